@@ -14,6 +14,9 @@
 #include "util.h"
 #include "image.h"
 #include "fih.h"
+#ifdef TFM_BOOT_TIMING
+#include "tfm_boot_status.h"
+#endif /* TFM_BOOT_TIMING */
 
 /* Disable both semihosting code and argv usage for main */
 #if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
@@ -55,6 +58,9 @@ int main(void)
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_PANIC;
     }
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL1_1_START, 0, 0);
+#endif /* TFM_BOOT_TIMING */
     BL1_LOG("[INF] Starting TF-M BL1_1\r\n");
 
     fih_rc = bl1_otp_init();
@@ -103,6 +109,9 @@ int main(void)
     }
 
     BL1_LOG("[INF] Jumping to BL1_2\r\n");
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL1_1_JUMP, 0, 0);
+#endif /* TFM_BOOT_TIMING */
     /* Jump to BL1_2 */
     boot_platform_quit((struct boot_arm_vector_table *)BL1_2_CODE_START);
 
@@ -27,6 +27,15 @@ fih_int bl1_sha256_init(void);
 fih_int bl1_sha256_update(uint8_t *data, size_t data_length);
 fih_int bl1_sha256_finish(uint8_t *hash);
 
+/* Computes a hash chain in place: hashes the block, overwrites the 32 bytes at
+ * digest_offset with the hash and increments the byte at ctr_offset, then
+ * repeats for the given number of iterations. This is the chain function of
+ * the LM-OTS signatures used by LMS, which dominates their verification time.
+ */
+fih_int bl1_sha256_chain(uint8_t *block, size_t block_length,
+                         size_t ctr_offset, size_t digest_offset,
+                         uint32_t iterations);
+
 /* Calculates a SHA-256 hash of the input data */
 fih_int bl1_sha256_compute(const uint8_t *data,
                            size_t data_length,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -29,14 +29,33 @@ uint32_t __WEAK bl1_image_get_flash_offset(uint32_t image_id)
 }
 
 #ifndef TFM_BL1_MEMORY_MAPPED_FLASH
-fih_int bl1_image_copy_to_sram(uint32_t image_id, uint8_t *out)
+fih_int bl1_image_copy_range_to_sram(uint32_t image_id, size_t offset,
+                                     uint8_t *out, size_t len)
 {
     uint32_t flash_offset;
+    int32_t rc;
+
+    if (offset > sizeof(struct bl1_2_image_t) ||
+        len > sizeof(struct bl1_2_image_t) - offset) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    flash_offset = bl1_image_get_flash_offset(image_id) + offset;
+    rc = FLASH_DEV_NAME.ReadData(flash_offset, out, len);
+    /* Drivers return either ARM_DRIVER_OK or the amount of data read */
+    if (rc < 0) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    FIH_RET(FIH_SUCCESS);
+}
+
+fih_int bl1_image_copy_to_sram(uint32_t image_id, uint8_t *out)
+{
     fih_int fih_rc;
 
-    flash_offset = bl1_image_get_flash_offset(image_id);
-    fih_rc = fih_int_encode(FLASH_DEV_NAME.ReadData(flash_offset, out,
-                                                    sizeof(struct bl1_2_image_t)));
+    FIH_CALL(bl1_image_copy_range_to_sram, fih_rc, image_id, 0, out,
+                                           sizeof(struct bl1_2_image_t));
 
     FIH_RET(fih_rc);
 }
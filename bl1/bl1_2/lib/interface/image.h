@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -20,6 +20,17 @@ extern "C" {
 #endif
 
 #define BL1_2_IMAGE_DECRYPT_MAGIC_EXPECTED 0xDEADBEEF
+/* Size of the blocks the image is read from flash and decrypted in, when the
+ * flash is not memory-mapped. Must be a multiple of the AES block size so the
+ * CTR counter carries over between blocks.
+ */
+#ifndef BL1_2_IMAGE_CHUNK_SIZE
+#define BL1_2_IMAGE_CHUNK_SIZE 0x1000
+#endif
+#if (BL1_2_IMAGE_CHUNK_SIZE % 16) != 0
+#error "BL1_2_IMAGE_CHUNK_SIZE must be a multiple of 16"
+#endif
+
 #define PAD_SIZE (BL1_HEADER_SIZE - CTR_IV_LEN - 1452 - \
                   sizeof(struct tfm_bl1_image_version_t) - 2 * sizeof(uint32_t))
 
@@ -51,6 +62,9 @@ uint32_t bl1_image_get_flash_offset(uint32_t image_id);
 
 fih_int bl1_image_copy_to_sram(uint32_t image_id, uint8_t *out);
 
+fih_int bl1_image_copy_range_to_sram(uint32_t image_id, size_t offset,
+                                     uint8_t *out, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
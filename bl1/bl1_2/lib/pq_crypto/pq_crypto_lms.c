@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* LMS signature verification as per IETF RFC8554, for the LMS_SHA256_M32_H10
+ * and LMOTS_SHA256_N32_W8 parameter sets.
+ *
+ * Nearly all of the verification time is spent in the LM-OTS hash chains, up
+ * to 255 hashes for each of the 34 chains. Each chain is computed with a single
+ * call to bl1_sha256_chain(), which lets the hash accelerator run the whole
+ * chain without being set up again for every hash.
+ */
+
+#include "pq_crypto.h"
+
+#include <stdint.h>
+#include <string.h>
+#include "crypto.h"
+#include "otp.h"
+#include "util.h"
+
+#define LMS_TYPE_SHA256_M32_H10   0x00000006
+#define LMOTS_TYPE_SHA256_N32_W8  0x00000004
+
+#define LMS_H          10
+#define LMS_M          32
+#define LMS_I_LEN      16
+#define LMOTS_N        32
+#define LMOTS_W        8
+#define LMOTS_P        34
+
+#define LMS_D_PBLC     0x8080
+#define LMS_D_MESG     0x8181
+#define LMS_D_LEAF     0x8282
+#define LMS_D_INTR     0x8383
+
+#define LMS_PUBLIC_KEY_LEN (4 + 4 + LMS_I_LEN + LMS_M)
+#define LMOTS_SIG_LEN      (4 + LMOTS_N + (LMOTS_P * LMOTS_N))
+#define LMS_SIG_LEN        (4 + LMOTS_SIG_LEN + 4 + (LMS_H * LMS_M))
+
+/* I || u32str(q) || u16str(i) || u8str(j) || tmp */
+#define CHAIN_Q_OFFSET      LMS_I_LEN
+#define CHAIN_I_OFFSET      (CHAIN_Q_OFFSET + 4)
+#define CHAIN_J_OFFSET      (CHAIN_I_OFFSET + 2)
+#define CHAIN_TMP_OFFSET    (CHAIN_J_OFFSET + 1)
+#define CHAIN_BLOCK_LEN     (CHAIN_TMP_OFFSET + LMOTS_N)
+
+static uint8_t lmots_z[LMOTS_P][LMOTS_N];
+
+static uint32_t get_u32(const uint8_t *buf)
+{
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+           ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+}
+
+static void put_u32(uint8_t *buf, uint32_t val)
+{
+    buf[0] = (uint8_t)(val >> 24);
+    buf[1] = (uint8_t)(val >> 16);
+    buf[2] = (uint8_t)(val >> 8);
+    buf[3] = (uint8_t)val;
+}
+
+static void put_u16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = (uint8_t)(val >> 8);
+    buf[1] = (uint8_t)val;
+}
+
+/* Computes the candidate LM-OTS public key Kc from the message and the LM-OTS
+ * signature, as per algorithm 4b of RFC8554.
+ */
+static fih_int lmots_candidate_public_key(const uint8_t *lms_i, uint32_t q,
+                                          const uint8_t *lmots_sig,
+                                          const uint8_t *data,
+                                          size_t data_length,
+                                          uint8_t *kc)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    uint8_t prefix[LMS_I_LEN + 4 + 2];
+    uint8_t q_cksm[LMOTS_N + 2];
+    uint8_t chain[CHAIN_BLOCK_LEN];
+    const uint8_t *c = lmots_sig + 4;
+    const uint8_t *y = c + LMOTS_N;
+    uint16_t cksm = 0;
+    uint32_t idx;
+
+    memcpy(prefix, lms_i, LMS_I_LEN);
+    put_u32(prefix + LMS_I_LEN, q);
+
+    /* Q = H(I || u32str(q) || u16str(D_MESG) || C || message) */
+    put_u16(prefix + LMS_I_LEN + 4, LMS_D_MESG);
+    FIH_CALL(bl1_sha256_init, fih_rc);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    FIH_CALL(bl1_sha256_update, fih_rc, prefix, sizeof(prefix));
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    FIH_CALL(bl1_sha256_update, fih_rc, (uint8_t *)c, LMOTS_N);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    FIH_CALL(bl1_sha256_update, fih_rc, (uint8_t *)data, data_length);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    FIH_CALL(bl1_sha256_finish, fih_rc, q_cksm);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    /* With w = 8 every byte of Q is a digit, and no left shift is needed */
+    for (idx = 0; idx < LMOTS_N; idx++) {
+        cksm += ((1 << LMOTS_W) - 1) - q_cksm[idx];
+    }
+    put_u16(q_cksm + LMOTS_N, cksm);
+
+    /* Each chain is advanced from the digit value to the end of the chain.
+     * The hash engine can only run one operation at a time, so the chain ends
+     * are all kept until Kc is computed.
+     */
+    memcpy(chain, prefix, CHAIN_I_OFFSET);
+    for (idx = 0; idx < LMOTS_P; idx++) {
+        put_u16(chain + CHAIN_I_OFFSET, (uint16_t)idx);
+        chain[CHAIN_J_OFFSET] = q_cksm[idx];
+        memcpy(chain + CHAIN_TMP_OFFSET, y + (idx * LMOTS_N), LMOTS_N);
+
+        FIH_CALL(bl1_sha256_chain, fih_rc, chain, sizeof(chain),
+                 CHAIN_J_OFFSET, CHAIN_TMP_OFFSET,
+                 ((1 << LMOTS_W) - 1) - q_cksm[idx]);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(FIH_FAILURE);
+        }
+
+        memcpy(lmots_z[idx], chain + CHAIN_TMP_OFFSET, LMOTS_N);
+    }
+
+    /* Kc = H(I || u32str(q) || u16str(D_PBLC) || z[0] || ... || z[p-1]) */
+    put_u16(prefix + LMS_I_LEN + 4, LMS_D_PBLC);
+    FIH_CALL(bl1_sha256_init, fih_rc);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    FIH_CALL(bl1_sha256_update, fih_rc, prefix, sizeof(prefix));
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    FIH_CALL(bl1_sha256_update, fih_rc, (uint8_t *)lmots_z, sizeof(lmots_z));
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    FIH_CALL(bl1_sha256_finish, fih_rc, kc);
+    FIH_RET(fih_rc);
+}
+
+fih_int pq_crypto_verify(enum tfm_bl1_key_id_t key,
+                         const uint8_t *data,
+                         size_t data_length,
+                         const uint8_t *signature,
+                         size_t signature_length)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    uint8_t key_buf[LMS_PUBLIC_KEY_LEN];
+    const uint8_t *lms_i = key_buf + 8;
+    const uint8_t *lms_t1 = lms_i + LMS_I_LEN;
+    const uint8_t *lmots_sig = signature + 4;
+    const uint8_t *path = lmots_sig + LMOTS_SIG_LEN + 4;
+    uint8_t node[LMS_I_LEN + 4 + 2 + (2 * LMS_M)];
+    uint8_t *tmp = node + LMS_I_LEN + 4 + 2;
+    uint32_t node_num;
+    uint32_t q;
+    uint32_t idx;
+
+    if (data == NULL || signature == NULL ||
+        signature_length != LMS_SIG_LEN) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    FIH_CALL(bl1_otp_read_key, fih_rc, key, key_buf);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    if (get_u32(key_buf) != LMS_TYPE_SHA256_M32_H10 ||
+        get_u32(key_buf + 4) != LMOTS_TYPE_SHA256_N32_W8) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    q = get_u32(signature);
+    if (q >= (1U << LMS_H) ||
+        get_u32(lmots_sig) != LMOTS_TYPE_SHA256_N32_W8 ||
+        get_u32(lmots_sig + LMOTS_SIG_LEN) != LMS_TYPE_SHA256_M32_H10) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    FIH_CALL(lmots_candidate_public_key, fih_rc, lms_i, q, lmots_sig, data,
+             data_length, tmp);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    /* tmp = H(I || u32str(node_num) || u16str(D_LEAF) || Kc) */
+    memcpy(node, lms_i, LMS_I_LEN);
+    node_num = (1U << LMS_H) + q;
+    put_u32(node + LMS_I_LEN, node_num);
+    put_u16(node + LMS_I_LEN + 4, LMS_D_LEAF);
+    FIH_CALL(bl1_sha256_compute, fih_rc, node,
+             LMS_I_LEN + 4 + 2 + LMS_M, tmp);
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    /* Climb the authentication path up to the root of the tree */
+    put_u16(node + LMS_I_LEN + 4, LMS_D_INTR);
+    for (idx = 0; node_num > 1; idx++, node_num /= 2) {
+        if (node_num % 2) {
+            memmove(tmp + LMS_M, tmp, LMS_M);
+            memcpy(tmp, path + (idx * LMS_M), LMS_M);
+        } else {
+            memcpy(tmp + LMS_M, path + (idx * LMS_M), LMS_M);
+        }
+        put_u32(node + LMS_I_LEN, node_num / 2);
+
+        FIH_CALL(bl1_sha256_compute, fih_rc, node, sizeof(node), tmp);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(FIH_FAILURE);
+        }
+    }
+
+    FIH_CALL(bl_secure_memeql, fih_rc, tmp, lms_t1, LMS_M);
+    FIH_RET(fih_rc);
+}
@@ -15,6 +15,9 @@
 #include "image.h"
 #include "region_defs.h"
 #include "pq_crypto.h"
+#ifdef TFM_BOOT_TIMING
+#include "tfm_boot_status.h"
+#endif /* TFM_BOOT_TIMING */
 
 /* Disable both semihosting code and argv usage for main */
 #if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
@@ -118,15 +121,21 @@ fih_int validate_image_at_addr(struct bl1_2_image_t *image)
 fih_int copy_and_decrypt_image(uint32_t image_id)
 {
     int rc;
-#ifdef TFM_BL1_MEMORY_MAPPED_FLASH
     fih_int fih_rc;
-#endif /* TFM_BL1_MEMORY_MAPPED_FLASH */
+#ifndef TFM_BL1_MEMORY_MAPPED_FLASH
+    size_t offset;
+    size_t chunk_size;
+#endif /* !TFM_BL1_MEMORY_MAPPED_FLASH */
     struct bl1_2_image_t *image_to_decrypt;
     struct bl1_2_image_t *image_after_decrypt =
         (struct bl1_2_image_t *)BL2_IMAGE_START;
     uint8_t key_buf[32];
     uint8_t label[] = "BL2_DECRYPTION_KEY";
 
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL1_2_DECRYPT, image_id, image_id);
+#endif /* TFM_BOOT_TIMING */
+
 #ifdef TFM_BL1_MEMORY_MAPPED_FLASH
     /* If we have memory-mapped flash, we can do the decrypt directly from the
      * flash and output to the SRAM. This is significantly faster if the AES
@@ -145,10 +154,18 @@ fih_int copy_and_decrypt_image(uint32_t image_id)
                         sizeof(image_after_decrypt->protected_values.encrypted_data));
 #else
     /* If the flash isn't memory-mapped, defer to the flash driver to copy the
-     * entire block in to SRAM. We'll then do the decrypt in-place.
+     * image in to SRAM. Only the part that isn't encrypted is copied here, the
+     * rest is copied a block at a time and each block is decrypted in-place
+     * straight after it has been read.
      */
-    bl1_image_copy_to_sram(image_id, (uint8_t *)BL2_IMAGE_START);
-    image_to_decrypt = (struct bl1_2_image_t *)BL2_IMAGE_START;
+    FIH_CALL(bl1_image_copy_range_to_sram, fih_rc, image_id, 0,
+             (uint8_t *)image_after_decrypt,
+             sizeof(struct bl1_2_image_t) -
+             sizeof(image_after_decrypt->protected_values.encrypted_data));
+    if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+    image_to_decrypt = image_after_decrypt;
 #endif /* TFM_BL1_MEMORY_MAPPED_FLASH */
 
     /* As the security counter is an attacker controlled parameter, bound the
@@ -168,6 +185,7 @@ fih_int copy_and_decrypt_image(uint32_t image_id)
         FIH_RET(fih_int_encode_zero_equality(rc));
     }
 
+#ifdef TFM_BL1_MEMORY_MAPPED_FLASH
     rc = bl1_aes_256_ctr_decrypt(TFM_BL1_KEY_USER, key_buf,
                                  image_after_decrypt->header.ctr_iv,
                                  (uint8_t *)&image_to_decrypt->protected_values.encrypted_data,
@@ -176,6 +194,41 @@ fih_int copy_and_decrypt_image(uint32_t image_id)
     if (rc) {
         FIH_RET(fih_int_encode_zero_equality(rc));
     }
+#else
+    /* The decrypt of each block picks up the CTR counter where the previous
+     * one left it, as the block size is a multiple of the AES block size.
+     */
+    for (offset = 0;
+         offset < sizeof(image_after_decrypt->protected_values.encrypted_data);
+         offset += chunk_size) {
+        chunk_size = sizeof(image_after_decrypt->protected_values.encrypted_data)
+                     - offset;
+        if (chunk_size > BL1_2_IMAGE_CHUNK_SIZE) {
+            chunk_size = BL1_2_IMAGE_CHUNK_SIZE;
+        }
+
+        FIH_CALL(bl1_image_copy_range_to_sram, fih_rc, image_id,
+                 offsetof(struct bl1_2_image_t,
+                          protected_values.encrypted_data) + offset,
+                 (uint8_t *)&image_after_decrypt->protected_values.encrypted_data
+                 + offset,
+                 chunk_size);
+        if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
+            FIH_RET(FIH_FAILURE);
+        }
+
+        rc = bl1_aes_256_ctr_decrypt(TFM_BL1_KEY_USER, key_buf,
+                                     image_after_decrypt->header.ctr_iv,
+                                     (uint8_t *)&image_to_decrypt->protected_values.encrypted_data
+                                     + offset,
+                                     chunk_size,
+                                     (uint8_t *)&image_after_decrypt->protected_values.encrypted_data
+                                     + offset);
+        if (rc) {
+            FIH_RET(fih_int_encode_zero_equality(rc));
+        }
+    }
+#endif /* TFM_BL1_MEMORY_MAPPED_FLASH */
 
     if (image_after_decrypt->protected_values.encrypted_data.decrypt_magic
             != BL1_2_IMAGE_DECRYPT_MAGIC_EXPECTED) {
@@ -199,6 +252,10 @@ static fih_int validate_image(uint32_t image_id)
 
     BL1_LOG("[INF] BL2 image decrypted successfully\r\n");
 
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL1_2_VALIDATE, image_id, image_id);
+#endif /* TFM_BOOT_TIMING */
+
     FIH_CALL(validate_image_at_addr, fih_rc, image);
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         BL1_LOG("[ERR] BL2 image failed to validate\r\n");
@@ -219,6 +276,9 @@ int main(void)
     if (fih_not_eq(fih_rc, FIH_SUCCESS)) {
         FIH_PANIC;
     }
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL1_2_START, 0, 0);
+#endif /* TFM_BOOT_TIMING */
     BL1_LOG("[INF] starting TF-M bl1_2\r\n");
 
     fih_rc = fih_int_encode_zero_equality(boot_platform_post_init());
@@ -241,6 +301,9 @@ int main(void)
     }
 
     BL1_LOG("[INF] Jumping to BL2\r\n");
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL1_2_JUMP, 0, 0);
+#endif /* TFM_BOOT_TIMING */
     boot_platform_quit((struct boot_arm_vector_table *)BL2_CODE_START);
 
     FIH_PANIC;
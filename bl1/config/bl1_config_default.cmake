@@ -1,5 +1,5 @@
 #-------------------------------------------------------------------------------
-# Copyright (c) 2022, Arm Limited. All rights reserved.
+# Copyright (c) 2022-2023, Arm Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -19,6 +19,7 @@ set(TFM_BL1_DEFAULT_PROVISIONING        ON          CACHE BOOL      "Whether BL1
 set(TFM_BL1_SOFTWARE_CRYPTO             ON          CACHE BOOL      "Whether BL1_1 will use software crypto")
 set(TFM_BL1_DUMMY_TRNG                  ON          CACHE BOOL      "Whether BL1_1 will use dummy TRNG")
 set(TFM_BL1_PQ_CRYPTO                   OFF         CACHE BOOL      "Enable LMS PQ crypto for BL2 verification. This is experimental and should not yet be used in production")
+set(TFM_BL1_PQ_CRYPTO_HASH_CHAIN        OFF         CACHE BOOL      "Verify LMS signatures with the BL1 verifier, which computes the LM-OTS hash chains with bl1_sha256_chain(), instead of the mbedtls one")
 
 set(TFM_BL1_IMAGE_VERSION_BL2           "1.9.0+0"   CACHE STRING    "Image version of BL2 image")
 set(TFM_BL1_IMAGE_SECURITY_COUNTER_BL2  1           CACHE STRING    "Security counter value to include with BL2 image")
@@ -34,6 +34,13 @@
 #ifdef TEST_BL2
 #include "mcuboot_suites.h"
 #endif /* TEST_BL2 */
+#ifdef MCUBOOT_VERIFIED_IMAGE_CACHE
+#include "boot_image_cache.h"
+#endif
+#ifdef TFM_BOOT_TIMING
+#include "boot_timing.h"
+#include "tfm_boot_status.h"
+#endif
 
 /* Avoids the semihosting issue */
 #if defined (__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
@@ -93,6 +100,11 @@ int main(void)
     enum tfm_plat_err_t plat_err;
     int32_t image_id;
 
+#ifdef TFM_BOOT_TIMING
+    boot_timing_init();
+    (void)boot_store_timestamp(BOOT_TIMING_BL2_START, 0, 0);
+#endif
+
     /* Initialise the mbedtls static memory allocator so that mbedtls allocates
      * memory from the provided static buffer instead of from the heap.
      */
@@ -108,6 +120,10 @@ int main(void)
         FIH_PANIC;
     }
 
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL2_FLASH_INIT, 0, 0);
+#endif
+
     BOOT_LOG_INF("Starting bootloader");
 
     plat_err = tfm_plat_otp_init();
@@ -156,11 +172,27 @@ int main(void)
          * done anyway as a good practice to sanitize memory.
          */
         memset(&rsp, 0, sizeof(struct boot_rsp));
+#ifdef TFM_BOOT_TIMING
+        (void)boot_store_timestamp(BOOT_TIMING_BL2_VALIDATE, image_id,
+                                   image_id);
+#endif
         FIH_CALL(boot_go_for_image_id, fih_rc, &rsp, image_id);
         if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
             BOOT_LOG_ERR("Unable to find bootable image");
             FIH_PANIC;
         }
+#ifdef TFM_BOOT_TIMING
+        (void)boot_store_timestamp(BOOT_TIMING_BL2_LOADED, image_id,
+                                   image_id);
+#endif
+
+#ifdef MCUBOOT_VERIFIED_IMAGE_CACHE
+        /* Not fatal, the image is only verified in full on the next boot. */
+        if (boot_image_cache_update(image_id) != 0) {
+            BOOT_LOG_WRN("Verified image cache of image %d not updated",
+                         image_id);
+        }
+#endif
 
         if (boot_platform_post_load(image_id)) {
             BOOT_LOG_ERR("Post-load step for image %d failed", image_id);
@@ -171,6 +203,13 @@ int main(void)
     BOOT_LOG_INF("Bootloader chainload address offset: 0x%x",
                  rsp.br_image_off);
     BOOT_LOG_INF("Jumping to the first image slot");
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL2_JUMP, 0, 0);
+    /* Not fatal, the timestamps are only informative. */
+    if (boot_timing_save_shared_data() != 0) {
+        BOOT_LOG_WRN("Boot timestamps not saved");
+    }
+#endif
     do_boot(&rsp);
 
     BOOT_LOG_ERR("Never should get here");
@@ -30,7 +30,7 @@
 /*
  * Minimal configuration for using TLS in the bootloader
  *
- * - RSA signature verification
+ * - RSA, ECDSA P-256 and Ed25519 signature verification
  */
 
 #ifndef __MCUBOOT_MBEDTLS_CFG__
@@ -60,6 +60,11 @@
 #define MBEDTLS_AES_C
 #define MBEDTLS_CIPHER_MODE_CTR
 
+#ifdef MCUBOOT_SIGN_ED25519
+/* Ed25519 hashes the signed data with SHA-512 */
+#define MBEDTLS_SHA512_C
+#endif
+
 /* Save RAM by adjusting to our exact needs */
 #if MCUBOOT_SIGN_RSA_LEN == 3072
 #define MBEDTLS_MPI_MAX_SIZE 384
@@ -72,12 +77,16 @@
 /* Save ROM and a few bytes of RAM by specifying our own ciphersuite list */
 #define MBEDTLS_SSL_CIPHERSUITES MBEDTLS_TLS_ECJPAKE_WITH_AES_128_CCM_8
 
-#ifdef CRYPTO_HW_ACCELERATOR_OTP_PROVISIONING
-#define MBEDTLS_CIPHER_C
-#define MBEDTLS_CCM_C
+#if defined(MCUBOOT_SIGN_EC256) || \
+    defined(CRYPTO_HW_ACCELERATOR_OTP_PROVISIONING)
 #define MBEDTLS_ECDSA_C
 #define MBEDTLS_ECP_C
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#endif
+
+#ifdef CRYPTO_HW_ACCELERATOR_OTP_PROVISIONING
+#define MBEDTLS_CIPHER_C
+#define MBEDTLS_CCM_C
 #define MBEDTLS_ECP_DP_CURVE25519_ENABLED
 #endif /* CRYPTO_HW_ACCELERATOR_OTP_PROVISIONING */
 
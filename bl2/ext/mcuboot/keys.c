@@ -21,7 +21,7 @@
  * Original code taken from mcuboot project at:
  * https://github.com/mcu-tools/mcuboot
  * Git SHA of the original version: ac55554059147fff718015be9f4bd3108123f50a
- * Modifications are Copyright (c) 2019-2022 Arm Limited.
+ * Modifications are Copyright (c) 2019-2026 Arm Limited.
  */
 
 #include <stddef.h>
@@ -331,6 +331,74 @@ const unsigned char rsa_pub_key_1[] = {
 const unsigned int rsa_pub_key_len_1 = 398;
 #endif
 #endif
+#define PUB_KEY         rsa_pub_key
+#define PUB_KEY_LEN     rsa_pub_key_len
+#define PUB_KEY_1       rsa_pub_key_1
+#define PUB_KEY_LEN_1   rsa_pub_key_len_1
+#elif defined(MCUBOOT_SIGN_EC256)
+#define HAVE_KEYS
+const unsigned char ecdsa_pub_key[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86,
+    0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+    0x42, 0x00, 0x04, 0x7a, 0x63, 0x94, 0x34, 0x03,
+    0xbf, 0x45, 0x41, 0xad, 0x89, 0x9b, 0x1f, 0xde,
+    0x4c, 0x3c, 0x57, 0xcb, 0x6c, 0x17, 0xd1, 0x62,
+    0x3e, 0x9e, 0x53, 0xe5, 0xdf, 0x76, 0x39, 0xe7,
+    0x84, 0x1e, 0x71, 0x96, 0x22, 0xcd, 0x2c, 0x60,
+    0x4e, 0x96, 0x19, 0x31, 0x5d, 0x57, 0xa0, 0xac,
+    0x0c, 0xf4, 0xeb, 0x5e, 0x13, 0x08, 0x1f, 0x51,
+    0xeb, 0x26, 0x61, 0x95, 0xc1, 0xfe, 0xea, 0xfd,
+    0x5d, 0xbe, 0x61,
+};
+const unsigned int ecdsa_pub_key_len = 91;
+#if (MCUBOOT_IMAGE_NUMBER > 1)
+const unsigned char ecdsa_pub_key_1[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86,
+    0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03,
+    0x42, 0x00, 0x04, 0xcc, 0xaf, 0x74, 0x29, 0xfd,
+    0x71, 0x23, 0x53, 0xda, 0x04, 0x6c, 0x5f, 0xd7,
+    0x12, 0xa8, 0xc5, 0x46, 0x3f, 0xb4, 0x0f, 0x85,
+    0x7f, 0x57, 0xa3, 0x9e, 0x87, 0x87, 0xd0, 0xb6,
+    0x45, 0x2f, 0xb7, 0x9b, 0xa8, 0xd7, 0x3e, 0xad,
+    0x32, 0x40, 0x3c, 0x6b, 0x27, 0x51, 0x44, 0x9f,
+    0x25, 0xa6, 0xf6, 0xa4, 0xa2, 0x5e, 0xcb, 0xfd,
+    0xa8, 0x26, 0x08, 0xde, 0xe0, 0xef, 0x35, 0xe4,
+    0x1c, 0xb7, 0xda,
+};
+const unsigned int ecdsa_pub_key_len_1 = 91;
+#endif
+#define PUB_KEY         ecdsa_pub_key
+#define PUB_KEY_LEN     ecdsa_pub_key_len
+#define PUB_KEY_1       ecdsa_pub_key_1
+#define PUB_KEY_LEN_1   ecdsa_pub_key_len_1
+#elif defined(MCUBOOT_SIGN_ED25519)
+#define HAVE_KEYS
+const unsigned char ed25519_pub_key[] = {
+    0x30, 0x2a, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65,
+    0x70, 0x03, 0x21, 0x00, 0x27, 0xef, 0xa9, 0x31,
+    0xf0, 0x8a, 0x91, 0x5d, 0x6e, 0xa5, 0x3e, 0xd4,
+    0x99, 0x6a, 0xee, 0xbc, 0x57, 0x5e, 0x2c, 0x4c,
+    0x49, 0xea, 0xbb, 0x6c, 0x8c, 0xb3, 0xc7, 0xf0,
+    0x62, 0x67, 0xf0, 0x98,
+};
+const unsigned int ed25519_pub_key_len = 44;
+#if (MCUBOOT_IMAGE_NUMBER > 1)
+const unsigned char ed25519_pub_key_1[] = {
+    0x30, 0x2a, 0x30, 0x05, 0x06, 0x03, 0x2b, 0x65,
+    0x70, 0x03, 0x21, 0x00, 0x88, 0x1e, 0x98, 0x3a,
+    0x43, 0xc3, 0xc2, 0x19, 0x2e, 0x3a, 0xbf, 0x0e,
+    0x2b, 0x78, 0x36, 0x96, 0x85, 0x1c, 0xe4, 0xa5,
+    0x49, 0xff, 0x11, 0x40, 0x38, 0xf3, 0x53, 0xa7,
+    0x03, 0x8d, 0xb8, 0x2e,
+};
+const unsigned int ed25519_pub_key_len_1 = 44;
+#endif
+#define PUB_KEY         ed25519_pub_key
+#define PUB_KEY_LEN     ed25519_pub_key_len
+#define PUB_KEY_1       ed25519_pub_key_1
+#define PUB_KEY_LEN_1   ed25519_pub_key_len_1
 #else
 #error "No public key available for given signing algorithm."
 #endif
@@ -338,27 +406,27 @@ const unsigned int rsa_pub_key_len_1 = 398;
 #if defined(HAVE_KEYS)
 const struct bootutil_key bootutil_keys[] = {
     {
-        .key = rsa_pub_key,
-        .len = &rsa_pub_key_len,
+        .key = PUB_KEY,
+        .len = &PUB_KEY_LEN,
     },
 #if (MCUBOOT_IMAGE_NUMBER > 1)
     {
-        .key = rsa_pub_key_1,
-        .len = &rsa_pub_key_len_1,
+        .key = PUB_KEY_1,
+        .len = &PUB_KEY_LEN_1,
     },
 #endif /* MCUBOOT_IMAGE_NUMBER > 1 */
 #if (MCUBOOT_IMAGE_NUMBER > 2)
     {
         /* FIXME assuming the image 0 key is reused here */
-        .key = rsa_pub_key,
-        .len = &rsa_pub_key_len,
+        .key = PUB_KEY,
+        .len = &PUB_KEY_LEN,
     },
 #endif /* MCUBOOT_IMAGE_NUMBER > 2 */
 #if (MCUBOOT_IMAGE_NUMBER > 3)
     {
         /* FIXME assuming the image 0 key is reused here */
-        .key = rsa_pub_key,
-        .len = &rsa_pub_key_len,
+        .key = PUB_KEY,
+        .len = &PUB_KEY_LEN,
     },
 #endif /* MCUBOOT_IMAGE_NUMBER > 3 */
 };
@@ -1,5 +1,5 @@
 #-------------------------------------------------------------------------------
-# Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+# Copyright (c) 2021-2023, Arm Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -40,12 +40,17 @@ set(MCUBOOT_ENC_IMAGES                  OFF         CACHE BOOL      "Enable encr
 set(MCUBOOT_BOOTSTRAP                   OFF         CACHE BOOL      "Support initial state with empty primary slot and images installed from secondary slots")
 set(MCUBOOT_ENCRYPT_RSA                 OFF         CACHE BOOL      "Use RSA for encrypted image upgrade support")
 set(MCUBOOT_FIH_PROFILE                 OFF         CACHE STRING    "Fault injection hardening profile [OFF, LOW, MEDIUM, HIGH]")
+set(MCUBOOT_VERIFIED_IMAGE_CACHE        OFF         CACHE BOOL      "Skip the hash and signature check of the images which have not changed since they were last verified")
+set(MCUBOOT_DEFER_NS_VERIFICATION       OFF         CACHE BOOL      "Boot without checking the non-secure image, which TF-M verifies before starting it")
+set(BL2_FLASH_READ_CACHE_SIZE           0           CACHE STRING    "Size in bytes of the window cached for short flash reads, 0 to disable")
+set(BL2_FLASH_MAPPED_READ               OFF         CACHE BOOL      "Read the flash memory-mapped at FLASH_BASE_ADDRESS directly instead of through the driver")
 
 # Note - If either SIGNATURE_TYPE or KEY_LEN are changed, the entries for KEY_S
 # and KEY_NS will either have to be updated manually or removed from the cache.
 # `cmake .. -UMCUBOOT_KEY_S -UMCUBOOT_KEY_NS`. Once removed from the cache it
 # will be set to default again.
-set(MCUBOOT_SIGNATURE_TYPE              "RSA"       CACHE STRING    "Algorithm to use for signature validation")
+set(MCUBOOT_SIGNATURE_TYPE              "RSA"       CACHE STRING    "Algorithm to use for signature validation [RSA, EC, ED25519]")
+set_property(CACHE MCUBOOT_SIGNATURE_TYPE PROPERTY STRINGS "RSA;EC;ED25519")
 set(MCUBOOT_SIGNATURE_KEY_LEN           3072        CACHE STRING    "Key length to use for signature validation")
 set(MCUBOOT_KEY_S                       "${CMAKE_SOURCE_DIR}/bl2/ext/mcuboot/root-${MCUBOOT_SIGNATURE_TYPE}-${MCUBOOT_SIGNATURE_KEY_LEN}.pem" CACHE FILEPATH "Path to key with which to sign secure binary")
 set(MCUBOOT_KEY_NS                      "${CMAKE_SOURCE_DIR}/bl2/ext/mcuboot/root-${MCUBOOT_SIGNATURE_TYPE}-${MCUBOOT_SIGNATURE_KEY_LEN}_1.pem" CACHE FILEPATH "Path to key with which to sign non-secure binary")
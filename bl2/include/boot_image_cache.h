@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __BOOT_IMAGE_CACHE_H__
+#define __BOOT_IMAGE_CACHE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Records that the image in the primary slot of an image has been
+ *        verified, so that the next boots skip hashing it while neither the
+ *        slot nor its security counter has changed.
+ *
+ * \param[in] image_id  The ID of the image which has just been loaded.
+ *
+ * \return Returns 0 on success, non-zero otherwise
+ */
+int boot_image_cache_update(uint32_t image_id);
+
+/**
+ * \brief Checks whether the primary slot of an image still matches the record
+ *        kept when it was last verified.
+ *
+ * \param[in] image_id  The ID of the image which is about to be checked.
+ *
+ * \return Returns 0 if the image has not changed, non-zero otherwise
+ */
+int boot_image_cache_check(uint32_t image_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_IMAGE_CACHE_H__ */
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __BOOT_TIMING_H__
+#define __BOOT_TIMING_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Keeps the timestamps BL1 added to the shared data area, as MCUboot
+ *        clears the area the first time it adds data to it. Must be called
+ *        before any boot data is saved.
+ */
+void boot_timing_init(void);
+
+/**
+ * \brief Adds the timestamps recorded so far to the shared data area. Called
+ *        once, after all the images have been loaded.
+ *
+ * \return Returns 0 on success, non-zero otherwise
+ */
+int boot_timing_save_shared_data(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_TIMING_H__ */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Boot phase timestamps
+ *
+ * MCUboot initialises the shared data area the first time it adds an entry to
+ * it, which happens in the middle of the image loading. The timestamps of BL2
+ * are therefore kept in RAM, together with the ones BL1 left in the area, and
+ * are only added to the area just before the secure image is started.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "boot_hal.h"
+#include "boot_timing.h"
+#include "region_defs.h"
+#include "tfm_boot_status.h"
+
+/* BL1 stamps at most 8 phases, BL2 at most 3 plus 3 per image */
+#define BOOT_TIMING_MAX_ENTRIES (11 + (3 * MCUBOOT_IMAGE_NUMBER))
+
+extern int boot_add_data_to_shared_area(uint8_t        major_type,
+                                        uint16_t       minor_type,
+                                        size_t         size,
+                                        const uint8_t *data);
+
+static struct boot_timing_entry timing_entries[BOOT_TIMING_MAX_ENTRIES];
+static uint32_t timing_entry_count;
+
+void boot_timing_init(void)
+{
+#ifdef BL1
+    struct tfm_boot_data *boot_data;
+    struct shared_data_tlv_entry tlv_entry;
+    uintptr_t tlv_end, offset;
+
+    boot_data = (struct tfm_boot_data *)BOOT_TFM_SHARED_DATA_BASE;
+    if (boot_data->header.tlv_magic != SHARED_DATA_TLV_INFO_MAGIC ||
+        boot_data->header.tlv_tot_len > BOOT_TFM_SHARED_DATA_SIZE) {
+        return;
+    }
+
+    tlv_end = (uintptr_t)boot_data + boot_data->header.tlv_tot_len;
+    offset = (uintptr_t)boot_data->data;
+
+    while (offset + SHARED_DATA_ENTRY_HEADER_SIZE <= tlv_end &&
+           timing_entry_count < BOOT_TIMING_MAX_ENTRIES) {
+        memcpy(&tlv_entry, (const void *)offset, sizeof(tlv_entry));
+        if (offset + SHARED_DATA_ENTRY_SIZE(tlv_entry.tlv_len) > tlv_end) {
+            break;
+        }
+
+        if (GET_MAJOR(tlv_entry.tlv_type) == TLV_MAJOR_BTS &&
+            tlv_entry.tlv_len == sizeof(struct boot_timing_entry)) {
+            memcpy(&timing_entries[timing_entry_count++],
+                   (const void *)(offset + SHARED_DATA_ENTRY_HEADER_SIZE),
+                   sizeof(struct boot_timing_entry));
+        }
+
+        offset += SHARED_DATA_ENTRY_SIZE(tlv_entry.tlv_len);
+    }
+#endif /* BL1 */
+}
+
+int boot_store_timestamp(uint8_t phase, uint8_t index, uint32_t id)
+{
+    struct boot_timing_entry *entry;
+
+    if (timing_entry_count >= BOOT_TIMING_MAX_ENTRIES) {
+        return -1;
+    }
+
+    entry = &timing_entries[timing_entry_count++];
+    entry->phase = phase;
+    entry->index = index;
+    entry->reserved = 0;
+    entry->timestamp = boot_platform_get_timestamp();
+    entry->id = id;
+
+    return 0;
+}
+
+int boot_timing_save_shared_data(void)
+{
+    uint32_t i;
+    uint16_t minor;
+    int rc;
+
+    for (i = 0; i < timing_entry_count; i++) {
+        minor = SET_BTS_MINOR(timing_entries[i].phase,
+                              timing_entries[i].index);
+        rc = boot_add_data_to_shared_area(TLV_MAJOR_BTS, minor,
+                                          sizeof(struct boot_timing_entry),
+                                          (const uint8_t *)&timing_entries[i]);
+        if (rc) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
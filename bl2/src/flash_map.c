@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include <stdbool.h>
+#include <string.h>
 #include "target.h"
 #include "flash_map/flash_map.h"
 #include "flash_map_backend/flash_map_backend.h"
@@ -36,6 +37,49 @@ extern const int flash_map_entry_num;
 extern const ARM_DRIVER_FLASH  *flash_driver[];
 extern const int flash_driver_entry_num;
 
+#ifdef BL2_FLASH_MAPPED_READ
+/* The device which is memory-mapped at FLASH_BASE_ADDRESS */
+extern ARM_DRIVER_FLASH FLASH_DEV_NAME;
+#endif
+
+#ifdef BL2_FLASH_READ_CACHE_SIZE
+#if (BL2_FLASH_READ_CACHE_SIZE % 4) != 0
+#error "BL2_FLASH_READ_CACHE_SIZE must be a multiple of 4"
+#endif
+
+/*
+ * Window of a flash area which has last been read with a short read. It is
+ * invalidated whenever the flash is written or erased.
+ */
+static struct {
+    const struct flash_area *area;
+    uint32_t off;
+    uint32_t len;
+    uint8_t buf[BL2_FLASH_READ_CACHE_SIZE];
+} read_cache;
+#endif /* BL2_FLASH_READ_CACHE_SIZE */
+
+#ifdef BL2_FLASH_DMA_READ_AHEAD_SIZE
+#ifndef PLATFORM_HAS_BOOT_DMA
+#error "BL2_FLASH_DMA_READ_AHEAD_SIZE needs PLATFORM_HAS_BOOT_DMA"
+#endif
+
+/* The other DMA reads keep using channel 0 */
+#define READ_AHEAD_DMA_CHANNEL    1
+
+/*
+ * Block following the last DMA read of a flash area, which is copied in the
+ * background while the caller works on that read, such as hashing it.
+ */
+static struct {
+    const struct flash_area *area;  /* NULL if no copy has been started */
+    uint32_t off;
+    uint32_t len;
+    bool pending;                   /* The copy may still be in progress */
+    uint8_t buf[BL2_FLASH_DMA_READ_AHEAD_SIZE];
+} read_ahead;
+#endif /* BL2_FLASH_DMA_READ_AHEAD_SIZE */
+
 /* Valid entries for data item width */
 static const uint32_t data_width_byte[] = {
     sizeof(uint8_t),
@@ -66,6 +110,149 @@ static bool is_range_valid(const struct flash_area *area,
 
     return true;
 }
+
+#ifdef BL2_FLASH_DMA_READ_AHEAD_SIZE
+static int read_ahead_wait(void)
+{
+    if (read_ahead.pending) {
+        read_ahead.pending = false;
+        if (boot_dma_wait(READ_AHEAD_DMA_CHANNEL) != 0) {
+            read_ahead.area = NULL;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void read_ahead_cancel(void)
+{
+    (void)read_ahead_wait();
+    read_ahead.area = NULL;
+}
+
+/*
+ * Start copying the `len` bytes at `off`, if they fit in the buffer and lie
+ * within the area.
+ */
+static void read_ahead_start(const struct flash_area *area, uint32_t off,
+                             uint32_t len)
+{
+    read_ahead.area = NULL;
+
+    if ((len > BL2_FLASH_DMA_READ_AHEAD_SIZE) ||
+        !is_range_valid(area, off, len)) {
+        return;
+    }
+
+    if (boot_dma_memcpy_start(FLASH_BASE_ADDRESS + area->fa_off + off,
+                              (uint32_t)read_ahead.buf, len,
+                              READ_AHEAD_DMA_CHANNEL) != 0) {
+        return;
+    }
+
+    read_ahead.area = area;
+    read_ahead.off = off;
+    read_ahead.len = len;
+    read_ahead.pending = true;
+}
+#endif /* BL2_FLASH_DMA_READ_AHEAD_SIZE */
+
+#if defined(BL2_FLASH_READ_CACHE_SIZE) || defined(BL2_FLASH_DMA_READ_AHEAD_SIZE)
+/*
+ * Check whether two ranges of flash areas cover any common byte of the same
+ * flash device. Different flash areas may map the same device.
+ */
+static bool is_range_overlapping(const struct flash_area *area_a,
+                                 uint32_t off_a, uint32_t len_a,
+                                 const struct flash_area *area_b,
+                                 uint32_t off_b, uint32_t len_b)
+{
+    uint32_t start_a = area_a->fa_off + off_a;
+    uint32_t start_b = area_b->fa_off + off_b;
+
+    return (DRV_FLASH_AREA(area_a) == DRV_FLASH_AREA(area_b)) &&
+           (start_a < start_b + len_b) && (start_b < start_a + len_a);
+}
+#endif
+
+/*
+ * Drop the data buffered from the `len` bytes at `off`, before their content
+ * changes. Any background copy is completed first, as the flash must not be
+ * read while it is programmed or erased, but its data is kept if it lies
+ * elsewhere: while an image is copied from one slot to another, the next
+ * block of the source is then read during the processing and programming of
+ * the current one.
+ */
+static inline void read_buffers_invalidate(const struct flash_area *area,
+                                           uint32_t off, uint32_t len)
+{
+#ifdef BL2_FLASH_READ_CACHE_SIZE
+    if ((read_cache.area != NULL) &&
+        is_range_overlapping(read_cache.area, read_cache.off, read_cache.len,
+                             area, off, len)) {
+        read_cache.area = NULL;
+    }
+#endif
+#ifdef BL2_FLASH_DMA_READ_AHEAD_SIZE
+    (void)read_ahead_wait();
+    if ((read_ahead.area != NULL) &&
+        is_range_overlapping(read_ahead.area, read_ahead.off, read_ahead.len,
+                             area, off, len)) {
+        read_ahead.area = NULL;
+    }
+#endif
+}
+
+#ifdef BL2_FLASH_READ_CACHE_SIZE
+/*
+ * Serve a read shorter than the cache from the cached window, loading the
+ * window which holds `off` first if needed.
+ */
+static int read_cache_read(const struct flash_area *area, uint32_t off,
+                           void *dst, uint32_t len)
+{
+    ARM_FLASH_CAPABILITIES DriverCapabilities;
+    uint32_t copy_len;
+    uint32_t win_off;
+    int ret;
+
+    while (len) {
+        if ((read_cache.area != area) || (off < read_cache.off) ||
+            (off >= read_cache.off + read_cache.len)) {
+            win_off = FLOOR_ALIGN(off, BL2_FLASH_READ_CACHE_SIZE);
+            read_cache.area = NULL;
+            read_cache.len = area->fa_size - win_off;
+            if (read_cache.len > BL2_FLASH_READ_CACHE_SIZE) {
+                read_cache.len = BL2_FLASH_READ_CACHE_SIZE;
+            }
+
+            DriverCapabilities = DRV_FLASH_AREA(area)->GetCapabilities();
+            ret = DRV_FLASH_AREA(area)->ReadData(area->fa_off + win_off,
+                    read_cache.buf,
+                    read_cache.len /
+                    data_width_byte[DriverCapabilities.data_width]);
+            if (ret < 0) {
+                return ret;
+            }
+            read_cache.area = area;
+            read_cache.off = win_off;
+        }
+
+        copy_len = read_cache.off + read_cache.len - off;
+        if (copy_len > len) {
+            copy_len = len;
+        }
+        memcpy(dst, &read_cache.buf[off - read_cache.off], copy_len);
+        dst = (uint8_t *)dst + copy_len;
+        off += copy_len;
+        len -= copy_len;
+    }
+
+    return 0;
+}
+#endif /* BL2_FLASH_READ_CACHE_SIZE */
+
 int flash_area_driver_init(void)
 {
     int i;
@@ -132,6 +319,23 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
     if (!is_range_valid(area, off, len)) {
         return -1;
     }
+
+#ifdef BL2_FLASH_MAPPED_READ
+    /* Memory-mapped flash is read directly, without driver calls. */
+    if (DRV_FLASH_AREA(area) == &FLASH_DEV_NAME) {
+        memcpy(dst, (const void *)(FLASH_BASE_ADDRESS + area->fa_off + off),
+               len);
+        return 0;
+    }
+#endif /* BL2_FLASH_MAPPED_READ */
+
+#ifdef BL2_FLASH_READ_CACHE_SIZE
+    /* MCUboot parses the image header and TLVs with many short reads. */
+    if (len < BL2_FLASH_READ_CACHE_SIZE) {
+        return read_cache_read(area, off, dst, len);
+    }
+#endif /* BL2_FLASH_READ_CACHE_SIZE */
+
     remaining_len = len;
 
     /* CMSIS ARM_FLASH_ReadData API requires the `addr` data type size aligned.
@@ -143,6 +347,19 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
 
 #ifdef PLATFORM_HAS_BOOT_DMA
     if (len >= BOOT_DMA_MIN_SIZE_REQ) {
+#ifdef BL2_FLASH_DMA_READ_AHEAD_SIZE
+        /* Sequential reads, such as the hash pass over an image, find their
+         * data already copied.
+         */
+        if ((read_ahead.area == area) && (read_ahead.off == off) &&
+            (read_ahead.len == len) && (read_ahead_wait() == 0)) {
+            memcpy(dst, read_ahead.buf, len);
+            read_ahead_start(area, off + len, len);
+            return 0;
+        }
+        read_ahead_cancel();
+#endif /* BL2_FLASH_DMA_READ_AHEAD_SIZE */
+
         dma_src_addr = FLASH_BASE_ADDRESS + area->fa_off + off;
         BOOT_LOG_DBG("dma memcpy call:src_addr=%#x, dest_addr=%#x, len=%#x",
                       dma_src_addr, dst, len);
@@ -150,6 +367,9 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
         ret = boot_dma_memcpy(dma_src_addr, (uint32_t)dst, len, 0);
         if (ret == 0) {
             /* DMA transfer copy success */
+#ifdef BL2_FLASH_DMA_READ_AHEAD_SIZE
+            read_ahead_start(area, off + len, len);
+#endif
             return 0;
         }
     }
@@ -221,8 +441,8 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
 /* Writes `len` bytes of flash memory at `off` from the buffer at `src`.
  * `off` and `len` can be any alignment.
  */
-int flash_area_write(const struct flash_area *area, uint32_t off,
-                     const void *src, uint32_t len)
+static int flash_area_program(const struct flash_area *area, uint32_t off,
+                              const void *src, uint32_t len)
 {
     uint8_t add_padding[FLASH_PROGRAM_UNIT];
 #if (FLASH_PROGRAM_UNIT == 1)
@@ -377,6 +597,22 @@ int flash_area_write(const struct flash_area *area, uint32_t off,
     return 0;
 }
 
+int flash_area_write(const struct flash_area *area, uint32_t off,
+                     const void *src, uint32_t len)
+{
+    int ret;
+
+    /* No background copy may read the flash while it is programmed. */
+    read_buffers_invalidate(area, off, len);
+
+    ret = flash_area_program(area, off, src, len);
+
+    /* The padding reads may have cached the data from before the write. */
+    read_buffers_invalidate(area, off, len);
+
+    return ret;
+}
+
 int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
 {
     ARM_FLASH_INFO *flash_info;
@@ -389,6 +625,9 @@ int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
         return -1;
     }
 
+    /* Whole sectors are erased, which may extend past `off + len`. */
+    read_buffers_invalidate(area, off, area->fa_size - off);
+
     flash_info = DRV_FLASH_AREA(area)->GetInfo();
 
     if (flash_info->sector_info == NULL) {
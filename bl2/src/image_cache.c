@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Verified image cache
+ *
+ * Each boot, the primary slot of every image is hashed and its signature is
+ * checked. When it has passed, a record is kept of an HMAC-SHA256, computed
+ * with a device key, over:
+ *  - the image ID and the number of writes to its primary slot,
+ *  - the NV security counter of the image,
+ *  - the image header and TLV area, which hold the image hash, signature and
+ *    security counter.
+ * On the next boots, the check of the primary slot is skipped while the HMAC
+ * matches the record. The boot measurements are still taken from the TLV
+ * area, which the HMAC covers.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "boot_hal.h"
+#include "boot_image_cache.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil/image.h"
+#include "bootutil/security_cnt.h"
+#include "flash_map/flash_map.h"
+#include "mbedtls/md.h"
+#include "sysflash/sysflash.h"
+
+#define IMAGE_CACHE_READ_SIZE    (64u)
+
+static int image_cache_hmac_area(mbedtls_md_context_t *ctx,
+                                 const struct flash_area *fap,
+                                 uint32_t off, uint32_t len)
+{
+    uint8_t buf[IMAGE_CACHE_READ_SIZE];
+    uint32_t chunk;
+
+    while (len) {
+        chunk = (len < sizeof(buf)) ? len : sizeof(buf);
+        if (flash_area_read(fap, off, buf, chunk) != 0) {
+            return -1;
+        }
+        if (mbedtls_md_hmac_update(ctx, buf, chunk) != 0) {
+            return -1;
+        }
+        off += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
+/*
+ * Compute the record which matches the current content of the primary slot of
+ * the image.
+ */
+static int image_cache_compute(uint32_t image_id, uint8_t *record)
+{
+    uint8_t key[BOOT_IMAGE_CACHE_KEY_SIZE];
+    const struct flash_area *fap;
+    struct image_header hdr;
+    struct image_tlv_info info;
+    mbedtls_md_context_t ctx;
+    uint32_t tlv_off, tlv_len;
+    uint32_t write_count;
+    uint32_t nv_counter;
+    fih_int fih_cnt;
+    fih_ret fih_rc;
+    int rc = -1;
+
+    if (flash_area_open(FLASH_AREA_IMAGE_PRIMARY(image_id), &fap) != 0) {
+        return -1;
+    }
+
+    if ((flash_area_read(fap, 0, &hdr, sizeof(hdr)) != 0) ||
+        (hdr.ih_magic != IMAGE_MAGIC)) {
+        goto out_close;
+    }
+
+    /* The unprotected TLVs follow the protected ones, if any. */
+    tlv_off = hdr.ih_hdr_size + hdr.ih_img_size;
+    if ((tlv_off < hdr.ih_img_size) ||
+        (flash_area_read(fap, tlv_off + hdr.ih_protect_tlv_size,
+                         &info, sizeof(info)) != 0) ||
+        (info.it_magic != IMAGE_TLV_INFO_MAGIC)) {
+        goto out_close;
+    }
+    tlv_len = hdr.ih_protect_tlv_size + info.it_tlv_tot;
+
+    FIH_CALL(boot_nv_security_counter_get, fih_rc, image_id, &fih_cnt);
+    if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
+        goto out_close;
+    }
+    nv_counter = (uint32_t)fih_int_decode(fih_cnt);
+
+    if ((boot_platform_get_flash_write_count(fap->fa_id, &write_count) != 0) ||
+        (boot_platform_get_image_cache_key(key, sizeof(key)) != 0)) {
+        goto out_close;
+    }
+
+    mbedtls_md_init(&ctx);
+    if ((mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                          1) != 0) ||
+        (mbedtls_md_hmac_starts(&ctx, key, sizeof(key)) != 0) ||
+        (mbedtls_md_hmac_update(&ctx, (const uint8_t *)&image_id,
+                                sizeof(image_id)) != 0) ||
+        (mbedtls_md_hmac_update(&ctx, (const uint8_t *)&write_count,
+                                sizeof(write_count)) != 0) ||
+        (mbedtls_md_hmac_update(&ctx, (const uint8_t *)&nv_counter,
+                                sizeof(nv_counter)) != 0) ||
+        (mbedtls_md_hmac_update(&ctx, (const uint8_t *)&hdr,
+                                sizeof(hdr)) != 0) ||
+        (image_cache_hmac_area(&ctx, fap, tlv_off, tlv_len) != 0) ||
+        (mbedtls_md_hmac_finish(&ctx, record) != 0)) {
+        goto out_free;
+    }
+
+    rc = 0;
+
+out_free:
+    mbedtls_md_free(&ctx);
+    memset(key, 0, sizeof(key));
+out_close:
+    flash_area_close(fap);
+
+    return rc;
+}
+
+/* Constant time, so that the record cannot be guessed byte after byte. */
+static int image_cache_compare(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t diff = 0;
+    uint32_t i;
+
+    for (i = 0; i < BOOT_IMAGE_CACHE_RECORD_SIZE; i++) {
+        diff |= a[i] ^ b[i];
+    }
+
+    return diff;
+}
+
+int boot_image_cache_update(uint32_t image_id)
+{
+    uint8_t record[BOOT_IMAGE_CACHE_RECORD_SIZE];
+    uint8_t stored[BOOT_IMAGE_CACHE_RECORD_SIZE];
+
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+    /* BL2 has not verified the non-secure image, TF-M does. */
+    if (FLASH_AREA_IMAGE_PRIMARY(image_id) ==
+        MCUBOOT_NS_IMAGE_FLASH_AREA_NUM) {
+        return 0;
+    }
+#endif
+
+    if (image_cache_compute(image_id, record) != 0) {
+        return -1;
+    }
+
+    /* Spare the storage a write when the image has not changed. */
+    if ((boot_platform_read_image_cache(image_id, stored,
+                                        sizeof(stored)) == 0) &&
+        (image_cache_compare(record, stored) == 0)) {
+        return 0;
+    }
+
+    return boot_platform_write_image_cache(image_id, record, sizeof(record));
+}
+
+int boot_image_cache_check(uint32_t image_id)
+{
+    uint8_t record[BOOT_IMAGE_CACHE_RECORD_SIZE];
+    uint8_t stored[BOOT_IMAGE_CACHE_RECORD_SIZE];
+
+    if ((image_cache_compute(image_id, record) != 0) ||
+        (boot_platform_read_image_cache(image_id, stored,
+                                        sizeof(stored)) != 0) ||
+        (image_cache_compare(record, stored) != 0)) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* MCUboot image access hooks
+ *
+ * The check of the image in a primary slot is skipped when:
+ *  - MCUBOOT_VERIFIED_IMAGE_CACHE is enabled and the image has not changed
+ *    since it was last verified,
+ *  - MCUBOOT_DEFER_NS_VERIFICATION is enabled and it is the non-secure image,
+ *    which TF-M verifies before it is started.
+ * The secondary slots are always checked before an upgrade.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bootutil/boot_hooks.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "sysflash/sysflash.h"
+#ifdef MCUBOOT_VERIFIED_IMAGE_CACHE
+#include "boot_image_cache.h"
+#endif
+
+fih_ret boot_image_check_hook(int img_index, int slot)
+{
+    /* Images are only ever booted from the primary slot. */
+    if (slot != 0) {
+        FIH_RET(FIH_BOOT_HOOK_REGULAR);
+    }
+
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+    if (FLASH_AREA_IMAGE_PRIMARY(img_index) ==
+        MCUBOOT_NS_IMAGE_FLASH_AREA_NUM) {
+        BOOT_LOG_INF("Image %d is verified by TF-M before it is started",
+                     img_index);
+        FIH_RET(FIH_SUCCESS);
+    }
+#endif
+
+#ifdef MCUBOOT_VERIFIED_IMAGE_CACHE
+    if (boot_image_cache_check(img_index) == 0) {
+        BOOT_LOG_INF("Image %d unchanged since verified, skipping hash check",
+                     img_index);
+        FIH_RET(FIH_SUCCESS);
+    }
+#endif
+
+    FIH_RET(FIH_BOOT_HOOK_REGULAR);
+}
+
+int boot_read_image_header_hook(int img_index, int slot,
+                                struct image_header *img_head)
+{
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_perform_update_hook(int img_index, struct image_header *img_head,
+                             const struct flash_area *area)
+{
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_copy_region_post_hook(int img_index, const struct flash_area *area,
+                               size_t size)
+{
+    return 0;
+}
+
+int boot_read_swap_state_primary_slot_hook(int image_index,
+                                           struct boot_swap_state *state)
+{
+    return BOOT_HOOK_REGULAR;
+}
+
+int boot_serial_uploaded_hook(int img_index, const struct flash_area *area,
+                              size_t size)
+{
+    return 0;
+}
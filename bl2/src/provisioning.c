@@ -102,6 +102,72 @@ static const struct bl2_assembly_and_test_provisioning_data_t bl2_assembly_and_t
         0xdf, 0x34, 0xc3, 0x29, 0x48, 0x9a, 0xdc, 0x38,
     },
 #endif /* MCUBOOT_IMAGE_NUMBER > 3 */
+#elif defined(MCUBOOT_SIGN_EC256)
+    /* bl2 rotpk 0 */
+    {
+        0x66, 0xc7, 0x03, 0xe9, 0xc2, 0x7b, 0xda, 0xc3,
+        0x12, 0x4e, 0x91, 0x02, 0xd8, 0xff, 0x1f, 0xd9,
+        0xcd, 0x64, 0xc5, 0x96, 0xda, 0xa0, 0x52, 0x3a,
+        0x5d, 0x36, 0xba, 0x24, 0xc3, 0x92, 0x27, 0xd3,
+    },
+    /* bl2 rotpk 1 */
+    {
+        0x47, 0x78, 0xcc, 0x15, 0x6b, 0x79, 0x08, 0x26,
+        0x61, 0xff, 0x64, 0x6f, 0xa9, 0x20, 0x35, 0x7a,
+        0x03, 0xb3, 0xe2, 0x19, 0x7f, 0x10, 0xa2, 0x94,
+        0x3d, 0xdb, 0xab, 0xee, 0x06, 0xb9, 0x3a, 0xbb,
+    },
+#if (MCUBOOT_IMAGE_NUMBER > 2)
+    /* bl2 rotpk 2 */
+    {
+        0x66, 0xc7, 0x03, 0xe9, 0xc2, 0x7b, 0xda, 0xc3,
+        0x12, 0x4e, 0x91, 0x02, 0xd8, 0xff, 0x1f, 0xd9,
+        0xcd, 0x64, 0xc5, 0x96, 0xda, 0xa0, 0x52, 0x3a,
+        0x5d, 0x36, 0xba, 0x24, 0xc3, 0x92, 0x27, 0xd3,
+    },
+#endif /* MCUBOOT_IMAGE_NUMBER > 2 */
+#if (MCUBOOT_IMAGE_NUMBER > 3)
+    /* bl2 rotpk 3 */
+    {
+        0x66, 0xc7, 0x03, 0xe9, 0xc2, 0x7b, 0xda, 0xc3,
+        0x12, 0x4e, 0x91, 0x02, 0xd8, 0xff, 0x1f, 0xd9,
+        0xcd, 0x64, 0xc5, 0x96, 0xda, 0xa0, 0x52, 0x3a,
+        0x5d, 0x36, 0xba, 0x24, 0xc3, 0x92, 0x27, 0xd3,
+    },
+#endif /* MCUBOOT_IMAGE_NUMBER > 3 */
+#elif defined(MCUBOOT_SIGN_ED25519)
+    /* bl2 rotpk 0 */
+    {
+        0xb2, 0xaf, 0xb6, 0x15, 0x2e, 0x62, 0xa3, 0x62,
+        0x8b, 0x53, 0xdd, 0xc6, 0xba, 0xce, 0xa9, 0x50,
+        0x90, 0x70, 0x42, 0x28, 0x2d, 0xaa, 0xdb, 0x63,
+        0xd6, 0xee, 0xf0, 0x0e, 0xa0, 0x58, 0xfc, 0x34,
+    },
+    /* bl2 rotpk 1 */
+    {
+        0x98, 0xe3, 0xad, 0x5a, 0x3e, 0xdc, 0x98, 0x04,
+        0xa4, 0xbb, 0xed, 0x4d, 0x50, 0xed, 0x18, 0x3e,
+        0x94, 0x43, 0x54, 0xd0, 0x7b, 0xab, 0xa5, 0x82,
+        0x0b, 0x6d, 0xeb, 0x78, 0xd5, 0x23, 0xf0, 0x13,
+    },
+#if (MCUBOOT_IMAGE_NUMBER > 2)
+    /* bl2 rotpk 2 */
+    {
+        0xb2, 0xaf, 0xb6, 0x15, 0x2e, 0x62, 0xa3, 0x62,
+        0x8b, 0x53, 0xdd, 0xc6, 0xba, 0xce, 0xa9, 0x50,
+        0x90, 0x70, 0x42, 0x28, 0x2d, 0xaa, 0xdb, 0x63,
+        0xd6, 0xee, 0xf0, 0x0e, 0xa0, 0x58, 0xfc, 0x34,
+    },
+#endif /* MCUBOOT_IMAGE_NUMBER > 2 */
+#if (MCUBOOT_IMAGE_NUMBER > 3)
+    /* bl2 rotpk 3 */
+    {
+        0xb2, 0xaf, 0xb6, 0x15, 0x2e, 0x62, 0xa3, 0x62,
+        0x8b, 0x53, 0xdd, 0xc6, 0xba, 0xce, 0xa9, 0x50,
+        0x90, 0x70, 0x42, 0x28, 0x2d, 0xaa, 0xdb, 0x63,
+        0xd6, 0xee, 0xf0, 0x0e, 0xa0, 0x58, 0xfc, 0x34,
+    },
+#endif /* MCUBOOT_IMAGE_NUMBER > 3 */
 #else
 #error "No public key available for given signing algorithm."
 #endif /* MCUBOOT_SIGN_RSA_LEN */
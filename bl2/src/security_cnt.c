@@ -9,6 +9,9 @@
 #include "../../platform/include/tfm_plat_nv_counters.h"
 #include "../../platform/include/tfm_plat_defs.h"
 #include "bootutil/fault_injection_hardening.h"
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+#include "sysflash/sysflash.h"
+#endif
 #include <stdint.h>
 
 #define TFM_BOOT_NV_COUNTER_0    PLAT_NV_COUNTER_BL2_0   /* NV counter of Image 0 */
@@ -81,6 +84,16 @@ int32_t boot_nv_security_counter_update(uint32_t image_id,
         return -1;
     }
 
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+    /* The counter of the non-secure image is only raised by TF-M, once it has
+     * verified the image.
+     */
+    if (FLASH_AREA_IMAGE_PRIMARY(image_id) ==
+        MCUBOOT_NS_IMAGE_FLASH_AREA_NUM) {
+        return 0;
+    }
+#endif
+
     err = tfm_plat_set_nv_counter(nv_counter, img_security_cnt);
     if (err != TFM_PLAT_ERR_SUCCESS) {
         return -1;
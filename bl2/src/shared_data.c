@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -11,6 +11,10 @@
 #include "flash_map/flash_map.h"
 #include "sysflash/sysflash.h"
 #include "mcuboot_config/mcuboot_config.h"
+#ifdef TFM_BOOT_TIMING
+#include "boot_hal.h"
+#include "tfm_boot_status.h"
+#endif
 
 #if defined(CONFIG_TFM_BOOT_STORE_MEASUREMENTS) && !defined(MCUBOOT_MEASURED_BOOT)
 #include <stdio.h>
@@ -24,7 +28,16 @@
 
 #ifdef MCUBOOT_HW_KEY
 #include  "bootutil/crypto/sha256.h"
-#define SIG_BUF_SIZE (MCUBOOT_SIGN_RSA_LEN / 8)
+#if defined(MCUBOOT_SIGN_RSA)
+/* Few extra bytes for encoding and for public exponent. */
+#define KEY_BUF_SIZE ((MCUBOOT_SIGN_RSA_LEN / 8) + 24)
+#elif defined(MCUBOOT_SIGN_EC256)
+/* DER encoded SubjectPublicKeyInfo holding an uncompressed P-256 point. */
+#define KEY_BUF_SIZE (91)
+#elif defined(MCUBOOT_SIGN_ED25519)
+/* DER encoded SubjectPublicKeyInfo holding an Ed25519 key. */
+#define KEY_BUF_SIZE (44)
+#endif
 #endif
 #endif /* CONFIG_TFM_BOOT_STORE_MEASUREMENTS && !MCUBOOT_MEASURED_BOOT */
 
@@ -72,8 +85,7 @@ static int collect_image_measurement_and_metadata(
     uint16_t len;
     uint16_t type;
 #ifdef MCUBOOT_HW_KEY
-    /* Few extra bytes for encoding and for public exponent. */
-    uint8_t key_buf[SIG_BUF_SIZE + 24];
+    uint8_t key_buf[KEY_BUF_SIZE];
     bootutil_sha256_context sha256_ctx;
 #endif
     int rc;
@@ -219,6 +231,11 @@ int boot_save_shared_data(const struct image_header *hdr,
         return -1;
     }
 
+#ifdef TFM_BOOT_TIMING
+    (void)boot_store_timestamp(BOOT_TIMING_BL2_SHARED_DATA, mcuboot_image_id,
+                               mcuboot_image_id);
+#endif
+
 #ifdef TFM_PARTITION_FIRMWARE_UPDATE
     image_ver = hdr->ih_ver;
 
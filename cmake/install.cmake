@@ -46,6 +46,8 @@ install(FILES       ${CMAKE_SOURCE_DIR}/config/config_base.h
         DESTINATION ${INSTALL_INTERFACE_INC_DIR})
 
 install(FILES       ${INTERFACE_INC_DIR}/tfm_psa_call_pack.h
+                    ${INTERFACE_INC_DIR}/tfm_psa_call_batch.h
+                    ${INTERFACE_INC_DIR}/tfm_psa_call_async.h
         DESTINATION ${INSTALL_INTERFACE_INC_DIR})
 install(FILES       ${CMAKE_BINARY_DIR}/generated/interface/include/psa/framework_feature.h
         DESTINATION ${INSTALL_INTERFACE_INC_DIR}/psa)
@@ -99,6 +101,13 @@ endif()
 
 if(TFM_PARTITION_PLATFORM)
     install(FILES       ${INTERFACE_INC_DIR}/tfm_platform_api.h
+                        ${INTERFACE_INC_DIR}/tfm_service_stats.h
+            DESTINATION ${INSTALL_INTERFACE_INC_DIR})
+endif()
+
+if(TFM_PARTITION_PERF)
+    install(FILES       ${INTERFACE_INC_DIR}/tfm_perf_api.h
+                        ${INTERFACE_INC_DIR}/tfm_perf_defs.h
             DESTINATION ${INSTALL_INTERFACE_INC_DIR})
 endif()
 
@@ -122,6 +131,7 @@ if (TFM_PARTITION_NS_AGENT_MAILBOX)
                         ${INTERFACE_SRC_DIR}/multi_core/tfm_multi_core_ns_api.c
                         ${INTERFACE_SRC_DIR}/multi_core/tfm_multi_core_psa_ns_api.c
                         ${INTERFACE_SRC_DIR}/multi_core/tfm_ns_mailbox_thread.c
+                        ${INTERFACE_SRC_DIR}/multi_core/tfm_ns_mailbox_zephyr.c
             DESTINATION ${INSTALL_INTERFACE_SRC_DIR}/multi_core)
 endif()
 
@@ -163,6 +173,11 @@ if(TFM_PARTITION_PLATFORM)
             DESTINATION ${INSTALL_INTERFACE_SRC_DIR})
 endif()
 
+if(TFM_PARTITION_PERF)
+    install(FILES       ${INTERFACE_SRC_DIR}/tfm_perf_api.c
+            DESTINATION ${INSTALL_INTERFACE_SRC_DIR})
+endif()
+
 
 ##################### Export image signing information #########################
 
@@ -28,13 +28,27 @@ tfm_invalid_config(TFM_ISOLATION_LEVEL EQUAL 3 AND NOT PLATFORM_HAS_ISOLATION_L3
 tfm_invalid_config(TFM_ISOLATION_LEVEL GREATER 1 AND PSA_FRAMEWORK_HAS_MM_IOVEC)
 
 tfm_invalid_config(TFM_MULTI_CORE_TOPOLOGY AND TFM_NS_MANAGE_NSID)
+tfm_invalid_config(CONFIG_TFM_MEMORY_CHECK_CACHE AND NOT TFM_NS_MANAGE_NSID)
 tfm_invalid_config(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM AND NOT TFM_MULTI_CORE_TOPOLOGY)
 # Multi-core platform with mailbox partition cannot fully work with SFN backend yet.
 tfm_invalid_config(TFM_PARTITION_NS_AGENT_MAILBOX AND CONFIG_TFM_SPM_BACKEND_SFN)
+tfm_invalid_config(NUM_SPE_MAILBOX_QUEUE_SLOT GREATER NUM_MAILBOX_QUEUE_SLOT)
+
+# The secure cores share the SPM with the SVC calls of the IPC backend
+set (VALID_SECURE_CORE_NUMS 1 2)
+tfm_invalid_config(NOT TFM_SPM_SECURE_CORE_NUM IN_LIST VALID_SECURE_CORE_NUMS)
+tfm_invalid_config(TFM_SPM_SECURE_CORE_NUM GREATER 1 AND NOT CONFIG_TFM_SPM_BACKEND_IPC)
+tfm_invalid_config(TFM_SPM_SECURE_CORE_NUM GREATER 1 AND TFM_ISOLATION_LEVEL EQUAL 1)
 
 tfm_invalid_config(TFM_ISOLATION_LEVEL EQUAL 3 AND CONFIG_TFM_STACK_WATERMARKS)
+tfm_invalid_config(CONFIG_TFM_STACK_PROFILE AND NOT CONFIG_TFM_STACK_WATERMARKS)
+tfm_invalid_config(CONFIG_TFM_STACK_PROFILE AND CONFIG_TFM_SPM_BACKEND_SFN)
+
+# The buffered log output is sent to the UART from the Idle Partition
+tfm_invalid_config(TFM_SPM_LOG_BUFFERED AND NOT (CONFIG_TFM_FLIH_API OR CONFIG_TFM_SLIH_API OR TFM_MULTI_CORE_TOPOLOGY))
 
 tfm_invalid_config((TFM_S_REG_TEST OR TFM_NS_REG_TEST) AND TEST_PSA_API)
+tfm_invalid_config(TFM_PERF AND TEST_PSA_API)
 
 tfm_invalid_config(SUITE STREQUAL "IPC" AND NOT TEST_PSA_API STREQUAL "IPC")
 
@@ -48,6 +62,8 @@ tfm_invalid_config(TEST_PSA_API STREQUAL "STORAGE" AND NOT TFM_PARTITION_PROTECT
 ########################## BL1 #################################################
 
 tfm_invalid_config((BL1 AND PLATFORM_DEFAULT_BL1 AND CONFIG_TFM_BOOT_STORE_MEASUREMENTS) AND NOT TFM_PARTITION_MEASURED_BOOT)
+tfm_invalid_config(TFM_BL1_PQ_CRYPTO_HASH_CHAIN AND NOT TFM_BL1_PQ_CRYPTO)
+tfm_invalid_config(TFM_BL1_PQ_CRYPTO_HASH_CHAIN AND TFM_BL1_SOFTWARE_CRYPTO)
 
 ########################## BL2 #################################################
 
@@ -56,9 +72,19 @@ tfm_invalid_config(BL2 AND (NOT MCUBOOT_UPGRADE_STRATEGY IN_LIST MCUBOOT_STRATEG
 
 # Maximum number of MCUBoot images supported by TF-M NV counters and ROTPKs
 tfm_invalid_config(MCUBOOT_IMAGE_NUMBER GREATER 4)
+get_property(MCUBOOT_SIGNATURE_TYPE_LIST CACHE MCUBOOT_SIGNATURE_TYPE PROPERTY STRINGS)
+tfm_invalid_config(BL2 AND (NOT MCUBOOT_SIGNATURE_TYPE IN_LIST MCUBOOT_SIGNATURE_TYPE_LIST) AND NOT USE_KCONFIG_TOOL)
+tfm_invalid_config(BL2 AND MCUBOOT_SIGNATURE_TYPE STREQUAL "RSA" AND NOT (MCUBOOT_SIGNATURE_KEY_LEN EQUAL 2048 OR MCUBOOT_SIGNATURE_KEY_LEN EQUAL 3072))
+tfm_invalid_config(BL2 AND (MCUBOOT_SIGNATURE_TYPE STREQUAL "EC" OR MCUBOOT_SIGNATURE_TYPE STREQUAL "ED25519") AND NOT MCUBOOT_SIGNATURE_KEY_LEN EQUAL 256)
+tfm_invalid_config(MCUBOOT_VERIFIED_IMAGE_CACHE AND (MCUBOOT_UPGRADE_STRATEGY STREQUAL "DIRECT_XIP" OR MCUBOOT_UPGRADE_STRATEGY STREQUAL "RAM_LOAD"))
+tfm_invalid_config(MCUBOOT_DEFER_NS_VERIFICATION AND (MCUBOOT_IMAGE_NUMBER LESS 2 OR NOT MCUBOOT_UPGRADE_STRATEGY STREQUAL "OVERWRITE_ONLY"))
+tfm_invalid_config(MCUBOOT_DEFER_NS_VERIFICATION AND NOT (MCUBOOT_HW_KEY AND MCUBOOT_HW_ROLLBACK_PROT AND DEFAULT_MCUBOOT_SECURITY_COUNTERS))
+tfm_invalid_config(MCUBOOT_DEFER_NS_VERIFICATION AND NOT MCUBOOT_SIGNATURE_TYPE STREQUAL "RSA")
+tfm_invalid_config(MCUBOOT_DEFER_NS_VERIFICATION AND NOT (TFM_PARTITION_FIRMWARE_UPDATE AND TFM_PARTITION_NS_AGENT_TZ))
 
 tfm_invalid_config((BL2 AND CONFIG_TFM_BOOT_STORE_MEASUREMENTS AND NOT CONFIG_TFM_BOOT_STORE_ENCODED_MEASUREMENTS) AND NOT MCUBOOT_DATA_SHARING)
-tfm_invalid_config((NOT (TFM_PARTITION_FIRMWARE_UPDATE OR CONFIG_TFM_BOOT_STORE_MEASUREMENTS)) AND MCUBOOT_DATA_SHARING)
+tfm_invalid_config((NOT (TFM_PARTITION_FIRMWARE_UPDATE OR CONFIG_TFM_BOOT_STORE_MEASUREMENTS OR TFM_BOOT_TIMING)) AND MCUBOOT_DATA_SHARING)
+tfm_invalid_config(TFM_BOOT_TIMING AND NOT (BL2 AND MCUBOOT_DATA_SHARING AND TFM_PARTITION_PLATFORM))
 
 get_property(MCUBOOT_ALIGN_VAL_LIST CACHE MCUBOOT_ALIGN_VAL PROPERTY STRINGS)
 tfm_invalid_config(BL2 AND (NOT MCUBOOT_ALIGN_VAL IN_LIST MCUBOOT_ALIGN_VAL_LIST) AND NOT USE_KCONFIG_TOOL)
@@ -96,6 +122,10 @@ tfm_invalid_config(TFM_PARTITION_PROTECTED_STORAGE AND NOT TFM_PARTITION_PLATFOR
 get_property(TFM_FIH_PROFILE_LIST CACHE TFM_FIH_PROFILE PROPERTY STRINGS)
 tfm_invalid_config(NOT TFM_FIH_PROFILE IN_LIST TFM_FIH_PROFILE_LIST)
 
+# The runtime path shares the fih_int type and the CFI counter of the image, so
+# it can only drop the random delays of the HIGH profile.
+tfm_invalid_config(NOT TFM_FIH_PROFILE_RUNTIME STREQUAL "" AND NOT (TFM_FIH_PROFILE_RUNTIME STREQUAL "MEDIUM" AND TFM_FIH_PROFILE STREQUAL "HIGH"))
+
 ########################### TF-M initial attestation #####################################
 
 tfm_invalid_config(ATTEST_INCLUDE_TEST_CODE AND NOT (TEST_NS_ATTESTATION OR TEST_S_ATTESTATION))
@@ -37,6 +37,7 @@ set(PSA_ARCH_TESTS_FORCE_PATCH          OFF         CACHE BOOL      "Always appl
 set(PLATFORM_PSA_ADAC_SECURE_DEBUG      FALSE       CACHE BOOL      "Whether to use psa-adac secure debug.")
 set(PLATFORM_PSA_ADAC_SOURCE_PATH       "DOWNLOAD"  CACHE PATH      "Path to source dir of psa-adac.")
 set(PLATFORM_PSA_ADAC_VERSION           "4c35930fb6df95400ea4fe5722acaaa594ac3b8b" CACHE STRING "The version of psa-adac to use.")
+set(PLATFORM_PSA_ADAC_TIMING            FALSE       CACHE BOOL      "Whether to log the cycles spent in the psa-adac secure debug handshake.")
 
 set(PLATFORM_IS_FVP                     FALSE       CACHE BOOL      "Whether to enable FVP or FPGA build of the platform.")
 
@@ -52,6 +53,7 @@ set(NS_EVALUATION_APP_PATH              ""          CACHE PATH      "Path to TFM
 set(TEST_S                              OFF         CACHE BOOL      "Whether to build S regression tests")
 set(TEST_NS                             OFF         CACHE BOOL      "Whether to build NS regression tests")
 set(TEST_PSA_API                        ""          CACHE STRING    "Which (if any) of the PSA API tests should be compiled")
+set(TFM_PERF                            OFF         CACHE BOOL      "Build the performance measurement configuration of config/tests/config_perf.cmake")
 set(TEST_BL1_1                          OFF         CACHE BOOL      "Whether to build BL1_1 tests")
 set(TEST_BL1_2                          OFF         CACHE BOOL      "Whether to build BL1_2 tests")
 
@@ -59,11 +61,13 @@ set(TFM_ISOLATION_LEVEL                 1           CACHE STRING    "Isolation l
 set(PSA_FRAMEWORK_HAS_MM_IOVEC          OFF         CACHE BOOL      "Enable MM-IOVEC")
 set(TFM_PROFILE                         ""          CACHE STRING    "Profile to use")
 set(TFM_FIH_PROFILE                     OFF         CACHE STRING    "Fault injection hardening profile [OFF, LOW, MEDIUM, HIGH]")
+set(TFM_FIH_PROFILE_RUNTIME             ""          CACHE STRING    "Fault injection hardening profile of the SPM runtime path, MEDIUM to drop the random delays of a HIGH TFM_FIH_PROFILE. Empty to use TFM_FIH_PROFILE")
 set(CONFIG_TFM_SPM_BACKEND              "SFN"       CACHE STRING    "The SPM backend [IPC, SFN]")
 
 # An NSPE client_id is provided by the NSPE OS via the SPM or directly by the SPM.
 # When `TFM_NS_MANAGE_NSID` is `ON`, TF-M supports NSPE OS providing NSPE client_id.
 set(TFM_NS_MANAGE_NSID                  OFF         CACHE BOOL      "Support NSPE OS providing NSPE client_id")
+set(TFM_NS_CLIENT_THREAD_NUM            1           CACHE STRING    "Number of NSPE threads calling secure services at the same time. Used to size the connection pool")
 
 set(TFM_EXTRA_CONFIG_PATH               ""          CACHE PATH      "Path to extra cmake config file")
 
@@ -75,6 +79,7 @@ set(TFM_EXTRA_PARTITION_PATHS           ""          CACHE PATH      "List of ext
 set(TFM_CODE_SHARING                    OFF         CACHE PATH      "Enable code sharing between MCUboot and secure firmware")
 set(CONFIG_TFM_BOOT_STORE_MEASUREMENTS  ON          CACHE BOOL      "Store measurement values from all the boot stages. Used for initial attestation token.")
 set(CONFIG_TFM_BOOT_STORE_ENCODED_MEASUREMENTS  ON  CACHE BOOL      "Enable storing of encoded measurements in boot.")
+set(TFM_BOOT_TIMING                     OFF         CACHE BOOL      "Record a timestamp at each boot phase in the shared data area, readable through the Platform Service.")
 
 set(TFM_PXN_ENABLE                      OFF         CACHE BOOL      "Use Privileged execute never (PXN)")
 
@@ -83,10 +88,19 @@ set(TFM_EXCEPTION_INFO_DUMP             OFF         CACHE BOOL      "On fatal er
 set(CONFIG_TFM_HALT_ON_CORE_PANIC       OFF         CACHE BOOL       "On fatal errors in the secure firmware, halt instead of rebooting.")
 
 set(CONFIG_TFM_STACK_WATERMARKS         OFF         CACHE BOOL      "Whether to pre-fill partition stacks with a set value to help determine stack usage")
+set(CONFIG_TFM_STACK_PROFILE            OFF         CACHE BOOL      "Whether to record the peak stack usage of each service and message type, refilling the watermarks after each psa_reply")
+set(CONFIG_TFM_STACK_PROFILE_ENTRIES    32          CACHE STRING    "Number of service and message type pairs recorded by the stack profile")
+set(CONFIG_TFM_SPM_TRACE                OFF         CACHE BOOL      "Whether to record SPM scheduling, PSA call/reply and interrupt events with cycle timestamps in a ring buffer")
+set(CONFIG_TFM_MEMORY_CHECK_CACHE       OFF         CACHE BOOL      "Whether to cache Non-secure buffer ranges already validated by tfm_hal_memory_check")
+set(TFM_S_LINK_ORDER_FILE               ""          CACHE FILEPATH  "Link order header generated by tools/tfm_link_order.py from a function hit count profile, to place the hot functions first in their sections with the GNU linker scripts of TF-M")
+set(CONFIG_TFM_SPM_HOT_PATH_IN_RAM      OFF         CACHE BOOL      "Whether to run the SPM IPC path from the platform code RAM (S_RAM_CODE_START), with the GNU linker scripts of TF-M")
+set(TFM_SPM_SECURE_CORE_NUM             1           CACHE STRING    "Number of secure cores running the Secure Partitions, each Partition is pinned to the core of its manifest \"core\" attribute. The platform implements tfm_hal_secure_cores.h if greater than 1")
 
 ############################ Platform ##########################################
 
-set(NUM_MAILBOX_QUEUE_SLOT              1           CACHE BOOL      "Number of mailbox queue slots")
+set(NUM_MAILBOX_QUEUE_SLOT              1           CACHE BOOL      "Number of mailbox queue slots, up to 255")
+set(NUM_MAILBOX_QUEUE                   1           CACHE STRING    "Number of NSPE mailbox queues, one per NS core or priority class. SPE handles queue 0 first")
+set(NUM_SPE_MAILBOX_QUEUE_SLOT          0           CACHE STRING    "Number of SPE mailbox queue slots, fewer than NUM_MAILBOX_QUEUE_SLOT queues the extra NSPE requests. 0 to use NUM_MAILBOX_QUEUE_SLOT")
 set(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM   OFF         CACHE BOOL      "Whether to use a platform specific inter-core communication instead of mailbox in dual-cpu topology")
 
 set(DEBUG_AUTHENTICATION                CHIP_DEFAULT CACHE STRING   "Debug authentication setting. [CHIP_DEFAULT, NONE, NS_ONLY, FULL")
@@ -110,6 +124,8 @@ set(PLATFORM_DEFAULT_OTP                ON          CACHE BOOL      "Use trusted
 set(PLATFORM_DEFAULT_OTP_WRITEABLE      ON          CACHE BOOL      "Use OTP memory with write support")
 set(PLATFORM_DEFAULT_PROVISIONING       ON          CACHE BOOL      "Use default provisioning implementation")
 set(PLATFORM_DEFAULT_SYSTEM_RESET_HALT  ON          CACHE BOOL      "Use default system reset/halt implementation")
+set(PLATFORM_DEFAULT_IDLE               ON          CACHE BOOL      "Use default secure idle low-power implementation")
+set(PLATFORM_DEFAULT_SPM_TICK           ON          CACHE BOOL      "Use the secure SysTick as the default SPM timer tick")
 set(PLATFORM_DEFAULT_IMAGE_SIGNING      ON          CACHE BOOL      "Use default image signing implementation")
 
 set(TFM_DUMMY_PROVISIONING              ON          CACHE BOOL      "Provision with dummy values. NOT to be used in production")
@@ -137,6 +153,8 @@ set(ATTEST_KEY_BITS                     256         CACHE STRING    "The size of
 
 set(TFM_PARTITION_PLATFORM              OFF         CACHE BOOL      "Enable Platform partition")
 
+set(TFM_PARTITION_PERF                  OFF         CACHE BOOL      "Enable Perf partition, the null service and benchmark marker of TFM_PERF")
+
 ############################ Mbedcrypto configurations #########################
 
 set(MBEDCRYPTO_BUILD_TYPE               "${CMAKE_BUILD_TYPE}" CACHE STRING "Build type of Mbed Crypto library")
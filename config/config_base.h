@@ -43,16 +43,100 @@
 #define CRYPTO_ENGINE_BUF_SIZE                 0x2080
 #endif
 
-/* The max number of concurrent operations that can be active (allocated) at any time in Crypto */
+/* The size of the bump arena at the start of the engine buffer.
+ * 0 keeps the mbed TLS buffer allocator managing the whole buffer.
+ */
+#ifndef CRYPTO_ENGINE_BUF_ARENA_SIZE
+#define CRYPTO_ENGINE_BUF_ARENA_SIZE           0x0
+#endif
+
+/* The default max number of concurrent operations of each type in Crypto */
 #ifndef CRYPTO_CONC_OPER_NUM
 #define CRYPTO_CONC_OPER_NUM                   8
 #endif
 
+/*
+ * The max number of concurrent operations of each type. Each type defaults to
+ * CRYPTO_CONC_OPER_NUM, the number of operations of any type the shared pool
+ * used to hold, so that no existing configuration supports fewer.
+ */
+#ifndef CRYPTO_CONC_CIPHER_OPER_NUM
+#define CRYPTO_CONC_CIPHER_OPER_NUM            CRYPTO_CONC_OPER_NUM
+#endif
+
+#ifndef CRYPTO_CONC_MAC_OPER_NUM
+#define CRYPTO_CONC_MAC_OPER_NUM               CRYPTO_CONC_OPER_NUM
+#endif
+
+#ifndef CRYPTO_CONC_HASH_OPER_NUM
+#define CRYPTO_CONC_HASH_OPER_NUM              CRYPTO_CONC_OPER_NUM
+#endif
+
+#ifndef CRYPTO_CONC_KEY_DERIVATION_OPER_NUM
+#define CRYPTO_CONC_KEY_DERIVATION_OPER_NUM    CRYPTO_CONC_OPER_NUM
+#endif
+
+#ifndef CRYPTO_CONC_AEAD_OPER_NUM
+#define CRYPTO_CONC_AEAD_OPER_NUM              CRYPTO_CONC_OPER_NUM
+#endif
+
+/* The number of per-user derived builtin subkeys cached by the builtin key
+ * loader, 0 to re-derive on every use
+ */
+#ifndef CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM
+#define CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM   4
+#endif
+
+/* The number of multipart calls after which an idle operation context may be
+ * reclaimed when its pool is exhausted, 0 to never reclaim contexts
+ */
+#ifndef CRYPTO_CONC_OPER_LEASE
+#define CRYPTO_CONC_OPER_LEASE                 0
+#endif
+
 /* Enable PSA Crypto random number generator module */
 #ifndef CRYPTO_RNG_MODULE_ENABLED
 #define CRYPTO_RNG_MODULE_ENABLED              1
 #endif
 
+/* The size of the pool of DRBG output serving small random requests, 0 to disable */
+#ifndef CRYPTO_RNG_POOL_SIZE
+#define CRYPTO_RNG_POOL_SIZE                   0
+#endif
+
+/* The largest psa_generate_random() request served from the random pool */
+#ifndef CRYPTO_RNG_POOL_MAX_REQUEST
+#define CRYPTO_RNG_POOL_MAX_REQUEST            32
+#endif
+
+/* The number of key slots of the PSA Crypto core, i.e. how many volatile and
+ * loaded persistent keys are held in RAM at once
+ */
+#ifndef CRYPTO_KEY_SLOT_COUNT
+#define CRYPTO_KEY_SLOT_COUNT                  32
+#endif
+
+/* Use the precomputed tables of the curve generators for fixed-point ECC
+ * multiplications, e.g. in ECDSA signing, trading flash for speed
+ */
+#ifndef CRYPTO_ECP_FIXED_POINT_OPTIM
+#define CRYPTO_ECP_FIXED_POINT_OPTIM           0
+#endif
+
+/* The number of ECC operations of each step of a hash signature, between the
+ * preemption points of the crypto service, 0 to sign in one go
+ */
+#ifndef CRYPTO_SIGN_HASH_MAX_OPS
+#define CRYPTO_SIGN_HASH_MAX_OPS               0
+#endif
+
+/* Build the software AES and SHA-256 of the crypto library for speed instead
+ * of footprint, for platforms without a crypto accelerator
+ */
+#ifndef CRYPTO_SW_SPEED_OPTIM
+#define CRYPTO_SW_SPEED_OPTIM                  0
+#endif
+
 /* Enable PSA Crypto Key module */
 #ifndef CRYPTO_KEY_MODULE_ENABLED
 #define CRYPTO_KEY_MODULE_ENABLED              1
@@ -111,6 +195,14 @@
 #define CRYPTO_SINGLE_PART_FUNCS_DISABLED      0
 #endif
 
+/*
+ * One-shot hash, MAC and cipher calls with an input up to this size are served
+ * from stack buffers, bypassing the scratch and sub-module dispatch. 0 disables.
+ */
+#ifndef CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE
+#define CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE  64
+#endif
+
 /* The stack size of the Crypto Secure Partition */
 #ifndef CRYPTO_STACK_SIZE
 #define CRYPTO_STACK_SIZE                      0x1B00
@@ -123,6 +215,41 @@
 #define TFM_FWU_BUF_SIZE                       PSA_FWU_MAX_WRITE_SIZE
 #endif
 
+/* Hash the image blocks as they are loaded, in place of reading them back */
+#ifndef FWU_HASH_ON_LOAD
+#define FWU_HASH_ON_LOAD                       0
+#endif
+
+/* Erase the staging area ahead of the loaded blocks, not all at start */
+#ifndef FWU_ERASE_ON_LOAD
+#define FWU_ERASE_ON_LOAD                      0
+#endif
+
+/* Accept images as a delta against the active image */
+#ifndef FWU_DELTA_UPDATE
+#define FWU_DELTA_UPDATE                       0
+#endif
+
+/* Accept images compressed as an LZ4 block */
+#ifndef FWU_COMPRESSED_UPDATE
+#define FWU_COMPRESSED_UPDATE                  0
+#endif
+
+/* Size of the buffer for the image data produced from a stream, per component */
+#ifndef FWU_STREAM_BUF_SIZE
+#define FWU_STREAM_BUF_SIZE                    0x100
+#endif
+
+/* Interval at which the write progress is recorded in ITS, 0 to disable */
+#ifndef FWU_RESUME_CHECKPOINT_SIZE
+#define FWU_RESUME_CHECKPOINT_SIZE             0
+#endif
+
+/* Count the cycles spent in each stage of writing an image */
+#ifndef FWU_WRITE_STATS
+#define FWU_WRITE_STATS                        0
+#endif
+
 /* The stack size of the Firmware Update Secure Partition */
 #ifndef FWU_STACK_SIZE
 #define FWU_STACK_SIZE                         0x600
@@ -140,6 +267,16 @@
 #define ATTEST_INCLUDE_COSE_KEY_ID             0
 #endif
 
+/* Size of the buffer caching the claims that are static for the boot */
+#ifndef ATTEST_STATIC_CLAIMS_CACHE_SIZE
+#define ATTEST_STATIC_CLAIMS_CACHE_SIZE        0
+#endif
+
+/* Count the cycles of each stage of the token creation */
+#ifndef ATTEST_TOKEN_STATS
+#define ATTEST_TOKEN_STATS                     0
+#endif
+
 /* The stack size of the Initial Attestation Secure Partition */
 #ifndef ATTEST_STACK_SIZE
 #define ATTEST_STACK_SIZE                      0x700
@@ -164,11 +301,56 @@
 #define ITS_RAM_FS                             0
 #endif
 
+/* Store the files directly in the RAM of the RAM FS, without flash emulation */
+#ifndef ITS_RAM_OBJECT_STORE
+#define ITS_RAM_OBJECT_STORE                   0
+#endif
+
 /* Validate filesystem metadata every time it is read from flash */
 #ifndef ITS_VALIDATE_METADATA_FROM_FLASH
 #define ITS_VALIDATE_METADATA_FROM_FLASH       1
 #endif
 
+/* Keep a RAM index of the file metadata to avoid flash reads on lookups */
+#ifndef ITS_FILE_INDEX
+#define ITS_FILE_INDEX                         0
+#endif
+
+/* Use the log-structured filesystem instead of the metadata block one */
+#ifndef ITS_FLASH_FS_LOG
+#define ITS_FLASH_FS_LOG                       0
+#endif
+
+/* Defer the compaction of deleted files until their space is needed */
+#ifndef ITS_DEFERRED_DELETE
+#define ITS_DEFERRED_DELETE                    0
+#endif
+
+/* Defer the scratch block erases of an update to the start of the next one */
+#ifndef ITS_DEFERRED_SCRATCH_ERASE
+#define ITS_DEFERRED_SCRATCH_ERASE             0
+#endif
+
+/* Program appends to files directly into the active data block if erased */
+#ifndef ITS_IN_PLACE_APPEND
+#define ITS_IN_PLACE_APPEND                    0
+#endif
+
+/* Encrypt the file data with a key derived from the HUK by the platform */
+#ifndef ITS_ENCRYPTION
+#define ITS_ENCRYPTION                         0
+#endif
+
+/* The maximum number of extents, each in a different data block, of a file */
+#ifndef ITS_MAX_FILE_EXTENTS
+#define ITS_MAX_FILE_EXTENTS                   1
+#endif
+
+/* Leave the last sector erase of a block running on asynchronous NOR flash */
+#ifndef ITS_FLASH_NOR_ASYNC
+#define ITS_FLASH_NOR_ASYNC                    0
+#endif
+
 /* The maximum asset size to be stored in the Internal Trusted Storage */
 #ifndef ITS_MAX_ASSET_SIZE
 #define ITS_MAX_ASSET_SIZE                     512
@@ -182,11 +364,52 @@
 #define ITS_BUF_SIZE                           ITS_MAX_ASSET_SIZE
 #endif
 
+/* Size in bytes of the RAM cache of recently read assets, 0 to disable it */
+#ifndef ITS_READ_CACHE_SIZE
+#define ITS_READ_CACHE_SIZE                    0
+#endif
+
+/* The maximum number of assets held in the ITS read cache */
+#ifndef ITS_READ_CACHE_NUM_ENTRIES
+#define ITS_READ_CACHE_NUM_ENTRIES             8
+#endif
+
+/* Number of blocks with an erase counter in the ITS flash statistics, 0 to
+ * disable the statistics
+ */
+#ifndef ITS_FLASH_STATS_NUM_BLOCKS
+#define ITS_FLASH_STATS_NUM_BLOCKS             0
+#endif
+
+/* Call its_flash_fs_fault_point() at the power failure sensitive steps of the
+ * ITS metadata block filesystem
+ */
+#ifndef ITS_FS_FAULT_INJECTION
+#define ITS_FS_FAULT_INJECTION                 0
+#endif
+
+/* Size in bytes of the ITS transaction journal, 0 to disable transactions */
+#ifndef ITS_TRANSACTION_BUF_SIZE
+#define ITS_TRANSACTION_BUF_SIZE               0
+#endif
+
+/* Requests of other clients after which an idle open ITS transaction can be
+ * aborted by another client opening one, 0 to never abort it
+ */
+#ifndef ITS_TRANSACTION_TIMEOUT
+#define ITS_TRANSACTION_TIMEOUT                32
+#endif
+
 /* The maximum number of assets to be stored in the Internal Trusted Storage */
 #ifndef ITS_NUM_ASSETS
 #define ITS_NUM_ASSETS                         10
 #endif
 
+/* The maximum number of ITS assets of a single client, 0 for no limit */
+#ifndef ITS_CLIENT_MAX_NUM_ASSETS
+#define ITS_CLIENT_MAX_NUM_ASSETS              0
+#endif
+
 /* The stack size of the Internal Trusted Storage Secure Partition */
 #ifndef ITS_STACK_SIZE
 #define ITS_STACK_SIZE                         0x720
@@ -209,6 +432,13 @@
 #define PS_ROLLBACK_PROTECTION                 1
 #endif
 
+/* The number of Protected Storage saves per increment of its NV counters, 1 to
+ * increment them on every save
+ */
+#ifndef PS_NV_COUNTER_UPDATE_INTERVAL
+#define PS_NV_COUNTER_UPDATE_INTERVAL          1
+#endif
+
 /* Validate filesystem metadata every time it is read from flash */
 #ifndef PS_VALIDATE_METADATA_FROM_FLASH
 #define PS_VALIDATE_METADATA_FROM_FLASH        1
@@ -224,6 +454,53 @@
 #define PS_NUM_ASSETS                          10
 #endif
 
+/* The maximum number of PS assets of a single client, 0 for no limit */
+#ifndef PS_CLIENT_MAX_NUM_ASSETS
+#define PS_CLIENT_MAX_NUM_ASSETS               0
+#endif
+
+/* The number of derived object keys cached by Protected Storage, 0 to derive
+ * the key on every object access
+ */
+#ifndef PS_CRYPTO_KEY_CACHE_NUM
+#define PS_CRYPTO_KEY_CACHE_NUM                4
+#endif
+
+/* The number of bytes Protected Storage encrypts or decrypts in each step of
+ * the multi-part AEAD operation on an object
+ */
+#ifndef PS_CRYPTO_CHUNK_SIZE
+#define PS_CRYPTO_CHUNK_SIZE                   128
+#endif
+
+/* The size of the object data segments Protected Storage authenticates on
+ * their own, 0 to authenticate each object as a whole
+ */
+#ifndef PS_OBJECT_SEGMENT_SIZE
+#define PS_OBJECT_SEGMENT_SIZE                 0
+#endif
+
+/* The number of changed object table entries Protected Storage journals
+ * before it saves the whole object table, 0 to save the table on every change
+ */
+#ifndef PS_OBJ_TABLE_JOURNAL_ENTRIES
+#define PS_OBJ_TABLE_JOURNAL_ENTRIES           0
+#endif
+
+/* The number of assets Protected Storage can hold the writes of in RAM, 0 to
+ * store every write at once
+ */
+#ifndef PS_WRITE_COALESCE_NUM
+#define PS_WRITE_COALESCE_NUM                  0
+#endif
+
+/* The number of writes of an asset Protected Storage holds in RAM before it
+ * stores the asset
+ */
+#ifndef PS_WRITE_COALESCE_LIMIT
+#define PS_WRITE_COALESCE_LIMIT                8
+#endif
+
 /* The stack size of the Protected Storage Secure Partition */
 #ifndef PS_STACK_SIZE
 #define PS_STACK_SIZE                          0x700
@@ -231,9 +508,13 @@
 
 /* SPM Partition Configs */
 
-/* The maximal number of secure services that are connected or requested at the same time */
+/*
+ * The maximal number of secure services that are connected or requested at the
+ * same time. 0 selects the number calculated by the manifest tool, which is at
+ * least the former default of 8.
+ */
 #ifndef CONFIG_TFM_CONN_HANDLE_MAX_NUM
-#define CONFIG_TFM_CONN_HANDLE_MAX_NUM          8
+#define CONFIG_TFM_CONN_HANDLE_MAX_NUM          0
 #endif
 
 /* Disable the doorbell APIs */
@@ -246,4 +527,69 @@
 #define CONFIG_TFM_SCHEDULE_WHEN_NS_INTERRUPTED 0
 #endif
 
+/* Pick the next runnable thread with a priority ready bitmap instead of a list walk */
+#ifndef CONFIG_TFM_SCHED_READY_BITMAP
+#define CONFIG_TFM_SCHED_READY_BITMAP           0
+#endif
+
+/* Record usage statistics of SPM pools */
+#ifndef CONFIG_TFM_SPM_POOL_STATISTICS
+#define CONFIG_TFM_SPM_POOL_STATISTICS          0
+#endif
+
+/* Dispatch SFN psa_call() without intermediate vector copies */
+#ifndef CONFIG_TFM_SFN_DIRECT_DISPATCH
+#define CONFIG_TFM_SFN_DIRECT_DISPATCH          0
+#endif
+
+/* Run SFN stateless services to completion without allocating connections */
+#ifndef CONFIG_TFM_SFN_RUN_TO_COMPLETION
+#define CONFIG_TFM_SFN_RUN_TO_COMPLETION        0
+#endif
+
+/* Let a server thread inherit the priority of its client while handling a message */
+#ifndef CONFIG_TFM_PRIORITY_DONATION
+#define CONFIG_TFM_PRIORITY_DONATION            0
+#endif
+
+/* Record per-service call latency, queue depth and rejection statistics */
+#ifndef CONFIG_TFM_SPM_SERVICE_STATS
+#define CONFIG_TFM_SPM_SERVICE_STATS            0
+#endif
+
+/* Log the cycles of FIH_CALL and fih_eq() with the boot and runtime profiles */
+#ifndef CONFIG_TFM_FIH_BENCH
+#define CONFIG_TFM_FIH_BENCH                    0
+#endif
+
+/* Let the idle thread enter the deepest low-power state the SPE permits */
+#ifndef CONFIG_TFM_IDLE_LOW_POWER
+#define CONFIG_TFM_IDLE_LOW_POWER               0
+#endif
+
+/* Let psa_wait() time out, driven by a secure tick timer */
+#ifndef CONFIG_TFM_SPM_TIMER
+#define CONFIG_TFM_SPM_TIMER                    0
+#endif
+
+/* Frequency of the secure tick driving the SPM timers */
+#ifndef CONFIG_TFM_SPM_TIMER_TICK_HZ
+#define CONFIG_TFM_SPM_TIMER_TICK_HZ            1000
+#endif
+
+/* Run the deferred work queues of the Partitions from the idle Partition */
+#ifndef CONFIG_TFM_WORKQ
+#define CONFIG_TFM_WORKQ                        0
+#endif
+
+/* Let the same priority Partitions run at the preemption points of long operations */
+#ifndef CONFIG_TFM_PREEMPTION_POINTS
+#define CONFIG_TFM_PREEMPTION_POINTS            0
+#endif
+
+/* BASEPRI value of the SPM critical sections, 0 to mask all interrupts with PRIMASK */
+#ifndef CONFIG_TFM_CRITICAL_SECTION_BASEPRI
+#define CONFIG_TFM_CRITICAL_SECTION_BASEPRI     0
+#endif
+
 #endif /* __CONFIG_BASE_H__ */
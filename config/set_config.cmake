@@ -19,6 +19,11 @@ if(TEST_PSA_API)
     include(config/tests/config_test_psa_api.cmake)
 endif()
 
+# Load performance measurement config, setting options not already set
+if(TFM_PERF)
+    include(config/tests/config_perf.cmake)
+endif()
+
 # Load build type config, setting options not already set
 string(TOLOWER "${CMAKE_BUILD_TYPE}" CMAKE_BUILD_TYPE_LOWERCASE)
 include(${CMAKE_SOURCE_DIR}/config/build_type/${CMAKE_BUILD_TYPE_LOWERCASE}.cmake OPTIONAL)
@@ -0,0 +1,34 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+############ Override defaults for performance measurement ####################
+
+# The services whose cost is measured
+set(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE ON       CACHE BOOL      "Enable Internal Trusted Storage partition")
+set(TFM_PARTITION_PROTECTED_STORAGE        ON       CACHE BOOL      "Enable Protected Storage partition")
+set(TFM_PARTITION_CRYPTO                   ON       CACHE BOOL      "Enable Crypto partition")
+set(TFM_PARTITION_INITIAL_ATTESTATION      ON       CACHE BOOL      "Enable Initial Attestation partition")
+# The Platform Service reads back the boot timestamps and the service statistics
+set(TFM_PARTITION_PLATFORM                 ON       CACHE BOOL      "Enable Platform partition")
+# The null RoT Service and the benchmark marks of tfm_perf_run()
+set(TFM_PARTITION_PERF                     ON       CACHE BOOL      "Enable Perf partition, the null service and benchmark marker of TFM_PERF")
+
+# SPM scheduling, PSA call and reply, interrupt, mailbox and flash events with
+# DWT cycle timestamps, exported with tools/tfm_trace_export.py
+set(CONFIG_TFM_SPM_TRACE                   ON       CACHE BOOL      "Whether to record SPM scheduling, PSA call/reply and interrupt events with cycle timestamps in a ring buffer")
+
+# Timestamps of the boot phases, recorded by the bootloaders and the SPM
+if(NOT DEFINED BL2 OR BL2)
+    set(TFM_BOOT_TIMING                    ON       CACHE BOOL      "Record a timestamp at each boot phase in the shared data area, readable through the Platform Service.")
+    set(MCUBOOT_DATA_SHARING               ON       CACHE BOOL      "Add sharing of application specific data using the same shared data area as for the measured boot")
+endif()
+
+# The service and flash statistics are header file configs. A profile brings
+# its own header, which should then set them.
+if(NOT TFM_PROFILE)
+    set(PROJECT_CONFIG_HEADER_FILE  "${CMAKE_SOURCE_DIR}/config/tests/config_perf.h" CACHE FILEPATH "User defined header file for TF-M config")
+endif()
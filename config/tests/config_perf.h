@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __CONFIG_PERF_H__
+#define __CONFIG_PERF_H__
+
+/* ITS Partition Configs */
+
+/* Count the flash operations, and the erases of the first blocks */
+#define ITS_FLASH_STATS_NUM_BLOCKS             16
+
+/* SPM Partition Configs */
+
+/* Hold the trace of a reference benchmark, drained between benchmarks */
+#define SPM_TRACE_ENTRY_NUM                    1024
+
+/* Record the calls, cycles and queue depth of each RoT Service */
+#define CONFIG_TFM_SPM_SERVICE_STATS           1
+
+/* Log the cost of the FIH primitives with each profile */
+#define CONFIG_TFM_FIH_BENCH                   1
+
+#endif /* __CONFIG_PERF_H__ */
@@ -7,6 +7,9 @@
 
 set(TFM_SPM_LOG_LEVEL           TFM_SPM_LOG_LEVEL_SILENCE       CACHE STRING    "Set default SPM log level as INFO level")
 set(TFM_PARTITION_LOG_LEVEL     TFM_PARTITION_LOG_LEVEL_SILENCE   CACHE STRING    "Set default Secure Partition log level as INFO level")
+set(TFM_SPM_LOG_BUFFERED        OFF                               CACHE BOOL      "Buffer the SPM and Secure Partition log output in RAM and send it to the UART when idle")
+set(TFM_SPM_LOG_BUFFER_SIZE     1024                              CACHE STRING    "Size of the SPM log buffer in bytes, must be a power of two")
+set(TFM_LOG_TOKENIZED           OFF                               CACHE BOOL      "Output the SPM and Secure Partition logs as binary records, decoded by tools/tfm_log_decode.py")
 
 # Secure regression tests also require SP log function
 # Enable SP log raw dump when SP log level is higher than silence or TF-M
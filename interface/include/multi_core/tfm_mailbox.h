@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2022 Cypress Semiconductor Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -20,7 +20,9 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "cmsis_compiler.h"
 #include "psa/client.h"
+#include "tfm_psa_call_batch.h"
 #include "tfm_mailbox_config.h"
 
 #ifdef __cplusplus
@@ -33,6 +35,7 @@ extern "C" {
 #define MAILBOX_PSA_CONNECT                 (0x3)
 #define MAILBOX_PSA_CALL                    (0x4)
 #define MAILBOX_PSA_CLOSE                   (0x5)
+#define MAILBOX_PSA_CALL_BATCH              (0x6)
 
 /* Return code of mailbox APIs */
 #define MAILBOX_SUCCESS                     (0)
@@ -71,6 +74,12 @@ struct psa_client_params_t {
         struct {
             psa_handle_t    handle;
         } psa_close_params;
+
+        struct {
+            const struct psa_call_batch_item_t *items;
+            psa_status_t                       *statuses;
+            size_t                             num;
+        } psa_call_batch_params;
     };
 };
 
@@ -118,7 +127,146 @@ struct ns_mailbox_slot_t {
     struct mailbox_reply_t reply;
 };
 
-typedef uint32_t   mailbox_queue_status_t;
+/* Number of slots in each word of a mailbox queue status bitmask */
+#define MAILBOX_QUEUE_STATUS_WORD_BITS      32
+
+#define MAILBOX_QUEUE_STATUS_WORDS                                  \
+    ((NUM_MAILBOX_QUEUE_SLOT + MAILBOX_QUEUE_STATUS_WORD_BITS - 1) / \
+     MAILBOX_QUEUE_STATUS_WORD_BITS)
+
+/*
+ * Bitmask of mailbox queue slots. Slot n is bit (n % 32) of word (n / 32), so
+ * up to 32 slots it has the layout of a single uint32_t.
+ */
+typedef struct {
+    uint32_t word[MAILBOX_QUEUE_STATUS_WORDS];
+} mailbox_queue_status_t;
+
+#define MAILBOX_QUEUE_STATUS_WORD(idx)      \
+    ((idx) / MAILBOX_QUEUE_STATUS_WORD_BITS)
+#define MAILBOX_QUEUE_STATUS_BIT(idx)       \
+    (1UL << ((idx) % MAILBOX_QUEUE_STATUS_WORD_BITS))
+
+/* The following inline functions operate on mailbox queue status bitmasks */
+static inline void mailbox_status_zero(mailbox_queue_status_t *status)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_QUEUE_STATUS_WORDS; i++) {
+        status->word[i] = 0;
+    }
+}
+
+/* Set the bits of the first 'num' slots */
+static inline void mailbox_status_fill(mailbox_queue_status_t *status,
+                                       uint32_t num)
+{
+    uint32_t i;
+
+    mailbox_status_zero(status);
+
+    for (i = 0; i < num / MAILBOX_QUEUE_STATUS_WORD_BITS; i++) {
+        status->word[i] = 0xFFFFFFFFUL;
+    }
+
+    if (num % MAILBOX_QUEUE_STATUS_WORD_BITS) {
+        status->word[i] = MAILBOX_QUEUE_STATUS_BIT(num) - 1;
+    }
+}
+
+static inline void mailbox_status_copy(mailbox_queue_status_t *dst,
+                                       const mailbox_queue_status_t *src)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_QUEUE_STATUS_WORDS; i++) {
+        dst->word[i] = src->word[i];
+    }
+}
+
+static inline void mailbox_status_set_slot(mailbox_queue_status_t *status,
+                                           uint8_t idx)
+{
+    status->word[MAILBOX_QUEUE_STATUS_WORD(idx)] |=
+                                                MAILBOX_QUEUE_STATUS_BIT(idx);
+}
+
+static inline void mailbox_status_clear_slot(mailbox_queue_status_t *status,
+                                             uint8_t idx)
+{
+    status->word[MAILBOX_QUEUE_STATUS_WORD(idx)] &=
+                                                ~MAILBOX_QUEUE_STATUS_BIT(idx);
+}
+
+static inline bool mailbox_status_has_slot(const mailbox_queue_status_t *status,
+                                           uint8_t idx)
+{
+    return (status->word[MAILBOX_QUEUE_STATUS_WORD(idx)] &
+            MAILBOX_QUEUE_STATUS_BIT(idx)) != 0;
+}
+
+static inline bool mailbox_status_is_zero(const mailbox_queue_status_t *status)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_QUEUE_STATUS_WORDS; i++) {
+        if (status->word[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* dst |= mask */
+static inline void mailbox_status_set_mask(mailbox_queue_status_t *dst,
+                                           const mailbox_queue_status_t *mask)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_QUEUE_STATUS_WORDS; i++) {
+        dst->word[i] |= mask->word[i];
+    }
+}
+
+/* dst &= ~mask */
+static inline void mailbox_status_clear_mask(mailbox_queue_status_t *dst,
+                                             const mailbox_queue_status_t *mask)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAILBOX_QUEUE_STATUS_WORDS; i++) {
+        dst->word[i] &= ~mask->word[i];
+    }
+}
+
+/*
+ * Return the lowest slot set in 'status' from slot 'from' on, or
+ * NUM_MAILBOX_QUEUE_SLOT if there is none. Empty words are skipped whole and
+ * the lowest bit of a word is found with a single bit reverse and count.
+ */
+static inline uint8_t mailbox_status_next_slot(
+                                        const mailbox_queue_status_t *status,
+                                        uint32_t from)
+{
+    uint32_t i = MAILBOX_QUEUE_STATUS_WORD(from);
+    uint32_t bits;
+
+    if (from >= NUM_MAILBOX_QUEUE_SLOT) {
+        return NUM_MAILBOX_QUEUE_SLOT;
+    }
+
+    bits = status->word[i] & ~(MAILBOX_QUEUE_STATUS_BIT(from) - 1);
+
+    while (!bits) {
+        if (++i >= MAILBOX_QUEUE_STATUS_WORDS) {
+            return NUM_MAILBOX_QUEUE_SLOT;
+        }
+        bits = status->word[i];
+    }
+
+    return (uint8_t)(i * MAILBOX_QUEUE_STATUS_WORD_BITS + __CLZ(__RBIT(bits)));
+}
 
 /* NSPE mailbox queue */
 struct ns_mailbox_queue_t {
@@ -147,6 +295,14 @@ struct ns_mailbox_queue_t {
 #endif
 
     bool                     is_full;           /* Queue if full */
+
+    /*
+     * Set by a side while it polls the bitmaps itself. The other side skips
+     * the doorbell then. Both are changed and read in the mailbox critical
+     * section together with pend_slots or replied_slots.
+     */
+    bool                     spe_polling;       /* SPE polls pend_slots */
+    bool                     ns_polling;        /* NSPE polls replied_slots */
 };
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,6 +13,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "cmsis_compiler.h"
 #include "tfm_mailbox.h"
 
 #ifdef __cplusplus
@@ -53,6 +54,57 @@ int32_t tfm_ns_mailbox_client_call(uint32_t call_type,
                                    int32_t client_id,
                                    int32_t *reply);
 
+#ifndef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
+/**
+ * \brief Send PSA client call to SPE via mailbox without waiting for the
+ *        result.
+ *
+ * \param[in] call_type         PSA client call type
+ * \param[in] params            Parameters used for PSA client call
+ * \param[in] client_id         Optional client ID of non-secure caller.
+ * \param[out] token            The token to fetch the result with
+ *                              \ref tfm_ns_mailbox_client_poll or
+ *                              \ref tfm_ns_mailbox_client_wait.
+ *
+ * \retval MAILBOX_SUCCESS      The PSA client call is sent to SPE.
+ * \retval Other return code    Operation failed with an error code.
+ *
+ * \note The mailbox slot is held until the result is fetched.
+ */
+int32_t tfm_ns_mailbox_client_call_async(uint32_t call_type,
+                                         const struct psa_client_params_t *params,
+                                         int32_t client_id,
+                                         uint32_t *token);
+
+/**
+ * \brief Fetch the result of a PSA client call sent by
+ *        \ref tfm_ns_mailbox_client_call_async, if it is replied.
+ *
+ * \param[in] token             The token of the PSA client call.
+ * \param[out] reply            The buffer written with PSA client call result.
+ *
+ * \retval MAILBOX_SUCCESS       The result is fetched and \p token released.
+ * \retval MAILBOX_NO_PEND_EVENT The PSA client call is not replied yet.
+ * \retval MAILBOX_INVAL_PARAMS  \p token is invalid.
+ */
+int32_t tfm_ns_mailbox_client_poll(uint32_t token, int32_t *reply);
+
+/**
+ * \brief Wait for and fetch the result of a PSA client call sent by
+ *        \ref tfm_ns_mailbox_client_call_async.
+ *
+ * \param[in] token             The token of the PSA client call.
+ * \param[out] reply            The buffer written with PSA client call result.
+ *
+ * \retval MAILBOX_SUCCESS       The result is fetched and \p token released.
+ * \retval MAILBOX_INVAL_PARAMS  \p token is invalid.
+ *
+ * \note It must be called by the task which sent the PSA client call, as the
+ *       reply IRQ wakes up that task.
+ */
+int32_t tfm_ns_mailbox_client_wait(uint32_t token, int32_t *reply);
+#endif /* !TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD */
+
 #ifdef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
 /**
  * \brief Handling PSA client calls in a dedicated NS mailbox thread.
@@ -117,6 +169,18 @@ void tfm_ns_mailbox_hal_enter_critical_isr(void);
  */
 void tfm_ns_mailbox_hal_exit_critical_isr(void);
 
+#if !defined(TFM_MULTI_CORE_NS_OS) && defined(TFM_MULTI_CORE_NS_MAILBOX_WAIT_WFE)
+/**
+ * \brief Put the core to sleep until the next event, while a bare metal NSPE
+ *        waits for a PSA client call reply.
+ *
+ * \note The implementation depends on platform specific hardware. It is
+ *       usually a single WFE. The reply doorbell interrupt must be enabled, so
+ *       that its exception entry and return wake the core up.
+ */
+void tfm_ns_mailbox_hal_wait_reply(void);
+#endif
+
 #ifdef TFM_MULTI_CORE_NS_OS
 /**
  * \brief Initialize the multi-core lock for synchronizing PSA client call(s)
@@ -286,12 +350,106 @@ static inline int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
 #define tfm_ns_mailbox_os_spin_unlock() do {} while (0)
 #endif /* TFM_MULTI_CORE_NS_OS */
 
+/*
+ * Empty slots are claimed and released with exclusive access instructions if
+ * available, so that NS threads sending PSA client calls concurrently don't
+ * serialize on the local spin lock. Any exception between the load and the
+ * store clears the local exclusive monitor, so the store fails and the
+ * operation retries. Armv6-M does not support exclusive access, the local
+ * spin lock is used instead.
+ */
+#if defined(__ARM_ARCH_6M__)
+#define NS_MAILBOX_SLOT_LOCK_FREE        0
+#else
+#define NS_MAILBOX_SLOT_LOCK_FREE        1
+#endif
+
+#define NS_MAILBOX_EMPTY_SLOTS_ADDR(q, w)   \
+    ((volatile uint32_t *)&(q)->empty_slots.word[w])
+
+/*
+ * Claim the lowest empty slot. Return NUM_MAILBOX_QUEUE_SLOT if no slot is
+ * empty.
+ */
+static inline uint8_t claim_queue_slot_empty(
+                                           struct ns_mailbox_queue_t *queue_ptr)
+{
+    uint8_t idx;
+#if NS_MAILBOX_SLOT_LOCK_FREE == 1
+    uint32_t status, bit;
+    uint32_t w;
+
+    /* Each word of the bitmask is claimed from on its own */
+    for (w = 0; w < MAILBOX_QUEUE_STATUS_WORDS; w++) {
+        do {
+            status = __LDREXW(NS_MAILBOX_EMPTY_SLOTS_ADDR(queue_ptr, w));
+            if (!status) {
+                __CLREX();
+                break;
+            }
+
+            bit = __CLZ(__RBIT(status));
+        } while (__STREXW(status & ~(1UL << bit),
+                          NS_MAILBOX_EMPTY_SLOTS_ADDR(queue_ptr, w)));
+
+        if (status) {
+            /* The slot is owned before its contents are touched */
+            __DMB();
+
+            return (uint8_t)(w * MAILBOX_QUEUE_STATUS_WORD_BITS + bit);
+        }
+    }
+
+    idx = NUM_MAILBOX_QUEUE_SLOT;
+#else
+    tfm_ns_mailbox_os_spin_lock();
+    idx = mailbox_status_next_slot(&queue_ptr->empty_slots, 0);
+    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
+        mailbox_status_clear_slot(&queue_ptr->empty_slots, idx);
+    }
+    tfm_ns_mailbox_os_spin_unlock();
+#endif
+
+    return idx;
+}
+
+/*
+ * Return the slots in 'slots' to the empty bitmask. Without exclusive access
+ * the caller either holds the local spin lock or runs in the mailbox ISR.
+ */
+static inline void release_queue_slots_empty(
+                                       struct ns_mailbox_queue_t *queue_ptr,
+                                       const mailbox_queue_status_t *slots)
+{
+#if NS_MAILBOX_SLOT_LOCK_FREE == 1
+    uint32_t status;
+    uint32_t w;
+
+    /* The slots are re-initialized before they can be claimed again */
+    __DMB();
+
+    for (w = 0; w < MAILBOX_QUEUE_STATUS_WORDS; w++) {
+        if (!slots->word[w]) {
+            continue;
+        }
+
+        do {
+            status = __LDREXW(NS_MAILBOX_EMPTY_SLOTS_ADDR(queue_ptr, w)) |
+                     slots->word[w];
+        } while (__STREXW(status, NS_MAILBOX_EMPTY_SLOTS_ADDR(queue_ptr, w)));
+    }
+#else
+    __DMB();
+    mailbox_status_set_mask(&queue_ptr->empty_slots, slots);
+#endif
+}
+
 /* The following inline functions configure non-secure mailbox queue status */
 static inline void clear_queue_slot_empty(struct ns_mailbox_queue_t *queue_ptr,
                                           uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        queue_ptr->empty_slots &= ~(1UL << idx);
+        mailbox_status_clear_slot(&queue_ptr->empty_slots, idx);
     }
 }
 
@@ -299,15 +457,15 @@ static inline void set_queue_slot_pend(struct ns_mailbox_queue_t *queue_ptr,
                                        uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        queue_ptr->pend_slots |= (1UL << idx);
+        mailbox_status_set_slot(&queue_ptr->pend_slots, idx);
     }
 }
 
 static inline void clear_queue_slot_all_replied(
-                                           struct ns_mailbox_queue_t *queue_ptr,
-                                           mailbox_queue_status_t status)
+                                       struct ns_mailbox_queue_t *queue_ptr,
+                                       const mailbox_queue_status_t *status)
 {
-    queue_ptr->replied_slots &= ~status;
+    mailbox_status_clear_mask(&queue_ptr->replied_slots, status);
 }
 
 #ifdef __cplusplus
@@ -114,6 +114,99 @@ extern "C" {
 
 /**@}*/
 
+/** \defgroup tfm_crypto_batch TF-M batched operations
+ * @{
+ */
+
+/* The maximal number of input buffers of psa_hash_compute_multi() */
+#define PSA_HASH_COMPUTE_MULTI_MAX_INPUTS 3
+
+/**
+ * \brief Calculate the hash of several buffers, as if they were concatenated
+ *
+ * This is equivalent to psa_hash_setup(), one psa_hash_update() per buffer and
+ * psa_hash_finish(), but the buffers are sent to the Crypto service in a
+ * single request.
+ *
+ * \param[in]  alg            The hash algorithm to compute
+ * \param[in]  inputs         \p input_count buffers to hash, in order
+ * \param[in]  input_lengths  Size of each of the \p inputs in bytes
+ * \param[in]  input_count    Number of buffers, 1 to
+ *                            \ref PSA_HASH_COMPUTE_MULTI_MAX_INPUTS
+ * \param[out] hash           Buffer where the hash is to be written
+ * \param[in]  hash_size      Size of the \p hash buffer in bytes
+ * \param[out] hash_length    On success, the number of bytes that make up
+ *                            the hash value
+ *
+ * \return The same statuses as psa_hash_compute(), or
+ *         #PSA_ERROR_INVALID_ARGUMENT if \p input_count is out of range
+ */
+psa_status_t psa_hash_compute_multi(psa_algorithm_t alg,
+                                    const uint8_t *const *inputs,
+                                    const size_t *input_lengths,
+                                    size_t input_count,
+                                    uint8_t *hash,
+                                    size_t hash_size,
+                                    size_t *hash_length);
+
+/**
+ * \brief Calculate the hash of the message passed so far to a hash operation,
+ *        which stays active
+ *
+ * This is equivalent to psa_hash_clone() followed by psa_hash_finish() of the
+ * clone, as done to hash a growing transcript, but the copy is finished by the
+ * Crypto service in a single request, without taking an operation slot.
+ *
+ * \param[in]  operation      Active hash operation, which can still be updated
+ *                            and finished afterwards
+ * \param[out] hash           Buffer where the hash is to be written
+ * \param[in]  hash_size      Size of the \p hash buffer in bytes
+ * \param[out] hash_length    On success, the number of bytes that make up
+ *                            the hash value
+ *
+ * \return The same statuses as psa_hash_finish(). The operation is not
+ *         changed or aborted on failure.
+ */
+psa_status_t psa_hash_finish_copy(const psa_hash_operation_t *operation,
+                                  uint8_t *hash,
+                                  size_t hash_size,
+                                  size_t *hash_length);
+
+/**
+ * \brief Verify a batch of hash signatures made with the same key
+ *
+ * This is equivalent to calling psa_verify_hash() \p count times, but all
+ * the pairs are sent to the Crypto service in a single request. The hashes
+ * are packed back to back in \p hashes, each \p hash_length bytes long, and
+ * the signatures in \p signatures, each \p signature_length bytes long.
+ *
+ * \param[in]  key               Identifier of the key to use
+ * \param[in]  alg               A signature algorithm as for psa_verify_hash()
+ * \param[in]  hashes            \p count hashes of \p hash_length bytes each
+ * \param[in]  hash_length       Size of each hash in bytes
+ * \param[in]  signatures        \p count signatures of \p signature_length
+ *                               bytes each
+ * \param[in]  signature_length  Size of each signature in bytes
+ * \param[in]  count             Number of (hash, signature) pairs
+ * \param[out] results           \p count statuses, the result of verifying
+ *                               each pair as psa_verify_hash() would return
+ *
+ * \retval #PSA_SUCCESS  Every signature in the batch is valid
+ * \return The status of the first pair that failed verification, or the
+ *         error that prevented the batch from being processed, in which case
+ *         \p results is not valid
+ */
+psa_status_t psa_verify_hash_batch(psa_key_id_t key,
+                                   psa_algorithm_t alg,
+                                   const uint8_t *hashes,
+                                   size_t hash_length,
+                                   const uint8_t *signatures,
+                                   size_t signature_length,
+                                   size_t count,
+                                   psa_status_t *results);
+
+/**@}*/
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -16,6 +16,7 @@
 
 #include "psa/error.h"
 #include "psa/storage_common.h"
+#include "tfm_its_defs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -157,6 +158,165 @@ psa_status_t psa_its_get_info(psa_storage_uid_t uid,
  */
 psa_status_t psa_its_remove(psa_storage_uid_t uid);
 
+/**
+ * \brief Retrieve the data associated with a batch of UIDs (TF-M extension)
+ *
+ * This is equivalent to calling psa_its_get() with a `data_offset` of 0 for
+ * each of the `count` UIDs in `uids`, but the whole batch is sent to the ITS
+ * service in a single request. The data of each UID is placed in `p_data`
+ * right after the data of the previous one, and is truncated to the space
+ * left in the buffer.
+ *
+ * \param[in]  uids            `count` uid values
+ * \param[in]  count           Number of UIDs in the batch
+ * \param[in]  data_size       The size of the `p_data` buffer in bytes
+ * \param[out] p_data          The buffer where the data will be placed
+ * \param[out] p_data_lengths  `count` sizes, the size of the data placed in
+ *                             `p_data` for each UID
+ * \param[out] results         `count` statuses, the result of retrieving each
+ *                             UID as psa_its_get() would return
+ *
+ * \retval PSA_SUCCESS  The data of every UID in the batch was retrieved
+ * \return The status of the first UID that could not be retrieved, or the
+ *         error that prevented the batch from being processed, in which case
+ *         `results` is not valid
+ */
+psa_status_t psa_its_get_batch(const psa_storage_uid_t *uids,
+                               size_t count,
+                               size_t data_size,
+                               void *p_data,
+                               size_t *p_data_lengths,
+                               psa_status_t *results);
+
+/**
+ * \brief Retrieve data associated with a provided UID into several buffers
+ *        (TF-M extension)
+ *
+ * This is equivalent to psa_its_get(), but the data is placed in the `count`
+ * buffers of `p_data` in order, each buffer being filled before the next one
+ * is used. It lets the caller read an asset straight into a fragmented set of
+ * buffers, without going through a single contiguous buffer.
+ *
+ * \param[in]  uid            The `uid` value
+ * \param[in]  data_offset    The starting offset of the data requested
+ * \param[in]  p_data         `count` pointers, the buffers where the data
+ *                            will be placed
+ * \param[in]  data_sizes     `count` sizes, the size of each buffer in bytes
+ * \param[in]  count          The number of buffers, from 1 to 4
+ *                            (PSA_MAX_IOVEC)
+ * \param[out] p_data_length  The total amount of data placed in the buffers
+ *
+ * \return A status indicating the success/failure of the operation, as
+ *         returned by psa_its_get()
+ */
+psa_status_t psa_its_get_multi(psa_storage_uid_t uid,
+                               size_t data_offset,
+                               void *const *p_data,
+                               const size_t *data_sizes,
+                               size_t count,
+                               size_t *p_data_length);
+
+/**
+ * \brief Open a transaction (TF-M extension)
+ *
+ * Until the transaction is committed or aborted, the calls to psa_its_set()
+ * and psa_its_remove() made by the caller are checked and recorded, but not
+ * applied. psa_its_get() and psa_its_get_info() still return the stored
+ * data. Only one transaction can be open at a time in the ITS service. A
+ * transaction left idle for ITS_TRANSACTION_TIMEOUT requests of other clients
+ * is aborted when another client opens one. Non-secure callers can only open
+ * a transaction if the NSPE gives each of its clients its own client ID
+ * (TFM_NS_MANAGE_NSID), as the sets of one would else be recorded in the
+ * transaction of another.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS              The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE      The operation failed because a
+ *                                  transaction is already open
+ * \retval PSA_ERROR_NOT_SUPPORTED  The operation failed because transactions
+ *                                  are not enabled in the ITS service, or
+ *                                  not available to the caller
+ */
+psa_status_t psa_its_transaction_begin(void);
+
+/**
+ * \brief Commit the open transaction (TF-M extension)
+ *
+ * Applies the sets and removals recorded in the transaction. They are stored
+ * together, so that after a power failure either all or none of them are
+ * applied. The commit fails with PSA_ERROR_INSUFFICIENT_STORAGE, with none of
+ * them applied, if they may not fit. If applying them fails once they are
+ * stored, they are applied again before the next request of the caller, and
+ * that request fails until they are.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE             The operation failed because the
+ *                                         caller has no open transaction
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because there
+ *                                         was insufficient space on the
+ *                                         storage medium
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ */
+psa_status_t psa_its_transaction_commit(void);
+
+/**
+ * \brief Discard the open transaction (TF-M extension)
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS          The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE  The operation failed because the caller has
+ *                              no open transaction
+ */
+psa_status_t psa_its_transaction_abort(void);
+
+/**
+ * \brief Retrieve the flash operations issued by a filesystem since the last
+ *        boot (TF-M extension)
+ *
+ * The counters are only kept when the ITS service is built with
+ * ITS_FLASH_STATS_NUM_BLOCKS > 0. The write amplification of an asset is the
+ * growth of `bytes_programmed` over the size of the asset data written.
+ *
+ * \param[in]  fs     TFM_ITS_FLASH_STATS_ITS for the ITS filesystem, or
+ *                    TFM_ITS_FLASH_STATS_PS for the PS filesystem
+ * \param[out] stats  The counters of the filesystem
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                The operation completed successfully
+ * \retval PSA_ERROR_INVALID_ARGUMENT The operation failed because `fs` is
+ *                                    invalid
+ * \retval PSA_ERROR_NOT_SUPPORTED    The operation failed because the
+ *                                    counters are not kept, or the
+ *                                    filesystem is not built
+ */
+psa_status_t psa_its_get_flash_stats(uint32_t fs,
+                                     struct tfm_its_flash_stats_t *stats);
+
+/**
+ * \brief Retrieve the hits and misses of the ITS read cache since the last
+ *        boot (TF-M extension)
+ *
+ * The cache is only built when the ITS service is built with
+ * ITS_READ_CACHE_SIZE > 0. The hit ratio is `hits` / (`hits` + `misses`).
+ *
+ * \param[out] stats  The statistics of the cache
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS              The operation completed successfully
+ * \retval PSA_ERROR_NOT_SUPPORTED  The operation failed because the cache is
+ *                                  not built
+ */
+psa_status_t psa_its_get_read_cache_stats(
+                                    struct tfm_its_read_cache_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -275,6 +275,48 @@ psa_status_t psa_ps_set_extended(psa_storage_uid_t uid,
  */
 uint32_t psa_ps_get_support(void);
 
+/**
+ * \brief Retrieve data associated with a provided UID into several buffers
+ *        (TF-M extension)
+ *
+ * This is equivalent to psa_ps_get(), but the data is placed in the `count`
+ * buffers of `p_data` in order, each buffer being filled before the next one
+ * is used. It lets the caller read an asset straight into a fragmented set of
+ * buffers, without going through a single contiguous buffer.
+ *
+ * \param[in]  uid            The `uid` value
+ * \param[in]  data_offset    The starting offset of the data requested
+ * \param[in]  p_data         `count` pointers, the buffers where the data
+ *                            will be placed
+ * \param[in]  data_sizes     `count` sizes, the size of each buffer in bytes
+ * \param[in]  count          The number of buffers, from 1 to 4
+ *                            (PSA_MAX_IOVEC)
+ * \param[out] p_data_length  The total amount of data placed in the buffers
+ *
+ * \return A status indicating the success/failure of the operation, as
+ *         returned by psa_ps_get()
+ */
+psa_status_t psa_ps_get_multi(psa_storage_uid_t uid,
+                              size_t data_offset,
+                              void *const *p_data,
+                              const size_t *data_sizes,
+                              size_t count,
+                              size_t *p_data_length);
+
+/**
+ * \brief Store all the asset writes held by PS in the persistent area
+ *        (TF-M extension)
+ *
+ * The writes of the assets set with the TFM_PS_FLAG_COALESCE_WRITES create
+ * flag, defined in tfm_ps_defs.h, may be held in RAM by PS. They are lost on a
+ * reset that is not preceded by this call.
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t. On failure, the writes that could not be
+ *         stored are discarded.
+ */
+psa_status_t tfm_ps_flush_writes(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -436,6 +436,56 @@ void *psa_map_outvec(psa_handle_t msg_handle, uint32_t outvec_idx);
  */
 void psa_unmap_outvec(psa_handle_t msg_handle, uint32_t outvec_idx, size_t len);
 
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+
+/**
+ * \brief Map a client output vector for direct access by a Secure Partition RoT
+ *        Service, for the lifetime of the connection (TF-M extension).
+ *
+ * The output vector is checked once, as psa_map_outvec() does, and then stays
+ * mapped after the reply. The later messages of the connection get it with
+ * psa_get_shared_outvec(), so a client can register a long-lived buffer once
+ * and only send descriptors of the data in it afterwards. The client must keep
+ * the buffer valid until it closes the connection. The client can still
+ * modify the buffer at any time, so the RoT Service must copy what it checks
+ * before using it.
+ *
+ * \param[in] msg_handle        Handle for the client's message.
+ * \param[in] outvec_idx        Index of output vector to map. Must be
+ *                              less than \ref PSA_MAX_IOVEC.
+ *
+ * \retval                      A pointer to the output vector data.
+ * \retval "PROGRAMMER ERROR"   The call is invalid, one or more of the
+ *                              following are true:
+ * \arg                           Any of the conditions of psa_map_outvec().
+ * \arg                           The RoT Service is stateless.
+ * \arg                           A buffer is already mapped for the
+ *                                connection.
+ */
+void *psa_map_shared_outvec(psa_handle_t msg_handle, uint32_t outvec_idx);
+
+/**
+ * \brief Get the client buffer mapped for the connection of a message by
+ *        psa_map_shared_outvec() (TF-M extension).
+ *
+ * \param[in]  msg_handle       Handle for the client's message.
+ * \param[out] len              The size of the buffer in bytes, 0 if there
+ *                              is none.
+ *
+ * \retval                      A pointer to the buffer, or NULL if no buffer
+ *                              is mapped for the connection.
+ * \retval "PROGRAMMER ERROR"   The call is invalid, one or more of the
+ *                              following are true:
+ * \arg                           MM-IOVEC has not been enabled for the RoT
+ *                                Service that received the message.
+ * \arg                           msg_handle is invalid.
+ * \arg                           msg_handle does not refer to a request
+ *                                message.
+ */
+void *psa_get_shared_outvec(psa_handle_t msg_handle, size_t *len);
+
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1 */
+
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
 
 #ifdef __cplusplus
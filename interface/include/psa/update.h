@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -147,6 +147,10 @@ typedef struct psa_fwu_image_version_t {
 typedef struct {
     /* The digest of second image when store state is CANDIDATE. */
     uint8_t candidate_digest[TFM_FWU_MAX_DIGEST_SIZE];
+    /* The offset to continue writing the image from when store state is
+     * WRITING.
+     */
+    uint32_t written_size;
  } psa_fwu_impl_info_t;
 
 /**
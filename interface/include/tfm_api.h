@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -14,6 +14,7 @@ extern "C" {
 
 #include <stdint.h>
 #include "psa/client.h"
+#include "tfm_psa_call_batch.h"
 
 #define TFM_INVALID_CLIENT_ID 0
 
@@ -40,6 +41,22 @@ extern "C" {
 /* The mask used for timeout values */
 #define PSA_TIMEOUT_MASK        PSA_BLOCK
 
+/*
+ * TF-M extension: psa_wait() timeout flag of a Partition with deferred work
+ * queued. The idle Partition asserts TFM_WORKQ_SIGNAL to the Partitions which
+ * wait with it. Only used with CONFIG_TFM_WORKQ.
+ */
+#define TFM_WAIT_WORKQ          (0x40000000u)
+#define TFM_WORKQ_SIGNAL        (0x00000001u)
+
+/*
+ * TF-M extension: psa_wait() timeout flag of a Partition at a preemption
+ * point of a long operation. The other runnable Partitions of the same
+ * priority run before it continues. Only used with
+ * CONFIG_TFM_PREEMPTION_POINTS.
+ */
+#define TFM_WAIT_YIELD          (0x20000000u)
+
 /* FixMe: sort out DEBUG compile option and limit return value options
  * on external interfaces */
 enum tfm_status_e
@@ -110,6 +127,19 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
  */
 void tfm_psa_close_veneer(psa_handle_t handle);
 
+/**
+ * \brief Call several secure functions in one Secure entry.
+ *
+ * \param[in] items             Array of \ref psa_call_batch_item_t structures.
+ * \param[out] statuses         Array receiving the status of each call.
+ * \param[in] num               Number of calls in the batch.
+ *
+ * \return Returns \ref psa_status_t status code of the batch.
+ */
+psa_status_t tfm_psa_call_batch_veneer(const struct psa_call_batch_item_t *items,
+                                       psa_status_t *statuses,
+                                       uint32_t num);
+
 /***************** End Secure function declarations ***************************/
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,10 @@
 #ifndef __TFM_ATTEST_DEFS_H__
 #define __TFM_ATTEST_DEFS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/error.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +19,68 @@ extern "C" {
 /* Initial Attestation message types that distinguish Attest services. */
 #define TFM_ATTEST_GET_TOKEN       1001
 #define TFM_ATTEST_GET_TOKEN_SIZE  1002
+#define TFM_ATTEST_GET_TOKENS      1003
+#define TFM_ATTEST_GET_TOKEN_STATS 1004
+
+/**
+ * \brief Stages of the creation of a token, as timed in
+ *        \ref tfm_attest_token_stats_t
+ */
+enum tfm_attest_token_stage_t {
+    /** Key algorithm look up and encoding of the COSE headers */
+    TFM_ATTEST_TOKEN_STAGE_START = 0,
+    /** Gathering and CBOR encoding of the claims, nonce included */
+    TFM_ATTEST_TOKEN_STAGE_CLAIMS,
+    /** Hashing of the payload, signing and end of the CBOR encoding */
+    TFM_ATTEST_TOKEN_STAGE_FINISH,
+    TFM_ATTEST_TOKEN_STAGE_NUM
+};
+
+/**
+ * \brief Cycles spent in each stage of the tokens created since boot. Token
+ *        size queries are not counted.
+ */
+struct tfm_attest_token_stats_t {
+    uint32_t tokens;                    /* Tokens successfully created     */
+    uint32_t last_cycles[TFM_ATTEST_TOKEN_STAGE_NUM];  /* Last token       */
+    uint64_t total_cycles[TFM_ATTEST_TOKEN_STAGE_NUM]; /* All tokens       */
+};
+
+/**
+ * \brief Get one initial attestation token for each of several challenges.
+ *
+ * \param[in]  auth_challenges  The challenges, one after the other.
+ * \param[in]  challenge_size   Size of each challenge object in bytes. One of
+ *                              the PSA_INITIAL_ATTEST_CHALLENGE_SIZE_x sizes.
+ * \param[in]  num_challenges   Number of challenges in \p auth_challenges.
+ * \param[out] token_buf        Buffer where the tokens are written one after
+ *                              the other, in the order of the challenges.
+ * \param[in]  token_buf_size   Size of \p token_buf in bytes.
+ * \param[out] token_sizes      Array of \p num_challenges elements where the
+ *                              size of each token is written.
+ *
+ * \return Returns error code as specified in \ref psa_status_t. The tokens are
+ *         only valid if PSA_SUCCESS is returned.
+ */
+psa_status_t
+tfm_initial_attest_get_tokens(const uint8_t *auth_challenges,
+                              size_t         challenge_size,
+                              size_t         num_challenges,
+                              uint8_t       *token_buf,
+                              size_t         token_buf_size,
+                              size_t        *token_sizes);
+
+/**
+ * \brief Get the token creation statistics of a service built with
+ *        ATTEST_TOKEN_STATS.
+ *
+ * \param[out] stats  Where the statistics are written.
+ *
+ * \return Returns PSA_SUCCESS, or PSA_ERROR_NOT_SUPPORTED when the service
+ *         does not count them.
+ */
+psa_status_t
+tfm_initial_attest_get_token_stats(struct tfm_attest_token_stats_t *stats);
 
 #ifdef __cplusplus
 }
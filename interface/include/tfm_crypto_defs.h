@@ -99,7 +99,9 @@ enum tfm_crypto_group_id {
     X(TFM_CRYPTO_HASH_CLONE)                       \
     X(TFM_CRYPTO_HASH_FINISH)                      \
     X(TFM_CRYPTO_HASH_VERIFY)                      \
-    X(TFM_CRYPTO_HASH_ABORT)
+    X(TFM_CRYPTO_HASH_ABORT)                       \
+    X(TFM_CRYPTO_HASH_COMPUTE_MULTI)               \
+    X(TFM_CRYPTO_HASH_FINISH_COPY)
 
 #define MAC_FUNCS                                  \
     X(TFM_CRYPTO_MAC_COMPUTE)                      \
@@ -140,7 +142,8 @@ enum tfm_crypto_group_id {
     X(TFM_CRYPTO_ASYMMETRIC_SIGN_MESSAGE)          \
     X(TFM_CRYPTO_ASYMMETRIC_VERIFY_MESSAGE)        \
     X(TFM_CRYPTO_ASYMMETRIC_SIGN_HASH)             \
-    X(TFM_CRYPTO_ASYMMETRIC_VERIFY_HASH)
+    X(TFM_CRYPTO_ASYMMETRIC_VERIFY_HASH)           \
+    X(TFM_CRYPTO_ASYMMETRIC_VERIFY_HASH_BATCH)
 
 #define AYSMMETRIC_ENCRYPT_FUNCS                   \
     X(TFM_CRYPTO_ASYMMETRIC_ENCRYPT)               \
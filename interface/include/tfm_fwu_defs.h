@@ -8,6 +8,9 @@
 #ifndef TFM_FWU_BOOTLOADER_DEFS_H
 #define TFM_FWU_BOOTLOADER_DEFS_H
 
+#include <stdint.h>
+#include "psa/error.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,6 +26,33 @@ extern "C" {
 #define TFM_FWU_REQUEST_REBOOT       1008
 #define TFM_FWU_ACCEPT               1009
 #define TFM_FWU_QUERY                1010
+#define TFM_FWU_GET_WRITE_STATS      1011
+
+/* The stages of writing an image which are counted in cycles */
+enum tfm_fwu_write_stage_t {
+    TFM_FWU_WRITE_STAGE_ERASE = 0,  /* Erasing the staging area */
+    TFM_FWU_WRITE_STAGE_PROGRAM,    /* Programming the image blocks */
+    TFM_FWU_WRITE_STAGE_HASH,       /* Hashing the image */
+    TFM_FWU_WRITE_STAGE_LOAD,       /* The whole of each psa_fwu_write() */
+    TFM_FWU_WRITE_STAGE_NUM
+};
+
+struct tfm_fwu_write_stats_t {
+    uint32_t blocks;                          /* Blocks loaded successfully */
+    uint64_t bytes;                           /* Bytes in those blocks */
+    uint64_t cycles[TFM_FWU_WRITE_STAGE_NUM]; /* Cycles spent in each stage */
+};
+
+/**
+ * \brief Get the image write statistics of a service built with
+ *        FWU_WRITE_STATS, accumulated since boot.
+ *
+ * \param[out] stats  Where the statistics are written.
+ *
+ * \return Returns PSA_SUCCESS, or PSA_ERROR_NOT_SUPPORTED when the service
+ *         does not count them.
+ */
+psa_status_t tfm_fwu_get_write_stats(struct tfm_fwu_write_stats_t *stats);
 
 #ifdef __cplusplus
 }
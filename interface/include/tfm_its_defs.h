@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2026, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,8 @@
 #ifndef __TFM_ITS_DEFS_H__
 #define __TFM_ITS_DEFS_H__
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +22,73 @@ extern "C" {
 #define TFM_ITS_GET                1002
 #define TFM_ITS_GET_INFO           1003
 #define TFM_ITS_REMOVE             1004
+#define TFM_ITS_GET_BATCH          1005
+#define TFM_ITS_TRANSACTION_BEGIN  1006
+#define TFM_ITS_TRANSACTION_COMMIT 1007
+#define TFM_ITS_TRANSACTION_ABORT  1008
+/* Only served when ITS_FS_FAULT_INJECTION is enabled */
+#define TFM_ITS_FAULT_ARM          1009
+#define TFM_ITS_FAULT_GET_STATS    1010
+/* Only served when ITS_FLASH_STATS_NUM_BLOCKS > 0 */
+#define TFM_ITS_GET_FLASH_STATS    1011
+/* Only served when ITS_READ_CACHE_SIZE > 0 */
+#define TFM_ITS_GET_READ_CACHE_STATS 1012
+
+/* Operations timed by the ITS service when ITS_FS_FAULT_INJECTION is enabled */
+#define TFM_ITS_FAULT_OP_SET       0
+#define TFM_ITS_FAULT_OP_GET       1
+#define TFM_ITS_FAULT_OP_REMOVE    2
+#define TFM_ITS_FAULT_OP_NUM       3
+
+/* Number of latency buckets, bucket n counts the operations of
+ * [2^n, 2^(n+1)) cycles
+ */
+#define TFM_ITS_FAULT_BUCKETS      24
+
+/* Input of TFM_ITS_FAULT_ARM */
+struct tfm_its_fault_arm_t {
+    uint32_t point;         /* Fault point of the metadata block filesystem */
+    uint32_t count;         /* Passes of the point until the reset, 0 disarms */
+};
+
+struct tfm_its_fault_op_stats_t {
+    uint32_t ops;           /* Operations served */
+    uint32_t failures;      /* Operations that did not return PSA_SUCCESS */
+    uint64_t cycles;        /* Sum of the operation latencies */
+    uint32_t max_cycles;    /* Largest operation latency */
+    uint32_t buckets[TFM_ITS_FAULT_BUCKETS]; /* Latency histogram */
+};
+
+/* Output of TFM_ITS_FAULT_GET_STATS, counted since the last boot */
+struct tfm_its_fault_stats_t {
+    uint32_t mount_cycles;  /* Mount of the ITS and PS filesystems */
+    uint32_t points;        /* Fault points passed */
+    struct tfm_its_fault_op_stats_t op[TFM_ITS_FAULT_OP_NUM];
+};
+
+/* Filesystems of TFM_ITS_GET_FLASH_STATS */
+#define TFM_ITS_FLASH_STATS_ITS    0
+#define TFM_ITS_FLASH_STATS_PS     1
+
+/* Number of blocks whose erases are returned by TFM_ITS_GET_FLASH_STATS */
+#define TFM_ITS_FLASH_STATS_BLOCKS 16
+
+/* Output of TFM_ITS_GET_FLASH_STATS, counted since the last boot */
+struct tfm_its_flash_stats_t {
+    uint32_t num_reads;         /* Read operations */
+    uint32_t num_programs;      /* Program operations */
+    uint32_t num_erases;        /* Block erases */
+    uint32_t bytes_read;        /* Bytes read */
+    uint32_t bytes_programmed;  /* Bytes programmed */
+    /* Erases of each of the first blocks, 0 past ITS_FLASH_STATS_NUM_BLOCKS */
+    uint32_t erase_count[TFM_ITS_FLASH_STATS_BLOCKS];
+};
+
+/* Output of TFM_ITS_GET_READ_CACHE_STATS, counted since the last boot */
+struct tfm_its_read_cache_stats_t {
+    uint32_t hits;              /* Reads served from the cache */
+    uint32_t misses;            /* Reads served from the filesystem */
+};
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_PERF_API_H__
+#define __TFM_PERF_API_H__
+
+#include <stdint.h>
+#include "psa/error.h"
+#include "tfm_perf_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of timed iterations of each reference benchmark */
+#ifndef TFM_PERF_ITERATIONS
+#define TFM_PERF_ITERATIONS     100
+#endif
+
+/* Largest asset of a storage pattern */
+#ifndef TFM_PERF_STORAGE_MAX_SIZE
+#define TFM_PERF_STORAGE_MAX_SIZE 1024
+#endif
+
+/* Storage services a storage pattern runs against */
+#define TFM_PERF_STORAGE_ITS    0
+#define TFM_PERF_STORAGE_PS     1
+
+/**
+ * \brief Functions of the client which runs the reference benchmarks.
+ */
+struct tfm_perf_ns_ops_t {
+    /* Reads a cycle counter of the client core, DWT CYCCNT on TrustZone */
+    uint32_t (*cycles)(void);
+    /* Writes one line of the results, without the line ending */
+    void (*output)(const char *line);
+    /* Frequency of the cycle counter in Hz, 0 leaves ops_per_s at 0 */
+    uint32_t clock_hz;
+};
+
+/**
+ * \brief A storage benchmark pattern.
+ */
+struct tfm_perf_storage_pattern_t {
+    uint32_t storage;       /* TFM_PERF_STORAGE_ITS or TFM_PERF_STORAGE_PS */
+    uint32_t asset_size;    /* Up to TFM_PERF_STORAGE_MAX_SIZE bytes */
+    uint32_t asset_count;   /* Up to TFM_PERF_ITERATIONS assets */
+    uint32_t fill_count;    /* Assets kept during the run, the fill level */
+};
+
+/**
+ * \brief Calls the Perf Service, which replies without doing any work.
+ *
+ * \return Returns the status of the call, PSA_SUCCESS if it succeeded.
+ */
+psa_status_t tfm_perf_null_call(void);
+
+/**
+ * \brief Marks the start of a benchmark in the SPM trace.
+ *
+ * \param[in] benchmark   The benchmark, one of the TFM_PERF_BENCH_* values.
+ * \param[in] iterations  Number of iterations the benchmark runs.
+ *
+ * \return Returns the status of the call, PSA_SUCCESS if it succeeded.
+ */
+psa_status_t tfm_perf_begin(uint32_t benchmark, uint32_t iterations);
+
+/**
+ * \brief Marks the end of a benchmark in the SPM trace.
+ *
+ * \param[in] benchmark   The benchmark, one of the TFM_PERF_BENCH_* values.
+ *
+ * \return Returns the status of the call, PSA_SUCCESS if it succeeded.
+ */
+psa_status_t tfm_perf_end(uint32_t benchmark);
+
+/**
+ * \brief Runs the reference benchmarks of the enabled services, then reads
+ *        the boot phase timestamps.
+ *
+ * \details Each benchmark is timed over TFM_PERF_ITERATIONS iterations with
+ *          \p ops->cycles. The results are written as one JSON object per line
+ *          through \p ops->output:
+ *
+ *          {"benchmark": name, "status": s, "iterations": n,
+ *           "ops_per_s": o, "min_cycles": c, "p50_cycles": c,
+ *           "p99_cycles": c, "max_cycles": c}
+ *          {"boot_phase": p, "index": i, "id": id, "cycles": c}
+ *
+ *          The cycles of a boot phase are counted from the first timestamp.
+ *          The report of tfm_perf_its_fault_report() follows when the ITS
+ *          service supports it.
+ *
+ * \param[in] ops  The functions of the client.
+ *
+ * \return Returns PSA_SUCCESS, or the status of the first benchmark or mark
+ *         that failed. The benchmarks after a failed one still run.
+ */
+psa_status_t tfm_perf_run(const struct tfm_perf_ns_ops_t *ops);
+
+/**
+ * \brief Runs a storage pattern: \p p->fill_count assets are stored first and
+ *        kept, then \p p->asset_count assets are set, got and removed.
+ *
+ * \details Each of the set, get and remove operations is written as one line:
+ *
+ *          {"storage": "its"|"ps", "op": "set"|"get"|"remove",
+ *           "asset_size": s, "fill_count": f, "status": s, "iterations": n,
+ *           "ops_per_s": o, "min_cycles": c, "p50_cycles": c,
+ *           "p99_cycles": c, "max_cycles": c}
+ *
+ * \param[in] ops  The functions of the client.
+ * \param[in] p    The pattern.
+ *
+ * \return Returns PSA_SUCCESS, or the status of the first operation that
+ *         failed. The operations after a failed one do not run.
+ */
+psa_status_t tfm_perf_storage_run(const struct tfm_perf_ns_ops_t *ops,
+                                  const struct tfm_perf_storage_pattern_t *p);
+
+/**
+ * \brief Arms the reset of an ITS service built with ITS_FS_FAULT_INJECTION.
+ *        The device is reset, as on a power failure, when the filesystem
+ *        passes \p point for the \p count th time.
+ *
+ * \param[in] point  The point, an its_flash_fs_fault_point_t value.
+ * \param[in] count  Passes of the point until the reset, 0 disarms.
+ *
+ * \return Returns PSA_SUCCESS, or PSA_ERROR_NOT_SUPPORTED without
+ *         ITS_FS_FAULT_INJECTION.
+ */
+psa_status_t tfm_perf_its_fault_arm(uint32_t point, uint32_t count);
+
+/**
+ * \brief Writes the statistics the ITS service counted since the last boot,
+ *        when it is built with ITS_FS_FAULT_INJECTION:
+ *
+ *          {"its_mount_cycles": c, "its_fault_points": n}
+ *          {"its_op": "set"|"get"|"remove", "ops": n, "failures": f,
+ *           "mean_cycles": c, "p50_cycles": c, "p99_cycles": c,
+ *           "max_cycles": c}
+ *
+ *        The mount after an injected reset includes the recovery of the
+ *        interrupted update. The percentiles are the upper bounds of the
+ *        power of two latency buckets.
+ *
+ * \param[in] ops  The functions of the client.
+ *
+ * \return Returns PSA_SUCCESS, or PSA_ERROR_NOT_SUPPORTED without
+ *         ITS_FS_FAULT_INJECTION.
+ */
+psa_status_t tfm_perf_its_fault_report(const struct tfm_perf_ns_ops_t *ops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_PERF_API_H__ */
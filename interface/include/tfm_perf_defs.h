@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_PERF_DEFS_H__
+#define __TFM_PERF_DEFS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Perf message types that distinguish the Perf requests */
+#define TFM_PERF_NULL_CALL          1   /* Replied without any work      */
+#define TFM_PERF_BEGIN              2   /* Start of a benchmark          */
+#define TFM_PERF_END                3   /* End of a benchmark            */
+
+/*
+ * The reference benchmarks, run by tfm_perf_run(). The IDs are recorded in
+ * the SPM trace by TFM_PERF_BEGIN and TFM_PERF_END, and named by
+ * tools/tfm_trace_export.py, so they must not be renumbered.
+ */
+#define TFM_PERF_BENCH_NULL_CALL    1   /* psa_call() to the Perf Service */
+#define TFM_PERF_BENCH_ITS_SET      2   /* psa_its_set() of 64 bytes      */
+#define TFM_PERF_BENCH_ITS_GET      3   /* psa_its_get() of 64 bytes      */
+#define TFM_PERF_BENCH_PS_SET       4   /* psa_ps_set() of 64 bytes       */
+#define TFM_PERF_BENCH_PS_GET       5   /* psa_ps_get() of 64 bytes       */
+#define TFM_PERF_BENCH_HASH         6   /* SHA-256 of 64 bytes            */
+#define TFM_PERF_BENCH_AEAD         7   /* AES-128-GCM of 64 bytes        */
+#define TFM_PERF_BENCH_SIGN         8   /* ECDSA P-256 signature          */
+#define TFM_PERF_BENCH_ATTEST_TOKEN 9   /* Token with a 64 byte challenge */
+
+/* Input of TFM_PERF_BEGIN and TFM_PERF_END */
+struct tfm_perf_mark_t {
+    uint32_t benchmark;                 /* TFM_PERF_BENCH_*               */
+    uint32_t iterations;                /* Number of iterations, 0 at end */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_PERF_DEFS_H__ */
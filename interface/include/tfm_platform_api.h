@@ -21,12 +21,14 @@ extern "C" {
  * \brief TFM secure partition platform API version
  */
 #define TFM_PLATFORM_API_VERSION_MAJOR (0)
-#define TFM_PLATFORM_API_VERSION_MINOR (3)
+#define TFM_PLATFORM_API_VERSION_MINOR (4)
 
 #define TFM_PLATFORM_API_ID_NV_READ       (1010)
 #define TFM_PLATFORM_API_ID_NV_INCREMENT  (1011)
 #define TFM_PLATFORM_API_ID_SYSTEM_RESET  (1012)
 #define TFM_PLATFORM_API_ID_IOCTL         (1013)
+#define TFM_PLATFORM_API_ID_NV_READ_BATCH      (1014)
+#define TFM_PLATFORM_API_ID_NV_INCREMENT_BATCH (1015)
 
 /*!
  * \enum tfm_platform_err_t
@@ -46,6 +48,25 @@ enum tfm_platform_err_t {
 
 typedef int32_t tfm_platform_ioctl_req_t;
 
+/*
+ * IOCTL request handled by the Platform Service itself rather than by
+ * tfm_platform_hal_ioctl(). The input is the uint32_t index of a RoT Service
+ * and the output a struct tfm_service_stat_t. It requires
+ * CONFIG_TFM_SPM_SERVICE_STATS, and is only served to Secure clients, as the
+ * timings of the services would otherwise be a side channel into them.
+ */
+#define TFM_PLATFORM_IOCTL_SERVICE_STATS  ((tfm_platform_ioctl_req_t)0x7FFF0001)
+
+/*
+ * IOCTL request handled by the Platform Service itself, returning the boot
+ * phase timestamps as an array of struct boot_timing_entry, in the order they
+ * were recorded. The optional input is the uint32_t index of the first entry
+ * to return, so that a small output buffer can be filled repeatedly. The
+ * output length is set to the size of the entries returned, 0 once past the
+ * last one. It requires TFM_BOOT_TIMING.
+ */
+#define TFM_PLATFORM_IOCTL_BOOT_TIMING    ((tfm_platform_ioctl_req_t)0x7FFF0002)
+
 /*!
  * \brief Resets the system.
  *
@@ -93,6 +114,36 @@ enum tfm_platform_err_t
 tfm_platform_nv_counter_read(uint32_t counter_id,
                              uint32_t size, uint8_t *val);
 
+/*!
+ * \brief Reads several non-volatile (NV) counters in one request
+ *
+ * \param[in]  counter_ids   Array of the NV counter IDs, each ID only once.
+ * \param[in]  num_counters  Number of entries in counter_ids.
+ * \param[out] vals          Array of num_counters entries to store the
+ *                           current NV counter values.
+ *
+ * \return  TFM_PLATFORM_ERR_SUCCESS if the values are read correctly.
+ *          Otherwise, it returns TFM_PLATFORM_ERR_SYSTEM_ERROR, and no value
+ *          is returned if the caller can not access one of the counters.
+ */
+enum tfm_platform_err_t
+tfm_platform_nv_counter_read_batch(const uint32_t *counter_ids,
+                                   uint32_t num_counters, uint32_t *vals);
+
+/*!
+ * \brief Increments several non-volatile (NV) counters by one in one request
+ *
+ * \param[in]  counter_ids   Array of the NV counter IDs, each ID only once.
+ * \param[in]  num_counters  Number of entries in counter_ids.
+ *
+ * \return  TFM_PLATFORM_ERR_SUCCESS if the counters are incremented correctly.
+ *          Otherwise, it returns TFM_PLATFORM_ERR_SYSTEM_ERROR. No counter is
+ *          incremented if the caller can not access one of them.
+ */
+enum tfm_platform_err_t
+tfm_platform_nv_counter_increment_batch(const uint32_t *counter_ids,
+                                        uint32_t num_counters);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,8 @@
 #ifndef __TFM_PS_DEFS_H__
 #define __TFM_PS_DEFS_H__
 
+#include "psa/error.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,6 +23,15 @@ extern "C" {
 #define TFM_PS_GET_INFO           1003
 #define TFM_PS_REMOVE             1004
 #define TFM_PS_GET_SUPPORT        1005
+#define TFM_PS_FLUSH              1006
+
+/* TF-M specific create flag of psa_ps_set(). The later psa_ps_set() calls on
+ * the asset with the same create flags may be held in the PS partition RAM
+ * and stored later on, if PS is built with PS_WRITE_COALESCE_NUM not 0.
+ * The writes held are lost on a reset that is not preceded by
+ * tfm_ps_flush_writes().
+ */
+#define TFM_PS_FLAG_COALESCE_WRITES (1u << 31)
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_PSA_CALL_ASYNC_H__
+#define __TFM_PSA_CALL_ASYNC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A token identifying an outstanding asynchronous call */
+typedef uint32_t psa_call_token_t;
+
+#define PSA_CALL_TOKEN_NULL             ((psa_call_token_t)0)
+
+/* The asynchronous call is not completed yet */
+#define PSA_CALL_ASYNC_PENDING          ((psa_status_t)-248)
+
+/**
+ * \brief Post a call to a RoT Service without waiting for it to complete.
+ *
+ * \param[in] handle            A handle to an established connection, or a
+ *                              stateless handle.
+ * \param[in] type              The request type, as for psa_call().
+ * \param[in] in_vec            Array of input \ref psa_invec structures.
+ * \param[in] in_len            Number of input \ref psa_invec structures.
+ * \param[in,out] out_vec       Array of output \ref psa_outvec structures.
+ * \param[in] out_len           Number of output \ref psa_outvec structures.
+ * \param[out] token            The token to get the result of the call.
+ *
+ * \retval PSA_SUCCESS          The call is posted. The vectors must remain
+ *                              valid until the call is completed.
+ * \retval Other return code    The call cannot be posted.
+ *
+ * \note The call is only asynchronous in multi-core topology, where the SPE
+ *       handles the call while the NSPE keeps running and the mailbox reply
+ *       IRQ wakes up the task which posted the call.
+ *
+ * \note In Trustzone topology, where the NSPE and the SPE share the core, this
+ *       is a synchronous fallback: the call runs to completion, exactly as
+ *       psa_call(), before psa_call_async() returns. The calling task is
+ *       blocked for the whole call and nothing overlaps with it. Polling or
+ *       waiting on the token then returns the status at once. The fallback
+ *       lets the same client code run in both topologies.
+ */
+psa_status_t psa_call_async(psa_handle_t handle, int32_t type,
+                            const psa_invec *in_vec, size_t in_len,
+                            psa_outvec *out_vec, size_t out_len,
+                            psa_call_token_t *token);
+
+/**
+ * \brief Check if an asynchronous call is completed, without blocking.
+ *
+ * \param[in] token             The token returned by psa_call_async().
+ * \param[out] status           The status of the completed call, as
+ *                              psa_call() would have returned it.
+ *
+ * \retval PSA_SUCCESS          The call is completed and \p token is
+ *                              released.
+ * \retval PSA_CALL_ASYNC_PENDING The call is not completed yet.
+ * \retval PSA_ERROR_INVALID_HANDLE \p token is not an outstanding call.
+ */
+psa_status_t psa_call_async_poll(psa_call_token_t token, psa_status_t *status);
+
+/**
+ * \brief Block until an asynchronous call is completed.
+ *
+ * \param[in] token             The token returned by psa_call_async().
+ * \param[out] status           The status of the completed call.
+ *
+ * \retval PSA_SUCCESS          The call is completed and \p token is
+ *                              released.
+ * \retval PSA_ERROR_INVALID_HANDLE \p token is not an outstanding call.
+ *
+ * \note It must be called by the task which posted the call.
+ */
+psa_status_t psa_call_async_wait(psa_call_token_t token, psa_status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_PSA_CALL_ASYNC_H__ */
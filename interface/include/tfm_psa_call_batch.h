@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_PSA_CALL_BATCH_H__
+#define __TFM_PSA_CALL_BATCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The maximal number of calls in a batch */
+#define PSA_CALL_BATCH_MAX_NUM          8
+
+/* A single call in a batch, holding the parameters of psa_call() */
+struct psa_call_batch_item_t {
+    psa_handle_t    handle;
+    int32_t         type;
+    const psa_invec *in_vec;
+    size_t          in_len;
+    psa_outvec      *out_vec;
+    size_t          out_len;
+};
+
+/**
+ * \brief Call several RoT Services with one request to the SPE.
+ *
+ * \param[in] items             Array of calls, issued in array order.
+ * \param[out] statuses         Array receiving the status of each call, as
+ *                              psa_call() would have returned it.
+ * \param[in] num               Number of calls, 1 to
+ *                              \ref PSA_CALL_BATCH_MAX_NUM.
+ *
+ * \retval PSA_SUCCESS          All the calls have been handled. Check
+ *                              \p statuses for the result of each call.
+ * \retval Other return code    The batch itself is invalid or cannot be
+ *                              delivered. \p statuses is not updated.
+ *
+ * \note Calls to the same stateless service are handled in order. A
+ *       connection handle must not appear more than once in a batch.
+ */
+psa_status_t psa_call_batch(const struct psa_call_batch_item_t *items,
+                            psa_status_t *statuses,
+                            size_t num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_PSA_CALL_BATCH_H__ */
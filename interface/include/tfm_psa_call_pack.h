@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,7 +8,9 @@
 #ifndef __TFM_PSA_CALL_PACK_H__
 #define __TFM_PSA_CALL_PACK_H__
 
+#include <stdint.h>
 #include "psa/client.h"
+#include "tfm_psa_call_batch.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +28,29 @@ extern "C" {
          ((((uint32_t)in_len) << IN_LEN_OFFSET) & IN_LEN_MASK) | \
          ((((uint32_t)out_len) << OUT_LEN_OFFSET) & OUT_LEN_MASK))
 
+/*
+ * PARAM_PACK() for call sites where type, in_len and out_len are integer
+ * constant expressions. The range checks psa_call() does at runtime are done
+ * while compiling instead, and the build fails if a parameter does not fit or
+ * is not a constant.
+ */
+#define PARAM_PACK_CONST(type, in_len, out_len)                         \
+        ((uint32_t)(PARAM_PACK(type, in_len, out_len) +                 \
+         0U * sizeof(struct {                                           \
+             int param_pack_check :                                     \
+                 (((type) <= INT16_MAX) && ((type) >= INT16_MIN) &&     \
+                  ((in_len) <= UINT8_MAX) &&                            \
+                  ((out_len) <= UINT8_MAX)) ? 1 : -1;                   \
+         })))
+
+/*
+ * Same as psa_call() for constant type, in_len and out_len, with the checks
+ * and the packing of these parameters done at compile time.
+ */
+#define TFM_PSA_CALL_CONST(handle, type, in_vec, in_len, out_vec, out_len) \
+        tfm_psa_call_pack((handle), PARAM_PACK_CONST(type, in_len, out_len), \
+                          (in_vec), (out_vec))
+
 #define PARAM_UNPACK_TYPE(ctrl_param) \
         ((int32_t)(((ctrl_param) & TYPE_MASK) >> TYPE_OFFSET))
 
@@ -35,11 +60,23 @@ extern "C" {
 #define PARAM_UNPACK_OUT_LEN(ctrl_param) \
         ((size_t)(((ctrl_param) & OUT_LEN_MASK) >> OUT_LEN_OFFSET))
 
+/*
+ * psa_call() with type, in_len and out_len packed by PARAM_PACK(), and not
+ * checked again. Provided by the client implementation of each environment.
+ */
 psa_status_t tfm_psa_call_pack(psa_handle_t handle,
                                uint32_t ctrl_param,
                                const psa_invec *in_vec,
                                psa_outvec *out_vec);
 
+/*
+ * Issue the calls of a batch from the NSPE one by one, and write the status
+ * of each call back to the NSPE. Used by the Trustzone NS Agent.
+ */
+psa_status_t tfm_psa_call_batch_pack(const struct psa_call_batch_item_t *items,
+                                     psa_status_t *statuses,
+                                     uint32_t num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SERVICE_STATS_H__
+#define __TFM_SERVICE_STATS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Usage statistics of one RoT Service, recorded by SPM when
+ * CONFIG_TFM_SPM_SERVICE_STATS is enabled. Cycles are counted from
+ * psa_call() entry to the reply, with the DWT cycle counter when the core
+ * has one.
+ */
+struct tfm_service_stat_t {
+    uint32_t sid;                       /* Service ID                     */
+    int32_t  partition_id;              /* Owner Partition ID             */
+    uint32_t calls;                     /* psa_call() requests replied    */
+    uint32_t max_cycles;                /* Longest request in cycles      */
+    uint64_t total_cycles;              /* Sum of all requests in cycles  */
+    uint32_t queue_hwm;                 /* Maximal pending messages       */
+    uint32_t rejected;                  /* Refused or busy connections    */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SERVICE_STATS_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -12,6 +12,9 @@
 #include "psa/error.h"
 #include "tfm_api.h"
 #include "tfm_ns_mailbox.h"
+#include "tfm_psa_call_batch.h"
+#include "tfm_psa_call_async.h"
+#include "tfm_psa_call_pack.h"
 
 /*
  * TODO
@@ -35,6 +38,41 @@
  */
 #define PSA_INTER_CORE_COMM_ERR         (INT32_MIN + 0xFF)
 
+/*
+ * The framework version and the versions of the RoT Services do not change
+ * after boot, so the first answer is kept and the later calls do not send a
+ * mailbox message. TFM_NS_PSA_VERSION_CACHE_SIZE is the number of RoT Services
+ * whose version is kept, 0 disables the cache.
+ */
+#ifndef TFM_NS_PSA_VERSION_CACHE_SIZE
+#define TFM_NS_PSA_VERSION_CACHE_SIZE   8
+#endif
+
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+static volatile uint32_t framework_version = PSA_VERSION_NONE;
+
+/* Accessed under the NSPE local mailbox spin lock */
+static struct {
+    uint32_t sid;
+    uint32_t version;
+} version_cache[TFM_NS_PSA_VERSION_CACHE_SIZE];
+static uint32_t version_cache_count;
+
+static bool version_cache_lookup(uint32_t sid, uint32_t *version)
+{
+    uint32_t i;
+
+    for (i = 0; i < version_cache_count; i++) {
+        if (version_cache[i].sid == sid) {
+            *version = version_cache[i].version;
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif /* TFM_NS_PSA_VERSION_CACHE_SIZE > 0 */
+
 /**** API functions ****/
 
 uint32_t psa_framework_version(void)
@@ -43,6 +81,12 @@ uint32_t psa_framework_version(void)
     uint32_t version;
     int32_t ret;
 
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+    if (framework_version != PSA_VERSION_NONE) {
+        return framework_version;
+    }
+#endif
+
     ret = tfm_ns_mailbox_client_call(MAILBOX_PSA_FRAMEWORK_VERSION,
                                      &params, NON_SECURE_CLIENT_ID,
                                      (int32_t *)&version);
@@ -50,6 +94,10 @@ uint32_t psa_framework_version(void)
         version = PSA_VERSION_NONE;
     }
 
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+    framework_version = version;
+#endif
+
     return version;
 }
 
@@ -58,6 +106,17 @@ uint32_t psa_version(uint32_t sid)
     struct psa_client_params_t params;
     uint32_t version;
     int32_t ret;
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+    uint32_t cached;
+    bool found;
+
+    tfm_ns_mailbox_os_spin_lock();
+    found = version_cache_lookup(sid, &version);
+    tfm_ns_mailbox_os_spin_unlock();
+    if (found) {
+        return version;
+    }
+#endif
 
     params.psa_version_params.sid = sid;
 
@@ -65,8 +124,20 @@ uint32_t psa_version(uint32_t sid)
                                      NON_SECURE_CLIENT_ID,
                                      (int32_t *)&version);
     if (ret != MAILBOX_SUCCESS) {
-        version = PSA_VERSION_NONE;
+        /* Not kept, as the failure may not happen again */
+        return PSA_VERSION_NONE;
+    }
+
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+    tfm_ns_mailbox_os_spin_lock();
+    if ((version_cache_count < TFM_NS_PSA_VERSION_CACHE_SIZE) &&
+        !version_cache_lookup(sid, &cached)) {
+        version_cache[version_cache_count].sid = sid;
+        version_cache[version_cache_count].version = version;
+        version_cache_count++;
     }
+    tfm_ns_mailbox_os_spin_unlock();
+#endif
 
     return version;
 }
@@ -115,6 +186,100 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type,
     return status;
 }
 
+/* The mailbox carries the parameters unpacked */
+psa_status_t tfm_psa_call_pack(psa_handle_t handle,
+                               uint32_t ctrl_param,
+                               const psa_invec *in_vec,
+                               psa_outvec *out_vec)
+{
+    return psa_call(handle, (int16_t)PARAM_UNPACK_TYPE(ctrl_param),
+                    in_vec, PARAM_UNPACK_IN_LEN(ctrl_param),
+                    out_vec, PARAM_UNPACK_OUT_LEN(ctrl_param));
+}
+
+psa_status_t psa_call_batch(const struct psa_call_batch_item_t *items,
+                            psa_status_t *statuses,
+                            size_t num)
+{
+    struct psa_client_params_t params;
+    int32_t ret;
+    psa_status_t status;
+
+    if ((num == 0) || (num > PSA_CALL_BATCH_MAX_NUM)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    params.psa_call_batch_params.items = items;
+    params.psa_call_batch_params.statuses = statuses;
+    params.psa_call_batch_params.num = num;
+
+    /* The whole batch takes one mailbox slot and one reply. */
+    ret = tfm_ns_mailbox_client_call(MAILBOX_PSA_CALL_BATCH, &params,
+                                     NON_SECURE_CLIENT_ID,
+                                     (int32_t *)&status);
+    if (ret != MAILBOX_SUCCESS) {
+        status = PSA_INTER_CORE_COMM_ERR;
+    }
+
+    return status;
+}
+
+#ifndef TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD
+psa_status_t psa_call_async(psa_handle_t handle, int32_t type,
+                            const psa_invec *in_vec, size_t in_len,
+                            psa_outvec *out_vec, size_t out_len,
+                            psa_call_token_t *token)
+{
+    struct psa_client_params_t params;
+    int32_t ret;
+
+    if (!token) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    params.psa_call_params.handle = handle;
+    params.psa_call_params.type = type;
+    params.psa_call_params.in_vec = in_vec;
+    params.psa_call_params.in_len = in_len;
+    params.psa_call_params.out_vec = out_vec;
+    params.psa_call_params.out_len = out_len;
+
+    ret = tfm_ns_mailbox_client_call_async(MAILBOX_PSA_CALL, &params,
+                                           NON_SECURE_CLIENT_ID, token);
+    if (ret != MAILBOX_SUCCESS) {
+        return PSA_INTER_CORE_COMM_ERR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t async_mailbox_to_status(int32_t ret)
+{
+    switch (ret) {
+    case MAILBOX_SUCCESS:
+        return PSA_SUCCESS;
+    case MAILBOX_NO_PEND_EVENT:
+        return PSA_CALL_ASYNC_PENDING;
+    case MAILBOX_INVAL_PARAMS:
+        return PSA_ERROR_INVALID_HANDLE;
+    default:
+        return PSA_INTER_CORE_COMM_ERR;
+    }
+}
+
+psa_status_t psa_call_async_poll(psa_call_token_t token, psa_status_t *status)
+{
+    return async_mailbox_to_status(
+                    tfm_ns_mailbox_client_poll(token, (int32_t *)status));
+}
+
+psa_status_t psa_call_async_wait(psa_call_token_t token, psa_status_t *status)
+{
+    return async_mailbox_to_status(
+                    tfm_ns_mailbox_client_wait(token, (int32_t *)status));
+}
+#endif /* !TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD */
+
 void psa_close(psa_handle_t handle)
 {
     struct psa_client_params_t params;
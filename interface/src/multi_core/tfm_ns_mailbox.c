@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -17,13 +17,6 @@ static struct ns_mailbox_queue_t *mailbox_queue_ptr = NULL;
 
 static int32_t mailbox_wait_reply(uint8_t idx);
 
-static inline void set_queue_slot_empty(uint8_t idx)
-{
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        mailbox_queue_ptr->empty_slots |= (1UL << idx);
-    }
-}
-
 static inline void set_queue_slot_woken(uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
@@ -51,47 +44,20 @@ static inline void clear_queue_slot_woken(uint8_t idx)
 static inline void clear_queue_slot_replied(uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        mailbox_queue_ptr->replied_slots &= ~(1UL << idx);
+        mailbox_status_clear_slot(&mailbox_queue_ptr->replied_slots, idx);
     }
 }
 
 static inline bool is_queue_slot_replied(uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        return mailbox_queue_ptr->replied_slots & (1UL << idx);
+        return mailbox_status_has_slot(&mailbox_queue_ptr->replied_slots, idx);
     }
 
     return false;
 }
 #endif /* !defined TFM_MULTI_CORE_NS_OS */
 
-static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
-{
-    uint8_t idx;
-    mailbox_queue_status_t status;
-
-    tfm_ns_mailbox_os_spin_lock();
-    status = queue->empty_slots;
-    tfm_ns_mailbox_os_spin_unlock();
-
-    if (!status) {
-        /* No empty slot */
-        return NUM_MAILBOX_QUEUE_SLOT;
-    }
-
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        if (status & (1 << idx)) {
-            break;
-        }
-    }
-
-    tfm_ns_mailbox_os_spin_lock();
-    clear_queue_slot_empty(queue, idx);
-    tfm_ns_mailbox_os_spin_unlock();
-
-    return idx;
-}
-
 static void set_msg_owner(uint8_t idx, const void *owner)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
@@ -107,8 +73,10 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
     uint8_t idx;
     struct mailbox_msg_t *msg_ptr;
     const void *task_handle;
+    bool spe_polling;
 
-    idx = acquire_empty_slot(mailbox_queue_ptr);
+    /* Concurrent callers each claim a different slot without locking. */
+    idx = claim_queue_slot_empty(mailbox_queue_ptr);
     if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
         return MAILBOX_QUEUE_FULL;
     }
@@ -133,9 +101,13 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
 
     tfm_ns_mailbox_hal_enter_critical();
     set_queue_slot_pend(mailbox_queue_ptr, idx);
+    spe_polling = mailbox_queue_ptr->spe_polling;
     tfm_ns_mailbox_hal_exit_critical();
 
-    tfm_ns_mailbox_hal_notify_peer();
+    /* SPE picks the request up without a doorbell while it is polling */
+    if (!spe_polling) {
+        tfm_ns_mailbox_hal_notify_peer();
+    }
 
     *slot_idx = idx;
 
@@ -144,6 +116,8 @@ static int32_t mailbox_tx_client_req(uint32_t call_type,
 
 static int32_t mailbox_rx_client_reply(uint8_t idx, int32_t *reply)
 {
+    mailbox_queue_status_t slot;
+
     *reply = mailbox_queue_ptr->queue[idx].reply.return_val;
 
     /* Clear up the owner field */
@@ -155,7 +129,9 @@ static int32_t mailbox_rx_client_reply(uint8_t idx, int32_t *reply)
      * Make sure that the empty flag is set after all the other status flags are
      * re-initialized.
      */
-    set_queue_slot_empty(idx);
+    mailbox_status_zero(&slot);
+    mailbox_status_set_slot(&slot, idx);
+    release_queue_slots_empty(mailbox_queue_ptr, &slot);
     tfm_ns_mailbox_os_spin_unlock();
 
     return MAILBOX_SUCCESS;
@@ -204,6 +180,128 @@ exit:
     return ret;
 }
 
+/*
+ * Token of the asynchronous call held in each slot. The low byte is the slot
+ * index plus 1 and the upper bits a sequence number, so that a stale token
+ * never matches a slot reused by a later call.
+ */
+#define ASYNC_TOKEN_IDX_MASK            0xFFUL
+#define ASYNC_TOKEN_SEQ_SHIFT           8
+
+static uint32_t async_tokens[NUM_MAILBOX_QUEUE_SLOT];
+static uint32_t async_seq;
+
+static bool mailbox_wait_reply_signal(uint8_t idx);
+
+static uint8_t async_token_to_idx(uint32_t token)
+{
+    uint32_t idx = (token & ASYNC_TOKEN_IDX_MASK) - 1;
+    bool valid;
+
+    if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
+        return NUM_MAILBOX_QUEUE_SLOT;
+    }
+
+    tfm_ns_mailbox_os_spin_lock();
+    valid = (async_tokens[idx] == token);
+    tfm_ns_mailbox_os_spin_unlock();
+
+    return valid ? (uint8_t)idx : NUM_MAILBOX_QUEUE_SLOT;
+}
+
+static int32_t async_fetch_reply(uint8_t idx, int32_t *reply)
+{
+    int32_t ret;
+
+    tfm_ns_mailbox_os_spin_lock();
+    async_tokens[idx] = 0;
+    tfm_ns_mailbox_os_spin_unlock();
+
+    ret = mailbox_rx_client_reply(idx, reply);
+
+    /* Release the lock acquired when the call was sent. */
+    if (tfm_ns_mailbox_os_lock_release() != MAILBOX_SUCCESS) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return ret;
+}
+
+int32_t tfm_ns_mailbox_client_call_async(uint32_t call_type,
+                                         const struct psa_client_params_t *params,
+                                         int32_t client_id,
+                                         uint32_t *token)
+{
+    uint8_t slot_idx = NUM_MAILBOX_QUEUE_SLOT;
+    uint32_t seq;
+    int32_t ret;
+
+    if (!mailbox_queue_ptr) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    if (!params || !token) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    if (tfm_ns_mailbox_os_lock_acquire() != MAILBOX_SUCCESS) {
+        return MAILBOX_QUEUE_FULL;
+    }
+
+    ret = mailbox_tx_client_req(call_type, params, client_id, &slot_idx);
+    if (ret != MAILBOX_SUCCESS) {
+        (void)tfm_ns_mailbox_os_lock_release();
+        return ret;
+    }
+
+    tfm_ns_mailbox_os_spin_lock();
+    seq = ++async_seq;
+    async_tokens[slot_idx] = (seq << ASYNC_TOKEN_SEQ_SHIFT) |
+                             ((uint32_t)slot_idx + 1);
+    *token = async_tokens[slot_idx];
+    tfm_ns_mailbox_os_spin_unlock();
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_client_poll(uint32_t token, int32_t *reply)
+{
+    uint8_t idx;
+
+    if (!mailbox_queue_ptr) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    idx = async_token_to_idx(token);
+    if ((idx >= NUM_MAILBOX_QUEUE_SLOT) || !reply) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    if (!mailbox_wait_reply_signal(idx)) {
+        return MAILBOX_NO_PEND_EVENT;
+    }
+
+    return async_fetch_reply(idx, reply);
+}
+
+int32_t tfm_ns_mailbox_client_wait(uint32_t token, int32_t *reply)
+{
+    uint8_t idx;
+
+    if (!mailbox_queue_ptr) {
+        return MAILBOX_INIT_ERROR;
+    }
+
+    idx = async_token_to_idx(token);
+    if ((idx >= NUM_MAILBOX_QUEUE_SLOT) || !reply) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    mailbox_wait_reply(idx);
+
+    return async_fetch_reply(idx, reply);
+}
+
 #ifdef TFM_MULTI_CORE_NS_OS
 int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
 {
@@ -215,23 +313,21 @@ int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
     }
 
     tfm_ns_mailbox_hal_enter_critical_isr();
-    replied_status = mailbox_queue_ptr->replied_slots;
-    clear_queue_slot_all_replied(mailbox_queue_ptr, replied_status);
+    mailbox_status_copy(&replied_status, &mailbox_queue_ptr->replied_slots);
+    clear_queue_slot_all_replied(mailbox_queue_ptr, &replied_status);
     tfm_ns_mailbox_hal_exit_critical_isr();
 
-    if (!replied_status) {
+    if (mailbox_status_is_zero(&replied_status)) {
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        /*
-         * The reply has already received from SPE mailbox but
-         * the wake-up signal is not sent yet.
-         */
-        if (!(replied_status & (0x1UL << idx))) {
-            continue;
-        }
-
+    /*
+     * The replies have already been received from SPE mailbox but the
+     * wake-up signals are not sent yet.
+     */
+    for (idx = mailbox_status_next_slot(&replied_status, 0);
+         idx < NUM_MAILBOX_QUEUE_SLOT;
+         idx = mailbox_status_next_slot(&replied_status, idx + 1)) {
         /* Set woken-up flag */
         tfm_ns_mailbox_hal_enter_critical_isr();
         set_queue_slot_woken(idx);
@@ -239,17 +335,12 @@ int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
 
         tfm_ns_mailbox_os_wake_task_isr(
                                      mailbox_queue_ptr->queue[idx].reply.owner);
-
-        replied_status &= ~(0x1UL << idx);
-        if (!replied_status) {
-            break;
-        }
     }
 
     return MAILBOX_SUCCESS;
 }
 
-static inline bool mailbox_wait_reply_signal(uint8_t idx)
+static bool mailbox_wait_reply_signal(uint8_t idx)
 {
     bool is_set = false;
 
@@ -265,7 +356,7 @@ static inline bool mailbox_wait_reply_signal(uint8_t idx)
     return is_set;
 }
 #else /* TFM_MULTI_CORE_NS_OS */
-static inline bool mailbox_wait_reply_signal(uint8_t idx)
+static bool mailbox_wait_reply_signal(uint8_t idx)
 {
     bool is_set = false;
 
@@ -286,8 +377,24 @@ static int32_t mailbox_wait_reply(uint8_t idx)
 {
     bool is_replied;
 
+#if !defined(TFM_MULTI_CORE_NS_OS) && !defined(TFM_MULTI_CORE_NS_MAILBOX_WAIT_WFE)
+    /* Bare metal NSPE spins on replied_slots, so SPE can skip the doorbell. */
+    tfm_ns_mailbox_hal_enter_critical();
+    mailbox_queue_ptr->ns_polling = true;
+    tfm_ns_mailbox_hal_exit_critical();
+#endif
+
     while (1) {
+#if !defined(TFM_MULTI_CORE_NS_OS) && defined(TFM_MULTI_CORE_NS_MAILBOX_WAIT_WFE)
+        /*
+         * Sleep until the reply doorbell or any other event. The event
+         * register is set if the doorbell came in after the last check, so
+         * the reply cannot be missed.
+         */
+        tfm_ns_mailbox_hal_wait_reply();
+#else
         tfm_ns_mailbox_os_wait_reply();
+#endif
 
         /*
          * Woken up from sleep
@@ -306,6 +413,12 @@ static int32_t mailbox_wait_reply(uint8_t idx)
         }
     }
 
+#if !defined(TFM_MULTI_CORE_NS_OS) && !defined(TFM_MULTI_CORE_NS_MAILBOX_WAIT_WFE)
+    tfm_ns_mailbox_hal_enter_critical();
+    mailbox_queue_ptr->ns_polling = false;
+    tfm_ns_mailbox_hal_exit_critical();
+#endif
+
     return MAILBOX_SUCCESS;
 }
 
@@ -325,10 +438,7 @@ int32_t tfm_ns_mailbox_init(struct ns_mailbox_queue_t *queue)
     memset(queue, 0, sizeof(*queue));
 
     /* Initialize empty bitmask */
-    queue->empty_slots =
-            (mailbox_queue_status_t)((1UL << (NUM_MAILBOX_QUEUE_SLOT - 1)) - 1);
-    queue->empty_slots +=
-            (mailbox_queue_status_t)(1UL << (NUM_MAILBOX_QUEUE_SLOT - 1));
+    mailbox_status_fill(&queue->empty_slots, NUM_MAILBOX_QUEUE_SLOT);
 
     mailbox_queue_ptr = queue;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -50,11 +50,6 @@ static const void *ns_mailbox_thread_handle = NULL;
 /* The pointer to NSPE mailbox queue */
 static struct ns_mailbox_queue_t *mailbox_queue_ptr = NULL;
 
-static inline void set_queue_slot_all_empty(mailbox_queue_status_t completed)
-{
-    mailbox_queue_ptr->empty_slots |= completed;
-}
-
 static inline void set_queue_slot_woken(uint8_t idx)
 {
     if (idx < NUM_MAILBOX_QUEUE_SLOT) {
@@ -65,14 +60,10 @@ static inline void set_queue_slot_woken(uint8_t idx)
 static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
 {
     uint8_t idx;
-    mailbox_queue_status_t status;
 
     while (1) {
-        tfm_ns_mailbox_os_spin_lock();
-        status = queue->empty_slots;
-        tfm_ns_mailbox_os_spin_unlock();
-
-        if (status) {
+        idx = claim_queue_slot_empty(queue);
+        if (idx < NUM_MAILBOX_QUEUE_SLOT) {
             break;
         }
 
@@ -81,20 +72,19 @@ static uint8_t acquire_empty_slot(struct ns_mailbox_queue_t *queue)
         /* DSB to make sure the thread sleeps after the flag is set */
         __DSB();
 
-        /* Wait for an empty slot released by a completed mailbox message */
-        tfm_ns_mailbox_os_wait_reply();
-        queue->is_full = false;
-    }
-
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        if (status & (1 << idx)) {
+        /*
+         * Check again in case a slot was released before the flag was set,
+         * otherwise wait for a slot released by a completed mailbox message.
+         */
+        idx = claim_queue_slot_empty(queue);
+        if (idx < NUM_MAILBOX_QUEUE_SLOT) {
+            queue->is_full = false;
             break;
         }
-    }
 
-    tfm_ns_mailbox_os_spin_lock();
-    clear_queue_slot_empty(queue, idx);
-    tfm_ns_mailbox_os_spin_unlock();
+        tfm_ns_mailbox_os_wait_reply();
+        queue->is_full = false;
+    }
 
     return idx;
 }
@@ -105,6 +95,7 @@ static int32_t mailbox_tx_client_call_msg(const struct ns_mailbox_req_t *req,
     struct mailbox_msg_t *msg_ptr;
     struct mailbox_reply_t *reply_ptr;
     uint8_t idx = NUM_MAILBOX_QUEUE_SLOT;
+    bool spe_polling;
 
     idx = acquire_empty_slot(mailbox_queue_ptr);
     if (idx == NUM_MAILBOX_QUEUE_SLOT) {
@@ -134,9 +125,13 @@ static int32_t mailbox_tx_client_call_msg(const struct ns_mailbox_req_t *req,
 
     tfm_ns_mailbox_hal_enter_critical();
     set_queue_slot_pend(mailbox_queue_ptr, idx);
+    spe_polling = mailbox_queue_ptr->spe_polling;
     tfm_ns_mailbox_hal_exit_critical();
 
-    tfm_ns_mailbox_hal_notify_peer();
+    /* SPE picks the request up without a doorbell while it is polling */
+    if (!spe_polling) {
+        tfm_ns_mailbox_hal_notify_peer();
+    }
 
     if (slot_idx) {
         *slot_idx = idx;
@@ -238,30 +233,28 @@ int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
 {
     uint8_t idx;
     const void *task_handle;
-    mailbox_queue_status_t replied_status, complete_slots = 0x0;
+    mailbox_queue_status_t replied_status;
 
     if (!mailbox_queue_ptr) {
         return MAILBOX_INIT_ERROR;
     }
 
     tfm_ns_mailbox_hal_enter_critical_isr();
-    replied_status = mailbox_queue_ptr->replied_slots;
-    clear_queue_slot_all_replied(mailbox_queue_ptr, replied_status);
+    mailbox_status_copy(&replied_status, &mailbox_queue_ptr->replied_slots);
+    clear_queue_slot_all_replied(mailbox_queue_ptr, &replied_status);
     tfm_ns_mailbox_hal_exit_critical_isr();
 
-    if (!replied_status) {
+    if (mailbox_status_is_zero(&replied_status)) {
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        /*
-         * The reply has already received from SPE mailbox but
-         * the wake-up signal is not sent yet.
-         */
-        if (!(replied_status & (0x1UL << idx))) {
-            continue;
-        }
-
+    /*
+     * The replies have already been received from SPE mailbox but the
+     * wake-up signals are not sent yet.
+     */
+    for (idx = mailbox_status_next_slot(&replied_status, 0);
+         idx < NUM_MAILBOX_QUEUE_SLOT;
+         idx = mailbox_status_next_slot(&replied_status, idx + 1)) {
         /*
          * Write back the return result.
          * When TFM_MULTI_CORE_NS_OS_MAILBOX_THREAD is enabled, a reply is
@@ -279,16 +272,10 @@ int32_t tfm_ns_mailbox_wake_reply_owner_isr(void)
         if (task_handle) {
             tfm_ns_mailbox_os_wake_task_isr(task_handle);
         }
-
-        complete_slots |= (1UL << idx);
-
-        replied_status &= ~(0x1UL << idx);
-        if (!replied_status) {
-            break;
-        }
     }
 
-    set_queue_slot_all_empty(complete_slots);
+    /* All the replied slots are completed */
+    release_queue_slots_empty(mailbox_queue_ptr, &replied_status);
 
     /*
      * Wake up the NS mailbox thread in case it is waiting for
@@ -330,10 +317,7 @@ int32_t tfm_ns_mailbox_init(struct ns_mailbox_queue_t *queue)
     memset(queue, 0, sizeof(*queue));
 
     /* Initialize empty bitmask */
-    queue->empty_slots =
-            (mailbox_queue_status_t)((1UL << (NUM_MAILBOX_QUEUE_SLOT - 1)) - 1);
-    queue->empty_slots +=
-            (mailbox_queue_status_t)(1UL << (NUM_MAILBOX_QUEUE_SLOT - 1));
+    mailbox_status_fill(&queue->empty_slots, NUM_MAILBOX_QUEUE_SLOT);
 
     mailbox_queue_ptr = queue;
 
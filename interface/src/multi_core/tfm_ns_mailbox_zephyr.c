@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * NSPE mailbox RTOS abstraction for Zephyr, with TFM_MULTI_CORE_NS_OS.
+ *
+ * The NS threads don't serialize on a global lock. The lock counts the free
+ * mailbox queue slots, so up to NUM_MAILBOX_QUEUE_SLOT PSA client calls are in
+ * flight at the same time and the next caller sleeps until a slot is released.
+ *
+ * Each thread waits for its replies on its own k_poll signal, which
+ * tfm_ns_mailbox_wake_reply_owner_isr() raises from the reply IRQ. The signal
+ * is thread local, so it requires CONFIG_THREAD_LOCAL_STORAGE, and the PSA
+ * client calls are made by supervisor threads. The task handle of a thread is
+ * the address of its signal: a thread sending asynchronous PSA client calls can
+ * put it in a k_poll event, with K_POLL_MODE_NOTIFY_ONLY, to wait for the
+ * replies together with its other events, then fetch them with
+ * tfm_ns_mailbox_client_poll().
+ */
+
+#include <stdbool.h>
+
+#include <zephyr/kernel.h>
+
+#include "tfm_ns_mailbox.h"
+
+#ifdef TFM_MULTI_CORE_NS_OS
+
+static struct k_sem mailbox_slot_sem;
+static struct k_spinlock mailbox_spin_lock;
+static k_spinlock_key_t mailbox_spin_key;
+
+static __thread struct k_poll_signal reply_signal;
+static __thread bool reply_signal_inited;
+
+static struct k_poll_signal *get_reply_signal(void)
+{
+    if (!reply_signal_inited) {
+        k_poll_signal_init(&reply_signal);
+        reply_signal_inited = true;
+    }
+
+    return &reply_signal;
+}
+
+int32_t tfm_ns_mailbox_os_lock_init(void)
+{
+    if (k_sem_init(&mailbox_slot_sem, NUM_MAILBOX_QUEUE_SLOT,
+                   NUM_MAILBOX_QUEUE_SLOT) != 0) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_os_lock_acquire(void)
+{
+    if (k_sem_take(&mailbox_slot_sem, K_FOREVER) != 0) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_os_lock_release(void)
+{
+    k_sem_give(&mailbox_slot_sem);
+
+    return MAILBOX_SUCCESS;
+}
+
+const void *tfm_ns_mailbox_os_get_task_handle(void)
+{
+    return get_reply_signal();
+}
+
+void tfm_ns_mailbox_os_wait_reply(void)
+{
+    struct k_poll_event event;
+
+    k_poll_event_init(&event, K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+                      get_reply_signal());
+
+    (void)k_poll(&event, 1, K_FOREVER);
+
+    /*
+     * The woken flag of a slot is set before its owner is signalled, so a reply
+     * raising the signal again after the reset is only a spurious wake-up,
+     * handled by the caller checking the flag.
+     */
+    k_poll_signal_reset(get_reply_signal());
+}
+
+void tfm_ns_mailbox_os_wake_task_isr(const void *task_handle)
+{
+    if (task_handle) {
+        (void)k_poll_signal_raise((struct k_poll_signal *)task_handle, 0);
+    }
+}
+
+void *tfm_ns_mailbox_os_mq_create(size_t msg_size, uint8_t msg_count)
+{
+    static struct k_msgq mailbox_msgq;
+
+    if (k_msgq_alloc_init(&mailbox_msgq, msg_size, msg_count) != 0) {
+        return NULL;
+    }
+
+    return &mailbox_msgq;
+}
+
+int32_t tfm_ns_mailbox_os_mq_send(void *mq_handle, const void *msg_ptr)
+{
+    if (!mq_handle || !msg_ptr) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    if (k_msgq_put((struct k_msgq *)mq_handle, msg_ptr, K_FOREVER) != 0) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+int32_t tfm_ns_mailbox_os_mq_receive(void *mq_handle, void *msg_ptr)
+{
+    if (!mq_handle || !msg_ptr) {
+        return MAILBOX_INVAL_PARAMS;
+    }
+
+    if (k_msgq_get((struct k_msgq *)mq_handle, msg_ptr, K_FOREVER) != 0) {
+        return MAILBOX_GENERIC_ERROR;
+    }
+
+    return MAILBOX_SUCCESS;
+}
+
+void tfm_ns_mailbox_os_spin_lock(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&mailbox_spin_lock);
+
+    /* Only the holder of the lock writes the key. */
+    mailbox_spin_key = key;
+}
+
+void tfm_ns_mailbox_os_spin_unlock(void)
+{
+    k_spin_unlock(&mailbox_spin_lock, mailbox_spin_key);
+}
+
+#endif /* TFM_MULTI_CORE_NS_OS */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2023 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -10,6 +10,13 @@
 /* This file provides implementation of TF-M NS os wrapper functions for the
  * RTOS use case. This implementation provides multithread safety, so it
  * can be used in RTOS environment.
+ *
+ * The lock cannot be dropped, even with the NS client extension. All the NS
+ * threads reach TF-M through the single thread of the TrustZone NS agent, so
+ * a veneer entered while another NS thread is already in the secure side is a
+ * reentry, which the SPM treats as a fault rather than another client. The NS
+ * client extension only attributes the calls to NS clients; it does not give
+ * each of them a secure thread.
  */
 
 #include <stdint.h>
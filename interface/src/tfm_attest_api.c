@@ -1,12 +1,14 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include <stdint.h>
 #include "psa/initial_attestation.h"
 #include "psa/client.h"
+#include "tfm_psa_call_pack.h"
 #include "psa/crypto_types.h"
 #include "psa_manifest/sid.h"
 #include "tfm_attest_defs.h"
@@ -27,9 +29,9 @@ psa_initial_attest_get_token(const uint8_t *auth_challenge,
         {token_buf, token_buf_size}
     };
 
-    status = psa_call(TFM_ATTESTATION_SERVICE_HANDLE, TFM_ATTEST_GET_TOKEN,
-                      in_vec, IOVEC_LEN(in_vec),
-                      out_vec, IOVEC_LEN(out_vec));
+    status = TFM_PSA_CALL_CONST(TFM_ATTESTATION_SERVICE_HANDLE,
+                                TFM_ATTEST_GET_TOKEN, in_vec, IOVEC_LEN(in_vec),
+                                out_vec, IOVEC_LEN(out_vec));
 
     if (status == PSA_SUCCESS) {
         *token_size = out_vec[0].len;
@@ -50,9 +52,49 @@ psa_initial_attest_get_token_size(size_t  challenge_size,
         {token_size, sizeof(size_t)}
     };
 
-    status = psa_call(TFM_ATTESTATION_SERVICE_HANDLE, TFM_ATTEST_GET_TOKEN_SIZE,
-                      in_vec, IOVEC_LEN(in_vec),
-                      out_vec, IOVEC_LEN(out_vec));
+    status = TFM_PSA_CALL_CONST(TFM_ATTESTATION_SERVICE_HANDLE,
+                                TFM_ATTEST_GET_TOKEN_SIZE, in_vec,
+                                IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
 
     return status;
 }
+
+psa_status_t
+tfm_initial_attest_get_tokens(const uint8_t *auth_challenges,
+                              size_t         challenge_size,
+                              size_t         num_challenges,
+                              uint8_t       *token_buf,
+                              size_t         token_buf_size,
+                              size_t        *token_sizes)
+{
+    psa_invec in_vec[] = {
+        {auth_challenges, challenge_size * num_challenges},
+        {&challenge_size, sizeof(challenge_size)}
+    };
+    psa_outvec out_vec[] = {
+        {token_buf, token_buf_size},
+        {token_sizes, num_challenges * sizeof(size_t)}
+    };
+
+    if ((challenge_size == 0) || (num_challenges == 0) ||
+        (num_challenges > SIZE_MAX / challenge_size) ||
+        (num_challenges > SIZE_MAX / sizeof(size_t))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return TFM_PSA_CALL_CONST(TFM_ATTESTATION_SERVICE_HANDLE,
+                              TFM_ATTEST_GET_TOKENS, in_vec, IOVEC_LEN(in_vec),
+                              out_vec, IOVEC_LEN(out_vec));
+}
+
+psa_status_t
+tfm_initial_attest_get_token_stats(struct tfm_attest_token_stats_t *stats)
+{
+    psa_outvec out_vec[] = {
+        {stats, sizeof(*stats)}
+    };
+
+    return TFM_PSA_CALL_CONST(TFM_ATTESTATION_SERVICE_HANDLE,
+                              TFM_ATTEST_GET_TOKEN_STATS, NULL, 0,
+                              out_vec, IOVEC_LEN(out_vec));
+}
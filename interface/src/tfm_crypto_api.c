@@ -9,15 +9,16 @@
 #include "psa/crypto.h"
 #include "psa/client.h"
 #include "psa_manifest/sid.h"
+#include "tfm_psa_call_pack.h"
 
-#define API_DISPATCH(in_vec, out_vec)          \
-    psa_call(TFM_CRYPTO_HANDLE, PSA_IPC_CALL,  \
-             in_vec, IOVEC_LEN(in_vec),        \
-             out_vec, IOVEC_LEN(out_vec))
-#define API_DISPATCH_NO_OUTVEC(in_vec)         \
-    psa_call(TFM_CRYPTO_HANDLE, PSA_IPC_CALL,  \
-             in_vec, IOVEC_LEN(in_vec),        \
-             (psa_outvec *)NULL, 0)
+#define API_DISPATCH(in_vec, out_vec)                    \
+    TFM_PSA_CALL_CONST(TFM_CRYPTO_HANDLE, PSA_IPC_CALL,  \
+                       in_vec, IOVEC_LEN(in_vec),        \
+                       out_vec, IOVEC_LEN(out_vec))
+#define API_DISPATCH_NO_OUTVEC(in_vec)                   \
+    TFM_PSA_CALL_CONST(TFM_CRYPTO_HANDLE, PSA_IPC_CALL,  \
+                       in_vec, IOVEC_LEN(in_vec),        \
+                       (psa_outvec *)NULL, 0)
 
 /*!
  * \def CONFIG_TFM_CRYPTO_API_RENAME
@@ -518,6 +519,31 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_clone)(const psa_hash_operation_t *source_
     return API_DISPATCH(in_vec, out_vec);
 }
 
+TFM_CRYPTO_API(psa_status_t, psa_hash_finish_copy)(const psa_hash_operation_t *operation,
+                                                   uint8_t *hash,
+                                                   size_t hash_size,
+                                                   size_t *hash_length)
+{
+    psa_status_t status;
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_HASH_FINISH_COPY_SID,
+        .op_handle = operation->handle,
+    };
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+    };
+    psa_outvec out_vec[] = {
+        {.base = hash, .len = hash_size},
+    };
+
+    status = API_DISPATCH(in_vec, out_vec);
+
+    *hash_length = out_vec[0].len;
+
+    return status;
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_hash_compute)(psa_algorithm_t alg,
                                                const uint8_t *input,
                                                size_t input_length,
@@ -547,6 +573,46 @@ TFM_CRYPTO_API(psa_status_t, psa_hash_compute)(psa_algorithm_t alg,
     return status;
 }
 
+TFM_CRYPTO_API(psa_status_t, psa_hash_compute_multi)(psa_algorithm_t alg,
+                                                     const uint8_t *const *inputs,
+                                                     const size_t *input_lengths,
+                                                     size_t input_count,
+                                                     uint8_t *hash,
+                                                     size_t hash_size,
+                                                     size_t *hash_length)
+{
+    psa_status_t status;
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_HASH_COMPUTE_MULTI_SID,
+        .alg = alg,
+    };
+    psa_invec in_vec[1 + PSA_HASH_COMPUTE_MULTI_MAX_INPUTS] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+    };
+    psa_outvec out_vec[] = {
+        {.base = hash, .len = hash_size}
+    };
+
+    if ((input_count == 0) ||
+        (input_count > PSA_HASH_COMPUTE_MULTI_MAX_INPUTS)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Each buffer is an input vector of its own, in the order to be hashed */
+    for (size_t i = 0; i < input_count; i++) {
+        in_vec[1 + i].base = inputs[i];
+        in_vec[1 + i].len = input_lengths[i];
+    }
+
+    status = psa_call(TFM_CRYPTO_HANDLE, PSA_IPC_CALL,
+                      in_vec, 1 + input_count,
+                      out_vec, IOVEC_LEN(out_vec));
+
+    *hash_length = out_vec[0].len;
+
+    return status;
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_hash_compare)(psa_algorithm_t alg,
                                                const uint8_t *input,
                                                size_t input_length,
@@ -1208,6 +1274,53 @@ TFM_CRYPTO_API(psa_status_t, psa_verify_hash)(psa_key_id_t key,
     return API_DISPATCH_NO_OUTVEC(in_vec);
 }
 
+TFM_CRYPTO_API(psa_status_t, psa_verify_hash_batch)(psa_key_id_t key,
+                                                    psa_algorithm_t alg,
+                                                    const uint8_t *hashes,
+                                                    size_t hash_length,
+                                                    const uint8_t *signatures,
+                                                    size_t signature_length,
+                                                    size_t count,
+                                                    psa_status_t *results)
+{
+    psa_status_t status;
+    struct tfm_crypto_pack_iovec iov = {
+        .function_id = TFM_CRYPTO_ASYMMETRIC_VERIFY_HASH_BATCH_SID,
+        .key_id = key,
+        .alg = alg
+    };
+
+    if ((count == 0) || (results == NULL) ||
+        (hash_length > SIZE_MAX / count) ||
+        (signature_length > SIZE_MAX / count) ||
+        (count > SIZE_MAX / sizeof(psa_status_t))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    psa_invec in_vec[] = {
+        {.base = &iov, .len = sizeof(struct tfm_crypto_pack_iovec)},
+        {.base = hashes, .len = hash_length * count},
+        {.base = signatures, .len = signature_length * count}
+    };
+    psa_outvec out_vec[] = {
+        {.base = results, .len = sizeof(psa_status_t) * count}
+    };
+
+    status = API_DISPATCH(in_vec, out_vec);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The service reports one status per pair, return the first failure */
+    for (size_t i = 0; i < count; i++) {
+        if (results[i] != PSA_SUCCESS) {
+            return results[i];
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
 TFM_CRYPTO_API(psa_status_t, psa_asymmetric_encrypt)(psa_key_id_t key,
                                                      psa_algorithm_t alg,
                                                      const uint8_t *input,
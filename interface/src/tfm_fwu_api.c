@@ -6,6 +6,7 @@
  */
 
 #include "psa/client.h"
+#include "tfm_psa_call_pack.h"
 #include "psa/update.h"
 #include "psa_manifest/sid.h"
 #include "tfm_api.h"
@@ -19,8 +20,8 @@ psa_status_t psa_fwu_start(psa_fwu_component_t component,
         { .base = manifest, .len = manifest_size }
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_START,
-                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_START,
+                              in_vec, IOVEC_LEN(in_vec), NULL, 0);
 }
 
 psa_status_t psa_fwu_write(psa_fwu_component_t component,
@@ -34,8 +35,8 @@ psa_status_t psa_fwu_write(psa_fwu_component_t component,
         { .base = block, .len = block_size }
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_WRITE,
-                      in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_WRITE,
+                              in_vec, IOVEC_LEN(in_vec), NULL, 0);
 }
 
 psa_status_t psa_fwu_finish(psa_fwu_component_t component)
@@ -44,14 +45,15 @@ psa_status_t psa_fwu_finish(psa_fwu_component_t component)
         { .base = &component, .len = sizeof(component) },
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_FINISH,
-                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_FINISH, in_vec, IOVEC_LEN(in_vec),
+                              NULL, 0);
 }
 
 psa_status_t psa_fwu_install(void)
 {
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_INSTALL,
-                    NULL, 0, NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_INSTALL, NULL, 0, NULL, 0);
 }
 
 psa_status_t psa_fwu_cancel(psa_fwu_component_t component)
@@ -60,8 +62,9 @@ psa_status_t psa_fwu_cancel(psa_fwu_component_t component)
         { .base = &component, .len = sizeof(component) },
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_CANCEL,
-                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_CANCEL, in_vec, IOVEC_LEN(in_vec),
+                              NULL, 0);
 }
 
 psa_status_t psa_fwu_clean(psa_fwu_component_t component)
@@ -70,8 +73,8 @@ psa_status_t psa_fwu_clean(psa_fwu_component_t component)
         { .base = &component, .len = sizeof(component) },
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_CLEAN,
-                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_CLEAN,
+                              in_vec, IOVEC_LEN(in_vec), NULL, 0);
 }
 
 psa_status_t psa_fwu_query(psa_fwu_component_t component,
@@ -84,20 +87,21 @@ psa_status_t psa_fwu_query(psa_fwu_component_t component,
         { .base = info, .len = sizeof(*info)}
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_QUERY,
-                    in_vec, IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_QUERY,
+                              in_vec, IOVEC_LEN(in_vec), out_vec,
+                              IOVEC_LEN(out_vec));
 }
 
 psa_status_t psa_fwu_request_reboot(void)
 {
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_REQUEST_REBOOT,
-                    NULL, 0, NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_REQUEST_REBOOT, NULL, 0, NULL, 0);
 }
 
 psa_status_t psa_fwu_accept(void)
 {
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_ACCEPT,
-                    NULL, 0, NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_ACCEPT, NULL, 0, NULL, 0);
 }
 
 psa_status_t psa_fwu_reject(psa_status_t error)
@@ -106,6 +110,18 @@ psa_status_t psa_fwu_reject(psa_status_t error)
         { .base = &error, .len = sizeof(error) }
     };
 
-    return psa_call(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE, TFM_FWU_REJECT,
-                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_REJECT, in_vec, IOVEC_LEN(in_vec),
+                              NULL, 0);
+}
+
+psa_status_t tfm_fwu_get_write_stats(struct tfm_fwu_write_stats_t *stats)
+{
+    psa_outvec out_vec[] = {
+        { .base = stats, .len = sizeof(*stats) }
+    };
+
+    return TFM_PSA_CALL_CONST(TFM_FIRMWARE_UPDATE_SERVICE_HANDLE,
+                              TFM_FWU_GET_WRITE_STATS, NULL, 0,
+                              out_vec, IOVEC_LEN(out_vec));
 }
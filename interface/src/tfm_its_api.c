@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include "psa/client.h"
+#include "tfm_psa_call_pack.h"
 #include "psa/internal_trusted_storage.h"
 #include "psa_manifest/sid.h"
 #include "tfm_api.h"
@@ -24,8 +25,9 @@ psa_status_t psa_its_set(psa_storage_uid_t uid,
         { .base = &create_flags, .len = sizeof(create_flags) }
     };
 
-    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE, TFM_ITS_SET,
-                      in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    status = TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                                TFM_ITS_SET, in_vec, IOVEC_LEN(in_vec),
+                                NULL, 0);
 
     return status;
 }
@@ -51,14 +53,52 @@ psa_status_t psa_its_get(psa_storage_uid_t uid,
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE, TFM_ITS_GET,
-                      in_vec, IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+    status = TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                                TFM_ITS_GET, in_vec, IOVEC_LEN(in_vec), out_vec,
+                                IOVEC_LEN(out_vec));
 
     *p_data_length = out_vec[0].len;
 
     return status;
 }
 
+psa_status_t psa_its_get_multi(psa_storage_uid_t uid,
+                               size_t data_offset,
+                               void *const *p_data,
+                               const size_t *data_sizes,
+                               size_t count,
+                               size_t *p_data_length)
+{
+    psa_status_t status;
+    psa_outvec out_vec[PSA_MAX_IOVEC];
+    size_t i;
+
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = &data_offset, .len = sizeof(data_offset) }
+    };
+
+    if ((p_data == NULL) || (data_sizes == NULL) || (p_data_length == NULL) ||
+        (count == 0) || (count > PSA_MAX_IOVEC)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; i++) {
+        out_vec[i].base = p_data[i];
+        out_vec[i].len = data_sizes[i];
+    }
+
+    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE, TFM_ITS_GET,
+                      in_vec, IOVEC_LEN(in_vec), out_vec, count);
+
+    *p_data_length = 0;
+    for (i = 0; i < count; i++) {
+        *p_data_length += out_vec[i].len;
+    }
+
+    return status;
+}
+
 psa_status_t psa_its_get_info(psa_storage_uid_t uid,
                               struct psa_storage_info_t *p_info)
 {
@@ -72,9 +112,9 @@ psa_status_t psa_its_get_info(psa_storage_uid_t uid,
         { .base = p_info, .len = sizeof(*p_info) }
     };
 
-    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
-                      TFM_ITS_GET_INFO, in_vec, IOVEC_LEN(in_vec), out_vec,
-                      IOVEC_LEN(out_vec));
+    status = TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                                TFM_ITS_GET_INFO, in_vec, IOVEC_LEN(in_vec),
+                                out_vec, IOVEC_LEN(out_vec));
 
     return status;
 }
@@ -87,8 +127,98 @@ psa_status_t psa_its_remove(psa_storage_uid_t uid)
         { .base = &uid, .len = sizeof(uid) }
     };
 
-    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
-                      TFM_ITS_REMOVE, in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    status = TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                                TFM_ITS_REMOVE, in_vec, IOVEC_LEN(in_vec),
+                                NULL, 0);
 
     return status;
 }
+
+psa_status_t psa_its_get_batch(const psa_storage_uid_t *uids,
+                               size_t count,
+                               size_t data_size,
+                               void *p_data,
+                               size_t *p_data_lengths,
+                               psa_status_t *results)
+{
+    psa_status_t status;
+
+    if ((count == 0) || (uids == NULL) || (p_data_lengths == NULL) ||
+        (results == NULL) ||
+        (count > SIZE_MAX / sizeof(psa_storage_uid_t)) ||
+        (count > SIZE_MAX / sizeof(size_t)) ||
+        (count > SIZE_MAX / sizeof(psa_status_t))) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    psa_invec in_vec[] = {
+        { .base = uids, .len = sizeof(psa_storage_uid_t) * count }
+    };
+
+    psa_outvec out_vec[] = {
+        { .base = p_data, .len = data_size },
+        { .base = results, .len = sizeof(psa_status_t) * count },
+        { .base = p_data_lengths, .len = sizeof(size_t) * count }
+    };
+
+    status = TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                                TFM_ITS_GET_BATCH, in_vec, IOVEC_LEN(in_vec),
+                                out_vec, IOVEC_LEN(out_vec));
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The service reports one status per UID, return the first failure */
+    for (size_t i = 0; i < count; i++) {
+        if (results[i] != PSA_SUCCESS) {
+            return results[i];
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_its_transaction_begin(void)
+{
+    return TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                              TFM_ITS_TRANSACTION_BEGIN, NULL, 0, NULL, 0);
+}
+
+psa_status_t psa_its_transaction_commit(void)
+{
+    return TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                              TFM_ITS_TRANSACTION_COMMIT, NULL, 0, NULL, 0);
+}
+
+psa_status_t psa_its_transaction_abort(void)
+{
+    return TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                              TFM_ITS_TRANSACTION_ABORT, NULL, 0, NULL, 0);
+}
+
+psa_status_t psa_its_get_flash_stats(uint32_t fs,
+                                     struct tfm_its_flash_stats_t *stats)
+{
+    psa_invec in_vec[] = {
+        { .base = &fs, .len = sizeof(fs) }
+    };
+    psa_outvec out_vec[] = {
+        { .base = stats, .len = sizeof(*stats) }
+    };
+
+    return TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                              TFM_ITS_GET_FLASH_STATS, in_vec,
+                              IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+}
+
+psa_status_t psa_its_get_read_cache_stats(
+                                    struct tfm_its_read_cache_stats_t *stats)
+{
+    psa_outvec out_vec[] = {
+        { .base = stats, .len = sizeof(*stats) }
+    };
+
+    return TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                              TFM_ITS_GET_READ_CACHE_STATS, NULL, 0,
+                              out_vec, IOVEC_LEN(out_vec));
+}
@@ -0,0 +1,637 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+#include "tfm_perf_api.h"
+#include "tfm_psa_call_pack.h"
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+#include "psa/internal_trusted_storage.h"
+#include "tfm_its_defs.h"
+#endif
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+#include "psa/protected_storage.h"
+#endif
+#ifdef TFM_PARTITION_CRYPTO
+#include "psa/crypto.h"
+#endif
+#ifdef TFM_PARTITION_INITIAL_ATTESTATION
+#include "psa/initial_attestation.h"
+#endif
+#ifdef TFM_PARTITION_PLATFORM
+#include "tfm_platform_api.h"
+#endif
+
+/* Size of the data of the storage, crypto and attestation benchmarks */
+#define TFM_PERF_DATA_SIZE      64
+
+/* UID of the asset written and read by the storage benchmarks */
+#define TFM_PERF_UID            0x5045524655494400ULL /* "PERFUID" */
+
+/* UID of the first asset kept by a storage pattern to set the fill level */
+#define TFM_PERF_FILL_UID       (TFM_PERF_UID + 0x10000)
+
+#define TFM_PERF_LINE_SIZE      256
+#define TFM_PERF_HEAD_SIZE      128
+
+/* Boot phase entries read at once through the Platform Service */
+#define TFM_PERF_BOOT_ENTRY_NUM 8
+
+struct tfm_perf_bench_t {
+    uint32_t id;
+    const char *name;
+    psa_status_t (*setup)(void);            /* Optional, not timed */
+    psa_status_t (*run)(void);              /* One timed iteration */
+    void (*teardown)(void);                 /* Optional, not timed */
+};
+
+static uint8_t perf_data[TFM_PERF_DATA_SIZE];
+static uint32_t perf_samples[TFM_PERF_ITERATIONS];
+
+psa_status_t tfm_perf_null_call(void)
+{
+    return TFM_PSA_CALL_CONST(TFM_PERF_SERVICE_HANDLE, TFM_PERF_NULL_CALL,
+                              NULL, 0, NULL, 0);
+}
+
+static psa_status_t tfm_perf_mark(int32_t type, uint32_t benchmark,
+                                  uint32_t iterations)
+{
+    struct tfm_perf_mark_t mark = {
+        .benchmark = benchmark,
+        .iterations = iterations,
+    };
+    psa_invec in_vec[] = {
+        { .base = &mark, .len = sizeof(mark) },
+    };
+
+    return psa_call(TFM_PERF_SERVICE_HANDLE, type,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+psa_status_t tfm_perf_begin(uint32_t benchmark, uint32_t iterations)
+{
+    return tfm_perf_mark(TFM_PERF_BEGIN, benchmark, iterations);
+}
+
+psa_status_t tfm_perf_end(uint32_t benchmark)
+{
+    return tfm_perf_mark(TFM_PERF_END, benchmark, 0);
+}
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+static psa_status_t perf_its_set(void)
+{
+    return psa_its_set(TFM_PERF_UID, sizeof(perf_data), perf_data,
+                       PSA_STORAGE_FLAG_NONE);
+}
+
+static psa_status_t perf_its_get(void)
+{
+    size_t len;
+
+    return psa_its_get(TFM_PERF_UID, 0, sizeof(perf_data), perf_data, &len);
+}
+
+static void perf_its_remove(void)
+{
+    (void)psa_its_remove(TFM_PERF_UID);
+}
+#endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+static psa_status_t perf_ps_set(void)
+{
+    return psa_ps_set(TFM_PERF_UID, sizeof(perf_data), perf_data,
+                      PSA_STORAGE_FLAG_NONE);
+}
+
+static psa_status_t perf_ps_get(void)
+{
+    size_t len;
+
+    return psa_ps_get(TFM_PERF_UID, 0, sizeof(perf_data), perf_data, &len);
+}
+
+static void perf_ps_remove(void)
+{
+    (void)psa_ps_remove(TFM_PERF_UID);
+}
+#endif /* TFM_PARTITION_PROTECTED_STORAGE */
+
+#ifdef TFM_PARTITION_CRYPTO
+static psa_key_id_t perf_key = PSA_KEY_ID_NULL;
+static uint8_t perf_crypto_out[TFM_PERF_DATA_SIZE + PSA_AEAD_TAG_MAX_SIZE];
+
+static psa_status_t perf_hash(void)
+{
+    size_t len;
+
+    return psa_hash_compute(PSA_ALG_SHA_256, perf_data, sizeof(perf_data),
+                            perf_crypto_out, sizeof(perf_crypto_out), &len);
+}
+
+static psa_status_t perf_aead_setup(void)
+{
+    static const uint8_t key[16] = {0};
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+
+    psa_set_key_type(&attr, PSA_KEY_TYPE_AES);
+    psa_set_key_bits(&attr, 128);
+    psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_ENCRYPT);
+    psa_set_key_algorithm(&attr, PSA_ALG_GCM);
+
+    return psa_import_key(&attr, key, sizeof(key), &perf_key);
+}
+
+static psa_status_t perf_aead(void)
+{
+    static const uint8_t nonce[12] = {0};
+    size_t len;
+
+    return psa_aead_encrypt(perf_key, PSA_ALG_GCM, nonce, sizeof(nonce),
+                            NULL, 0, perf_data, sizeof(perf_data),
+                            perf_crypto_out, sizeof(perf_crypto_out), &len);
+}
+
+static psa_status_t perf_sign_setup(void)
+{
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+
+    psa_set_key_type(&attr, PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1));
+    psa_set_key_bits(&attr, 256);
+    psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_SIGN_HASH);
+    psa_set_key_algorithm(&attr, PSA_ALG_ECDSA(PSA_ALG_SHA_256));
+
+    return psa_generate_key(&attr, &perf_key);
+}
+
+static psa_status_t perf_sign(void)
+{
+    size_t len;
+
+    /* The first 32 bytes of the data stand for a SHA-256 hash */
+    return psa_sign_hash(perf_key, PSA_ALG_ECDSA(PSA_ALG_SHA_256),
+                         perf_data, PSA_HASH_LENGTH(PSA_ALG_SHA_256),
+                         perf_crypto_out, sizeof(perf_crypto_out), &len);
+}
+
+static void perf_key_destroy(void)
+{
+    (void)psa_destroy_key(perf_key);
+    perf_key = PSA_KEY_ID_NULL;
+}
+#endif /* TFM_PARTITION_CRYPTO */
+
+#ifdef TFM_PARTITION_INITIAL_ATTESTATION
+static uint8_t perf_token[PSA_INITIAL_ATTEST_MAX_TOKEN_SIZE];
+
+static psa_status_t perf_attest_token(void)
+{
+    size_t len;
+
+    return psa_initial_attest_get_token(perf_data,
+                                        PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64,
+                                        perf_token, sizeof(perf_token), &len);
+}
+#endif /* TFM_PARTITION_INITIAL_ATTESTATION */
+
+static const struct tfm_perf_bench_t perf_benchmarks[] = {
+    {TFM_PERF_BENCH_NULL_CALL, "null_call", NULL, tfm_perf_null_call, NULL},
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    {TFM_PERF_BENCH_ITS_SET, "its_set", NULL, perf_its_set, NULL},
+    {TFM_PERF_BENCH_ITS_GET, "its_get", perf_its_set, perf_its_get,
+     perf_its_remove},
+#endif
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    {TFM_PERF_BENCH_PS_SET, "ps_set", NULL, perf_ps_set, NULL},
+    {TFM_PERF_BENCH_PS_GET, "ps_get", perf_ps_set, perf_ps_get,
+     perf_ps_remove},
+#endif
+#ifdef TFM_PARTITION_CRYPTO
+    {TFM_PERF_BENCH_HASH, "hash_sha256", NULL, perf_hash, NULL},
+    {TFM_PERF_BENCH_AEAD, "aead_aes128_gcm", perf_aead_setup, perf_aead,
+     perf_key_destroy},
+    {TFM_PERF_BENCH_SIGN, "sign_ecdsa_p256", perf_sign_setup, perf_sign,
+     perf_key_destroy},
+#endif
+#ifdef TFM_PARTITION_INITIAL_ATTESTATION
+    {TFM_PERF_BENCH_ATTEST_TOKEN, "attest_token", NULL, perf_attest_token,
+     NULL},
+#endif
+};
+
+static void perf_sort(uint32_t *samples, uint32_t num)
+{
+    uint32_t i, j;
+    uint32_t val;
+
+    for (i = 1; i < num; i++) {
+        val = samples[i];
+        for (j = i; (j > 0) && (samples[j - 1] > val); j--) {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = val;
+    }
+}
+
+/* Nearest-rank percentile of sorted samples */
+static uint32_t perf_percentile(const uint32_t *samples, uint32_t num,
+                                uint32_t percent)
+{
+    uint32_t rank = (num * percent + 99) / 100;
+
+    return samples[(rank > 0) ? (rank - 1) : 0];
+}
+
+/* Writes the statistics of the samples, after the fields in head */
+static void perf_output_samples(const struct tfm_perf_ns_ops_t *ops,
+                                const char *head, psa_status_t status,
+                                uint32_t num)
+{
+    char line[TFM_PERF_LINE_SIZE];
+    uint64_t total = 0;
+    uint32_t ops_per_s = 0;
+    uint32_t i;
+
+    if (num == 0) {
+        perf_samples[num++] = 0;
+    }
+
+    perf_sort(perf_samples, num);
+
+    for (i = 0; i < num; i++) {
+        total += perf_samples[i];
+    }
+    if ((total != 0) && (ops->clock_hz != 0)) {
+        ops_per_s = (uint32_t)(((uint64_t)num * ops->clock_hz) / total);
+    }
+
+    (void)snprintf(line, sizeof(line),
+                   "{%s, \"status\": %d, \"iterations\": %u, "
+                   "\"ops_per_s\": %u, \"min_cycles\": %u, "
+                   "\"p50_cycles\": %u, \"p99_cycles\": %u, "
+                   "\"max_cycles\": %u}",
+                   head, (int)status, (unsigned int)num,
+                   (unsigned int)ops_per_s,
+                   (unsigned int)perf_samples[0],
+                   (unsigned int)perf_percentile(perf_samples, num, 50),
+                   (unsigned int)perf_percentile(perf_samples, num, 99),
+                   (unsigned int)perf_samples[num - 1]);
+    ops->output(line);
+}
+
+static psa_status_t perf_run_bench(const struct tfm_perf_ns_ops_t *ops,
+                                   const struct tfm_perf_bench_t *bench)
+{
+    char head[TFM_PERF_HEAD_SIZE];
+    psa_status_t status = PSA_SUCCESS;
+    psa_status_t mark_status;
+    uint32_t num = 0;
+    uint32_t start;
+
+    if (bench->setup) {
+        status = bench->setup();
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = tfm_perf_begin(bench->id, TFM_PERF_ITERATIONS);
+    }
+
+    while ((status == PSA_SUCCESS) && (num < TFM_PERF_ITERATIONS)) {
+        start = ops->cycles();
+        status = bench->run();
+        perf_samples[num++] = ops->cycles() - start;
+    }
+
+    mark_status = tfm_perf_end(bench->id);
+    if (status == PSA_SUCCESS) {
+        status = mark_status;
+    }
+
+    if (bench->teardown) {
+        bench->teardown();
+    }
+
+    (void)snprintf(head, sizeof(head), "\"benchmark\": \"%s\"", bench->name);
+    perf_output_samples(ops, head, status, num);
+
+    return status;
+}
+
+#if defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE) || \
+    defined(TFM_PARTITION_PROTECTED_STORAGE)
+/* Operations timed by a storage pattern, in the order they run */
+enum perf_storage_op_t {
+    PERF_STORAGE_SET = 0,
+    PERF_STORAGE_GET,
+    PERF_STORAGE_REMOVE,
+    PERF_STORAGE_OP_NUM,
+};
+
+static uint8_t perf_asset[TFM_PERF_STORAGE_MAX_SIZE];
+
+static psa_status_t perf_storage_set(uint32_t storage, psa_storage_uid_t uid,
+                                     size_t size)
+{
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    if (storage == TFM_PERF_STORAGE_ITS) {
+        return psa_its_set(uid, size, perf_asset, PSA_STORAGE_FLAG_NONE);
+    }
+#endif
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (storage == TFM_PERF_STORAGE_PS) {
+        return psa_ps_set(uid, size, perf_asset, PSA_STORAGE_FLAG_NONE);
+    }
+#endif
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+
+static psa_status_t perf_storage_get(uint32_t storage, psa_storage_uid_t uid,
+                                     size_t size)
+{
+    size_t len;
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    if (storage == TFM_PERF_STORAGE_ITS) {
+        return psa_its_get(uid, 0, size, perf_asset, &len);
+    }
+#endif
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (storage == TFM_PERF_STORAGE_PS) {
+        return psa_ps_get(uid, 0, size, perf_asset, &len);
+    }
+#endif
+    (void)len;
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+
+static psa_status_t perf_storage_remove(uint32_t storage,
+                                        psa_storage_uid_t uid)
+{
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    if (storage == TFM_PERF_STORAGE_ITS) {
+        return psa_its_remove(uid);
+    }
+#endif
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (storage == TFM_PERF_STORAGE_PS) {
+        return psa_ps_remove(uid);
+    }
+#endif
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+
+static psa_status_t perf_storage_op(const struct tfm_perf_ns_ops_t *ops,
+                                    const struct tfm_perf_storage_pattern_t *p,
+                                    enum perf_storage_op_t op)
+{
+    static const char *const op_names[PERF_STORAGE_OP_NUM] = {
+        "set", "get", "remove",
+    };
+    char head[TFM_PERF_HEAD_SIZE];
+    psa_status_t status = PSA_SUCCESS;
+    psa_storage_uid_t uid;
+    uint32_t num = 0;
+    uint32_t start;
+
+    while ((status == PSA_SUCCESS) && (num < p->asset_count)) {
+        uid = TFM_PERF_UID + num;
+        start = ops->cycles();
+        if (op == PERF_STORAGE_SET) {
+            status = perf_storage_set(p->storage, uid, p->asset_size);
+        } else if (op == PERF_STORAGE_GET) {
+            status = perf_storage_get(p->storage, uid, p->asset_size);
+        } else {
+            status = perf_storage_remove(p->storage, uid);
+        }
+        perf_samples[num++] = ops->cycles() - start;
+    }
+
+    (void)snprintf(head, sizeof(head),
+                   "\"storage\": \"%s\", \"op\": \"%s\", "
+                   "\"asset_size\": %u, \"fill_count\": %u",
+                   (p->storage == TFM_PERF_STORAGE_ITS) ? "its" : "ps",
+                   op_names[op], (unsigned int)p->asset_size,
+                   (unsigned int)p->fill_count);
+    perf_output_samples(ops, head, status, num);
+
+    return status;
+}
+
+psa_status_t tfm_perf_storage_run(const struct tfm_perf_ns_ops_t *ops,
+                                  const struct tfm_perf_storage_pattern_t *p)
+{
+    psa_status_t ret = PSA_SUCCESS;
+    uint32_t i;
+
+    if (!ops || !ops->cycles || !ops->output || !p ||
+        (p->asset_size > TFM_PERF_STORAGE_MAX_SIZE) ||
+        (p->asset_count > TFM_PERF_ITERATIONS)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    (void)memset(perf_asset, 0x5A, sizeof(perf_asset));
+
+    /* The fill assets are kept during the run, they set the fill level */
+    for (i = 0; (ret == PSA_SUCCESS) && (i < p->fill_count); i++) {
+        ret = perf_storage_set(p->storage, TFM_PERF_FILL_UID + i,
+                               p->asset_size);
+    }
+
+    for (i = 0; (ret == PSA_SUCCESS) && (i < PERF_STORAGE_OP_NUM); i++) {
+        ret = perf_storage_op(ops, p, (enum perf_storage_op_t)i);
+    }
+
+    for (i = 0; i < p->fill_count; i++) {
+        (void)perf_storage_remove(p->storage, TFM_PERF_FILL_UID + i);
+    }
+
+    return ret;
+}
+#endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE || TFM_PARTITION_PROTECTED_STORAGE */
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+psa_status_t tfm_perf_its_fault_arm(uint32_t point, uint32_t count)
+{
+    struct tfm_its_fault_arm_t arm = {
+        .point = point,
+        .count = count,
+    };
+    psa_invec in_vec[] = {
+        { .base = &arm, .len = sizeof(arm) },
+    };
+
+    return TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                              TFM_ITS_FAULT_ARM,
+                              in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+/* Upper bound of the latency bucket that holds the percentile */
+static uint32_t perf_bucket_percentile(const struct tfm_its_fault_op_stats_t *s,
+                                       uint32_t percent)
+{
+    uint32_t rank = (s->ops * percent + 99) / 100;
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < TFM_ITS_FAULT_BUCKETS - 1; i++) {
+        sum += s->buckets[i];
+        if (sum >= rank) {
+            break;
+        }
+    }
+
+    if ((i == TFM_ITS_FAULT_BUCKETS - 1) || ((2UL << i) - 1 > s->max_cycles)) {
+        return s->max_cycles;
+    }
+
+    return (2UL << i) - 1;
+}
+
+psa_status_t tfm_perf_its_fault_report(const struct tfm_perf_ns_ops_t *ops)
+{
+    static const char *const op_names[TFM_ITS_FAULT_OP_NUM] = {
+        "set", "get", "remove",
+    };
+    static struct tfm_its_fault_stats_t stats;
+    char line[TFM_PERF_LINE_SIZE];
+    const struct tfm_its_fault_op_stats_t *s;
+    psa_status_t status;
+    uint32_t i;
+    psa_outvec out_vec[] = {
+        { .base = &stats, .len = sizeof(stats) },
+    };
+
+    if (!ops || !ops->output) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    status = TFM_PSA_CALL_CONST(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                                TFM_ITS_FAULT_GET_STATS,
+                                NULL, 0, out_vec, IOVEC_LEN(out_vec));
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    (void)snprintf(line, sizeof(line),
+                   "{\"its_mount_cycles\": %u, \"its_fault_points\": %u}",
+                   (unsigned int)stats.mount_cycles,
+                   (unsigned int)stats.points);
+    ops->output(line);
+
+    for (i = 0; i < TFM_ITS_FAULT_OP_NUM; i++) {
+        s = &stats.op[i];
+        (void)snprintf(line, sizeof(line),
+                       "{\"its_op\": \"%s\", \"ops\": %u, "
+                       "\"failures\": %u, \"mean_cycles\": %u, "
+                       "\"p50_cycles\": %u, \"p99_cycles\": %u, "
+                       "\"max_cycles\": %u}",
+                       op_names[i], (unsigned int)s->ops,
+                       (unsigned int)s->failures,
+                       (unsigned int)((s->ops != 0) ? s->cycles / s->ops : 0),
+                       (unsigned int)perf_bucket_percentile(s, 50),
+                       (unsigned int)perf_bucket_percentile(s, 99),
+                       (unsigned int)s->max_cycles);
+        ops->output(line);
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* TFM_PARTITION_INTERNAL_TRUSTED_STORAGE */
+
+#ifdef TFM_PARTITION_PLATFORM
+/* Layout of struct boot_timing_entry of tfm_boot_status.h */
+struct perf_boot_entry_t {
+    uint8_t  phase;
+    uint8_t  index;
+    uint16_t reserved;
+    uint32_t timestamp;
+    uint32_t id;
+};
+
+static void perf_report_boot_phases(const struct tfm_perf_ns_ops_t *ops)
+{
+    char line[TFM_PERF_LINE_SIZE];
+    struct perf_boot_entry_t entries[TFM_PERF_BOOT_ENTRY_NUM];
+    uint32_t first = 0;
+    uint32_t idx = 0;
+    size_t i, num;
+    psa_invec in_vec = { .base = &idx, .len = sizeof(idx) };
+    psa_outvec out_vec;
+
+    do {
+        out_vec.base = entries;
+        out_vec.len = sizeof(entries);
+
+        /* Not supported without TFM_BOOT_TIMING */
+        if (tfm_platform_ioctl(TFM_PLATFORM_IOCTL_BOOT_TIMING, &in_vec,
+                               &out_vec) != TFM_PLATFORM_ERR_SUCCESS) {
+            return;
+        }
+
+        num = out_vec.len / sizeof(entries[0]);
+        for (i = 0; i < num; i++) {
+            if (idx == 0 && i == 0) {
+                first = entries[0].timestamp;
+            }
+
+            (void)snprintf(line, sizeof(line),
+                           "{\"boot_phase\": %u, \"index\": %u, "
+                           "\"id\": %u, \"cycles\": %u}",
+                           (unsigned int)entries[i].phase,
+                           (unsigned int)entries[i].index,
+                           (unsigned int)entries[i].id,
+                           (unsigned int)(entries[i].timestamp - first));
+            ops->output(line);
+        }
+
+        idx += num;
+    } while (num == TFM_PERF_BOOT_ENTRY_NUM);
+}
+#endif /* TFM_PARTITION_PLATFORM */
+
+psa_status_t tfm_perf_run(const struct tfm_perf_ns_ops_t *ops)
+{
+    psa_status_t ret = PSA_SUCCESS;
+    psa_status_t status;
+    size_t i;
+
+    if (!ops || !ops->cycles || !ops->output) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    (void)memset(perf_data, 0x5A, sizeof(perf_data));
+
+#ifdef TFM_PARTITION_CRYPTO
+    ret = psa_crypto_init();
+#endif
+
+    for (i = 0; i < sizeof(perf_benchmarks) / sizeof(perf_benchmarks[0]);
+         i++) {
+        status = perf_run_bench(ops, &perf_benchmarks[i]);
+        if (ret == PSA_SUCCESS) {
+            ret = status;
+        }
+    }
+
+#ifdef TFM_PARTITION_PLATFORM
+    perf_report_boot_phases(ops);
+#endif
+
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    /* Not supported without ITS_FS_FAULT_INJECTION */
+    (void)tfm_perf_its_fault_report(ops);
+#endif
+
+    return ret;
+}
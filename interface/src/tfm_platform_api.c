@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,14 +8,15 @@
 #include <stdbool.h>
 #include "tfm_platform_api.h"
 #include "psa_manifest/sid.h"
+#include "tfm_psa_call_pack.h"
 
 enum tfm_platform_err_t tfm_platform_system_reset(void)
 {
     psa_status_t status = PSA_ERROR_CONNECTION_REFUSED;
 
-    status = psa_call(TFM_PLATFORM_SERVICE_HANDLE,
-                      TFM_PLATFORM_API_ID_SYSTEM_RESET,
-                      NULL, 0, NULL, 0);
+    status = TFM_PSA_CALL_CONST(TFM_PLATFORM_SERVICE_HANDLE,
+                                TFM_PLATFORM_API_ID_SYSTEM_RESET, NULL, 0,
+                                NULL, 0);
 
     if (status < PSA_SUCCESS) {
         return TFM_PLATFORM_ERR_SYSTEM_ERROR;
@@ -71,9 +72,9 @@ tfm_platform_nv_counter_increment(uint32_t counter_id)
     in_vec[0].base = &counter_id;
     in_vec[0].len = sizeof(counter_id);
 
-    status = psa_call(TFM_PLATFORM_SERVICE_HANDLE,
-                      TFM_PLATFORM_API_ID_NV_INCREMENT,
-                      in_vec, 1, (psa_outvec *)NULL, 0);
+    status = TFM_PSA_CALL_CONST(TFM_PLATFORM_SERVICE_HANDLE,
+                                TFM_PLATFORM_API_ID_NV_INCREMENT, in_vec, 1,
+                                (psa_outvec *)NULL, 0);
 
     if (status < PSA_SUCCESS) {
         return TFM_PLATFORM_ERR_SYSTEM_ERROR;
@@ -96,9 +97,55 @@ tfm_platform_nv_counter_read(uint32_t counter_id,
     out_vec[0].base = val;
     out_vec[0].len = size;
 
-    status = psa_call(TFM_PLATFORM_SERVICE_HANDLE,
-                      TFM_PLATFORM_API_ID_NV_READ,
-                      in_vec, 1, out_vec, 1);
+    status = TFM_PSA_CALL_CONST(TFM_PLATFORM_SERVICE_HANDLE,
+                                TFM_PLATFORM_API_ID_NV_READ, in_vec, 1,
+                                out_vec, 1);
+
+    if (status < PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    } else {
+        return (enum tfm_platform_err_t)status;
+    }
+}
+
+enum tfm_platform_err_t
+tfm_platform_nv_counter_read_batch(const uint32_t *counter_ids,
+                                   uint32_t num_counters, uint32_t *vals)
+{
+    psa_status_t status = PSA_ERROR_CONNECTION_REFUSED;
+    struct psa_invec in_vec[1];
+    struct psa_outvec out_vec[1];
+
+    in_vec[0].base = counter_ids;
+    in_vec[0].len = num_counters * sizeof(uint32_t);
+
+    out_vec[0].base = vals;
+    out_vec[0].len = num_counters * sizeof(uint32_t);
+
+    status = TFM_PSA_CALL_CONST(TFM_PLATFORM_SERVICE_HANDLE,
+                                TFM_PLATFORM_API_ID_NV_READ_BATCH, in_vec, 1,
+                                out_vec, 1);
+
+    if (status < PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    } else {
+        return (enum tfm_platform_err_t)status;
+    }
+}
+
+enum tfm_platform_err_t
+tfm_platform_nv_counter_increment_batch(const uint32_t *counter_ids,
+                                        uint32_t num_counters)
+{
+    psa_status_t status = PSA_ERROR_CONNECTION_REFUSED;
+    struct psa_invec in_vec[1];
+
+    in_vec[0].base = counter_ids;
+    in_vec[0].len = num_counters * sizeof(uint32_t);
+
+    status = TFM_PSA_CALL_CONST(TFM_PLATFORM_SERVICE_HANDLE,
+                                TFM_PLATFORM_API_ID_NV_INCREMENT_BATCH,
+                                in_vec, 1, (psa_outvec *)NULL, 0);
 
     if (status < PSA_SUCCESS) {
         return TFM_PLATFORM_ERR_SYSTEM_ERROR;
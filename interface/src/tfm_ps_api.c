@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2017-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include "psa/client.h"
+#include "tfm_psa_call_pack.h"
 #include "psa/protected_storage.h"
 #include "psa_manifest/sid.h"
 #include "tfm_ps_defs.h"
@@ -23,8 +24,8 @@ psa_status_t psa_ps_set(psa_storage_uid_t uid,
         { .base = &create_flags, .len = sizeof(create_flags) }
     };
 
-    status = psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_SET, in_vec,
-                      IOVEC_LEN(in_vec), NULL, 0);
+    status = TFM_PSA_CALL_CONST(TFM_PROTECTED_STORAGE_SERVICE_HANDLE,
+                                TFM_PS_SET, in_vec, IOVEC_LEN(in_vec), NULL, 0);
 
     return status;
 }
@@ -50,14 +51,52 @@ psa_status_t psa_ps_get(psa_storage_uid_t uid,
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    status = psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_GET, in_vec,
-                      IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+    status = TFM_PSA_CALL_CONST(TFM_PROTECTED_STORAGE_SERVICE_HANDLE,
+                                TFM_PS_GET, in_vec, IOVEC_LEN(in_vec), out_vec,
+                                IOVEC_LEN(out_vec));
 
     *p_data_length = out_vec[0].len;
 
     return status;
 }
 
+psa_status_t psa_ps_get_multi(psa_storage_uid_t uid,
+                              size_t data_offset,
+                              void *const *p_data,
+                              const size_t *data_sizes,
+                              size_t count,
+                              size_t *p_data_length)
+{
+    psa_status_t status;
+    psa_outvec out_vec[PSA_MAX_IOVEC];
+    size_t i;
+
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = &data_offset, .len = sizeof(data_offset) }
+    };
+
+    if ((p_data == NULL) || (data_sizes == NULL) || (p_data_length == NULL) ||
+        (count == 0) || (count > PSA_MAX_IOVEC)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; i++) {
+        out_vec[i].base = p_data[i];
+        out_vec[i].len = data_sizes[i];
+    }
+
+    status = psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_GET,
+                      in_vec, IOVEC_LEN(in_vec), out_vec, count);
+
+    *p_data_length = 0;
+    for (i = 0; i < count; i++) {
+        *p_data_length += out_vec[i].len;
+    }
+
+    return status;
+}
+
 psa_status_t psa_ps_get_info(psa_storage_uid_t uid,
                              struct psa_storage_info_t *p_info)
 {
@@ -71,8 +110,9 @@ psa_status_t psa_ps_get_info(psa_storage_uid_t uid,
         { .base = p_info, .len = sizeof(*p_info) }
     };
 
-    status = psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_GET_INFO,
-                      in_vec, IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+    status = TFM_PSA_CALL_CONST(TFM_PROTECTED_STORAGE_SERVICE_HANDLE,
+                                TFM_PS_GET_INFO, in_vec, IOVEC_LEN(in_vec),
+                                out_vec, IOVEC_LEN(out_vec));
 
     return status;
 }
@@ -85,8 +125,9 @@ psa_status_t psa_ps_remove(psa_storage_uid_t uid)
         { .base = &uid, .len = sizeof(uid) }
     };
 
-    status = psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_REMOVE,
-                      in_vec, IOVEC_LEN(in_vec), NULL, 0);
+    status = TFM_PSA_CALL_CONST(TFM_PROTECTED_STORAGE_SERVICE_HANDLE,
+                                TFM_PS_REMOVE, in_vec, IOVEC_LEN(in_vec),
+                                NULL, 0);
 
     return status;
 }
@@ -126,8 +167,15 @@ uint32_t psa_ps_get_support(void)
     /* The PSA API does not return an error, so any error from TF-M is
      * ignored.
      */
-    (void)psa_call(TFM_PROTECTED_STORAGE_SERVICE_HANDLE, TFM_PS_GET_SUPPORT,
-                   NULL, 0, out_vec, IOVEC_LEN(out_vec));
+    (void)TFM_PSA_CALL_CONST(TFM_PROTECTED_STORAGE_SERVICE_HANDLE,
+                             TFM_PS_GET_SUPPORT, NULL, 0, out_vec,
+                             IOVEC_LEN(out_vec));
 
     return support_flags;
 }
+
+psa_status_t tfm_ps_flush_writes(void)
+{
+    return TFM_PSA_CALL_CONST(TFM_PROTECTED_STORAGE_SERVICE_HANDLE,
+                              TFM_PS_FLUSH, NULL, 0, NULL, 0);
+}
@@ -1,35 +1,128 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include <stdbool.h>
+
 #include "psa/client.h"
 #include "tfm_ns_interface.h"
 #include "tfm_api.h"
 #include "tfm_psa_call_pack.h"
+#include "tfm_psa_call_batch.h"
+#include "tfm_psa_call_async.h"
+
+/*
+ * The framework version and the versions of the RoT Services do not change
+ * after boot, so the first answer is kept and the later calls do not enter
+ * the SPE. TFM_NS_PSA_VERSION_CACHE_SIZE is the number of RoT Services whose
+ * version is kept, 0 disables the cache.
+ */
+#ifndef TFM_NS_PSA_VERSION_CACHE_SIZE
+#define TFM_NS_PSA_VERSION_CACHE_SIZE   8
+#endif
+
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+static volatile uint32_t framework_version = PSA_VERSION_NONE;
+
+/*
+ * Entries are only added, under the NS interface lock, and an entry is
+ * complete before it is counted. Lookups are done without the lock.
+ */
+static volatile struct {
+    uint32_t sid;
+    uint32_t version;
+} version_cache[TFM_NS_PSA_VERSION_CACHE_SIZE];
+static volatile uint32_t version_cache_count;
+
+static bool version_cache_lookup(uint32_t sid, uint32_t *version)
+{
+    uint32_t count = version_cache_count;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (version_cache[i].sid == sid) {
+            *version = version_cache[i].version;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Called through the NS interface dispatcher, and so under its lock */
+static int32_t version_cache_fill(uint32_t sid, uint32_t arg1,
+                                  uint32_t arg2, uint32_t arg3)
+{
+    uint32_t count = version_cache_count;
+    uint32_t version;
+
+    (void)arg1;
+    (void)arg2;
+    (void)arg3;
+
+    /* Another thread may have added it while this one waited for the lock */
+    if (version_cache_lookup(sid, &version)) {
+        return (int32_t)version;
+    }
+
+    version = tfm_psa_version_veneer(sid);
+
+    if (count < TFM_NS_PSA_VERSION_CACHE_SIZE) {
+        version_cache[count].sid = sid;
+        version_cache[count].version = version;
+        version_cache_count = count + 1;
+    }
+
+    return (int32_t)version;
+}
+#endif /* TFM_NS_PSA_VERSION_CACHE_SIZE > 0 */
 
 /**** API functions ****/
 
 uint32_t psa_framework_version(void)
 {
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+    if (framework_version == PSA_VERSION_NONE) {
+        framework_version = tfm_ns_interface_dispatch(
+                                (veneer_fn)tfm_psa_framework_version_veneer,
+                                0,
+                                0,
+                                0,
+                                0);
+    }
+
+    return framework_version;
+#else
     return tfm_ns_interface_dispatch(
                                 (veneer_fn)tfm_psa_framework_version_veneer,
                                 0,
                                 0,
                                 0,
                                 0);
+#endif
 }
 
 uint32_t psa_version(uint32_t sid)
 {
+#if TFM_NS_PSA_VERSION_CACHE_SIZE > 0
+    uint32_t version;
+
+    if (version_cache_lookup(sid, &version)) {
+        return version;
+    }
+
+    return tfm_ns_interface_dispatch(version_cache_fill, sid, 0, 0, 0);
+#else
     return tfm_ns_interface_dispatch(
                                 (veneer_fn)tfm_psa_version_veneer,
                                 sid,
                                 0,
                                 0,
                                 0);
+#endif
 }
 
 psa_status_t psa_call(psa_handle_t handle, int32_t type,
@@ -45,14 +138,81 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type,
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
+    return tfm_psa_call_pack(handle, PARAM_PACK(type, in_len, out_len),
+                             in_vec, out_vec);
+}
+
+psa_status_t tfm_psa_call_pack(psa_handle_t handle,
+                               uint32_t ctrl_param,
+                               const psa_invec *in_vec,
+                               psa_outvec *out_vec)
+{
     return tfm_ns_interface_dispatch(
                                 (veneer_fn)tfm_psa_call_veneer,
                                 (uint32_t)handle,
-                                PARAM_PACK(type, in_len, out_len),
+                                ctrl_param,
                                 (uint32_t)in_vec,
                                 (uint32_t)out_vec);
 }
 
+psa_status_t psa_call_batch(const struct psa_call_batch_item_t *items,
+                            psa_status_t *statuses,
+                            size_t num)
+{
+    if ((num == 0) || (num > PSA_CALL_BATCH_MAX_NUM)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_ns_interface_dispatch(
+                                (veneer_fn)tfm_psa_call_batch_veneer,
+                                (uint32_t)items,
+                                (uint32_t)statuses,
+                                (uint32_t)num,
+                                0);
+}
+
+/*
+ * Synchronous fallback of the asynchronous calls. The NSPE and the SPE share
+ * the core, so the call runs to completion before psa_call_async() returns,
+ * and the token carries the status itself, tagged with the MSB.
+ */
+#define ASYNC_TOKEN_TAG                 (1UL << 31)
+
+psa_status_t psa_call_async(psa_handle_t handle, int32_t type,
+                            const psa_invec *in_vec, size_t in_len,
+                            psa_outvec *out_vec, size_t out_len,
+                            psa_call_token_t *token)
+{
+    psa_status_t status;
+
+    if (!token) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    status = psa_call(handle, type, in_vec, in_len, out_vec, out_len);
+
+    *token = ASYNC_TOKEN_TAG | ((uint32_t)status & ~ASYNC_TOKEN_TAG);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_call_async_poll(psa_call_token_t token, psa_status_t *status)
+{
+    if (!(token & ASYNC_TOKEN_TAG) || !status) {
+        return PSA_ERROR_INVALID_HANDLE;
+    }
+
+    /* Sign-extend the status from the remaining 31 bits. */
+    *status = (psa_status_t)(token << 1) >> 1;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t psa_call_async_wait(psa_call_token_t token, psa_status_t *status)
+{
+    return psa_call_async_poll(token, status);
+}
+
 psa_handle_t psa_connect(uint32_t sid, uint32_t version)
 {
     return tfm_ns_interface_dispatch((veneer_fn)tfm_psa_connect_veneer, sid, version, 0, 0);
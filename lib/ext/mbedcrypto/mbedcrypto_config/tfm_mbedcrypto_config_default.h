@@ -148,6 +148,16 @@
  */
 #define MBEDTLS_ECP_NIST_OPTIM
 
+/**
+ * \def MBEDTLS_ECP_RESTARTABLE
+ *
+ * Enable the interruptible ECC operations, used by the crypto service to sign
+ * hashes in steps of CRYPTO_SIGN_HASH_MAX_OPS operations.
+ */
+#if CRYPTO_SIGN_HASH_MAX_OPS > 0
+#define MBEDTLS_ECP_RESTARTABLE
+#endif
+
 /**
  * \def MBEDTLS_PK_PARSE_EC_EXTENDED
  *
@@ -529,7 +539,10 @@
  */
 
 /* ECP options */
-#define MBEDTLS_ECP_FIXED_POINT_OPTIM        0 /**< Disable fixed-point speed-up */
+#define MBEDTLS_ECP_FIXED_POINT_OPTIM        CRYPTO_ECP_FIXED_POINT_OPTIM /**< Fixed-point speed-up */
+
+/* PSA key slot options */
+#define MBEDTLS_PSA_KEY_SLOT_COUNT           CRYPTO_KEY_SLOT_COUNT /**< Keys held in RAM */
 
 /* \} name SECTION: Customisation configuration options */
 
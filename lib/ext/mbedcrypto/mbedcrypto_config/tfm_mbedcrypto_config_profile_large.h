@@ -136,7 +136,9 @@
  * This option is independent of \c MBEDTLS_AES_ROM_TABLES.
  *
  */
+#if !CRYPTO_SW_SPEED_OPTIM
 #define MBEDTLS_AES_FEWER_TABLES
+#endif
 
 /**
  * \def MBEDTLS_ECP_NIST_OPTIM
@@ -149,6 +151,16 @@
  */
 #define MBEDTLS_ECP_NIST_OPTIM
 
+/**
+ * \def MBEDTLS_ECP_RESTARTABLE
+ *
+ * Enable the interruptible ECC operations, used by the crypto service to sign
+ * hashes in steps of CRYPTO_SIGN_HASH_MAX_OPS operations.
+ */
+#if CRYPTO_SIGN_HASH_MAX_OPS > 0
+#define MBEDTLS_ECP_RESTARTABLE
+#endif
+
 /**
  * \def MBEDTLS_PK_PARSE_EC_EXTENDED
  *
@@ -530,7 +542,10 @@
  */
 
 /* ECP options */
-#define MBEDTLS_ECP_FIXED_POINT_OPTIM        0 /**< Disable fixed-point speed-up */
+#define MBEDTLS_ECP_FIXED_POINT_OPTIM        CRYPTO_ECP_FIXED_POINT_OPTIM /**< Fixed-point speed-up */
+
+/* PSA key slot options */
+#define MBEDTLS_PSA_KEY_SLOT_COUNT           CRYPTO_KEY_SLOT_COUNT /**< Keys held in RAM */
 
 /* \} name SECTION: Customisation configuration options */
 
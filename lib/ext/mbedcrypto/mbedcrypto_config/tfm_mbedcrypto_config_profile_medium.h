@@ -174,7 +174,9 @@
  * This option is independent of \c MBEDTLS_AES_ROM_TABLES.
  *
  */
+#if !CRYPTO_SW_SPEED_OPTIM
 #define MBEDTLS_AES_FEWER_TABLES
+#endif
 
 /**
  * \def MBEDTLS_ECP_NIST_OPTIM
@@ -187,6 +189,16 @@
  */
 #define MBEDTLS_ECP_NIST_OPTIM
 
+/**
+ * \def MBEDTLS_ECP_RESTARTABLE
+ *
+ * Enable the interruptible ECC operations, used by the crypto service to sign
+ * hashes in steps of CRYPTO_SIGN_HASH_MAX_OPS operations.
+ */
+#if CRYPTO_SIGN_HASH_MAX_OPS > 0
+#define MBEDTLS_ECP_RESTARTABLE
+#endif
+
 /**
  * \def MBEDTLS_ERROR_STRERROR_DUMMY
  *
@@ -269,7 +281,9 @@
  *
  * Uncomment to enable the smaller implementation of SHA256.
  */
+#if !CRYPTO_SW_SPEED_OPTIM
 #define MBEDTLS_SHA256_SMALLER
+#endif
 
 /**
  * \def MBEDTLS_PSA_CRYPTO_CONFIG
@@ -600,7 +614,10 @@
  */
 
 /* ECP options */
-#define MBEDTLS_ECP_FIXED_POINT_OPTIM        0 /**< Disable fixed-point speed-up */
+#define MBEDTLS_ECP_FIXED_POINT_OPTIM        CRYPTO_ECP_FIXED_POINT_OPTIM /**< Fixed-point speed-up */
+
+/* PSA key slot options */
+#define MBEDTLS_PSA_KEY_SLOT_COUNT           CRYPTO_KEY_SLOT_COUNT /**< Keys held in RAM */
 
 /* \} name SECTION: Customisation configuration options */
 
@@ -174,7 +174,9 @@
  * This option is independent of \c MBEDTLS_AES_ROM_TABLES.
  *
  */
+#if !CRYPTO_SW_SPEED_OPTIM
 #define MBEDTLS_AES_FEWER_TABLES
+#endif
 
 /**
  * \def MBEDTLS_ERROR_STRERROR_DUMMY
@@ -258,7 +260,9 @@
  *
  * Uncomment to enable the smaller implementation of SHA256.
  */
+#if !CRYPTO_SW_SPEED_OPTIM
 #define MBEDTLS_SHA256_SMALLER
+#endif
 
 /**
  * \def MBEDTLS_PSA_CRYPTO_CONFIG
@@ -546,6 +550,9 @@
 
 /** \} name SECTION: General configuration options */
 
+/* PSA key slot options */
+#define MBEDTLS_PSA_KEY_SLOT_COUNT           CRYPTO_KEY_SLOT_COUNT /**< Keys held in RAM */
+
 #if CRYPTO_NV_SEED
 #include "tfm_mbedcrypto_config_extra_nv_seed.h"
 #endif /* CRYPTO_NV_SEED */
@@ -68,6 +68,7 @@ extern "C" {
 #undef FIH_ENABLE_CFI
 #undef FIH_ENABLE_DOUBLE_VARS
 #undef FIH_ENABLE_DELAY
+#undef FIH_MODULE_NO_DELAY
 
 #ifdef TFM_FIH_PROFILE_ON
 #if defined(TFM_FIH_PROFILE_LOW)
@@ -89,6 +90,23 @@ extern "C" {
 #error "Invalid FIH Profile configuration"
 #endif /* TFM_FIH_PROFILE */
 
+/*
+ * A module of a HIGH profile image can run with the MEDIUM profile, such as
+ * the runtime path of the SPM with TFM_FIH_PROFILE_RUNTIME, by building its
+ * sources with TFM_FIH_MODULE_PROFILE_MEDIUM. The fih_int type and the CFI
+ * counter are shared by all the modules, so the module profile only drops the
+ * measure local to its code, the random delays. A lower module profile would
+ * give the same code, so it is rejected.
+ */
+#if defined(TFM_FIH_MODULE_PROFILE_OFF) || defined(TFM_FIH_MODULE_PROFILE_LOW)
+#error "A module can only lower the FIH profile to MEDIUM"
+#endif
+
+#if defined(TFM_FIH_MODULE_PROFILE_MEDIUM) && defined(FIH_ENABLE_DELAY)
+#define FIH_MODULE_NO_DELAY
+#undef FIH_ENABLE_DELAY
+#endif
+
 #define FIH_TRUE              0xC35A
 #define FIH_FALSE             0x0
 
@@ -383,8 +401,19 @@ void fih_cfi_decrement(void);
 #define FIH_CFI_PRECALL_BLOCK \
         fih_int _fih_cfi_precall_saved_value = fih_cfi_get_and_increment(1)
 
+#ifdef FIH_MODULE_NO_DELAY
+/* fih_cfi_validate() has the delays of the image profile, check it inline */
+#define FIH_CFI_POSTCALL_BLOCK \
+        do { \
+            if (fih_eq(_fih_cfi_precall_saved_value, _fih_cfi_ctr) != \
+                FIH_TRUE) { \
+                FIH_PANIC; \
+            } \
+        } while (0)
+#else /* FIH_MODULE_NO_DELAY */
 #define FIH_CFI_POSTCALL_BLOCK \
         fih_cfi_validate(_fih_cfi_precall_saved_value)
+#endif /* FIH_MODULE_NO_DELAY */
 
 #define FIH_CFI_PRERET \
         fih_cfi_decrement()
@@ -68,6 +68,28 @@ fih_int bl1_sha256_update(uint8_t *data, size_t data_length)
     return FIH_SUCCESS;
 }
 
+fih_int bl1_sha256_chain(uint8_t *block, size_t block_length,
+                         size_t ctr_offset, size_t digest_offset,
+                         uint32_t iterations)
+{
+    fih_int fih_rc = FIH_FAILURE;
+
+    if (block == NULL) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    fih_rc = fih_int_encode_zero_equality(cc3xx_hash_sha256_chain(block,
+                                                                  block_length,
+                                                                  ctr_offset,
+                                                                  digest_offset,
+                                                                  iterations));
+    if(fih_not_eq(fih_rc, FIH_SUCCESS)) {
+        FIH_RET(FIH_FAILURE);
+    }
+
+    FIH_RET(FIH_SUCCESS);
+}
+
 fih_int bl1_sha256_compute(const uint8_t *data,
                            size_t data_length,
                            uint8_t *hash)
@@ -35,6 +35,26 @@ static inline uint32_t bswap_32(uint32_t in) {
     return out;
 }
 
+static void hash_set_initial_state(void)
+{
+    /* Set already processed length to 0 */
+    P_CC3XX->hash.hash_cur_len[0] = 0x0U;
+    P_CC3XX->hash.hash_cur_len[1] = 0x0U;
+
+    /* Set the registers to the magic initial values of sha256. CryptoCell
+     * hardware requires the writes to happen in reverse order
+     * (from H7 to H0).
+     */
+    P_CC3XX->hash.hash_h[7] = 0x5be0cd19U;
+    P_CC3XX->hash.hash_h[6] = 0x1f83d9abU;
+    P_CC3XX->hash.hash_h[5] = 0x9b05688cU;
+    P_CC3XX->hash.hash_h[4] = 0x510e527fU;
+    P_CC3XX->hash.hash_h[3] = 0xa54ff53aU;
+    P_CC3XX->hash.hash_h[2] = 0x3c6ef372U;
+    P_CC3XX->hash.hash_h[1] = 0xbb67ae85U;
+    P_CC3XX->hash.hash_h[0] = 0x6a09e667U;
+}
+
 cc3xx_err_t cc3xx_hash_sha256_init(void)
 {
 
@@ -67,22 +87,7 @@ cc3xx_err_t cc3xx_hash_sha256_init(void)
     /* Disable auto-padding to allow multipart operations */
     P_CC3XX->hash.auto_hw_padding = 0x0U;
 
-    /* Set already processed length to 0 */
-    P_CC3XX->hash.hash_cur_len[0] = 0x0U;
-    P_CC3XX->hash.hash_cur_len[1] = 0x0U;
-
-    /* Set the registers to the magic initial values of sha256. CryptoCell
-     * hardware requires the writes to happen in reverse order
-     * (from H7 to H0).
-     */
-    P_CC3XX->hash.hash_h[7] = 0x5be0cd19U;
-    P_CC3XX->hash.hash_h[6] = 0x1f83d9abU;
-    P_CC3XX->hash.hash_h[5] = 0x9b05688cU;
-    P_CC3XX->hash.hash_h[4] = 0x510e527fU;
-    P_CC3XX->hash.hash_h[3] = 0xa54ff53aU;
-    P_CC3XX->hash.hash_h[2] = 0x3c6ef372U;
-    P_CC3XX->hash.hash_h[1] = 0xbb67ae85U;
-    P_CC3XX->hash.hash_h[0] = 0x6a09e667U;
+    hash_set_initial_state();
 
     return CC3XX_ERR_SUCCESS;
 }
@@ -213,3 +218,71 @@ cc3xx_err_t cc3xx_hash_sha256_finish(uint8_t *res,
 
     return CC3XX_ERR_SUCCESS;
 }
+
+cc3xx_err_t cc3xx_hash_sha256_chain(uint8_t *buf, size_t length,
+                                    size_t ctr_offset, size_t digest_offset,
+                                    uint32_t iterations)
+{
+    cc3xx_err_t err = CC3XX_ERR_SUCCESS;
+    uint32_t tmp_buf[SHA256_OUTPUT_SIZE / sizeof(uint32_t)];
+    size_t final_size;
+    uint32_t iter;
+    uint32_t idx;
+
+    if (length < SHA256_OUTPUT_SIZE || length >= 0x10000
+        || ctr_offset >= length
+        || digest_offset > length - SHA256_OUTPUT_SIZE) {
+        return CC3XX_ERR_INVALID_DATA;
+    }
+
+    if (iterations == 0) {
+        return CC3XX_ERR_SUCCESS;
+    }
+
+    /* The engine is only set up once for the whole chain, and only the hash
+     * state is reset between the iterations.
+     */
+    err = cc3xx_hash_sha256_init();
+    if (err != CC3XX_ERR_SUCCESS) {
+        return err;
+    }
+
+    /* As in the multipart case, the last DMA transfer is the one padded by
+     * the hardware, and is never empty.
+     */
+    final_size = ((length - 1) % SHA256_BLOCK_SIZE) + 1;
+
+    for (iter = 0; iter < iterations; iter++) {
+        if (iter != 0) {
+            P_CC3XX->hash.hash_pad_cfg = 0x0U;
+            P_CC3XX->hash.auto_hw_padding = 0x0U;
+            hash_set_initial_state();
+        }
+
+        if (length > final_size) {
+            err = cc3xx_dma_input_data(buf, length - final_size);
+            if (err != CC3XX_ERR_SUCCESS) {
+                goto out;
+            }
+        }
+
+        P_CC3XX->hash.auto_hw_padding = 0x1U;
+        err = cc3xx_dma_input_data(buf + length - final_size, final_size);
+        if (err != CC3XX_ERR_SUCCESS) {
+            goto out;
+        }
+
+        for (idx = 0; idx < 8; idx++) {
+            tmp_buf[idx] = bswap_32(P_CC3XX->hash.hash_h[idx]);
+        }
+
+        memcpy(buf + digest_offset, tmp_buf, sizeof(tmp_buf));
+        buf[ctr_offset] += 1;
+    }
+
+out:
+    memset(tmp_buf, 0, sizeof(tmp_buf));
+    hash_uninit();
+
+    return err;
+}
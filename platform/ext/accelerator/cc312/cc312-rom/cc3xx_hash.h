@@ -23,6 +23,14 @@ cc3xx_err_t cc3xx_hash_sha256_init(void);
 cc3xx_err_t cc3xx_hash_sha256_update(const uint8_t *buf, size_t length);
 cc3xx_err_t cc3xx_hash_sha256_finish(uint8_t *res, size_t length);
 
+/* Hashes buf, then overwrites SHA256_OUTPUT_SIZE bytes of it at digest_offset
+ * with the hash and increments the byte at ctr_offset, iterations times. The
+ * engine is kept set up between iterations.
+ */
+cc3xx_err_t cc3xx_hash_sha256_chain(uint8_t *buf, size_t length,
+                                    size_t ctr_offset, size_t digest_offset,
+                                    uint32_t iterations);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -14,6 +14,8 @@
 #include "uart_stdout.h"
 #include "region_defs.h"
 #include "cmsis.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 /* Define some offsets from the CC312 base address, to access particular
@@ -270,10 +272,21 @@ static inline struct plat_otp_layout_t *get_cc312_otp_ptr(void){
     return (struct plat_otp_layout_t*)(DX_BASE_CC + CC312_OTP_BASE_OFFSET);
 }
 
+/* The IAK info and the attestation claims, from iak_len to
+ * profile_definition, are read for every attestation token. They are kept in a
+ * shadow copy in RAM, which is filled on first use and dropped on any OTP
+ * write. Keys are never copied out of the OTP.
+ */
+#define OTP_SHADOW_OFFSET offsetof(struct plat_otp_layout_t, iak_len)
+#define OTP_SHADOW_SIZE   (offsetof(struct plat_otp_layout_t, profile_definition) \
+                           + sizeof(((struct plat_otp_layout_t *)0)->profile_definition) \
+                           - OTP_SHADOW_OFFSET)
 
+static uint32_t otp_shadow[(OTP_SHADOW_SIZE + 3) / sizeof(uint32_t)];
+static bool otp_shadow_valid;
 
-static enum tfm_plat_err_t otp_read(const uint8_t *addr, size_t item_size,
-                                    size_t out_len, uint8_t *out)
+static enum tfm_plat_err_t otp_read_words(const uint8_t *addr, size_t item_size,
+                                          size_t out_len, uint8_t *out)
 {
     uint32_t* word_ptr;
     uint32_t word;
@@ -315,6 +328,29 @@ static enum tfm_plat_err_t otp_read(const uint8_t *addr, size_t item_size,
     return TFM_PLAT_ERR_SUCCESS;
 }
 
+static enum tfm_plat_err_t otp_read(const uint8_t *addr, size_t item_size,
+                                    size_t out_len, uint8_t *out)
+{
+    const uint8_t *shadow_base = (const uint8_t *)get_cc312_otp_ptr()
+                                 + OTP_SHADOW_OFFSET;
+    size_t total_copy_size = item_size < out_len ? item_size : out_len;
+
+    if (addr < shadow_base ||
+        addr + item_size > shadow_base + OTP_SHADOW_SIZE) {
+        return otp_read_words(addr, item_size, out_len, out);
+    }
+
+    if (!otp_shadow_valid) {
+        otp_read_words(shadow_base, OTP_SHADOW_SIZE, OTP_SHADOW_SIZE,
+                       (uint8_t *)otp_shadow);
+        otp_shadow_valid = true;
+    }
+
+    memcpy(out, (uint8_t *)otp_shadow + (addr - shadow_base), total_copy_size);
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
 void wait_until_otp_programming_completes(void) {
     /* Read the AIB_FUSE_PROG_COMPLETED register until it has bit 1 set */
     while (! ( cc_read_reg(AIB_FUSE_PROG_COMPLETED_REG_OFFSET) & 1)) {}
@@ -359,6 +395,9 @@ static enum tfm_plat_err_t otp_write(uint8_t *addr, size_t size,
         return TFM_PLAT_ERR_INVALID_INPUT;
     }
 
+    /* Any write may change a shadowed field, or the LCS they depend on */
+    otp_shadow_valid = false;
+
     /* First iterate through and check all values are valid (will not require a
      * 1 bit to be unset). See docs below on why certain design choices have
      * been made with regard to alignment.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021 Arm Limited
+ * Copyright (c) 2021-2023 Arm Limited
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
@@ -9,5 +9,37 @@
 #include "psa_adac.h"
 #include "psa_adac_crypto_api.h"
 #include "psa_adac_cryptosystems.h"
+#include "adac_crypto_cc312_timing.h"
+
+#ifdef PSA_ADAC_CC312_TIMING
+/* Crypto operations timed in the handshake report */
+enum adac_cc312_timing_op_t {
+    ADAC_CC312_TIMING_HASH,
+    ADAC_CC312_TIMING_VERIFY,
+    ADAC_CC312_TIMING_OP_NUM
+};
+
+uint32_t adac_cc312_cycles(void);
+void adac_cc312_timing_add(enum adac_cc312_timing_op_t op, uint32_t start,
+                           size_t bytes);
+
+static inline size_t adac_cc312_total_size(const size_t sizes[], size_t count)
+{
+    size_t total = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        total += sizes[i];
+    }
+
+    return total;
+}
+
+#define ADAC_CC312_TIMING_START(start)   uint32_t start = adac_cc312_cycles()
+#define ADAC_CC312_TIMING_END(op, start, bytes) \
+    adac_cc312_timing_add(op, start, bytes)
+#else
+#define ADAC_CC312_TIMING_START(start)
+#define ADAC_CC312_TIMING_END(op, start, bytes)
+#endif /* PSA_ADAC_CC312_TIMING */
 
 #endif //PSA_ADAC_CRYPTO_CC312_H
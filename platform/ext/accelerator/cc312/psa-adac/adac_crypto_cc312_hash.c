@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020 Arm Limited
+ * Copyright (c) 2020-2023 Arm Limited
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
@@ -48,6 +48,7 @@ psa_status_t psa_adac_hash_multiple(psa_algorithm_t alg,
     }
 
     psa_status_t status = PSA_ERROR_NOT_SUPPORTED;
+    ADAC_CC312_TIMING_START(start);
     if (alg == PSA_ALG_SHA_256) {
         if (hash_size < 32) {
             return PSA_ERROR_INVALID_ARGUMENT;
@@ -96,6 +97,9 @@ psa_status_t psa_adac_hash_multiple(psa_algorithm_t alg,
 #endif
     }
 
+    ADAC_CC312_TIMING_END(ADAC_CC312_TIMING_HASH, start,
+                          adac_cc312_total_size(input_sizes, input_count));
+
     return status;
 }
 
@@ -31,20 +31,14 @@ psa_status_t psa_adac_verify_signature(uint8_t key_type, uint8_t *key,
         size_t input_sizes[], size_t input_count, psa_algorithm_t sig_algo,
         uint8_t *sig, size_t sig_size)
 {
-    psa_status_t r;
-    uint8_t hash[PSA_HASH_MAX_SIZE];
-    size_t hash_size;
     CCError_t error = CC_FAIL;
-
-    r = psa_adac_hash_multiple(hash_algo, inputs, input_sizes, input_count,
-            hash, sizeof(hash), &hash_size);
-
-    if (r != PSA_SUCCESS) {
-        return r;
-    }
+    ADAC_CC312_TIMING_START(start);
 
     if ((key_type == RSA_3072_SHA256) || (key_type == RSA_4096_SHA256)) {
 #if defined (PSA_ADAC_RSA3072) || defined (PSA_ADAC_RSA4096)
+        psa_status_t r;
+        uint8_t hash[PSA_HASH_MAX_SIZE];
+        size_t hash_size;
         CCRsaPubUserContext_t rsaPubUserContext;
         CCRsaUserPubKey_t pubKey;
         uint8_t F4[3] = {0x01, 0x0, 0x1};
@@ -56,6 +50,15 @@ psa_status_t psa_adac_verify_signature(uint8_t key_type, uint8_t *key,
         PSA_ADAC_LOG_TRACE("cc312", "psa_adac_verify_signature Rsa%d\r\n",
                            key_size);
 
+        /* The PSS verification takes the message in a single buffer, so the
+         * inputs are hashed first.
+         */
+        r = psa_adac_hash_multiple(hash_algo, inputs, input_sizes, input_count,
+                hash, sizeof(hash), &hash_size);
+        if (r != PSA_SUCCESS) {
+            return r;
+        }
+
         error = CC_RsaPubKeyBuild(&pubKey, F4, sizeof(F4), key, key_size);
         if (error != CC_OK) {
             PSA_ADAC_LOG_ERR("cc312", "Error in CC_RsaPubKeyBuild %lx\r\n",
@@ -79,10 +82,20 @@ psa_status_t psa_adac_verify_signature(uint8_t key_type, uint8_t *key,
         CCEcdsaVerifyUserContext_t ecdsaVerifyUserContext;
         CCEcpkiUserPublKey_t pubKey;
 
+        /* The inputs are streamed to the hash of the verify operation as
+         * they are, rather than hashed into a separate digest first. The
+         * runtime is built with USE_MBEDTLS_CRYPTOCELL, so their sizes do not
+         * have to be multiples of the hash block size.
+         */
         CCEcpkiHashOpMode_t hashOpMode =
-            (hash_algo == PSA_ALG_SHA_256) ? CC_ECPKI_AFTER_HASH_SHA256_mode :
-            ((hash_algo == PSA_ALG_SHA_512) ? CC_ECPKI_AFTER_HASH_SHA512_mode :
+            (hash_algo == PSA_ALG_SHA_256) ? CC_ECPKI_HASH_SHA256_mode :
+            ((hash_algo == PSA_ALG_SHA_512) ? CC_ECPKI_HASH_SHA512_mode :
                         CC_ECPKI_HASH_NumOfModes);
+        size_t i;
+
+        if (hashOpMode == CC_ECPKI_HASH_NumOfModes) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
 
         if (key_type == ECDSA_P256_SHA256) {
 #if defined (PSA_ADAC_EC_P256)
@@ -124,14 +137,23 @@ psa_status_t psa_adac_verify_signature(uint8_t key_type, uint8_t *key,
         } else if (CC_OK != (error = EcdsaVerifyInit(&ecdsaVerifyUserContext,
                         &pubKey, hashOpMode))) {
             PSA_ADAC_LOG_ERR("cc312", "Error in EcdsaVerifyInit %lx\r\n", error);
-        } else if (CC_OK != (error = EcdsaVerifyUpdate(&ecdsaVerifyUserContext,
-                        hash, hash_size))) {
-            PSA_ADAC_LOG_ERR("cc312", "Error in EcdsaVerifyUpdate %lx\r\n",
-                                        error);
-        } else if (CC_OK != (error = EcdsaVerifyFinish(&ecdsaVerifyUserContext,
-                        sig, sig_size))) {
-            PSA_ADAC_LOG_ERR("cc312", "Error in EcdsaVerifyFinish %lx\r\n",
-                                        error);
+        } else {
+            for (i = 0; (i < input_count) && (error == CC_OK); i++) {
+                error = EcdsaVerifyUpdate(&ecdsaVerifyUserContext,
+                                          (uint8_t *)inputs[i], input_sizes[i]);
+                if (error != CC_OK) {
+                    PSA_ADAC_LOG_ERR("cc312",
+                                     "Error in EcdsaVerifyUpdate %lx\r\n",
+                                     error);
+                }
+            }
+
+            if ((error == CC_OK) &&
+                (CC_OK != (error = EcdsaVerifyFinish(&ecdsaVerifyUserContext,
+                        sig, sig_size)))) {
+                PSA_ADAC_LOG_ERR("cc312", "Error in EcdsaVerifyFinish %lx\r\n",
+                                            error);
+            }
         }
 #else
         return PSA_ERROR_NOT_SUPPORTED;
@@ -140,6 +162,9 @@ psa_status_t psa_adac_verify_signature(uint8_t key_type, uint8_t *key,
         return PSA_ERROR_NOT_SUPPORTED;
     }
 
+    ADAC_CC312_TIMING_END(ADAC_CC312_TIMING_VERIFY, start,
+                          adac_cc312_total_size(input_sizes, input_count));
+
     PSA_ADAC_LOG_DEBUG("cc312", "Signature verification: %s\r\n",
                                        error == CC_OK ? "success" : "failure");
     return (error == CC_OK) ? PSA_SUCCESS : PSA_ERROR_INVALID_SIGNATURE;
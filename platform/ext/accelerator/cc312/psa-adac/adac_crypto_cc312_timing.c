@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Arm Limited. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "adac_crypto_cc312.h"
+#include "psa_adac_debug.h"
+#include "cycle_counter.h"
+
+#include <string.h>
+
+#ifdef PSA_ADAC_CC312_TIMING
+
+struct adac_cc312_timing_t {
+    uint32_t count;
+    uint32_t cycles;
+    uint32_t bytes;
+};
+
+static const char *const timing_op_names[ADAC_CC312_TIMING_OP_NUM] = {
+    "hash",
+    "verify",
+};
+
+static struct adac_cc312_timing_t timing_ops[ADAC_CC312_TIMING_OP_NUM];
+static uint32_t handshake_start;
+
+uint32_t adac_cc312_cycles(void)
+{
+    return cycle_counter_read();
+}
+
+void adac_cc312_timing_add(enum adac_cc312_timing_op_t op, uint32_t start,
+                           size_t bytes)
+{
+    timing_ops[op].count++;
+    timing_ops[op].cycles += adac_cc312_cycles() - start;
+    timing_ops[op].bytes += (uint32_t)bytes;
+}
+
+void psa_adac_cc312_timing_start(void)
+{
+    cycle_counter_enable();
+
+    memset(timing_ops, 0, sizeof(timing_ops));
+    handshake_start = adac_cc312_cycles();
+}
+
+void psa_adac_cc312_timing_report(int result)
+{
+    uint32_t total = adac_cc312_cycles() - handshake_start;
+    int i;
+
+    PSA_ADAC_LOG_INFO("cc312", "Handshake %s in %u cycles\r\n",
+                      (result == 0) ? "succeeded" : "failed",
+                      (unsigned int)total);
+
+    for (i = 0; i < ADAC_CC312_TIMING_OP_NUM; i++) {
+        PSA_ADAC_LOG_INFO("cc312", "  %-6s %3u calls %8u cycles %6u bytes\r\n",
+                          timing_op_names[i],
+                          (unsigned int)timing_ops[i].count,
+                          (unsigned int)timing_ops[i].cycles,
+                          (unsigned int)timing_ops[i].bytes);
+    }
+}
+
+#endif /* PSA_ADAC_CC312_TIMING */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2023 Arm Limited. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSA_ADAC_CRYPTO_CC312_TIMING_H
+#define PSA_ADAC_CRYPTO_CC312_TIMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Timing report of the ADAC handshake, enabled with PLATFORM_PSA_ADAC_TIMING.
+ * The cycles are counted with the DWT cycle counter, so they also include the
+ * time spent waiting for the debugger between the messages.
+ */
+#ifdef PSA_ADAC_CC312_TIMING
+
+/** \brief Reset the counters and start timing the handshake. */
+void psa_adac_cc312_timing_start(void);
+
+/** \brief Log the cycles spent in the handshake and in its crypto operations.
+ *
+ * \param result            Result of the handshake, as returned by the
+ *                          platform secure debug function.
+ */
+void psa_adac_cc312_timing_report(int result);
+
+#else /* PSA_ADAC_CC312_TIMING */
+
+#define psa_adac_cc312_timing_start()
+#define psa_adac_cc312_timing_report(result)
+
+#endif /* PSA_ADAC_CC312_TIMING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PSA_ADAC_CRYPTO_CC312_TIMING_H
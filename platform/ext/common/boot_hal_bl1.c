@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,6 +9,7 @@
 #include "target_cfg.h"
 #include "region.h"
 #include "cmsis.h"
+#include "cycle_counter.h"
 #include "boot_hal.h"
 #include "Driver_Flash.h"
 #include "flash_layout.h"
@@ -19,9 +20,10 @@
 #include "fih.h"
 #endif /* CRYPTO_HW_ACCELERATOR */
 
-#ifdef MEASURED_BOOT_API
-#include "region_defs.h"
+#if defined(MEASURED_BOOT_API) || defined(TFM_BOOT_TIMING)
 #include "tfm_boot_status.h"
+#endif /* MEASURED_BOOT_API || TFM_BOOT_TIMING */
+#ifdef MEASURED_BOOT_API
 #include "boot_measurement.h"
 #endif /* MEASURED_BOOT_API */
 
@@ -240,7 +242,7 @@ __WEAK int boot_platform_post_load(uint32_t image_id)
     return 0;
 }
 
-#ifdef MEASURED_BOOT_API
+#if defined(MEASURED_BOOT_API) || defined(TFM_BOOT_TIMING)
 static int boot_add_data_to_shared_area(uint8_t        major_type,
                                         uint16_t       minor_type,
                                         size_t         size,
@@ -306,7 +308,9 @@ static int boot_add_data_to_shared_area(uint8_t        major_type,
 
     return 0;
 }
+#endif /* MEASURED_BOOT_API || TFM_BOOT_TIMING */
 
+#ifdef MEASURED_BOOT_API
 __WEAK int boot_store_measurement(
                             uint8_t index,
                             const uint8_t *measurement,
@@ -342,3 +346,27 @@ __WEAK int boot_store_measurement(
     return rc;
 }
 #endif /* MEASURED_BOOT_API */
+
+#ifdef TFM_BOOT_TIMING
+__WEAK uint32_t boot_platform_get_timestamp(void)
+{
+    cycle_counter_enable();
+
+    return cycle_counter_read();
+}
+
+__WEAK int boot_store_timestamp(uint8_t phase, uint8_t index, uint32_t id)
+{
+    struct boot_timing_entry entry = {
+        .phase = phase,
+        .index = index,
+        .timestamp = boot_platform_get_timestamp(),
+        .id = id,
+    };
+
+    return boot_add_data_to_shared_area(TLV_MAJOR_BTS,
+                                        SET_BTS_MINOR(phase, index),
+                                        sizeof(entry),
+                                        (const uint8_t *)&entry);
+}
+#endif /* TFM_BOOT_TIMING */
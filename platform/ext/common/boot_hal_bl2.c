@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,6 +9,7 @@
 #include "target_cfg.h"
 #include "region.h"
 #include "cmsis.h"
+#include "cycle_counter.h"
 #include "boot_hal.h"
 #include "Driver_Flash.h"
 #include "flash_layout.h"
@@ -347,3 +348,12 @@ __WEAK int boot_store_measurement(
     return rc;
 }
 #endif /* MEASURED_BOOT_API */
+
+#ifdef TFM_BOOT_TIMING
+__WEAK uint32_t boot_platform_get_timestamp(void)
+{
+    cycle_counter_enable();
+
+    return cycle_counter_read();
+}
+#endif /* TFM_BOOT_TIMING */
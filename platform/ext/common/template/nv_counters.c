@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -14,6 +14,7 @@
 #include "tfm_plat_nv_counters.h"
 
 #include <limits.h>
+#include <stdbool.h>
 #include "Driver_Flash.h"
 #include "flash_layout.h"
 #include "tfm_plat_otp.h"
@@ -36,6 +37,13 @@ enum flash_nv_counter_id_t {
 };
 #endif
 
+/* The counters are kept in RAM after they are first read. Writes go through to
+ * the underlying memory, and the RAM copy is only updated once the new value is
+ * read back.
+ */
+static uint32_t nv_counter_shadow[PLAT_NV_COUNTER_MAX];
+static uint32_t nv_counter_shadow_valid;
+
 enum tfm_plat_err_t tfm_plat_init_nv_counter(void)
 {
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
@@ -107,13 +115,9 @@ static enum tfm_plat_err_t read_nv_counter_flash(enum flash_nv_counter_id_t coun
 }
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
 
-enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
-                                             uint32_t size, uint8_t *val)
+static enum tfm_plat_err_t read_nv_counter(enum tfm_nv_counter_t counter_id,
+                                           uint32_t size, uint8_t *val)
 {
-    if (size != NV_COUNTER_SIZE) {
-        return TFM_PLAT_ERR_SYSTEM_ERR;
-    }
-
     switch(counter_id) {
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
     case (PLAT_NV_COUNTER_PS_0):
@@ -158,6 +162,35 @@ enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
     }
 }
 
+enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
+                                             uint32_t size, uint8_t *val)
+{
+    enum tfm_plat_err_t err;
+
+    if (size != NV_COUNTER_SIZE) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
+    }
+
+    if (counter_id >= PLAT_NV_COUNTER_MAX) {
+        return TFM_PLAT_ERR_UNSUPPORTED;
+    }
+
+    if (nv_counter_shadow_valid & (1u << counter_id)) {
+        memcpy(val, &nv_counter_shadow[counter_id], NV_COUNTER_SIZE);
+        return TFM_PLAT_ERR_SUCCESS;
+    }
+
+    err = read_nv_counter(counter_id, size, val);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+    memcpy(&nv_counter_shadow[counter_id], val, NV_COUNTER_SIZE);
+    nv_counter_shadow_valid |= (1u << counter_id);
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
 #if defined(BL2) || defined(BL1)
 static enum tfm_plat_err_t set_nv_counter_otp(enum tfm_otp_element_id_t id,
                                               uint32_t value)
@@ -289,6 +322,12 @@ enum tfm_plat_err_t tfm_plat_set_nv_counter(enum tfm_nv_counter_t counter_id,
     default:
         return TFM_PLAT_ERR_UNSUPPORTED;
     }
+
+    /* The counter may have been partially written, so it has to be read from
+     * the underlying memory again.
+     */
+    nv_counter_shadow_valid &= ~(1u << counter_id);
+
     if (err != TFM_PLAT_ERR_SUCCESS) {
         return err;
     }
@@ -328,3 +367,102 @@ enum tfm_plat_err_t tfm_plat_increment_nv_counter(
 
     return tfm_plat_set_nv_counter(counter_id, security_cnt + 1u);
 }
+
+enum tfm_plat_err_t tfm_plat_increment_nv_counters(
+                                     const enum tfm_nv_counter_t *counter_ids,
+                                     uint32_t num_counters)
+{
+    uint32_t security_cnt[PLAT_NV_COUNTER_MAX];
+    enum tfm_nv_counter_t counter_id;
+    enum tfm_plat_err_t err;
+    uint32_t new_value;
+    uint32_t idx;
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    uint32_t flash_counters[FLASH_NV_COUNTER_ID_MAX];
+    bool flash_update = false;
+#endif
+
+    /* Check all the counters first so that none of them is incremented if one
+     * has reached its maximum value.
+     */
+    for (idx = 0; idx < num_counters; idx++) {
+        counter_id = counter_ids[idx];
+
+        err = tfm_plat_read_nv_counter(counter_id, NV_COUNTER_SIZE,
+                                       (uint8_t *)&new_value);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+
+        if (new_value == UINT32_MAX) {
+            return TFM_PLAT_ERR_MAX_VALUE;
+        }
+
+        security_cnt[counter_id] = new_value;
+    }
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    err = read_otp_nv_counters_flash(offsetof(struct flash_otp_nv_counters_region_t,
+                                              flash_nv_counters),
+                                     flash_counters, sizeof(flash_counters));
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+#endif
+
+    for (idx = 0; idx < num_counters; idx++) {
+        counter_id = counter_ids[idx];
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+        /* The PS counters are next to each other in flash, so they are all
+         * programmed in a single write below.
+         */
+        if (counter_id >= PLAT_NV_COUNTER_PS_0 &&
+            counter_id <= PLAT_NV_COUNTER_PS_2) {
+            flash_counters[counter_id - PLAT_NV_COUNTER_PS_0] =
+                security_cnt[counter_id] + 1u;
+            flash_update = true;
+            continue;
+        }
+#endif
+
+        err = tfm_plat_set_nv_counter(counter_id, security_cnt[counter_id] + 1u);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+    }
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (!flash_update) {
+        return TFM_PLAT_ERR_SUCCESS;
+    }
+
+    nv_counter_shadow_valid &= ~((1u << PLAT_NV_COUNTER_PS_0) |
+                                 (1u << PLAT_NV_COUNTER_PS_1) |
+                                 (1u << PLAT_NV_COUNTER_PS_2));
+
+    err = write_otp_nv_counters_flash(offsetof(struct flash_otp_nv_counters_region_t,
+                                               flash_nv_counters),
+                                      flash_counters, sizeof(flash_counters));
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+    /* Check that the NV counter write hasn't failed */
+    for (idx = 0; idx < FLASH_NV_COUNTER_ID_MAX; idx++) {
+        counter_id = (enum tfm_nv_counter_t)(PLAT_NV_COUNTER_PS_0 + idx);
+
+        err = tfm_plat_read_nv_counter(counter_id, sizeof(new_value),
+                                       (uint8_t *)&new_value);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+
+        if (new_value != flash_counters[idx]) {
+            return TFM_PLAT_ERR_SYSTEM_ERR;
+        }
+    }
+#endif
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "cmsis.h"
+#include "tfm_hal_platform.h"
+
+#define NVIC_REG_NUM    (sizeof(NVIC->ISER) / sizeof(NVIC->ISER[0]))
+
+/* Return the lowest enabled and pending IRQ number. */
+static uint32_t pending_irq(void)
+{
+    uint32_t i, bit, pend;
+
+    for (i = 0; i < NVIC_REG_NUM; i++) {
+        pend = NVIC->ISPR[i] & NVIC->ISER[i];
+        for (bit = 0; pend != 0; bit++, pend >>= 1) {
+            if (pend & 1U) {
+                return i * 32 + bit;
+            }
+        }
+    }
+
+    return TFM_HAL_WAKE_REASON_UNKNOWN;
+}
+
+/*
+ * Deeper states need platform knowledge of clocks, power domains and wake-up
+ * sources, so the default only stops the core clock.
+ */
+enum tfm_hal_idle_state_t tfm_hal_platform_idle(
+                                        enum tfm_hal_idle_state_t deepest,
+                                        uint32_t *wake_reason)
+{
+    (void)deepest;
+
+    __DSB();
+    __WFI();
+
+    if (wake_reason) {
+        *wake_reason = pending_irq();
+    }
+
+    return TFM_HAL_IDLE_WFI;
+}
@@ -36,6 +36,78 @@
 #define HANDLE_ATTR_NS_POS              0U
 #define HANDLE_ATTR_NS_MASK             (0x1UL << HANDLE_ATTR_NS_POS)
 
+#ifdef CONFIG_TFM_MEMORY_CHECK_CACHE
+/* Number of NS ranges remembered as accessible, most recently used first */
+#define MEM_CHECK_CACHE_NUM             4
+
+struct mem_check_cache_t {
+    uintptr_t base;
+    size_t    size;                     /* 0 for an empty entry */
+    int       flags;                    /* CMSE flags of the check */
+};
+
+static struct mem_check_cache_t mem_check_cache[MEM_CHECK_CACHE_NUM];
+
+/*
+ * A sub-range of a range accepted by cmse_check_address_range() lies in the
+ * same region with the same attributes, so it is accepted too.
+ */
+static bool mem_check_cache_lookup(uintptr_t base, size_t size, int flags)
+{
+    struct mem_check_cache_t hit;
+    uint32_t primask = __get_PRIMASK();
+    bool found = false;
+    uint32_t i;
+
+    __disable_irq();
+
+    for (i = 0; i < MEM_CHECK_CACHE_NUM; i++) {
+        if (mem_check_cache[i].flags == flags &&
+            base >= mem_check_cache[i].base &&
+            size <= mem_check_cache[i].size &&
+            base - mem_check_cache[i].base <= mem_check_cache[i].size - size) {
+            found = true;
+            break;
+        }
+    }
+
+    if (found && i > 0) {
+        hit = mem_check_cache[i];
+        memmove(&mem_check_cache[1], &mem_check_cache[0],
+                i * sizeof(mem_check_cache[0]));
+        mem_check_cache[0] = hit;
+    }
+
+    __set_PRIMASK(primask);
+
+    return found;
+}
+
+static void mem_check_cache_insert(uintptr_t base, size_t size, int flags)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    memmove(&mem_check_cache[1], &mem_check_cache[0],
+            (MEM_CHECK_CACHE_NUM - 1) * sizeof(mem_check_cache[0]));
+    mem_check_cache[0].base = base;
+    mem_check_cache[0].size = size;
+    mem_check_cache[0].flags = flags;
+
+    __set_PRIMASK(primask);
+}
+
+void tfm_hal_memory_check_cache_invalidate(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memset(mem_check_cache, 0, sizeof(mem_check_cache));
+    __set_PRIMASK(primask);
+}
+#endif /* CONFIG_TFM_MEMORY_CHECK_CACHE */
+
 #ifdef CONFIG_TFM_ENABLE_MEMORY_PROTECT
 static uint32_t n_configured_regions = 0;
 
@@ -441,9 +513,20 @@ enum tfm_hal_status_t tfm_hal_memory_check(uintptr_t boundary, uintptr_t base,
             flags &= ~CMSE_MPU_UNPRIV;
         }
         flags |= CMSE_NONSECURE;
+
+#ifdef CONFIG_TFM_MEMORY_CHECK_CACHE
+        if (mem_check_cache_lookup(base, size, flags)) {
+            return TFM_HAL_SUCCESS;
+        }
+#endif
     }
 
     if (cmse_check_address_range((void *)base, size, flags) != NULL) {
+#ifdef CONFIG_TFM_MEMORY_CHECK_CACHE
+        if (flags & CMSE_NONSECURE) {
+            mem_check_cache_insert(base, size, flags);
+        }
+#endif
         return TFM_HAL_SUCCESS;
     } else {
         return TFM_HAL_ERROR_MEM_FAULT;
@@ -21,4 +21,18 @@
  */
 int32_t tfm_hal_output_spm_log(const char *str, uint32_t len);
 
+#ifdef TFM_SPM_LOG_BUFFERED
+/**
+ * \brief Sends the log output buffered so far to the log device. Called by
+ *        the SPM when the system is idle, and before it halts or resets.
+ */
+void tfm_hal_spm_log_drain(void);
+
+/**
+ * \brief Returns the number of bytes of log output dropped since boot because
+ *        the log buffer was full.
+ */
+uint32_t tfm_hal_spm_log_dropped(void);
+#endif /* TFM_SPM_LOG_BUFFERED */
+
 #endif /* __TFM_HAL_SPM_LOGDEV_H__ */
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Buffered SPM log device
+ *
+ * The SPM and Secure Partition log output is copied to a ring buffer instead
+ * of being sent to the UART straight away. tfm_hal_spm_log_drain() sends it
+ * later, when the system is idle. Output that doesn't fit in the buffer is
+ * dropped and counted, so logging never waits for the UART.
+ *
+ * The SPM can log from an exception handler while thread mode is logging, so
+ * writers may be nested. Each writer reserves its space and copies its message
+ * with interrupts enabled, only the index updates are done with interrupts
+ * masked. The output is handed to the drain once the outermost writer has
+ * finished.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "critical_section.h"
+#include "tfm_hal_spm_logdev.h"
+#include "uart_stdout.h"
+
+#ifndef TFM_SPM_LOG_BUFFER_SIZE
+#define TFM_SPM_LOG_BUFFER_SIZE 1024
+#endif
+
+#if (TFM_SPM_LOG_BUFFER_SIZE & (TFM_SPM_LOG_BUFFER_SIZE - 1)) != 0
+#error "TFM_SPM_LOG_BUFFER_SIZE must be a power of two"
+#endif
+
+#define LOG_BUFFER_MASK     (TFM_SPM_LOG_BUFFER_SIZE - 1)
+
+static const char log_dropped_msg[] = "\r\n[Log output dropped]\r\n";
+
+static uint8_t log_buffer[TFM_SPM_LOG_BUFFER_SIZE];
+
+/* Free-running byte counts, wrapped to the buffer with LOG_BUFFER_MASK */
+static volatile uint32_t log_reserved;
+static volatile uint32_t log_committed;
+static volatile uint32_t log_drained;
+
+static volatile uint32_t log_writers;
+static volatile uint32_t log_dropped;
+static uint32_t log_dropped_reported;
+
+int32_t tfm_hal_output_spm_log(const char *str, uint32_t len)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t start;
+    uint32_t first_len;
+
+    CRITICAL_SECTION_ENTER(cs);
+    if (len > TFM_SPM_LOG_BUFFER_SIZE - (log_reserved - log_drained)) {
+        log_dropped += len;
+        CRITICAL_SECTION_LEAVE(cs);
+        return 0;
+    }
+    start = log_reserved;
+    log_reserved = start + len;
+    log_writers++;
+    CRITICAL_SECTION_LEAVE(cs);
+
+    first_len = TFM_SPM_LOG_BUFFER_SIZE - (start & LOG_BUFFER_MASK);
+    if (first_len > len) {
+        first_len = len;
+    }
+    memcpy(&log_buffer[start & LOG_BUFFER_MASK], str, first_len);
+    memcpy(log_buffer, str + first_len, len - first_len);
+
+    CRITICAL_SECTION_ENTER(cs);
+    if (--log_writers == 0) {
+        log_committed = log_reserved;
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+
+    return (int32_t)len;
+}
+
+void tfm_hal_spm_log_drain(void)
+{
+    uint32_t committed = log_committed;
+    uint32_t dropped = log_dropped;
+    uint32_t start;
+    uint32_t len;
+
+    while (log_drained != committed) {
+        start = log_drained & LOG_BUFFER_MASK;
+        len = committed - log_drained;
+        if (len > TFM_SPM_LOG_BUFFER_SIZE - start) {
+            len = TFM_SPM_LOG_BUFFER_SIZE - start;
+        }
+
+        (void)stdio_output_string(&log_buffer[start], len);
+        log_drained += len;
+    }
+
+    /* The dropped output was newer than everything sent so far */
+    if (dropped != log_dropped_reported) {
+        log_dropped_reported = dropped;
+        (void)stdio_output_string((const unsigned char *)log_dropped_msg,
+                                  sizeof(log_dropped_msg) - 1);
+    }
+}
+
+uint32_t tfm_hal_spm_log_dropped(void)
+{
+    return log_dropped;
+}
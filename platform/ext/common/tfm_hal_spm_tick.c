@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "cmsis.h"
+#include "config_tfm.h"
+#include "tfm_hal_platform.h"
+
+#if CONFIG_TFM_SPM_TIMER == 1
+#include "critical_section.h"
+#include "ffm/spm_timer.h"
+
+/*
+ * The secure SysTick is used by default. It runs at the lowest exception
+ * priority, the same as PendSV, so a tick never preempts the scheduler.
+ */
+void SysTick_Handler(void)
+{
+    spm_handle_tick();
+}
+
+enum tfm_hal_status_t tfm_hal_spm_tick_init(uint32_t tick_hz)
+{
+    if (tick_hz == 0 || SystemCoreClock / tick_hz == 0) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    if (SysTick_Config(SystemCoreClock / tick_hz) != 0) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+#if CONFIG_TFM_CRITICAL_SECTION_BASEPRI != 0
+    /* The tick walks the SPM timers, the critical sections must mask it */
+    if (!CRITICAL_SECTION_MASKS_PRIORITY(NVIC_GetPriority(SysTick_IRQn))) {
+        SysTick->CTRL = 0;
+        return TFM_HAL_ERROR_GENERIC;
+    }
+#endif
+
+    return TFM_HAL_SUCCESS;
+}
+#endif /* CONFIG_TFM_SPM_TIMER == 1 */
@@ -61,6 +61,36 @@ enum mpu_armv8m_error_t mpu_armv8m_disable(struct mpu_armv8m_dev_t *dev)
     return MPU_ARMV8M_OK;
 }
 
+enum mpu_armv8m_error_t mpu_armv8m_region_encode(
+                            const struct mpu_armv8m_region_cfg_t *region_cfg,
+                            struct mpu_armv8m_region_regs_t *regs)
+{
+    /*FIXME : Add complete error checking*/
+    if ((region_cfg->region_base & ~MPU_RBAR_BASE_Msk) != 0) {
+        return MPU_ARMV8M_ERROR;
+    }
+    /* region_limit doesn't need to be aligned but the scatter
+     * file needs to be setup to ensure that partitions do not overlap.
+     */
+
+    /* This zeroes the lower bits of the base address */
+    regs->rbar = region_cfg->region_base & MPU_RBAR_BASE_Msk;
+    regs->rbar |= (region_cfg->attr_sh << MPU_RBAR_SH_Pos) & MPU_RBAR_SH_Msk;
+    regs->rbar |= (region_cfg->attr_access << MPU_RBAR_AP_Pos) &
+                  MPU_RBAR_AP_Msk;
+    regs->rbar |= (region_cfg->attr_exec << MPU_RBAR_XN_Pos) & MPU_RBAR_XN_Msk;
+
+    /* This zeroes the lower bits of limit address but they are treated as 1 */
+    regs->rlar = (region_cfg->region_limit-1) & MPU_RLAR_LIMIT_Msk;
+
+    regs->rlar |= (region_cfg->region_attridx << MPU_RLAR_AttrIndx_Pos) &
+                  MPU_RLAR_AttrIndx_Msk;
+
+    regs->rlar |= MPU_RLAR_EN_Msk;
+
+    return MPU_ARMV8M_OK;
+}
+
 FIH_RET_TYPE(enum mpu_armv8m_error_t) mpu_armv8m_region_enable(
                                 struct mpu_armv8m_dev_t *dev,
                                 struct mpu_armv8m_region_cfg_t *region_cfg)
@@ -68,39 +98,52 @@ FIH_RET_TYPE(enum mpu_armv8m_error_t) mpu_armv8m_region_enable(
     MPU_Type *mpu = (MPU_Type *)dev->base;
 
     uint32_t ctrl_before;
-    uint32_t base_cfg;
-    uint32_t limit_cfg;
+    struct mpu_armv8m_region_regs_t regs;
 
-    /*FIXME : Add complete error checking*/
-    if ((region_cfg->region_base & ~MPU_RBAR_BASE_Msk) != 0) {
+    if (mpu_armv8m_region_encode(region_cfg, &regs) != MPU_ARMV8M_OK) {
         FIH_RET(fih_int_encode(MPU_ARMV8M_ERROR));
     }
-    /* region_limit doesn't need to be aligned but the scatter
-     * file needs to be setup to ensure that partitions do not overlap.
-     */
 
     ctrl_before = mpu->CTRL;
     mpu->CTRL = 0;
 
     mpu->RNR  = region_cfg->region_nr & MPU_RNR_REGION_Msk;
+    mpu->RBAR = regs.rbar;
+    mpu->RLAR = regs.rlar;
 
-    /* This zeroes the lower bits of the base address */
-    base_cfg = region_cfg->region_base & MPU_RBAR_BASE_Msk;
-    base_cfg |= (region_cfg->attr_sh << MPU_RBAR_SH_Pos) & MPU_RBAR_SH_Msk;
-    base_cfg |= (region_cfg->attr_access << MPU_RBAR_AP_Pos) & MPU_RBAR_AP_Msk;
-    base_cfg |= (region_cfg->attr_exec << MPU_RBAR_XN_Pos) & MPU_RBAR_XN_Msk;
+    /*Restore main MPU control*/
+    mpu->CTRL = ctrl_before;
 
-    mpu->RBAR = base_cfg;
+    /* Enable MPU before the next instruction */
+    __DSB();
+    __ISB();
 
-    /* This zeroes the lower bits of limit address but they are treated as 1 */
-    limit_cfg = (region_cfg->region_limit-1) & MPU_RLAR_LIMIT_Msk;
+    FIH_RET(fih_int_encode(MPU_ARMV8M_OK));
+}
 
-    limit_cfg |= (region_cfg->region_attridx << MPU_RLAR_AttrIndx_Pos) &
-                 MPU_RLAR_AttrIndx_Msk;
+FIH_RET_TYPE(enum mpu_armv8m_error_t) mpu_armv8m_region_load(
+                            struct mpu_armv8m_dev_t *dev,
+                            uint32_t region_nr,
+                            const struct mpu_armv8m_region_regs_t *regs,
+                            uint32_t count)
+{
+    MPU_Type *mpu = (MPU_Type *)dev->base;
+    volatile uint32_t *alias;
+    uint32_t ctrl_before;
+    uint32_t nr;
 
-    limit_cfg |= MPU_RLAR_EN_Msk;
+    ctrl_before = mpu->CTRL;
+    mpu->CTRL = 0;
 
-    mpu->RLAR = limit_cfg;
+    for (nr = region_nr; nr < region_nr + count; nr++) {
+        /* RBAR/RLAR and their aliases access the regions following RNR */
+        if (nr == region_nr || (nr % MPU_TYPE_RALIASES) == 0) {
+            mpu->RNR = (nr & ~(MPU_TYPE_RALIASES - 1U)) & MPU_RNR_REGION_Msk;
+        }
+        alias = &mpu->RBAR + ((nr % MPU_TYPE_RALIASES) * 2U);
+        alias[0] = regs[nr - region_nr].rbar;
+        alias[1] = regs[nr - region_nr].rlar;
+    }
 
     /*Restore main MPU control*/
     mpu->CTRL = ctrl_before;
@@ -68,6 +68,11 @@ struct mpu_armv8m_region_cfg_raw_t {
     uint32_t region_limit;
 };
 
+struct mpu_armv8m_region_regs_t {
+    uint32_t rbar;
+    uint32_t rlar;
+};
+
 
 /**
  * \brief Enable MPU
@@ -135,4 +140,38 @@ FIH_RET_TYPE(enum mpu_armv8m_error_t) mpu_armv8m_region_disable(
                                                   struct mpu_armv8m_dev_t *dev,
                                                   uint32_t region_nr);
 
+/**
+ * \brief Encode an MPU region config into its RBAR and RLAR values
+ *
+ * \param[in]  region_cfg    MPU region config \ref mpu_armv8m_region_cfg_t,
+ *                           region_nr is ignored
+ * \param[out] regs          RBAR and RLAR values of the enabled region
+ *
+ * \return Error code \ref mpu_armv8m_error_t
+ */
+enum mpu_armv8m_error_t mpu_armv8m_region_encode(
+                            const struct mpu_armv8m_region_cfg_t *region_cfg,
+                            struct mpu_armv8m_region_regs_t *regs);
+
+/**
+ * \brief Load consecutive MPU regions
+ *
+ * \param[in] dev            MPU device \ref mpu_armv8m_dev_t
+ * \param[in] region_nr      First region number
+ * \param[in] regs           RBAR and RLAR values of the regions, {0, 0} for
+ *                           a disabled region
+ * \param[in] count          Number of regions to load
+ *
+ * \return Error code \ref mpu_armv8m_error_t
+ *
+ * \note The regions are written through the RBAR and RLAR alias registers,
+ *       so RNR is only written once for every MPU_TYPE_RALIASES regions.
+ * \note This function doesn't check if dev is NULL.
+ */
+FIH_RET_TYPE(enum mpu_armv8m_error_t) mpu_armv8m_region_load(
+                            struct mpu_armv8m_dev_t *dev,
+                            uint32_t region_nr,
+                            const struct mpu_armv8m_region_regs_t *regs,
+                            uint32_t count);
+
 #endif /* __MPU_ARMV8M_DRV_H__ */
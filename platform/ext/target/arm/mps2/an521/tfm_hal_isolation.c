@@ -45,6 +45,13 @@ REGION_DECLARE(Image$$, TFM_SP_META_PTR, $$ZI$$Limit);
 #define MIN_NR_PRIVATE_DATA_REGION    1
 
 static uint32_t idx_boundary_handle = 0;
+
+/*
+ * Values of the partition regions currently in the MPU, beyond the static
+ * regions. They are all disabled after the static boundaries are set up.
+ */
+static struct mpu_armv8m_region_regs_t mpu_image[MPU_REGION_NUM];
+
 REGION_DECLARE(Image$$, PT_RO_START, $$Base);
 REGION_DECLARE(Image$$, PT_RO_END, $$Base);
 REGION_DECLARE(Image$$, PT_PRIV_RWZI_START, $$Base);
@@ -515,7 +522,8 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
     bool privileged = !!(local_handle & HANDLE_ATTR_PRIV_MASK);
 #if TFM_LVL == 3
     struct mpu_armv8m_region_cfg_t localcfg;
-    uint32_t i;
+    struct mpu_armv8m_region_regs_t image[MPU_REGION_NUM];
+    uint32_t i, first, last;
 #if CONFIG_TFM_MMIO_REGION_ENABLE == 1
     uint32_t mmio_index;
     struct platform_data_t *plat_data_ptr;
@@ -539,6 +547,12 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
         FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
     }
 
+    /*
+     * Build the values of all the partition regions, then only write the
+     * ones that differ from what is already in the MPU.
+     */
+    memset(image, 0, sizeof(image));
+
     /* Setup runtime memory first */
     localcfg.attr_exec = MPU_ARMV8M_XN_EXEC_NEVER;
     localcfg.attr_sh = MPU_ARMV8M_SH_NONE;
@@ -552,12 +566,15 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
     for (i = 0;
          i < p_ldinf->nassets && !(rt_mem[i].attr & ASSET_ATTR_MMIO);
          i++) {
-        localcfg.region_nr = n_configured_regions + i;
+        if (n_configured_regions + i >= MPU_REGION_NUM) {
+            FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
+        }
         localcfg.region_base = rt_mem[i].mem.start;
         localcfg.region_limit = rt_mem[i].mem.limit;
 
-        FIH_CALL(mpu_armv8m_region_enable, fih_rc, &dev_mpu_s, &localcfg);
-        if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
+        if (mpu_armv8m_region_encode(&localcfg,
+                                     &image[n_configured_regions + i])
+            != MPU_ARMV8M_OK) {
             FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
         }
     }
@@ -575,15 +592,14 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
     while (mmio_index && i < MPU_REGION_NUM) {
         plat_data_ptr =
           (struct platform_data_t *)partition_named_mmio_list[mmio_index - 1];
-        localcfg.region_nr = i++;
         localcfg.attr_access = (local_handle & HANDLE_ATTR_RW_POS)?
                             MPU_ARMV8M_AP_RW_PRIV_UNPRIV :
                             MPU_ARMV8M_AP_RO_PRIV_UNPRIV;
         localcfg.region_base = plat_data_ptr->periph_start;
         localcfg.region_limit = plat_data_ptr->periph_limit;
 
-        FIH_CALL(mpu_armv8m_region_enable, fih_rc, &dev_mpu_s, &localcfg);
-        if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
+        if (mpu_armv8m_region_encode(&localcfg, &image[i++])
+            != MPU_ARMV8M_OK) {
             FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
         }
 
@@ -592,13 +608,34 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_activate_boundary(
     }
 #endif
 
-    /* Disable unused regions */
-    while (i < MPU_REGION_NUM) {
-        FIH_CALL(mpu_armv8m_region_disable, fih_rc, &dev_mpu_s, i++);
-        if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
-            FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
+    /* The regions left in image are disabled. Find the span that changed. */
+    for (first = n_configured_regions; first < MPU_REGION_NUM; first++) {
+        if (image[first].rbar != mpu_image[first].rbar ||
+            image[first].rlar != mpu_image[first].rlar) {
+            break;
         }
     }
+
+    if (first == MPU_REGION_NUM) {
+        /* Same regions as the partition that ran last */
+        FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
+    }
+
+    for (last = MPU_REGION_NUM - 1; last > first; last--) {
+        if (image[last].rbar != mpu_image[last].rbar ||
+            image[last].rlar != mpu_image[last].rlar) {
+            break;
+        }
+    }
+
+    FIH_CALL(mpu_armv8m_region_load, fih_rc, &dev_mpu_s, first,
+             &image[first], last - first + 1);
+    if (fih_not_eq(fih_rc, fih_int_encode(MPU_ARMV8M_OK))) {
+        FIH_RET(fih_int_encode(TFM_HAL_ERROR_GENERIC));
+    }
+
+    memcpy(&mpu_image[first], &image[first],
+           (last - first + 1) * sizeof(image[0]));
 #endif /* TFM_LVL == 3 */
     FIH_RET(fih_int_encode(TFM_HAL_SUCCESS));
 }
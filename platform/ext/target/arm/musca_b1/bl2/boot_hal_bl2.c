@@ -11,6 +11,7 @@
 #include "fih.h"
 #endif /* CRYPTO_HW_ACCELERATOR */
 
+#include "adac_crypto_cc312_timing.h"
 #include "bootutil/bootutil_log.h"
 #include "microsecond_timer.h"
 #include "psa_adac_platform.h"
@@ -40,7 +41,9 @@ int32_t boot_platform_post_init(void)
         return plat_err;
     }
 
+    psa_adac_cc312_timing_start();
     result = tfm_to_psa_adac_musca_b1_secure_debug(rotpk_p256, 32);
+    psa_adac_cc312_timing_report(result);
     BOOT_LOG_INF("%s: Musca-B1 secure_debug is a %s.\r\n", __func__,
             (result == 0) ? "success" : "failure");
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -31,6 +31,32 @@ int32_t boot_dma_memcpy(uint32_t src_addr,
                         uint32_t size,
                         uint32_t channel_idx);
 
+/*!
+ * \brief Starts a DMA memory copy and returns without waiting for it.
+ *
+ * \param[in] src_addr      Source address of the data to be copied.
+ * \param[in] dest_addr     Destination address of the data to be copied.
+ * \param[in] size          Size of the data to be copied in bytes copied.
+ * \param[in] channel_idx   DMA channel index to be used for copy service.
+ *
+ * \return Returns 0 on success else -1
+ *
+ */
+int32_t boot_dma_memcpy_start(uint32_t src_addr,
+                              uint32_t dest_addr,
+                              uint32_t size,
+                              uint32_t channel_idx);
+
+/*!
+ * \brief Waits for the copy started on a DMA channel to complete.
+ *
+ * \param[in] channel_idx   DMA channel index the copy was started on.
+ *
+ * \return Returns 0 if the copy has completed successfully else -1
+ *
+ */
+int32_t boot_dma_wait(uint32_t channel_idx);
+
 /**
  * \brief Initialise the DMA devices and channels.
  *
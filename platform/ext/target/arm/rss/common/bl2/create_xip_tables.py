@@ -1,5 +1,5 @@
 #-------------------------------------------------------------------------------
-# Copyright (c) 2022, Arm Limited. All rights reserved.
+# Copyright (c) 2022-2023, Arm Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -13,8 +13,6 @@ from cryptography.hazmat.primitives.ciphers import Cipher, algorithms, modes
 import struct
 import secrets
 
-sic_page_size = 1024
-
 def struct_pack(objects, pad_to=0):
     defstring = "<"
     for obj in objects:
@@ -35,8 +33,13 @@ parser.add_argument("--encrypt_key_file", help="Key to encrypt image with", requ
 parser.add_argument("--image_version", help="Version of the image", required=True)
 parser.add_argument("--table_output_file", help="table output file", required=True)
 parser.add_argument("--encrypted_image_output_file", help="encrupted image output file", required=True)
+parser.add_argument("--sic_page_size", help="SIC authentication page size in bytes, must match the SIC hardware", required=False, default="1024")
 args = parser.parse_args()
 
+sic_page_size = int(args.sic_page_size, 0)
+if sic_page_size < 128 or sic_page_size & (sic_page_size - 1):
+    parser.error("--sic_page_size must be a power of two of at least 128")
+
 with open(args.input_image, "rb") as in_file:
     image = in_file.read()
 
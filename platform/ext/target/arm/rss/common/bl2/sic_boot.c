@@ -13,7 +13,11 @@
 #include "tfm_plat_otp.h"
 #include "host_flash_atu.h"
 #include "plat_def_fip_uuid.h"
+#ifdef PLATFORM_HAS_BOOT_DMA
+#include "boot_dma.h"
+#endif /* PLATFORM_HAS_BOOT_DMA */
 
+#include <stdbool.h>
 #include <string.h>
 
 #define RSS_ATU_S_IMAGE_XIP_REGION  0
@@ -24,6 +28,19 @@
 
 #define FLASH_SIC_HTR_SIZE 0x800
 
+#ifndef RSS_SIC_PAGE_SIZE
+#define RSS_SIC_PAGE_SIZE 1024
+#endif
+
+#ifdef PLATFORM_HAS_BOOT_DMA
+/* Channels 0 and 1 are used by the flash layer */
+#define RSS_SIC_S_IMAGE_HTR_DMA_CHANNEL  2
+#define RSS_SIC_NS_IMAGE_HTR_DMA_CHANNEL 3
+
+/* Whether a HTR copy has been started on the S and NS image channels */
+static bool htr_dma_pending[2];
+#endif /* PLATFORM_HAS_BOOT_DMA */
+
 uint32_t s_image_offset;
 uint32_t ns_image_offset;
 
@@ -34,11 +51,66 @@ struct rss_xip_htr_table {
     uint8_t htr[FLASH_SIC_HTR_SIZE];
 };
 
+/* Loads the HTR of an image. With a DMA, the copy is only started, so that
+ * BL2 goes on to verify the next image while the table is copied. All the
+ * copies are waited for in sic_boot_pre_quit().
+ */
+static int sic_boot_load_htr(struct rss_xip_htr_table *table,
+                             size_t table_offset, uint32_t decrypt_region)
+{
+    enum sic_error_t sic_err;
+#ifdef PLATFORM_HAS_BOOT_DMA
+    uintptr_t htr_addr;
+    uint32_t channel;
+    int32_t rc;
+
+    channel = (decrypt_region == RSS_SIC_S_IMAGE_DECRYPT_REGION) ?
+              RSS_SIC_S_IMAGE_HTR_DMA_CHANNEL :
+              RSS_SIC_NS_IMAGE_HTR_DMA_CHANNEL;
+
+    /* Both slots of an image use the same channel */
+    if (htr_dma_pending[decrypt_region]) {
+        rc = boot_dma_wait(channel);
+        htr_dma_pending[decrypt_region] = false;
+        if (rc != 0) {
+            return 1;
+        }
+    }
+
+    sic_err = sic_auth_table_addr_get(&SIC_DEV_S, table->htr_size,
+                                      table_offset, &htr_addr);
+    if (sic_err != SIC_ERROR_NONE) {
+        return 1;
+    }
+
+    rc = boot_dma_memcpy_start((uint32_t)table->htr, (uint32_t)htr_addr,
+                               table->htr_size, channel);
+    if (rc != 0) {
+        return 1;
+    }
+    htr_dma_pending[decrypt_region] = true;
+#else
+    sic_err = sic_auth_table_set(&SIC_DEV_S, (uint32_t*)(table->htr),
+                                 table->htr_size, table_offset);
+    if (sic_err != SIC_ERROR_NONE) {
+        return 1;
+    }
+#endif /* PLATFORM_HAS_BOOT_DMA */
+
+    return 0;
+}
 
 int sic_boot_init(void)
 {
     enum sic_error_t sic_err;
 
+    /* The XIP tables are built for a fixed authentication page size, which
+     * must match the one the SIC was built with.
+     */
+    if (sic_page_size_get(&SIC_DEV_S) != RSS_SIC_PAGE_SIZE) {
+        return 1;
+    }
+
     sic_err = sic_auth_init(&SIC_DEV_S, SIC_DIGEST_SIZE_256,
                             SIC_DIGEST_COMPARE_FIRST_QWORD,
                             RSS_RUNTIME_S_XIP_BASE_S, FLASH_S_PARTITION_SIZE);
@@ -162,13 +234,11 @@ int sic_boot_post_load(uint32_t image_id, uint32_t image_load_offset)
         return 1;
     }
 
-
-    sic_err = sic_auth_table_set(&SIC_DEV_S, (uint32_t*)(table->htr),
-                                 table->htr_size, (xip_region_base_addr
-                                                   - SIC_HOST_BASE_S)
-                                                  / sic_page_size * 32);
-    if (sic_err != SIC_ERROR_NONE) {
-        return 1;
+    rc = sic_boot_load_htr(table, (xip_region_base_addr - SIC_HOST_BASE_S)
+                                  / sic_page_size * 32,
+                           decrypt_region);
+    if (rc) {
+        return rc;
     }
 
     plat_err = tfm_plat_otp_read(decrypt_key_otp_id, sizeof(key), (uint8_t*)key);
@@ -195,6 +265,21 @@ int sic_boot_post_load(uint32_t image_id, uint32_t image_load_offset)
 int sic_boot_pre_quit(struct boot_arm_vector_table **vt_cpy)
 {
     enum sic_error_t sic_err;
+#ifdef PLATFORM_HAS_BOOT_DMA
+    bool dma_failed = false;
+
+    if (htr_dma_pending[RSS_SIC_S_IMAGE_DECRYPT_REGION]) {
+        dma_failed |= boot_dma_wait(RSS_SIC_S_IMAGE_HTR_DMA_CHANNEL) != 0;
+        htr_dma_pending[RSS_SIC_S_IMAGE_DECRYPT_REGION] = false;
+    }
+    if (htr_dma_pending[RSS_SIC_NS_IMAGE_DECRYPT_REGION]) {
+        dma_failed |= boot_dma_wait(RSS_SIC_NS_IMAGE_HTR_DMA_CHANNEL) != 0;
+        htr_dma_pending[RSS_SIC_NS_IMAGE_DECRYPT_REGION] = false;
+    }
+    if (dma_failed) {
+        return 1;
+    }
+#endif /* PLATFORM_HAS_BOOT_DMA */
 
     sic_err = sic_auth_enable(&SIC_DEV_S);
     if (sic_err != SIC_ERROR_NONE) {
@@ -10,6 +10,7 @@ set(PLATFORM_DEFAULT_IMAGE_SIGNING      OFF       CACHE BOOL    "Use default ima
 
 set(MCUBOOT_S_IMAGE_FLASH_AREA_NUM      10        CACHE STRING  "ID of the flash area containing the primary Secure image")
 set(MCUBOOT_NS_IMAGE_FLASH_AREA_NUM     11        CACHE STRING  "ID of the flash area containing the primary Non-Secure image")
+set(RSS_SIC_PAGE_SIZE                   1024      CACHE STRING  "SIC authentication page size in bytes the XIP tables are built for, must match the SIC hardware. Larger pages make smaller tables but authenticate more code on each miss")
 endif()
 
 set(CRYPTO_HW_ACCELERATOR               ON         CACHE BOOL     "Whether to enable the crypto hardware accelerator on supported platforms")
@@ -24,7 +25,9 @@ set(PLATFORM_DEFAULT_ATTEST_HAL         OFF        CACHE BOOL     "Use default a
 set(PLATFORM_DEFAULT_SYSTEM_RESET_HALT  OFF        CACHE BOOL     "Use default system reset/halt implementation")
 set(PLATFORM_HAS_BOOT_DMA               ON         CACHE BOOL     "Enable dma support for memory transactions for bootloader")
 set(PLATFORM_BOOT_DMA_MIN_SIZE_REQ      0x40       CACHE STRING   "Minimum transaction size (in bytes) required to enable dma support for bootloader")
+set(PLATFORM_BOOT_DMA_READ_AHEAD_SIZE   0x400      CACHE STRING   "Largest bootloader flash read followed by a dma copy of the next block in the background, 0 to disable")
 set(PLATFORM_SVC_HANDLERS               ON         CACHE BOOL     "Platform supports custom SVC handlers")
+set(PLATFORM_DMA_COPY_MIN_SIZE          1024       CACHE STRING   "Smallest psa_read/psa_write transfer copied with DMA, calibrated for DMA-350")
 
 set(BL1                                 ON         CACHE BOOL     "Whether to build BL1")
 set(PLATFORM_DEFAULT_BL1                ON         CACHE STRING   "Whether to use default BL1 or platform-specific one")
@@ -62,12 +65,14 @@ set(TFM_NS_NV_COUNTER_AMOUNT            3          CACHE STRING   "How many NS N
 
 set(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM   ON         CACHE BOOL     "Whether to use a platform specific inter-core communication instead of mailbox in dual-cpu topology")
 set(TEST_NS_MULTI_CORE                  OFF        CACHE BOOL     "Whether to build NS regression multi-core tests")
+set(RSS_COMMS_STATS                     OFF        CACHE BOOL     "Whether to record the latency of the host PSA calls per RSS comms protocol, and log it periodically")
 
 configure_file(${CMAKE_CURRENT_LIST_DIR}/manifest/tfm_manifest_list.yaml ${CMAKE_BINARY_DIR}/tools/tfm_manifest_list.yaml)
 set(TFM_MANIFEST_LIST                   ${CMAKE_BINARY_DIR}/tools/tfm_manifest_list.yaml CACHE FILEPATH "TF-M native Secure Partition manifests list file")
 
 # Platform-specific configurations
 set(CONFIG_TFM_USE_TRUSTZONE            OFF)
+set(PLATFORM_HAS_DMA_COPY               ON)
 set(TFM_MULTI_CORE_TOPOLOGY             ON)
 set(MCUBOOT_DATA_SHARING                ON)
 set(TFM_PARTITION_MEASURED_BOOT         ON)
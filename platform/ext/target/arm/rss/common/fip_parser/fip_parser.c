@@ -84,3 +84,67 @@ int fip_get_entry_by_uuid(uint32_t fip_base, uint32_t atu_slot_size, uuid_t uuid
     /* UUID not found, return error. */
     return 3;
 }
+
+int fip_get_toc_entries(uint32_t fip_base, uint32_t atu_slot_size,
+                        fip_toc_entry_t *entries, size_t max_entries,
+                        size_t *num_entries)
+{
+    ARM_FLASH_CAPABILITIES DriverCapabilities = FLASH_DEV_NAME.GetCapabilities();
+    /* Valid entries for data item width */
+    uint32_t data_width_byte[] = {
+        sizeof(uint8_t),
+        sizeof(uint16_t),
+        sizeof(uint32_t),
+    };
+    size_t data_width = data_width_byte[DriverCapabilities.data_width];
+    int rc;
+    uint32_t idx = 0;
+    size_t count = 0;
+    fip_toc_header_t toc_header;
+    fip_toc_entry_t toc_entry;
+    uuid_t null_uuid;
+
+    /* The NULL UUID is all-zeroes */
+    memset(&null_uuid, 0, sizeof(null_uuid));
+
+    rc = FLASH_DEV_NAME.ReadData(fip_base - FLASH_BASE_ADDRESS, &toc_header,
+                                 sizeof(toc_header) / data_width);
+    if (rc != sizeof(toc_header) / data_width) {
+        return rc;
+    }
+
+    if (toc_header.name != TOC_HEADER_NAME) {
+        return 2;
+    }
+
+    idx += sizeof(toc_header);
+
+    for (;;) {
+        /* Prevent reading out of bounds */
+        if (idx + sizeof(toc_entry) > atu_slot_size) {
+            return 3;
+        }
+
+        rc = FLASH_DEV_NAME.ReadData(fip_base + idx - FLASH_BASE_ADDRESS,
+                                     &toc_entry, sizeof(toc_entry) / data_width);
+        if (rc != sizeof(toc_entry) / data_width) {
+            return rc;
+        }
+
+        /* The FIP's TOC ends in an entry with a NULL UUID */
+        if (!memcmp(&null_uuid, &toc_entry.uuid, sizeof(uuid_t))) {
+            break;
+        }
+
+        if (count >= max_entries) {
+            return 4;
+        }
+
+        entries[count++] = toc_entry;
+        idx += sizeof(toc_entry);
+    }
+
+    *num_entries = count;
+
+    return 0;
+}
@@ -36,6 +36,30 @@ extern "C" {
 int fip_get_entry_by_uuid(uint32_t fip_base, uint32_t atu_slot_size, uuid_t uuid,
                           uint64_t *offset, size_t *size);
 
+/**
+ * \brief                    Parse a FIP and copy all the entries of its TOC,
+ *                           so that they can be looked up without reading the
+ *                           FIP again.
+ *
+ * \param[in]  fip_base      The RSS address mapped to the FIP base address in
+ *                           host flash.
+ * \param[in]  atu_slot_size The size of the ATU region that was mapped for
+ *                           access to this FIP. This is used to prevent reads
+ *                           outside the mapped region.
+ * \param[out] entries       Buffer the TOC entries are copied to. The entry
+ *                           with the NULL UUID that ends the TOC is not copied.
+ * \param[in]  max_entries   The number of entries that fit in the buffer.
+ *
+ * \param[out] num_entries   The number of entries copied.
+ *
+ * \return                   0 if operation completed successfully, another
+ *                           value on error, including when the TOC has more
+ *                           than max_entries entries.
+ */
+int fip_get_toc_entries(uint32_t fip_base, uint32_t atu_slot_size,
+                        fip_toc_entry_t *entries, size_t max_entries,
+                        size_t *num_entries);
+
 #ifdef __cplusplus
 }
 #endif
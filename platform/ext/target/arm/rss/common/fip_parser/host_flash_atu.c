@@ -23,6 +23,31 @@
 #define RSS_ATU_REGION_OUTPUT_IMAGE_SLOT   5
 #define RSS_ATU_REGION_OUTPUT_HEADER_SLOT  6
 
+#ifndef HOST_FLASH_FIP_TOC_CACHE_ENTRIES
+#define HOST_FLASH_FIP_TOC_CACHE_ENTRIES   16
+#endif
+
+/* The GPT and the FIP TOCs are read through the temporary ATU slot, which has
+ * to be set up again for every access. They don't change during a boot stage,
+ * so they are only parsed once and later lookups are served from RAM. A FIP
+ * whose TOC doesn't fit in the cache is looked up in flash every time.
+ */
+struct fip_toc_cache_t {
+    bool valid;
+    uint64_t fip_offset;
+    size_t num_entries;
+    fip_toc_entry_t entries[HOST_FLASH_FIP_TOC_CACHE_ENTRIES];
+};
+
+static struct fip_toc_cache_t fip_toc_cache[2];
+static uint32_t fip_toc_cache_next;
+
+#ifdef RSS_GPT_SUPPORT
+static bool fip_offsets_cached;
+static bool cached_fip_found[2];
+static uint64_t cached_fip_offsets[2];
+#endif /* RSS_GPT_SUPPORT */
+
 static inline uint32_t round_down(uint32_t num, uint32_t boundary)
 {
     return num - (num % boundary);
@@ -70,13 +95,102 @@ static int setup_aligned_atu_slot(uint64_t physical_address, uint32_t size,
     return 0;
 }
 
+static struct fip_toc_cache_t *fip_toc_cache_find(uint64_t fip_offset)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < sizeof(fip_toc_cache) / sizeof(fip_toc_cache[0]);
+         idx++) {
+        if (fip_toc_cache[idx].valid &&
+            fip_toc_cache[idx].fip_offset == fip_offset) {
+            return &fip_toc_cache[idx];
+        }
+    }
+
+    return NULL;
+}
+
+static int fip_toc_cache_lookup(uint64_t fip_offset, uuid_t image_uuid,
+                                uint64_t *region_offset, size_t *region_size)
+{
+    enum atu_error_t err;
+    struct fip_toc_cache_t *cache;
+    uint64_t physical_address = HOST_FLASH0_BASE + fip_offset;
+    uint32_t alignment_offset;
+    size_t atu_slot_size;
+    size_t page_size = get_page_size(&ATU_DEV_S);
+    size_t idx;
+    int rc;
+
+    cache = fip_toc_cache_find(fip_offset);
+    if (cache == NULL) {
+        /* There's no way to tell how big the FIP TOC will be before reading
+         * it, so we just map 0x1000.
+         */
+        rc = setup_aligned_atu_slot(physical_address, 0x1000, page_size,
+                                    RSS_ATU_REGION_TEMP_SLOT,
+                                    HOST_FLASH0_TEMP_BASE_S, &alignment_offset,
+                                    &atu_slot_size);
+        if (rc) {
+            return rc;
+        }
+
+        cache = &fip_toc_cache[fip_toc_cache_next];
+        cache->valid = false;
+
+        rc = fip_get_toc_entries(HOST_FLASH0_TEMP_BASE_S + alignment_offset,
+                                 atu_slot_size - alignment_offset,
+                                 cache->entries,
+                                 HOST_FLASH_FIP_TOC_CACHE_ENTRIES,
+                                 &cache->num_entries);
+        if (rc == 0) {
+            cache->valid = true;
+            cache->fip_offset = fip_offset;
+            fip_toc_cache_next = (fip_toc_cache_next + 1) %
+                           (sizeof(fip_toc_cache) / sizeof(fip_toc_cache[0]));
+        } else {
+            /* The TOC may just be too big for the cache */
+            rc = fip_get_entry_by_uuid(HOST_FLASH0_TEMP_BASE_S + alignment_offset,
+                                       atu_slot_size - alignment_offset,
+                                       image_uuid, region_offset, region_size);
+        }
+
+        err = atu_uninitialize_region(&ATU_DEV_S, RSS_ATU_REGION_TEMP_SLOT);
+        if (err != ATU_ERR_NONE) {
+            return 1;
+        }
+
+        if (!cache->valid) {
+            return rc;
+        }
+    }
+
+    for (idx = 0; idx < cache->num_entries; idx++) {
+        if (!memcmp(&image_uuid, &cache->entries[idx].uuid, sizeof(uuid_t))) {
+            /* Partitions greater than UINT32_MAX aren't wholly mappable into
+             * the RSS memory space, see fip_get_entry_by_uuid().
+             */
+            if (cache->entries[idx].size > UINT32_MAX) {
+                return 1;
+            }
+
+            *region_offset = cache->entries[idx].offset_address;
+            *region_size = (uint32_t)cache->entries[idx].size;
+
+            return 0;
+        }
+    }
+
+    /* UUID not found, return error. */
+    return 3;
+}
+
 int host_flash_atu_setup_image_input_slots_from_fip(uint64_t fip_offset,
                                                     uint32_t slot,
                                                     uintptr_t logical_address,
                                                     uuid_t image_uuid,
                                                     uint32_t *logical_address_offset)
 {
-    enum atu_error_t err;
     int rc;
     uint64_t region_offset;
     size_t region_size;
@@ -85,29 +199,12 @@ int host_flash_atu_setup_image_input_slots_from_fip(uint64_t fip_offset,
     size_t atu_slot_size;
     size_t page_size = get_page_size(&ATU_DEV_S);
 
-    /* There's no way to tell how big the FIP TOC will be before reading it, so
-     * we just map 0x1000.
-     */
-    rc = setup_aligned_atu_slot(physical_address, 0x1000, page_size,
-                                RSS_ATU_REGION_TEMP_SLOT,
-                                HOST_FLASH0_TEMP_BASE_S, &alignment_offset,
-                                &atu_slot_size);
+    rc = fip_toc_cache_lookup(fip_offset, image_uuid, &region_offset,
+                              &region_size);
     if (rc) {
         return rc;
     }
 
-    rc = fip_get_entry_by_uuid(HOST_FLASH0_TEMP_BASE_S + alignment_offset,
-                               atu_slot_size - alignment_offset,
-                               image_uuid, &region_offset, &region_size);
-    if (rc) {
-        return rc;
-    }
-
-    err = atu_uninitialize_region(&ATU_DEV_S, RSS_ATU_REGION_TEMP_SLOT);
-    if (err != ATU_ERR_NONE) {
-        return 1;
-    }
-
     /* Initialize primary input region */
     rc = setup_aligned_atu_slot(physical_address + region_offset, region_size,
                                 page_size, slot, logical_address,
@@ -135,6 +232,12 @@ int host_flash_atu_get_fip_offsets(bool fip_found[2], uint64_t fip_offsets[2])
 #endif /* RSS_GPT_SUPPORT */
 
 #ifdef RSS_GPT_SUPPORT
+    if (fip_offsets_cached) {
+        memcpy(fip_found, cached_fip_found, sizeof(cached_fip_found));
+        memcpy(fip_offsets, cached_fip_offsets, sizeof(cached_fip_offsets));
+        return 0;
+    }
+
     physical_address = HOST_FLASH0_BASE + FLASH_LBA_SIZE;
     rc = setup_aligned_atu_slot(physical_address, FLASH_LBA_SIZE,
                                 page_size, RSS_ATU_REGION_TEMP_SLOT,
@@ -196,6 +299,10 @@ int host_flash_atu_get_fip_offsets(bool fip_found[2], uint64_t fip_offsets[2])
     if (err != ATU_ERR_NONE) {
         return 1;
     }
+
+    memcpy(cached_fip_found, fip_found, sizeof(cached_fip_found));
+    memcpy(cached_fip_offsets, fip_offsets, sizeof(cached_fip_offsets));
+    fip_offsets_cached = true;
 #else
     fip_found[0] = true;
     fip_offsets[0] = FLASH_FIP_A_OFFSET;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022 Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023 Arm Limited. All rights reserved.
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -361,6 +361,31 @@ enum sic_error_t sic_auth_table_set(struct sic_dev_t *dev, uint32_t *data,
     return SIC_ERROR_NONE;
 }
 
+enum sic_error_t sic_auth_table_addr_get(struct sic_dev_t *dev,
+                                         size_t data_len_bytes,
+                                         size_t table_offset,
+                                         uintptr_t *addr)
+{
+    struct _sic_reg_map_t* p_sic = (struct _sic_reg_map_t*)dev->cfg->base;
+
+    /* The tables cannot be written while the SIC is enabled */
+    if (is_sic_enabled(dev)) {
+        return SIC_ERROR_INVALID_OP_WHILE_ENABLED;
+    }
+
+    if (table_offset & 0x3u) {
+        return SIC_ERROR_INVALID_ALIGNMENT;
+    }
+
+    if (table_offset + data_len_bytes >= (sic_page_count_get(dev) * 32)) {
+        return SIC_ERROR_INVALID_ADDRESS;
+    }
+
+    *addr = (uintptr_t)&p_sic->htr[table_offset / 4];
+
+    return SIC_ERROR_NONE;
+}
+
 enum sic_error_t sic_decrypt_init(struct sic_dev_t *dev,
                                   enum sic_decrypt_keysize_t decrypt_keysize,
                                   bool decrypt_padding_enable)
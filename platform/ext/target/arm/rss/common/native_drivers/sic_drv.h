@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
@@ -310,6 +310,27 @@ enum sic_error_t sic_auth_axim_cfg_get(struct sic_dev_t *dev,
 enum sic_error_t sic_auth_table_set(struct sic_dev_t *dev, uint32_t *data,
                                     size_t data_len_bytes, size_t table_offset);
 
+/**
+ * \brief                    Get the address of part of the SIC HTR, so that it
+ *                           can be loaded by a DMA instead of by
+ *                           \ref sic_auth_table_set. The same checks are made.
+ *
+ * \param[in]  dev           The SIC device.
+ *
+ * \param[in] data_len       The size of the data that will be loaded into the
+ *                           HTR in bytes.
+ * \param[in] table_offset   The offset (in bytes) into the HTR that the data
+ *                           will be loaded to.
+ * \param[out] addr          The address the data must be copied to.
+ *
+ * \return                   SIC_ERROR_NONE on success, otherwise a different
+ *                           sic_error_t.
+ */
+enum sic_error_t sic_auth_table_addr_get(struct sic_dev_t *dev,
+                                         size_t data_len_bytes,
+                                         size_t table_offset,
+                                         uintptr_t *addr);
+
 /**
  * \brief                             Setup the SIC decryption engine.
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -25,13 +25,57 @@
 #define NV_COUNTER_SIZE         4
 #define OTP_COUNTER_MAGIC       0x3333CAFE
 
+/* The counters are read from OTP the first time they are accessed and kept in
+ * RAM afterwards. All writes go through to the OTP before the copy is updated.
+ */
+static uint32_t nv_counter_shadow[PLAT_NV_COUNTER_MAX];
+static uint32_t nv_counter_shadow_valid;
+
 enum tfm_plat_err_t tfm_plat_init_nv_counter(void)
 {
     return TFM_PLAT_ERR_SUCCESS;
 }
 
+static enum tfm_plat_err_t get_otp_id(enum tfm_nv_counter_t counter_id,
+                                      enum tfm_otp_element_id_t *id)
+{
+    switch(counter_id) {
+    case (PLAT_NV_COUNTER_BL2_0):
+        *id = PLAT_OTP_ID_NV_COUNTER_BL2_0;
+        break;
+    case (PLAT_NV_COUNTER_BL2_1):
+        *id = PLAT_OTP_ID_NV_COUNTER_BL2_1;
+        break;
+    case (PLAT_NV_COUNTER_BL2_2):
+        *id = PLAT_OTP_ID_NV_COUNTER_BL2_2;
+        break;
+    case (PLAT_NV_COUNTER_BL2_3):
+        *id = PLAT_OTP_ID_NV_COUNTER_BL2_3;
+        break;
+
+    case (PLAT_NV_COUNTER_NS_0):
+        *id = PLAT_OTP_ID_NV_COUNTER_NS_0;
+        break;
+    case (PLAT_NV_COUNTER_NS_1):
+        *id = PLAT_OTP_ID_NV_COUNTER_NS_1;
+        break;
+    case (PLAT_NV_COUNTER_NS_2):
+        *id = PLAT_OTP_ID_NV_COUNTER_NS_2;
+        break;
+
+    case (PLAT_NV_COUNTER_BL1_0):
+        *id = PLAT_OTP_ID_NV_COUNTER_BL1_0;
+        break;
+
+    default:
+        return TFM_PLAT_ERR_UNSUPPORTED;
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
 static enum tfm_plat_err_t read_nv_counter_otp(enum tfm_otp_element_id_t id,
-                                               uint8_t *val)
+                                               uint32_t *val)
 {
     size_t counter_size;
     enum tfm_plat_err_t err;
@@ -63,7 +107,34 @@ static enum tfm_plat_err_t read_nv_counter_otp(enum tfm_otp_element_id_t id,
         }
     }
 
-    memcpy(val, &count, NV_COUNTER_SIZE);
+    *val = count;
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+static enum tfm_plat_err_t read_nv_counter(enum tfm_nv_counter_t counter_id,
+                                           uint32_t *val)
+{
+    enum tfm_otp_element_id_t id;
+    enum tfm_plat_err_t err;
+
+    err = get_otp_id(counter_id, &id);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+    if (nv_counter_shadow_valid & (1u << counter_id)) {
+        *val = nv_counter_shadow[counter_id];
+        return TFM_PLAT_ERR_SUCCESS;
+    }
+
+    err = read_nv_counter_otp(id, val);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
+    nv_counter_shadow[counter_id] = *val;
+    nv_counter_shadow_valid |= (1u << counter_id);
 
     return TFM_PLAT_ERR_SUCCESS;
 }
@@ -71,42 +142,29 @@ static enum tfm_plat_err_t read_nv_counter_otp(enum tfm_otp_element_id_t id,
 enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
                                              uint32_t size, uint8_t *val)
 {
+    enum tfm_plat_err_t err;
+    uint32_t count;
+
     if (size != NV_COUNTER_SIZE) {
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
 
-    switch(counter_id) {
-    case (PLAT_NV_COUNTER_BL2_0):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_0, val);
-    case (PLAT_NV_COUNTER_BL2_1):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_1, val);
-    case (PLAT_NV_COUNTER_BL2_2):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_2, val);
-    case (PLAT_NV_COUNTER_BL2_3):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_3, val);
-
-    case (PLAT_NV_COUNTER_NS_0):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_NS_0, val);
-    case (PLAT_NV_COUNTER_NS_1):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_NS_1, val);
-    case (PLAT_NV_COUNTER_NS_2):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_NS_2, val);
+    err = read_nv_counter(counter_id, &count);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
 
-    case (PLAT_NV_COUNTER_BL1_0):
-        return read_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL1_0, val);
+    memcpy(val, &count, NV_COUNTER_SIZE);
 
-    default:
-        return TFM_PLAT_ERR_UNSUPPORTED;
-    }
+    return TFM_PLAT_ERR_SUCCESS;
 }
 
-static enum tfm_plat_err_t set_nv_counter_otp(enum tfm_otp_element_id_t id,
-                                              uint32_t value)
+static enum tfm_plat_err_t check_nv_counter_otp_value(
+                                                enum tfm_otp_element_id_t id,
+                                                uint32_t value)
 {
     size_t counter_size;
     enum tfm_plat_err_t err;
-    size_t idx;
-    uint32_t counter_value[OTP_COUNTER_MAX_SIZE / sizeof(uint32_t)] = {0};
 
     err = tfm_plat_otp_get_size(id, &counter_size);
     if (err != TFM_PLAT_ERR_SUCCESS) {
@@ -120,6 +178,21 @@ static enum tfm_plat_err_t set_nv_counter_otp(enum tfm_otp_element_id_t id,
         return TFM_PLAT_ERR_MAX_VALUE;
     }
 
+    return TFM_PLAT_ERR_SUCCESS;
+}
+
+static enum tfm_plat_err_t set_nv_counter_otp(enum tfm_otp_element_id_t id,
+                                              uint32_t value)
+{
+    enum tfm_plat_err_t err;
+    size_t idx;
+    uint32_t counter_value[OTP_COUNTER_MAX_SIZE / sizeof(uint32_t)] = {0};
+
+    err = check_nv_counter_otp_value(id, value);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
+
     for (idx = 0; idx < value; idx++) {
         counter_value[idx] = OTP_COUNTER_MAGIC;
     }
@@ -133,29 +206,25 @@ static enum tfm_plat_err_t set_nv_counter_otp(enum tfm_otp_element_id_t id,
 enum tfm_plat_err_t tfm_plat_set_nv_counter(enum tfm_nv_counter_t counter_id,
                                             uint32_t value)
 {
-    switch(counter_id) {
-    case (PLAT_NV_COUNTER_BL2_0):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_0, value);
-    case (PLAT_NV_COUNTER_BL2_1):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_1, value);
-    case (PLAT_NV_COUNTER_BL2_2):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_2, value);
-    case (PLAT_NV_COUNTER_BL2_3):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL2_3, value);
-
-    case (PLAT_NV_COUNTER_NS_0):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_NS_0, value);
-    case (PLAT_NV_COUNTER_NS_1):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_NS_1, value);
-    case (PLAT_NV_COUNTER_NS_2):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_NS_2, value);
+    enum tfm_otp_element_id_t id;
+    enum tfm_plat_err_t err;
 
-    case (PLAT_NV_COUNTER_BL1_0):
-        return set_nv_counter_otp(PLAT_OTP_ID_NV_COUNTER_BL1_0, value);
+    err = get_otp_id(counter_id, &id);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return err;
+    }
 
-    default:
-        return TFM_PLAT_ERR_UNSUPPORTED;
+    err = set_nv_counter_otp(id, value);
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        /* The OTP may have been partially written, so read it again */
+        nv_counter_shadow_valid &= ~(1u << counter_id);
+        return err;
     }
+
+    nv_counter_shadow[counter_id] = value;
+    nv_counter_shadow_valid |= (1u << counter_id);
+
+    return TFM_PLAT_ERR_SUCCESS;
 }
 
 enum tfm_plat_err_t tfm_plat_increment_nv_counter(
@@ -164,9 +233,7 @@ enum tfm_plat_err_t tfm_plat_increment_nv_counter(
     uint32_t security_cnt;
     enum tfm_plat_err_t err;
 
-    err = tfm_plat_read_nv_counter(counter_id,
-                                   sizeof(security_cnt),
-                                   (uint8_t *)&security_cnt);
+    err = read_nv_counter(counter_id, &security_cnt);
     if (err != TFM_PLAT_ERR_SUCCESS) {
         return err;
     }
@@ -177,3 +244,48 @@ enum tfm_plat_err_t tfm_plat_increment_nv_counter(
 
     return tfm_plat_set_nv_counter(counter_id, security_cnt + 1u);
 }
+
+enum tfm_plat_err_t tfm_plat_increment_nv_counters(
+                                     const enum tfm_nv_counter_t *counter_ids,
+                                     uint32_t num_counters)
+{
+    enum tfm_otp_element_id_t id;
+    enum tfm_plat_err_t err;
+    uint32_t security_cnt;
+    uint32_t idx;
+
+    /* Each counter is a separate OTP element, so the writes can't be merged.
+     * All the counters are checked first so that none of them is incremented
+     * if one has reached its maximum value.
+     */
+    for (idx = 0; idx < num_counters; idx++) {
+        err = get_otp_id(counter_ids[idx], &id);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+
+        err = read_nv_counter(counter_ids[idx], &security_cnt);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+
+        if (security_cnt == UINT32_MAX) {
+            return TFM_PLAT_ERR_MAX_VALUE;
+        }
+
+        err = check_nv_counter_otp_value(id, security_cnt + 1u);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+    }
+
+    for (idx = 0; idx < num_counters; idx++) {
+        err = tfm_plat_set_nv_counter(counter_ids[idx],
+                                      nv_counter_shadow[counter_ids[idx]] + 1u);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
@@ -16,8 +16,14 @@
 extern "C" {
 #endif
 
- /* size suits to get_attest_token() */
+/*
+ * Size suits to get_attest_token(). Builds passing large buffers with the
+ * pointer access protocol can reduce it, which shrinks the static message
+ * buffers and every client request.
+ */
+#ifndef RSS_COMMS_PAYLOAD_MAX_SIZE
 #define RSS_COMMS_PAYLOAD_MAX_SIZE (0x40 + 0x800)
+#endif
 
 /*
  * Allocated for each client request.
@@ -41,6 +47,10 @@ struct client_request_t {
     uint64_t out_vec_host_addr[PSA_MAX_IOVEC];
     uint8_t param_copy_buf[RSS_COMMS_PAYLOAD_MAX_SIZE];
     comms_atu_region_set_t atu_regions;
+#ifdef RSS_COMMS_STATS
+    uint32_t rx_cycles;   /* Cycle count when the message was received */
+    uint32_t msg_len;     /* Size of the received message */
+#endif
 };
 
 #ifdef __cplusplus
@@ -6,6 +6,9 @@
  */
 
 #include "rss_comms_atu.h"
+
+#include <stdbool.h>
+
 #include "atu_rss_drv.h"
 #include "tfm_spm_log.h"
 #include "device_definition.h"
@@ -17,11 +20,20 @@ struct comms_atu_region_params_t {
     uint32_t size;
     uint8_t region;
     uint32_t ref_count;
+    bool mapped;
+    uint32_t last_use;
 };
 
 /* ATU config */
 static struct comms_atu_region_params_t atu_regions[RSS_COMMS_ATU_REGION_AM] = {0};
 
+/*
+ * A region whose last reference is freed stays mapped, as hosts tend to pass
+ * the same buffers again. It is only reprogrammed when no unmapped region is
+ * left, picking the least recently used one.
+ */
+static uint32_t atu_use_stamp;
+
 static inline uint64_t round_down(uint64_t num, uint64_t boundary)
 {
     return num - (num % boundary);
@@ -49,7 +61,7 @@ static enum tfm_plat_err_t get_region_idx_from_host_buf(uint64_t host_addr,
     for (idx = 0; idx < RSS_COMMS_ATU_REGION_AM; idx++) {
         region = &atu_regions[idx];
 
-        if (atu_regions[idx].ref_count > 0 &&
+        if (region->mapped &&
             host_addr >= region->phys_addr &&
             host_addr + size <= region->phys_addr + region->size) {
             *region_idx = idx;
@@ -80,15 +92,40 @@ enum tfm_plat_err_t comms_atu_get_rss_ptr_from_host_addr(uint8_t region,
 
 static int get_free_region_idx(uint32_t *region_idx) {
     uint32_t idx;
+    uint32_t lru_idx = RSS_COMMS_ATU_REGION_AM;
+    int32_t atu_err;
+
+    for (idx = 0; idx < RSS_COMMS_ATU_REGION_AM; idx++) {
+        if (atu_regions[idx].ref_count > 0) {
+            continue;
+        }
 
-    for (idx = 0; idx <= RSS_COMMS_ATU_REGION_AM; idx++) {
-        if (atu_regions[idx].ref_count == 0) {
+        if (!atu_regions[idx].mapped) {
             *region_idx = idx;
             return TFM_PLAT_ERR_SUCCESS;
         }
+
+        if (lru_idx == RSS_COMMS_ATU_REGION_AM ||
+            (atu_use_stamp - atu_regions[idx].last_use) >
+            (atu_use_stamp - atu_regions[lru_idx].last_use)) {
+            lru_idx = idx;
+        }
+    }
+
+    if (lru_idx == RSS_COMMS_ATU_REGION_AM) {
+        return TFM_PLAT_ERR_MAX_VALUE;
+    }
+
+    /* Evict the least recently used cached region */
+    atu_err = atu_uninitialize_region(&ATU_DEV_S, atu_regions[lru_idx].region);
+    if (atu_err) {
+        return TFM_PLAT_ERR_SYSTEM_ERR;
     }
+    atu_regions[lru_idx].mapped = false;
+    SPMLOG_DBGMSGVAL("[COMMS ATU] Evicting region: ", lru_idx);
 
-    return TFM_PLAT_ERR_MAX_VALUE;
+    *region_idx = lru_idx;
+    return TFM_PLAT_ERR_SUCCESS;
 }
 
 static enum tfm_plat_err_t setup_region_for_host_buf(uint64_t host_addr,
@@ -123,6 +160,7 @@ static enum tfm_plat_err_t setup_region_for_host_buf(uint64_t host_addr,
     if (atu_err) {
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
+    region_params->mapped = true;
 
     SPMLOG_DBGMSGVAL("[COMMS ATU] Mapping new region: ", region_idx);
     SPMLOG_DBGMSGVAL("[COMMS ATU] Region start: ", region_params->phys_addr);
@@ -151,6 +189,7 @@ enum tfm_plat_err_t comms_atu_alloc_region(uint64_t host_addr, uint32_t size,
     }
 
     atu_regions[region_idx].ref_count++;
+    atu_regions[region_idx].last_use = ++atu_use_stamp;
 
     *region = region_idx;
 
@@ -159,46 +198,33 @@ enum tfm_plat_err_t comms_atu_alloc_region(uint64_t host_addr, uint32_t size,
 
 enum tfm_plat_err_t comms_atu_free_region(uint8_t region)
 {
-    int32_t atu_err;
-    struct comms_atu_region_params_t *region_params;
-
     if (region >= RSS_COMMS_ATU_REGION_AM) {
         return TFM_PLAT_ERR_INVALID_INPUT;
     }
 
-    atu_regions[region].ref_count--;
-    region_params = &atu_regions[region];
-
     if (atu_regions[region].ref_count == 0) {
-        atu_err = atu_uninitialize_region(&ATU_DEV_S, region_params->region);
-        if (atu_err) {
-            return TFM_PLAT_ERR_SYSTEM_ERR;
-        }
-        SPMLOG_DBGMSGVAL("[COMMS ATU] Deallocating region: ", region);
+        return TFM_PLAT_ERR_INVALID_INPUT;
     }
 
+    /* The region is kept mapped for reuse once unreferenced */
+    atu_regions[region].ref_count--;
+
     return TFM_PLAT_ERR_SUCCESS;
 }
 
 enum tfm_plat_err_t comms_atu_free_regions(comms_atu_region_set_t regions)
 {
     uint32_t region_idx;
-    int32_t atu_err;
-    struct comms_atu_region_params_t *region_params;
 
     for (region_idx = 0; region_idx < RSS_COMMS_ATU_REGION_AM; region_idx++) {
         if ((regions.ref_counts[region_idx]) > 0) {
-            atu_regions[region_idx].ref_count -= regions.ref_counts[region_idx];
-            region_params = &atu_regions[region_idx];
-
-            if (atu_regions[region_idx].ref_count == 0) {
-                atu_err = atu_uninitialize_region(&ATU_DEV_S,
-                                                  region_params->region);
-                if (atu_err) {
-                    return TFM_PLAT_ERR_SYSTEM_ERR;
-                }
-                SPMLOG_DBGMSGVAL("[COMMS ATU] Deallocating region: ", region_idx);
+            if (atu_regions[region_idx].ref_count <
+                regions.ref_counts[region_idx]) {
+                return TFM_PLAT_ERR_INVALID_INPUT;
             }
+
+            /* The region is kept mapped for reuse once unreferenced */
+            atu_regions[region_idx].ref_count -= regions.ref_counts[region_idx];
         }
     }
 
@@ -39,14 +39,15 @@ enum tfm_plat_err_t comms_atu_alloc_region(uint64_t host_addr, uint32_t size,
                                            uint8_t *region);
 
 /* Decrease the regerence count to the particular region. If this is the last
- * reference to that region, uninitialise it and return it to the pool that can
- * be allocated.
+ * reference to that region, it stays mapped so that a later buffer in the same
+ * host range reuses it. Unreferenced regions are evicted least recently used
+ * first when a new region is needed.
  */
 enum tfm_plat_err_t comms_atu_free_region(uint8_t region);
 
 /* For each region in the set, decrease the reference count to the region by the
- * reference count in the set. If this causes any regions to have no references,
- * uninitialise the regions and return them to the pool that can be allocated.
+ * reference count in the set. Regions left with no references stay mapped for
+ * reuse, as in comms_atu_free_region().
  */
 enum tfm_plat_err_t comms_atu_free_regions(comms_atu_region_set_t regions);
 
@@ -10,6 +10,8 @@
 #include "rss_comms.h"
 #include "rss_comms_queue.h"
 #include "mhu.h"
+#include "cmsis.h"
+#include "cycle_counter.h"
 #include "device_definition.h"
 #include "tfm_spm_log.h"
 #include "tfm_pools.h"
@@ -25,6 +27,60 @@ static __ALIGNED(4) struct serialized_psa_reply_t reply;
 TFM_POOL_DECLARE(req_pool, sizeof(struct client_request_t),
                  RSS_COMMS_MAX_CONCURRENT_REQ);
 
+#ifdef RSS_COMMS_STATS
+/* One entry for each of the embed and the pointer access protocols */
+#define RSS_COMMS_STATS_PROTOCOLS 2
+
+static struct rss_comms_stats_t stats[RSS_COMMS_STATS_PROTOCOLS];
+
+static void stats_log(uint8_t protocol_ver, const struct rss_comms_stats_t *s)
+{
+    uint32_t i;
+
+    SPMLOG_INFMSGVAL("[COMMS] Stats for protocol ", protocol_ver);
+    SPMLOG_INFMSGVAL("[COMMS] calls=", s->calls);
+    SPMLOG_INFMSGVAL("[COMMS] bytes=", s->bytes);
+    SPMLOG_INFMSGVAL("[COMMS] mean_cycles=", (uint32_t)(s->cycles / s->calls));
+    SPMLOG_INFMSGVAL("[COMMS] max_cycles=", s->max_cycles);
+    for (i = 0; i < RSS_COMMS_STATS_BUCKETS; i++) {
+        if (s->buckets[i] != 0) {
+            SPMLOG_INFMSGVAL("[COMMS] log2_cycles=", i);
+            SPMLOG_INFMSGVAL("[COMMS]   calls=", s->buckets[i]);
+        }
+    }
+}
+
+static void stats_record(const struct client_request_t *req)
+{
+    struct rss_comms_stats_t *s;
+    uint32_t cycles;
+    uint32_t bucket;
+
+    if (req->protocol_ver >= RSS_COMMS_STATS_PROTOCOLS) {
+        return;
+    }
+
+    cycles = cycle_counter_read() - req->rx_cycles;
+    bucket = (cycles == 0) ? 0 : (31 - __CLZ(cycles));
+    if (bucket >= RSS_COMMS_STATS_BUCKETS) {
+        bucket = RSS_COMMS_STATS_BUCKETS - 1;
+    }
+
+    s = &stats[req->protocol_ver];
+    s->calls++;
+    s->bytes += req->msg_len;
+    s->cycles += cycles;
+    if (cycles > s->max_cycles) {
+        s->max_cycles = cycles;
+    }
+    s->buckets[bucket]++;
+
+    if ((s->calls % RSS_COMMS_STATS_LOG_PERIOD) == 0) {
+        stats_log(req->protocol_ver, s);
+    }
+}
+#endif /* RSS_COMMS_STATS */
+
 static enum tfm_plat_err_t initialize_mhu(void)
 {
     enum mhu_error_t err;
@@ -53,8 +109,15 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
     size_t msg_len = sizeof(msg);
     size_t reply_size;
 
-    memset(&msg, 0, sizeof(msg));
-    memset(&reply, 0, sizeof(reply));
+    /*
+     * The protocols never read past msg_len and the reply is cleared when it
+     * is serialized, so only the header used by an error reply is cleared.
+     */
+    memset(&msg.header, 0, sizeof(msg.header));
+
+#ifdef RSS_COMMS_STATS
+    uint32_t rx_cycles = cycle_counter_read();
+#endif
 
     /* Receive complete message */
     mhu_err = mhu_receive_data(mhu_receiver_dev, (uint8_t *)&msg, &msg_len);
@@ -84,9 +147,17 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
 
     /* Record the MHU sender device to be used for the reply */
     req->mhu_sender_dev = mhu_sender_dev;
+#ifdef RSS_COMMS_STATS
+    req->rx_cycles = rx_cycles;
+    req->msg_len = msg_len;
+#endif
 
     if (queue_enqueue(req) != 0) {
+        struct queue_stats_t stats;
+
         /* No queue capacity, drop message */
+        queue_get_stats(&stats);
+        SPMLOG_DBGMSGVAL("[COMMS] Queue full, dropped=", stats.dropped);
         err = TFM_PLAT_ERR_SYSTEM_ERR;
         goto out_free_req;
     }
@@ -135,6 +206,9 @@ enum tfm_plat_err_t tfm_multi_core_hal_reply(struct client_request_t *req)
     }
 
     SPMLOG_DBGMSG("[COMMS] Sent reply\r\n");
+#ifdef RSS_COMMS_STATS
+    stats_record(req);
+#endif
 
 out:
     tfm_pool_free(req_pool, req);
@@ -152,5 +226,9 @@ enum tfm_plat_err_t tfm_multi_core_hal_init(void)
         return TFM_PLAT_ERR_SYSTEM_ERR;
     }
 
+#ifdef RSS_COMMS_STATS
+    cycle_counter_enable();
+#endif
+
     return initialize_mhu();
 }
@@ -47,6 +47,35 @@ enum tfm_plat_err_t tfm_multi_core_hal_receive(void *mhu_receiver_dev,
  */
 enum tfm_plat_err_t tfm_multi_core_hal_reply(struct client_request_t *req);
 
+#ifdef RSS_COMMS_STATS
+/* Number of latency buckets, bucket n counts the calls of [2^n, 2^(n+1)) cycles */
+#define RSS_COMMS_STATS_BUCKETS 24
+
+/* Number of replies of a protocol between two logs of its statistics */
+#ifndef RSS_COMMS_STATS_LOG_PERIOD
+#define RSS_COMMS_STATS_LOG_PERIOD 1024
+#endif
+
+#if RSS_COMMS_STATS_LOG_PERIOD == 0
+#error "RSS_COMMS_STATS_LOG_PERIOD must be non-zero, the statistics are only logged"
+#endif
+
+/*
+ * Statistics of the calls made with one protocol, logged through the SPM log.
+ * The latency of a call is measured in CPU cycles, from the reception of the
+ * message until its reply is sent, and the percentiles can be derived from
+ * the histogram.
+ */
+struct rss_comms_stats_t {
+    uint32_t calls;         /* Replies sent */
+    uint32_t bytes;         /* Sum of the received message sizes */
+    uint64_t cycles;        /* Sum of the receive to reply latencies */
+    uint32_t max_cycles;    /* Largest receive to reply latency */
+    uint32_t buckets[RSS_COMMS_STATS_BUCKETS]; /* Latency histogram */
+};
+
+#endif /* RSS_COMMS_STATS */
+
 #ifdef __cplusplus
 }
 #endif
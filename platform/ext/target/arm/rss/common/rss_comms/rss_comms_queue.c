@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,12 +10,28 @@
 #include <stdbool.h>
 #include <stddef.h>
 
-#define QUEUE_SIZE (RSS_COMMS_MAX_CONCURRENT_REQ + 1)
+#include "cmsis_compiler.h"
+
+/* One entry is kept unused to tell a full queue from an empty one */
+#define QUEUE_SIZE (RSS_COMMS_QUEUE_DEPTH + 1)
+
+/*
+ * The head is written by the producer and the tail by the consumer. Each is
+ * kept in its own cache line, together with the data only its writer uses.
+ */
+struct queue_producer_t {
+    volatile size_t head;
+    struct queue_stats_t stats;
+};
+
+struct queue_consumer_t {
+    volatile size_t tail;
+};
 
 struct queue_t {
-    void *buf[QUEUE_SIZE];
-    size_t head;
-    size_t tail;
+    __ALIGNED(RSS_COMMS_QUEUE_ALIGN) struct queue_producer_t prod;
+    __ALIGNED(RSS_COMMS_QUEUE_ALIGN) struct queue_consumer_t cons;
+    __ALIGNED(RSS_COMMS_QUEUE_ALIGN) void *buf[QUEUE_SIZE];
 };
 
 static struct queue_t queue;
@@ -29,36 +45,58 @@ static size_t advance(size_t index)
     return index;
 }
 
-static inline bool is_empty(void)
-{
-    return queue.head == queue.tail;
-}
-
-static inline bool is_full(void)
+static inline size_t used_entries(size_t head, size_t tail)
 {
-    return advance(queue.head) == queue.tail;
+    return (head >= tail) ? (head - tail) : (QUEUE_SIZE - tail + head);
 }
 
 int32_t queue_enqueue(void *entry)
 {
-    if (is_full()) {
+    size_t head = queue.prod.head;
+    size_t next = advance(head);
+    size_t used;
+
+    if (next == queue.cons.tail) {
+        queue.prod.stats.dropped++;
         return -1;
     }
 
-    queue.buf[queue.head] = entry;
-    queue.head = advance(queue.head);
+    queue.buf[head] = entry;
+
+    /* The entry is visible before the consumer can see the new head */
+    __DMB();
+    queue.prod.head = next;
+
+    used = used_entries(next, queue.cons.tail);
+    if (used > queue.prod.stats.high_water) {
+        queue.prod.stats.high_water = used;
+    }
 
     return 0;
 }
 
 int32_t queue_dequeue(void **entry)
 {
-    if (is_empty()) {
+    size_t tail = queue.cons.tail;
+
+    if (tail == queue.prod.head) {
         return -1;
     }
 
-    *entry = queue.buf[queue.tail];
-    queue.tail = advance(queue.tail);
+    /* The entry is read after the head which published it */
+    __DMB();
+    *entry = queue.buf[tail];
+
+    /* The entry is read before the producer can overwrite it */
+    __DMB();
+    queue.cons.tail = advance(tail);
 
     return 0;
 }
+
+void queue_get_stats(struct queue_stats_t *stats)
+{
+    if (stats) {
+        *stats = queue.prod.stats;
+    }
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -14,10 +14,36 @@
 extern "C" {
 #endif
 
+/* Number of entries the queue can hold */
+#ifndef RSS_COMMS_QUEUE_DEPTH
+#define RSS_COMMS_QUEUE_DEPTH RSS_COMMS_MAX_CONCURRENT_REQ
+#endif
+
+/* Alignment of the producer and consumer indices, the D-cache line size */
+#ifndef RSS_COMMS_QUEUE_ALIGN
+#define RSS_COMMS_QUEUE_ALIGN 32
+#endif
+
+struct queue_stats_t {
+    uint32_t dropped;       /* Entries rejected because the queue was full */
+    uint32_t high_water;    /* Maximum number of entries queued at once */
+};
+
+/*
+ * The queue is lock-free with a single producer and a single consumer. The
+ * producer only writes the head and the consumer only writes the tail, so
+ * neither side needs to mask interrupts.
+ */
+
+/* Called by the producer only. Return 0 on success, -1 if the queue is full */
 int32_t queue_enqueue(void *entry);
 
+/* Called by the consumer only. Return 0 on success, -1 if the queue is empty */
 int32_t queue_dequeue(void **entry);
 
+/* Copy the queue statistics to 'stats' */
+void queue_get_stats(struct queue_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,35 +1,155 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
-#include "stddef.h"
+#include "spm_dma_copy.h"
 
+#include <stddef.h>
+#include <string.h>
+
+#include "array.h"
+#include "cmsis.h"
 #include "dma350_privileged_config.h"
 #include "dma350_lib.h"
 #include "device_definition.h"
+#include "tfm_hal_dma.h"
 #include "utilities.h"
 
 #ifndef RSS_DMA_MIN_SIZE
 #define RSS_DMA_MIN_SIZE 1024
 #endif /* RSS_DMA_MIN_SIZE */
 
-void *spm_dma_memcpy(void *dest, const void *src, size_t n)
+/*
+ * The channels all run privileged and secure, see dma_init_cfg(). Channel 0 is
+ * left to unprivileged partitions through the DMA350 checker layer.
+ */
+static struct dma350_ch_dev_t *const spm_dma_channels[] = {
+    &DMA350_DMA0_CH1_DEV_S,
+    &DMA350_DMA0_CH2_DEV_S,
+    &DMA350_DMA0_CH3_DEV_S,
+};
+
+/* Bitmap of the channels running a copy */
+static uint32_t channels_in_use;
+
+/* Copies can be started from interrupt handlers, so the pool masks them */
+static int32_t channel_claim(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    int32_t channel = -1;
+    uint32_t i;
+
+    __disable_irq();
+
+    for (i = 0; i < ARRAY_SIZE(spm_dma_channels); i++) {
+        if (!(channels_in_use & (1UL << i))) {
+            channels_in_use |= (1UL << i);
+            channel = (int32_t)i;
+            break;
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    return channel;
+}
+
+static void channel_release(uint32_t channel)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    channels_in_use &= ~(1UL << channel);
+    __set_PRIMASK(primask);
+}
+
+void spm_dma_memcpy_start(struct spm_dma_copy_t *copy,
+                          void *dest, const void *src, size_t n)
 {
     enum dma350_lib_error_t err;
+    size_t nchunks = n / RSS_DMA_MIN_SIZE;
+    size_t chunk;
+    int32_t channel;
+
+    copy->channels = 0;
 
-    if (n < RSS_DMA_MIN_SIZE) {
-        return memcpy(dest, src, n);
-    } else {
-        err = dma350_memcpy(&DMA350_DMA0_CH0_DEV_S, (void *)src, dest, n,
-                            DMA350_LIB_EXEC_BLOCKING);
+    if (nchunks > ARRAY_SIZE(spm_dma_channels)) {
+        nchunks = ARRAY_SIZE(spm_dma_channels);
+    }
+
+    /* Word aligned chunks, the last one also takes the remainder */
+    chunk = nchunks ? ((n / nchunks) & ~(size_t)0x3) : 0;
+
+    while (nchunks > 0) {
+        channel = channel_claim();
+        if (channel < 0) {
+            break;
+        }
+
+        if (nchunks == 1) {
+            chunk = n;
+        }
+
+        err = dma350_memcpy(spm_dma_channels[channel], src, dest, chunk,
+                            DMA350_LIB_EXEC_START_ONLY);
         if (err != DMA350_LIB_ERR_NONE) {
             /* Memcpy can't return an error, so this the only option */
             tfm_core_panic();
         }
+        copy->channels |= (1UL << channel);
+
+        dest = (uint8_t *)dest + chunk;
+        src = (const uint8_t *)src + chunk;
+        n -= chunk;
+        nchunks--;
+    }
+
+    /* Copy what did not get a channel while the DMA runs */
+    if (n > 0) {
+        memcpy(dest, src, n);
+    }
+}
+
+void spm_dma_memcpy_wait(struct spm_dma_copy_t *copy)
+{
+    union dma350_ch_status_t status;
+    uint32_t i;
+
+    for (i = 0; i < ARRAY_SIZE(spm_dma_channels); i++) {
+        if (!(copy->channels & (1UL << i))) {
+            continue;
+        }
+
+        status = dma350_ch_wait_status(spm_dma_channels[i]);
+        if (!status.b.STAT_DONE || status.b.STAT_ERR) {
+            tfm_core_panic();
+        }
 
-        return dest;
+        channel_release(i);
     }
+
+    copy->channels = 0;
+}
+
+void *spm_dma_memcpy(void *dest, const void *src, size_t n)
+{
+    struct spm_dma_copy_t copy;
+
+    spm_dma_memcpy_start(&copy, dest, src, n);
+    spm_dma_memcpy_wait(&copy);
+
+    return dest;
+}
+
+enum tfm_hal_status_t tfm_hal_dma_copy(void *dest, const void *src, size_t n)
+{
+    struct spm_dma_copy_t copy;
+
+    spm_dma_memcpy_start(&copy, dest, src, n);
+    spm_dma_memcpy_wait(&copy);
+
+    return TFM_HAL_SUCCESS;
 }
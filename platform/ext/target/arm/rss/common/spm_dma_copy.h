@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_DMA_COPY_H__
+#define __SPM_DMA_COPY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A copy started with spm_dma_memcpy_start() */
+struct spm_dma_copy_t {
+    uint32_t channels;      /* Bitmap of the DMA channels running the copy */
+};
+
+/**
+ * \brief Start copying n bytes from src to dest in the background.
+ *
+ * \param[out] copy       The copy to wait for with spm_dma_memcpy_wait().
+ * \param[in]  dest       Destination address.
+ * \param[in]  src        Source address.
+ * \param[in]  n          Number of bytes to copy.
+ *
+ * \note Copies of at least RSS_DMA_MIN_SIZE bytes are split across the free
+ *       DMA channels, the part that gets no channel is copied by the CPU before
+ *       returning. Smaller copies are done by the CPU. The buffers must not be
+ *       accessed until spm_dma_memcpy_wait() returns.
+ */
+void spm_dma_memcpy_start(struct spm_dma_copy_t *copy,
+                          void *dest, const void *src, size_t n);
+
+/**
+ * \brief Wait for a copy started by spm_dma_memcpy_start() to complete, and
+ *        give its DMA channels back. Panics if a DMA transfer failed.
+ *
+ * \param[in] copy        The copy to wait for.
+ */
+void spm_dma_memcpy_wait(struct spm_dma_copy_t *copy);
+
+/**
+ * \brief Copy n bytes from src to dest, with DMA channels for large copies.
+ *        Used as spm_memcpy() by the SPM.
+ *
+ * \return dest
+ */
+void *spm_dma_memcpy(void *dest, const void *src, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPM_DMA_COPY_H__ */
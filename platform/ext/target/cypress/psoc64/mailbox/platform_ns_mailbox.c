@@ -133,6 +133,14 @@ void tfm_ns_mailbox_hal_exit_critical_isr(void)
     Cy_IPC_Drv_LockRelease(ipc_struct, CY_IPC_NO_NOTIFICATION);
 }
 
+#if !defined(TFM_MULTI_CORE_NS_OS) && defined(TFM_MULTI_CORE_NS_MAILBOX_WAIT_WFE)
+void tfm_ns_mailbox_hal_wait_reply(void)
+{
+    /* Woken up by the reply IPC interrupt enabled in mailbox_ipc_config() */
+    __WFE();
+}
+#endif
+
 static bool mailbox_clear_intr(void)
 {
     uint32_t status;
@@ -62,7 +62,7 @@ int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue)
      * be implemented there.
      */
 
-    s_queue->ns_queue = ns_queue;
+    s_queue->ns_queue[0] = ns_queue;
 
     mailbox_ipc_config();
 
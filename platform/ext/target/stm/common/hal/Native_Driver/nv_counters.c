@@ -278,3 +278,20 @@ enum tfm_plat_err_t tfm_plat_increment_nv_counter(
 
     return tfm_plat_set_nv_counter(counter_id, security_cnt + 1u);
 }
+
+enum tfm_plat_err_t tfm_plat_increment_nv_counters(
+                                     const enum tfm_nv_counter_t *counter_ids,
+                                     uint32_t num_counters)
+{
+    enum tfm_plat_err_t err;
+    uint32_t idx;
+
+    for (idx = 0; idx < num_counters; idx++) {
+        err = tfm_plat_increment_nv_counter(counter_ids[idx]);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return err;
+        }
+    }
+
+    return TFM_PLAT_ERR_SUCCESS;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2020 STMicroelectronics. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -135,6 +135,88 @@ int boot_store_measurement(uint8_t index,
                            const struct boot_measurement_metadata *metadata,
                            bool lock_measurement);
 
+/**
+ * \brief Reads the counter the boot phases are timestamped with. Needed by
+ *        TFM_BOOT_TIMING. The default is the DWT cycle counter, which is
+ *        enabled on the first read. An implementation must keep counting
+ *        across the boot stages, as the runtime firmware reads the same
+ *        counter.
+ *
+ * \return The counter value, 0 if the platform has none.
+ */
+uint32_t boot_platform_get_timestamp(void);
+
+/**
+ * \brief Records the time at which a boot phase is reached, as a
+ *        TLV_MAJOR_BTS entry of the shared data area. Needed by
+ *        TFM_BOOT_TIMING.
+ *
+ * \param[in] phase  The boot phase, one of the BOOT_TIMING_* values.
+ * \param[in] index  Tells the repeated phases apart, the largest allowed
+ *                   index is 63 (0x3F).
+ * \param[in] id     The image or partition ID the phase is about, 0 if none.
+ *
+ * \return Returns 0 on success, non-zero otherwise.
+ */
+int boot_store_timestamp(uint8_t phase, uint8_t index, uint32_t id);
+
+/* Size of the key and of the record of the verified image cache */
+#define BOOT_IMAGE_CACHE_KEY_SIZE       (32u)
+#define BOOT_IMAGE_CACHE_RECORD_SIZE    (32u)
+
+/**
+ * \brief Gets how many times a flash area has been written or erased.
+ *        Needed by MCUBOOT_VERIFIED_IMAGE_CACHE.
+ *
+ * \note  The count must never decrease, and it must account for every change
+ *        of the area content, including those made before BL2 runs, by the
+ *        runtime firmware, or through a debug port.
+ *
+ * \param[in]  fa_id  The ID of the flash area.
+ * \param[out] count  The number of writes and erases of the area.
+ *
+ * \return Returns 0 on success, non-zero otherwise
+ */
+int boot_platform_get_flash_write_count(uint8_t fa_id, uint32_t *count);
+
+/**
+ * \brief Gets the device unique key the records of the verified image cache
+ *        are computed with. Needed by MCUBOOT_VERIFIED_IMAGE_CACHE.
+ *
+ * \param[out] key       Buffer to hold the key.
+ * \param[in]  key_size  Size of the key, BOOT_IMAGE_CACHE_KEY_SIZE.
+ *
+ * \return Returns 0 on success, non-zero otherwise
+ */
+int boot_platform_get_image_cache_key(uint8_t *key, size_t key_size);
+
+/**
+ * \brief Reads the record of the verified image cache of an image from
+ *        storage which only the bootloader can write.
+ *        Needed by MCUBOOT_VERIFIED_IMAGE_CACHE.
+ *
+ * \param[in]  image_id     The ID of the image.
+ * \param[out] record       Buffer to hold the record.
+ * \param[in]  record_size  Size of the record, BOOT_IMAGE_CACHE_RECORD_SIZE.
+ *
+ * \return Returns 0 on success, non-zero if there is no record
+ */
+int boot_platform_read_image_cache(uint32_t image_id, uint8_t *record,
+                                   size_t record_size);
+
+/**
+ * \brief Writes the record of the verified image cache of an image.
+ *        Needed by MCUBOOT_VERIFIED_IMAGE_CACHE.
+ *
+ * \param[in] image_id     The ID of the image.
+ * \param[in] record       The record to write.
+ * \param[in] record_size  Size of the record, BOOT_IMAGE_CACHE_RECORD_SIZE.
+ *
+ * \return Returns 0 on success, non-zero otherwise
+ */
+int boot_platform_write_image_cache(uint32_t image_id, const uint8_t *record,
+                                    size_t record_size);
+
 #ifdef __cplusplus
 }
 #endif
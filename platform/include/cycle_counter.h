@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __CYCLE_COUNTER_H__
+#define __CYCLE_COUNTER_H__
+
+#include <stdint.h>
+#include "cmsis.h"
+
+/*
+ * DWT cycle counter helpers shared by the instrumentation of the bootloaders,
+ * the SPM, the partitions and the platform drivers. Armv6-M and Armv8-M
+ * Baseline have no cycle counter, the reads return 0 there.
+ *
+ * Enabling the counter does not reset it, so a counter already started by an
+ * earlier boot stage keeps counting from the same origin.
+ */
+static inline void cycle_counter_enable(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) {
+        return;
+    }
+#ifdef DCB_DEMCR_TRCENA_Msk
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+    if (!(DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk)) {
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+#endif
+}
+
+static inline uint32_t cycle_counter_read(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    return DWT->CYCCNT;
+#else
+    return 0;
+#endif
+}
+
+#endif /* __CYCLE_COUNTER_H__ */
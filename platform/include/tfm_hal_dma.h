@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_DMA_H__
+#define __TFM_HAL_DMA_H__
+
+#include <stddef.h>
+
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Smallest copy the SPM passes to tfm_hal_dma_copy(). Below it, the cost of
+ * setting up a transfer outweighs a CPU copy. Platforms calibrate it with
+ * PLATFORM_DMA_COPY_MIN_SIZE.
+ */
+#ifndef TFM_HAL_DMA_COPY_MIN_SIZE
+#define TFM_HAL_DMA_COPY_MIN_SIZE 1024
+#endif
+
+/**
+ * \brief Copy memory with a DMA engine, and return once the copy is complete.
+ *
+ * \param[in] dest              Destination address.
+ * \param[in] src               Source address.
+ * \param[in] n                 Number of bytes to copy.
+ *
+ * \retval TFM_HAL_SUCCESS      The memory has been copied.
+ * \retval Other error codes    Nothing has been copied, the SPM then copies
+ *                              the memory with the CPU.
+ *
+ * \note Only built when the platform sets PLATFORM_HAS_DMA_COPY. The SPM has
+ *       checked that both buffers are accessible by the partitions involved.
+ */
+enum tfm_hal_status_t tfm_hal_dma_copy(void *dest, const void *src, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_DMA_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -91,6 +91,16 @@ FIH_RET_TYPE(enum tfm_hal_status_t) tfm_hal_memory_check(
                                            uintptr_t boundary, uintptr_t base,
                                            size_t size, uint32_t access_type);
 
+#ifdef CONFIG_TFM_MEMORY_CHECK_CACHE
+/**
+ * \brief  Drop the Non-secure ranges cached as accessible by
+ *         \ref tfm_hal_memory_check. It must be called whenever the SAU,
+ *         IDAU or Non-secure MPU configuration may have changed, for example
+ *         on an NS context switch.
+ */
+void tfm_hal_memory_check_cache_invalidate(void);
+#endif
+
 /**
  * \brief  This API binds partition boundaries with the platform. The platform
  *         maintains the platform-specific settings for SPM further
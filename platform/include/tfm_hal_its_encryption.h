@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_ITS_ENCRYPTION_H__
+#define __TFM_HAL_ITS_ENCRYPTION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tfm_hal_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * HAL of the platforms encrypting the ITS file data, with ITS_ENCRYPTION.
+ *
+ * The ITS filesystem encrypts the data of each file with AES-CTR, under a key
+ * derived by the platform from its hardware unique key. The key never leaves
+ * the platform, and the functions are called directly by the ITS partition,
+ * so they are typically implemented with the crypto accelerator of the
+ * platform rather than the Crypto service.
+ */
+
+/* Size of the nonce of the file data, the first bytes of the initial counter
+ * block. The last 4 bytes are the big endian number of the 16 byte block in
+ * the file data.
+ */
+#define TFM_HAL_ITS_ENCRYPTION_NONCE_SIZE   12
+
+/**
+ * \brief Generate a new random nonce. The filesystem gets one for each write
+ *        to a file, so the nonces must not repeat under the same key.
+ *
+ * \param[out] nonce       Buffer to store the nonce
+ * \param[in]  nonce_size  Size of the nonce, in bytes
+ *
+ * \return A status code as specified in \ref tfm_hal_status_t
+ *
+ * \retval TFM_HAL_SUCCESS              The nonce is generated
+ * \retval TFM_HAL_ERROR_INVALID_INPUT  Invalid parameter
+ * \retval TFM_HAL_ERROR_GENERIC        The random generator failed
+ */
+enum tfm_hal_status_t tfm_hal_its_gen_nonce(uint8_t *nonce, size_t nonce_size);
+
+/**
+ * \brief Encrypt or decrypt file data with AES-CTR, under the key derived
+ *        from the hardware unique key for ITS.
+ *
+ * \param[in]  nonce       Nonce of the file data
+ * \param[in]  nonce_size  Size of the nonce, in bytes
+ * \param[in]  offset      Offset of the input in the file data. It does not
+ *                         need to be aligned to the AES block size.
+ * \param[in]  input       Data to encrypt or decrypt
+ * \param[out] output      Buffer to store the result. It can be the same as
+ *                         the input.
+ * \param[in]  size        Size of the input and output, in bytes
+ *
+ * \return A status code as specified in \ref tfm_hal_status_t
+ *
+ * \retval TFM_HAL_SUCCESS              The data is encrypted or decrypted
+ * \retval TFM_HAL_ERROR_INVALID_INPUT  Invalid parameter
+ * \retval TFM_HAL_ERROR_GENERIC        The key or the accelerator failed
+ */
+enum tfm_hal_status_t tfm_hal_its_ctr_crypt(const uint8_t *nonce,
+                                            size_t nonce_size,
+                                            size_t offset,
+                                            const uint8_t *input,
+                                            uint8_t *output,
+                                            size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_ITS_ENCRYPTION_H__ */
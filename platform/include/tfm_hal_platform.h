@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2022 Cypress Semiconductor Corporation (an Infineon company)
  * or an affiliate of Cypress Semiconductor Corporation. All rights reserved.
  *
@@ -58,6 +58,49 @@ int32_t tfm_hal_random_init(void);
  */
 int32_t tfm_hal_random_generate(uint8_t *rand, size_t size);
 
+/* Low-power states of the secure idle thread, from shallowest to deepest */
+enum tfm_hal_idle_state_t {
+    TFM_HAL_IDLE_WFI = 0,           /* Core clock gated only                */
+    TFM_HAL_IDLE_SLEEP,             /* Platform sleep, peripherals clocked  */
+    TFM_HAL_IDLE_DEEP_SLEEP,        /* Deepest state with wake-up sources   */
+};
+
+/* The wake-up source is not known */
+#define TFM_HAL_WAKE_REASON_UNKNOWN     UINT32_MAX
+
+/**
+ * \brief Put the core into a low-power state while the SPE is idle.
+ *
+ * \param[in]  deepest          The deepest state SPM permits. A Secure
+ *                              Partition waiting for an interrupt limits it
+ *                              to \ref TFM_HAL_IDLE_SLEEP.
+ * \param[out] wake_reason      The IRQ number that woke up the core, or
+ *                              \ref TFM_HAL_WAKE_REASON_UNKNOWN.
+ *
+ * \return The state that was entered.
+ *
+ * \note It is called with interrupts masked by PRIMASK. A pending interrupt
+ *       still wakes up the core, and it is taken after this function returns.
+ */
+enum tfm_hal_idle_state_t tfm_hal_platform_idle(
+                                        enum tfm_hal_idle_state_t deepest,
+                                        uint32_t *wake_reason);
+
+/**
+ * \brief Start the secure tick that drives the SPM timers.
+ *
+ * \param[in] tick_hz           The tick frequency in Hz.
+ *
+ * \retval TFM_HAL_SUCCESS        The tick source is started.
+ * \retval Other code             The frequency is not supported.
+ *
+ * \note The platform calls spm_handle_tick() from the tick interrupt, which
+ *       must not preempt PendSV. With CONFIG_TFM_CRITICAL_SECTION_BASEPRI,
+ *       the SPM critical sections must mask it, else an error is returned.
+ *       It is only used with CONFIG_TFM_SPM_TIMER.
+ */
+enum tfm_hal_status_t tfm_hal_spm_tick_init(uint32_t tick_hz);
+
 /**
  * \brief Get the VTOR value of non-secure image
  *
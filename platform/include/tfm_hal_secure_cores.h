@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_SECURE_CORES_H__
+#define __TFM_HAL_SECURE_CORES_H__
+
+#include <stdint.h>
+
+/*
+ * HAL of the platforms running the Secure Partitions on more than one secure
+ * core, with TFM_SPM_SECURE_CORE_NUM greater than 1.
+ *
+ * The cores share the secure memory and the SPM data. The MSP stack and the
+ * Partition metadata pointer of each core are at the same address on every
+ * core, in a core private memory such as a TCM.
+ */
+
+/**
+ * \brief Get the ID of the secure core running the caller.
+ *
+ * \return The core ID, 0 for the core booting TF-M, below
+ *         TFM_SPM_SECURE_CORE_NUM.
+ */
+uint32_t tfm_hal_get_secure_core_id(void);
+
+/**
+ * \brief Start a secondary secure core. It runs the code at the given address
+ *        in Thread mode, with the MSP at the top of its stack. It is called by
+ *        the SPM once the Secure Partitions are initialized.
+ *
+ * \param[in] core_id          The ID of the core to start.
+ * \param[in] entry            The entry point of the core.
+ */
+void tfm_hal_boot_secure_core(uint32_t core_id, uintptr_t entry);
+
+/**
+ * \brief Take the lock shared by the secure cores. It busy waits until the
+ *        lock is free, and is not recursive. It is called with the interrupts
+ *        of the calling core masked.
+ */
+void tfm_hal_secure_core_lock(void);
+
+/**
+ * \brief Release the lock taken by \ref tfm_hal_secure_core_lock.
+ */
+void tfm_hal_secure_core_unlock(void);
+
+/**
+ * \brief Raise the inter-core interrupt of a secure core. Its handler calls
+ *        spm_handle_core_notify() to let the SPM schedule the Partitions
+ *        woken up by the other core.
+ *
+ * \param[in] core_id          The ID of the core to notify.
+ */
+void tfm_hal_notify_secure_core(uint32_t core_id);
+
+#endif /* __TFM_HAL_SECURE_CORES_H__ */
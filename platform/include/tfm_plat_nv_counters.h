@@ -90,6 +90,27 @@ enum tfm_plat_err_t tfm_plat_read_nv_counter(enum tfm_nv_counter_t counter_id,
 enum tfm_plat_err_t tfm_plat_increment_nv_counter(
                                               enum tfm_nv_counter_t counter_id);
 
+/**
+ * \brief Increments several non-volatile (NV) counters by one.
+ *
+ * \note All the counters are read before any of them is written. Where the
+ *       underlying memory allows it, the counters are then programmed with a
+ *       single write. Otherwise they are incremented one after the other, and
+ *       the counters before a failing one stay incremented.
+ *
+ * \param[in] counter_ids   Array of the NV counter IDs. Each ID must only
+ *                          appear once.
+ * \param[in] num_counters  Number of entries in counter_ids.
+ *
+ * \return  When one of the NV counters reaches its maximum value, the
+ *          TFM_PLAT_ERR_MAX_VALUE error is returned. Otherwise, it returns
+ *          TFM_PLAT_ERR_SUCCESS, or another error if one of the counters
+ *          couldn't be read or written.
+ */
+enum tfm_plat_err_t tfm_plat_increment_nv_counters(
+                                     const enum tfm_nv_counter_t *counter_ids,
+                                     uint32_t num_counters);
+
 /**
  * \brief Sets the given non-volatile (NV) counter to the specified value.
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,6 +13,26 @@
 
 #define ADDR_WORD_UNALIGNED(x)        ((x) & 0x3)
 
+/*
+ * Merges the word starting 'offset' bytes, 1 to 3, into the aligned word 'lo',
+ * with 'hi' the aligned word following it. Buffers with different alignments
+ * are then copied with aligned word accesses only, which Armv8-M Baseline
+ * requires, and which are faster than unaligned ones on Mainline.
+ */
+#if defined(__ARM_BIG_ENDIAN)
+#define WORD_MERGE(lo, hi, offset)                     \
+    (((lo) << ((offset) * 8)) | ((hi) >> (32 - (offset) * 8)))
+#else
+#define WORD_MERGE(lo, hi, offset)                     \
+    (((lo) >> ((offset) * 8)) | ((hi) << (32 - (offset) * 8)))
+#endif
+
+/*
+ * The bytes moved by each iteration of the burst loops, four words loaded into
+ * registers before being stored, which the compilers emit as LDM/STM pairs.
+ */
+#define BURST_SIZE                    (4 * sizeof(uint32_t))
+
 union composite_addr_t {
     uintptr_t uint_addr;        /* Address as integer value  */
     uint8_t   *p_byte;          /* Address in BYTE pointer   */
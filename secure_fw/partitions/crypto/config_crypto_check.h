@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -19,4 +19,23 @@
 #error "Invalid config: NOT CRYPTO_NV_SEED AND NOT CRYPTO_HW_ACCELERATOR!"
 #endif
 
+#if (CRYPTO_CONC_CIPHER_OPER_NUM < 1) || (CRYPTO_CONC_CIPHER_OPER_NUM > 65534) || \
+    (CRYPTO_CONC_MAC_OPER_NUM < 1) || (CRYPTO_CONC_MAC_OPER_NUM > 65534) || \
+    (CRYPTO_CONC_HASH_OPER_NUM < 1) || (CRYPTO_CONC_HASH_OPER_NUM > 65534) || \
+    (CRYPTO_CONC_KEY_DERIVATION_OPER_NUM < 1) || \
+    (CRYPTO_CONC_KEY_DERIVATION_OPER_NUM > 65534) || \
+    (CRYPTO_CONC_AEAD_OPER_NUM < 1) || (CRYPTO_CONC_AEAD_OPER_NUM > 65534)
+#error "Invalid config: CRYPTO_CONC_<type>_OPER_NUM must be in range 1..65534!"
+#endif
+
+#if (CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM < 0)
+#error "Invalid config: CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM must not be negative!"
+#endif
+
+#if (CRYPTO_RNG_POOL_SIZE > 0) && \
+    ((CRYPTO_RNG_POOL_MAX_REQUEST < 1) || \
+     (CRYPTO_RNG_POOL_MAX_REQUEST > CRYPTO_RNG_POOL_SIZE))
+#error "Invalid config: CRYPTO_RNG_POOL_MAX_REQUEST must be in range 1..CRYPTO_RNG_POOL_SIZE!"
+#endif
+
 #endif /* __CONFIG_PARTITION_CRYPTO_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -200,6 +200,12 @@ psa_status_t tfm_crypto_aead_interface(psa_invec in_vec[],
     }
     case TFM_CRYPTO_AEAD_UPDATE_SID:
     {
+        /*
+         * Without MM-IOVEC, an input larger than the scratch is passed here
+         * one chunk at a time within the same client call, see
+         * tfm_crypto_call_srv_stream(). The operation keeps the state between
+         * the chunks, so the output is the same as for a single update.
+         */
         const uint8_t *input = in_vec[1].base;
         size_t input_length = in_vec[1].len;
         uint8_t *output = out_vec[0].base;
@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -29,41 +30,277 @@ enum {
 #define TFM_CRYPTO_INVALID_HANDLE (0x0u)
 
 /**
- * \brief A type describing the context stored in Secure memory by the TF-M Crypto
- *        service to support multipart calls on secure side
+ * \brief The handle of a multipart operation holds a generation count in the
+ *        top byte, the operation type in the next byte and the index in the
+ *        pool of that type, plus 1, in the lower half-word. The type selects
+ *        the pool without a scan, and the generation makes the handle of a
+ *        reclaimed context stale instead of aliasing its next allocation.
+ */
+#define TFM_CRYPTO_HANDLE_GEN_SHIFT  (24u)
+#define TFM_CRYPTO_HANDLE_TYPE_SHIFT (16u)
+#define TFM_CRYPTO_HANDLE_TYPE_MASK  (0xFFu)
+#define TFM_CRYPTO_HANDLE_IDX_MASK   (0xFFFFu)
+
+/**
+ * \brief Marks the end of the free list of a pool
+ */
+#define TFM_CRYPTO_FREE_LIST_END     (0xFFFFu)
+
+/**
+ * \brief Number of contexts in the pool of each operation type. The pool of an
+ *        operation type whose module is disabled is empty.
+ */
+#if CRYPTO_CIPHER_MODULE_ENABLED
+#define CIPHER_POOL_NUM     CRYPTO_CONC_CIPHER_OPER_NUM
+#else
+#define CIPHER_POOL_NUM     0
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+#define MAC_POOL_NUM        CRYPTO_CONC_MAC_OPER_NUM
+#else
+#define MAC_POOL_NUM        0
+#endif
+#if CRYPTO_HASH_MODULE_ENABLED
+#define HASH_POOL_NUM       CRYPTO_CONC_HASH_OPER_NUM
+#else
+#define HASH_POOL_NUM       0
+#endif
+#if CRYPTO_KEY_DERIVATION_MODULE_ENABLED
+#define KEY_DERIV_POOL_NUM  CRYPTO_CONC_KEY_DERIVATION_OPER_NUM
+#else
+#define KEY_DERIV_POOL_NUM  0
+#endif
+#if CRYPTO_AEAD_MODULE_ENABLED
+#define AEAD_POOL_NUM       CRYPTO_CONC_AEAD_OPER_NUM
+#else
+#define AEAD_POOL_NUM       0
+#endif
+
+/**
+ * \brief A type describing the bookkeeping of a context stored in Secure
+ *        memory by the TF-M Crypto service to support multipart calls on
+ *        secure side
  */
 struct tfm_crypto_operation_s {
     uint32_t in_use;                /*!< Indicates if the operation is in use */
     int32_t owner;                  /*!< Indicates an ID of the owner of
                                      *   the context
                                      */
-    enum tfm_crypto_operation_type type; /*!< Type of the operation */
-    union {
-        psa_cipher_operation_t cipher;    /*!< Cipher operation context */
-        psa_mac_operation_t mac;          /*!< MAC operation context */
-        psa_hash_operation_t hash;        /*!< Hash operation context */
-        psa_key_derivation_operation_t key_deriv; /*!< Key derivation operation context */
-        psa_aead_operation_t aead;        /*!< AEAD operation context */
-    } operation;
+    uint16_t next_free;             /*!< Index of the next free context in
+                                     *   the pool
+                                     */
+    uint8_t generation;             /*!< Bumped on each allocation of the
+                                     *   context, encoded in its handle
+                                     */
+#if CRYPTO_CONC_OPER_LEASE > 0
+    uint32_t last_use;              /*!< Value of the activity count when the
+                                     *   context was last used
+                                     */
+#endif
+};
+
+/**
+ * \brief A pool of contexts of one operation type, sized for that type only
+ */
+struct tfm_crypto_operation_pool_s {
+    struct tfm_crypto_operation_s *ops; /*!< Bookkeeping of each context */
+    uint8_t *ctx;                   /*!< Base of the context array */
+    size_t ctx_size;                /*!< Size of one context */
+    uint16_t num;                   /*!< Number of contexts in the pool */
+    uint16_t free_head;             /*!< Index of the first free context */
+};
+
+#define TFM_CRYPTO_POOL_DECLARE(name, ctx_type, pool_num)                     \
+    static struct tfm_crypto_operation_s name##_ops[pool_num];                \
+    static ctx_type name##_ctx[pool_num]
+
+#define TFM_CRYPTO_POOL_INIT(name, pool_num) {                                \
+        .ops = name##_ops,                                                    \
+        .ctx = (uint8_t *)name##_ctx,                                         \
+        .ctx_size = sizeof(name##_ctx[0]),                                    \
+        .num = (pool_num),                                                    \
+    }
+
+#if CIPHER_POOL_NUM > 0
+TFM_CRYPTO_POOL_DECLARE(cipher, psa_cipher_operation_t, CIPHER_POOL_NUM);
+#endif
+#if MAC_POOL_NUM > 0
+TFM_CRYPTO_POOL_DECLARE(mac, psa_mac_operation_t, MAC_POOL_NUM);
+#endif
+#if HASH_POOL_NUM > 0
+TFM_CRYPTO_POOL_DECLARE(hash, psa_hash_operation_t, HASH_POOL_NUM);
+#endif
+#if KEY_DERIV_POOL_NUM > 0
+TFM_CRYPTO_POOL_DECLARE(key_deriv, psa_key_derivation_operation_t,
+                        KEY_DERIV_POOL_NUM);
+#endif
+#if AEAD_POOL_NUM > 0
+TFM_CRYPTO_POOL_DECLARE(aead, psa_aead_operation_t, AEAD_POOL_NUM);
+#endif
+
+/* Indexed by enum tfm_crypto_operation_type */
+static struct tfm_crypto_operation_pool_s
+                                      pools[TFM_CRYPTO_AEAD_OPERATION + 1] = {
+    [TFM_CRYPTO_OPERATION_NONE] = {0},
+#if CIPHER_POOL_NUM > 0
+    [TFM_CRYPTO_CIPHER_OPERATION] = TFM_CRYPTO_POOL_INIT(cipher,
+                                                         CIPHER_POOL_NUM),
+#endif
+#if MAC_POOL_NUM > 0
+    [TFM_CRYPTO_MAC_OPERATION] = TFM_CRYPTO_POOL_INIT(mac, MAC_POOL_NUM),
+#endif
+#if HASH_POOL_NUM > 0
+    [TFM_CRYPTO_HASH_OPERATION] = TFM_CRYPTO_POOL_INIT(hash, HASH_POOL_NUM),
+#endif
+#if KEY_DERIV_POOL_NUM > 0
+    [TFM_CRYPTO_KEY_DERIVATION_OPERATION] = TFM_CRYPTO_POOL_INIT(key_deriv,
+                                                            KEY_DERIV_POOL_NUM),
+#endif
+#if AEAD_POOL_NUM > 0
+    [TFM_CRYPTO_AEAD_OPERATION] = TFM_CRYPTO_POOL_INIT(aead, AEAD_POOL_NUM),
+#endif
 };
 
-static struct tfm_crypto_operation_s operations[CRYPTO_CONC_OPER_NUM] = {{0}};
+#define TFM_CRYPTO_POOL_AMOUNT (sizeof(pools) / sizeof(pools[0]))
+
+#if CRYPTO_CONC_OPER_LEASE > 0
+/**
+ * \brief Count of multipart allocations and lookups, used as the clock of
+ *        the lease of each context
+ */
+static uint32_t activity_count;
+#endif
+
+/*
+ * \brief Function used to find the pool and the index of a handle
+ *
+ * \param[in]  handle Handle of the operation
+ * \param[out] pool   Pool holding the context of the operation
+ * \param[out] idx    Index of the context in the pool
+ *
+ * \return true if the handle refers to a context in the pools, false otherwise
+ *
+ */
+static bool decode_handle(uint32_t handle,
+                          struct tfm_crypto_operation_pool_s **pool,
+                          uint32_t *idx)
+{
+    uint32_t type = (handle >> TFM_CRYPTO_HANDLE_TYPE_SHIFT) &
+                    TFM_CRYPTO_HANDLE_TYPE_MASK;
+    uint32_t i = handle & TFM_CRYPTO_HANDLE_IDX_MASK;
+
+    if ((type >= TFM_CRYPTO_POOL_AMOUNT) || (i == 0) ||
+        (i > pools[type].num) ||
+        (pools[type].ops[i - 1].generation !=
+         (uint8_t)(handle >> TFM_CRYPTO_HANDLE_GEN_SHIFT))) {
+        return false;
+    }
+
+    *pool = &pools[type];
+    *idx = i - 1;
+
+    return true;
+}
 
 /*
  * \brief Function used to clear the memory associated to a backend context
  *
- * \param[in] index Numerical index in the database of the backend contexts
+ * \param[in] pool  Pool holding the backend context
+ * \param[in] index Numerical index in the pool of the backend contexts
  *
  * \return None
  *
  */
-static void memset_operation_context(uint32_t index)
+static void memset_operation_context(struct tfm_crypto_operation_pool_s *pool,
+                                     uint32_t index)
 {
     /* Clear the contents of the backend context */
-    (void)memset((uint8_t *)&(operations[index].operation), 0,
-                 sizeof(operations[index].operation));
+    (void)memset(pool->ctx + (index * pool->ctx_size), 0, pool->ctx_size);
 }
 
+static void free_operation_context(struct tfm_crypto_operation_pool_s *pool,
+                                   uint32_t index)
+{
+    memset_operation_context(pool, index);
+    pool->ops[index].in_use = TFM_CRYPTO_NOT_IN_USE;
+    pool->ops[index].owner = 0;
+    pool->ops[index].next_free = pool->free_head;
+    pool->free_head = (uint16_t)index;
+}
+
+#if CRYPTO_CONC_OPER_LEASE > 0
+/*
+ * \brief Function used to reclaim the context of a pool which has been idle
+ *        for the longest, if that is longer than the lease. A client which
+ *        terminated in the middle of an operation never releases its context,
+ *        the whole pool would otherwise be lost after a few such clients.
+ *
+ * \param[in] type Type of the operation held in the pool
+ * \param[in] pool Pool to reclaim a context from
+ *
+ * \return true if a context has been aborted and put back in the free list
+ *
+ */
+static bool reclaim_operation_context(enum tfm_crypto_operation_type type,
+                                      struct tfm_crypto_operation_pool_s *pool)
+{
+    uint32_t i, oldest = TFM_CRYPTO_FREE_LIST_END;
+    uint32_t idle, oldest_idle = 0;
+    void *ctx;
+
+    for (i = 0; i < pool->num; i++) {
+        if (pool->ops[i].in_use != TFM_CRYPTO_IN_USE) {
+            continue;
+        }
+        idle = activity_count - pool->ops[i].last_use;
+        if ((idle > CRYPTO_CONC_OPER_LEASE) && (idle > oldest_idle)) {
+            oldest = i;
+            oldest_idle = idle;
+        }
+    }
+
+    if (oldest == TFM_CRYPTO_FREE_LIST_END) {
+        return false;
+    }
+
+    /* Abort the operation so that the library releases what it holds */
+    ctx = (void *)(pool->ctx + (oldest * pool->ctx_size));
+    switch (type) {
+#if CRYPTO_CIPHER_MODULE_ENABLED
+    case TFM_CRYPTO_CIPHER_OPERATION:
+        (void)psa_cipher_abort(ctx);
+        break;
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+    case TFM_CRYPTO_MAC_OPERATION:
+        (void)psa_mac_abort(ctx);
+        break;
+#endif
+#if CRYPTO_HASH_MODULE_ENABLED
+    case TFM_CRYPTO_HASH_OPERATION:
+        (void)psa_hash_abort(ctx);
+        break;
+#endif
+#if CRYPTO_KEY_DERIVATION_MODULE_ENABLED
+    case TFM_CRYPTO_KEY_DERIVATION_OPERATION:
+        (void)psa_key_derivation_abort(ctx);
+        break;
+#endif
+#if CRYPTO_AEAD_MODULE_ENABLED
+    case TFM_CRYPTO_AEAD_OPERATION:
+        (void)psa_aead_abort(ctx);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    free_operation_context(pool, oldest);
+
+    return true;
+}
+#endif /* CRYPTO_CONC_OPER_LEASE > 0 */
+
 /*!
  * \defgroup alloc Function that implement allocation and deallocation of
  *                 contexts to be stored in the secure world for multipart
@@ -73,8 +310,31 @@ static void memset_operation_context(uint32_t index)
 /*!@{*/
 psa_status_t tfm_crypto_init_alloc(void)
 {
-    /* Clear the contents of the local contexts */
-    (void)memset(operations, 0, sizeof(operations));
+    struct tfm_crypto_operation_pool_s *pool;
+    uint32_t type, i;
+
+    for (type = 0; type < TFM_CRYPTO_POOL_AMOUNT; type++) {
+        pool = &pools[type];
+        pool->free_head = TFM_CRYPTO_FREE_LIST_END;
+        if (pool->num == 0) {
+            continue;
+        }
+
+        /* Clear the contents of the local contexts */
+        (void)memset(pool->ctx, 0, pool->num * pool->ctx_size);
+
+        /* Chain all the contexts into the free list */
+        for (i = 0; i < pool->num; i++) {
+            pool->ops[i].in_use = TFM_CRYPTO_NOT_IN_USE;
+            pool->ops[i].owner = 0;
+            pool->ops[i].generation = 0;
+            pool->ops[i].next_free = (i + 1 < pool->num) ?
+                                     (uint16_t)(i + 1) :
+                                     TFM_CRYPTO_FREE_LIST_END;
+        }
+        pool->free_head = 0;
+    }
+
     return PSA_SUCCESS;
 }
 
@@ -85,6 +345,7 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
     uint32_t i = 0;
     int32_t partition_id = 0;
     psa_status_t status;
+    struct tfm_crypto_operation_pool_s *pool;
 
     /* Handle must be initialised before calling a setup function */
     if (*handle != TFM_CRYPTO_INVALID_HANDLE) {
@@ -97,23 +358,39 @@ psa_status_t tfm_crypto_operation_alloc(enum tfm_crypto_operation_type type,
     }
     *ctx = NULL;
 
+    if ((uint32_t)type >= TFM_CRYPTO_POOL_AMOUNT) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
     status = tfm_crypto_get_caller_id(&partition_id);
     if (status != PSA_SUCCESS) {
         return status;
     }
 
-    for (i = 0; i < CRYPTO_CONC_OPER_NUM; i++) {
-        if (operations[i].in_use == TFM_CRYPTO_NOT_IN_USE) {
-            operations[i].in_use = TFM_CRYPTO_IN_USE;
-            operations[i].owner = partition_id;
-            operations[i].type = type;
-            *handle = i + 1;
-            *ctx = (void *) &(operations[i].operation);
-            return PSA_SUCCESS;
-        }
+    pool = &pools[type];
+#if CRYPTO_CONC_OPER_LEASE > 0
+    activity_count++;
+    if ((pool->free_head == TFM_CRYPTO_FREE_LIST_END) && (pool->num > 0)) {
+        (void)reclaim_operation_context(type, pool);
+    }
+#endif
+    i = pool->free_head;
+    if (i == TFM_CRYPTO_FREE_LIST_END) {
+        return PSA_ERROR_NOT_PERMITTED;
     }
 
-    return PSA_ERROR_NOT_PERMITTED;
+    pool->free_head = pool->ops[i].next_free;
+    pool->ops[i].in_use = TFM_CRYPTO_IN_USE;
+    pool->ops[i].owner = partition_id;
+    pool->ops[i].generation++;
+#if CRYPTO_CONC_OPER_LEASE > 0
+    pool->ops[i].last_use = activity_count;
+#endif
+    *handle = ((uint32_t)pool->ops[i].generation << TFM_CRYPTO_HANDLE_GEN_SHIFT) |
+              ((uint32_t)type << TFM_CRYPTO_HANDLE_TYPE_SHIFT) | (i + 1);
+    *ctx = (void *)(pool->ctx + (i * pool->ctx_size));
+
+    return PSA_SUCCESS;
 }
 
 psa_status_t tfm_crypto_operation_release(uint32_t *handle)
@@ -121,12 +398,14 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle)
     uint32_t h_val = *handle;
     int32_t partition_id = 0;
     psa_status_t status;
+    struct tfm_crypto_operation_pool_s *pool;
+    uint32_t idx;
 
     /* Handle shall be cleaned up always at first */
     *handle = TFM_CRYPTO_INVALID_HANDLE;
 
     if ((h_val == TFM_CRYPTO_INVALID_HANDLE) ||
-        (h_val > CRYPTO_CONC_OPER_NUM)) {
+        !decode_handle(h_val, &pool, &idx)) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
@@ -135,13 +414,10 @@ psa_status_t tfm_crypto_operation_release(uint32_t *handle)
         return status;
     }
 
-    if ((operations[h_val - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[h_val - 1].owner == partition_id)) {
+    if ((pool->ops[idx].in_use == TFM_CRYPTO_IN_USE) &&
+        (pool->ops[idx].owner == partition_id)) {
 
-        memset_operation_context(h_val - 1);
-        operations[h_val - 1].in_use = TFM_CRYPTO_NOT_IN_USE;
-        operations[h_val - 1].type = TFM_CRYPTO_OPERATION_NONE;
-        operations[h_val - 1].owner = 0;
+        free_operation_context(pool, idx);
 
         return PSA_SUCCESS;
     }
@@ -155,9 +431,13 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
 {
     int32_t partition_id = 0;
     psa_status_t status;
+    struct tfm_crypto_operation_pool_s *pool;
+    uint32_t idx;
 
     if ((handle == TFM_CRYPTO_INVALID_HANDLE) ||
-        (handle > CRYPTO_CONC_OPER_NUM)) {
+        (((handle >> TFM_CRYPTO_HANDLE_TYPE_SHIFT) &
+          TFM_CRYPTO_HANDLE_TYPE_MASK) != (uint32_t)type) ||
+        !decode_handle(handle, &pool, &idx)) {
         return PSA_ERROR_BAD_STATE;
     }
 
@@ -170,10 +450,12 @@ psa_status_t tfm_crypto_operation_lookup(enum tfm_crypto_operation_type type,
         return status;
     }
 
-    if ((operations[handle - 1].in_use == TFM_CRYPTO_IN_USE) &&
-        (operations[handle - 1].type == type) &&
-        (operations[handle - 1].owner == partition_id)) {
-        *ctx = (void *) &(operations[handle - 1].operation);
+    if ((pool->ops[idx].in_use == TFM_CRYPTO_IN_USE) &&
+        (pool->ops[idx].owner == partition_id)) {
+#if CRYPTO_CONC_OPER_LEASE > 0
+        pool->ops[idx].last_use = ++activity_count;
+#endif
+        *ctx = (void *)(pool->ctx + (idx * pool->ctx_size));
         return PSA_SUCCESS;
     }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -16,6 +16,7 @@
 #include "tfm_crypto_defs.h"
 
 #include "crypto_library.h"
+#include "tfm_yield.h"
 
 /*!
  * \addtogroup tfm_crypto_api_shim_layer
@@ -24,6 +25,50 @@
 
 /*!@{*/
 #if CRYPTO_ASYM_SIGN_MODULE_ENABLED
+#if CRYPTO_SIGN_HASH_MAX_OPS > 0
+/* Signs a hash in steps of CRYPTO_SIGN_HASH_MAX_OPS ECC operations, with a
+ * preemption point between them. The algorithms which are not interruptible,
+ * such as RSA, are signed in one go.
+ */
+static psa_status_t tfm_crypto_sign_hash_in_steps(
+                                          tfm_crypto_library_key_id_t key,
+                                          psa_algorithm_t alg,
+                                          const uint8_t *hash,
+                                          size_t hash_length,
+                                          uint8_t *signature,
+                                          size_t signature_size,
+                                          size_t *signature_length)
+{
+    psa_sign_hash_interruptible_operation_t operation =
+                                    psa_sign_hash_interruptible_operation_init();
+    psa_status_t status;
+
+    psa_interruptible_set_max_ops(CRYPTO_SIGN_HASH_MAX_OPS);
+
+    status = psa_sign_hash_start(&operation, key, alg, hash, hash_length);
+    if (status == PSA_ERROR_NOT_SUPPORTED) {
+        return psa_sign_hash(key, alg, hash, hash_length,
+                             signature, signature_size, signature_length);
+    }
+
+    if (status == PSA_SUCCESS) {
+        do {
+            status = psa_sign_hash_complete(&operation, signature,
+                                            signature_size, signature_length);
+            if (status == PSA_OPERATION_INCOMPLETE) {
+                tfm_yield();
+            }
+        } while (status == PSA_OPERATION_INCOMPLETE);
+    }
+
+    if (status != PSA_SUCCESS) {
+        (void)psa_sign_hash_abort(&operation);
+    }
+
+    return status;
+}
+#endif /* CRYPTO_SIGN_HASH_MAX_OPS > 0 */
+
 psa_status_t tfm_crypto_asymmetric_sign_interface(psa_invec in_vec[],
                                                   psa_outvec out_vec[],
                                                   struct tfm_crypto_key_id_s *encoded_key)
@@ -65,8 +110,15 @@ psa_status_t tfm_crypto_asymmetric_sign_interface(psa_invec in_vec[],
         uint8_t *signature = out_vec[0].base;
         size_t signature_size = out_vec[0].len;
 
+#if CRYPTO_SIGN_HASH_MAX_OPS > 0
+        status = tfm_crypto_sign_hash_in_steps(library_key, iov->alg,
+                                               hash, hash_length,
+                                               signature, signature_size,
+                                               &(out_vec[0].len));
+#else
         status = psa_sign_hash(library_key, iov->alg, hash, hash_length,
                                signature, signature_size, &(out_vec[0].len));
+#endif
         if (status != PSA_SUCCESS) {
             out_vec[0].len = 0;
         }
@@ -82,6 +134,38 @@ psa_status_t tfm_crypto_asymmetric_sign_interface(psa_invec in_vec[],
         return psa_verify_hash(library_key, iov->alg, hash, hash_length,
                                signature, signature_length);
     }
+    case TFM_CRYPTO_ASYMMETRIC_VERIFY_HASH_BATCH_SID:
+    {
+        const uint8_t *hashes = in_vec[1].base;
+        const uint8_t *signatures = in_vec[2].base;
+        psa_status_t *results = out_vec[0].base;
+        size_t count = out_vec[0].len / sizeof(psa_status_t);
+        size_t hash_length;
+        size_t signature_length;
+
+        /* The pairs are packed back to back, each hash and each signature
+         * having the same length, so that the whole batch is a single
+         * request to the service.
+         */
+        if ((count == 0) ||
+            (out_vec[0].len != count * sizeof(psa_status_t)) ||
+            (in_vec[1].len % count != 0) || (in_vec[2].len % count != 0)) {
+            out_vec[0].len = 0;
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        hash_length = in_vec[1].len / count;
+        signature_length = in_vec[2].len / count;
+
+        for (size_t i = 0; i < count; i++) {
+            results[i] = psa_verify_hash(library_key, iov->alg,
+                                         &hashes[i * hash_length], hash_length,
+                                         &signatures[i * signature_length],
+                                         signature_length);
+            tfm_yield();
+        }
+        return PSA_SUCCESS;
+    }
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -67,4 +67,8 @@
 #error "CRYPTO_KEY_DERIVATION_MODULE_ENABLED enables, but not all prerequisites (missing key derivation algorithms)!"
 #endif
 
+#if (CRYPTO_SIGN_HASH_MAX_OPS > 0) && defined(MBEDTLS_ECDSA_SIGN_ALT)
+#error "CRYPTO_SIGN_HASH_MAX_OPS needs the mbed TLS ECDSA signature, it cannot be used with an alternative one such as the CC312 driver!"
+#endif
+
 #endif /* __CRYPTO_CHECK_CONFIG_H__ */
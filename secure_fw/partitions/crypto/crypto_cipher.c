@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -148,6 +148,12 @@ psa_status_t tfm_crypto_cipher_interface(psa_invec in_vec[],
     break;
     case TFM_CRYPTO_CIPHER_UPDATE_SID:
     {
+        /*
+         * Without MM-IOVEC, an input larger than the scratch is passed here
+         * one chunk at a time within the same client call, see
+         * tfm_crypto_call_srv_stream(). The operation keeps the state between
+         * the chunks, so the output is the same as for a single update.
+         */
         const uint8_t *input = in_vec[1].base;
         size_t input_length = in_vec[1].len;
         unsigned char *output = out_vec[0].base;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -48,6 +48,37 @@ psa_status_t tfm_crypto_hash_interface(psa_invec in_vec[],
 #endif
     }
 
+    if (sid == TFM_CRYPTO_HASH_COMPUTE_MULTI_SID) {
+#if CRYPTO_SINGLE_PART_FUNCS_DISABLED
+        return PSA_ERROR_NOT_SUPPORTED;
+#else
+        psa_hash_operation_t multi_operation = PSA_HASH_OPERATION_INIT;
+        uint8_t *hash = out_vec[0].base;
+        size_t hash_size = out_vec[0].len;
+        size_t i;
+
+        /* Every in_vec after the first one is a buffer to hash. The unused
+         * ones are empty, and hashing them has no effect.
+         */
+        status = psa_hash_setup(&multi_operation, iov->alg);
+        for (i = 1; (i < PSA_MAX_IOVEC) && (status == PSA_SUCCESS); i++) {
+            if (in_vec[i].len != 0) {
+                status = psa_hash_update(&multi_operation, in_vec[i].base,
+                                         in_vec[i].len);
+            }
+        }
+        if (status == PSA_SUCCESS) {
+            status = psa_hash_finish(&multi_operation, hash, hash_size,
+                                     &out_vec[0].len);
+        }
+        if (status != PSA_SUCCESS) {
+            (void)psa_hash_abort(&multi_operation);
+            out_vec[0].len = 0;
+        }
+        return status;
+#endif
+    }
+
     if (sid == TFM_CRYPTO_HASH_COMPARE_SID) {
 #if CRYPTO_SINGLE_PART_FUNCS_DISABLED
         return PSA_ERROR_NOT_SUPPORTED;
@@ -165,6 +196,24 @@ psa_status_t tfm_crypto_hash_interface(psa_invec in_vec[],
         }
     }
     break;
+    case TFM_CRYPTO_HASH_FINISH_COPY_SID:
+    {
+        psa_hash_operation_t copy_operation = PSA_HASH_OPERATION_INIT;
+        uint8_t *hash = out_vec[0].base;
+        size_t hash_size = out_vec[0].len;
+
+        /* Finish a local copy, the operation of the client carries on */
+        status = psa_hash_clone(operation, &copy_operation);
+        if (status == PSA_SUCCESS) {
+            status = psa_hash_finish(&copy_operation, hash, hash_size,
+                                     &out_vec[0].len);
+        }
+        if (status != PSA_SUCCESS) {
+            (void)psa_hash_abort(&copy_operation);
+            out_vec[0].len = 0;
+        }
+    }
+    break;
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -185,6 +185,204 @@ static psa_status_t tfm_crypto_init_iovecs(const psa_msg_t *msg,
 
     return PSA_SUCCESS;
 }
+
+/**
+ * \brief Size of the input chunks of a streamed call. The output of each chunk
+ *        can exceed its input by up to a cipher block, and both fit the scratch.
+ */
+#define TFM_CRYPTO_STREAM_CHUNK_SIZE                                           \
+    (((CRYPTO_IOVEC_BUFFER_SIZE - PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE) / 2) &      \
+     ~(TFM_CRYPTO_IOVEC_ALIGNMENT - 1))
+
+/*
+ * Multipart update calls with an input larger than a chunk are streamed, so
+ * that they are not capped by the size of the scratch.
+ */
+static bool tfm_crypto_is_stream_call(const psa_msg_t *msg,
+                                      const struct tfm_crypto_pack_iovec *iov,
+                                      size_t in_len,
+                                      size_t out_len)
+{
+    switch (iov->function_id) {
+    case TFM_CRYPTO_HASH_UPDATE_SID:
+    case TFM_CRYPTO_MAC_UPDATE_SID:
+    case TFM_CRYPTO_AEAD_UPDATE_AD_SID:
+        if (out_len != 0) {
+            return false;
+        }
+        break;
+    case TFM_CRYPTO_CIPHER_UPDATE_SID:
+    case TFM_CRYPTO_AEAD_UPDATE_SID:
+        if (out_len != 1) {
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    return (in_len == 2) && (msg->in_size[1] > TFM_CRYPTO_STREAM_CHUNK_SIZE);
+}
+
+/*
+ * Read the input one chunk at a time and feed each chunk to the update
+ * function, writing its output back before the next chunk is read.
+ */
+static psa_status_t tfm_crypto_call_srv_stream(const psa_msg_t *msg,
+                                               psa_invec in_vec[],
+                                               psa_outvec out_vec[],
+                                               size_t out_len)
+{
+    size_t in_remaining = msg->in_size[1];
+    size_t out_remaining = (out_len > 0) ? msg->out_size[0] : 0;
+    size_t chunk;
+    void *in_buf = NULL;
+    void *out_buf = NULL;
+    psa_status_t status;
+
+    status = tfm_crypto_alloc_scratch(TFM_CRYPTO_STREAM_CHUNK_SIZE, &in_buf);
+    if ((status == PSA_SUCCESS) && (out_len > 0)) {
+        status = tfm_crypto_alloc_scratch(TFM_CRYPTO_STREAM_CHUNK_SIZE +
+                                          PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE,
+                                          &out_buf);
+    }
+
+    while ((status == PSA_SUCCESS) && (in_remaining > 0)) {
+        chunk = (in_remaining < TFM_CRYPTO_STREAM_CHUNK_SIZE) ?
+                in_remaining : TFM_CRYPTO_STREAM_CHUNK_SIZE;
+
+        in_vec[1].base = in_buf;
+        in_vec[1].len = psa_read(msg->handle, 1, in_buf, chunk);
+        if (in_vec[1].len != chunk) {
+            status = PSA_ERROR_GENERIC_ERROR;
+            break;
+        }
+        in_remaining -= chunk;
+
+        if (out_len > 0) {
+            out_vec[0].base = out_buf;
+            out_vec[0].len = TFM_CRYPTO_STREAM_CHUNK_SIZE +
+                             PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE;
+            if (out_vec[0].len > out_remaining) {
+                out_vec[0].len = out_remaining;
+            }
+        }
+
+        status = tfm_crypto_api_dispatcher(in_vec, 2, out_vec, out_len);
+
+        if ((status == PSA_SUCCESS) && (out_len > 0) && (out_vec[0].len > 0)) {
+            psa_write(msg->handle, 0, out_buf, out_vec[0].len);
+            out_remaining -= out_vec[0].len;
+        }
+    }
+
+    /* Clear the allocated internal scratch before returning */
+    tfm_crypto_clear_scratch();
+
+    return status;
+}
+
+#if (CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE > 0) && !CRYPTO_SINGLE_PART_FUNCS_DISABLED
+/**
+ * \brief Size of the output buffer of the fast path, large enough for any hash
+ *        or MAC, and for the IV and padding of a cipher of the largest input.
+ */
+#define TFM_CRYPTO_FAST_PATH_OUT_SIZE                                          \
+    (CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE + PSA_CIPHER_IV_MAX_SIZE +         \
+     PSA_BLOCK_CIPHER_BLOCK_MAX_SIZE + PSA_HASH_MAX_SIZE)
+
+static bool tfm_crypto_is_fast_call(const psa_msg_t *msg,
+                                    const struct tfm_crypto_pack_iovec *iov,
+                                    size_t in_len,
+                                    size_t out_len)
+{
+    switch (iov->function_id) {
+#if CRYPTO_HASH_MODULE_ENABLED
+    case TFM_CRYPTO_HASH_COMPUTE_SID:
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+    case TFM_CRYPTO_MAC_COMPUTE_SID:
+#endif
+#if CRYPTO_CIPHER_MODULE_ENABLED
+    case TFM_CRYPTO_CIPHER_ENCRYPT_SID:
+    case TFM_CRYPTO_CIPHER_DECRYPT_SID:
+#endif
+        break;
+    default:
+        return false;
+    }
+
+    return (in_len == 2) && (out_len == 1) &&
+           (msg->in_size[1] <= CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE);
+}
+
+/*
+ * One-shot hash, MAC and cipher calls on small inputs are served with buffers
+ * on the stack and call the PSA Crypto core directly, bypassing the scratch
+ * and the sub-module dispatch.
+ */
+static psa_status_t tfm_crypto_call_srv_fast(const psa_msg_t *msg,
+                                             const struct tfm_crypto_pack_iovec *iov)
+{
+    uint8_t input[CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE];
+    uint8_t output[TFM_CRYPTO_FAST_PATH_OUT_SIZE];
+    size_t input_length;
+    size_t output_size = msg->out_size[0];
+    size_t output_length = 0;
+    tfm_crypto_library_key_id_t library_key =
+            tfm_crypto_library_key_id_init(msg->client_id, iov->key_id);
+    psa_status_t status;
+
+    /* No output exceeds the buffer, so capping the size cannot make a call fail */
+    if (output_size > sizeof(output)) {
+        output_size = sizeof(output);
+    }
+
+    input_length = psa_read(msg->handle, 1, input, msg->in_size[1]);
+    if (input_length != msg->in_size[1]) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    switch (iov->function_id) {
+#if CRYPTO_HASH_MODULE_ENABLED
+    case TFM_CRYPTO_HASH_COMPUTE_SID:
+        status = psa_hash_compute(iov->alg, input, input_length,
+                                  output, output_size, &output_length);
+        break;
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+    case TFM_CRYPTO_MAC_COMPUTE_SID:
+        status = psa_mac_compute(library_key, iov->alg, input, input_length,
+                                 output, output_size, &output_length);
+        break;
+#endif
+#if CRYPTO_CIPHER_MODULE_ENABLED
+    case TFM_CRYPTO_CIPHER_ENCRYPT_SID:
+        status = psa_cipher_encrypt(library_key, iov->alg, input, input_length,
+                                    output, output_size, &output_length);
+        break;
+    case TFM_CRYPTO_CIPHER_DECRYPT_SID:
+        status = psa_cipher_decrypt(library_key, iov->alg, input, input_length,
+                                    output, output_size, &output_length);
+        break;
+#endif
+    default:
+        status = PSA_ERROR_NOT_SUPPORTED;
+        break;
+    }
+
+    if (status != PSA_SUCCESS) {
+        output_length = 0;
+    }
+    psa_write(msg->handle, 0, output, output_length);
+
+    (void)library_key;
+    (void)memset(input, 0, sizeof(input));
+    (void)memset(output, 0, sizeof(output));
+
+    return status;
+}
+#endif /* (CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE > 0) && !CRYPTO_SINGLE_PART_FUNCS_DISABLED */
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
 
 static psa_status_t tfm_crypto_call_srv(const psa_msg_t *msg)
@@ -218,6 +416,22 @@ static psa_status_t tfm_crypto_call_srv(const psa_msg_t *msg)
     in_vec[0].base = &iov;
     in_vec[0].len = sizeof(struct tfm_crypto_pack_iovec);
 
+#if PSA_FRAMEWORK_HAS_MM_IOVEC != 1
+#if (CRYPTO_SINGLE_PART_FAST_PATH_MAX_SIZE > 0) && !CRYPTO_SINGLE_PART_FUNCS_DISABLED
+    if (tfm_crypto_is_fast_call(msg, &iov, in_len, out_len)) {
+        tfm_crypto_set_caller_id(msg->client_id);
+        status = tfm_crypto_call_srv_fast(msg, &iov);
+        tfm_crypto_clear_scratch();
+        return status;
+    }
+#endif
+
+    if (tfm_crypto_is_stream_call(msg, &iov, in_len, out_len)) {
+        tfm_crypto_set_caller_id(msg->client_id);
+        return tfm_crypto_call_srv_stream(msg, in_vec, out_vec, out_len);
+    }
+#endif
+
     status = tfm_crypto_init_iovecs(msg, in_vec, in_len, out_vec, out_len);
     if (status != PSA_SUCCESS) {
         return status;
@@ -331,6 +545,69 @@ psa_status_t tfm_crypto_sfn(const psa_msg_t *msg)
     return PSA_ERROR_GENERIC_ERROR;
 }
 
+#if CRYPTO_HASH_MODULE_ENABLED
+static psa_status_t tfm_crypto_hash_dispatch(psa_invec in_vec[],
+                                             psa_outvec out_vec[],
+                                             struct tfm_crypto_key_id_s *encoded_key)
+{
+    (void)encoded_key;
+
+    return tfm_crypto_hash_interface(in_vec, out_vec);
+}
+#endif
+
+#if CRYPTO_RNG_MODULE_ENABLED
+static psa_status_t tfm_crypto_random_dispatch(psa_invec in_vec[],
+                                               psa_outvec out_vec[],
+                                               struct tfm_crypto_key_id_s *encoded_key)
+{
+    (void)encoded_key;
+
+    return tfm_crypto_random_interface(in_vec, out_vec);
+}
+#endif
+
+typedef psa_status_t (*tfm_crypto_group_interface_t)(
+                                    psa_invec in_vec[],
+                                    psa_outvec out_vec[],
+                                    struct tfm_crypto_key_id_s *encoded_key);
+
+/**
+ * \brief Sub-module interface of each group ID, built from the enabled modules.
+ *        The entry of a disabled module is NULL, so that its handlers are not
+ *        referenced and can be discarded at link time.
+ */
+static const tfm_crypto_group_interface_t
+                tfm_crypto_group_interfaces[TFM_CRYPTO_GROUP_ID_KEY_DERIVATION + 1] = {
+#if CRYPTO_RNG_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_RANDOM] = tfm_crypto_random_dispatch,
+#endif
+#if CRYPTO_KEY_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_KEY_MANAGEMENT] = tfm_crypto_key_management_interface,
+#endif
+#if CRYPTO_HASH_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_HASH] = tfm_crypto_hash_dispatch,
+#endif
+#if CRYPTO_MAC_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_MAC] = tfm_crypto_mac_interface,
+#endif
+#if CRYPTO_CIPHER_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_CIPHER] = tfm_crypto_cipher_interface,
+#endif
+#if CRYPTO_AEAD_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_AEAD] = tfm_crypto_aead_interface,
+#endif
+#if CRYPTO_ASYM_SIGN_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_ASYM_SIGN] = tfm_crypto_asymmetric_sign_interface,
+#endif
+#if CRYPTO_ASYM_ENCRYPT_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_ASYM_ENCRYPT] = tfm_crypto_asymmetric_encrypt_interface,
+#endif
+#if CRYPTO_KEY_DERIVATION_MODULE_ENABLED
+    [TFM_CRYPTO_GROUP_ID_KEY_DERIVATION] = tfm_crypto_key_derivation_interface,
+#endif
+};
+
 psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
                                        size_t in_len,
                                        psa_outvec out_vec[],
@@ -342,6 +619,7 @@ psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
     struct tfm_crypto_key_id_s encoded_key = TFM_CRYPTO_KEY_ID_S_INIT;
     bool is_key_required = false;
     enum tfm_crypto_group_id group_id;
+    tfm_crypto_group_interface_t group_interface;
 
     if (in_vec[0].len != sizeof(struct tfm_crypto_pack_iovec)) {
         return PSA_ERROR_PROGRAMMER_ERROR;
@@ -349,6 +627,15 @@ psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
 
     group_id = TFM_CRYPTO_GET_GROUP_ID(iov->function_id);
 
+    /* Dispatch to each sub-module based on the Group ID */
+    if ((uint32_t)group_id >= (sizeof(tfm_crypto_group_interfaces) /
+                               sizeof(tfm_crypto_group_interfaces[0])) ||
+        (tfm_crypto_group_interfaces[group_id] == NULL)) {
+        LOG_ERRFMT("[ERR][Crypto] Unsupported request!\r\n");
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+    group_interface = tfm_crypto_group_interfaces[group_id];
+
     is_key_required = !((group_id == TFM_CRYPTO_GROUP_ID_HASH) ||
                         (group_id == TFM_CRYPTO_GROUP_ID_RANDOM));
 
@@ -364,34 +651,5 @@ psa_status_t tfm_crypto_api_dispatcher(psa_invec in_vec[],
         encoded_key.owner = caller_id;
     }
 
-    /* Dispatch to each sub-module based on the Group ID */
-    switch (group_id) {
-    case TFM_CRYPTO_GROUP_ID_KEY_MANAGEMENT:
-        return tfm_crypto_key_management_interface(in_vec, out_vec,
-                                                   &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_HASH:
-        return tfm_crypto_hash_interface(in_vec, out_vec);
-    case TFM_CRYPTO_GROUP_ID_MAC:
-        return tfm_crypto_mac_interface(in_vec, out_vec, &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_CIPHER:
-        return tfm_crypto_cipher_interface(in_vec, out_vec, &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_AEAD:
-        return tfm_crypto_aead_interface(in_vec, out_vec, &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_ASYM_SIGN:
-        return tfm_crypto_asymmetric_sign_interface(in_vec, out_vec,
-                                                    &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_ASYM_ENCRYPT:
-        return tfm_crypto_asymmetric_encrypt_interface(in_vec, out_vec,
-                                                       &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_KEY_DERIVATION:
-        return tfm_crypto_key_derivation_interface(in_vec, out_vec,
-                                                   &encoded_key);
-    case TFM_CRYPTO_GROUP_ID_RANDOM:
-        return tfm_crypto_random_interface(in_vec, out_vec);
-    default:
-        LOG_ERRFMT("[ERR][Crypto] Unsupported request!\r\n");
-        return PSA_ERROR_NOT_SUPPORTED;
-    }
-
-    return PSA_ERROR_NOT_SUPPORTED;
+    return group_interface(in_vec, out_vec, &encoded_key);
 }
@@ -5,6 +5,7 @@
  *
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -22,6 +23,7 @@
  *        IDs.
  */
 #include "tfm_plat_crypto_keys.h"
+#include "tfm_builtin_key_ids.h"
 
 /**
  * \brief These includes are required to get the interface that TF-M crypto
@@ -63,7 +65,242 @@ static char mbedtls_version_full[18];
  *
  */
 #include "config_engine_buf.h"
-static uint8_t mbedtls_mem_buf[CRYPTO_ENGINE_BUF_SIZE] = {0};
+static uint8_t mbedtls_mem_buf[CRYPTO_ENGINE_BUF_SIZE] __attribute__((aligned(8))) = {0};
+
+#if CRYPTO_ENGINE_BUF_ARENA_SIZE > 0
+/**
+ * \brief Arena allocator mode for the engine buffer
+ *
+ * The first CRYPTO_ENGINE_BUF_ARENA_SIZE bytes of the engine buffer are a bump
+ * arena which serves the short lived allocations of the engine. The top block
+ * is given back when it is freed, and the whole arena is rewound as soon as
+ * every block in it has been freed. Allocations that do not fit the arena fall
+ * back to a first-fit, address ordered and coalescing heap in the rest of the
+ * buffer. Mbed TLS does not expose the allocator behind
+ * mbedtls_memory_buffer_alloc_init(), hence the fallback heap is kept here.
+ *
+ * The allocation statistics are logged when an allocation fails, so that
+ * CRYPTO_ENGINE_BUF_SIZE can be sized from the high-water marks and the
+ * fragmentation of the heap.
+ */
+#define ENGINE_ALLOC_ALIGN        (8u)
+#define ENGINE_ALLOC_ROUND(x)     (((x) + ENGINE_ALLOC_ALIGN - 1) & ~(ENGINE_ALLOC_ALIGN - 1))
+#define ENGINE_ARENA_SIZE         ENGINE_ALLOC_ROUND(CRYPTO_ENGINE_BUF_ARENA_SIZE)
+
+#if ENGINE_ARENA_SIZE + 64 > CRYPTO_ENGINE_BUF_SIZE
+#error "Invalid config: CRYPTO_ENGINE_BUF_ARENA_SIZE leaves no room for the fallback heap!"
+#endif
+
+/* Header of every block, ENGINE_ALLOC_ALIGN bytes so that payloads stay aligned */
+struct engine_block_t {
+    uint32_t size;                /* Size of the block including this header */
+    uint32_t next;                /* Offset of the next free heap block, 0 if last */
+};
+
+#define ENGINE_HDR_SIZE           ((uint32_t)sizeof(struct engine_block_t))
+#define ENGINE_HEAP_BASE          (&mbedtls_mem_buf[ENGINE_ARENA_SIZE])
+#define ENGINE_HEAP_SIZE          ((uint32_t)(CRYPTO_ENGINE_BUF_SIZE - ENGINE_ARENA_SIZE) & \
+                                   ~(ENGINE_ALLOC_ALIGN - 1))
+#define ENGINE_BLOCK_AT(off)      ((struct engine_block_t *)(ENGINE_HEAP_BASE + (off)))
+/* Heap offsets are biased by one block header so that 0 terminates the list */
+#define ENGINE_FREE_LIST_END      (0u)
+
+/* Allocation statistics, all sizes in bytes including the block header */
+struct engine_mem_stats_t {
+    uint32_t arena_high_water;  /* Maximum bytes ever taken from the arena */
+    uint32_t arena_allocs;      /* Number of allocations served by the arena */
+    uint32_t heap_used;         /* Bytes currently allocated from the heap */
+    uint32_t heap_high_water;   /* Maximum bytes ever allocated from the heap */
+    uint32_t heap_allocs;       /* Number of allocations served by the heap */
+    uint32_t failed_allocs;     /* Number of allocations which failed */
+};
+
+static uint32_t engine_arena_top;      /* First free byte of the arena */
+static uint32_t engine_arena_live;     /* Number of allocated arena blocks */
+static uint32_t engine_heap_free_head; /* Offset of the first free block + 1 */
+static struct engine_mem_stats_t engine_stats;
+
+static void engine_heap_init(void)
+{
+    struct engine_block_t *blk = ENGINE_BLOCK_AT(0);
+
+    blk->size = ENGINE_HEAP_SIZE;
+    blk->next = ENGINE_FREE_LIST_END;
+    engine_heap_free_head = 1;
+}
+
+static void *engine_heap_alloc(uint32_t size)
+{
+    uint32_t *link = &engine_heap_free_head;
+
+    while (*link != ENGINE_FREE_LIST_END) {
+        uint32_t off = *link - 1;
+        struct engine_block_t *blk = ENGINE_BLOCK_AT(off);
+
+        if (blk->size >= size) {
+            if (blk->size - size >= ENGINE_HDR_SIZE + ENGINE_ALLOC_ALIGN) {
+                /* Split, keeping the tail on the free list */
+                struct engine_block_t *rest = ENGINE_BLOCK_AT(off + size);
+
+                rest->size = blk->size - size;
+                rest->next = blk->next;
+                blk->size = size;
+                *link = off + size + 1;
+            } else {
+                *link = blk->next;
+            }
+            blk->next = ENGINE_FREE_LIST_END;
+
+            engine_stats.heap_used += blk->size;
+            if (engine_stats.heap_used > engine_stats.heap_high_water) {
+                engine_stats.heap_high_water = engine_stats.heap_used;
+            }
+            return (uint8_t *)blk + ENGINE_HDR_SIZE;
+        }
+        link = &blk->next;
+    }
+
+    return NULL;
+}
+
+static void engine_heap_free(struct engine_block_t *blk)
+{
+    uint32_t off = (uint32_t)((uint8_t *)blk - ENGINE_HEAP_BASE);
+    uint32_t *link = &engine_heap_free_head;
+    struct engine_block_t *prev = NULL;
+
+    engine_stats.heap_used -= blk->size;
+
+    /* Keep the free list sorted by address to be able to coalesce */
+    while (*link != ENGINE_FREE_LIST_END && *link - 1 < off) {
+        prev = ENGINE_BLOCK_AT(*link - 1);
+        link = &prev->next;
+    }
+
+    blk->next = *link;
+    *link = off + 1;
+
+    if (blk->next != ENGINE_FREE_LIST_END && off + blk->size == blk->next - 1) {
+        struct engine_block_t *next = ENGINE_BLOCK_AT(blk->next - 1);
+
+        blk->size += next->size;
+        blk->next = next->next;
+    }
+
+    if (prev != NULL &&
+        (uint32_t)((uint8_t *)prev - ENGINE_HEAP_BASE) + prev->size == off) {
+        prev->size += blk->size;
+        prev->next = blk->next;
+    }
+}
+
+/* Logs the statistics on a failed allocation of size bytes, 0 if it overflows */
+static void engine_log_stats(uint32_t size)
+{
+#if (TFM_PARTITION_LOG_LEVEL == TFM_PARTITION_LOG_LEVEL_DEBUG)
+    uint32_t free_total = 0;
+    uint32_t free_largest = 0;
+    uint32_t link = engine_heap_free_head;
+
+    while (link != ENGINE_FREE_LIST_END) {
+        struct engine_block_t *blk = ENGINE_BLOCK_AT(link - 1);
+
+        free_total += blk->size;
+        if (blk->size > free_largest) {
+            free_largest = blk->size;
+        }
+        link = blk->next;
+    }
+
+    /* free_total minus free_largest is the fragmentation of the heap */
+    LOG_DBGFMT("[DBG][Crypto] Engine allocation of %u bytes failed: arena %u "
+               "high %u allocs %u, heap %u high %u allocs %u free %u "
+               "largest %u, failures %u\r\n",
+               (unsigned int)size, (unsigned int)engine_arena_top,
+               (unsigned int)engine_stats.arena_high_water,
+               (unsigned int)engine_stats.arena_allocs,
+               (unsigned int)engine_stats.heap_used,
+               (unsigned int)engine_stats.heap_high_water,
+               (unsigned int)engine_stats.heap_allocs,
+               (unsigned int)free_total, (unsigned int)free_largest,
+               (unsigned int)engine_stats.failed_allocs);
+#else
+    (void)size;
+#endif
+}
+
+static void *engine_calloc(size_t n, size_t size)
+{
+    uint32_t total;
+    uint8_t *p = NULL;
+
+    if (n == 0 || size == 0) {
+        return NULL;
+    }
+
+    if (size > (CRYPTO_ENGINE_BUF_SIZE / n)) {
+        engine_stats.failed_allocs++;
+        engine_log_stats(0);
+        return NULL;
+    }
+
+    total = ENGINE_HDR_SIZE + ENGINE_ALLOC_ROUND((uint32_t)(n * size));
+
+    /* Fast path, bump allocation in the arena */
+    if (total <= ENGINE_ARENA_SIZE - engine_arena_top) {
+        struct engine_block_t *blk =
+            (struct engine_block_t *)&mbedtls_mem_buf[engine_arena_top];
+
+        blk->size = total;
+        blk->next = ENGINE_FREE_LIST_END;
+        engine_arena_top += total;
+        engine_arena_live++;
+        if (engine_arena_top > engine_stats.arena_high_water) {
+            engine_stats.arena_high_water = engine_arena_top;
+        }
+        engine_stats.arena_allocs++;
+        p = (uint8_t *)blk + ENGINE_HDR_SIZE;
+    } else {
+        p = engine_heap_alloc(total);
+        if (p == NULL) {
+            engine_stats.failed_allocs++;
+            engine_log_stats(total);
+            return NULL;
+        }
+        engine_stats.heap_allocs++;
+    }
+
+    memset(p, 0, total - ENGINE_HDR_SIZE);
+    return p;
+}
+
+static void engine_free(void *ptr)
+{
+    struct engine_block_t *blk;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    blk = (struct engine_block_t *)((uint8_t *)ptr - ENGINE_HDR_SIZE);
+
+    if ((uint8_t *)blk < ENGINE_HEAP_BASE) {
+        uint32_t off = (uint32_t)((uint8_t *)blk - mbedtls_mem_buf);
+
+        /* Give back the top of the arena, then everything once it is empty */
+        if (off + blk->size == engine_arena_top) {
+            engine_arena_top = off;
+        }
+        if (--engine_arena_live == 0) {
+            engine_arena_top = 0;
+        }
+        return;
+    }
+
+    engine_heap_free(blk);
+}
+
+#endif /* CRYPTO_ENGINE_BUF_ARENA_SIZE > 0 */
 
 /*!
  * \defgroup tfm_crypto_library Set of functions implementing the abstractions of the underlying cryptographic
@@ -88,8 +325,17 @@ psa_status_t tfm_crypto_core_library_init(void)
     /* Initialise the Mbed Crypto memory allocator to use static memory
      * allocation from the provided buffer instead of using the heap
      */
+#if CRYPTO_ENGINE_BUF_ARENA_SIZE > 0
+    engine_arena_top = 0;
+    engine_arena_live = 0;
+    engine_heap_init();
+    if (mbedtls_platform_set_calloc_free(engine_calloc, engine_free) != 0) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+#else
     mbedtls_memory_buffer_alloc_init(mbedtls_mem_buf,
                                      CRYPTO_ENGINE_BUF_SIZE);
+#endif /* CRYPTO_ENGINE_BUF_ARENA_SIZE > 0 */
 
     /* mbedtls_printf is used to print messages including error information. */
 #if (TFM_PARTITION_LOG_LEVEL >= TFM_PARTITION_LOG_LEVEL_ERROR)
@@ -153,6 +399,40 @@ psa_status_t tfm_crypto_core_library_key_attributes_to_client(
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Number of key IDs in the TF-M builtin key range
+ */
+#define TFM_BUILTIN_KEY_ID_RANGE \
+    ((size_t)TFM_BUILTIN_KEY_ID_MAX - (size_t)TFM_BUILTIN_KEY_ID_MIN)
+
+/**
+ * \brief Index plus 1 in the platform descriptor table of each key ID in the
+ *        builtin key range, 0 if the key ID has no descriptor. It is built on
+ *        first use, as the table is constant, so that using a builtin key
+ *        doesn't scan the table each time.
+ */
+static uint8_t g_builtin_key_desc_idx[TFM_BUILTIN_KEY_ID_RANGE];
+static bool g_builtin_key_desc_idx_valid = false;
+
+static void builtin_key_desc_idx_build(
+                             const tfm_plat_builtin_key_descriptor_t *desc_table,
+                             size_t number_of_keys)
+{
+    size_t offset;
+
+    for (size_t idx = 0; (idx < number_of_keys) && (idx < UINT8_MAX); idx++) {
+        offset = (size_t)desc_table[idx].key_id - (size_t)TFM_BUILTIN_KEY_ID_MIN;
+        /* Keep the first descriptor of a key ID, as the linear scan did */
+        if ((desc_table[idx].key_id >= TFM_BUILTIN_KEY_ID_MIN) &&
+            (offset < TFM_BUILTIN_KEY_ID_RANGE) &&
+            (g_builtin_key_desc_idx[offset] == 0)) {
+            g_builtin_key_desc_idx[offset] = (uint8_t)(idx + 1);
+        }
+    }
+
+    g_builtin_key_desc_idx_valid = true;
+}
+
 /**
  * \brief This function is required by mbed TLS to enable support for
  *        platform builtin keys in the PSA Crypto core layer implemented
@@ -170,9 +450,29 @@ psa_status_t mbedtls_psa_platform_get_builtin_key(
 {
     const tfm_plat_builtin_key_descriptor_t *desc_table = NULL;
     size_t number_of_keys = tfm_plat_builtin_key_get_desc_table_ptr(&desc_table);
+    psa_key_id_t id = MBEDTLS_SVC_KEY_ID_GET_KEY_ID(key_id);
+    size_t offset = (size_t)id - (size_t)TFM_BUILTIN_KEY_ID_MIN;
+    size_t idx;
+
+    if ((id >= TFM_BUILTIN_KEY_ID_MIN) && (offset < TFM_BUILTIN_KEY_ID_RANGE) &&
+        (number_of_keys < UINT8_MAX)) {
+        if (!g_builtin_key_desc_idx_valid) {
+            builtin_key_desc_idx_build(desc_table, number_of_keys);
+        }
+
+        idx = g_builtin_key_desc_idx[offset];
+        if (idx == 0) {
+            return PSA_ERROR_DOES_NOT_EXIST;
+        }
+
+        *lifetime = desc_table[idx - 1].lifetime;
+        *slot_number = desc_table[idx - 1].slot_number;
+        return PSA_SUCCESS;
+    }
 
-    for (size_t idx = 0; idx < number_of_keys; idx++) {
-        if (desc_table[idx].key_id == MBEDTLS_SVC_KEY_ID_GET_KEY_ID(key_id)) {
+    /* Key IDs outside of the range, or too many keys to index */
+    for (idx = 0; idx < number_of_keys; idx++) {
+        if (desc_table[idx].key_id == id) {
             *lifetime = desc_table[idx].lifetime;
             *slot_number = desc_table[idx].slot_number;
             return PSA_SUCCESS;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2021, Nordic Semiconductor ASA.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "config_tfm.h"
 #include "tfm_mbedcrypto_include.h"
@@ -21,6 +22,38 @@
  */
 
 /*!@{*/
+#if CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0)
+/*!
+ * \brief Pool of DRBG output used to serve the small random requests. It is
+ *        refilled with a single DRBG call once it cannot serve a request, and
+ *        consumed from its end, wiping the bytes handed out so that the pool
+ *        never holds output which has already been given to a caller.
+ */
+static uint8_t rng_pool[CRYPTO_RNG_POOL_SIZE];
+static size_t rng_pool_avail;
+
+static psa_status_t rng_pool_generate(uint8_t *output, size_t output_size)
+{
+    psa_status_t status;
+
+    if (output_size > rng_pool_avail) {
+        status = psa_generate_random(rng_pool, sizeof(rng_pool));
+        if (status != PSA_SUCCESS) {
+            memset(rng_pool, 0, sizeof(rng_pool));
+            rng_pool_avail = 0;
+            return status;
+        }
+        rng_pool_avail = sizeof(rng_pool);
+    }
+
+    rng_pool_avail -= output_size;
+    memcpy(output, &rng_pool[rng_pool_avail], output_size);
+    memset(&rng_pool[rng_pool_avail], 0, output_size);
+
+    return PSA_SUCCESS;
+}
+#endif /* CRYPTO_RNG_MODULE_ENABLED && (CRYPTO_RNG_POOL_SIZE > 0) */
+
 psa_status_t tfm_crypto_random_interface(psa_invec in_vec[],
                                          psa_outvec out_vec[])
 {
@@ -33,6 +66,15 @@ psa_status_t tfm_crypto_random_interface(psa_invec in_vec[],
     uint8_t *output = out_vec[0].base;
     size_t output_size = out_vec[0].len;
 
+#if CRYPTO_RNG_POOL_SIZE > 0
+    /* Larger requests, and the randomness drawn internally for key
+     * generation, always come fresh from the DRBG
+     */
+    if (output_size <= CRYPTO_RNG_POOL_MAX_REQUEST) {
+        return rng_pool_generate(output, output_size);
+    }
+#endif /* CRYPTO_RNG_POOL_SIZE > 0 */
+
     return psa_generate_random(output, output_size);
 #endif
 }
@@ -154,6 +154,14 @@
         PSA_FUNCTION_NAME(psa_sign_hash)
 #define psa_verify_hash \
         PSA_FUNCTION_NAME(psa_verify_hash)
+#define psa_interruptible_set_max_ops \
+        PSA_FUNCTION_NAME(psa_interruptible_set_max_ops)
+#define psa_sign_hash_start \
+        PSA_FUNCTION_NAME(psa_sign_hash_start)
+#define psa_sign_hash_complete \
+        PSA_FUNCTION_NAME(psa_sign_hash_complete)
+#define psa_sign_hash_abort \
+        PSA_FUNCTION_NAME(psa_sign_hash_abort)
 #define psa_asymmetric_encrypt \
         PSA_FUNCTION_NAME(psa_asymmetric_encrypt)
 #define psa_asymmetric_decrypt \
@@ -5,6 +5,7 @@
  *
  */
 #include <string.h>
+#include "config_tfm.h"
 #if defined(TFM_BUILTIN_KEY_LOADER_DERIVE_KEY_USING_PSA)
 #include "tfm_mbedcrypto_include.h"
 #else
@@ -41,6 +42,86 @@ struct tfm_builtin_key_t {
  */
 static struct tfm_builtin_key_t g_builtin_key_slots[TFM_BUILTIN_MAX_KEYS] = {0};
 
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+/*!
+ * \brief A structure which describes a cached per-user subkey derived from a
+ *        builtin key slot
+ */
+struct tfm_builtin_key_cache_entry_t {
+    uint8_t __attribute__((aligned(4))) key[TFM_BUILTIN_MAX_KEY_LEN]; /*!< Derived key material */
+    size_t key_len;                        /*!< Size of the derived key material */
+    psa_drv_slot_number_t slot_number;     /*!< Builtin slot the key was derived from */
+    int32_t user;                          /*!< Partition the key was derived for */
+    uint32_t last_use;                     /*!< Stamp of the last lookup, for LRU eviction */
+    uint32_t is_valid;                     /*!< Boolean indicating whether the entry is being used */
+};
+
+/*!
+ * \brief Derived subkeys kept in secure memory so that a partition repeatedly
+ *        using the same builtin derivation key does not re-run HKDF each time
+ */
+static struct tfm_builtin_key_cache_entry_t
+                g_builtin_key_cache[CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM] = {0};
+static uint32_t g_builtin_key_cache_stamp;
+
+static void builtin_key_cache_wipe(struct tfm_builtin_key_cache_entry_t *entry)
+{
+    volatile uint8_t *p = (volatile uint8_t *)entry;
+
+    for (size_t i = 0; i < sizeof(*entry); i++) {
+        p[i] = 0;
+    }
+}
+
+static struct tfm_builtin_key_cache_entry_t *builtin_key_cache_lookup(
+        psa_drv_slot_number_t slot_number, int32_t user, size_t key_len)
+{
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_builtin_key_cache); idx++) {
+        struct tfm_builtin_key_cache_entry_t *entry = &g_builtin_key_cache[idx];
+
+        if (entry->is_valid && entry->slot_number == slot_number &&
+            entry->user == user && entry->key_len == key_len) {
+            entry->last_use = ++g_builtin_key_cache_stamp;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void builtin_key_cache_insert(psa_drv_slot_number_t slot_number,
+                                     int32_t user, const uint8_t *key,
+                                     size_t key_len)
+{
+    struct tfm_builtin_key_cache_entry_t *victim = &g_builtin_key_cache[0];
+
+    if (key_len > TFM_BUILTIN_MAX_KEY_LEN) {
+        return;
+    }
+
+    /* Prefer a free entry, otherwise evict the least recently used one */
+    for (size_t idx = 0; idx < NUMBER_OF_ELEMENTS_OF(g_builtin_key_cache); idx++) {
+        struct tfm_builtin_key_cache_entry_t *entry = &g_builtin_key_cache[idx];
+
+        if (!entry->is_valid) {
+            victim = entry;
+            break;
+        }
+        if ((int32_t)(entry->last_use - victim->last_use) < 0) {
+            victim = entry;
+        }
+    }
+
+    builtin_key_cache_wipe(victim);
+    memcpy(victim->key, key, key_len);
+    victim->key_len = key_len;
+    victim->slot_number = slot_number;
+    victim->user = user;
+    victim->last_use = ++g_builtin_key_cache_stamp;
+    victim->is_valid = 1;
+}
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
+
 /*!
  * \brief This functions returns the slot associated to a key id interrogating the
  *        platform HAL table
@@ -378,10 +459,27 @@ psa_status_t tfm_builtin_key_loader_get_builtin_key(
      */
     int32_t user = CRYPTO_LIBRARY_GET_OWNER(key_id);
     if (psa_get_key_usage_flags(attributes) & PSA_KEY_USAGE_DERIVE && user != TFM_SP_CRYPTO) {
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+        struct tfm_builtin_key_cache_entry_t *entry =
+            builtin_key_cache_lookup(slot_number, user, key_buffer_size);
+
+        if (entry != NULL) {
+            memcpy(key_buffer, entry->key, entry->key_len);
+            *key_buffer_length = entry->key_len;
+            err = PSA_SUCCESS;
+            goto wrap_up;
+        }
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
 
         err = derive_subkey_into_buffer(key_slot, user,
                                         key_buffer, key_buffer_size,
                                         key_buffer_length);
+#if CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0
+        if (err == PSA_SUCCESS) {
+            builtin_key_cache_insert(slot_number, user, key_buffer,
+                                     *key_buffer_length);
+        }
+#endif /* CRYPTO_BUILTIN_KEY_DERIVED_CACHE_NUM > 0 */
     } else {
         err = builtin_key_copy_to_buffer(key_slot, key_buffer, key_buffer_size,
                                          key_buffer_length);
@@ -1,11 +1,15 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 #include <string.h>
+#include "config_tfm.h"
 #include "psa/crypto.h"
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+#include "psa/internal_trusted_storage.h"
+#endif
 #include "tfm_sp_log.h"
 #include "bootutil_priv.h"
 #include "bootutil/bootutil.h"
@@ -16,11 +20,48 @@
 #include "tfm_bootloader_fwu_abstraction.h"
 #include "tfm_boot_status.h"
 #include "service_api.h"
+#if FWU_WRITE_STATS
+#include "cycle_counter.h"
+#endif
+
+#if FWU_WRITE_STATS && (TFM_ISOLATION_LEVEL != 1)
+#error "FWU_WRITE_STATS reads the cycle counter, it needs TFM_ISOLATION_LEVEL 1"
+#endif
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+#include "psa/service.h"
+#include "tfm_plat_nv_counters.h"
+#include "tfm_plat_rotpk.h"
+#endif
 
 #if (FWU_COMPONENT_NUMBER != MCUBOOT_IMAGE_NUMBER)
     #error "FWU_COMPONENT_NUMBER mismatch with MCUBOOT_IMAGE_NUMBER"
 #endif
 
+#if (FWU_RESUME_CHECKPOINT_SIZE != 0) && \
+    !defined(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
+    #error "FWU_RESUME_CHECKPOINT_SIZE needs the ITS partition"
+#endif
+
+#if FWU_DELTA_UPDATE && (defined(MCUBOOT_DIRECT_XIP) || \
+                          defined(MCUBOOT_RAM_LOAD))
+    #error "FWU_DELTA_UPDATE needs the active image in the primary slot"
+#endif
+
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+#if (MCUBOOT_IMAGE_NUMBER == 1) || !defined(MCUBOOT_SIGN_RSA)
+    #error "MCUBOOT_DEFER_NS_VERIFICATION needs a separate RSA signed NS image"
+#endif
+
+#define NS_VERIFY_READ_SIZE      (512u)
+#define NS_VERIFY_HASH_SIZE      PSA_HASH_LENGTH(PSA_ALG_SHA_256)
+#define NS_VERIFY_ALG            PSA_ALG_RSA_PSS(PSA_ALG_SHA_256)
+#if (MCUBOOT_SIGN_RSA_LEN == 2048)
+#define NS_VERIFY_SIG_TLV        IMAGE_TLV_RSA2048_PSS
+#else
+#define NS_VERIFY_SIG_TLV        IMAGE_TLV_RSA3072_PSS
+#endif
+#endif /* MCUBOOT_DEFER_NS_VERIFICATION */
+
 #if (MCUBOOT_IMAGE_NUMBER == 1)
 #define MAX_IMAGE_INFO_LENGTH    (sizeof(struct image_version) + \
                                   SHARED_DATA_ENTRY_HEADER_SIZE)
@@ -42,15 +83,123 @@ typedef struct fwu_image_info_data_s {
     uint8_t data[MAX_IMAGE_INFO_LENGTH];
 } fwu_image_info_data_t;
 
+#define FWU_STREAM_UPDATE   (FWU_DELTA_UPDATE || FWU_COMPRESSED_UPDATE)
+
+#if FWU_STREAM_UPDATE
+/* The first word of an update stream, "TFMD" or "TFMZ" in little endian. */
+#define FWU_DELTA_MAGIC          0x444D4654U
+#define FWU_LZ4_MAGIC            0x5A4D4654U
+#define FWU_STREAM_HEADER_SIZE   (2 * sizeof(uint32_t))
+#define FWU_DELTA_RECORD_SIZE    (3 * sizeof(uint32_t))
+
+enum fwu_stream_type_t {
+    FWU_STREAM_NONE = 0,
+    FWU_STREAM_DELTA,
+    FWU_STREAM_LZ4,
+};
+
+enum fwu_lz4_state_t {
+    FWU_LZ4_TOKEN = 0,
+    FWU_LZ4_LITERAL_LEN,
+    FWU_LZ4_LITERALS,
+    FWU_LZ4_OFFSET,
+    FWU_LZ4_MATCH_LEN,
+};
+
+/*
+ * \struct fwu_stream_ctx_t
+ *
+ * \brief The state of an update stream the new image is built from.
+ *
+ * \details The stream is a header, the magic and the size of the new image,
+ *          followed by the encoded image. All header fields are 32-bit
+ *          little endian.
+ *          A delta is made of records. Each record copies copy_len bytes at
+ *          copy_off of the active image, then inserts the insert_len bytes
+ *          which follow the record.
+ *          A compressed image is a single LZ4 block, whose matches refer
+ *          to the new image built so far.
+ */
+struct fwu_stream_ctx_t {
+    /* The type of the stream, FWU_STREAM_NONE for a full image. */
+    enum fwu_stream_type_t type;
+
+    /* Applying the stream failed, so the new image is incomplete. */
+    bool failed;
+
+    /* The size of the stream received so far. */
+    uint32_t stream_size;
+
+    /* The size of the new image, and how much of it has been produced. */
+    uint32_t image_size;
+    uint32_t produced_size;
+
+#if FWU_DELTA_UPDATE
+    /* The primary slot holding the active image. */
+    const struct flash_area *src_fap;
+
+    /* The record being received, and the literal bytes left in it. */
+    uint8_t record[FWU_DELTA_RECORD_SIZE];
+    uint32_t record_len;
+    uint32_t insert_len;
+#endif
+
+#if FWU_COMPRESSED_UPDATE
+    /* The LZ4 sequence being received. */
+    enum fwu_lz4_state_t lz4_state;
+    uint8_t token;
+    uint8_t offset_len;
+    uint32_t literal_len;
+    uint32_t match_len;
+    uint32_t match_offset;
+#endif
+
+    /* The produced data which is not yet written to the staging area. */
+    uint8_t buf[FWU_STREAM_BUF_SIZE] __attribute__((aligned(4)));
+    uint32_t buf_len;
+};
+#endif
+
 typedef struct tfm_fwu_mcuboot_ctx_s {
     /* The flash area corresponding to component. */
     const struct flash_area *fap;
 
     /* The size of the downloaded data in the FWU process. */
     size_t loaded_size;
+
+#if FWU_HASH_ON_LOAD
+    /* Hash of the downloaded data, as long as it is loaded in order. */
+    psa_hash_operation_t hash_op;
+
+    /* The downloaded data is hashed in hash_op. */
+    bool hash_valid;
+#endif
+
+#if FWU_ERASE_ON_LOAD
+    /* The size of the staging area erased since the FWU process started. */
+    uint32_t erased_size;
+#endif
+
+#if FWU_STREAM_UPDATE
+    struct fwu_stream_ctx_t stream;
+#endif
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    /* The size of the image recorded in ITS as written in order. */
+    uint32_t checkpoint_size;
+
+    /* The FWU process was restored from the record after a reset. */
+    bool resumed;
+
+    /* The image has been written in order so far. */
+    bool in_order;
+#endif
 } tfm_fwu_mcuboot_ctx_t;
 
 static tfm_fwu_mcuboot_ctx_t mcuboot_ctx[FWU_COMPONENT_NUMBER];
+#if FWU_WRITE_STATS
+static struct tfm_fwu_write_stats_t write_stats;
+#endif
 static fwu_image_info_data_t __attribute__((aligned(4))) boot_shared_data;
 
 static int fwu_bootloader_get_shared_data(void)
@@ -96,21 +245,801 @@ static psa_status_t get_active_image_version(psa_fwu_component_t component,
     return PSA_ERROR_DATA_CORRUPT;
 }
 
+#if FWU_WRITE_STATS
+/* Account the cycles spent in a stage since the given cycle count. */
+static inline void fwu_stats_add(enum tfm_fwu_write_stage_t stage,
+                                 uint32_t since)
+{
+    write_stats.cycles[stage] += cycle_counter_read() - since;
+}
+
+void fwu_bootloader_get_write_stats(struct tfm_fwu_write_stats_t *stats)
+{
+    *stats = write_stats;
+}
+#endif /* FWU_WRITE_STATS */
+
+#if FWU_HASH_ON_LOAD
+static void fwu_image_hash_reset(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    (void)psa_hash_abort(&ctx->hash_op);
+    ctx->hash_op = psa_hash_operation_init();
+    ctx->hash_valid = false;
+}
+
+static void fwu_image_hash_start(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    fwu_image_hash_reset(ctx);
+    ctx->hash_valid = (psa_hash_setup(&ctx->hash_op, PSA_ALG_SHA_256) ==
+                       PSA_SUCCESS);
+}
+
+/* Add a loaded block to the image hash. A block which does not follow the
+ * data hashed so far, or any hash failure, leaves the digest to be computed
+ * from the flash content.
+ */
+static void fwu_image_hash_update(tfm_fwu_mcuboot_ctx_t *ctx,
+                                  size_t block_offset,
+                                  const void *block,
+                                  size_t block_size)
+{
+#if FWU_WRITE_STATS
+    uint32_t start = cycle_counter_read();
+#endif
+
+    if (!ctx->hash_valid) {
+        return;
+    }
+
+    if ((block_offset != ctx->loaded_size) ||
+        (psa_hash_update(&ctx->hash_op, block, block_size) != PSA_SUCCESS)) {
+        fwu_image_hash_reset(ctx);
+    }
+
+#if FWU_WRITE_STATS
+    fwu_stats_add(TFM_FWU_WRITE_STAGE_HASH, start);
+#endif
+}
+#endif /* FWU_HASH_ON_LOAD */
+
+#if FWU_ERASE_ON_LOAD
+/* The offset of the last sector of the staging area, which holds the image
+ * trailer.
+ */
+static inline uint32_t trailer_sector_off(const struct flash_area *fap)
+{
+    return ALIGN_DOWN(flash_area_get_size(fap) - 1,
+                      FLASH_AREA_IMAGE_SECTOR_SIZE);
+}
+
+/* Erase the staging area from the end of its erased part up to end_off,
+ * rounded up to a whole sector. The trailer sector is left out as it is
+ * erased when the staging area is initialized.
+ */
+static int fwu_staging_area_erase_to(tfm_fwu_mcuboot_ctx_t *ctx,
+                                     uint32_t end_off)
+{
+    uint32_t limit = trailer_sector_off(ctx->fap);
+#if FWU_WRITE_STATS
+    uint32_t start;
+#endif
+
+    end_off = ALIGN_UP(end_off, FLASH_AREA_IMAGE_SECTOR_SIZE);
+    if (end_off > limit) {
+        end_off = limit;
+    }
+    if (end_off <= ctx->erased_size) {
+        return 0;
+    }
+
+#if FWU_WRITE_STATS
+    start = cycle_counter_read();
+#endif
+    if (flash_area_erase(ctx->fap, ctx->erased_size,
+                         end_off - ctx->erased_size) != 0) {
+        return -1;
+    }
+    ctx->erased_size = end_off;
+#if FWU_WRITE_STATS
+    fwu_stats_add(TFM_FWU_WRITE_STAGE_ERASE, start);
+#endif
+
+    return 0;
+}
+#endif /* FWU_ERASE_ON_LOAD */
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+/* The ITS UID of the write progress record of a component. */
+#define FWU_RESUME_UID(component)    (0x46575500U + (component))
+
+/* Record that the first size bytes of the image have been written in order,
+ * or remove the record if size is 0. A failure only loses the checkpoint.
+ */
+static void fwu_resume_checkpoint(psa_fwu_component_t component, uint32_t size)
+{
+    tfm_fwu_mcuboot_ctx_t *ctx = &mcuboot_ctx[component];
+
+    if (size == 0) {
+        ctx->resumed = false;
+    }
+    if (size == ctx->checkpoint_size) {
+        return;
+    }
+
+    if (size == 0) {
+        (void)psa_its_remove(FWU_RESUME_UID(component));
+    } else if (psa_its_set(FWU_RESUME_UID(component), sizeof(size), &size,
+                           PSA_STORAGE_FLAG_NONE) != PSA_SUCCESS) {
+        return;
+    }
+    ctx->checkpoint_size = size;
+}
+
+/* Restore the FWU process of a component from its write progress record. The
+ * staging area is erased from the checkpoint, which is sector aligned, so that
+ * the rest of the image can be written again.
+ */
+static void fwu_resume_restore(psa_fwu_component_t component)
+{
+    tfm_fwu_mcuboot_ctx_t *ctx = &mcuboot_ctx[component];
+    const struct flash_area *fap;
+    uint32_t size;
+    size_t data_length;
+
+    if ((psa_its_get(FWU_RESUME_UID(component), 0, sizeof(size), &size,
+                     &data_length) != PSA_SUCCESS) ||
+        (data_length != sizeof(size))) {
+        return;
+    }
+
+    if (flash_area_open(FLASH_AREA_IMAGE_SECONDARY(component), &fap) != 0) {
+        return;
+    }
+
+    if ((size == 0) || (size % FLASH_AREA_IMAGE_SECTOR_SIZE != 0) ||
+        (size >= fap->fa_size) ||
+#if FWU_ERASE_ON_LOAD
+        (flash_area_erase(fap, trailer_sector_off(fap),
+                          fap->fa_size - trailer_sector_off(fap)) != 0)
+#else
+        (flash_area_erase(fap, size, fap->fa_size - size) != 0)
+#endif
+        ) {
+        flash_area_close(fap);
+        (void)psa_its_remove(FWU_RESUME_UID(component));
+        return;
+    }
+
+    ctx->fap = fap;
+    ctx->loaded_size = size;
+    ctx->checkpoint_size = size;
+    ctx->resumed = true;
+    ctx->in_order = true;
+#if FWU_ERASE_ON_LOAD
+    ctx->erased_size = size;
+#endif
+}
+#endif /* FWU_RESUME_CHECKPOINT_SIZE != 0 */
+
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+/*
+ * Do the checks BL2 has left out on the non-secure image in the primary slot:
+ * its hash, its signature with the key the ROTPK hash of the image matches,
+ * and the rollback protection. Raises the NV counter of the image once it has
+ * passed.
+ */
+static psa_status_t fwu_verify_ns_image(void)
+{
+    static uint8_t buf[NS_VERIFY_READ_SIZE] __attribute__((aligned(4)));
+    const uint8_t image_id = FWU_COMPONENT_ID_NONSECURE;
+    const enum tfm_nv_counter_t nv_counter =
+        (enum tfm_nv_counter_t)(PLAT_NV_COUNTER_BL2_0 + image_id);
+    uint8_t hash[NS_VERIFY_HASH_SIZE];
+    uint8_t key_hash[NS_VERIFY_HASH_SIZE];
+    uint8_t rotpk_hash[NS_VERIFY_HASH_SIZE];
+    uint32_t rotpk_hash_size = sizeof(rotpk_hash);
+    psa_hash_operation_t hash_op = PSA_HASH_OPERATION_INIT;
+    psa_key_attributes_t key_attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_key_id_t key_id = PSA_KEY_ID_NULL;
+    const struct flash_area *fap;
+    struct image_header hdr;
+    struct image_tlv_iter it;
+    uint32_t off, chunk, prot_end;
+    uint32_t img_cnt = 0, nv_cnt;
+    uint16_t len, type;
+    size_t hash_len;
+    bool hash_ok = false, sig_ok = false, cnt_found = false;
+    psa_status_t status = PSA_ERROR_INVALID_SIGNATURE;
+    int rc;
+
+    if (flash_area_open(FLASH_AREA_IMAGE_PRIMARY(image_id), &fap) != 0) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    if ((flash_area_read(fap, 0, &hdr, sizeof(hdr)) != 0) ||
+        (hdr.ih_magic != IMAGE_MAGIC)) {
+        goto out;
+    }
+
+    /* The header, the payload and the protected TLVs are signed. */
+    prot_end = hdr.ih_hdr_size + hdr.ih_img_size;
+    if ((prot_end < hdr.ih_img_size) ||
+        (prot_end + hdr.ih_protect_tlv_size < prot_end) ||
+        (prot_end + hdr.ih_protect_tlv_size > flash_area_get_size(fap))) {
+        goto out;
+    }
+    prot_end += hdr.ih_protect_tlv_size;
+
+    if (psa_hash_setup(&hash_op, PSA_ALG_SHA_256) != PSA_SUCCESS) {
+        status = PSA_ERROR_GENERIC_ERROR;
+        goto out;
+    }
+    for (off = 0; off < prot_end; off += chunk) {
+        chunk = prot_end - off;
+        if (chunk > sizeof(buf)) {
+            chunk = sizeof(buf);
+        }
+        if (flash_area_read(fap, off, buf, chunk) != 0) {
+            status = PSA_ERROR_STORAGE_FAILURE;
+            goto out;
+        }
+        if (psa_hash_update(&hash_op, buf, chunk) != PSA_SUCCESS) {
+            status = PSA_ERROR_GENERIC_ERROR;
+            goto out;
+        }
+    }
+    if (psa_hash_finish(&hash_op, hash, sizeof(hash),
+                        &hash_len) != PSA_SUCCESS) {
+        status = PSA_ERROR_GENERIC_ERROR;
+        goto out;
+    }
+
+    if (bootutil_tlv_iter_begin(&it, &hdr, fap, IMAGE_TLV_ANY, false) != 0) {
+        goto out;
+    }
+
+    /* imgtool puts the hash before the key, and the key before the
+     * signature.
+     */
+    while ((rc = bootutil_tlv_iter_next(&it, &off, &len, &type)) == 0) {
+        if ((type != IMAGE_TLV_SHA256) && (type != IMAGE_TLV_PUBKEY) &&
+            (type != NS_VERIFY_SIG_TLV) && (type != IMAGE_TLV_SEC_CNT)) {
+            continue;
+        }
+        if ((len > sizeof(buf)) || (flash_area_read(fap, off, buf, len) != 0)) {
+            goto out;
+        }
+
+        switch (type) {
+        case IMAGE_TLV_SHA256:
+            if ((len != sizeof(hash)) || (memcmp(buf, hash, len) != 0)) {
+                goto out;
+            }
+            hash_ok = true;
+            break;
+        case IMAGE_TLV_PUBKEY:
+            if ((key_id != PSA_KEY_ID_NULL) ||
+                (psa_hash_compute(PSA_ALG_SHA_256, buf, len, key_hash,
+                                  sizeof(key_hash), &hash_len) != PSA_SUCCESS) ||
+                (tfm_plat_get_rotpk_hash(image_id, rotpk_hash,
+                                         &rotpk_hash_size) !=
+                 TFM_PLAT_ERR_SUCCESS) ||
+                (rotpk_hash_size != sizeof(rotpk_hash)) ||
+                (memcmp(key_hash, rotpk_hash, sizeof(rotpk_hash)) != 0)) {
+                goto out;
+            }
+            psa_set_key_type(&key_attr, PSA_KEY_TYPE_RSA_PUBLIC_KEY);
+            psa_set_key_usage_flags(&key_attr, PSA_KEY_USAGE_VERIFY_HASH);
+            psa_set_key_algorithm(&key_attr, NS_VERIFY_ALG);
+            if (psa_import_key(&key_attr, buf, len, &key_id) != PSA_SUCCESS) {
+                goto out;
+            }
+            break;
+        case NS_VERIFY_SIG_TLV:
+            if (!hash_ok || (key_id == PSA_KEY_ID_NULL) ||
+                (psa_verify_hash(key_id, NS_VERIFY_ALG, hash, sizeof(hash),
+                                 buf, len) != PSA_SUCCESS)) {
+                goto out;
+            }
+            sig_ok = true;
+            break;
+        case IMAGE_TLV_SEC_CNT:
+            /* Only a signed security counter counts. */
+            if ((off >= prot_end) || (len != sizeof(img_cnt))) {
+                goto out;
+            }
+            memcpy(&img_cnt, buf, sizeof(img_cnt));
+            cnt_found = true;
+            break;
+        }
+    }
+    if ((rc < 0) || !sig_ok || !cnt_found) {
+        goto out;
+    }
+
+    if (tfm_plat_read_nv_counter(nv_counter, sizeof(nv_cnt),
+                                 (uint8_t *)&nv_cnt) != TFM_PLAT_ERR_SUCCESS) {
+        status = PSA_ERROR_STORAGE_FAILURE;
+        goto out;
+    }
+    if (img_cnt < nv_cnt) {
+        LOG_ERRFMT("TFM FWU: NS image security counter rolled back.\r\n");
+        goto out;
+    }
+    if ((img_cnt > nv_cnt) &&
+        (tfm_plat_set_nv_counter(nv_counter, img_cnt) !=
+         TFM_PLAT_ERR_SUCCESS)) {
+        status = PSA_ERROR_STORAGE_FAILURE;
+        goto out;
+    }
+
+    status = PSA_SUCCESS;
+
+out:
+    (void)psa_hash_abort(&hash_op);
+    if (key_id != PSA_KEY_ID_NULL) {
+        (void)psa_destroy_key(key_id);
+    }
+    flash_area_close(fap);
+
+    return status;
+}
+#endif /* MCUBOOT_DEFER_NS_VERIFICATION */
+
 psa_status_t fwu_bootloader_init(void)
 {
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    psa_fwu_component_t component;
+#endif
+
     if (fwu_bootloader_get_shared_data() != TFM_SUCCESS) {
         return PSA_ERROR_STORAGE_FAILURE;
     }
     /* add Init of specific flash driver */
     flash_area_driver_init();
+
+#ifdef MCUBOOT_DEFER_NS_VERIFICATION
+    /* BL2 has booted the NS image unchecked. This partition is initialized
+     * before the NS agent, which is the lowest priority partition, and stops
+     * the boot as BL2 would have done when the image fails.
+     */
+    if (fwu_verify_ns_image() != PSA_SUCCESS) {
+        LOG_ERRFMT("TFM FWU: NS image verification failed.\r\n");
+        psa_panic();
+    }
+#endif
+
+#if FWU_WRITE_STATS
+    cycle_counter_enable();
+#endif
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    for (component = 0; component < FWU_COMPONENT_NUMBER; component++) {
+        fwu_resume_restore(component);
+    }
+#endif
+    return PSA_SUCCESS;
+}
+
+/* Write a block of the new image into the staging area. */
+static psa_status_t fwu_staging_area_write(tfm_fwu_mcuboot_ctx_t *ctx,
+                                           size_t block_offset,
+                                           const void *block,
+                                           size_t block_size)
+{
+#if FWU_WRITE_STATS
+    uint32_t start;
+#endif
+
+#if FWU_ERASE_ON_LOAD
+    if (fwu_staging_area_erase_to(ctx, block_offset + block_size) != 0) {
+        LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+#endif
+
+#if FWU_WRITE_STATS
+    start = cycle_counter_read();
+#endif
+    if (flash_area_write(ctx->fap, block_offset, block, block_size) != 0) {
+        LOG_ERRFMT("TFM FWU: write flash failed.\r\n");
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+#if FWU_WRITE_STATS
+    fwu_stats_add(TFM_FWU_WRITE_STAGE_PROGRAM, start);
+#endif
+
+#if FWU_HASH_ON_LOAD
+    fwu_image_hash_update(ctx, block_offset, block, block_size);
+#endif
+
+    /* The overflow check has been done in flash_area_write. */
+    ctx->loaded_size += block_size;
+    return PSA_SUCCESS;
+}
+
+#if FWU_STREAM_UPDATE
+static uint32_t fwu_stream_get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void fwu_stream_reset(struct fwu_stream_ctx_t *stream)
+{
+#if FWU_DELTA_UPDATE
+    if (stream->src_fap != NULL) {
+        flash_area_close(stream->src_fap);
+    }
+#endif
+    memset(stream, 0, sizeof(*stream));
+}
+
+/* Start building the new image from an update stream if the first block
+ * carries a stream header. Returns the size of the header consumed, 0 for a
+ * full image.
+ */
+static size_t fwu_stream_start(psa_fwu_component_t component,
+                               const uint8_t *block,
+                               size_t block_size,
+                               psa_status_t *status)
+{
+    struct fwu_stream_ctx_t *stream = &mcuboot_ctx[component].stream;
+    const struct flash_area *fap = mcuboot_ctx[component].fap;
+    enum fwu_stream_type_t type;
+
+    *status = PSA_SUCCESS;
+    if (block_size < FWU_STREAM_HEADER_SIZE) {
+        return 0;
+    }
+
+    switch (fwu_stream_get_u32(block)) {
+#if FWU_DELTA_UPDATE
+    case FWU_DELTA_MAGIC:
+        type = FWU_STREAM_DELTA;
+        break;
+#endif
+#if FWU_COMPRESSED_UPDATE
+    case FWU_LZ4_MAGIC:
+        type = FWU_STREAM_LZ4;
+        break;
+#endif
+    default:
+        return 0;
+    }
+
+    fwu_stream_reset(stream);
+    stream->image_size = fwu_stream_get_u32(block + sizeof(uint32_t));
+    if ((stream->image_size == 0) ||
+        (stream->image_size > flash_area_get_size(fap))) {
+        *status = PSA_ERROR_INVALID_ARGUMENT;
+        return 0;
+    }
+
+#if FWU_DELTA_UPDATE
+    if ((type == FWU_STREAM_DELTA) &&
+        (flash_area_open(FLASH_AREA_IMAGE_PRIMARY(component),
+                         &stream->src_fap) != 0)) {
+        stream->src_fap = NULL;
+        *status = PSA_ERROR_STORAGE_FAILURE;
+        return 0;
+    }
+#endif
+
+    stream->type = type;
+    stream->stream_size = FWU_STREAM_HEADER_SIZE;
+    return FWU_STREAM_HEADER_SIZE;
+}
+
+/* Write the buffered data of the new image into the staging area. */
+static psa_status_t fwu_stream_flush(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+    psa_status_t status;
+
+    if (stream->buf_len == 0) {
+        return PSA_SUCCESS;
+    }
+
+    status = fwu_staging_area_write(ctx, ctx->loaded_size, stream->buf,
+                                    stream->buf_len);
+    stream->buf_len = 0;
+    return status;
+}
+
+/* Account for data appended to the buffer, and write it to the staging area
+ * once the buffer is full or the new image is complete.
+ */
+static psa_status_t fwu_stream_produced(tfm_fwu_mcuboot_ctx_t *ctx,
+                                        uint32_t len)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+
+    stream->buf_len += len;
+    stream->produced_size += len;
+    if ((stream->buf_len == sizeof(stream->buf)) ||
+        (stream->produced_size == stream->image_size)) {
+        return fwu_stream_flush(ctx);
+    }
+
     return PSA_SUCCESS;
 }
 
+/* Append data of the stream to the new image. */
+static psa_status_t fwu_stream_insert(tfm_fwu_mcuboot_ctx_t *ctx,
+                                      const uint8_t *data,
+                                      uint32_t len)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+    uint32_t chunk;
+    psa_status_t status;
+
+    while (len > 0) {
+        chunk = sizeof(stream->buf) - stream->buf_len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(&stream->buf[stream->buf_len], data, chunk);
+        data += chunk;
+        len -= chunk;
+
+        status = fwu_stream_produced(ctx, chunk);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+#if FWU_DELTA_UPDATE
+/* Append a range of the active image to the new image. */
+static psa_status_t fwu_delta_copy(tfm_fwu_mcuboot_ctx_t *ctx,
+                                   uint32_t copy_off,
+                                   uint32_t len)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+    uint32_t chunk;
+    psa_status_t status;
+
+    while (len > 0) {
+        chunk = sizeof(stream->buf) - stream->buf_len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        if (flash_area_read(stream->src_fap, copy_off,
+                            &stream->buf[stream->buf_len], chunk) != 0) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+        copy_off += chunk;
+        len -= chunk;
+
+        status = fwu_stream_produced(ctx, chunk);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Apply a block of the delta update stream. */
+static psa_status_t fwu_delta_load(tfm_fwu_mcuboot_ctx_t *ctx,
+                                   const uint8_t *block,
+                                   size_t block_size)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+    uint32_t copy_off, copy_len, left, chunk;
+    psa_status_t status;
+
+    while (block_size > 0) {
+        if (stream->insert_len > 0) {
+            /* The literal bytes of the current record. */
+            chunk = stream->insert_len < block_size ?
+                    stream->insert_len : (uint32_t)block_size;
+            status = fwu_stream_insert(ctx, block, chunk);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+            stream->insert_len -= chunk;
+            block += chunk;
+            block_size -= chunk;
+            continue;
+        }
+
+        /* No data is expected once the new image is complete. */
+        if (stream->produced_size == stream->image_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Gather the next record, which may span several blocks. */
+        chunk = sizeof(stream->record) - stream->record_len;
+        if (chunk > block_size) {
+            chunk = block_size;
+        }
+        memcpy(&stream->record[stream->record_len], block, chunk);
+        stream->record_len += chunk;
+        block += chunk;
+        block_size -= chunk;
+        if (stream->record_len < sizeof(stream->record)) {
+            break;
+        }
+        stream->record_len = 0;
+
+        copy_off = fwu_stream_get_u32(&stream->record[0]);
+        copy_len = fwu_stream_get_u32(&stream->record[4]);
+        stream->insert_len = fwu_stream_get_u32(&stream->record[8]);
+
+        left = stream->image_size - stream->produced_size;
+        if ((copy_len > left) || (stream->insert_len > left - copy_len) ||
+            (copy_off > flash_area_get_size(stream->src_fap)) ||
+            (copy_len > flash_area_get_size(stream->src_fap) - copy_off)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        status = fwu_delta_copy(ctx, copy_off, copy_len);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* FWU_DELTA_UPDATE */
+
+#if FWU_COMPRESSED_UPDATE
+/* Append an LZ4 match to the new image. The match is read back from the
+ * buffer or, once written, from the staging area. A match may overlap the
+ * data it produces, so the part in the buffer is copied byte by byte.
+ */
+static psa_status_t fwu_lz4_copy_match(tfm_fwu_mcuboot_ctx_t *ctx)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+    uint32_t src, chunk, i;
+    psa_status_t status;
+
+    while (stream->match_len > 0) {
+        src = stream->produced_size - stream->match_offset;
+        chunk = sizeof(stream->buf) - stream->buf_len;
+        if (chunk > stream->match_len) {
+            chunk = stream->match_len;
+        }
+
+        if (src < ctx->loaded_size) {
+            if (chunk > ctx->loaded_size - src) {
+                chunk = ctx->loaded_size - src;
+            }
+            if (flash_area_read(ctx->fap, src,
+                                &stream->buf[stream->buf_len], chunk) != 0) {
+                return PSA_ERROR_STORAGE_FAILURE;
+            }
+        } else {
+            src -= ctx->loaded_size;
+            for (i = 0; i < chunk; i++) {
+                stream->buf[stream->buf_len + i] = stream->buf[src + i];
+            }
+        }
+        stream->match_len -= chunk;
+
+        status = fwu_stream_produced(ctx, chunk);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Decompress a block of the LZ4 compressed image. */
+static psa_status_t fwu_lz4_load(tfm_fwu_mcuboot_ctx_t *ctx,
+                                 const uint8_t *block,
+                                 size_t block_size)
+{
+    struct fwu_stream_ctx_t *stream = &ctx->stream;
+    uint32_t left, chunk;
+    uint8_t byte;
+    psa_status_t status;
+
+    while (block_size > 0) {
+        left = stream->image_size - stream->produced_size;
+
+        if (stream->lz4_state == FWU_LZ4_LITERALS) {
+            chunk = stream->literal_len < block_size ?
+                    stream->literal_len : (uint32_t)block_size;
+            status = fwu_stream_insert(ctx, block, chunk);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+            stream->literal_len -= chunk;
+            block += chunk;
+            block_size -= chunk;
+            if (stream->literal_len == 0) {
+                /* The last sequence has no match. */
+                stream->lz4_state = FWU_LZ4_OFFSET;
+            }
+            continue;
+        }
+
+        /* No data is expected once the new image is complete. */
+        if (left == 0) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        byte = *block++;
+        block_size--;
+
+        switch (stream->lz4_state) {
+        case FWU_LZ4_TOKEN:
+            stream->token = byte;
+            stream->literal_len = byte >> 4;
+            stream->match_offset = 0;
+            stream->offset_len = 0;
+            stream->lz4_state = (stream->literal_len == 15) ?
+                                FWU_LZ4_LITERAL_LEN : FWU_LZ4_LITERALS;
+            break;
+        case FWU_LZ4_LITERAL_LEN:
+            stream->literal_len += byte;
+            if (byte != 255) {
+                stream->lz4_state = FWU_LZ4_LITERALS;
+            }
+            break;
+        case FWU_LZ4_OFFSET:
+            stream->match_offset |= (uint32_t)byte << (8 * stream->offset_len);
+            if (++stream->offset_len < 2) {
+                break;
+            }
+            stream->match_len = (stream->token & 0xF) + 4;
+            if ((stream->token & 0xF) == 15) {
+                stream->lz4_state = FWU_LZ4_MATCH_LEN;
+                break;
+            }
+            stream->lz4_state = FWU_LZ4_TOKEN;
+            break;
+        case FWU_LZ4_MATCH_LEN:
+            stream->match_len += byte;
+            if (byte == 255) {
+                break;
+            }
+            stream->lz4_state = FWU_LZ4_TOKEN;
+            break;
+        default:
+            return PSA_ERROR_BAD_STATE;
+        }
+
+        if ((stream->literal_len > left) || (stream->match_len > left)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        if ((stream->lz4_state == FWU_LZ4_LITERALS) &&
+            (stream->literal_len == 0)) {
+            stream->lz4_state = FWU_LZ4_OFFSET;
+        }
+
+        if ((stream->lz4_state == FWU_LZ4_TOKEN) && (stream->match_len > 0)) {
+            if ((stream->match_offset == 0) ||
+                (stream->match_offset > stream->produced_size)) {
+                return PSA_ERROR_INVALID_ARGUMENT;
+            }
+            status = fwu_lz4_copy_match(ctx);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* FWU_COMPRESSED_UPDATE */
+#endif /* FWU_STREAM_UPDATE */
+
 psa_status_t fwu_bootloader_staging_area_init(psa_fwu_component_t component,
                                               const void *manifest,
                                               size_t manifest_size)
 {
     const struct flash_area *fap;
+#if FWU_WRITE_STATS
+    uint32_t start = cycle_counter_read();
+#endif
 
     /* MCUboot uses bundled manifest. */
     if ((manifest_size != 0) || (component >= FWU_COMPONENT_NUMBER)) {
@@ -123,45 +1052,173 @@ psa_status_t fwu_bootloader_staging_area_init(psa_fwu_component_t component,
         return PSA_ERROR_STORAGE_FAILURE;
     }
 
+#if FWU_ERASE_ON_LOAD
+    /* Only erase the trailer here, so that the trailer of a former image is
+     * never taken for this one. The rest of the staging area is erased just
+     * ahead of the blocks as they are loaded.
+     */
+    if (flash_area_erase(fap, trailer_sector_off(fap),
+                         fap->fa_size - trailer_sector_off(fap)) != 0) {
+        LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    mcuboot_ctx[component].erased_size = 0;
+#else
     if (flash_area_erase(fap, 0, fap->fa_size) != 0) {
         LOG_ERRFMT("TFM FWU: erasing flash failed.\r\n");
         return PSA_ERROR_GENERIC_ERROR;
     }
+#endif
+#if FWU_WRITE_STATS
+    fwu_stats_add(TFM_FWU_WRITE_STAGE_ERASE, start);
+#endif
 
     mcuboot_ctx[component].fap = fap;
 
     /* Reset the loaded_size. */
     mcuboot_ctx[component].loaded_size = 0;
 
+#if FWU_STREAM_UPDATE
+    fwu_stream_reset(&mcuboot_ctx[component].stream);
+#endif
+
+#if FWU_HASH_ON_LOAD
+    fwu_image_hash_start(&mcuboot_ctx[component]);
+#endif
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    fwu_resume_checkpoint(component, 0);
+    mcuboot_ctx[component].in_order = true;
+#endif
+
     return PSA_SUCCESS;
 }
 
-psa_status_t fwu_bootloader_load_image(psa_fwu_component_t component,
-                                       size_t block_offset,
-                                       const void *block,
-                                       size_t block_size)
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+/* Write a block of a full image, and record the progress each time another
+ * FWU_RESUME_CHECKPOINT_SIZE bytes have been written in order.
+ */
+static psa_status_t fwu_resume_load(psa_fwu_component_t component,
+                                    size_t block_offset,
+                                    const void *block,
+                                    size_t block_size)
 {
-    const struct flash_area *fap;
+    tfm_fwu_mcuboot_ctx_t *ctx = &mcuboot_ctx[component];
+    psa_status_t status;
+
+    if (block_offset != ctx->loaded_size) {
+        ctx->in_order = false;
+    }
+
+    status = fwu_staging_area_write(ctx, block_offset, block, block_size);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    if (!ctx->in_order) {
+        fwu_resume_checkpoint(component, 0);
+    } else {
+        fwu_resume_checkpoint(component,
+                              ALIGN_DOWN(ALIGN_DOWN(ctx->loaded_size,
+                                                    FWU_RESUME_CHECKPOINT_SIZE),
+                                         FLASH_AREA_IMAGE_SECTOR_SIZE));
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* FWU_RESUME_CHECKPOINT_SIZE != 0 */
+
+static psa_status_t fwu_load_image(psa_fwu_component_t component,
+                                   size_t block_offset,
+                                   const void *block,
+                                   size_t block_size)
+{
+#if FWU_STREAM_UPDATE
+    struct fwu_stream_ctx_t *stream;
+    size_t header_size;
+    psa_status_t status;
+#endif
 
     if (block == NULL || component >= FWU_COMPONENT_NUMBER) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
     /* The component should already be added into the mcuboot_ctx. */
-    if (mcuboot_ctx[component].fap != NULL) {
-        fap = mcuboot_ctx[component].fap;
-    } else {
+    if (mcuboot_ctx[component].fap == NULL) {
         return PSA_ERROR_BAD_STATE;
     }
 
-    if (flash_area_write(fap, block_offset, block, block_size) != 0) {
-        LOG_ERRFMT("TFM FWU: write flash failed.\r\n");
-        return PSA_ERROR_STORAGE_FAILURE;
+#if FWU_STREAM_UPDATE
+    stream = &mcuboot_ctx[component].stream;
+    if ((block_offset == 0) && (stream->type == FWU_STREAM_NONE) &&
+        (mcuboot_ctx[component].loaded_size == 0)) {
+        header_size = fwu_stream_start(component, block, block_size, &status);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+        block = (const uint8_t *)block + header_size;
+        block_size -= header_size;
+        block_offset += header_size;
     }
 
-    /* The overflow check has been done in flash_area_write. */
-    mcuboot_ctx[component].loaded_size += block_size;
-    return PSA_SUCCESS;
+    if (stream->type != FWU_STREAM_NONE) {
+        /* An update stream can only be applied in order, and not after a
+         * failure.
+         */
+        if (stream->failed || (block_offset != stream->stream_size) ||
+            (block_size > UINT32_MAX - stream->stream_size)) {
+            return PSA_ERROR_BAD_STATE;
+        }
+
+        status = PSA_ERROR_BAD_STATE;
+#if FWU_DELTA_UPDATE
+        if (stream->type == FWU_STREAM_DELTA) {
+            status = fwu_delta_load(&mcuboot_ctx[component], block,
+                                    block_size);
+        }
+#endif
+#if FWU_COMPRESSED_UPDATE
+        if (stream->type == FWU_STREAM_LZ4) {
+            status = fwu_lz4_load(&mcuboot_ctx[component], block, block_size);
+        }
+#endif
+        if (status != PSA_SUCCESS) {
+            stream->failed = true;
+            return status;
+        }
+        stream->stream_size += block_size;
+        return PSA_SUCCESS;
+    }
+#endif
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    return fwu_resume_load(component, block_offset, block, block_size);
+#else
+    return fwu_staging_area_write(&mcuboot_ctx[component], block_offset,
+                                  block, block_size);
+#endif
+}
+
+psa_status_t fwu_bootloader_load_image(psa_fwu_component_t component,
+                                       size_t block_offset,
+                                       const void *block,
+                                       size_t block_size)
+{
+#if FWU_WRITE_STATS
+    uint32_t start = cycle_counter_read();
+    psa_status_t status;
+
+    status = fwu_load_image(component, block_offset, block, block_size);
+    if (status == PSA_SUCCESS) {
+        write_stats.blocks++;
+        write_stats.bytes += block_size;
+    }
+    fwu_stats_add(TFM_FWU_WRITE_STAGE_LOAD, start);
+
+    return status;
+#else
+    return fwu_load_image(component, block_offset, block, block_size);
+#endif
 }
 
 #if (MCUBOOT_IMAGE_NUMBER > 1)
@@ -202,8 +1259,10 @@ static bool is_version_greater_or_equal(const struct image_version *image_ver_1,
 psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates, uint8_t number)
 {
     uint8_t index_i, cand_index;
-#if (MCUBOOT_IMAGE_NUMBER > 1)
+#if (MCUBOOT_IMAGE_NUMBER > 1) || FWU_ERASE_ON_LOAD || FWU_STREAM_UPDATE
     psa_fwu_component_t component;
+#endif
+#if (MCUBOOT_IMAGE_NUMBER > 1)
     const struct flash_area *fap;
     struct image_tlv_iter it;
     struct image_header hdr;
@@ -325,6 +1384,39 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
     }
 #endif
 
+#if FWU_STREAM_UPDATE
+    /* An update stream must have produced the whole new image. */
+    for (cand_index = 0; cand_index < number; cand_index++) {
+        component = candidates[cand_index];
+        if (component >= FWU_COMPONENT_NUMBER) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if ((mcuboot_ctx[component].stream.type != FWU_STREAM_NONE) &&
+            (mcuboot_ctx[component].stream.failed ||
+             (mcuboot_ctx[component].stream.produced_size !=
+              mcuboot_ctx[component].stream.image_size))) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+    }
+#endif
+
+#if FWU_ERASE_ON_LOAD
+    /* Erase what is left of the staging areas so that no stale data remains
+     * in the image trailers.
+     */
+    for (cand_index = 0; cand_index < number; cand_index++) {
+        component = candidates[cand_index];
+        if ((component >= FWU_COMPONENT_NUMBER) ||
+            (mcuboot_ctx[component].fap == NULL)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+        if (fwu_staging_area_erase_to(&mcuboot_ctx[component],
+                                      mcuboot_ctx[component].fap->fa_size) != 0) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+    }
+#endif
+
     /* Write the boot magic in image trailer so that these images will be
      * taken as candidates.
      */
@@ -339,6 +1431,13 @@ psa_status_t fwu_bootloader_install_image(const psa_fwu_component_t *candidates,
             return PSA_ERROR_STORAGE_FAILURE;
         }
     }
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    /* The staged images are kept by their trailers from now on. */
+    for (cand_index = 0; cand_index < number; cand_index++) {
+        fwu_resume_checkpoint(candidates[cand_index], 0);
+    }
+#endif
     return PSA_SUCCESS_REBOOT;
 }
 
@@ -499,6 +1598,15 @@ psa_status_t fwu_bootloader_abort(psa_fwu_component_t component)
     flash_area_close(fap);
     mcuboot_ctx[component].fap = NULL;
     mcuboot_ctx[component].loaded_size = 0;
+#if FWU_HASH_ON_LOAD
+    fwu_image_hash_reset(&mcuboot_ctx[component]);
+#endif
+#if FWU_STREAM_UPDATE
+    fwu_stream_reset(&mcuboot_ctx[component].stream);
+#endif
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    fwu_resume_checkpoint(component, 0);
+#endif
     return PSA_SUCCESS;
 }
 
@@ -562,6 +1670,22 @@ static psa_status_t get_second_image_digest(psa_fwu_component_t component,
     } else {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
+#if FWU_HASH_ON_LOAD
+    /* Finish a copy of the hash, so that more blocks can still be added */
+    if (mcuboot_ctx[component].hash_valid) {
+        psa_hash_operation_t hash_op = psa_hash_operation_init();
+
+        if ((psa_hash_clone(&mcuboot_ctx[component].hash_op,
+                            &hash_op) == PSA_SUCCESS) &&
+            (psa_hash_finish(&hash_op, hash, sizeof(hash),
+                             &hash_size) == PSA_SUCCESS)) {
+            memcpy(info->impl.candidate_digest, hash, hash_size);
+            return PSA_SUCCESS;
+        }
+        (void)psa_hash_abort(&hash_op);
+    }
+#endif
+
     if ((flash_area_open(FLASH_AREA_IMAGE_SECONDARY(component),
                             &fap)) != 0) {
         LOG_ERRFMT("TFM FWU: opening flash failed.\r\n");
@@ -579,6 +1703,22 @@ static psa_status_t get_second_image_digest(psa_fwu_component_t component,
     return ret;
 }
 
+/* The offset from which a client continues writing the image of a
+ * component.
+ */
+static uint32_t fwu_written_size(psa_fwu_component_t component)
+{
+    if (mcuboot_ctx[component].fap == NULL) {
+        return 0;
+    }
+#if FWU_STREAM_UPDATE
+    if (mcuboot_ctx[component].stream.type != FWU_STREAM_NONE) {
+        return mcuboot_ctx[component].stream.stream_size;
+    }
+#endif
+    return mcuboot_ctx[component].loaded_size;
+}
+
 psa_status_t fwu_bootloader_get_image_info(psa_fwu_component_t component,
                                            bool query_state,
                                            bool query_impl_info,
@@ -607,7 +1747,13 @@ psa_status_t fwu_bootloader_get_image_info(psa_fwu_component_t component,
     }
     info->max_size = fap->fa_size;
     info->location = fap->fa_id;
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    /* The write progress is restored after a reset. */
+    info->flags = 0;
+#else
     info->flags = PSA_FWU_FLAG_VOLATILE_STAGING;
+#endif
+    info->impl.written_size = fwu_written_size(component);
 
     if (query_state) {
         /* As DIRECT_XIP, RAM_LOAD and OVERWRITE_ONLY do not support image revert.
@@ -632,6 +1778,12 @@ psa_status_t fwu_bootloader_get_image_info(psa_fwu_component_t component,
     #else
         info->state = PSA_FWU_READY;
     #endif
+    #if FWU_RESUME_CHECKPOINT_SIZE != 0
+        /* The FWU process restored after a reset is in WRITING state. */
+        if (mcuboot_ctx[component].resumed) {
+            info->state = PSA_FWU_WRITING;
+        }
+    #endif
     }
     if (get_active_image_version(component,
                                     &image_version) == PSA_SUCCESS) {
@@ -644,7 +1796,14 @@ psa_status_t fwu_bootloader_get_image_info(psa_fwu_component_t component,
         goto close_return;
     }
     if (query_impl_info) {
+#if FWU_WRITE_STATS
+        uint32_t start = cycle_counter_read();
+
+        ret = get_second_image_digest(component, info);
+        fwu_stats_add(TFM_FWU_WRITE_STAGE_HASH, start);
+#else
         ret = get_second_image_digest(component, info);
+#endif
     }
 
 close_return:
@@ -667,6 +1826,15 @@ psa_status_t fwu_bootloader_clean_component(psa_fwu_component_t component)
             return PSA_ERROR_STORAGE_FAILURE;
         }
         mcuboot_ctx[component].fap = NULL;
+#if FWU_HASH_ON_LOAD
+        fwu_image_hash_reset(&mcuboot_ctx[component]);
+#endif
+#if FWU_STREAM_UPDATE
+        fwu_stream_reset(&mcuboot_ctx[component].stream);
+#endif
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+        fwu_resume_checkpoint(component, 0);
+#endif
     } else {
         return PSA_ERROR_DOES_NOT_EXIST;
     }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,7 +9,9 @@
 #define __TFM_BOOTLOADER_FWU_ABSTRACTION_H__
 
 #include "stdbool.h"
+#include "stdint.h"
 #include "psa/update.h"
+#include "config_tfm.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -183,6 +185,16 @@ psa_status_t fwu_bootloader_get_image_info(psa_fwu_component_t component,
                                            bool query_state,
                                            bool query_impl_info,
                                            psa_fwu_component_info_t *info);
+
+#if FWU_WRITE_STATS
+/**
+ * \brief Get the image write statistics accumulated since boot.
+ *
+ * \param[out] stats  Buffer to hold the statistics.
+ */
+void fwu_bootloader_get_write_stats(struct tfm_fwu_write_stats_t *stats);
+#endif /* FWU_WRITE_STATS */
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -504,6 +504,22 @@ static psa_status_t tfm_fwu_clean(const psa_msg_t *msg)
     }
 }
 
+#if FWU_WRITE_STATS
+static psa_status_t tfm_fwu_write_stats(const psa_msg_t *msg)
+{
+    struct tfm_fwu_write_stats_t stats;
+
+    if (msg->out_size[0] != sizeof(stats)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    fwu_bootloader_get_write_stats(&stats);
+    psa_write(msg->handle, 0, &stats, sizeof(stats));
+
+    return PSA_SUCCESS;
+}
+#endif /* FWU_WRITE_STATS */
+
 psa_status_t tfm_firmware_update_service_sfn(const psa_msg_t *msg)
 {
     switch (msg->type) {
@@ -527,6 +543,10 @@ psa_status_t tfm_firmware_update_service_sfn(const psa_msg_t *msg)
         return tfm_fwu_accept();
     case TFM_FWU_REJECT:
         return tfm_fwu_reject(msg);
+#if FWU_WRITE_STATS
+    case TFM_FWU_GET_WRITE_STATS:
+        return tfm_fwu_write_stats(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -534,8 +554,25 @@ psa_status_t tfm_firmware_update_service_sfn(const psa_msg_t *msg)
 
 psa_status_t tfm_fwu_entry(void)
 {
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    psa_fwu_component_t component;
+    psa_fwu_component_info_t info;
+#endif
+
     if (fwu_bootloader_init() != 0) {
         return PSA_ERROR_GENERIC_ERROR;
     }
+
+#if FWU_RESUME_CHECKPOINT_SIZE != 0
+    /* Continue the FWU processes the bootloader restored after a reset. */
+    COMPONENTS_ITER(component) {
+        if ((fwu_bootloader_get_image_info(component, true, false,
+                                          &info) == PSA_SUCCESS) &&
+            (info.state == PSA_FWU_WRITING)) {
+            fwu_ctx[component].in_use = true;
+            fwu_ctx[component].component_state = PSA_FWU_WRITING;
+        }
+    }
+#endif
     return PSA_SUCCESS;
 }
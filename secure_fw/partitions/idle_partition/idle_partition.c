@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,43 @@
 #include "cmsis.h"
 #include "fih.h"
 #include "psa/service.h"
+#include "ffm/tickless_idle.h"
+#ifdef TFM_SPM_LOG_BUFFERED
+#include "tfm_hal_spm_logdev.h"
+#endif
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+#include "tfm_hal_secure_cores.h"
+#endif
+
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+#define IDLE_SLEEP()    spm_idle_enter()
+#else
+#define IDLE_SLEEP()    __WFI()
+#endif
+
+/* Deferred work of the Partitions runs when nothing else is runnable */
+#if CONFIG_TFM_WORKQ == 1
+#define IDLE_KICK_WORK()    spm_idle_kick_work()
+#else
+#define IDLE_KICK_WORK()    false
+#endif
+
+/*
+ * The log output buffered while Partitions were running is sent when idle. The
+ * idle Partition of the first secure core owns the log device.
+ */
+#if defined(TFM_SPM_LOG_BUFFERED) && CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+#define IDLE_LOG_DRAIN()                            \
+    do {                                            \
+        if (tfm_hal_get_secure_core_id() == 0) {    \
+            tfm_hal_spm_log_drain();                \
+        }                                           \
+    } while (0)
+#elif defined(TFM_SPM_LOG_BUFFERED)
+#define IDLE_LOG_DRAIN()    tfm_hal_spm_log_drain()
+#else
+#define IDLE_LOG_DRAIN()
+#endif
 
 void tfm_idle_thread(void)
 {
@@ -17,8 +54,9 @@ void tfm_idle_thread(void)
          * This is a dummy psa_wait to let SPM check possible scheduling.
          * It does not expect any signals.
          */
-        if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
-            __WFI();
+        if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0 && !IDLE_KICK_WORK()) {
+            IDLE_LOG_DRAIN();
+            IDLE_SLEEP();
         }
     }
 
@@ -31,8 +69,9 @@ void tfm_idle_thread(void)
          * This is a dummy psa_wait to let SPM check possible scheduling.
          * It does not expect any signals.
          */
-        if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
-            __WFI();
+        if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0 && !IDLE_KICK_WORK()) {
+            IDLE_LOG_DRAIN();
+            IDLE_SLEEP();
         }
     }
 #endif
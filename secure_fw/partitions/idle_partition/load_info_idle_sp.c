@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -11,6 +11,7 @@
 #include "load/partition_defs.h"
 #include "load/service_defs.h"
 #include "load/asset_defs.h"
+#include "runtime_defs.h"
 /* Note that region_defs.h must be included before tfm_s_linker_alignments.h
  * to let platform overwrite default alignment values.
  */
@@ -31,6 +32,7 @@ struct partition_tfm_sp_idle_load_info_t {
     /* per-partition variable length load data */
     uintptr_t                       stack_addr;
     uintptr_t                       heap_addr;
+    uintptr_t                       metadata_addr;
 #if TFM_LVL == 3
     struct asset_desc_t             assets[TFM_SP_IDLE_NASSETS];
 #endif
@@ -41,6 +43,15 @@ extern void tfm_idle_thread(void);
 /* Stack */
 uint8_t idle_sp_stack[IDLE_SP_STACK_SIZE] __attribute__((aligned(TFM_LINKER_IDLE_PARTITION_STACK_ALIGNMENT)));
 
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+/* Runtime metadata */
+static const struct runtime_metadata_t idle_metadata = {
+    .entry                          = (uintptr_t)tfm_idle_thread,
+    .psa_fns                        = RUNTIME_METADATA_PSA_FNS,
+    .n_sfn                          = 0,
+};
+#endif
+
 /* Partition load, deps, service load data. Put to a dedicated section. */
 #if defined(__ICCARM__)
 #pragma location = ".part_load_priority_lowest"
@@ -66,6 +77,11 @@ const struct partition_tfm_sp_idle_load_info_t
     },
     .stack_addr                     = (uintptr_t)idle_sp_stack,
     .heap_addr                      = 0,
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    .metadata_addr                  = (uintptr_t)&idle_metadata,
+#else
+    .metadata_addr                  = 0,
+#endif
 #if TFM_LVL == 3
     .assets                         = {
         {
@@ -85,3 +101,54 @@ __root
 #endif
 static struct partition_t tfm_idle_partition_runtime_item
     __attribute__((used, section(".bss.part_runtime_priority_lowest")));
+
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+/* Each secure core needs an idle Partition to run when nothing else is ready */
+uint8_t idle_sp_core1_stack[IDLE_SP_STACK_SIZE] __attribute__((aligned(TFM_LINKER_IDLE_PARTITION_STACK_ALIGNMENT)));
+
+#if defined(__ICCARM__)
+#pragma location = ".part_load_priority_lowest"
+__root
+#endif
+const struct partition_tfm_sp_idle_load_info_t
+    tfm_sp_idle_core1_load __attribute__((used, section(".part_load_priority_lowest"))) = {
+    .load_info = {
+        .psa_ff_ver                 = 0x0101 | PARTITION_INFO_MAGIC,
+        .pid                        = TFM_SP_IDLE_CORE1_ID,
+        .flags                      = PARTITION_PRI_LOWEST | PARTITION_MODEL_IPC
+                                      | PARTITION_MODEL_PSA_ROT
+                                      | PARTITION_CORE(1),
+        .entry                      = ENTRY_TO_POSITION(tfm_idle_thread),
+        .stack_size                 = IDLE_SP_STACK_SIZE,
+        .heap_size                  = 0,
+        .ndeps                      = 0,
+        .nservices                  = 0,
+#if TFM_LVL == 3
+        .nassets                    = TFM_SP_IDLE_NASSETS,
+#else
+        .nassets                    = 0,
+#endif
+    },
+    .stack_addr                     = (uintptr_t)idle_sp_core1_stack,
+    .heap_addr                      = 0,
+    .metadata_addr                  = (uintptr_t)&idle_metadata,
+#if TFM_LVL == 3
+    .assets                         = {
+        {
+            .mem.start              = (uintptr_t)idle_sp_core1_stack,
+
+            .mem.limit              = (uintptr_t)&idle_sp_core1_stack[IDLE_SP_STACK_SIZE],
+            .attr                   = ASSET_ATTR_READ_WRITE,
+        },
+    },
+#endif
+};
+
+/* Placeholder for partition runtime space. Do not reference it. */
+#if defined(__ICCARM__)
+#pragma location = ".bss.part_runtime_priority_lowest"
+__root
+#endif
+static struct partition_t tfm_idle_core1_partition_runtime_item
+    __attribute__((used, section(".bss.part_runtime_priority_lowest")));
+#endif /* CONFIG_TFM_SPM_SECURE_CORE_NUM > 1 */
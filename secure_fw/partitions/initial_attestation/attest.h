@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,9 +8,12 @@
 #ifndef __ATTEST_H__
 #define __ATTEST_H__
 
+#include <stdint.h>
+#include "config_tfm.h"
 #include "psa/initial_attestation.h"
 #include "psa/client.h"
 #include "tfm_boot_status.h"
+#include "tfm_attest_defs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -109,6 +112,15 @@ initial_attest_get_token(const void *challenge_buf, size_t challenge_size,
 psa_status_t
 initial_attest_get_token_size(size_t challenge_size, size_t *token_size);
 
+#if ATTEST_TOKEN_STATS
+/**
+ * \brief Get the token creation statistics of the service
+ *
+ * \param[out] stats  Where to copy the statistics
+ */
+void attest_get_token_stats(struct tfm_attest_token_stats_t *stats);
+#endif /* ATTEST_TOKEN_STATS */
+
 #ifdef __cplusplus
 }
 #endif
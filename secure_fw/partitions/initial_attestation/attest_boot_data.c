@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -47,96 +47,118 @@ __attribute__ ((aligned(4)))
 static struct attest_boot_data boot_data;
 
 /*!
- * \brief Static function to look up all entries in the shared data area
- *       (boot status) which belong to a specific module.
+ * \struct attest_boot_data_index
  *
- * \param[in]     module  The identifier of SW module to look up based on this
- * \param[out]    claim   The type of SW module's attribute
- * \param[out]    tlv_len Length of the shared data entry
- * \param[in/out] tlv_ptr Pointer to the shared data entry. If its value NULL as
- *                        input then it will starts the look up from the
- *                        beginning of the shared data section. If not NULL then
- *                        it continue look up from the next entry. It returns
- *                        the address of next found entry which belongs to
- *                        module.
+ * \brief Offsets in \ref boot_data of the TLV entries looked up by the service
  *
- * \retval    -1          Error, boot status is malformed
- * \retval     0          Entry not found
- * \retval     1          Entry found
+ * \details Built once by \ref attest_boot_data_init, so that a look up does
+ *          not need to walk the boot status. An offset of 0 means that there is
+ *          no such entry, as no entry can start in the header.
  */
-static int32_t attest_get_tlv_by_module(uint8_t    module,
-                                        uint8_t   *claim,
-                                        uint16_t  *tlv_len,
-                                        uint8_t  **tlv_ptr)
+struct attest_boot_data_index {
+    bool valid;                           /* Boot status is well-formed */
+    uint16_t module_tlv[SW_MAX];          /* First entry of each SW module */
+    /* First entry of each claim which belongs to the SW_GENERAL module */
+    uint16_t general_tlv[CLAIM_MASK + 1];
+};
+
+static struct attest_boot_data_index boot_data_index;
+
+/*!
+ * \brief Static function to index the entries of the boot status.
+ */
+static void attest_boot_data_index_init(void)
 {
     struct shared_data_tlv_entry tlv_entry;
     uint8_t *tlv_end;
     uint8_t *tlv_curr;
+    uint16_t offset;
+    uint8_t module;
+    uint8_t claim;
+
+    (void)memset(&boot_data_index, 0, sizeof(boot_data_index));
 
     if (boot_data.header.tlv_magic != SHARED_DATA_TLV_INFO_MAGIC) {
-        return -1;
+        return;
     }
 
     /* Get the boundaries of TLV section where to lookup*/
     tlv_end = (uint8_t *)&boot_data + boot_data.header.tlv_tot_len;
-    if (*tlv_ptr == NULL) {
-        /* At first call set to the beginning of the TLV section */
-        tlv_curr = boot_data.data;
-    } else {
-        /* Any subsequent call set to the next TLV entry */
-        (void)memcpy(&tlv_entry, *tlv_ptr, SHARED_DATA_ENTRY_HEADER_SIZE);
-
-        tlv_curr  = (*tlv_ptr) + SHARED_DATA_ENTRY_HEADER_SIZE
-                    + tlv_entry.tlv_len;
-    }
+    tlv_curr = boot_data.data;
 
-    /* Iterates over the TLV section and returns the address and size of TLVs
-     * with requested module identifier
-     */
-    while (tlv_curr < tlv_end) {
+    while (tlv_curr + SHARED_DATA_ENTRY_HEADER_SIZE <= tlv_end) {
         /* Create local copy to avoid unaligned access */
         (void)memcpy(&tlv_entry, tlv_curr, SHARED_DATA_ENTRY_HEADER_SIZE);
-        if (GET_IAS_MODULE(tlv_entry.tlv_type) == module) {
-            *claim   = GET_IAS_CLAIM(tlv_entry.tlv_type);
-            *tlv_ptr = tlv_curr;
-            *tlv_len = tlv_entry.tlv_len;
-            return 1;
+
+        offset = (uint16_t)(tlv_curr - (uint8_t *)&boot_data);
+        module = GET_IAS_MODULE(tlv_entry.tlv_type);
+        claim = GET_IAS_CLAIM(tlv_entry.tlv_type);
+
+        if ((module < SW_MAX) && (boot_data_index.module_tlv[module] == 0)) {
+            boot_data_index.module_tlv[module] = offset;
+        }
+
+        if ((module == SW_GENERAL) &&
+            (boot_data_index.general_tlv[claim] == 0)) {
+            boot_data_index.general_tlv[claim] = offset;
         }
 
         tlv_curr += (SHARED_DATA_ENTRY_HEADER_SIZE + tlv_entry.tlv_len);
     }
 
-    return 0;
+    boot_data_index.valid = true;
+}
+
+/*!
+ * \brief Static function to get an indexed entry of the boot status.
+ *
+ * \param[in]  offset   Offset of the entry in \ref boot_data, 0 if none
+ * \param[out] claim    The type of SW module's attribute, can be NULL
+ * \param[out] tlv_len  Length of the shared data entry
+ * \param[out] tlv_ptr  Pointer to the shared data entry
+ *
+ * \retval    -1          Error, boot status is malformed
+ * \retval     0          Entry not found
+ * \retval     1          Entry found
+ */
+static int32_t attest_get_indexed_tlv(uint16_t   offset,
+                                      uint8_t   *claim,
+                                      uint16_t  *tlv_len,
+                                      uint8_t  **tlv_ptr)
+{
+    struct shared_data_tlv_entry tlv_entry;
+
+    if (!boot_data_index.valid) {
+        return -1;
+    }
+
+    if (offset == 0) {
+        return 0;
+    }
+
+    *tlv_ptr = (uint8_t *)&boot_data + offset;
+
+    /* Create local copy to avoid unaligned access */
+    (void)memcpy(&tlv_entry, *tlv_ptr, SHARED_DATA_ENTRY_HEADER_SIZE);
+    if (claim != NULL) {
+        *claim = GET_IAS_CLAIM(tlv_entry.tlv_type);
+    }
+    *tlv_len = tlv_entry.tlv_len;
+
+    return 1;
 }
 
 int32_t attest_get_tlv_by_id(uint8_t    claim,
                              uint16_t  *tlv_len,
                              uint8_t  **tlv_ptr)
 {
-    uint8_t tlv_id;
-    uint8_t module = SW_GENERAL;
-    int32_t found;
-
-    /* Ensure that look up starting from the beginning of the boot status */
-    *tlv_ptr = NULL;
+    if (claim > CLAIM_MASK) {
+        return 0;
+    }
 
     /* Look up specific TLV entry which belongs to SW_GENERAL module */
-    do {
-        /* Look up next entry */
-        found = attest_get_tlv_by_module(module, &tlv_id,
-                                         tlv_len, tlv_ptr);
-        if (found != 1) {
-            break;
-        }
-        /* At least one entry was found which belongs to SW_GENERAL,
-         * check whether this one is looked for
-         */
-        if (claim == tlv_id) {
-            break;
-        }
-    } while (found == 1);
-
-    return found;
+    return attest_get_indexed_tlv(boot_data_index.general_tlv[claim], NULL,
+                                  tlv_len, tlv_ptr);
 }
 
 #ifdef TFM_PARTITION_MEASURED_BOOT
@@ -331,14 +353,9 @@ attest_encode_sw_components_array(QCBOREncodeContext *encode_ctx,
      * that was received from the secure bootloader.
      */
     for (module = 0; module < SW_MAX; ++module) {
-        /* Indicates to restart the look up from the beginning of the shared
-         * data section.
-         */
-        tlv_ptr = NULL;
-
         /* Look up the first TLV entry which belongs to the SW module */
-        found = attest_get_tlv_by_module(module, &tlv_id,
-                                         &tlv_len, &tlv_ptr);
+        found = attest_get_indexed_tlv(boot_data_index.module_tlv[module],
+                                       &tlv_id, &tlv_len, &tlv_ptr);
         if (found == -1) {
             /* Boot status area is malformed. */
             return PSA_ATTEST_ERR_CLAIM_UNAVAILABLE;
@@ -370,7 +387,16 @@ attest_encode_sw_components_array(QCBOREncodeContext *encode_ctx,
 
 enum psa_attest_err_t attest_boot_data_init(void)
 {
-    return attest_get_boot_data(TLV_MAJOR_IAS,
-                                (struct tfm_boot_data *)&boot_data,
-                                MAX_BOOT_STATUS);
+    enum psa_attest_err_t err;
+
+    err = attest_get_boot_data(TLV_MAJOR_IAS,
+                               (struct tfm_boot_data *)&boot_data,
+                               MAX_BOOT_STATUS);
+    if (err != PSA_ATTEST_ERR_SUCCESS) {
+        return err;
+    }
+
+    attest_boot_data_index_init();
+
+    return PSA_ATTEST_ERR_SUCCESS;
 }
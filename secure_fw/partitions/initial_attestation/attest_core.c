@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stddef.h>
@@ -21,6 +22,13 @@
 #include "tfm_attest_iat_defs.h"
 #include "t_cose_common.h"
 #include "tfm_crypto_defs.h"
+#if ATTEST_TOKEN_STATS
+#include "cycle_counter.h"
+#endif
+
+#if ATTEST_TOKEN_STATS && (TFM_ISOLATION_LEVEL != 1)
+#error "ATTEST_TOKEN_STATS reads the cycle counter, it needs TFM_ISOLATION_LEVEL 1"
+#endif
 
 #define ARRAY_LENGTH(array) (sizeof(array) / sizeof(*(array)))
 
@@ -59,10 +67,46 @@ error_mapping_to_psa_status_t(enum psa_attest_err_t attest_err)
     }
 }
 
+#if ATTEST_TOKEN_STATS
+static struct tfm_attest_token_stats_t token_stats;
+
+/*!
+ * \brief Static function to account the cycles of a token creation stage.
+ *
+ * \param[in]  token  Token buffer, the size queries have a NULL pointer
+ * \param[in]  stage  The stage which ends
+ * \param[in]  since  Cycle count at the start of the stage
+ *
+ * \return Returns the cycle count at the end of the stage
+ */
+static uint32_t attest_stats_stage(const struct q_useful_buf *token,
+                                   enum tfm_attest_token_stage_t stage,
+                                   uint32_t since)
+{
+    uint32_t now = cycle_counter_read();
+
+    if (token->ptr != NULL) {
+        token_stats.last_cycles[stage] = now - since;
+        token_stats.total_cycles[stage] += now - since;
+    }
+
+    return now;
+}
+
+void attest_get_token_stats(struct tfm_attest_token_stats_t *stats)
+{
+    *stats = token_stats;
+}
+#endif /* ATTEST_TOKEN_STATS */
+
 psa_status_t attest_init(void)
 {
     enum psa_attest_err_t res;
 
+#if ATTEST_TOKEN_STATS
+    cycle_counter_enable();
+#endif
+
     res = attest_boot_data_init();
 
     return error_mapping_to_psa_status_t(res);
@@ -234,16 +278,15 @@ attest_add_instance_id_claim(struct attest_token_encode_ctx *token_ctx)
 }
 
 /*!
- * \brief Static function to add security lifecycle claim to attestation token.
+ * \brief Static function to get the current security lifecycle state.
  *
- * \param[in]  token_ctx  Token encoding context
+ * \param[out] security_lifecycle  Security lifecycle state
  *
  * \return Returns error code as specified in \ref psa_attest_err_t
  */
 static enum psa_attest_err_t
-attest_add_security_lifecycle_claim(struct attest_token_encode_ctx *token_ctx)
+attest_get_security_lifecycle(enum tfm_security_lifecycle_t *security_lifecycle)
 {
-    enum tfm_security_lifecycle_t security_lifecycle;
     uint32_t slc_value;
     int32_t res;
     struct q_useful_buf_c claim_value = {0};
@@ -262,22 +305,68 @@ attest_add_security_lifecycle_claim(struct attest_token_encode_ctx *token_ctx)
         if (res) {
             return PSA_ATTEST_ERR_GENERAL;
         }
-        security_lifecycle = (enum tfm_security_lifecycle_t)slc_value;
+        *security_lifecycle = (enum tfm_security_lifecycle_t)slc_value;
     } else {
         /* If not found in boot status then use callback function to get it
          * from runtime SW
          */
-        security_lifecycle = tfm_attest_hal_get_security_lifecycle();
+        *security_lifecycle = tfm_attest_hal_get_security_lifecycle();
     }
 
     /* Sanity check */
-    if (security_lifecycle > TFM_SLC_MAX_VALUE) {
+    if (*security_lifecycle > TFM_SLC_MAX_VALUE) {
         return PSA_ATTEST_ERR_GENERAL;
     }
 
-    attest_token_encode_add_integer(token_ctx,
-                                    IAT_SECURITY_LIFECYCLE,
-                                    (int64_t)security_lifecycle);
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to get the label and the value of the security
+ *        lifecycle claim.
+ *
+ * \param[out] label  Label of the claim
+ * \param[out] value  Value of the claim
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_get_security_lifecycle_claim(int32_t *label, int64_t *value)
+{
+    enum tfm_security_lifecycle_t security_lifecycle;
+    enum psa_attest_err_t err;
+
+    err = attest_get_security_lifecycle(&security_lifecycle);
+    if (err != PSA_ATTEST_ERR_SUCCESS) {
+        return err;
+    }
+
+    *label = IAT_SECURITY_LIFECYCLE;
+    *value = (int64_t)security_lifecycle;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to add security lifecycle claim to attestation token.
+ *
+ * \param[in]  token_ctx  Token encoding context
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_add_security_lifecycle_claim(struct attest_token_encode_ctx *token_ctx)
+{
+    enum psa_attest_err_t err;
+    int32_t label;
+    int64_t value;
+
+    err = attest_get_security_lifecycle_claim(&label, &value);
+    if (err != PSA_ATTEST_ERR_SUCCESS) {
+        return err;
+    }
+
+    attest_token_encode_add_integer(token_ctx, label, value);
 
     return PSA_ATTEST_ERR_SUCCESS;
 }
@@ -388,6 +477,32 @@ attest_add_boot_seed_claim(struct attest_token_encode_ctx *token_ctx)
     return PSA_ATTEST_ERR_SUCCESS;
 }
 
+/*!
+ * \brief Static function to get the label and the value of the caller id
+ *        claim.
+ *
+ * \param[out] label  Label of the claim
+ * \param[out] value  Value of the claim
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_get_caller_id_claim(int32_t *label, int64_t *value)
+{
+    enum psa_attest_err_t res;
+    int32_t caller_id;
+
+    res = attest_get_caller_client_id(&caller_id);
+    if (res != PSA_ATTEST_ERR_SUCCESS) {
+        return res;
+    }
+
+    *label = IAT_CLIENT_ID;
+    *value = (int64_t)caller_id;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
 /*!
  * \brief Static function to add caller id claim to attestation token.
  *
@@ -399,16 +514,15 @@ static enum psa_attest_err_t
 attest_add_caller_id_claim(struct attest_token_encode_ctx *token_ctx)
 {
     enum psa_attest_err_t res;
-    int32_t caller_id;
+    int32_t label;
+    int64_t value;
 
-    res = attest_get_caller_client_id(&caller_id);
+    res = attest_get_caller_id_claim(&label, &value);
     if (res != PSA_ATTEST_ERR_SUCCESS) {
         return res;
     }
 
-    attest_token_encode_add_integer(token_ctx,
-                                    IAT_CLIENT_ID,
-                                    (int64_t)caller_id);
+    attest_token_encode_add_integer(token_ctx, label, value);
 
     return PSA_ATTEST_ERR_SUCCESS;
 }
@@ -679,38 +793,422 @@ static enum psa_attest_err_t attest_get_t_cose_algorithm(
     return PSA_ATTEST_ERR_SUCCESS;
 }
 
+/* The SW components claim can only be cached when it is built from the boot
+ * data. Measurements recorded in the Measured Boot partition can still be
+ * extended at runtime.
+ */
+#ifdef TFM_PARTITION_MEASURED_BOOT
+#define ATTEST_SW_COMPONENTS_STATIC false
+#else
+#define ATTEST_SW_COMPONENTS_STATIC true
+#endif
+
+/*!
+ * \struct attest_claim_t
+ *
+ * \brief Claim added to every token by \ref attest_create_token
+ */
+struct attest_claim_t {
+    enum psa_attest_err_t (*add)(struct attest_token_encode_ctx *token_ctx);
+    bool is_static; /*!< The claim value does not change until next boot */
+    /*! Gets the label and the value of an integer claim, NULL for the others */
+    enum psa_attest_err_t (*get_int)(int32_t *label, int64_t *value);
+};
+
 #if ATTEST_TOKEN_PROFILE_PSA_IOT_1 || ATTEST_TOKEN_PROFILE_PSA_2_0_0
-    static enum psa_attest_err_t
-    (*claim_query_funcs[])(struct attest_token_encode_ctx *) = {
-        &attest_add_boot_seed_claim,
-        &attest_add_instance_id_claim,
-        &attest_add_implementation_id_claim,
-        &attest_add_caller_id_claim,
-        &attest_add_security_lifecycle_claim,
-        &attest_add_all_sw_components,
-        &attest_add_profile_definition,
+    static const struct attest_claim_t claim_query_funcs[] = {
+        {&attest_add_boot_seed_claim,          true,  NULL},
+        {&attest_add_instance_id_claim,        true,  NULL},
+        {&attest_add_implementation_id_claim,  true,  NULL},
+        {&attest_add_caller_id_claim,          false,
+         &attest_get_caller_id_claim},
+        {&attest_add_security_lifecycle_claim, false,
+         &attest_get_security_lifecycle_claim},
+        {&attest_add_all_sw_components,        ATTEST_SW_COMPONENTS_STATIC,
+         NULL},
+        {&attest_add_profile_definition,       true,  NULL},
 #if ATTEST_INCLUDE_OPTIONAL_CLAIMS
-        &attest_add_verification_service,
-        &attest_add_cert_ref_claim
+        {&attest_add_verification_service,     true,  NULL},
+        {&attest_add_cert_ref_claim,           true,  NULL}
 #endif
     };
 #elif ATTEST_TOKEN_PROFILE_ARM_CCA
 
-    static enum psa_attest_err_t
-    (*claim_query_funcs[])(struct attest_token_encode_ctx *) = {
-        &attest_add_instance_id_claim,
-        &attest_add_implementation_id_claim,
-        &attest_add_security_lifecycle_claim,
-        &attest_add_all_sw_components,
-        &attest_add_profile_definition,
-        &attest_add_hash_algo_claim,
-        &attest_add_platform_config_claim,
+    static const struct attest_claim_t claim_query_funcs[] = {
+        {&attest_add_instance_id_claim,        true,  NULL},
+        {&attest_add_implementation_id_claim,  true,  NULL},
+        {&attest_add_security_lifecycle_claim, false,
+         &attest_get_security_lifecycle_claim},
+        {&attest_add_all_sw_components,        ATTEST_SW_COMPONENTS_STATIC,
+         NULL},
+        {&attest_add_profile_definition,       true,  NULL},
+        {&attest_add_hash_algo_claim,          true,  NULL},
+        {&attest_add_platform_config_claim,    true,  NULL},
 #if ATTEST_INCLUDE_OPTIONAL_CLAIMS
-        &attest_add_verification_service,
+        {&attest_add_verification_service,     true,  NULL},
 #endif
     };
 #endif
 
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE
+/* CBOR head of a map with a single entry */
+#define CBOR_MAP_OF_ONE           0xA1
+#define CBOR_MAJOR_TYPE_POS_INT   0
+#define CBOR_MAJOR_TYPE_NEG_INT   1
+#define CBOR_MAJOR_TYPE_BSTR      2
+#define CBOR_MAJOR_TYPE_MAP       5
+
+/* Largest CBOR head: the initial byte and an 8 bytes argument */
+#define CBOR_HEAD_MAX_SIZE        9
+
+/* Bytes of the claims map which are not taken from the cache: the map head,
+ * the nonce and the integer claims, the caller ID and the security lifecycle.
+ */
+#define ATTEST_CLAIMS_MAP_DYNAMIC_SIZE \
+    (CBOR_HEAD_MAX_SIZE * 3 + PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64 + \
+     CBOR_HEAD_MAX_SIZE * 2 * 2)
+
+/*!
+ * \struct attest_cached_claim_t
+ *
+ * \brief Encoded value of a static claim
+ *
+ * \details The value is kept apart from its label and added back to the token
+ *          map with \ref attest_token_encode_add_cbor, so the map still counts
+ *          the claim as a single entry.
+ */
+struct attest_cached_claim_t {
+    int32_t label;
+    struct q_useful_buf_c value; /*!< NULL pointer if the claim is not cached */
+    struct q_useful_buf_c entry; /*!< Encoded label and value of the claim */
+};
+
+static uint8_t claim_cache_buf[ATTEST_STATIC_CLAIMS_CACHE_SIZE];
+static struct attest_cached_claim_t claim_cache[ARRAY_LENGTH(claim_query_funcs)];
+static bool claim_cache_ready;
+/* Every claim is either cached or an integer claim */
+static bool claim_cache_complete;
+
+/* The claims map, when it is encoded by \ref attest_encode_claims_map */
+static uint8_t claims_map_buf[ATTEST_STATIC_CLAIMS_CACHE_SIZE +
+                              ATTEST_CLAIMS_MAP_DYNAMIC_SIZE];
+
+static int32_t cached_cose_algorithm_id;
+static bool cose_algorithm_ready;
+
+/* Kept out of the stack, as it is only needed while the cache is built */
+static struct attest_token_encode_ctx claim_cache_encode_ctx;
+
+/*!
+ * \brief Static function to split the label and the value of the single claim
+ *        captured in a map.
+ *
+ * \param[in]  encoded  Encoded map which holds one claim
+ * \param[out] claim    Label and value of the claim
+ *
+ * \return Returns 0 on success and -1 if the claim is not encoded as expected.
+ */
+static int32_t attest_split_cached_claim(const struct q_useful_buf_c *encoded,
+                                         struct attest_cached_claim_t *claim)
+{
+    const uint8_t *cbor = encoded->ptr;
+    uint8_t major_type;
+    uint8_t additional_info;
+    size_t head_len;
+    uint32_t arg = 0;
+    size_t i;
+
+    if ((encoded->len < 2) || (cbor[0] != CBOR_MAP_OF_ONE)) {
+        return -1;
+    }
+
+    major_type = cbor[1] >> 5;
+    additional_info = cbor[1] & 0x1F;
+
+    if ((major_type != CBOR_MAJOR_TYPE_POS_INT) &&
+        (major_type != CBOR_MAJOR_TYPE_NEG_INT)) {
+        return -1;
+    }
+
+    if (additional_info < 24) {
+        head_len = 1;
+        arg = additional_info;
+    } else if (additional_info <= 26) {
+        /* 1, 2 or 4 bytes of argument follow the initial byte */
+        head_len = 1 + (1u << (additional_info - 24));
+    } else {
+        return -1;
+    }
+
+    if (encoded->len <= 1 + head_len) {
+        return -1;
+    }
+
+    for (i = 1; i < head_len; i++) {
+        arg = (arg << 8) | cbor[1 + i];
+    }
+
+    if (arg > INT32_MAX) {
+        return -1;
+    }
+
+    claim->label = (major_type == CBOR_MAJOR_TYPE_POS_INT) ?
+                   (int32_t)arg : -1 - (int32_t)arg;
+    claim->value.ptr = &cbor[1 + head_len];
+    claim->value.len = encoded->len - 1 - head_len;
+    claim->entry.ptr = &cbor[1];
+    claim->entry.len = encoded->len - 1;
+
+    return 0;
+}
+
+/*!
+ * \brief Static function to encode the static claims once per boot.
+ *
+ * \details Each static claim is encoded on its own into a map, from which the
+ *          label and the value are recorded. A claim which does not fit the
+ *          remaining space of the cache is left to be encoded for each token.
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t attest_cache_static_claims(void)
+{
+    QCBOREncodeContext *cbor_encode_ctx;
+    struct q_useful_buf free_space;
+    struct q_useful_buf_c encoded;
+    enum psa_attest_err_t err;
+    QCBORError qcbor_err;
+    size_t used = 0;
+    int i;
+
+    cbor_encode_ctx =
+        attest_token_encode_borrow_cbor_cntxt(&claim_cache_encode_ctx);
+    claim_cache_complete = true;
+
+    for (i = 0; i < ARRAY_LENGTH(claim_query_funcs); ++i) {
+        claim_cache[i].value = NULL_Q_USEFUL_BUF_C;
+
+        if (!claim_query_funcs[i].is_static) {
+            if (claim_query_funcs[i].get_int == NULL) {
+                claim_cache_complete = false;
+            }
+            continue;
+        }
+
+        free_space.ptr = &claim_cache_buf[used];
+        free_space.len = sizeof(claim_cache_buf) - used;
+
+        QCBOREncode_Init(cbor_encode_ctx, free_space);
+        QCBOREncode_OpenMap(cbor_encode_ctx);
+        err = claim_query_funcs[i].add(&claim_cache_encode_ctx);
+        if (err != PSA_ATTEST_ERR_SUCCESS) {
+            return err;
+        }
+        QCBOREncode_CloseMap(cbor_encode_ctx);
+
+        qcbor_err = QCBOREncode_Finish(cbor_encode_ctx, &encoded);
+        if (qcbor_err != QCBOR_SUCCESS) {
+            claim_cache_complete = false;
+            continue;
+        }
+
+        if (attest_split_cached_claim(&encoded, &claim_cache[i]) != 0) {
+            claim_cache[i].value = NULL_Q_USEFUL_BUF_C;
+            claim_cache_complete = false;
+            continue;
+        }
+
+        used += encoded.len;
+    }
+
+    claim_cache_ready = true;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+/*!
+ * \brief Static function to encode a CBOR head in its shortest form, as
+ *        QCBOR does.
+ *
+ * \param[out] buf         Buffer of at least \ref CBOR_HEAD_MAX_SIZE bytes
+ * \param[in]  major_type  Major type of the item
+ * \param[in]  arg         Argument of the head
+ *
+ * \return Returns the size of the head in bytes.
+ */
+static size_t attest_encode_cbor_head(uint8_t *buf, uint8_t major_type,
+                                      uint64_t arg)
+{
+    size_t arg_len;
+    size_t i;
+
+    if (arg < 24) {
+        buf[0] = (uint8_t)((major_type << 5) | arg);
+        return 1;
+    } else if (arg <= UINT8_MAX) {
+        buf[0] = (uint8_t)((major_type << 5) | 24);
+        arg_len = 1;
+    } else if (arg <= UINT16_MAX) {
+        buf[0] = (uint8_t)((major_type << 5) | 25);
+        arg_len = 2;
+    } else if (arg <= UINT32_MAX) {
+        buf[0] = (uint8_t)((major_type << 5) | 26);
+        arg_len = 4;
+    } else {
+        buf[0] = (uint8_t)((major_type << 5) | 27);
+        arg_len = 8;
+    }
+
+    /* The argument is big endian */
+    for (i = arg_len; i > 0; i--) {
+        buf[i] = (uint8_t)arg;
+        arg >>= 8;
+    }
+
+    return 1 + arg_len;
+}
+
+/*!
+ * \brief Static function to encode a CBOR integer.
+ *
+ * \param[out] buf    Buffer of at least \ref CBOR_HEAD_MAX_SIZE bytes
+ * \param[in]  value  Value of the integer
+ *
+ * \return Returns the size of the integer in bytes.
+ */
+static size_t attest_encode_cbor_int(uint8_t *buf, int64_t value)
+{
+    if (value < 0) {
+        /* -1 - value can not overflow, unlike -value */
+        return attest_encode_cbor_head(buf, CBOR_MAJOR_TYPE_NEG_INT,
+                                       (uint64_t)(-1 - value));
+    }
+
+    return attest_encode_cbor_head(buf, CBOR_MAJOR_TYPE_POS_INT,
+                                   (uint64_t)value);
+}
+
+/*!
+ * \brief Static function to encode the whole claims map without QCBOR.
+ *
+ * \details Only used when \ref claim_cache_complete is set. The cached claims
+ *          are copied as they are and the integer claims are encoded in
+ *          their shortest form, so the map is the same as the one encoded
+ *          claim by claim with QCBOR. Without a nonce, to get the size of
+ *          the token, only the size of the map is of interest.
+ *
+ * \param[in]  nonce    The challenge, with a NULL pointer to get the size
+ * \param[out] encoded  The encoded map
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_encode_claims_map(const struct q_useful_buf_c *nonce,
+                         struct q_useful_buf_c *encoded)
+{
+    enum psa_attest_err_t err;
+    int32_t label;
+    int64_t value;
+    size_t used;
+    int i;
+
+    if (nonce->len > PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64) {
+        return PSA_ATTEST_ERR_INVALID_INPUT;
+    }
+
+    used = attest_encode_cbor_head(claims_map_buf, CBOR_MAJOR_TYPE_MAP,
+                                   ARRAY_LENGTH(claim_query_funcs) + 1);
+
+    used += attest_encode_cbor_int(&claims_map_buf[used], IAT_NONCE);
+    used += attest_encode_cbor_head(&claims_map_buf[used],
+                                    CBOR_MAJOR_TYPE_BSTR, nonce->len);
+    if (nonce->ptr != NULL) {
+        (void)memcpy(&claims_map_buf[used], nonce->ptr, nonce->len);
+    }
+    used += nonce->len;
+
+    for (i = 0; i < ARRAY_LENGTH(claim_query_funcs); ++i) {
+        if (claim_cache[i].value.ptr != NULL) {
+            (void)memcpy(&claims_map_buf[used], claim_cache[i].entry.ptr,
+                         claim_cache[i].entry.len);
+            used += claim_cache[i].entry.len;
+            continue;
+        }
+
+        err = claim_query_funcs[i].get_int(&label, &value);
+        if (err != PSA_ATTEST_ERR_SUCCESS) {
+            return err;
+        }
+        used += attest_encode_cbor_int(&claims_map_buf[used], label);
+        used += attest_encode_cbor_int(&claims_map_buf[used], value);
+    }
+
+    encoded->ptr = claims_map_buf;
+    encoded->len = used;
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+#endif /* ATTEST_STATIC_CLAIMS_CACHE_SIZE */
+
+/*!
+ * \brief Static function to add all the claims but the nonce to the token.
+ *
+ * \param[in]  token_ctx  Token encoding context
+ *
+ * \return Returns error code as specified in \ref psa_attest_err_t
+ */
+static enum psa_attest_err_t
+attest_add_all_claims(struct attest_token_encode_ctx *token_ctx)
+{
+    enum psa_attest_err_t attest_err;
+    int i;
+
+    for (i = 0; i < ARRAY_LENGTH(claim_query_funcs); ++i) {
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE
+        if (claim_cache[i].value.ptr != NULL) {
+            attest_token_encode_add_cbor(token_ctx,
+                                         claim_cache[i].label,
+                                         &claim_cache[i].value);
+            continue;
+        }
+#endif
+        /* Calling the attest_add_XXX_claim functions */
+        attest_err = claim_query_funcs[i].add(token_ctx);
+        if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+            return attest_err;
+        }
+    }
+
+    return PSA_ATTEST_ERR_SUCCESS;
+}
+
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE && !defined(TFM_PARTITION_MEASURED_BOOT)
+/* Apart from the nonce, only the caller ID and the security lifecycle claims
+ * can change the size of the token until next boot, so the size found for a
+ * challenge size is kept as long as these two claims keep their value.
+ */
+#define ATTEST_TOKEN_SIZE_CACHE 1
+
+/* Challenge sizes accepted by \ref attest_verify_challenge_size */
+#define ATTEST_CHALLENGE_SIZE_NUM  3
+#define ATTEST_CHALLENGE_SIZE_IDX(size) \
+    (((size) - PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32) / 16)
+
+/*!
+ * \struct attest_token_size_t
+ *
+ * \brief Token size computed for one challenge size
+ */
+struct attest_token_size_t {
+    bool valid;
+    int32_t caller_id;
+    enum tfm_security_lifecycle_t security_lifecycle;
+    size_t token_size;
+};
+
+static struct attest_token_size_t token_size_cache[ATTEST_CHALLENGE_SIZE_NUM];
+#endif /* ATTEST_STATIC_CLAIMS_CACHE_SIZE && !TFM_PARTITION_MEASURED_BOOT */
+
 /*!
  * \brief Static function to create the initial attestation token
  *
@@ -733,13 +1231,37 @@ attest_create_token(struct q_useful_buf_c *challenge,
     struct attest_token_encode_ctx attest_token_ctx;
     int32_t key_select = 0;
     uint32_t option_flags = 0;
-    int i;
     int32_t cose_algorithm_id;
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE
+    struct q_useful_buf_c claims_map;
+#endif
+#if ATTEST_TOKEN_STATS
+    uint32_t stage_start = cycle_counter_read();
+#endif
 
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE
+    if (!claim_cache_ready) {
+        attest_err = attest_cache_static_claims();
+        if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+            return attest_err;
+        }
+    }
+
+    /* The attestation key is built in, so its algorithm is looked up once */
+    if (!cose_algorithm_ready) {
+        attest_err = attest_get_t_cose_algorithm(&cached_cose_algorithm_id);
+        if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+            return attest_err;
+        }
+        cose_algorithm_ready = true;
+    }
+    cose_algorithm_id = cached_cose_algorithm_id;
+#else
     attest_err = attest_get_t_cose_algorithm(&cose_algorithm_id);
     if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
         return attest_err;
     }
+#endif
 
 #ifdef INCLUDE_TEST_CODE
     attest_get_option_flags(challenge, &option_flags, &key_select);
@@ -755,6 +1277,15 @@ attest_create_token(struct q_useful_buf_c *challenge,
         cose_algorithm_id = cose_algorithm_id < 0 ? T_COSE_ALGORITHM_ES256 :
                                                     T_COSE_ALGORITHM_HMAC256;
     }
+    /* Only selected below */
+    option_flags &= ~TOKEN_OPT_ENCODED_CLAIMS;
+#endif
+
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE
+    /* The test options change the claims, they keep the generic encoding */
+    if (claim_cache_complete && (option_flags == 0)) {
+        option_flags = TOKEN_OPT_ENCODED_CLAIMS;
+    }
 #endif
 
     /* Get started creating the token. This sets up the CBOR and COSE contexts
@@ -771,28 +1302,54 @@ attest_create_token(struct q_useful_buf_c *challenge,
         goto error;
     }
 
-    attest_err = attest_add_nonce_claim(&attest_token_ctx,
-                                        challenge);
-    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
-        goto error;
-    }
+#if ATTEST_TOKEN_STATS
+    stage_start = attest_stats_stage(token, TFM_ATTEST_TOKEN_STAGE_START,
+                                     stage_start);
+#endif
+
+#if ATTEST_STATIC_CLAIMS_CACHE_SIZE
+    if (option_flags & TOKEN_OPT_ENCODED_CLAIMS) {
+        attest_err = attest_encode_claims_map(challenge, &claims_map);
+        if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+            goto error;
+        }
 
-    if (!(option_flags & TOKEN_OPT_OMIT_CLAIMS)) {
-        for (i = 0; i < ARRAY_LENGTH(claim_query_funcs); ++i) {
-            /* Calling the attest_add_XXX_claim functions */
-            attest_err = claim_query_funcs[i](&attest_token_ctx);
+        attest_token_encode_add_claims_map(&attest_token_ctx, &claims_map);
+    } else
+#endif
+    {
+        attest_err = attest_add_nonce_claim(&attest_token_ctx,
+                                            challenge);
+        if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+            goto error;
+        }
+
+        if (!(option_flags & TOKEN_OPT_OMIT_CLAIMS)) {
+            attest_err = attest_add_all_claims(&attest_token_ctx);
             if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
                 goto error;
             }
         }
     }
 
+#if ATTEST_TOKEN_STATS
+    stage_start = attest_stats_stage(token, TFM_ATTEST_TOKEN_STAGE_CLAIMS,
+                                     stage_start);
+#endif
+
     /* Finish up creating the token. This is where the actual signature
      * is generated. This finishes up the CBOR encoding too.
      */
     token_err = attest_token_encode_finish(&attest_token_ctx, completed_token);
     attest_err = error_mapping_to_psa_attest_err_t(token_err);
 
+#if ATTEST_TOKEN_STATS
+    (void)attest_stats_stage(token, TFM_ATTEST_TOKEN_STAGE_FINISH, stage_start);
+    if ((attest_err == PSA_ATTEST_ERR_SUCCESS) && (token->ptr != NULL)) {
+        token_stats.tokens++;
+    }
+#endif
+
 error:
     return attest_err;
 }
@@ -841,6 +1398,11 @@ initial_attest_get_token_size(const size_t challenge_size,
     struct q_useful_buf_c challenge;
     struct q_useful_buf token;
     struct q_useful_buf_c completed_token;
+#ifdef ATTEST_TOKEN_SIZE_CACHE
+    struct attest_token_size_t *size_cache;
+    enum tfm_security_lifecycle_t security_lifecycle;
+    int32_t caller_id;
+#endif
 
     /* Only the size of the challenge is needed */
     challenge.ptr = NULL;
@@ -855,6 +1417,27 @@ initial_attest_get_token_size(const size_t challenge_size,
         goto error;
     }
 
+#ifdef ATTEST_TOKEN_SIZE_CACHE
+    size_cache = &token_size_cache[ATTEST_CHALLENGE_SIZE_IDX(challenge_size)];
+
+    attest_err = attest_get_caller_client_id(&caller_id);
+    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+        goto error;
+    }
+
+    attest_err = attest_get_security_lifecycle(&security_lifecycle);
+    if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
+        goto error;
+    }
+
+    if (size_cache->valid &&
+        (size_cache->caller_id == caller_id) &&
+        (size_cache->security_lifecycle == security_lifecycle)) {
+        *token_size = size_cache->token_size;
+        return PSA_SUCCESS;
+    }
+#endif
+
     attest_err = attest_create_token(&challenge, &token, &completed_token);
     if (attest_err != PSA_ATTEST_ERR_SUCCESS) {
         goto error;
@@ -862,6 +1445,13 @@ initial_attest_get_token_size(const size_t challenge_size,
 
     *token_size = completed_token.len;
 
+#ifdef ATTEST_TOKEN_SIZE_CACHE
+    size_cache->caller_id = caller_id;
+    size_cache->security_lifecycle = security_lifecycle;
+    size_cache->token_size = completed_token.len;
+    size_cache->valid = true;
+#endif
+
 error:
     return error_mapping_to_psa_status_t(attest_err);
 }
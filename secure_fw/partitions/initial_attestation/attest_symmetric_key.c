@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2018-2019, Laurence Lundblade.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -176,6 +176,8 @@ attest_get_initial_attestation_key_id(struct q_useful_buf_c *attest_key_id)
         }
 
         if (plat_res != TFM_PLAT_ERR_SUCCESS) {
+            /* Fetch the kid again on the next call */
+            kid_len = 0;
             return PSA_ATTEST_ERR_GENERAL;
         }
     }
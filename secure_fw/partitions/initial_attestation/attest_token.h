@@ -111,6 +111,13 @@ enum attest_token_err_t {
  * replicate it. */
 #define TOKEN_OPT_SHORT_CIRCUIT_SIGN 0x80000000
 
+/**
+ * The claims map is not opened by \ref attest_token_encode_start. The
+ * caller adds it whole, already encoded, with
+ * \ref attest_token_encode_add_claims_map.
+ */
+#define TOKEN_OPT_ENCODED_CLAIMS     0x20000000
+
 /**
  * The context for creating an attestation token.  The caller of
  * attest_token_encode must create one of these and pass it to the functions
@@ -235,6 +242,18 @@ void attest_token_encode_add_cbor(struct attest_token_encode_ctx *me,
                                   int32_t label,
                                   const struct q_useful_buf_c *encoded);
 
+/**
+ * \brief Add the whole claims map, already encoded, as the token payload.
+ *
+ * \param[in] me       Token creation context.
+ * \param[in] encoded  The encoded CBOR map of all the claims.
+ *
+ * Only used when the token is started with \ref TOKEN_OPT_ENCODED_CLAIMS,
+ * in place of the claims added one by one.
+ */
+void attest_token_encode_add_claims_map(struct attest_token_encode_ctx *me,
+                                        const struct q_useful_buf_c *encoded);
+
 /**
  * \brief Finish the token, complete the signing and get the result
  *
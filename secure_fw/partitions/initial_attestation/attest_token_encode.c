@@ -145,7 +145,9 @@ attest_token_encode_start(struct attest_token_encode_ctx *me,
         return_value = t_cose_err_to_attest_err(cose_ret);
     }
 
-    QCBOREncode_OpenMap(&(me->cbor_enc_ctx));
+    if (!(opt_flags & TOKEN_OPT_ENCODED_CLAIMS)) {
+        QCBOREncode_OpenMap(&(me->cbor_enc_ctx));
+    }
 
     return return_value;
 }
@@ -163,7 +165,9 @@ attest_token_encode_finish(struct attest_token_encode_ctx *me,
     QCBORError              qcbor_result;
     enum t_cose_err_t       cose_return_value;
 
-    QCBOREncode_CloseMap(&(me->cbor_enc_ctx));
+    if (!(me->opt_flags & TOKEN_OPT_ENCODED_CLAIMS)) {
+        QCBOREncode_CloseMap(&(me->cbor_enc_ctx));
+    }
 
     /* -- Finish up the COSE_Mac0. This is where the MAC happens -- */
     cose_return_value = t_cose_mac0_encode_tag(&(me->mac_ctx),
@@ -274,7 +278,9 @@ attest_token_encode_start(struct attest_token_encode_ctx *me,
         return_value = t_cose_err_to_attest_err(cose_ret);
     }
 
-    QCBOREncode_OpenMap(&(me->cbor_enc_ctx));
+    if (!(opt_flags & TOKEN_OPT_ENCODED_CLAIMS)) {
+        QCBOREncode_OpenMap(&(me->cbor_enc_ctx));
+    }
 
     return return_value;
 }
@@ -292,7 +298,9 @@ attest_token_encode_finish(struct attest_token_encode_ctx *me,
     QCBORError              qcbor_result;
     enum t_cose_err_t       cose_return_value;
 
-    QCBOREncode_CloseMap(&(me->cbor_enc_ctx));
+    if (!(me->opt_flags & TOKEN_OPT_ENCODED_CLAIMS)) {
+        QCBOREncode_CloseMap(&(me->cbor_enc_ctx));
+    }
 
     /* -- Finish up the COSE_Sign1. This is where the signing happens -- */
     cose_return_value = t_cose_sign1_encode_signature(&(me->signer_ctx),
@@ -375,3 +383,13 @@ void attest_token_encode_add_cbor(struct attest_token_encode_ctx *me,
 {
     QCBOREncode_AddEncodedToMapN(&(me->cbor_enc_ctx), label, *encoded);
 }
+
+
+/*
+ * Public function. See attest_token.h
+ */
+void attest_token_encode_add_claims_map(struct attest_token_encode_ctx *me,
+                                        const struct q_useful_buf_c *encoded)
+{
+    QCBOREncode_AddEncoded(&(me->cbor_enc_ctx), *encoded);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -26,6 +26,49 @@ typedef psa_status_t (*attest_func_t)(const psa_msg_t *msg);
 
 int32_t g_attest_caller_id;
 
+/*!
+ * \brief Check the vectors of a TFM_ATTEST_GET_TOKENS request and get the
+ *        size and the number of its challenges.
+ *
+ * \param[in]  msg             The TFM_ATTEST_GET_TOKENS message
+ * \param[out] challenge_size  Size of each challenge
+ * \param[out] num_challenges  Number of challenges
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t psa_attest_get_tokens_params(const psa_msg_t *msg,
+                                                 size_t *challenge_size,
+                                                 size_t *num_challenges)
+{
+    size_t bytes_read;
+
+    if (msg->in_size[1] != sizeof(*challenge_size)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    bytes_read = psa_read(msg->handle, 1, challenge_size, msg->in_size[1]);
+    if (bytes_read != sizeof(*challenge_size)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (*challenge_size > PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64
+        || *challenge_size == 0 || msg->out_size[0] == 0
+        || msg->in_size[0] % *challenge_size != 0) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    *num_challenges = msg->in_size[0] / *challenge_size;
+    if (*num_challenges == 0
+        || msg->out_size[1] != *num_challenges * sizeof(size_t)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* store the client ID here for later use in service */
+    g_attest_caller_id = msg->client_id;
+
+    return PSA_SUCCESS;
+}
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
 static psa_status_t psa_attest_get_token(const psa_msg_t *msg)
 {
@@ -58,8 +101,59 @@ static psa_status_t psa_attest_get_token(const psa_msg_t *msg)
 
     return status;
 }
+
+static psa_status_t psa_attest_get_tokens(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    const uint8_t *challenge_buff;
+    uint8_t *token_buff;
+    uint8_t *token_sizes;
+    size_t challenge_size;
+    size_t num_challenges;
+    size_t token_offset = 0;
+    size_t token_size;
+    size_t i;
+
+    status = psa_attest_get_tokens_params(msg, &challenge_size,
+                                          &num_challenges);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    challenge_buff = psa_map_invec(msg->handle, 0);
+    token_buff = psa_map_outvec(msg->handle, 0);
+    token_sizes = psa_map_outvec(msg->handle, 1);
+
+    for (i = 0; i < num_challenges; i++) {
+        if (token_offset == msg->out_size[0]) {
+            return PSA_ERROR_BUFFER_TOO_SMALL;
+        }
+
+        status = initial_attest_get_token(&challenge_buff[i * challenge_size],
+                                          challenge_size,
+                                          &token_buff[token_offset],
+                                          msg->out_size[0] - token_offset,
+                                          &token_size);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        /* The caller's array may not be aligned for a direct store */
+        (void)memcpy(&token_sizes[i * sizeof(token_size)], &token_size,
+                     sizeof(token_size));
+        token_offset += token_size;
+    }
+
+    psa_unmap_outvec(msg->handle, 0, token_offset);
+    psa_unmap_outvec(msg->handle, 1, msg->out_size[1]);
+
+    return PSA_SUCCESS;
+}
 #else /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
-/* Buffer to store the created attestation token. */
+/* Buffer to store the created attestation token. The whole token has to be
+ * encoded before any of it is written to the caller, as the CBOR lengths are
+ * filled in when the maps are closed and the payload is signed in place.
+ */
 static uint8_t token_buff[PSA_INITIAL_ATTEST_TOKEN_MAX_SIZE];
 
 static psa_status_t psa_attest_get_token(const psa_msg_t *msg)
@@ -96,6 +190,57 @@ static psa_status_t psa_attest_get_token(const psa_msg_t *msg)
 
     return status;
 }
+
+static psa_status_t psa_attest_get_tokens(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    uint8_t challenge_buff[PSA_INITIAL_ATTEST_CHALLENGE_SIZE_64];
+    size_t bytes_read;
+    size_t challenge_size;
+    size_t num_challenges;
+    size_t token_offset = 0;
+    size_t token_buff_size;
+    size_t token_size;
+    size_t i;
+
+    status = psa_attest_get_tokens_params(msg, &challenge_size,
+                                          &num_challenges);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* Each token is encoded into the local buffer and written out before the
+     * next one, so the tokens only have to fit one at a time.
+     */
+    for (i = 0; i < num_challenges; i++) {
+        if (token_offset == msg->out_size[0]) {
+            return PSA_ERROR_BUFFER_TOO_SMALL;
+        }
+
+        bytes_read = psa_read(msg->handle, 0, challenge_buff, challenge_size);
+        if (bytes_read != challenge_size) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        token_buff_size = msg->out_size[0] - token_offset;
+        if (token_buff_size > sizeof(token_buff)) {
+            token_buff_size = sizeof(token_buff);
+        }
+
+        status = initial_attest_get_token(challenge_buff, challenge_size,
+                                          token_buff, token_buff_size,
+                                          &token_size);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        psa_write(msg->handle, 0, token_buff, token_size);
+        psa_write(msg->handle, 1, &token_size, sizeof(token_size));
+        token_offset += token_size;
+    }
+
+    return PSA_SUCCESS;
+}
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC == 1 */
 
 static psa_status_t psa_attest_get_token_size(const psa_msg_t *msg)
@@ -127,6 +272,22 @@ static psa_status_t psa_attest_get_token_size(const psa_msg_t *msg)
     return status;
 }
 
+#if ATTEST_TOKEN_STATS
+static psa_status_t psa_attest_get_token_stats(const psa_msg_t *msg)
+{
+    struct tfm_attest_token_stats_t stats;
+
+    if (msg->out_size[0] != sizeof(stats)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    attest_get_token_stats(&stats);
+    psa_write(msg->handle, 0, &stats, sizeof(stats));
+
+    return PSA_SUCCESS;
+}
+#endif /* ATTEST_TOKEN_STATS */
+
 psa_status_t tfm_attestation_service_sfn(const psa_msg_t *msg)
 {
     switch (msg->type) {
@@ -134,6 +295,12 @@ psa_status_t tfm_attestation_service_sfn(const psa_msg_t *msg)
         return psa_attest_get_token(msg);
     case TFM_ATTEST_GET_TOKEN_SIZE:
         return psa_attest_get_token_size(msg);
+    case TFM_ATTEST_GET_TOKENS:
+        return psa_attest_get_tokens(msg);
+#if ATTEST_TOKEN_STATS
+    case TFM_ATTEST_GET_TOKEN_STATS:
+        return psa_attest_get_token_stats(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -22,6 +22,9 @@ uint8_t its_block_data[ITS_RAM_FS_SIZE];
 #endif
 static uint8_t its_write_buf_0[ITS_FLASH_NAND_BUF_SIZE];
 static uint8_t its_write_buf_1[ITS_FLASH_NAND_BUF_SIZE];
+#if defined(ITS_FLASH_NAND_READ_BUF_SIZE) && (ITS_FLASH_NAND_READ_BUF_SIZE > 0)
+static uint8_t its_read_buf[ITS_FLASH_NAND_READ_BUF_SIZE];
+#endif
 struct its_flash_nand_dev_t its_flash_nand_dev = {
     .driver = &TFM_HAL_ITS_FLASH_DRIVER,
     .buf_block_id_0 = ITS_BLOCK_INVALID_ID,
@@ -29,6 +32,11 @@ struct its_flash_nand_dev_t its_flash_nand_dev = {
     .write_buf_0 = its_write_buf_0,
     .write_buf_1 = its_write_buf_1,
     .buf_size = sizeof(its_write_buf_0),
+#if defined(ITS_FLASH_NAND_READ_BUF_SIZE) && (ITS_FLASH_NAND_READ_BUF_SIZE > 0)
+    .read_buf = its_read_buf,
+    .read_buf_size = sizeof(its_read_buf),
+#endif
+    .read_buf_addr = ITS_FLASH_NAND_INVALID_ADDR,
 };
 #endif
 
@@ -45,6 +53,9 @@ uint8_t ps_block_data[PS_RAM_FS_SIZE];
 #endif
 static uint8_t ps_write_buf_0[PS_FLASH_NAND_BUF_SIZE];
 static uint8_t ps_write_buf_1[PS_FLASH_NAND_BUF_SIZE];
+#if defined(PS_FLASH_NAND_READ_BUF_SIZE) && (PS_FLASH_NAND_READ_BUF_SIZE > 0)
+static uint8_t ps_read_buf[PS_FLASH_NAND_READ_BUF_SIZE];
+#endif
 struct its_flash_nand_dev_t ps_flash_nand_dev = {
     .driver = &TFM_HAL_PS_FLASH_DRIVER,
     .buf_block_id_0 = ITS_BLOCK_INVALID_ID,
@@ -52,6 +63,11 @@ struct its_flash_nand_dev_t ps_flash_nand_dev = {
     .write_buf_0 = ps_write_buf_0,
     .write_buf_1 = ps_write_buf_1,
     .buf_size = sizeof(ps_write_buf_0),
+#if defined(PS_FLASH_NAND_READ_BUF_SIZE) && (PS_FLASH_NAND_READ_BUF_SIZE > 0)
+    .read_buf = ps_read_buf,
+    .read_buf_size = sizeof(ps_read_buf),
+#endif
+    .read_buf_addr = ITS_FLASH_NAND_INVALID_ADDR,
 };
 #endif
 #endif /* TFM_PARTITION_PROTECTED_STORAGE */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2020-2022 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -18,6 +18,19 @@
 #include "tfm_hal_ps.h"
 #endif
 
+/* The RAM object store keeps the files of ITS and PS in their RAM areas */
+#if ITS_RAM_OBJECT_STORE
+#if ITS_FLASH_FS_LOG
+#error "ITS_RAM_OBJECT_STORE cannot be used with ITS_FLASH_FS_LOG"
+#endif
+#if !ITS_RAM_FS
+#error "ITS_RAM_OBJECT_STORE requires ITS_RAM_FS"
+#endif
+#if defined(TFM_PARTITION_PROTECTED_STORAGE) && !PS_RAM_FS
+#error "ITS_RAM_OBJECT_STORE requires PS_RAM_FS with Protected Storage"
+#endif
+#endif
+
 /* Include the correct flash interface implementation for ITS */
 #if ITS_RAM_FS
 /* RAM FS: use a buffer to emulate storage in RAM */
@@ -31,6 +44,12 @@ extern uint8_t its_block_data[];
 /* NAND flash: each filesystem block is buffered and then programmed in one
  * shot, so no filesystem data alignment is required.
  */
+#if ITS_FLASH_FS_LOG
+#error "ITS_FLASH_FS_LOG requires flash that can be programmed incrementally"
+#endif
+#if ITS_IN_PLACE_APPEND
+#error "ITS_IN_PLACE_APPEND requires flash that can be programmed incrementally"
+#endif
 #include "its_flash_nand.h"
 extern struct its_flash_nand_dev_t its_flash_nand_dev;
 #define ITS_FLASH_DEV its_flash_nand_dev
@@ -61,6 +80,12 @@ extern uint8_t ps_block_data[];
 /* NAND flash: each filesystem block is buffered and then programmed in one
  * shot, so no filesystem data alignment is required.
  */
+#if ITS_FLASH_FS_LOG
+#error "ITS_FLASH_FS_LOG requires flash that can be programmed incrementally"
+#endif
+#if ITS_IN_PLACE_APPEND
+#error "ITS_IN_PLACE_APPEND requires flash that can be programmed incrementally"
+#endif
 #include "its_flash_nand.h"
 extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #define PS_FLASH_DEV ps_flash_nand_dev
@@ -33,16 +33,91 @@ static uint32_t get_phys_address(const struct its_flash_fs_config_t *cfg,
     return cfg->flash_area_addr + (block_id * cfg->block_size) + offset;
 }
 
+/**
+ * \brief Invalidates the read-ahead buffer if it holds data of the given
+ *        block.
+ *
+ * \param[in] cfg       Flash FS configuration
+ * \param[in] block_id  Block ID
+ */
+static void invalidate_read_buf(const struct its_flash_fs_config_t *cfg,
+                                uint32_t block_id)
+{
+    struct its_flash_nand_dev_t *flash_dev =
+        (struct its_flash_nand_dev_t *)cfg->flash_dev;
+    uint32_t block_addr = get_phys_address(cfg, block_id, 0);
+
+    if ((flash_dev->read_buf_addr != ITS_FLASH_NAND_INVALID_ADDR) &&
+        (flash_dev->read_buf_addr >= block_addr) &&
+        (flash_dev->read_buf_addr < block_addr + cfg->block_size)) {
+        flash_dev->read_buf_addr = ITS_FLASH_NAND_INVALID_ADDR;
+    }
+}
+
+/**
+ * \brief Reads data through the read-ahead buffer. The aligned window that
+ *        contains the data is read from flash if it is not buffered yet.
+ *
+ * \param[in]  flash_dev   NAND flash device
+ * \param[in]  addr        Physical address of the data
+ * \param[out] buff        Buffer to store the data
+ * \param[in]  size        Size of the data, which must not cross a window
+ *                         boundary
+ * \param[in]  data_width  Size of a data item of the driver
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t read_ahead(struct its_flash_nand_dev_t *flash_dev,
+                               uint32_t addr, uint8_t *buff, size_t size,
+                               uint8_t data_width)
+{
+    uint32_t window_addr = addr - (addr % flash_dev->read_buf_size);
+    int ret;
+
+    if (flash_dev->read_buf_addr != window_addr) {
+        flash_dev->read_buf_addr = ITS_FLASH_NAND_INVALID_ADDR;
+
+        ret = flash_dev->driver->ReadData(window_addr, flash_dev->read_buf,
+                                          flash_dev->read_buf_size
+                                          / data_width);
+        if (ret < 0) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+
+        flash_dev->read_buf_addr = window_addr;
+    }
+
+    (void)memcpy(buff, flash_dev->read_buf + (addr - window_addr), size);
+
+    return PSA_SUCCESS;
+}
+
 static psa_status_t its_flash_nand_init(const struct its_flash_fs_config_t *cfg)
 {
     int32_t err;
     struct its_flash_nand_dev_t *flash_dev =
         (struct its_flash_nand_dev_t *)cfg->flash_dev;
+    ARM_FLASH_CAPABILITIES DriverCapabilities;
+    uint8_t data_width;
 
     if (flash_dev->buf_size < cfg->block_size) {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
+    /* The read-ahead windows are read with whole data items and must not
+     * cross block boundaries, so that they can be invalidated per block.
+     */
+    if (flash_dev->read_buf_size != 0) {
+        DriverCapabilities = flash_dev->driver->GetCapabilities();
+        data_width = data_width_byte[DriverCapabilities.data_width];
+
+        if (((flash_dev->read_buf_size % data_width) != 0) ||
+            ((cfg->block_size % flash_dev->read_buf_size) != 0) ||
+            ((cfg->flash_area_addr % flash_dev->read_buf_size) != 0)) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+    }
+
     err = flash_dev->driver->Initialize(NULL);
     if (err != ARM_DRIVER_OK) {
         return PSA_ERROR_STORAGE_FAILURE;
@@ -72,6 +147,8 @@ static psa_status_t its_flash_nand_read(const struct its_flash_fs_config_t *cfg,
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
+    its_flash_fs_stats_read(cfg, size);
+
     if (block_id == flash_dev->buf_block_id_0) {
         (void)memcpy(buff, flash_dev->write_buf_0 + offset, size);
     } else if (block_id == flash_dev->buf_block_id_1) {
@@ -82,6 +159,13 @@ static psa_status_t its_flash_nand_read(const struct its_flash_fs_config_t *cfg,
         DriverCapabilities = flash_dev->driver->GetCapabilities();
         data_width = data_width_byte[DriverCapabilities.data_width];
 
+        /* Serve reads that fit in one read-ahead window from the buffer */
+        if ((flash_dev->read_buf_size != 0) &&
+            ((addr % flash_dev->read_buf_size) + size
+             <= flash_dev->read_buf_size)) {
+            return read_ahead(flash_dev, addr, buff, size, data_width);
+        }
+
         /*
          * CMSIS ARM_FLASH_ReadData API requires the `addr` data type size
          * aligned. Data type size is specified by the data_width in
@@ -182,6 +266,10 @@ static psa_status_t its_flash_nand_flush(
 
     DriverCapabilities = flash_dev->driver->GetCapabilities();
     data_width = data_width_byte[DriverCapabilities.data_width];
+
+    /* The programmed data replaces what the read-ahead buffer may hold */
+    invalidate_read_buf(cfg, block_id);
+
     if (block_id == flash_dev->buf_block_id_0) {
         addr = get_phys_address(cfg, flash_dev->buf_block_id_0, 0);
 
@@ -194,6 +282,7 @@ static psa_status_t its_flash_nand_flush(
         if (err < 0) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
+        its_flash_fs_stats_program(cfg, cfg->block_size);
 
         /* Clear the write buffer */
         (void)memset(flash_dev->write_buf_0, 0, flash_dev->buf_size);
@@ -207,6 +296,7 @@ static psa_status_t its_flash_nand_flush(
         if (err < 0) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
+        its_flash_fs_stats_program(cfg, cfg->block_size);
 
         /* Clear the write buffer */
         (void)memset(flash_dev->write_buf_1, 0, flash_dev->buf_size);
@@ -227,6 +317,8 @@ static psa_status_t its_flash_nand_erase(const struct its_flash_fs_config_t *cfg
     struct its_flash_nand_dev_t *flash_dev =
         (struct its_flash_nand_dev_t *)cfg->flash_dev;
 
+    invalidate_read_buf(cfg, block_id);
+
     for (offset = 0; offset < cfg->block_size; offset += cfg->sector_size) {
         addr = get_phys_address(cfg, block_id, offset);
 
@@ -236,13 +328,55 @@ static psa_status_t its_flash_nand_erase(const struct its_flash_fs_config_t *cfg
         }
     }
 
+    its_flash_fs_stats_erase(cfg, block_id);
+
     return PSA_SUCCESS;
 }
 
+#ifdef CONFIG_TFM_SPM_TRACE
+static psa_status_t its_flash_nand_read_traced(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id, uint8_t *buff,
+                                    size_t offset, size_t size)
+{
+    its_flash_fs_trace_begin(TFM_TRACE_EVT_FLASH_READ, block_id, size);
+
+    return its_flash_fs_trace_end(TFM_TRACE_EVT_FLASH_READ,
+                                  its_flash_nand_read(cfg, block_id, buff,
+                                                      offset, size));
+}
+
+/* The writes are buffered, the flash is programmed by the flush. */
+static psa_status_t its_flash_nand_flush_traced(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id)
+{
+    its_flash_fs_trace_begin(TFM_TRACE_EVT_FLASH_PROGRAM, block_id,
+                             cfg->block_size);
+
+    return its_flash_fs_trace_end(TFM_TRACE_EVT_FLASH_PROGRAM,
+                                  its_flash_nand_flush(cfg, block_id));
+}
+
+static psa_status_t its_flash_nand_erase_traced(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id)
+{
+    its_flash_fs_trace_begin(TFM_TRACE_EVT_FLASH_ERASE, block_id, 0);
+
+    return its_flash_fs_trace_end(TFM_TRACE_EVT_FLASH_ERASE,
+                                  its_flash_nand_erase(cfg, block_id));
+}
+
+#define NAND_OP(op)     its_flash_nand_##op##_traced
+#else
+#define NAND_OP(op)     its_flash_nand_##op
+#endif /* CONFIG_TFM_SPM_TRACE */
+
 const struct its_flash_fs_ops_t its_flash_fs_ops_nand = {
     .init = its_flash_nand_init,
-    .read = its_flash_nand_read,
+    .read = NAND_OP(read),
     .write = its_flash_nand_write,
-    .flush = its_flash_nand_flush,
-    .erase = its_flash_nand_erase,
+    .flush = NAND_OP(flush),
+    .erase = NAND_OP(erase),
 };
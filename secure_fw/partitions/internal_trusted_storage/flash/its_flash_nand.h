@@ -24,6 +24,9 @@
 extern "C" {
 #endif
 
+/* Value of read_buf_addr when the read-ahead buffer holds no data */
+#define ITS_FLASH_NAND_INVALID_ADDR 0xFFFFFFFFU
+
 struct its_flash_nand_dev_t {
     ARM_DRIVER_FLASH *driver;
     /* Two write buffers are reserved as the metadata block and the file block
@@ -34,6 +37,13 @@ struct its_flash_nand_dev_t {
     uint8_t *write_buf_0;
     uint8_t *write_buf_1;
     size_t buf_size;
+    /* Optional read-ahead buffer, which holds an aligned window of the flash
+     * so that consecutive small reads of the filesystem are served with a
+     * single driver access. It is disabled when read_buf_size is 0.
+     */
+    uint8_t *read_buf;
+    size_t read_buf_size;
+    uint32_t read_buf_addr;
 };
 
 extern const struct its_flash_fs_ops_t its_flash_fs_ops_nand;
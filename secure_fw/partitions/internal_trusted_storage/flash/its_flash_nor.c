@@ -5,11 +5,16 @@
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
+#include <stdbool.h>
 #include <string.h>
 #include "its_flash_nor.h"
 
+#include "config_tfm.h"
 #include "flash_fs/its_flash_fs.h"
 #include "driver/Driver_Flash.h"
+#if ITS_FLASH_NOR_ASYNC
+#include "cmsis_compiler.h"
+#endif
 
 /* Valid entries for data item width */
 static const uint32_t data_width_byte[] = {
@@ -33,11 +38,63 @@ static uint32_t get_phys_address(const struct its_flash_fs_config_t *cfg,
     return cfg->flash_area_addr + (block_id * cfg->block_size) + offset;
 }
 
+#if ITS_FLASH_NOR_ASYNC
+/* Set by the driver event callback when an operation has failed */
+static volatile bool async_error;
+
+/**
+ * \brief Flash driver event callback, called when an operation started by
+ *        a driver with asynchronous operations has completed.
+ *
+ * \param[in] event  Flash driver events
+ */
+static void its_flash_nor_signal_event(uint32_t event)
+{
+    if (event & ARM_FLASH_EVENT_ERROR) {
+        async_error = true;
+    }
+}
+
+/**
+ * \brief Waits for the completion of the operation in progress, if any.
+ *
+ * \details The CPU is put to sleep until an event, such as the completion
+ *          interrupt of the flash, occurs. A synchronous driver is never busy
+ *          when it returns, so there is nothing to wait for.
+ *
+ * \param[in] cfg  Flash FS configuration
+ *
+ * \return Returns PSA_ERROR_STORAGE_FAILURE if the operation has failed, and
+ *         PSA_SUCCESS otherwise.
+ */
+static psa_status_t wait_ready(const struct its_flash_fs_config_t *cfg)
+{
+    ARM_FLASH_STATUS status;
+
+    while ((status =
+            ((ARM_DRIVER_FLASH *)cfg->flash_dev)->GetStatus()).busy) {
+        __WFE();
+    }
+
+    if (async_error || status.error) {
+        async_error = false;
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_FLASH_NOR_ASYNC */
+
 static psa_status_t its_flash_nor_init(const struct its_flash_fs_config_t *cfg)
 {
     int32_t err;
 
+#if ITS_FLASH_NOR_ASYNC
+    err = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->Initialize(
+                                                 its_flash_nor_signal_event);
+#else
     err = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->Initialize(NULL);
+#endif
     if (err != ARM_DRIVER_OK) {
         return PSA_ERROR_STORAGE_FAILURE;
     }
@@ -45,6 +102,41 @@ static psa_status_t its_flash_nor_init(const struct its_flash_fs_config_t *cfg)
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Reads data items from the flash. With asynchronous operations, it
+ *        waits for any operation in progress before the read, and for the read
+ *        itself to complete.
+ *
+ * \param[in]  cfg   Flash FS configuration
+ * \param[in]  addr  Physical address, aligned to the data width
+ * \param[out] buff  Buffer to store the data
+ * \param[in]  cnt   Number of data items to read
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t read_data(const struct its_flash_fs_config_t *cfg,
+                              uint32_t addr, void *buff, uint32_t cnt)
+{
+    int ret;
+
+#if ITS_FLASH_NOR_ASYNC
+    if (wait_ready(cfg) != PSA_SUCCESS) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+#endif
+
+    ret = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->ReadData(addr, buff, cnt);
+    if (ret < 0) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+#if ITS_FLASH_NOR_ASYNC
+    return wait_ready(cfg);
+#else
+    return PSA_SUCCESS;
+#endif
+}
+
 static psa_status_t flash_read_unaligned(
                                     const struct its_flash_fs_config_t *cfg,
                                     uint32_t addr, uint8_t *buff, size_t size)
@@ -57,7 +149,7 @@ static psa_status_t flash_read_unaligned(
     uint8_t temp_buffer[sizeof(uint32_t)];
     ARM_FLASH_CAPABILITIES DriverCapabilities;
     uint8_t data_width;
-    int ret;
+    psa_status_t ret;
 
     DriverCapabilities =
                     ((ARM_DRIVER_FLASH *)cfg->flash_dev)->GetCapabilities();
@@ -73,10 +165,9 @@ static psa_status_t flash_read_unaligned(
 
     /* Read the first data_width bytes data if `addr` is not aligned. */
     if (aligned_addr != addr) {
-        ret = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->ReadData(aligned_addr,
-                                                             temp_buffer, 1);
-        if (ret < 0) {
-            return PSA_ERROR_STORAGE_FAILURE;
+        ret = read_data(cfg, aligned_addr, temp_buffer, 1);
+        if (ret != PSA_SUCCESS) {
+            return ret;
         }
 
         /* Record how many target data have been read. */
@@ -95,12 +186,10 @@ static psa_status_t flash_read_unaligned(
     if (remaining_len) {
         item_number = remaining_len / data_width;
         if (item_number) {
-            ret = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->ReadData(
-                                                addr + read_length,
-                                                (uint8_t *)buff + read_length,
-                                                item_number);
-            if (ret < 0) {
-                return PSA_ERROR_STORAGE_FAILURE;
+            ret = read_data(cfg, addr + read_length,
+                            (uint8_t *)buff + read_length, item_number);
+            if (ret != PSA_SUCCESS) {
+                return ret;
             }
             read_length += item_number * data_width;
             remaining_len -= item_number * data_width;
@@ -109,11 +198,9 @@ static psa_status_t flash_read_unaligned(
 
     /* Read the last data item if there is still remaing data. */
     if (remaining_len) {
-        ret = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->ReadData(
-                                                            addr + read_length,
-                                                            temp_buffer, 1);
-        if (ret < 0) {
-            return PSA_ERROR_STORAGE_FAILURE;
+        ret = read_data(cfg, addr + read_length, temp_buffer, 1);
+        if (ret != PSA_SUCCESS) {
+            return ret;
         }
         /* Copy the read data. */
         memcpy(buff + read_length, temp_buffer, remaining_len);
@@ -131,6 +218,7 @@ static psa_status_t its_flash_nor_read(const struct its_flash_fs_config_t *cfg,
         return PSA_SUCCESS;
     }
     addr = get_phys_address(cfg, block_id, offset);
+    its_flash_fs_stats_read(cfg, size);
     return flash_read_unaligned(cfg, addr, buff, size);
 }
 
@@ -149,13 +237,26 @@ static psa_status_t its_flash_nor_write(const struct its_flash_fs_config_t *cfg,
 
     addr = get_phys_address(cfg, block_id, offset);
 
+#if ITS_FLASH_NOR_ASYNC
+    /* Let a previously started erase complete */
+    if (wait_ready(cfg) != PSA_SUCCESS) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+#endif
+
     err = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->ProgramData(addr, buff,
                                                         size / data_width);
     if (err < 0) {
         return PSA_ERROR_STORAGE_FAILURE;
     }
+    its_flash_fs_stats_program(cfg, size);
 
+#if ITS_FLASH_NOR_ASYNC
+    /* The data buffer must stay valid until the program has completed */
+    return wait_ready(cfg);
+#else
     return PSA_SUCCESS;
+#endif
 }
 
 static psa_status_t its_flash_nor_flush(const struct its_flash_fs_config_t *cfg,
@@ -179,19 +280,71 @@ static psa_status_t its_flash_nor_erase(const struct its_flash_fs_config_t *cfg,
     for (offset = 0; offset < cfg->block_size; offset += cfg->sector_size) {
         addr = get_phys_address(cfg, block_id, offset);
 
+#if ITS_FLASH_NOR_ASYNC
+        /* Only the erase of the last sector is left running on return. The
+         * next flash operation waits for it, so the erase overlaps with the
+         * work done in between, including the return to the client.
+         */
+        if (wait_ready(cfg) != PSA_SUCCESS) {
+            return PSA_ERROR_STORAGE_FAILURE;
+        }
+#endif
+
         err = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->EraseSector(addr);
         if (err != ARM_DRIVER_OK) {
             return PSA_ERROR_STORAGE_FAILURE;
         }
     }
 
+    its_flash_fs_stats_erase(cfg, block_id);
+
     return PSA_SUCCESS;
 }
 
+#ifdef CONFIG_TFM_SPM_TRACE
+static psa_status_t its_flash_nor_read_traced(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id, uint8_t *buff,
+                                    size_t offset, size_t size)
+{
+    its_flash_fs_trace_begin(TFM_TRACE_EVT_FLASH_READ, block_id, size);
+
+    return its_flash_fs_trace_end(TFM_TRACE_EVT_FLASH_READ,
+                                  its_flash_nor_read(cfg, block_id, buff,
+                                                     offset, size));
+}
+
+static psa_status_t its_flash_nor_write_traced(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id, const uint8_t *buff,
+                                    size_t offset, size_t size)
+{
+    its_flash_fs_trace_begin(TFM_TRACE_EVT_FLASH_PROGRAM, block_id, size);
+
+    return its_flash_fs_trace_end(TFM_TRACE_EVT_FLASH_PROGRAM,
+                                  its_flash_nor_write(cfg, block_id, buff,
+                                                      offset, size));
+}
+
+static psa_status_t its_flash_nor_erase_traced(
+                                    const struct its_flash_fs_config_t *cfg,
+                                    uint32_t block_id)
+{
+    its_flash_fs_trace_begin(TFM_TRACE_EVT_FLASH_ERASE, block_id, 0);
+
+    return its_flash_fs_trace_end(TFM_TRACE_EVT_FLASH_ERASE,
+                                  its_flash_nor_erase(cfg, block_id));
+}
+
+#define NOR_OP(op)      its_flash_nor_##op##_traced
+#else
+#define NOR_OP(op)      its_flash_nor_##op
+#endif /* CONFIG_TFM_SPM_TRACE */
+
 const struct its_flash_fs_ops_t its_flash_fs_ops_nor = {
     .init = its_flash_nor_init,
-    .read = its_flash_nor_read,
-    .write = its_flash_nor_write,
+    .read = NOR_OP(read),
+    .write = NOR_OP(write),
     .flush = its_flash_nor_flush,
-    .erase = its_flash_nor_erase,
+    .erase = NOR_OP(erase),
 };
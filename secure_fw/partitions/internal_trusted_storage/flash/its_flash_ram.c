@@ -38,6 +38,7 @@ static psa_status_t its_flash_ram_read(const struct its_flash_fs_config_t *cfg,
     uint32_t idx = get_phys_address(cfg, block_id, offset);
 
     (void)memcpy(buff, (uint8_t *)cfg->flash_dev + idx, size);
+    its_flash_fs_stats_read(cfg, size);
 
     return PSA_SUCCESS;
 }
@@ -49,6 +50,7 @@ static psa_status_t its_flash_ram_write(const struct its_flash_fs_config_t *cfg,
     uint32_t idx = get_phys_address(cfg, block_id, offset);
 
     (void)memcpy((uint8_t *)cfg->flash_dev + idx, buff, size);
+    its_flash_fs_stats_program(cfg, size);
 
     return PSA_SUCCESS;
 }
@@ -72,6 +74,7 @@ static psa_status_t its_flash_ram_erase(const struct its_flash_fs_config_t *cfg,
 
     (void)memset((uint8_t *)cfg->flash_dev + idx, cfg->erase_val,
                  cfg->block_size);
+    its_flash_fs_stats_erase(cfg, block_id);
 
     return PSA_SUCCESS;
 }
@@ -8,28 +8,48 @@
 
 #include "its_flash_fs.h"
 
+#if !ITS_FLASH_FS_LOG && !ITS_RAM_OBJECT_STORE
+
 #include <stdbool.h>
 #include <string.h>
 
 #include "its_flash_fs_dblock.h"
 #include "its_utils.h"
+#include "psa/storage_common.h"
+#include "tfm_yield.h"
+
+#if (ITS_MAX_FILE_EXTENTS < 1) || \
+    (ITS_MAX_FILE_EXTENTS > ITS_FLASH_FS_MAX_EXTENTS)
+#error "ITS_MAX_FILE_EXTENTS must be between 1 and ITS_FLASH_FS_MAX_EXTENTS"
+#endif
+
+#if ITS_ENCRYPTION && ITS_IN_PLACE_APPEND
+#error "ITS_IN_PLACE_APPEND is not supported with ITS_ENCRYPTION"
+#endif
 
 /* Filesystem-internal flags, which cannot be passed by the caller */
 #define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
-/* Flag that indicates the file is to be deleted in the next block update */
-#define ITS_FLASH_FS_FLAG_DELETE          (1U << 24)
 
 static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
                                             uint32_t del_file_idx);
+static psa_status_t its_flash_fs_compact_step(
+                                             struct its_flash_fs_ctx_t *fs_ctx);
 
 static psa_status_t its_flash_fs_file_write_aligned_data(
                                       struct its_flash_fs_ctx_t *fs_ctx,
                                       const struct its_block_meta_t *block_meta,
-                                      const struct its_file_meta_t *file_meta,
+                                      struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
-                                      const uint8_t *data)
+                                      const uint8_t *data,
+                                      bool *in_place)
 {
+#if ITS_IN_PLACE_APPEND
+    psa_status_t err;
+#endif
+
+    *in_place = false;
+
 #if (ITS_FLASH_MAX_ALIGNMENT != 1)
     /* Check that the offset is aligned with the flash program unit */
     if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
@@ -51,6 +71,17 @@ static psa_status_t its_flash_fs_file_write_aligned_data(
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if ITS_IN_PLACE_APPEND
+    /* Program an append directly into the active data block if possible */
+    err = its_flash_fs_dblock_append_file_in_place(fs_ctx, block_meta,
+                                                   file_meta, offset, size,
+                                                   data);
+    if (err != PSA_ERROR_NOT_SUPPORTED) {
+        *in_place = (err == PSA_SUCCESS);
+        return err;
+    }
+#endif
+
     return its_flash_fs_dblock_write_file(fs_ctx, block_meta, file_meta, offset,
                                           size, data);
 }
@@ -112,6 +143,17 @@ static psa_status_t its_flash_fs_validate_config(
         ret = PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if ITS_MAX_FILE_EXTENTS > 1
+    /* A file can be split into extents across all the data blocks, so the
+     * larger file must fit in the data space of the ITS flash area when it is
+     * empty.
+     */
+    if (cfg->max_file_size >
+                        (its_flash_fs_num_active_dblocks(cfg) * cfg->block_size)
+                        - its_flash_fs_all_metadata_size(cfg)) {
+        ret = PSA_ERROR_INVALID_ARGUMENT;
+    }
+#else
     if (cfg->num_blocks == 2) {
         /* Metadata and data are stored in the same physical block */
         if (cfg->max_file_size >
@@ -128,220 +170,93 @@ static psa_status_t its_flash_fs_validate_config(
     if (cfg->max_file_size > cfg->block_size) {
         ret = PSA_ERROR_INVALID_ARGUMENT;
     }
+#endif
 
     /* Metadata must fit in a flash block */
     if (its_flash_fs_all_metadata_size(cfg) > cfg->block_size) {
         ret = PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    return ret;
-}
-
-psa_status_t its_flash_fs_init_ctx(its_flash_fs_ctx_t *fs_ctx,
-                                   const struct its_flash_fs_config_t *fs_cfg,
-                                   const struct its_flash_fs_ops_t *fs_ops)
-{
-    psa_status_t err;
-
-    if (!fs_ctx || !fs_cfg || !fs_ops) {
-        return PSA_ERROR_INVALID_ARGUMENT;
-    }
-
-    /* Check for valid filesystem configuration */
-    err = its_flash_fs_validate_config(fs_cfg);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
-
-    /* Zero the context */
-    memset(fs_ctx, 0, sizeof(*fs_ctx));
-
-    /* Associate the filesystem config and operations with the context */
-    fs_ctx->cfg = fs_cfg;
-    fs_ctx->ops = fs_ops;
-
-    return PSA_SUCCESS;
-}
-
-psa_status_t its_flash_fs_prepare(its_flash_fs_ctx_t *fs_ctx)
-{
-    psa_status_t err;
-    uint32_t idx;
-
-    /* Initialize metadata block with the valid/active metablock */
-    err = its_flash_fs_mblock_init(fs_ctx);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
-
-    /* Check if a file marked for deletion has been left behind by a power
-     * failure. If so, delete it.
-     */
-    err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
-                                                ITS_FLASH_FS_FLAG_DELETE, &idx);
-    if (err == PSA_SUCCESS) {
-        return its_flash_fs_delete_idx(fs_ctx, idx);
-    } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
-        return err;
-    }
-
-    return PSA_SUCCESS;
-}
-
-psa_status_t its_flash_fs_wipe_all(struct its_flash_fs_ctx_t *fs_ctx)
-{
-    /* Clean and initialize the metadata block */
-    return its_flash_fs_mblock_reset_metablock(fs_ctx);
-}
-
-psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
-                                        const uint8_t *fid,
-                                        struct its_file_info_t *info)
-{
-    psa_status_t err;
-    uint32_t idx;
-    struct its_file_meta_t tmp_metadata;
-
-    /* Get the meta data index and meta data */
-    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, &tmp_metadata);
-    if (err != PSA_SUCCESS) {
-        return PSA_ERROR_DOES_NOT_EXIST;
+    /* File indexes must be distinguishable from an empty file index slot */
+    if ((cfg->file_index != NULL) &&
+        (cfg->max_num_files >= ITS_FILE_INDEX_EMPTY_SLOT)) {
+        ret = PSA_ERROR_INVALID_ARGUMENT;
     }
-    info->size_max = tmp_metadata.max_size;
-    info->size_current = tmp_metadata.cur_size;
-    info->flags = tmp_metadata.flags & ITS_FLASH_FS_USER_FLAGS_MASK;
 
-    return PSA_SUCCESS;
+    return ret;
 }
 
-psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
-                                     const uint8_t *fid,
-                                     uint32_t flags,
-                                     size_t max_size,
-                                     size_t data_size,
-                                     size_t offset,
-                                     const uint8_t *data)
+/**
+ * \brief Writes the file data, if any, and commits the file metadata.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     new_idx     Index of the file metadata to write
+ * \param[in]     old_idx     Index of the file metadata already put in the
+ *                            scratch metadata block, or
+ *                            \ref ITS_METADATA_INVALID_INDEX
+ * \param[in,out] file_meta   File metadata
+ * \param[in,out] block_meta  Metadata of the block that holds the file
+ * \param[in]     offset      Offset in the file
+ * \param[in]     data_size   Size of the incoming data
+ * \param[in]     data        Pointer to the incoming data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_file_write_commit(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         uint32_t new_idx,
+                                         uint32_t old_idx,
+                                         struct its_file_meta_t *file_meta,
+                                         struct its_block_meta_t *block_meta,
+                                         size_t offset,
+                                         size_t data_size,
+                                         const uint8_t *data)
 {
-    struct its_block_meta_t block_meta;
-    struct its_file_meta_t file_meta = {0};
     uint32_t cur_phys_block;
     psa_status_t err;
     uint32_t idx;
-    uint32_t old_idx = ITS_METADATA_INVALID_INDEX;
-    uint32_t new_idx = ITS_METADATA_INVALID_INDEX;
-    bool use_spare;
-
-    /* Do not permit the user to pass filesystem-internal flags */
-    if (flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
-        return PSA_ERROR_INVALID_ARGUMENT;
-    }
-
-#if (ITS_FLASH_MAX_ALIGNMENT != 1)
-    /* Set the max_size to be aligned with the flash program unit */
-    max_size = ITS_UTILS_ALIGN(max_size, fs_ctx->cfg->program_unit);
-#endif
-
-    /* Check if the file already exists */
-    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &old_idx, &file_meta);
-    if (err == PSA_SUCCESS) {
-        if (flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
-            if (file_meta.max_size == max_size) {
-                /* Truncate and reuse the existing file, which is already the
-                 * correct size.
-                 */
-                file_meta.cur_size = 0;
-                file_meta.flags = flags;
-                new_idx = old_idx;
-            } else {
-                /* Mark the existing file to be deleted in this block update. It
-                 * will be deleted in a second block update, and if there is a
-                 * power failure before that block update completes, then
-                 * deletion will be re-attempted based on this flag.
-                 */
-                file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
-                err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx,
-                                                                   old_idx,
-                                                                   &file_meta);
-                if (err != PSA_SUCCESS) {
-                    return PSA_ERROR_GENERIC_ERROR;
-                }
-            }
-        } else {
-            /* Write to existing file */
-            new_idx = old_idx;
-        }
-    } else if (err == PSA_ERROR_DOES_NOT_EXIST) {
-        /* The create flag must be supplied to create a new file */
-        if (!(flags & ITS_FLASH_FS_FLAG_CREATE)) {
-            return PSA_ERROR_DOES_NOT_EXIST;
-        }
-    } else {
-        return err;
-    }
-
-    /* If the existing file was not reused, then a new one must be reserved */
-    if (new_idx == ITS_METADATA_INVALID_INDEX) {
-        /* Check that the file's maximum size is valid */
-        if (max_size > fs_ctx->cfg->max_file_size) {
-            return PSA_ERROR_INVALID_ARGUMENT;
-        }
-
-        /* Only use the spare file if there is an old file to be deleted */
-        use_spare = (old_idx != ITS_METADATA_INVALID_INDEX);
-
-        /* Try to reserve a new file based on the input parameters */
-        err = its_flash_fs_mblock_reserve_file(fs_ctx, fid, use_spare,
-                                               max_size, flags, &new_idx,
-                                               &file_meta, &block_meta);
-        if (err != PSA_SUCCESS) {
-            return err;
-        }
-    } else {
-        /* Read existing block metadata */
-        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, file_meta.lblock,
-                                                      &block_meta);
-        if (err != PSA_SUCCESS) {
-            return PSA_ERROR_GENERIC_ERROR;
-        }
-    }
+    bool in_place;
 
     if (data_size != 0) {
-        /* Write the content into scratch data block */
-        err = its_flash_fs_file_write_aligned_data(fs_ctx, &block_meta,
-                                                   &file_meta, offset,
-                                                   data_size, data);
+        /* Write the content into scratch data block, or in place */
+        err = its_flash_fs_file_write_aligned_data(fs_ctx, block_meta,
+                                                   file_meta, offset,
+                                                   data_size, data, &in_place);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
 
         /* Update the file's current size if required */
-        if (offset + data_size > file_meta.cur_size) {
+        if (offset + data_size > file_meta->cur_size) {
             /* Update the file metadata */
-            file_meta.cur_size = offset + data_size;
+            file_meta->cur_size = offset + data_size;
         }
 
-        cur_phys_block = block_meta.phy_id;
+        if (!in_place) {
+            cur_phys_block = block_meta->phy_id;
 
-        /* Cur scratch block become the active datablock */
-        block_meta.phy_id =
-            its_flash_fs_mblock_cur_data_scratch_id(fs_ctx, file_meta.lblock);
+            /* Cur scratch block become the active datablock */
+            block_meta->phy_id =
+                its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
+                                                        file_meta->lblock);
 
-        /* Swap the scratch data block */
-        its_flash_fs_mblock_set_data_scratch(fs_ctx, cur_phys_block,
-                                             file_meta.lblock);
+            /* Swap the scratch data block */
+            its_flash_fs_mblock_set_data_scratch(fs_ctx, cur_phys_block,
+                                                 file_meta->lblock);
+        }
     }
 
     /* Update block metadata in scratch metadata block */
     err = its_flash_fs_mblock_update_scratch_block_meta(fs_ctx,
-                                                        file_meta.lblock,
-                                                        &block_meta);
+                                                        file_meta->lblock,
+                                                        block_meta);
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
     }
 
     /* Write file metadata in the scratch metadata block */
     err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, new_idx,
-                                                       &file_meta);
+                                                       file_meta);
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
     }
@@ -381,7 +296,7 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
      * located in the logical block 0, that copy has been done while processing
      * the file data.
      */
-    if ((file_meta.lblock != ITS_LOGICAL_DBLOCK0) || (data_size == 0)) {
+    if ((file_meta->lblock != ITS_LOGICAL_DBLOCK0) || (data_size == 0)) {
         err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
@@ -389,82 +304,1023 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     }
 
     /* Write metadata header, swap metadata blocks and erase scratch blocks */
-    err = its_flash_fs_mblock_meta_update_finalize(fs_ctx);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
 
-    /* Delete the old file in a second block update.
-     * Note: A power failure after this point, but before the deletion has
-     * completed, will leave the old file in the filesystem, so it is always
-     * necessary to check for files to be deleted at initialisation time.
-     */
-    if (old_idx != ITS_METADATA_INVALID_INDEX && old_idx != new_idx) {
-        err = its_flash_fs_delete_idx(fs_ctx, old_idx);
+#if ITS_MAX_FILE_EXTENTS > 1
+/**
+ * \struct its_flash_fs_extents_t
+ *
+ * \brief Structure to store the attributes of a file made of extents.
+ */
+struct its_flash_fs_extents_t {
+    uint32_t num;     /*!< Number of extents, zero if the file does not exist */
+    size_t cur_size;  /*!< Current size of the file data */
+    size_t max_size;  /*!< Maximum size of the file */
+    uint32_t flags;   /*!< Flags of the first extent */
+};
+
+/**
+ * \brief Gets the largest file that fits in a single extent.
+ *
+ * \param[in] cfg  Filesystem config
+ *
+ * \return Returns the maximum size of a single extent
+ */
+static size_t its_flash_fs_max_extent_size(
+                                        const struct its_flash_fs_config_t *cfg)
+{
+    if (cfg->num_blocks == 2) {
+        /* Metadata and data are stored in the same physical block */
+        return cfg->block_size - its_flash_fs_all_metadata_size(cfg);
     }
 
-    return err;
+    return cfg->block_size;
 }
 
-static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
-                                            uint32_t del_file_idx)
+/**
+ * \brief Gets the number of extents and the sizes of a file.
+ *
+ * \param[in,out] fs_ctx   Filesystem context
+ * \param[in]     fid      ID of the file
+ * \param[out]    extents  Attributes of the file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_get_extents(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         const uint8_t *fid,
+                                         struct its_flash_fs_extents_t *extents)
 {
-    size_t del_file_data_idx;
-    uint32_t del_file_lblock;
-    size_t del_file_max_size;
     psa_status_t err;
-    size_t src_offset = fs_ctx->cfg->block_size;
-    size_t nbr_bytes_to_move = 0;
     uint32_t idx;
     struct its_file_meta_t file_meta;
-    struct its_block_meta_t block_meta;
-
-    err = its_flash_fs_mblock_read_file_meta(fs_ctx, del_file_idx, &file_meta);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
-
-    if (its_utils_validate_fid(file_meta.id) != PSA_SUCCESS) {
-        return PSA_ERROR_DOES_NOT_EXIST;
-    }
 
-    /* Save logical block, data_index and max_size to be used later on */
-    del_file_lblock = file_meta.lblock;
-    del_file_data_idx = file_meta.data_idx;
-    del_file_max_size = file_meta.max_size;
-
-    /* Remove file metadata */
-    file_meta = (struct its_file_meta_t){0};
-
-    /* Update file metadata in to the scratch block */
-    err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, del_file_idx,
-                                                       &file_meta);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
+    *extents = (struct its_flash_fs_extents_t){0};
 
-    /* Read all file metadata */
-    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
-        if (idx == del_file_idx) {
-            /* Skip deleted file */
-            continue;
+    do {
+        if (extents->num == ITS_MAX_FILE_EXTENTS) {
+            return PSA_ERROR_DATA_CORRUPT;
         }
 
-        /* Read file meta for the given file index */
-        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
-        if (err != PSA_SUCCESS) {
+        err = its_flash_fs_mblock_get_file_extent_idx_meta(fs_ctx, fid,
+                                                           extents->num, &idx,
+                                                           &file_meta);
+        if (err == PSA_ERROR_DOES_NOT_EXIST && extents->num != 0) {
+            /* The extents of a file are always reserved together */
+            return PSA_ERROR_DATA_CORRUPT;
+        } else if (err != PSA_SUCCESS) {
             return err;
         }
 
-        /* Check if the file is located in the same logical block and has a
-         * valid FID.
-         */
-        if ((file_meta.lblock == del_file_lblock) &&
-            (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS)) {
-            /* If a file is located after the data to delete, this
-             * needs to be moved.
-             */
-            if (file_meta.data_idx > del_file_data_idx) {
+        if (extents->num == 0) {
+            extents->flags = file_meta.flags;
+        }
+
+        extents->cur_size += file_meta.cur_size;
+        extents->max_size += file_meta.max_size;
+        extents->num++;
+    } while (file_meta.flags & ITS_FLASH_FS_FLAG_EXTENT_NEXT);
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Gets the location of the next extent of a new file.
+ *
+ * \details The extents are placed in the logical blocks with free space, in
+ *          logical block order, at most one extent per block. The first
+ *          block that can hold all the remaining size is preferred, so that a
+ *          file is only split when no single block can hold it.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in,out] lblock     Logical block to start the search from. It is
+ *                           set to the block after the extent.
+ * \param[in,out] remaining  Size of the file that is not placed yet
+ * \param[out]    file_meta  File metadata, in which the location and the
+ *                           size of the extent are set
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_next_extent(struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t *lblock,
+                                             size_t *remaining,
+                                             struct its_file_meta_t *file_meta)
+{
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t found = ITS_BLOCK_INVALID_ID;
+    size_t found_free_size = 0;
+    struct its_block_meta_t block_meta;
+
+    for (idx = *lblock; idx < its_flash_fs_num_active_dblocks(fs_ctx->cfg);
+         idx++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, idx,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (block_meta.free_size >= *remaining) {
+            /* The rest of the file fits in this block */
+            found = idx;
+            found_free_size = block_meta.free_size;
+            break;
+        }
+
+        if ((found == ITS_BLOCK_INVALID_ID) && (block_meta.free_size != 0)) {
+            found = idx;
+            found_free_size = block_meta.free_size;
+        }
+    }
+
+    if (found == ITS_BLOCK_INVALID_ID) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    file_meta->lblock = found;
+    file_meta->data_idx = fs_ctx->cfg->block_size - found_free_size;
+    file_meta->max_size = ITS_UTILS_MIN(*remaining, found_free_size);
+    *remaining -= file_meta->max_size;
+    *lblock = found + 1;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Checks that a new file with the given size can be reserved, and
+ *        gets its number of extents.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     size         Maximum size of the new file
+ * \param[in]     use_spare    If true then the spare file index can be used
+ * \param[out]    num_extents  Number of extents of the new file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_plan_extents(struct its_flash_fs_ctx_t *fs_ctx,
+                                              size_t size,
+                                              bool use_spare,
+                                              uint32_t *num_extents)
+{
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t lblock = 0;
+    uint32_t num_free = 0;
+    struct its_file_meta_t file_meta;
+
+    *num_extents = 0;
+    do {
+        err = its_flash_fs_next_extent(fs_ctx, &lblock, &size, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        (*num_extents)++;
+    } while (size > 0);
+
+    if (*num_extents > ITS_MAX_FILE_EXTENTS) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    /* Each extent needs a free file index, and the spare one is only used if
+     * there is an old file to be deleted.
+     */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (its_utils_validate_fid(file_meta.id) != PSA_SUCCESS) {
+            num_free++;
+        }
+    }
+
+    if (num_free < *num_extents + (use_spare ? 0 : 1)) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Reserves the extents of a new file in a single metadata block update.
+ *
+ * \details The new extents are reserved marked to be deleted, so that they are
+ *          not found by the file ID and a power failure before
+ *          \ref its_flash_fs_replace_extents leaves them to be deleted. The
+ *          existing extents of the file are left as they are.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     fid          ID of the file
+ * \param[in]     flags        Flags of the file
+ * \param[in]     size         Maximum size of the new file
+ * \param[in]     num_extents  Number of extents of the new file, as returned
+ *                             by \ref its_flash_fs_plan_extents
+ * \param[in]     use_spare    If true then the spare file index can be used
+ * \param[out]    ext_idx      File metadata indexes of the new extents, in
+ *                             extent order
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_reserve_extents(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid,
+                                              uint32_t flags,
+                                              size_t size,
+                                              uint32_t num_extents,
+                                              bool use_spare,
+                                              uint32_t *ext_idx)
+{
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t lblock;
+    uint32_t ext_lblock = 0;
+    uint32_t extent = 0;
+    size_t remaining = size;
+    bool skip_spare = !use_spare;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    struct its_file_meta_t ext_meta;
+
+    /* Put the metadata of every block, with the space of the new extents
+     * reserved, in the scratch metadata block.
+     */
+    err = its_flash_fs_next_extent(fs_ctx, &ext_lblock, &remaining, &ext_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    for (lblock = 0; lblock < its_flash_fs_num_active_dblocks(fs_ctx->cfg);
+         lblock++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if ((extent < num_extents) && (ext_meta.lblock == lblock)) {
+            block_meta.free_size -= ext_meta.max_size;
+            extent++;
+
+            if (extent < num_extents) {
+                err = its_flash_fs_next_extent(fs_ctx, &ext_lblock, &remaining,
+                                               &ext_meta);
+                if (err != PSA_SUCCESS) {
+                    return err;
+                }
+            }
+        }
+
+        err = its_flash_fs_mblock_write_scratch_block_meta(fs_ctx, lblock,
+                                                           &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Put every file metadata entry in the scratch metadata block, filling
+     * free entries with the new extents, which are placed in the same order
+     * as above.
+     */
+    ext_lblock = 0;
+    remaining = size;
+    extent = 0;
+
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if ((its_utils_validate_fid(file_meta.id) != PSA_SUCCESS) &&
+            (extent < num_extents)) {
+            if (skip_spare) {
+                /* Keep the first free file index as a spare */
+                skip_spare = false;
+            } else {
+                err = its_flash_fs_next_extent(fs_ctx, &ext_lblock, &remaining,
+                                               &file_meta);
+                if (err != PSA_SUCCESS) {
+                    return err;
+                }
+
+                memcpy(file_meta.id, fid, ITS_FILE_ID_SIZE);
+                file_meta.cur_size = 0;
+                file_meta.flags = flags | ITS_FLASH_FS_FLAG_DELETE |
+                                  (extent << ITS_FLASH_FS_EXTENT_POS);
+                if (extent + 1 < num_extents) {
+                    file_meta.flags |= ITS_FLASH_FS_FLAG_EXTENT_NEXT;
+                }
+                ext_idx[extent] = idx;
+                extent++;
+            }
+        }
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Copy the file data in the logical block 0 to the scratch block */
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Write metadata header, swap metadata blocks and erase scratch blocks */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+/**
+ * \brief Replaces the extents of a file by the new extents in a single
+ *        metadata block update.
+ *
+ * \details The existing extents of the file are marked to be deleted and the
+ *          new ones, reserved by \ref its_flash_fs_reserve_extents, are
+ *          unmarked. A power failure leaves either the old or the new file.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     fid          ID of the file
+ * \param[in]     ext_idx      File metadata indexes of the new extents
+ * \param[in]     num_extents  Number of new extents, or zero to only mark the
+ *                             existing extents to be deleted
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_replace_extents(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid,
+                                              const uint32_t *ext_idx,
+                                              uint32_t num_extents)
+{
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t lblock;
+    uint32_t extent = 0;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+
+    /* Put the metadata of every block in the scratch metadata block */
+    for (lblock = 0; lblock < its_flash_fs_num_active_dblocks(fs_ctx->cfg);
+         lblock++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = its_flash_fs_mblock_write_scratch_block_meta(fs_ctx, lblock,
+                                                           &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Put every file metadata entry in the scratch metadata block, marking
+     * the existing extents and unmarking the new ones, which are in index
+     * order.
+     */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if ((extent < num_extents) && (ext_idx[extent] == idx)) {
+            file_meta.flags &= ~ITS_FLASH_FS_FLAG_DELETE;
+            extent++;
+        } else if ((its_utils_validate_fid(file_meta.id) == PSA_SUCCESS) &&
+                   !memcmp(file_meta.id, fid, ITS_FILE_ID_SIZE)) {
+            file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+        }
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, idx,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Copy the file data in the logical block 0 to the scratch block */
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Write metadata header, swap metadata blocks and erase scratch blocks */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+/**
+ * \brief Deletes the files marked for deletion.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_delete_marked(struct its_flash_fs_ctx_t *fs_ctx)
+{
+#if ITS_DEFERRED_DELETE
+    /* The files are deleted when their space is needed */
+    (void)fs_ctx;
+
+    return PSA_SUCCESS;
+#else
+    psa_status_t err;
+
+    /* Delete them one by one, each in its own block update.
+     * Note: A power failure before all of them have been deleted leaves the
+     * rest in the filesystem, to be deleted at initialisation time.
+     */
+    do {
+        err = its_flash_fs_compact_step(fs_ctx);
+        /* Each step leaves a consistent filesystem, let others run */
+        tfm_yield();
+    } while (err == PSA_SUCCESS);
+
+    return (err == PSA_ERROR_DOES_NOT_EXIST) ? PSA_SUCCESS : err;
+#endif
+}
+
+/**
+ * \brief Writes data to the extents of a file, with one block update for
+ *        each extent written.
+ *
+ * \param[in,out] fs_ctx   Filesystem context
+ * \param[in]     fid      ID of the file
+ * \param[in]     ext_idx  File metadata indexes of the extents, as reserved
+ *                         by \ref its_flash_fs_reserve_extents, or NULL to
+ *                         write to the extents found by the file ID
+ * \param[in]     offset   Offset in the file
+ * \param[in]     size     Size of the incoming data
+ * \param[in]     data     Pointer to the incoming data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_write_extents(struct its_flash_fs_ctx_t *fs_ctx,
+                                               const uint8_t *fid,
+                                               const uint32_t *ext_idx,
+                                               size_t offset,
+                                               size_t size,
+                                               const uint8_t *data)
+{
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t extent = 0;
+    size_t ext_offset = 0;
+    size_t pos;
+    size_t bytes_to_write;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+
+    while (size > 0) {
+        if (ext_idx != NULL) {
+            idx = ext_idx[extent];
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        } else {
+            err = its_flash_fs_mblock_get_file_extent_idx_meta(fs_ctx, fid,
+                                                               extent, &idx,
+                                                               &file_meta);
+        }
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (offset < ext_offset + file_meta.max_size) {
+            pos = offset - ext_offset;
+            bytes_to_write = ITS_UTILS_MIN(size, file_meta.max_size - pos);
+
+            err = its_flash_fs_mblock_read_block_metadata(fs_ctx,
+                                                          file_meta.lblock,
+                                                          &block_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            err = its_flash_fs_file_write_commit(fs_ctx, idx,
+                                                 ITS_METADATA_INVALID_INDEX,
+                                                 &file_meta, &block_meta, pos,
+                                                 bytes_to_write, data);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            offset += bytes_to_write;
+            size -= bytes_to_write;
+            data += bytes_to_write;
+        }
+
+        ext_offset += file_meta.max_size;
+        extent++;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes a file that is, or will be, made of several extents.
+ *
+ * \details Unlike a file in a single extent, a new file is reserved in a
+ *          block update of its own, next to the existing file, and the data
+ *          is then written with one block update for each extent. The
+ *          existing file is replaced by the new one in a last block update,
+ *          so that a power failure leaves either of them.
+ *
+ *          A write to an existing file, without the truncate flag, is done in
+ *          place, one extent at a time.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        ID of the file
+ * \param[in]     flags      Flags of the write operation
+ * \param[in]     max_size   Maximum size of the file to be created
+ * \param[in]     data_size  Size of the incoming data
+ * \param[in]     offset     Offset in the file
+ * \param[in]     data       Pointer to the incoming data
+ * \param[in]     extents    Attributes of the existing file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_file_write_extents(
+                                 struct its_flash_fs_ctx_t *fs_ctx,
+                                 const uint8_t *fid,
+                                 uint32_t flags,
+                                 size_t max_size,
+                                 size_t data_size,
+                                 size_t offset,
+                                 const uint8_t *data,
+                                 const struct its_flash_fs_extents_t *extents)
+{
+    psa_status_t err;
+    uint32_t num_extents;
+    uint32_t ext_idx[ITS_MAX_FILE_EXTENTS];
+    size_t cur_size = 0;
+    bool use_spare = (extents->num != 0);
+    bool reserve = false;
+
+    if (extents->num == 0) {
+        /* The create flag must be supplied to create a new file */
+        if (!(flags & ITS_FLASH_FS_FLAG_CREATE)) {
+            return PSA_ERROR_DOES_NOT_EXIST;
+        }
+        reserve = true;
+    } else if (flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
+        /* Replace the existing file, even if it is already the correct size,
+         * as truncating it in place would lose its data before the new data
+         * is written.
+         */
+        reserve = true;
+    } else {
+        /* Write to existing file */
+        cur_size = extents->cur_size;
+        max_size = extents->max_size;
+    }
+
+    /* Check that the file's maximum size is valid */
+    if (reserve && (max_size > fs_ctx->cfg->max_file_size)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* It is not permitted to create gaps in the file, and the new data must
+     * be contained within the file's max size.
+     */
+    if ((offset > cur_size) ||
+        (its_utils_check_contained_in(max_size, offset, data_size)
+         != PSA_SUCCESS)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!reserve) {
+        return its_flash_fs_write_extents(fs_ctx, fid, NULL, offset,
+                                          data_size, data);
+    }
+
+    err = its_flash_fs_plan_extents(fs_ctx, max_size, use_spare, &num_extents);
+#if ITS_DEFERRED_DELETE
+    /* Reclaim the space of the files marked for deletion, one at a time,
+     * until the new file fits.
+     */
+    while (err == PSA_ERROR_INSUFFICIENT_STORAGE) {
+        err = its_flash_fs_compact_step(fs_ctx);
+        if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        } else if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        tfm_yield();
+
+        err = its_flash_fs_plan_extents(fs_ctx, max_size, use_spare,
+                                        &num_extents);
+    }
+#endif
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Reserve the new file next to the existing one and write its data */
+    err = its_flash_fs_reserve_extents(fs_ctx, fid, flags, max_size,
+                                       num_extents, use_spare, ext_idx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_flash_fs_write_extents(fs_ctx, fid, ext_idx, offset, data_size,
+                                     data);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Replace the existing file by the new one, then delete the former */
+    err = its_flash_fs_replace_extents(fs_ctx, fid, ext_idx, num_extents);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return use_spare ? its_flash_fs_delete_marked(fs_ctx) : PSA_SUCCESS;
+}
+
+/**
+ * \brief Reads data from the extents of a file.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     fid     ID of the file
+ * \param[in]     size    Size to be read
+ * \param[in]     offset  Offset in the file
+ * \param[out]    data    Buffer pointer to store the data
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_read_extents(struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid,
+                                              size_t size,
+                                              size_t offset,
+                                              uint8_t *data)
+{
+    psa_status_t err;
+    uint32_t idx;
+    uint32_t extent = 0;
+    size_t ext_offset = 0;
+    size_t pos;
+    size_t bytes_to_read;
+    struct its_file_meta_t file_meta;
+
+    while (size > 0) {
+        err = its_flash_fs_mblock_get_file_extent_idx_meta(fs_ctx, fid, extent,
+                                                           &idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (offset < ext_offset + file_meta.max_size) {
+            pos = offset - ext_offset;
+            bytes_to_read = ITS_UTILS_MIN(size, file_meta.max_size - pos);
+
+            err = its_flash_fs_dblock_read_file(fs_ctx, &file_meta, pos,
+                                                bytes_to_read, data);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            offset += bytes_to_read;
+            size -= bytes_to_read;
+            data += bytes_to_read;
+        }
+
+        ext_offset += file_meta.max_size;
+        extent++;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_MAX_FILE_EXTENTS > 1 */
+
+psa_status_t its_flash_fs_init_ctx(its_flash_fs_ctx_t *fs_ctx,
+                                   const struct its_flash_fs_config_t *fs_cfg,
+                                   const struct its_flash_fs_ops_t *fs_ops)
+{
+    psa_status_t err;
+
+    if (!fs_ctx || !fs_cfg || !fs_ops) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Check for valid filesystem configuration */
+    err = its_flash_fs_validate_config(fs_cfg);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Zero the context */
+    memset(fs_ctx, 0, sizeof(*fs_ctx));
+
+    /* Associate the filesystem config and operations with the context */
+    fs_ctx->cfg = fs_cfg;
+    fs_ctx->ops = fs_ops;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_prepare(its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+
+    /* Initialize metadata block with the valid/active metablock */
+    err = its_flash_fs_mblock_init(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if ITS_DEFERRED_DELETE
+    /* Files marked for deletion, including the ones left behind by a power
+     * failure, are deleted when their space is needed.
+     */
+#else
+    /* Check if files marked for deletion have been left behind by a power
+     * failure. If so, delete them. A file made of several extents leaves one
+     * marked file per extent.
+     */
+    do {
+        err = its_flash_fs_compact_step(fs_ctx);
+    } while (err == PSA_SUCCESS);
+
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_wipe_all(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    /* Clean and initialize the metadata block */
+    return its_flash_fs_mblock_reset_metablock(fs_ctx);
+}
+
+psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
+                                        const uint8_t *fid,
+                                        struct its_file_info_t *info)
+{
+    psa_status_t err;
+#if ITS_MAX_FILE_EXTENTS > 1
+    struct its_flash_fs_extents_t extents;
+
+    /* Get the sizes of the file, summed over its extents */
+    err = its_flash_fs_get_extents(fs_ctx, fid, &extents);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+    info->size_max = extents.max_size;
+    info->size_current = extents.cur_size;
+    info->flags = extents.flags & ITS_FLASH_FS_USER_FLAGS_MASK;
+#else
+    uint32_t idx;
+    struct its_file_meta_t tmp_metadata;
+
+    /* Get the meta data index and meta data */
+    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &idx, &tmp_metadata);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+    info->size_max = tmp_metadata.max_size;
+    info->size_current = tmp_metadata.cur_size;
+    info->flags = tmp_metadata.flags & ITS_FLASH_FS_USER_FLAGS_MASK;
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *fid,
+                                     uint32_t flags,
+                                     size_t max_size,
+                                     size_t data_size,
+                                     size_t offset,
+                                     const uint8_t *data)
+{
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta = {0};
+    struct its_file_meta_t old_file_meta;
+    psa_status_t err;
+    uint32_t old_idx = ITS_METADATA_INVALID_INDEX;
+    uint32_t new_idx = ITS_METADATA_INVALID_INDEX;
+    bool use_spare;
+#if ITS_MAX_FILE_EXTENTS > 1
+    struct its_flash_fs_extents_t extents;
+#endif
+
+    /* Do not permit the user to pass filesystem-internal flags */
+    if (flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    /* Set the max_size to be aligned with the flash program unit */
+    max_size = ITS_UTILS_ALIGN(max_size, fs_ctx->cfg->program_unit);
+#endif
+
+#if ITS_MAX_FILE_EXTENTS > 1
+    /* Files that are, or will be, larger than a single extent are handled
+     * separately.
+     */
+    err = its_flash_fs_get_extents(fs_ctx, fid, &extents);
+    if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        if (max_size > its_flash_fs_max_extent_size(fs_ctx->cfg)) {
+            return its_flash_fs_file_write_extents(fs_ctx, fid, flags,
+                                                   max_size, data_size,
+                                                   offset, data, &extents);
+        }
+    } else if (err != PSA_SUCCESS) {
+        return err;
+    } else if ((extents.num > 1) ||
+               ((flags & ITS_FLASH_FS_FLAG_TRUNCATE) &&
+                (max_size > its_flash_fs_max_extent_size(fs_ctx->cfg)))) {
+        return its_flash_fs_file_write_extents(fs_ctx, fid, flags, max_size,
+                                               data_size, offset, data,
+                                               &extents);
+    }
+#endif
+
+    /* Check if the file already exists */
+    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &old_idx, &file_meta);
+    if (err == PSA_SUCCESS) {
+        if (flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
+            if (file_meta.max_size == max_size) {
+                /* Truncate and reuse the existing file, which is already the
+                 * correct size.
+                 */
+                file_meta.cur_size = 0;
+                file_meta.flags = flags;
+                new_idx = old_idx;
+            }
+            /* Otherwise, a new file is reserved and the existing file is
+             * marked to be deleted.
+             */
+        } else {
+            /* Write to existing file */
+            new_idx = old_idx;
+        }
+    } else if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        /* The create flag must be supplied to create a new file */
+        if (!(flags & ITS_FLASH_FS_FLAG_CREATE)) {
+            return PSA_ERROR_DOES_NOT_EXIST;
+        }
+    } else {
+        return err;
+    }
+
+    /* If the existing file was not reused, then a new one must be reserved */
+    if (new_idx == ITS_METADATA_INVALID_INDEX) {
+        /* Check that the file's maximum size is valid */
+        if (max_size > fs_ctx->cfg->max_file_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Only use the spare file if there is an old file to be deleted */
+        use_spare = (old_idx != ITS_METADATA_INVALID_INDEX);
+
+        /* Try to reserve a new file based on the input parameters */
+        err = its_flash_fs_mblock_reserve_file(fs_ctx, fid, use_spare,
+                                               max_size, flags, &new_idx,
+                                               &file_meta, &block_meta);
+#if ITS_DEFERRED_DELETE
+        /* Reclaim the space of the files marked for deletion, one at a time,
+         * until the new file fits. This is done before anything is written
+         * to the scratch blocks, as each deletion is a block update itself.
+         */
+        while (err == PSA_ERROR_INSUFFICIENT_STORAGE) {
+            err = its_flash_fs_compact_step(fs_ctx);
+            if (err == PSA_ERROR_DOES_NOT_EXIST) {
+                return PSA_ERROR_INSUFFICIENT_STORAGE;
+            } else if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            tfm_yield();
+
+            err = its_flash_fs_mblock_reserve_file(fs_ctx, fid, use_spare,
+                                                   max_size, flags, &new_idx,
+                                                   &file_meta, &block_meta);
+        }
+#endif
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (old_idx != ITS_METADATA_INVALID_INDEX) {
+            /* Mark the existing file to be deleted in this block update. It
+             * will be deleted in a second block update, and if there is a
+             * power failure before that block update completes, then
+             * deletion will be re-attempted based on this flag.
+             * Note: The metadata is read again, as a deletion above can have
+             * moved the file data.
+             */
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, old_idx,
+                                                     &old_file_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            old_file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+            err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx,
+                                                               old_idx,
+                                                               &old_file_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+    } else {
+        /* Read existing block metadata */
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, file_meta.lblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Write the data and commit the file and block metadata */
+    err = its_flash_fs_file_write_commit(fs_ctx, new_idx, old_idx, &file_meta,
+                                         &block_meta, offset, data_size, data);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+#if !ITS_DEFERRED_DELETE
+    /* Delete the old file in a second block update.
+     * Note: A power failure after this point, but before the deletion has
+     * completed, will leave the old file in the filesystem, so it is always
+     * necessary to check for files to be deleted at initialisation time.
+     */
+    if (old_idx != ITS_METADATA_INVALID_INDEX && old_idx != new_idx) {
+        err = its_flash_fs_delete_idx(fs_ctx, old_idx);
+    }
+#endif
+
+    return err;
+}
+
+static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t del_file_idx)
+{
+    size_t del_file_data_idx;
+    uint32_t del_file_lblock;
+    size_t del_file_max_size;
+    psa_status_t err;
+    size_t src_offset = fs_ctx->cfg->block_size;
+    size_t nbr_bytes_to_move = 0;
+    uint32_t idx;
+    struct its_file_meta_t file_meta;
+    struct its_block_meta_t block_meta;
+
+    err = its_flash_fs_mblock_read_file_meta(fs_ctx, del_file_idx, &file_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (its_utils_validate_fid(file_meta.id) != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    /* Save logical block, data_index and max_size to be used later on */
+    del_file_lblock = file_meta.lblock;
+    del_file_data_idx = file_meta.data_idx;
+    del_file_max_size = file_meta.max_size;
+
+    /* Remove file metadata */
+    file_meta = (struct its_file_meta_t){0};
+
+    /* Update file metadata in to the scratch block */
+    err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, del_file_idx,
+                                                       &file_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Read all file metadata */
+    for (idx = 0; idx < fs_ctx->cfg->max_num_files; idx++) {
+        if (idx == del_file_idx) {
+            /* Skip deleted file */
+            continue;
+        }
+
+        /* Read file meta for the given file index */
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        /* Check if the file is located in the same logical block and has a
+         * valid FID.
+         */
+        if ((file_meta.lblock == del_file_lblock) &&
+            (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS)) {
+            /* If a file is located after the data to delete, this
+             * needs to be moved.
+             */
+            if (file_meta.data_idx > del_file_data_idx) {
                 /* Check if this is the position after the deleted
                  * data. This will be the first file data to move.
                  */
@@ -531,10 +1387,102 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
         }
     }
 
-    /* Update the metablock header, swap scratch and active blocks,
-     * erase scratch blocks.
-     */
-    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+    /* Update the metablock header, swap scratch and active blocks,
+     * erase scratch blocks.
+     */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+#if ITS_DEFERRED_DELETE
+/**
+ * \brief Marks a file to be deleted in a later block update.
+ *
+ * \details Only the file metadata is changed, so the data block holding the
+ *          file is not compacted. The space used by the file is reclaimed by
+ *          \ref its_flash_fs_compact_step.
+ *
+ * \param[in,out] fs_ctx        Filesystem context
+ * \param[in]     del_file_idx  Index of the file to mark
+ * \param[in]     file_meta     Metadata of the file to mark
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_mark_delete_idx(
+                                         struct its_flash_fs_ctx_t *fs_ctx,
+                                         uint32_t del_file_idx,
+                                         struct its_file_meta_t *file_meta)
+{
+    psa_status_t err;
+    struct its_block_meta_t block_meta;
+
+    /* Copy the block metadata to the scratch metadata block */
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                                  &block_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_flash_fs_mblock_update_scratch_block_meta(fs_ctx,
+                                                        ITS_LOGICAL_DBLOCK0,
+                                                        &block_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Write the marked file metadata and copy the other entries */
+    file_meta->flags |= ITS_FLASH_FS_FLAG_DELETE;
+    err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, del_file_idx,
+                                                       file_meta);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_flash_fs_mblock_cp_file_meta(fs_ctx, 0, del_file_idx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_cp_file_meta(fs_ctx, del_file_idx + 1,
+                                           fs_ctx->cfg->max_num_files);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Copy the file data in the logical block 0 to the scratch block */
+    err = its_flash_fs_mblock_migrate_lb0_data_to_scratch(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Update the metablock header, swap scratch and active blocks,
+     * erase scratch blocks.
+     */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+#endif /* ITS_DEFERRED_DELETE */
+
+/**
+ * \brief Deletes one of the files marked for deletion, compacting the data
+ *        block that holds it.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ * \retval PSA_ERROR_DOES_NOT_EXIST  No file is marked for deletion
+ */
+static psa_status_t its_flash_fs_compact_step(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+    uint32_t idx;
+
+    err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
+                                                ITS_FLASH_FS_FLAG_DELETE, &idx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return its_flash_fs_delete_idx(fs_ctx, idx);
 }
 
 psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
@@ -542,7 +1490,40 @@ psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
 {
     psa_status_t err;
     uint32_t del_file_idx;
+#if ITS_DEFERRED_DELETE
+    struct its_file_meta_t file_meta;
+#endif
+#if ITS_MAX_FILE_EXTENTS > 1
+    struct its_flash_fs_extents_t extents;
+
+    err = its_flash_fs_get_extents(fs_ctx, fid, &extents);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    if (extents.num > 1) {
+        /* Mark all the extents to be deleted in one block update, so that a
+         * power failure cannot leave part of the file, then delete them.
+         */
+        err = its_flash_fs_replace_extents(fs_ctx, fid, NULL, 0);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        return its_flash_fs_delete_marked(fs_ctx);
+    }
+#endif
+#if ITS_DEFERRED_DELETE
+    /* Get the file index and meta data */
+    err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &del_file_idx,
+                                                &file_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
 
+    /* Leave the data in place, it is reclaimed when the space is needed */
+    return its_flash_fs_mark_delete_idx(fs_ctx, del_file_idx, &file_meta);
+#else
     /* Get the file index. */
     err = its_flash_fs_mblock_get_file_idx_meta(fs_ctx, fid, &del_file_idx, NULL);
     if (err != PSA_SUCCESS) {
@@ -550,6 +1531,7 @@ psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
     }
 
     return its_flash_fs_delete_idx(fs_ctx, del_file_idx);
+#endif
 }
 
 psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
@@ -559,6 +1541,24 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
                                     uint8_t *data)
 {
     psa_status_t err;
+#if ITS_MAX_FILE_EXTENTS > 1
+    struct its_flash_fs_extents_t extents;
+
+    /* Get the sizes of the file, summed over its extents */
+    err = its_flash_fs_get_extents(fs_ctx, fid, &extents);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    /* Boundary check the incoming request */
+    err = its_utils_check_contained_in(extents.cur_size, offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Read the file from flash */
+    return its_flash_fs_read_extents(fs_ctx, fid, size, offset, data);
+#else
     uint32_t idx;
     struct its_file_meta_t tmp_metadata;
 
@@ -581,5 +1581,426 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_GENERIC_ERROR;
     }
 
+    return PSA_SUCCESS;
+#endif
+}
+
+
+psa_status_t its_flash_fs_file_count(struct its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *prefix,
+                                     size_t prefix_size,
+                                     uint32_t *num_files)
+{
+    psa_status_t err;
+    uint32_t i;
+    struct its_file_meta_t tmp_metadata;
+    const struct its_file_meta_t *file_meta = &tmp_metadata;
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+
+    *num_files = 0;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        /* The file index holds a RAM copy of the file metadata table, so the
+         * files are counted from it without a copy of each entry.
+         */
+        if ((index != NULL) && index->valid) {
+            file_meta = &index->file_meta[i];
+        } else {
+            err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+
+        /* A file made of extents is counted once, by its first extent. A
+         * file marked for deletion has already been replaced or removed.
+         */
+        if ((its_utils_validate_fid(file_meta->id) == PSA_SUCCESS) &&
+            !(file_meta->flags & ITS_FLASH_FS_FLAG_DELETE) &&
+            (ITS_FLASH_FS_EXTENT_NUM(file_meta->flags) == 0) &&
+            !memcmp(file_meta->id, prefix, prefix_size)) {
+            (*num_files)++;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Gets the size a file of a bulk load takes in its data block.
+ *
+ * \param[in] cfg   Filesystem config
+ * \param[in] file  File of the bulk load
+ *
+ * \return Returns the maximum size of the file
+ */
+static size_t its_flash_fs_bulk_file_size(
+                                     const struct its_flash_fs_config_t *cfg,
+                                     const struct its_flash_fs_bulk_file_t *file)
+{
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    return ITS_UTILS_ALIGN(file->size, cfg->program_unit);
+#else
+    (void)cfg;
+    return file->size;
+#endif
+}
+
+/**
+ * \brief Checks that the files of a bulk load fit in an empty filesystem,
+ *        placed one after the other from the logical block 0.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     files      Files to create
+ * \param[in]     num_files  Number of files to create
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_bulk_plan(
+                                    struct its_flash_fs_ctx_t *fs_ctx,
+                                    const struct its_flash_fs_bulk_file_t *files,
+                                    uint32_t num_files)
+{
+    psa_status_t err;
+    uint32_t i;
+    uint32_t lblock = ITS_LOGICAL_DBLOCK0;
+    size_t size;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+
+    /* The files are only written in place, in free space, if no file holds
+     * data in the filesystem, including the files marked for deletion.
+     */
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (its_utils_validate_fid(file_meta.id) == PSA_SUCCESS) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+    }
+
+    /* Leave the spare file index, as when the files are created one by one */
+    if (num_files >= fs_ctx->cfg->max_num_files) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    for (i = 0; i < num_files; i++) {
+        if ((files[i].flags & ~ITS_FLASH_FS_USER_FLAGS_MASK) ||
+            (files[i].size > fs_ctx->cfg->max_file_size)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        size = its_flash_fs_bulk_file_size(fs_ctx->cfg, &files[i]);
+
+        /* A file that does not fit in what is left is put in the next block.
+         * If the files do not fit in that order, they are left to be written
+         * one by one, which can split or reorder them.
+         */
+        while (block_meta.free_size < size) {
+            lblock++;
+            if (lblock >= its_flash_fs_num_active_dblocks(fs_ctx->cfg)) {
+                return PSA_ERROR_NOT_SUPPORTED;
+            }
+
+            err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock,
+                                                          &block_meta);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+
+        block_meta.free_size -= size;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Finishes the bulk load of a logical block and moves to the next one.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in,out] lblock      Logical block, updated to the next one
+ * \param[in,out] block_meta  Metadata of the logical block, updated to the
+ *                            metadata of the next one
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_bulk_next_block(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t *lblock,
+                                            struct its_block_meta_t *block_meta)
+{
+    psa_status_t err;
+
+    /* The data of the logical block 0 is in the scratch metadata block, which
+     * is flushed when the update is finalized.
+     */
+    if (*lblock != ITS_LOGICAL_DBLOCK0) {
+        err = fs_ctx->ops->flush(fs_ctx->cfg, block_meta->phy_id);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    err = its_flash_fs_mblock_write_scratch_block_meta(fs_ctx, *lblock,
+                                                       block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    (*lblock)++;
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, *lblock, block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* The block holds no file, but it can hold the data of a write that was
+     * not committed before a power failure.
+     */
+    return fs_ctx->ops->erase(fs_ctx->cfg, block_meta->phy_id);
+}
+
+psa_status_t its_flash_fs_bulk_load(struct its_flash_fs_ctx_t *fs_ctx,
+                                    const struct its_flash_fs_bulk_file_t *files,
+                                    uint32_t num_files)
+{
+    psa_status_t err;
+    uint32_t i;
+    uint32_t lblock = ITS_LOGICAL_DBLOCK0;
+    uint32_t phys_block;
+    size_t size;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+
+    /* Nothing can fail for lack of space once the scratch blocks are written */
+    err = its_flash_fs_bulk_plan(fs_ctx, files, num_files);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The rest of the file metadata table stays free */
+    err = its_flash_fs_mblock_cp_file_meta(fs_ctx, num_files,
+                                           fs_ctx->cfg->max_num_files);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock, &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    for (i = 0; i < num_files; i++) {
+        size = its_flash_fs_bulk_file_size(fs_ctx->cfg, &files[i]);
+
+        while (block_meta.free_size < size) {
+            err = its_flash_fs_bulk_next_block(fs_ctx, &lblock, &block_meta);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+
+        (void)memset(&file_meta, ITS_DEFAULT_EMPTY_BUFF_VAL,
+                     sizeof(file_meta));
+        memcpy(file_meta.id, files[i].fid, ITS_FILE_ID_SIZE);
+        file_meta.lblock = lblock;
+        file_meta.data_idx = fs_ctx->cfg->block_size - block_meta.free_size;
+        file_meta.cur_size = files[i].size;
+        file_meta.max_size = size;
+        file_meta.flags = files[i].flags;
+
+        /* The data of the logical block 0 is written with the new metadata,
+         * the other blocks are empty and written in place.
+         */
+        phys_block = (lblock == ITS_LOGICAL_DBLOCK0) ?
+                     fs_ctx->scratch_metablock : block_meta.phy_id;
+
+        if (size != 0) {
+            err = its_flash_fs_dblock_load_file(fs_ctx, phys_block, &file_meta,
+                                                size, files[i].data);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+
+        block_meta.free_size -= size;
+
+        err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, i,
+                                                           &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Put the metadata of the last block written and of the blocks left
+     * empty in the scratch metadata block.
+     */
+    if (lblock != ITS_LOGICAL_DBLOCK0) {
+        err = fs_ctx->ops->flush(fs_ctx->cfg, block_meta.phy_id);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    err = its_flash_fs_mblock_write_scratch_block_meta(fs_ctx, lblock,
+                                                       &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    for (lblock++; lblock < its_flash_fs_num_active_dblocks(fs_ctx->cfg);
+         lblock++) {
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, lblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = its_flash_fs_mblock_write_scratch_block_meta(fs_ctx, lblock,
+                                                           &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Write metadata header, swap metadata blocks and erase scratch blocks */
+    return its_flash_fs_mblock_meta_update_finalize(fs_ctx);
+}
+
+/**
+ * \brief Moves the space left to the next logical block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in,out] space   Space left
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_space_next_block(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            struct its_flash_fs_space_t *space)
+{
+    psa_status_t err;
+    struct its_block_meta_t block_meta;
+
+    space->lblock++;
+    if (space->lblock >= its_flash_fs_num_active_dblocks(fs_ctx->cfg)) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, space->lblock,
+                                                  &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    space->free_size = block_meta.free_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_space_init(struct its_flash_fs_ctx_t *fs_ctx,
+                                     struct its_flash_fs_space_t *space)
+{
+    psa_status_t err;
+    uint32_t i;
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+
+    space->free_files = 0;
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &file_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        if (its_utils_validate_fid(file_meta.id) != PSA_SUCCESS) {
+            space->free_files++;
+        }
+    }
+
+    /* The spare file index is only used to replace a file */
+    if (space->free_files > 0) {
+        space->free_files--;
+    }
+
+    space->lblock = ITS_LOGICAL_DBLOCK0;
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, space->lblock,
+                                                  &block_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    space->free_size = block_meta.free_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_space_reserve(struct its_flash_fs_ctx_t *fs_ctx,
+                                        struct its_flash_fs_space_t *space,
+                                        const uint8_t *fid,
+                                        size_t size)
+{
+    psa_status_t err;
+    size_t extent_size;
+    uint32_t num_extents = 0;
+
+    /* Every file, new or replaced, takes a new file index and new space */
+    (void)fid;
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    size = ITS_UTILS_ALIGN(size, fs_ctx->cfg->program_unit);
+#endif
+
+    if (size > fs_ctx->cfg->max_file_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The files are placed one after the other. A file is not put in a block
+     * left behind, as the first fit used to write the files always finds a
+     * place if this does.
+     */
+    do {
+        extent_size = size;
+#if ITS_MAX_FILE_EXTENTS > 1
+        /* A file larger than an extent is split over the next blocks */
+        if (size > its_flash_fs_max_extent_size(fs_ctx->cfg)) {
+            while (space->free_size == 0) {
+                err = its_flash_fs_space_next_block(fs_ctx, space);
+                if (err != PSA_SUCCESS) {
+                    return err;
+                }
+            }
+            extent_size = ITS_UTILS_MIN(size, space->free_size);
+        }
+#endif
+
+        while (space->free_size < extent_size) {
+            err = its_flash_fs_space_next_block(fs_ctx, space);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+
+        if ((space->free_files == 0) ||
+            (++num_extents > ITS_UTILS_MAX(ITS_MAX_FILE_EXTENTS, 1))) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+
+        space->free_size -= extent_size;
+        space->free_files--;
+        size -= extent_size;
+    } while (size > 0);
+
     return PSA_SUCCESS;
 }
+
+#endif /* !ITS_FLASH_FS_LOG && !ITS_RAM_OBJECT_STORE */
@@ -20,7 +20,17 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "config_tfm.h"
+#ifdef CONFIG_TFM_SPM_TRACE
+#include "service_api.h"
+#endif
+#if ITS_FLASH_FS_LOG
+#include "its_flash_fs_log.h"
+#elif ITS_RAM_OBJECT_STORE
+#include "its_flash_fs_ram.h"
+#else
 #include "its_flash_fs_mblock.h"
+#endif
 #include "psa/error.h"
 
 #ifdef __cplusplus
@@ -42,6 +52,26 @@ extern "C" {
 /* Invalid block index */
 #define ITS_BLOCK_INVALID_ID 0xFFFFFFFFU
 
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+/**
+ * \struct its_flash_fs_stats_t
+ *
+ * \brief Structure to store the flash operations issued by a filesystem,
+ *        counted by the flash interface implementations.
+ */
+struct its_flash_fs_stats_t {
+    uint32_t num_reads;        /**< Number of read operations */
+    uint32_t num_programs;     /**< Number of program operations */
+    uint32_t num_erases;       /**< Number of block erases */
+    uint32_t bytes_read;       /**< Number of bytes read */
+    uint32_t bytes_programmed; /**< Number of bytes programmed */
+    uint32_t erase_count[ITS_FLASH_STATS_NUM_BLOCKS]; /**< Number of erases of
+                                                       *   each block, for the
+                                                       *   first blocks
+                                                       */
+};
+#endif
+
 /**
  * \struct its_flash_fs_config_t
  *
@@ -61,8 +91,151 @@ struct its_flash_fs_config_t {
     uint16_t max_file_size;   /**< Maximum file size */
     uint16_t max_num_files;   /**< Maximum number of files */
     uint8_t erase_val;        /**< Value of a byte after erase (usually 0xFF) */
+    struct its_flash_fs_file_index_t *file_index; /**< RAM index of the file
+                                                   *   metadata, or NULL to
+                                                   *   always read it from
+                                                   *   flash
+                                                   */
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+    struct its_flash_fs_stats_t *stats; /**< Flash operation counters, or NULL
+                                         *   to not count them
+                                         */
+#endif
 };
 
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+/**
+ * \brief Counts a read operation of the flash interface.
+ *
+ * \param[in] cfg   Filesystem configuration
+ * \param[in] size  Number of bytes read
+ */
+static inline void its_flash_fs_stats_read(
+                                        const struct its_flash_fs_config_t *cfg,
+                                        size_t size)
+{
+    if (cfg->stats != NULL) {
+        cfg->stats->num_reads++;
+        cfg->stats->bytes_read += size;
+    }
+}
+
+/**
+ * \brief Counts a program operation of the flash interface.
+ *
+ * \param[in] cfg   Filesystem configuration
+ * \param[in] size  Number of bytes programmed
+ */
+static inline void its_flash_fs_stats_program(
+                                        const struct its_flash_fs_config_t *cfg,
+                                        size_t size)
+{
+    if (cfg->stats != NULL) {
+        cfg->stats->num_programs++;
+        cfg->stats->bytes_programmed += size;
+    }
+}
+
+/**
+ * \brief Counts a block erase of the flash interface.
+ *
+ * \param[in] cfg       Filesystem configuration
+ * \param[in] block_id  Block ID
+ */
+static inline void its_flash_fs_stats_erase(
+                                        const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id)
+{
+    if (cfg->stats != NULL) {
+        cfg->stats->num_erases++;
+        if (block_id < ITS_FLASH_STATS_NUM_BLOCKS) {
+            cfg->stats->erase_count[block_id]++;
+        }
+    }
+}
+#else
+#define its_flash_fs_stats_read(cfg, size)
+#define its_flash_fs_stats_program(cfg, size)
+#define its_flash_fs_stats_erase(cfg, block_id)
+#endif
+
+#ifdef CONFIG_TFM_SPM_TRACE
+/**
+ * \brief Records the start of a flash operation in the SPM trace.
+ *
+ * \param[in] event     TFM_TRACE_EVT_FLASH_READ, _PROGRAM or _ERASE
+ * \param[in] block_id  Block ID
+ * \param[in] size      Number of bytes, 0 for an erase
+ */
+static inline void its_flash_fs_trace_begin(uint32_t event, uint32_t block_id,
+                                            size_t size)
+{
+    tfm_core_trace_event(event, block_id, (uint32_t)size);
+}
+
+/**
+ * \brief Records the end of a flash operation in the SPM trace.
+ *
+ * \param[in] event   Event of the start of the operation
+ * \param[in] status  Result of the operation
+ *
+ * \return Returns \p status
+ */
+static inline psa_status_t its_flash_fs_trace_end(uint32_t event,
+                                                  psa_status_t status)
+{
+    tfm_core_trace_event(TFM_TRACE_EVT_FLASH_DONE, event, (uint32_t)status);
+
+    return status;
+}
+#endif /* CONFIG_TFM_SPM_TRACE */
+
+#if ITS_FS_FAULT_INJECTION
+/**
+ * \enum its_flash_fs_fault_point_t
+ *
+ * \brief Steps of a metadata block filesystem update after which a power
+ *        failure leaves the flash in a distinct state.
+ */
+enum its_flash_fs_fault_point_t {
+    ITS_FLASH_FS_FAULT_DATA_MOVED = 0, /**< A chunk of data is copied to the
+                                        *   scratch block
+                                        */
+    ITS_FLASH_FS_FAULT_META_WRITTEN,   /**< The scratch metadata is written,
+                                        *   without its header
+                                        */
+    ITS_FLASH_FS_FAULT_HEADER_WRITTEN, /**< The scratch metadata header is
+                                        *   written, not flushed
+                                        */
+    ITS_FLASH_FS_FAULT_META_COMMITTED, /**< The scratch metadata block is
+                                        *   flushed and is now active
+                                        */
+    ITS_FLASH_FS_FAULT_META_ERASED,    /**< The new scratch metadata block is
+                                        *   erased, not the data scratch block
+                                        */
+    ITS_FLASH_FS_FAULT_RESET_ERASED,   /**< The first metadata block is erased
+                                        *   by a filesystem reset
+                                        */
+};
+
+/**
+ * \brief Called by the metadata block filesystem at each fault point. The
+ *        weak reference implementation of its_fault_bench.c resets the
+ *        device at the armed point. A test build can provide its own, then
+ *        checks that the filesystem mounts with either the old or the new
+ *        content.
+ *
+ * \param[in] cfg    Configuration of the filesystem being updated
+ * \param[in] point  Fault point reached
+ */
+void its_flash_fs_fault_point(const struct its_flash_fs_config_t *cfg,
+                              enum its_flash_fs_fault_point_t point);
+
+#define ITS_FLASH_FS_FAULT_POINT(cfg, point) its_flash_fs_fault_point(cfg, point)
+#else
+#define ITS_FLASH_FS_FAULT_POINT(cfg, point)
+#endif
+
 /**
  * \struct its_flash_fs_ops_t
  *
@@ -178,6 +351,33 @@ struct its_file_info_t {
     uint32_t flags;      /*!< Flags set when the file was created */
 };
 
+/*!
+ * \struct its_flash_fs_bulk_file_t
+ *
+ * \brief Structure to describe a file written by \ref its_flash_fs_bulk_load.
+ */
+struct its_flash_fs_bulk_file_t {
+    uint8_t fid[ITS_FILE_ID_SIZE]; /*!< ID of the file */
+    uint32_t flags;                /*!< User flags of the file */
+    size_t size;                   /*!< Size of the file data, which is also
+                                    *   the maximum size of the file
+                                    */
+    const uint8_t *data;           /*!< Pointer to the file data */
+};
+
+/*!
+ * \struct its_flash_fs_space_t
+ *
+ * \brief Space left for the files of \ref its_flash_fs_space_reserve.
+ */
+struct its_flash_fs_space_t {
+    uint32_t lblock;    /*!< Block the next file is placed in */
+    size_t free_size;   /*!< Free space left, in the block if the filesystem
+                         *   has blocks of metadata
+                         */
+    uint32_t free_files; /*!< Free file entries left */
+};
+
 /**
  * \brief Initialises the filesystem context. Must be called successfully before
  *        any other filesystem API is called.
@@ -280,6 +480,71 @@ psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
 psa_status_t its_flash_fs_file_delete(its_flash_fs_ctx_t *fs_ctx,
                                       const uint8_t *fid);
 
+/**
+ * \brief Counts the files whose ID starts with the given prefix.
+ *
+ * \param[in,out] fs_ctx       Filesystem context
+ * \param[in]     prefix       Start of the file IDs to count
+ * \param[in]     prefix_size  Size of the prefix, at most ITS_FILE_ID_SIZE
+ * \param[out]    num_files    Number of files found
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_file_count(its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *prefix,
+                                     size_t prefix_size,
+                                     uint32_t *num_files);
+
+/**
+ * \brief Creates several files in an empty filesystem, with a single
+ *        metadata update. The file data is programmed in one sequential pass
+ *        and the files appear together when the metadata is committed, so a
+ *        power failure leaves the filesystem empty or with all of them.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     files      Files to create, with distinct IDs
+ * \param[in]     num_files  Number of files to create
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ * \retval PSA_ERROR_NOT_SUPPORTED  The filesystem is not empty, or does not
+ *                                  support bulk loads. The files must be
+ *                                  written one at a time instead.
+ */
+psa_status_t its_flash_fs_bulk_load(its_flash_fs_ctx_t *fs_ctx,
+                                    const struct its_flash_fs_bulk_file_t *files,
+                                    uint32_t num_files);
+
+/**
+ * \brief Starts checking that several files can be written one after the
+ *        other, with \ref its_flash_fs_space_reserve.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[out]    space   Space left in the filesystem
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_space_init(its_flash_fs_ctx_t *fs_ctx,
+                                     struct its_flash_fs_space_t *space);
+
+/**
+ * \brief Reserves the space for a file written with the create and truncate
+ *        flags. The check is conservative: the space of a file that is
+ *        replaced or removed is not given back, so the files fit if it
+ *        succeeds for each of them.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in,out] space   Space left, updated for the file
+ * \param[in]     fid     ID of the file
+ * \param[in]     size    Maximum size of the file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The file may not fit
+ */
+psa_status_t its_flash_fs_space_reserve(its_flash_fs_ctx_t *fs_ctx,
+                                        struct its_flash_fs_space_t *space,
+                                        const uint8_t *fid,
+                                        size_t size);
+
 #ifdef __cplusplus
 }
 #endif
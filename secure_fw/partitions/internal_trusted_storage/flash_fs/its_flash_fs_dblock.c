@@ -1,14 +1,32 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include "config_tfm.h"
+
+#if !ITS_FLASH_FS_LOG && !ITS_RAM_OBJECT_STORE
+
 #include "its_flash_fs_dblock.h"
 
+#include <string.h>
+
 #include "its_flash_fs.h"
 
+#if ITS_IN_PLACE_APPEND
+/* Size of the buffer used to check that a flash region is erased */
+#define ITS_DBLOCK_ERASED_CHECK_BUF_SIZE  16
+#endif
+
+#if ITS_ENCRYPTION
+/* Size of the buffer used to encrypt file data before it is programmed. It
+ * must be a multiple of the flash program unit.
+ */
+#define ITS_DBLOCK_CRYPT_BUF_SIZE  ITS_UTILS_MAX(64, ITS_FLASH_MAX_ALIGNMENT)
+#endif
+
 /**
  * \brief Converts logical data block number to physical number.
  *
@@ -31,6 +49,114 @@ static uint32_t its_dblock_lo_to_phy(struct its_flash_fs_ctx_t *fs_ctx,
     return block_meta.phy_id;
 }
 
+#if ITS_ENCRYPTION
+/**
+ * \brief Encrypts file data and programs it into a block.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     phys_block  Physical block ID
+ * \param[in]     pos         Position of the data in the block
+ * \param[in]     nonce       Nonce of the file data
+ * \param[in]     offset      Offset of the data in the file
+ * \param[in]     size        Size of the data
+ * \param[in]     data        Pointer to the data to encrypt
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_dblock_write_encrypted(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t phys_block,
+                                              size_t pos,
+                                              const uint8_t *nonce,
+                                              size_t offset,
+                                              size_t size,
+                                              const uint8_t *data)
+{
+    psa_status_t err;
+    uint8_t buf[ITS_DBLOCK_CRYPT_BUF_SIZE];
+    size_t bytes_to_write;
+
+    while (size > 0) {
+        bytes_to_write = ITS_UTILS_MIN(size, sizeof(buf));
+
+        if (tfm_hal_its_ctr_crypt(nonce, TFM_HAL_ITS_ENCRYPTION_NONCE_SIZE,
+                                  offset, data, buf, bytes_to_write)
+            != TFM_HAL_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = fs_ctx->ops->write(fs_ctx->cfg, phys_block, buf, pos,
+                                 bytes_to_write);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        pos += bytes_to_write;
+        offset += bytes_to_write;
+        data += bytes_to_write;
+        size -= bytes_to_write;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Copies the start of a file to another block, encrypting it again
+ *        under a new nonce.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     dst_block  Physical block ID of the destination
+ * \param[in]     src_block  Physical block ID of the source
+ * \param[in]     pos        Position of the file in both blocks
+ * \param[in]     old_nonce  Nonce of the file data in the source
+ * \param[in]     nonce      Nonce of the file data in the destination
+ * \param[in]     size       Number of bytes to copy from the start of the file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_dblock_reencrypt(struct its_flash_fs_ctx_t *fs_ctx,
+                                         uint32_t dst_block,
+                                         uint32_t src_block,
+                                         size_t pos,
+                                         const uint8_t *old_nonce,
+                                         const uint8_t *nonce,
+                                         size_t size)
+{
+    psa_status_t err;
+    uint8_t buf[ITS_DBLOCK_CRYPT_BUF_SIZE];
+    size_t bytes_to_copy;
+    size_t offset = 0;
+
+    while (size > 0) {
+        bytes_to_copy = ITS_UTILS_MIN(size, sizeof(buf));
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, src_block, buf, pos + offset,
+                                bytes_to_copy);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        /* Decrypt in place, the buffer is encrypted again when written */
+        if (tfm_hal_its_ctr_crypt(old_nonce, TFM_HAL_ITS_ENCRYPTION_NONCE_SIZE,
+                                  offset, buf, buf, bytes_to_copy)
+            != TFM_HAL_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = its_dblock_write_encrypted(fs_ctx, dst_block, pos + offset,
+                                         nonce, offset, bytes_to_copy, buf);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        offset += bytes_to_copy;
+        size -= bytes_to_copy;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_ENCRYPTION */
+
 psa_status_t its_flash_fs_dblock_compact_block(
                                               struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t lblock,
@@ -123,6 +249,9 @@ psa_status_t its_flash_fs_dblock_read_file(
 {
     uint32_t phys_block;
     size_t pos;
+#if ITS_ENCRYPTION
+    psa_status_t err;
+#endif
 
     phys_block = its_dblock_lo_to_phy(fs_ctx, file_meta->lblock);
     if (phys_block == ITS_BLOCK_INVALID_ID) {
@@ -131,13 +260,27 @@ psa_status_t its_flash_fs_dblock_read_file(
 
     pos = (file_meta->data_idx + offset);
 
+#if ITS_ENCRYPTION
+    err = fs_ctx->ops->read(fs_ctx->cfg, phys_block, buf, pos, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (tfm_hal_its_ctr_crypt(file_meta->nonce, sizeof(file_meta->nonce),
+                              offset, buf, buf, size) != TFM_HAL_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+#else
     return fs_ctx->ops->read(fs_ctx->cfg, phys_block, buf, pos, size);
+#endif
 }
 
 psa_status_t its_flash_fs_dblock_write_file(
                                       struct its_flash_fs_ctx_t *fs_ctx,
                                       const struct its_block_meta_t *block_meta,
-                                      const struct its_file_meta_t *file_meta,
+                                      struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
                                       const uint8_t *data)
@@ -146,6 +289,9 @@ psa_status_t its_flash_fs_dblock_write_file(
     uint32_t scratch_id;
     size_t pos;
     size_t num_bytes;
+#if ITS_ENCRYPTION
+    uint8_t old_nonce[TFM_HAL_ITS_ENCRYPTION_NONCE_SIZE];
+#endif
 
     scratch_id = its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
                                                          file_meta->lblock);
@@ -153,6 +299,42 @@ psa_status_t its_flash_fs_dblock_write_file(
     /* Calculate the position of the new file data in the block */
     pos = file_meta->data_idx + offset;
 
+#if ITS_ENCRYPTION
+    /* Every write takes a new nonce, so that the key stream of a nonce is
+     * never programmed with other content, even by a write that was not
+     * committed. The file data kept before the offset is encrypted again.
+     */
+    memcpy(old_nonce, file_meta->nonce, sizeof(old_nonce));
+    if (tfm_hal_its_gen_nonce(file_meta->nonce, sizeof(file_meta->nonce))
+        != TFM_HAL_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* Move data up to the start of the file */
+    err = its_flash_fs_block_to_block_move(fs_ctx, scratch_id,
+                                           block_meta->data_start,
+                                           block_meta->phy_id,
+                                           block_meta->data_start,
+                                           file_meta->data_idx -
+                                           block_meta->data_start);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_dblock_reencrypt(fs_ctx, scratch_id, block_meta->phy_id,
+                               file_meta->data_idx, old_nonce,
+                               file_meta->nonce, offset);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Write the new file data */
+    err = its_dblock_write_encrypted(fs_ctx, scratch_id, pos, file_meta->nonce,
+                                     offset, size, data);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#else
     /* Move data up to the new file data position */
     err = its_flash_fs_block_to_block_move(fs_ctx, scratch_id,
                                            block_meta->data_start,
@@ -168,6 +350,7 @@ psa_status_t its_flash_fs_dblock_write_file(
     if (err != PSA_SUCCESS) {
         return err;
     }
+#endif
 
     /* Calculate the position of the end of the file */
     pos = file_meta->data_idx + file_meta->max_size;
@@ -192,3 +375,149 @@ psa_status_t its_flash_fs_dblock_write_file(
 
     return err;
 }
+
+psa_status_t its_flash_fs_dblock_load_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                           uint32_t phys_block,
+                                           struct its_file_meta_t *file_meta,
+                                           size_t size,
+                                           const uint8_t *data)
+{
+    psa_status_t err;
+    uint8_t tail[ITS_FLASH_MAX_ALIGNMENT];
+    size_t data_size = ITS_UTILS_MIN(size, file_meta->cur_size);
+    size_t head_size = data_size - (data_size % fs_ctx->cfg->program_unit);
+    size_t tail_size = size - head_size;
+
+    /* The data is only read up to the file size. The rest of the last
+     * program unit is padded with the erase value.
+     */
+    if (tail_size > sizeof(tail)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    (void)memset(tail, fs_ctx->cfg->erase_val, tail_size);
+    memcpy(tail, data + head_size, data_size - head_size);
+
+#if ITS_ENCRYPTION
+    if (tfm_hal_its_gen_nonce(file_meta->nonce, sizeof(file_meta->nonce))
+        != TFM_HAL_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_dblock_write_encrypted(fs_ctx, phys_block, file_meta->data_idx,
+                                     file_meta->nonce, 0, head_size, data);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return its_dblock_write_encrypted(fs_ctx, phys_block,
+                                      file_meta->data_idx + head_size,
+                                      file_meta->nonce, head_size, tail_size,
+                                      tail);
+#else
+    if (head_size != 0) {
+        err = fs_ctx->ops->write(fs_ctx->cfg, phys_block, data,
+                                 file_meta->data_idx, head_size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    if (tail_size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    return fs_ctx->ops->write(fs_ctx->cfg, phys_block, tail,
+                              file_meta->data_idx + head_size, tail_size);
+#endif
+}
+
+#if ITS_IN_PLACE_APPEND
+/**
+ * \brief Checks that a region of a physical block is erased.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     phys_block  Physical block ID
+ * \param[in]     pos         Position of the region in the block
+ * \param[in]     size        Size of the region
+ *
+ * \return Returns PSA_SUCCESS if the region is erased,
+ *         PSA_ERROR_NOT_SUPPORTED if it is not, or an error code as specified
+ *         in \ref psa_status_t if it could not be read.
+ */
+static psa_status_t its_dblock_check_erased(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t phys_block,
+                                            size_t pos,
+                                            size_t size)
+{
+    psa_status_t err;
+    uint8_t buf[ITS_DBLOCK_ERASED_CHECK_BUF_SIZE];
+    size_t bytes_to_check;
+    size_t i;
+
+    while (size > 0) {
+        bytes_to_check = ITS_UTILS_MIN(size, sizeof(buf));
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, phys_block, buf, pos,
+                                bytes_to_check);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (i = 0; i < bytes_to_check; i++) {
+            if (buf[i] != fs_ctx->cfg->erase_val) {
+                return PSA_ERROR_NOT_SUPPORTED;
+            }
+        }
+
+        pos += bytes_to_check;
+        size -= bytes_to_check;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_dblock_append_file_in_place(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size,
+                                      const uint8_t *data)
+{
+    psa_status_t err;
+    size_t pos;
+
+    /* The data in logical data block 0 is copied with every metadata block
+     * update, so there is nothing to gain from writing it in place. Data
+     * that overwrites the existing file content must be written through the
+     * scratch data block to be power failure safe.
+     */
+    if ((file_meta->lblock == ITS_LOGICAL_DBLOCK0) ||
+        (offset != file_meta->cur_size)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* Calculate the position of the new file data in the block */
+    pos = file_meta->data_idx + offset;
+
+    /* The region can have been partially programmed by an append that was
+     * interrupted by a power failure before its metadata was committed.
+     */
+    err = its_dblock_check_erased(fs_ctx, block_meta->phy_id, pos, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Write the new file data */
+    err = fs_ctx->ops->write(fs_ctx->cfg, block_meta->phy_id, data, pos, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Commit data block modifications to flash */
+    return fs_ctx->ops->flush(fs_ctx->cfg, block_meta->phy_id);
+}
+#endif /* ITS_IN_PLACE_APPEND */
+
+#endif /* !ITS_FLASH_FS_LOG && !ITS_RAM_OBJECT_STORE */
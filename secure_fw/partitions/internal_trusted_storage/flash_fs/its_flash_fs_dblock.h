@@ -64,7 +64,8 @@ psa_status_t its_flash_fs_dblock_read_file(
  *
  * \param[in,out] fs_ctx      Filesystem context
  * \param[in]     block_meta  Block metadata
- * \param[in]     file_meta   File metadata
+ * \param[in,out] file_meta   File metadata. With ITS_ENCRYPTION, its nonce is
+ *                            replaced by the one of the written data.
  * \param[in]     offset      Offset in the scratch data block where to start
  *                            the copy of the incoming data
  * \param[in]     size        Size of the incoming data
@@ -74,12 +75,63 @@ psa_status_t its_flash_fs_dblock_read_file(
  * \return Returns error code as specified in \ref psa_status_t
  */
 psa_status_t its_flash_fs_dblock_write_file(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size,
+                                      const uint8_t *data);
+
+/**
+ * \brief Programs the data of a new file directly into a block, for a bulk
+ *        load of an empty filesystem.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     phys_block  Physical block ID, erased at the file position
+ * \param[in,out] file_meta   File metadata. With ITS_ENCRYPTION, its nonce is
+ *                            set to the one of the written data.
+ * \param[in]     size        Size of the file data, aligned to the program
+ *                            unit
+ * \param[in]     data        Pointer to the file data. Only the current size
+ *                            of the file is read from it.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_dblock_load_file(struct its_flash_fs_ctx_t *fs_ctx,
+                                           uint32_t phys_block,
+                                           struct its_file_meta_t *file_meta,
+                                           size_t size,
+                                           const uint8_t *data);
+
+#if ITS_IN_PLACE_APPEND
+/**
+ * \brief Appends data to a file by programming it directly into the active
+ *        data block, without copying the block to the scratch data block.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     block_meta  Block metadata
+ * \param[in]     file_meta   File metadata
+ * \param[in]     offset      Offset in the file where to start the copy of
+ *                            the incoming data
+ * \param[in]     size        Size of the incoming data
+ * \param[in]     data        Pointer to data buffer to copy in the data block
+ *
+ * \note The data is only programmed in place if it is appended to a file in a
+ *       dedicated data block and the target region is still erased. The new
+ *       data is not visible until the file metadata is committed.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ * \retval PSA_ERROR_NOT_SUPPORTED  The data must be written through the
+ *                                  scratch data block instead
+ */
+psa_status_t its_flash_fs_dblock_append_file_in_place(
                                       struct its_flash_fs_ctx_t *fs_ctx,
                                       const struct its_block_meta_t *block_meta,
                                       const struct its_file_meta_t *file_meta,
                                       size_t offset,
                                       size_t size,
                                       const uint8_t *data);
+#endif /* ITS_IN_PLACE_APPEND */
 
 #ifdef __cplusplus
 }
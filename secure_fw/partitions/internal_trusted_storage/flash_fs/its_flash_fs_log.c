@@ -0,0 +1,1226 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "config_tfm.h"
+
+#if ITS_FLASH_FS_LOG
+
+#if ITS_ENCRYPTION
+#error "ITS_FLASH_FS_LOG is not supported with ITS_ENCRYPTION"
+#endif
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "its_flash_fs.h"
+#include "its_utils.h"
+#include "tfm_yield.h"
+
+/* Filesystem-internal flags, which cannot be passed by the caller */
+#define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
+/* Record flag that indicates the file has been deleted */
+#define ITS_LOG_FLAG_DELETED              (1U << 24)
+/* Record flag that indicates the garbage collection of the block following
+ * the one holding this record has completed.
+ */
+#define ITS_LOG_FLAG_GC_DONE              (1U << 25)
+
+#define ITS_LOG_BLOCK_MAGIC   0x4C535449U /* "ITSL" */
+#define ITS_LOG_RECORD_MAGIC  0x52535449U /* "ITSR" */
+#define ITS_LOG_COMMIT_MAGIC  0x43535449U /* "ITSC" */
+
+/* Size of the buffer used to program records and to copy data between
+ * blocks. It must be a multiple of the maximum flash program unit.
+ */
+#ifndef ITS_LOG_COPY_BUF_SIZE
+#define ITS_LOG_COPY_BUF_SIZE  ITS_UTILS_ALIGN(64, ITS_FLASH_MAX_ALIGNMENT)
+#endif
+
+/*!
+ * \struct its_log_block_hdr_t
+ *
+ * \brief Header programmed at the start of a block when it is opened.
+ */
+struct its_log_block_hdr_t {
+    uint32_t magic;   /*!< ITS_LOG_BLOCK_MAGIC */
+    uint32_t seq;     /*!< Sequence number, incremented for each opened block */
+    uint32_t version; /*!< Layout version */
+    uint32_t check;   /*!< Checksum of the fields above */
+};
+
+/*!
+ * \struct its_log_record_hdr_t
+ *
+ * \brief Header of a record. It is followed by cur_size bytes of file data
+ *        and then by a \ref its_log_commit_t, each padded to the flash
+ *        program unit.
+ */
+struct its_log_record_hdr_t {
+    uint32_t magic;               /*!< ITS_LOG_RECORD_MAGIC */
+    uint32_t flags;               /*!< File flags and ITS_LOG_FLAG_* */
+    uint32_t cur_size;            /*!< Size of the file data in the record */
+    uint32_t max_size;            /*!< Maximum size of the file */
+    uint8_t id[ITS_FILE_ID_SIZE]; /*!< ID of the file */
+};
+
+/*!
+ * \struct its_log_commit_t
+ *
+ * \brief Trailer programmed after the record data. A record is only valid
+ *        once its trailer has been programmed.
+ */
+struct its_log_commit_t {
+    uint32_t magic; /*!< ITS_LOG_COMMIT_MAGIC */
+    uint32_t check; /*!< Checksum of the record header */
+};
+
+/*!
+ * \struct its_log_writer_t
+ *
+ * \brief Buffers the bytes of a record so that flash is only programmed in
+ *        aligned multiples of the program unit.
+ */
+struct its_log_writer_t {
+    uint32_t block;                     /*!< Block being programmed */
+    size_t offset;                      /*!< Flash offset of buf[0] */
+    size_t fill;                        /*!< Number of buffered bytes */
+    uint8_t buf[ITS_LOG_COPY_BUF_SIZE]; /*!< Buffered bytes */
+};
+
+static uint32_t its_log_checksum(const void *buf, size_t size)
+{
+    const uint8_t *p = buf;
+    uint32_t hash = 2166136261U;
+
+    while (size--) {
+        hash = (hash ^ *p++) * 16777619U;
+    }
+
+    return hash;
+}
+
+static size_t its_log_align(const struct its_flash_fs_ctx_t *fs_ctx,
+                            size_t size)
+{
+    return ITS_UTILS_ALIGN(size, fs_ctx->cfg->program_unit);
+}
+
+/* Offset of the first record in a block */
+static size_t its_log_first_record(const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return its_log_align(fs_ctx, sizeof(struct its_log_block_hdr_t));
+}
+
+/* Flash space taken by a record holding data_size bytes of file data */
+static size_t its_log_record_size(const struct its_flash_fs_ctx_t *fs_ctx,
+                                  size_t data_size)
+{
+    return its_log_align(fs_ctx, sizeof(struct its_log_record_hdr_t))
+           + its_log_align(fs_ctx, data_size)
+           + its_log_align(fs_ctx, sizeof(struct its_log_commit_t));
+}
+
+/* Space at the end of each block reserved for the garbage collection record,
+ * so that the live records of a block always fit in the next one.
+ */
+static size_t its_log_gc_reserve(const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return its_log_record_size(fs_ctx, 0);
+}
+
+/* Total flash space that the files can reserve. One block is kept erased for
+ * garbage collection, one block absorbs the old copies of files being
+ * rewritten, and every block can waste up to one maximum size record at its
+ * end.
+ */
+static size_t its_log_capacity(const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    size_t payload = fs_ctx->cfg->block_size - its_log_first_record(fs_ctx)
+                     - its_log_gc_reserve(fs_ctx);
+
+    return (fs_ctx->cfg->num_blocks - 2)
+           * (payload - its_log_record_size(fs_ctx,
+                                            fs_ctx->cfg->max_file_size));
+}
+
+static uint32_t its_log_next_block(const struct its_flash_fs_ctx_t *fs_ctx,
+                                   uint32_t block)
+{
+    return (block + 1) % fs_ctx->cfg->num_blocks;
+}
+
+static struct its_log_file_t *its_log_find_file(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              const uint8_t *fid)
+{
+    struct its_log_file_t *file = fs_ctx->cfg->file_index->file;
+    uint32_t i;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if ((its_utils_validate_fid(file[i].id) == PSA_SUCCESS) &&
+            !memcmp(file[i].id, fid, ITS_FILE_ID_SIZE)) {
+            return &file[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Gets an unused file index entry.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     use_spare  If true then the last unused entry can be
+ *                           returned, otherwise at least one entry is left
+ *                           unused, as done by the metadata block filesystem
+ *
+ * \return Pointer to the entry, or NULL if there is none
+ */
+static struct its_log_file_t *its_log_alloc_file(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              bool use_spare)
+{
+    struct its_log_file_t *file = fs_ctx->cfg->file_index->file;
+    uint32_t i;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if (its_utils_validate_fid(file[i].id) != PSA_SUCCESS) {
+            if (!use_spare) {
+                use_spare = true;
+                continue;
+            }
+            return &file[i];
+        }
+    }
+
+    return NULL;
+}
+
+static psa_status_t its_log_is_erased(struct its_flash_fs_ctx_t *fs_ctx,
+                                      uint32_t block, size_t offset,
+                                      size_t size, bool *erased)
+{
+    uint8_t buf[ITS_LOG_COPY_BUF_SIZE];
+    psa_status_t err;
+    size_t chunk;
+    size_t i;
+
+    *erased = false;
+
+    while (size > 0) {
+        chunk = ITS_UTILS_MIN(size, sizeof(buf));
+        err = fs_ctx->ops->read(fs_ctx->cfg, block, buf, offset, chunk);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (i = 0; i < chunk; i++) {
+            if (buf[i] != fs_ctx->cfg->erase_val) {
+                return PSA_SUCCESS;
+            }
+        }
+
+        offset += chunk;
+        size -= chunk;
+    }
+
+    *erased = true;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Reads the header of a block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     block   Physical block ID
+ * \param[out]    seq     Sequence number of the block
+ *
+ * \return PSA_SUCCESS if the block has a valid header, PSA_ERROR_DOES_NOT_EXIST
+ *         if it is not in use, or another error on flash failure
+ */
+static psa_status_t its_log_read_block_hdr(struct its_flash_fs_ctx_t *fs_ctx,
+                                           uint32_t block, uint32_t *seq)
+{
+    struct its_log_block_hdr_t hdr;
+    psa_status_t err;
+
+    err = fs_ctx->ops->read(fs_ctx->cfg, block, (uint8_t *)&hdr, 0,
+                            sizeof(hdr));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if ((hdr.magic != ITS_LOG_BLOCK_MAGIC) ||
+        (hdr.version != ITS_LOG_SUPPORTED_VERSION) ||
+        (hdr.check != its_log_checksum(&hdr, offsetof(struct its_log_block_hdr_t,
+                                                      check)))) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    *seq = hdr.seq;
+
+    return PSA_SUCCESS;
+}
+
+static void its_log_writer_init(struct its_log_writer_t *writer,
+                                uint32_t block, size_t offset)
+{
+    writer->block = block;
+    writer->offset = offset;
+    writer->fill = 0;
+}
+
+static psa_status_t its_log_writer_emit(struct its_flash_fs_ctx_t *fs_ctx,
+                                        struct its_log_writer_t *writer)
+{
+    psa_status_t err;
+
+    err = fs_ctx->ops->write(fs_ctx->cfg, writer->block, writer->buf,
+                             writer->offset, writer->fill);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    writer->offset += writer->fill;
+    writer->fill = 0;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_log_writer_append(struct its_flash_fs_ctx_t *fs_ctx,
+                                          struct its_log_writer_t *writer,
+                                          const uint8_t *data, size_t size)
+{
+    psa_status_t err;
+    size_t chunk;
+
+    while (size > 0) {
+        chunk = ITS_UTILS_MIN(size, sizeof(writer->buf) - writer->fill);
+        (void)memcpy(writer->buf + writer->fill, data, chunk);
+        writer->fill += chunk;
+        data += chunk;
+        size -= chunk;
+
+        if (writer->fill == sizeof(writer->buf)) {
+            err = its_log_writer_emit(fs_ctx, writer);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Appends data read from another location in flash */
+static psa_status_t its_log_writer_copy(struct its_flash_fs_ctx_t *fs_ctx,
+                                        struct its_log_writer_t *writer,
+                                        uint32_t block, size_t offset,
+                                        size_t size)
+{
+    psa_status_t err;
+    size_t chunk;
+
+    while (size > 0) {
+        chunk = ITS_UTILS_MIN(size, sizeof(writer->buf) - writer->fill);
+        err = fs_ctx->ops->read(fs_ctx->cfg, block,
+                                writer->buf + writer->fill, offset, chunk);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        writer->fill += chunk;
+        offset += chunk;
+        size -= chunk;
+
+        if (writer->fill == sizeof(writer->buf)) {
+            err = its_log_writer_emit(fs_ctx, writer);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/* Pads the buffered bytes to the program unit and programs them */
+static psa_status_t its_log_writer_pad(struct its_flash_fs_ctx_t *fs_ctx,
+                                       struct its_log_writer_t *writer)
+{
+    size_t padded = its_log_align(fs_ctx, writer->fill);
+
+    if (padded == 0) {
+        return PSA_SUCCESS;
+    }
+
+    (void)memset(writer->buf + writer->fill, ITS_DEFAULT_EMPTY_BUFF_VAL,
+                 padded - writer->fill);
+    writer->fill = padded;
+
+    return its_log_writer_emit(fs_ctx, writer);
+}
+
+/**
+ * \brief Appends a record to the write block.
+ *
+ * \details The record data is the content of the source file with the range
+ *          [offset, offset + data_size) replaced by data. The record data
+ *          size is hdr->cur_size. The caller must have reserved enough space
+ *          in the write block.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     hdr        Record header to program
+ * \param[in]     src        File holding the existing data, or NULL
+ * \param[in]     offset     Offset of the new data in the file
+ * \param[in]     data_size  Size of the new data
+ * \param[in]     data       New data
+ * \param[out]    rec_offset Offset of the record in the write block
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_log_append_record(
+                                       struct its_flash_fs_ctx_t *fs_ctx,
+                                       const struct its_log_record_hdr_t *hdr,
+                                       const struct its_log_file_t *src,
+                                       size_t offset,
+                                       size_t data_size,
+                                       const uint8_t *data,
+                                       size_t *rec_offset)
+{
+    struct its_log_writer_t writer;
+    struct its_log_commit_t commit;
+    size_t src_data = 0;
+    size_t tail;
+    psa_status_t err;
+
+    its_log_writer_init(&writer, fs_ctx->write_block, fs_ctx->write_offset);
+
+    err = its_log_writer_append(fs_ctx, &writer, (const uint8_t *)hdr,
+                                sizeof(*hdr));
+    if (err == PSA_SUCCESS) {
+        err = its_log_writer_pad(fs_ctx, &writer);
+    }
+
+    if ((err == PSA_SUCCESS) && (src != NULL)) {
+        src_data = src->offset
+                   + its_log_align(fs_ctx, sizeof(struct its_log_record_hdr_t));
+
+        /* Existing data before the new data */
+        err = its_log_writer_copy(fs_ctx, &writer, src->block, src_data,
+                                  ITS_UTILS_MIN(offset, src->cur_size));
+    }
+
+    if (err == PSA_SUCCESS) {
+        err = its_log_writer_append(fs_ctx, &writer, data, data_size);
+    }
+
+    if ((err == PSA_SUCCESS) && (src != NULL) &&
+        (offset + data_size < src->cur_size)) {
+        /* Existing data after the new data */
+        tail = src->cur_size - (offset + data_size);
+        err = its_log_writer_copy(fs_ctx, &writer, src->block,
+                                  src_data + offset + data_size, tail);
+    }
+
+    /* Program all the record content before the commit trailer */
+    if (err == PSA_SUCCESS) {
+        err = its_log_writer_pad(fs_ctx, &writer);
+    }
+
+    if (err == PSA_SUCCESS) {
+        commit.magic = ITS_LOG_COMMIT_MAGIC;
+        commit.check = its_log_checksum(hdr, sizeof(*hdr));
+        err = its_log_writer_append(fs_ctx, &writer, (const uint8_t *)&commit,
+                                    sizeof(commit));
+    }
+
+    if (err == PSA_SUCCESS) {
+        err = its_log_writer_pad(fs_ctx, &writer);
+    }
+
+    if (err == PSA_SUCCESS) {
+        err = fs_ctx->ops->flush(fs_ctx->cfg, fs_ctx->write_block);
+    }
+
+    if (err != PSA_SUCCESS) {
+        /* The space may be partially programmed, so do not reuse it */
+        fs_ctx->write_offset = fs_ctx->cfg->block_size;
+        return err;
+    }
+
+    *rec_offset = fs_ctx->write_offset;
+    fs_ctx->write_offset = writer.offset;
+
+    return PSA_SUCCESS;
+}
+
+/* Makes block the write block, erasing it first if it is not blank */
+static psa_status_t its_log_open_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t block, uint32_t seq)
+{
+    struct its_log_writer_t writer;
+    struct its_log_block_hdr_t hdr;
+    psa_status_t err;
+    bool erased;
+
+    err = its_log_is_erased(fs_ctx, block, 0, fs_ctx->cfg->block_size,
+                            &erased);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (!erased) {
+        err = fs_ctx->ops->erase(fs_ctx->cfg, block);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    hdr.magic = ITS_LOG_BLOCK_MAGIC;
+    hdr.seq = seq;
+    hdr.version = ITS_LOG_SUPPORTED_VERSION;
+    hdr.check = its_log_checksum(&hdr, offsetof(struct its_log_block_hdr_t,
+                                                check));
+
+    its_log_writer_init(&writer, block, 0);
+    err = its_log_writer_append(fs_ctx, &writer, (const uint8_t *)&hdr,
+                                sizeof(hdr));
+    if (err == PSA_SUCCESS) {
+        err = its_log_writer_pad(fs_ctx, &writer);
+    }
+    if (err == PSA_SUCCESS) {
+        err = fs_ctx->ops->flush(fs_ctx->cfg, block);
+    }
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    fs_ctx->write_block = block;
+    fs_ctx->write_seq = seq;
+    fs_ctx->write_offset = writer.offset;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Copies the live records of a block into the write block, records
+ *        the completion and erases the block.
+ *
+ * \note  The block must be the oldest block in use, so that the deletion
+ *        records it holds can be dropped.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     victim  Physical block ID to collect
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_log_gc_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t victim)
+{
+    struct its_log_file_t *file = fs_ctx->cfg->file_index->file;
+    struct its_log_record_hdr_t hdr;
+    size_t rec_offset;
+    psa_status_t err;
+    uint32_t i;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if ((its_utils_validate_fid(file[i].id) != PSA_SUCCESS) ||
+            (file[i].block != victim)) {
+            continue;
+        }
+
+        hdr.magic = ITS_LOG_RECORD_MAGIC;
+        hdr.flags = file[i].flags;
+        hdr.cur_size = file[i].cur_size;
+        hdr.max_size = file[i].max_size;
+        (void)memcpy(hdr.id, file[i].id, ITS_FILE_ID_SIZE);
+
+        err = its_log_append_record(fs_ctx, &hdr, &file[i], file[i].cur_size,
+                                    0, NULL, &rec_offset);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        file[i].block = fs_ctx->write_block;
+        file[i].offset = rec_offset;
+    }
+
+    /* Once this record is programmed, the victim is no longer needed */
+    (void)memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = ITS_LOG_RECORD_MAGIC;
+    hdr.flags = ITS_LOG_FLAG_GC_DONE;
+    err = its_log_append_record(fs_ctx, &hdr, NULL, 0, 0, NULL, &rec_offset);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return fs_ctx->ops->erase(fs_ctx->cfg, victim);
+}
+
+/* Opens the next block in the ring, collecting the oldest block if needed */
+static psa_status_t its_log_advance(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    uint32_t block = its_log_next_block(fs_ctx, fs_ctx->write_block);
+    uint32_t victim = its_log_next_block(fs_ctx, block);
+    uint32_t seq;
+    psa_status_t err;
+
+    /* The block following the write block is only in use after a failed
+     * garbage collection, which must be recovered by preparing the
+     * filesystem again.
+     */
+    err = its_log_read_block_hdr(fs_ctx, block, &seq);
+    if (err == PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+
+    err = its_log_open_block(fs_ctx, block, fs_ctx->write_seq + 1);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_log_read_block_hdr(fs_ctx, victim, &seq);
+    if (err == PSA_ERROR_DOES_NOT_EXIST) {
+        /* The following block is not in use, nothing to collect */
+        return PSA_SUCCESS;
+    } else if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return its_log_gc_block(fs_ctx, victim);
+}
+
+/* Ensures that a record of the given size can be appended */
+static psa_status_t its_log_reserve(struct its_flash_fs_ctx_t *fs_ctx,
+                                    size_t size)
+{
+    psa_status_t err;
+    uint32_t i;
+
+    size += its_log_gc_reserve(fs_ctx);
+
+    for (i = 0; i < fs_ctx->cfg->num_blocks; i++) {
+        if (fs_ctx->write_offset + size <= fs_ctx->cfg->block_size) {
+            return PSA_SUCCESS;
+        }
+
+        err = its_log_advance(fs_ctx);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        /* Each collected block leaves a consistent log, let others run */
+        tfm_yield();
+    }
+
+    return PSA_ERROR_INSUFFICIENT_STORAGE;
+}
+
+/**
+ * \brief Walks the records of a block.
+ *
+ * \param[in,out] fs_ctx   Filesystem context
+ * \param[in]     block    Physical block ID
+ * \param[in]     apply    If true, apply the records to the file index
+ * \param[out]    gc_done  Set to true if a garbage collection record was found
+ * \param[out]    end      Offset following the last valid record, or the block
+ *                         size if the block must not be appended to
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_log_scan_block(struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t block, bool apply,
+                                       bool *gc_done, size_t *end)
+{
+    const size_t hdr_size = its_log_align(fs_ctx,
+                                          sizeof(struct its_log_record_hdr_t));
+    const size_t commit_size = its_log_align(fs_ctx,
+                                             sizeof(struct its_log_commit_t));
+    struct its_log_record_hdr_t hdr;
+    struct its_log_commit_t commit;
+    struct its_log_file_t *file;
+    size_t offset = its_log_first_record(fs_ctx);
+    size_t rec_size;
+    psa_status_t err;
+    bool erased;
+
+    *gc_done = false;
+
+    while (offset + hdr_size + commit_size <= fs_ctx->cfg->block_size) {
+        err = its_log_is_erased(fs_ctx, block, offset, hdr_size, &erased);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (erased) {
+            /* End of the records in this block */
+            *end = offset;
+            return PSA_SUCCESS;
+        }
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, block, (uint8_t *)&hdr, offset,
+                                sizeof(hdr));
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((hdr.magic != ITS_LOG_RECORD_MAGIC) ||
+            (hdr.cur_size > hdr.max_size) ||
+            (hdr.max_size > fs_ctx->cfg->max_file_size)) {
+            break;
+        }
+
+        rec_size = its_log_record_size(fs_ctx, hdr.cur_size);
+        if (offset + rec_size > fs_ctx->cfg->block_size) {
+            break;
+        }
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, block, (uint8_t *)&commit,
+                                offset + rec_size - commit_size,
+                                sizeof(commit));
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((commit.magic != ITS_LOG_COMMIT_MAGIC) ||
+            (commit.check != its_log_checksum(&hdr, sizeof(hdr)))) {
+            /* Interrupted record */
+            break;
+        }
+
+        if (hdr.flags & ITS_LOG_FLAG_GC_DONE) {
+            *gc_done = true;
+        } else if (apply) {
+            if (its_utils_validate_fid(hdr.id) != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+
+            file = its_log_find_file(fs_ctx, hdr.id);
+            if (file != NULL) {
+                fs_ctx->live_size -= its_log_record_size(fs_ctx,
+                                                         file->max_size);
+                (void)memset(file, 0, sizeof(*file));
+            }
+
+            if (!(hdr.flags & ITS_LOG_FLAG_DELETED)) {
+                file = its_log_alloc_file(fs_ctx, true);
+                if (file == NULL) {
+                    return PSA_ERROR_GENERIC_ERROR;
+                }
+
+                (void)memcpy(file->id, hdr.id, ITS_FILE_ID_SIZE);
+                file->flags = hdr.flags;
+                file->cur_size = hdr.cur_size;
+                file->max_size = hdr.max_size;
+                file->block = block;
+                file->offset = offset;
+                fs_ctx->live_size += its_log_record_size(fs_ctx,
+                                                         hdr.max_size);
+            }
+        }
+
+        offset += rec_size;
+    }
+
+    /* The rest of the block may be partially programmed */
+    *end = fs_ctx->cfg->block_size;
+
+    return PSA_SUCCESS;
+}
+
+/* Finds the most recently opened block */
+static psa_status_t its_log_find_write_block(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    bool found = false;
+    uint32_t seq;
+    uint32_t i;
+    psa_status_t err;
+
+    for (i = 0; i < fs_ctx->cfg->num_blocks; i++) {
+        err = its_log_read_block_hdr(fs_ctx, i, &seq);
+        if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            continue;
+        } else if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (!found || (seq > fs_ctx->write_seq)) {
+            fs_ctx->write_block = i;
+            fs_ctx->write_seq = seq;
+            found = true;
+        }
+    }
+
+    return found ? PSA_SUCCESS : PSA_ERROR_GENERIC_ERROR;
+}
+
+/**
+ * \brief Validates the configuration of the flash filesystem.
+ *
+ * \param[in] fs_ctx  Filesystem context holding the configuration
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_log_validate_config(
+                                        const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    const struct its_flash_fs_config_t *cfg = fs_ctx->cfg;
+    size_t overhead;
+
+    /* The log needs an index in RAM and a block that is kept erased, plus one
+     * block to absorb the old copies of rewritten files.
+     */
+    if ((cfg->file_index == NULL) || (cfg->num_blocks < 3)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((cfg->program_unit == 0) ||
+        (cfg->program_unit > ITS_FLASH_MAX_ALIGNMENT) ||
+        ((cfg->program_unit & (cfg->program_unit - 1)) != 0)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* A record of the maximum file size must fit in a block, with room left */
+    overhead = its_log_first_record(fs_ctx) + its_log_gc_reserve(fs_ctx)
+               + its_log_record_size(fs_ctx, cfg->max_file_size);
+    if (overhead >= cfg->block_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_init_ctx(its_flash_fs_ctx_t *fs_ctx,
+                                   const struct its_flash_fs_config_t *fs_cfg,
+                                   const struct its_flash_fs_ops_t *fs_ops)
+{
+    if (!fs_ctx || !fs_cfg || !fs_ops) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Zero the context */
+    memset(fs_ctx, 0, sizeof(*fs_ctx));
+
+    /* Associate the filesystem config and operations with the context */
+    fs_ctx->cfg = fs_cfg;
+    fs_ctx->ops = fs_ops;
+
+    return its_log_validate_config(fs_ctx);
+}
+
+psa_status_t its_flash_fs_prepare(its_flash_fs_ctx_t *fs_ctx)
+{
+    uint32_t block;
+    uint32_t seq;
+    uint32_t i;
+    size_t end;
+    bool gc_done;
+    psa_status_t err;
+
+    err = fs_ctx->ops->init(fs_ctx->cfg);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_log_find_write_block(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The block following the write block is in use only if a garbage
+     * collection into the write block was interrupted by a power failure.
+     */
+    block = its_log_next_block(fs_ctx, fs_ctx->write_block);
+    err = its_log_read_block_hdr(fs_ctx, block, &seq);
+    if (err == PSA_SUCCESS) {
+        err = its_log_scan_block(fs_ctx, fs_ctx->write_block, false, &gc_done,
+                                 &end);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (gc_done) {
+            /* Only the erase of the collected block is missing */
+            err = fs_ctx->ops->erase(fs_ctx->cfg, block);
+        } else {
+            /* The write block only holds partial copies of the collected
+             * block, which is still complete. Discard the copies, the
+             * collection is performed again when the log next advances.
+             */
+            err = fs_ctx->ops->erase(fs_ctx->cfg, fs_ctx->write_block);
+        }
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_log_find_write_block(fs_ctx);
+    }
+    if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+
+    /* Rebuild the file index by replaying the blocks in use, oldest first */
+    (void)memset(fs_ctx->cfg->file_index->file, 0,
+                 fs_ctx->cfg->max_num_files * sizeof(struct its_log_file_t));
+    fs_ctx->live_size = 0;
+
+    block = fs_ctx->write_block;
+    for (i = 0; i < fs_ctx->cfg->num_blocks; i++) {
+        block = its_log_next_block(fs_ctx, block);
+
+        err = its_log_read_block_hdr(fs_ctx, block, &seq);
+        if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            continue;
+        } else if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_log_scan_block(fs_ctx, block, true, &gc_done, &end);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* The last block replayed is the write block */
+    fs_ctx->write_offset = end;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_wipe_all(its_flash_fs_ctx_t *fs_ctx)
+{
+    uint32_t block = 0;
+    uint32_t i;
+    psa_status_t err;
+
+    /* Erase the most recent block last, so that an interrupted wipe cannot
+     * bring back files that were deleted or overwritten.
+     */
+    if (its_log_find_write_block(fs_ctx) == PSA_SUCCESS) {
+        block = fs_ctx->write_block;
+    }
+
+    for (i = 0; i < fs_ctx->cfg->num_blocks; i++) {
+        block = its_log_next_block(fs_ctx, block);
+        err = fs_ctx->ops->erase(fs_ctx->cfg, block);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    return its_log_open_block(fs_ctx, 0, 0);
+}
+
+psa_status_t its_flash_fs_file_get_info(its_flash_fs_ctx_t *fs_ctx,
+                                        const uint8_t *fid,
+                                        struct its_file_info_t *info)
+{
+    struct its_log_file_t *file;
+
+    file = its_log_find_file(fs_ctx, fid);
+    if (file == NULL) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    info->size_max = file->max_size;
+    info->size_current = file->cur_size;
+    info->flags = file->flags & ITS_FLASH_FS_USER_FLAGS_MASK;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_write(its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *fid,
+                                     uint32_t flags,
+                                     size_t max_size,
+                                     size_t data_size,
+                                     size_t offset,
+                                     const uint8_t *data)
+{
+    struct its_log_record_hdr_t hdr;
+    struct its_log_file_t *file;
+    const struct its_log_file_t *src = NULL;
+    size_t old_reserved = 0;
+    size_t new_reserved;
+    size_t rec_offset;
+    psa_status_t err;
+
+    /* Do not permit the user to pass filesystem-internal flags */
+    if (flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    /* Set the max_size to be aligned with the flash program unit */
+    max_size = ITS_UTILS_ALIGN(max_size, fs_ctx->cfg->program_unit);
+#endif
+
+    hdr.magic = ITS_LOG_RECORD_MAGIC;
+    (void)memcpy(hdr.id, fid, ITS_FILE_ID_SIZE);
+
+    file = its_log_find_file(fs_ctx, fid);
+    if (file != NULL) {
+        old_reserved = its_log_record_size(fs_ctx, file->max_size);
+
+        if (flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
+            hdr.flags = flags;
+            hdr.cur_size = 0;
+            hdr.max_size = max_size;
+        } else {
+            if (data_size == 0) {
+                /* Nothing changes */
+                return PSA_SUCCESS;
+            }
+
+            /* Write to existing file */
+            hdr.flags = file->flags;
+            hdr.cur_size = file->cur_size;
+            hdr.max_size = file->max_size;
+            src = file;
+        }
+    } else {
+        /* The create flag must be supplied to create a new file */
+        if (!(flags & ITS_FLASH_FS_FLAG_CREATE)) {
+            return PSA_ERROR_DOES_NOT_EXIST;
+        }
+
+        hdr.flags = flags;
+        hdr.cur_size = 0;
+        hdr.max_size = max_size;
+    }
+
+    /* Check that the file's maximum size is valid */
+    if (hdr.max_size > fs_ctx->cfg->max_file_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (data_size != 0) {
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+        /* Check that the offset is aligned with the flash program unit */
+        if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+#endif
+
+        /* It is not permitted to create gaps in the file */
+        if (offset > hdr.cur_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Check that the new data is contained within the file's max size */
+        if (its_utils_check_contained_in(hdr.max_size, offset,
+                                         its_log_align(fs_ctx, data_size))
+            != PSA_SUCCESS) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Update the file's current size if required */
+        if (offset + data_size > hdr.cur_size) {
+            hdr.cur_size = offset + data_size;
+        }
+    }
+
+    /* Check the files still fit once the log is compacted */
+    new_reserved = its_log_record_size(fs_ctx, hdr.max_size);
+    if (fs_ctx->live_size - old_reserved + new_reserved
+        > its_log_capacity(fs_ctx)) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    if (file == NULL) {
+        /* Keep one index entry free, as the metadata block filesystem does */
+        file = its_log_alloc_file(fs_ctx, false);
+        if (file == NULL) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+    }
+
+    /* May move the source record while collecting garbage */
+    err = its_log_reserve(fs_ctx, its_log_record_size(fs_ctx, hdr.cur_size));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_log_append_record(fs_ctx, &hdr, src, offset, data_size, data,
+                                &rec_offset);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    (void)memcpy(file->id, hdr.id, ITS_FILE_ID_SIZE);
+    file->flags = hdr.flags;
+    file->cur_size = hdr.cur_size;
+    file->max_size = hdr.max_size;
+    file->block = fs_ctx->write_block;
+    file->offset = rec_offset;
+    fs_ctx->live_size = fs_ctx->live_size - old_reserved + new_reserved;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_delete(its_flash_fs_ctx_t *fs_ctx,
+                                      const uint8_t *fid)
+{
+    struct its_log_record_hdr_t hdr;
+    struct its_log_file_t *file;
+    size_t rec_offset;
+    psa_status_t err;
+
+    file = its_log_find_file(fs_ctx, fid);
+    if (file == NULL) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    err = its_log_reserve(fs_ctx, its_log_record_size(fs_ctx, 0));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    hdr.magic = ITS_LOG_RECORD_MAGIC;
+    hdr.flags = ITS_LOG_FLAG_DELETED;
+    hdr.cur_size = 0;
+    hdr.max_size = 0;
+    (void)memcpy(hdr.id, fid, ITS_FILE_ID_SIZE);
+
+    err = its_log_append_record(fs_ctx, &hdr, NULL, 0, 0, NULL, &rec_offset);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    fs_ctx->live_size -= its_log_record_size(fs_ctx, file->max_size);
+    (void)memset(file, 0, sizeof(*file));
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
+                                    const uint8_t *fid,
+                                    size_t size,
+                                    size_t offset,
+                                    uint8_t *data)
+{
+    struct its_log_file_t *file;
+    psa_status_t err;
+
+    file = its_log_find_file(fs_ctx, fid);
+    if (file == NULL) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    /* Boundary check the incoming request */
+    err = its_utils_check_contained_in(file->cur_size, offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (size == 0) {
+        return PSA_SUCCESS;
+    }
+
+    err = fs_ctx->ops->read(fs_ctx->cfg, file->block,
+                            data, file->offset
+                            + its_log_align(fs_ctx,
+                                            sizeof(struct its_log_record_hdr_t))
+                            + offset, size);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+
+psa_status_t its_flash_fs_file_count(its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *prefix,
+                                     size_t prefix_size,
+                                     uint32_t *num_files)
+{
+    const struct its_log_file_t *file = fs_ctx->cfg->file_index->file;
+    uint32_t i;
+
+    *num_files = 0;
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if ((its_utils_validate_fid(file[i].id) == PSA_SUCCESS) &&
+            !memcmp(file[i].id, prefix, prefix_size)) {
+            (*num_files)++;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_bulk_load(its_flash_fs_ctx_t *fs_ctx,
+                                    const struct its_flash_fs_bulk_file_t *files,
+                                    uint32_t num_files)
+{
+    (void)fs_ctx;
+    (void)files;
+    (void)num_files;
+
+    /* Every write is already appended to the log in sequence */
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+
+psa_status_t its_flash_fs_space_init(its_flash_fs_ctx_t *fs_ctx,
+                                     struct its_flash_fs_space_t *space)
+{
+    const struct its_log_file_t *file = fs_ctx->cfg->file_index->file;
+    uint32_t i;
+
+    space->lblock = 0;
+    space->free_size = (fs_ctx->live_size < its_log_capacity(fs_ctx)) ?
+                       its_log_capacity(fs_ctx) - fs_ctx->live_size : 0;
+
+    space->free_files = 0;
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if (its_utils_validate_fid(file[i].id) != PSA_SUCCESS) {
+            space->free_files++;
+        }
+    }
+
+    /* One index entry is kept free for new files */
+    if (space->free_files > 0) {
+        space->free_files--;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_space_reserve(its_flash_fs_ctx_t *fs_ctx,
+                                        struct its_flash_fs_space_t *space,
+                                        const uint8_t *fid,
+                                        size_t size)
+{
+    size_t record_size;
+
+    if (size > fs_ctx->cfg->max_file_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The old record of a replaced file is not counted as freed */
+    record_size = its_log_record_size(fs_ctx, size);
+    if (record_size > space->free_size) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    if (its_log_find_file(fs_ctx, fid) == NULL) {
+        if (space->free_files == 0) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+        space->free_files--;
+    }
+
+    space->free_size -= record_size;
+
+    return PSA_SUCCESS;
+}
+
+#endif /* ITS_FLASH_FS_LOG */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file  its_flash_fs_log.h
+ *
+ * \brief Internal definitions of the log-structured implementation of the
+ *        ITS flash filesystem.
+ *
+ * \details Files are stored as records appended to a ring of flash blocks.
+ *          Each record holds the complete content of a file, so a write
+ *          appends one new record and leaves the old one as garbage. When
+ *          the block being written is full, the next block in the ring is
+ *          opened and the oldest block is garbage collected into it. Blocks
+ *          are always used in ring order, which spreads the erases evenly
+ *          across the flash area.
+ */
+
+#ifndef __ITS_FLASH_FS_LOG_H__
+#define __ITS_FLASH_FS_LOG_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flash/its_flash.h"
+#include "its_flash_fs.h"
+#include "its_utils.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \def ITS_LOG_SUPPORTED_VERSION
+ *
+ * \brief Defines the supported version of the log-structured layout.
+ */
+#define ITS_LOG_SUPPORTED_VERSION  0x01
+
+/*!
+ * \struct its_log_file_t
+ *
+ * \brief Structure to store the attributes and the location of the latest
+ *        record of a file.
+ */
+struct its_log_file_t {
+    uint8_t id[ITS_FILE_ID_SIZE]; /*!< ID of this file, zero if unused */
+    uint32_t flags;               /*!< Flags set when the file was created */
+    uint32_t cur_size;            /*!< Current size of the file data */
+    uint32_t max_size;            /*!< Maximum size of this file */
+    uint32_t block;               /*!< Physical block of the latest record */
+    uint32_t offset;              /*!< Offset of the latest record in the
+                                   *   block
+                                   */
+};
+
+/**
+ * \struct its_flash_fs_file_index_t
+ *
+ * \brief Structure to store the RAM index of the files, rebuilt from the log
+ *        when the filesystem is prepared.
+ *
+ * \note The storage is provided by the filesystem user through
+ *       \ref its_flash_fs_config_t and is mandatory for this filesystem.
+ */
+struct its_flash_fs_file_index_t {
+    struct its_log_file_t *file; /**< Latest record of each file,
+                                  *   max_num_files entries
+                                  */
+};
+
+/**
+ * \def ITS_FLASH_FS_FILE_INDEX_DEFINE
+ *
+ * \brief Statically allocates a file index for a filesystem with the given
+ *        maximum number of files.
+ */
+#define ITS_FLASH_FS_FILE_INDEX_DEFINE(name, max_num_files) \
+    static struct its_log_file_t name##_file[max_num_files]; \
+    static struct its_flash_fs_file_index_t name = {         \
+        .file = name##_file,                                 \
+    }
+
+/**
+ * \struct its_flash_fs_ctx_t
+ *
+ * \brief Structure to store the ITS flash file system context.
+ */
+struct its_flash_fs_ctx_t {
+    const struct its_flash_fs_config_t *cfg; /**< Filesystem configuration */
+    const struct its_flash_fs_ops_t *ops;    /**< Filesystem flash operations */
+    uint32_t write_block;  /**< Block that new records are appended to */
+    uint32_t write_seq;    /**< Sequence number of the write block */
+    size_t write_offset;   /**< Offset of the next record in the write block */
+    size_t live_size;      /**< Flash space reserved by the existing files */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_FLASH_FS_LOG_H__ */
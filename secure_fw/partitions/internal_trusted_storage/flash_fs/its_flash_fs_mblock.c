@@ -1,13 +1,17 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include "config_tfm.h"
+
+#if !ITS_FLASH_FS_LOG && !ITS_RAM_OBJECT_STORE
+
 #include <string.h>
 
-#include "config_tfm.h"
+#include "cmsis_compiler.h"
 #include "its_flash_fs_mblock.h"
 #include "psa/storage_common.h"
 
@@ -149,6 +153,92 @@ static void its_mblock_swap_metablocks(struct its_flash_fs_ctx_t *fs_ctx)
     fs_ctx->active_metablock = tmp_block;
 }
 
+/**
+ * \brief Computes the position of a file ID in the file index hash table.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] fid     File ID
+ *
+ * \return Hash table position to start probing from
+ */
+static uint32_t its_mblock_file_index_hash(struct its_flash_fs_ctx_t *fs_ctx,
+                                           const uint8_t *fid)
+{
+    uint32_t hash = 0;
+    uint32_t i;
+
+    for (i = 0; i < ITS_FILE_ID_SIZE; i++) {
+        hash = (hash * 31U) + fid[i];
+    }
+
+    return hash % ITS_FILE_INDEX_NUM_SLOTS(fs_ctx->cfg->max_num_files);
+}
+
+/**
+ * \brief Marks the RAM file index as not matching the active metadata block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void its_mblock_invalidate_file_index(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    if (fs_ctx->cfg->file_index != NULL) {
+        fs_ctx->cfg->file_index->valid = false;
+    }
+}
+
+/**
+ * \brief Rebuilds the RAM file index from the active metadata block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \note If the file metadata cannot be read, the index is left invalid and
+ *       the file metadata continues to be read from flash.
+ */
+static void its_mblock_build_file_index(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    uint32_t num_slots;
+    uint32_t pos;
+    uint32_t i;
+
+    if (index == NULL) {
+        return;
+    }
+
+    /* Read the metadata table from flash, not from the stale index */
+    its_mblock_invalidate_file_index(fs_ctx);
+
+    num_slots = ITS_FILE_INDEX_NUM_SLOTS(fs_ctx->cfg->max_num_files);
+    for (i = 0; i < num_slots; i++) {
+        index->slot[i] = ITS_FILE_INDEX_EMPTY_SLOT;
+    }
+
+    for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
+        if (its_flash_fs_mblock_read_file_meta(fs_ctx, i, &index->file_meta[i])
+            != PSA_SUCCESS) {
+            return;
+        }
+
+        if ((its_utils_validate_fid(index->file_meta[i].id) != PSA_SUCCESS) ||
+            (index->file_meta[i].flags & ITS_FLASH_FS_FLAG_DELETE)) {
+            /* Free entries and files marked for deletion are not indexed */
+            continue;
+        }
+
+        /* The table has twice as many slots as files, so a free slot is always
+         * found. Files are inserted in index order so that a lookup returns
+         * the same entry as a linear search of the table.
+         */
+        pos = its_mblock_file_index_hash(fs_ctx, index->file_meta[i].id);
+        while (index->slot[pos] != ITS_FILE_INDEX_EMPTY_SLOT) {
+            pos = (pos + 1) % num_slots;
+        }
+        index->slot[pos] = (uint16_t)i;
+    }
+
+    index->valid = true;
+}
+
 /**
  * \brief Finds the potential most recent valid metablock.
  *
@@ -378,15 +468,18 @@ static psa_status_t its_mblock_validate_block_meta_comp(
  *
  * \param[in,out] fs_ctx      Filesystem context
  * \param[in] block_id        Metadata block ID
+ * \param[in] file_meta       Copy of the file metadata table of the block,
+ *                            or NULL to read it from the block
  *
  * \param[out] xor_value      XOR value based on all the medata in the block
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
 static psa_status_t its_mblock_calculate_metadata_xor(
-                                              struct its_flash_fs_ctx_t *fs_ctx,
-                                              uint32_t block_id,
-                                              uint8_t *xor_value)
+                                       struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t block_id,
+                                       const struct its_file_meta_t *file_meta,
+                                       uint8_t *xor_value)
 {
     uint32_t i, j;
     psa_status_t err;
@@ -417,12 +510,16 @@ static psa_status_t its_mblock_calculate_metadata_xor(
 
     /* Calculate the XOR value based on the file metadata. */
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
-        err = fs_ctx->ops->read(fs_ctx->cfg, block_id,
-                                metadata,
-                                its_mblock_file_meta_offset(fs_ctx, i),
-                                ITS_FILE_METADATA_SIZE);
-        if (err != PSA_SUCCESS) {
-            return err;
+        if (file_meta != NULL) {
+            memcpy(metadata, &file_meta[i], ITS_FILE_METADATA_SIZE);
+        } else {
+            err = fs_ctx->ops->read(fs_ctx->cfg, block_id,
+                                    metadata,
+                                    its_mblock_file_meta_offset(fs_ctx, i),
+                                    ITS_FILE_METADATA_SIZE);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
         }
 
         /* Update the XOR value. */
@@ -442,6 +539,11 @@ static psa_status_t its_mblock_calculate_metadata_xor(
  *
  * \param[in] block_id        Metadata block ID
  *
+ * \note If the filesystem has a file index, the block is made the active
+ *       metadata block and the index is built from it while the XOR is
+ *       checked, so that the file metadata table is read from flash once on
+ *       mount. The index is left invalid if the check fails.
+ *
  * \return Returns error code as specified in \ref psa_status_t
  */
 static psa_status_t its_mblock_validate_metadata_xor(
@@ -451,16 +553,27 @@ static psa_status_t its_mblock_validate_metadata_xor(
 {
     psa_status_t err;
     uint8_t xor_value;
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    const struct its_file_meta_t *file_meta = NULL;
+
+    if (index != NULL) {
+        fs_ctx->active_metablock = block_id;
+        its_mblock_build_file_index(fs_ctx);
+        if (index->valid) {
+            file_meta = index->file_meta;
+        }
+    }
 
-    err = its_mblock_calculate_metadata_xor(fs_ctx, block_id, &xor_value);
-    if (err != PSA_SUCCESS) {
-        return err;
+    err = its_mblock_calculate_metadata_xor(fs_ctx, block_id, file_meta,
+                                            &xor_value);
+    if ((err == PSA_SUCCESS) && (xor_value != h_meta->metadata_xor)) {
+        err = PSA_ERROR_STORAGE_FAILURE;
     }
 
-    if (xor_value != h_meta->metadata_xor) {
-        return PSA_ERROR_STORAGE_FAILURE;
+    if (err != PSA_SUCCESS) {
+        its_mblock_invalidate_file_index(fs_ctx);
     }
-    return PSA_SUCCESS;
+    return err;
 }
 #endif /* ITS_VALIDATE_METADATA_FROM_FLASH */
 
@@ -505,9 +618,59 @@ static uint32_t its_get_free_file_index(struct its_flash_fs_ctx_t *fs_ctx,
     return ITS_METADATA_INVALID_INDEX;
 }
 
+/**
+ * \brief Checks whether a block still reads as erased.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     block   Physical block ID
+ * \param[out]    erased  Set to true if all the bytes of the block read as
+ *                        erased
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_block_is_erased(
+                                              struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t block, bool *erased)
+{
+    psa_status_t err;
+    uint8_t buf[ITS_MAX_BLOCK_DATA_COPY];
+    size_t bytes_to_check;
+    size_t pos = 0;
+    size_t i;
+
+    *erased = false;
+
+    while (pos < fs_ctx->cfg->block_size) {
+        bytes_to_check = ITS_UTILS_MIN(fs_ctx->cfg->block_size - pos,
+                                       ITS_MAX_BLOCK_DATA_COPY);
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, block, buf, pos, bytes_to_check);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (i = 0; i < bytes_to_check; i++) {
+            if (buf[i] != fs_ctx->cfg->erase_val) {
+                return PSA_SUCCESS;
+            }
+        }
+
+        pos += bytes_to_check;
+    }
+
+    *erased = true;
+
+    return PSA_SUCCESS;
+}
+
 /**
  * \brief Erases data and meta scratch blocks.
  *
+ * \details Transactions that only update the metadata and the logical data
+ *          block 0 do not use the scratch data block. It is not erased again
+ *          if it has already been erased since it became the scratch block,
+ *          and nothing has been written to it since.
+ *
  * \param[in,out] fs_ctx  Filesystem context
  *
  * \return Returns error code as specified in \ref psa_status_t
@@ -517,6 +680,7 @@ static psa_status_t its_mblock_erase_scratch_blocks(
 {
     psa_status_t err;
     uint32_t scratch_datablock;
+    bool erased;
 
     /* For the atomicity of the data update process
      * and power-failure-safe operation, it is necessary that
@@ -527,6 +691,8 @@ static psa_status_t its_mblock_erase_scratch_blocks(
         return err;
     }
 
+    ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_META_ERASED);
+
     /* If the number of blocks is bigger than 2, the code needs to erase the
      * scratch block used to process any change in the data block which contains
      * only data. Otherwise, if the number of blocks is equal to 2, it means
@@ -536,12 +702,89 @@ static psa_status_t its_mblock_erase_scratch_blocks(
         scratch_datablock =
             its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
                                                     (ITS_LOGICAL_DBLOCK0 + 1));
+
+        if (fs_ctx->data_scratch_erased) {
+            err = its_mblock_block_is_erased(fs_ctx, scratch_datablock,
+                                             &erased);
+            if ((err != PSA_SUCCESS) || erased) {
+                return err;
+            }
+        }
+
+        fs_ctx->data_scratch_erased = false;
         err = fs_ctx->ops->erase(fs_ctx->cfg, scratch_datablock);
+        if (err == PSA_SUCCESS) {
+            fs_ctx->data_scratch_erased = true;
+        }
     }
 
     return err;
 }
 
+/**
+ * \brief Erases the scratch blocks left by the last update, if their erase
+ *        was deferred. It is called before anything is written to the
+ *        scratch blocks.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_erase_pending(struct its_flash_fs_ctx_t *fs_ctx)
+{
+#if ITS_DEFERRED_SCRATCH_ERASE
+    psa_status_t err;
+    bool is_scratch;
+    bool erased;
+
+    if (!fs_ctx->erase_pending) {
+        return PSA_SUCCESS;
+    }
+
+    /* The metadata scratch block is erased before the data block, as in
+     * its_mblock_erase_scratch_blocks().
+     */
+    err = fs_ctx->ops->erase(fs_ctx->cfg, fs_ctx->scratch_metablock);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_META_ERASED);
+
+    /* The update being started may already have swapped the scratch data
+     * block, so the block left by the last update is the one erased.
+     */
+    if (fs_ctx->erase_dblock != ITS_BLOCK_INVALID_ID) {
+        is_scratch = (fs_ctx->erase_dblock ==
+                      its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
+                                                    (ITS_LOGICAL_DBLOCK0 + 1)));
+        erased = false;
+        if (is_scratch && fs_ctx->data_scratch_erased) {
+            err = its_mblock_block_is_erased(fs_ctx, fs_ctx->erase_dblock,
+                                             &erased);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+
+        if (!erased) {
+            fs_ctx->data_scratch_erased = false;
+            err = fs_ctx->ops->erase(fs_ctx->cfg, fs_ctx->erase_dblock);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+            fs_ctx->data_scratch_erased = is_scratch;
+        }
+    }
+
+    fs_ctx->erase_pending = false;
+#else
+    (void)fs_ctx;
+#endif
+
+    return PSA_SUCCESS;
+}
+
 /**
  * \brief Updates scratch block meta.
  *
@@ -557,8 +800,14 @@ static psa_status_t its_mblock_update_scratch_block_meta(
                                       uint32_t lblock,
                                       const struct its_block_meta_t *block_meta)
 {
+    psa_status_t err;
     size_t pos;
 
+    err = its_mblock_erase_pending(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
     /* Calculate the position */
     pos = its_mblock_block_meta_offset(lblock);
     return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
@@ -704,14 +953,14 @@ static inline psa_status_t its_mblock_validate_fs_version(uint8_t fs_version,
  * \param[in,out] fs_ctx  Filesystem context
  * \param[in]     h_meta  Pointer to metadata block header
  *
- * \param[in] block_id    Metadata block ID
+ * \note The metadata XOR is not checked here, see
+ *       \ref its_init_get_active_metablock.
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
 static psa_status_t its_mblock_validate_header_meta(
-                               struct its_flash_fs_ctx_t *fs_ctx,
-                               const struct its_metadata_block_header_t *h_meta,
-                               uint32_t block_id)
+                              struct its_flash_fs_ctx_t *fs_ctx,
+                              const struct its_metadata_block_header_t *h_meta)
 {
     psa_status_t err;
     bool backward_compatible = false;
@@ -727,12 +976,6 @@ static psa_status_t its_mblock_validate_header_meta(
         ((struct its_metadata_block_header_comp_t *)h_meta)->active_swap_count);
     } else {
         err = its_mblock_validate_swap_count(fs_ctx, h_meta->active_swap_count);
-        if (err != PSA_SUCCESS) {
-            return err;
-        }
-#if ITS_VALIDATE_METADATA_FROM_FLASH
-        err = its_mblock_validate_metadata_xor(fs_ctx, h_meta, block_id);
-#endif
     }
     return err;
 }
@@ -749,6 +992,11 @@ static psa_status_t its_mblock_write_scratch_meta_header(
 {
     psa_status_t err;
 
+    err = its_mblock_erase_pending(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
     /* Increment the swap count */
     fs_ctx->meta_block_header.active_swap_count++;
 
@@ -761,7 +1009,7 @@ static psa_status_t its_mblock_write_scratch_meta_header(
 #if ITS_VALIDATE_METADATA_FROM_FLASH
     /* Calculate metadata XOR value. */
     err = its_mblock_calculate_metadata_xor(fs_ctx,
-                                       fs_ctx->scratch_metablock,
+                                       fs_ctx->scratch_metablock, NULL,
                                        &fs_ctx->meta_block_header.metadata_xor);
     if (err != PSA_SUCCESS) {
         return err;
@@ -856,8 +1104,7 @@ static psa_status_t its_mblock_read_meta_header(
         return err;
     }
 
-    return its_mblock_validate_header_meta(fs_ctx, &fs_ctx->meta_block_header,
-                                           fs_ctx->active_metablock);
+    return its_mblock_validate_header_meta(fs_ctx, &fs_ctx->meta_block_header);
 }
 
 /**
@@ -907,11 +1154,47 @@ static psa_status_t its_mblock_reserve_file(struct its_flash_fs_ctx_t *fs_ctx,
     return PSA_ERROR_INSUFFICIENT_STORAGE;
 }
 
+/**
+ * \brief Checks the metadata XOR of a metadata block, if it is stored in the
+ *        header version of the block.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     h_meta    Pointer to metadata block header
+ * \param[in]     block_id  Metadata block ID
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_validate_metablock(
+                               struct its_flash_fs_ctx_t *fs_ctx,
+                               const struct its_metadata_block_header_t *h_meta,
+                               uint32_t block_id)
+{
+#if ITS_VALIDATE_METADATA_FROM_FLASH
+    bool backward_compatible = false;
+
+    (void)its_mblock_validate_fs_version(h_meta->fs_version,
+                                         &backward_compatible);
+    if (!backward_compatible) {
+        return its_mblock_validate_metadata_xor(fs_ctx, h_meta, block_id);
+    }
+#else
+    (void)fs_ctx;
+    (void)h_meta;
+    (void)block_id;
+#endif
+    return PSA_SUCCESS;
+}
+
 /**
  * \brief Validates and find the valid-active metablock
  *
  * \param[in,out] fs_ctx  Filesystem context
  *
+ * \note The headers of both metadata blocks are validated, but the metadata
+ *       XOR is only checked for the most recent block. The metadata of the
+ *       other block is only read if the most recent one is corrupted, which
+ *       keeps the mount time to a single pass over the metadata table.
+ *
  * \return Returns value as specified in \ref psa_status_t
  */
 static psa_status_t its_init_get_active_metablock(
@@ -919,8 +1202,7 @@ static psa_status_t its_init_get_active_metablock(
 {
     uint32_t cur_meta_block = ITS_BLOCK_INVALID_ID;
     psa_status_t err;
-    struct its_metadata_block_header_t h_meta0;
-    struct its_metadata_block_header_t h_meta1;
+    struct its_metadata_block_header_t h_meta[2];
     uint8_t num_valid_meta_blocks = 0;
 
     /* First two blocks are reserved for metadata */
@@ -930,20 +1212,24 @@ static psa_status_t its_init_get_active_metablock(
      * update was incomplete
      */
     err = fs_ctx->ops->read(fs_ctx->cfg, ITS_METADATA_BLOCK0,
-                            (uint8_t *)&h_meta0, 0, ITS_BLOCK_META_HEADER_SIZE);
+                            (uint8_t *)&h_meta[ITS_METADATA_BLOCK0], 0,
+                            ITS_BLOCK_META_HEADER_SIZE);
     if (err == PSA_SUCCESS) {
-        if (its_mblock_validate_header_meta(fs_ctx, &h_meta0,
-                                        ITS_METADATA_BLOCK0) == PSA_SUCCESS) {
+        if (its_mblock_validate_header_meta(fs_ctx,
+                                            &h_meta[ITS_METADATA_BLOCK0])
+            == PSA_SUCCESS) {
             num_valid_meta_blocks++;
             cur_meta_block = ITS_METADATA_BLOCK0;
         }
     }
 
     err = fs_ctx->ops->read(fs_ctx->cfg, ITS_METADATA_BLOCK1,
-                            (uint8_t *)&h_meta1, 0, ITS_BLOCK_META_HEADER_SIZE);
+                            (uint8_t *)&h_meta[ITS_METADATA_BLOCK1], 0,
+                            ITS_BLOCK_META_HEADER_SIZE);
     if (err == PSA_SUCCESS) {
-        if (its_mblock_validate_header_meta(fs_ctx, &h_meta1,
-                                        ITS_METADATA_BLOCK1) == PSA_SUCCESS) {
+        if (its_mblock_validate_header_meta(fs_ctx,
+                                            &h_meta[ITS_METADATA_BLOCK1])
+            == PSA_SUCCESS) {
             num_valid_meta_blocks++;
             cur_meta_block = ITS_METADATA_BLOCK1;
         }
@@ -954,12 +1240,29 @@ static psa_status_t its_init_get_active_metablock(
      * need to find out which one is potentially latest metablock.
      */
     if (num_valid_meta_blocks > 1) {
-        cur_meta_block = its_mblock_latest_meta_block(fs_ctx, &h_meta0,
-                                                      &h_meta1);
+        cur_meta_block = its_mblock_latest_meta_block(fs_ctx,
+                                                 &h_meta[ITS_METADATA_BLOCK0],
+                                                 &h_meta[ITS_METADATA_BLOCK1]);
     } else if (num_valid_meta_blocks == 0) {
         return PSA_ERROR_GENERIC_ERROR;
     }
 
+    err = its_mblock_validate_metablock(fs_ctx, &h_meta[cur_meta_block],
+                                        cur_meta_block);
+    if (err != PSA_SUCCESS) {
+        /* Fall back to the other block if its header is also valid */
+        if (num_valid_meta_blocks == 1) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        cur_meta_block = ITS_OTHER_META_BLOCK(cur_meta_block);
+        err = its_mblock_validate_metablock(fs_ctx, &h_meta[cur_meta_block],
+                                            cur_meta_block);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
     fs_ctx->active_metablock = cur_meta_block;
     fs_ctx->scratch_metablock = ITS_OTHER_META_BLOCK(cur_meta_block);
 
@@ -973,6 +1276,27 @@ psa_status_t its_flash_fs_mblock_cp_file_meta(struct its_flash_fs_ctx_t *fs_ctx,
     /* Calculate the positions of the two indexes in the metadata block */
     size_t pos_start = its_mblock_file_meta_offset(fs_ctx, idx_start);
     size_t pos_end = its_mblock_file_meta_offset(fs_ctx, idx_end);
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    psa_status_t err;
+
+    if (pos_end == pos_start) {
+        return PSA_SUCCESS;
+    }
+
+    err = its_mblock_erase_pending(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The file index holds a copy of the active file metadata table with the
+     * same layout, so program the entries from RAM instead of reading them
+     * back from the active metadata block.
+     */
+    if ((index != NULL) && index->valid) {
+        return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
+                                  (const uint8_t *)&index->file_meta[idx_start],
+                                  pos_start, pos_end - pos_start);
+    }
 
     /* Copy all data between the two positions from the scratch metadata block
      * to the active metadata block.
@@ -998,10 +1322,47 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
                                                    const uint8_t *fid,
                                                    uint32_t *idx,
                                                    struct its_file_meta_t *file_meta)
+{
+    return its_flash_fs_mblock_get_file_extent_idx_meta(fs_ctx, fid, 0, idx,
+                                                        file_meta);
+}
+
+psa_status_t its_flash_fs_mblock_get_file_extent_idx_meta(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            const uint8_t *fid,
+                                            uint32_t extent,
+                                            uint32_t *idx,
+                                            struct its_file_meta_t *file_meta)
 {
     psa_status_t err;
     uint32_t i;
+    uint32_t pos;
+    uint32_t num_slots;
     struct its_file_meta_t tmp_metadata;
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+
+    if ((index != NULL) && index->valid &&
+        (its_utils_validate_fid(fid) == PSA_SUCCESS)) {
+        num_slots = ITS_FILE_INDEX_NUM_SLOTS(fs_ctx->cfg->max_num_files);
+        pos = its_mblock_file_index_hash(fs_ctx, fid);
+
+        while (index->slot[pos] != ITS_FILE_INDEX_EMPTY_SLOT) {
+            i = index->slot[pos];
+            if (!memcmp(index->file_meta[i].id, fid, ITS_FILE_ID_SIZE) &&
+                (ITS_FLASH_FS_EXTENT_NUM(index->file_meta[i].flags) ==
+                 extent)) {
+                /* Found */
+                *idx = i;
+                if (file_meta != NULL) {
+                    *file_meta = index->file_meta[i];
+                }
+                return PSA_SUCCESS;
+            }
+            pos = (pos + 1) % num_slots;
+        }
+
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
 
     for (i = 0; i < fs_ctx->cfg->max_num_files; i++) {
         err = its_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
@@ -1009,8 +1370,12 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
             return PSA_ERROR_GENERIC_ERROR;
         }
 
-        /* ID with value 0x00 means end of file meta section */
-        if (!memcmp(tmp_metadata.id, fid, ITS_FILE_ID_SIZE)) {
+        /* ID with value 0x00 means end of file meta section. A file marked
+         * for deletion may share its ID with the file that replaced it.
+         */
+        if (!memcmp(tmp_metadata.id, fid, ITS_FILE_ID_SIZE) &&
+            !(tmp_metadata.flags & ITS_FLASH_FS_FLAG_DELETE) &&
+            (ITS_FLASH_FS_EXTENT_NUM(tmp_metadata.flags) == extent)) {
             /* Found */
             *idx = i;
             if (file_meta != NULL) {
@@ -1052,6 +1417,8 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
 {
     psa_status_t err;
 
+    its_mblock_invalidate_file_index(fs_ctx);
+
     /* Initialize Flash Interface */
     err = fs_ctx->ops->init(fs_ctx->cfg);
     if (err != PSA_SUCCESS) {
@@ -1069,15 +1436,32 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
     }
 
     /* Erase the other scratch metadata block. It can be used in the later
-     * step.
+     * step. An erase interrupted by a power failure can leave a block that
+     * reads as erased, so the scratch data block is always erased here.
      */
+    fs_ctx->data_scratch_erased = false;
+#if ITS_DEFERRED_SCRATCH_ERASE
+    fs_ctx->erase_pending = false;
+#endif
     err = its_mblock_erase_scratch_blocks(fs_ctx);
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
     }
 
     /* Upgrade the metadata header if required. */
-    return its_mblock_upgrade_meta_header(fs_ctx);
+    err = its_mblock_upgrade_meta_header(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The file index may already have been built while the active metadata
+     * block was validated.
+     */
+    if ((fs_ctx->cfg->file_index != NULL) && !fs_ctx->cfg->file_index->valid) {
+        its_mblock_build_file_index(fs_ctx);
+    }
+
+    return PSA_SUCCESS;
 }
 
 psa_status_t its_flash_fs_mblock_meta_update_finalize(
@@ -1085,23 +1469,43 @@ psa_status_t its_flash_fs_mblock_meta_update_finalize(
 {
     psa_status_t err;
 
+    ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_META_WRITTEN);
+
     /* Write the metadata block header to flash */
     err = its_mblock_write_scratch_meta_header(fs_ctx);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
+    ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_HEADER_WRITTEN);
+
     /* Commit metadata block modifications to flash */
     err = fs_ctx->ops->flush(fs_ctx->cfg, fs_ctx->scratch_metablock);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
+    ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_META_COMMITTED);
+
     /* Update the running context */
     its_mblock_swap_metablocks(fs_ctx);
+    its_mblock_build_file_index(fs_ctx);
+
+#if ITS_DEFERRED_SCRATCH_ERASE
+    /* The new state is committed. The erase is left to the next update, so
+     * that the requests queued behind this one do not wait for it.
+     */
+    fs_ctx->erase_pending = true;
+    fs_ctx->erase_dblock = (fs_ctx->cfg->num_blocks > 2) ?
+                           its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
+                                                    (ITS_LOGICAL_DBLOCK0 + 1)) :
+                           ITS_BLOCK_INVALID_ID;
 
+    return PSA_SUCCESS;
+#else
     /* Erase meta block and current scratch block */
     return its_mblock_erase_scratch_blocks(fs_ctx);
+#endif
 }
 
 psa_status_t its_flash_fs_mblock_migrate_lb0_data_to_scratch(
@@ -1134,6 +1538,12 @@ psa_status_t its_flash_fs_mblock_read_file_meta(
 {
     psa_status_t err;
     size_t offset;
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+
+    if ((index != NULL) && index->valid) {
+        *file_meta = index->file_meta[idx];
+        return PSA_SUCCESS;
+    }
 
     offset = its_mblock_file_meta_offset(fs_ctx, idx);
     err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
@@ -1236,11 +1646,16 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
         metablock_to_erase_first = fs_ctx->scratch_metablock;
     }
 
+    /* The index may have been built from the metadata block being erased */
+    its_mblock_invalidate_file_index(fs_ctx);
+
     err = fs_ctx->ops->erase(fs_ctx->cfg, metablock_to_erase_first);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
+    ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_RESET_ERASED);
+
     err = fs_ctx->ops->erase(fs_ctx->cfg,
                              ITS_OTHER_META_BLOCK(metablock_to_erase_first));
     if (err != PSA_SUCCESS) {
@@ -1250,6 +1665,11 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
     fs_ctx->meta_block_header.active_swap_count =
                                     (fs_ctx->cfg->erase_val == 0x00U) ? 1U : 0U;
     fs_ctx->meta_block_header.scratch_dblock = its_init_scratch_dblock(fs_ctx);
+    fs_ctx->data_scratch_erased = false;
+#if ITS_DEFERRED_SCRATCH_ERASE
+    /* All the blocks are erased by the reset */
+    fs_ctx->erase_pending = false;
+#endif
     fs_ctx->meta_block_header.fs_version = ITS_SUPPORTED_VERSION;
     fs_ctx->scratch_metablock = ITS_METADATA_BLOCK1;
     fs_ctx->active_metablock = ITS_METADATA_BLOCK0;
@@ -1326,6 +1746,7 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
 
     /* Swap active and scratch metablocks */
     its_mblock_swap_metablocks(fs_ctx);
+    its_mblock_build_file_index(fs_ctx);
 
     return PSA_SUCCESS;
 }
@@ -1334,6 +1755,9 @@ void its_flash_fs_mblock_set_data_scratch(struct its_flash_fs_ctx_t *fs_ctx,
                                           uint32_t phy_id, uint32_t lblock)
 {
     if (lblock != ITS_LOGICAL_DBLOCK0) {
+        if (fs_ctx->meta_block_header.scratch_dblock != phy_id) {
+            fs_ctx->data_scratch_erased = false;
+        }
         fs_ctx->meta_block_header.scratch_dblock = phy_id;
     }
 }
@@ -1361,13 +1785,35 @@ psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
     return its_mblock_copy_remaining_block_meta(fs_ctx, lblock);
 }
 
+psa_status_t its_flash_fs_mblock_write_scratch_block_meta(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t lblock,
+                                            struct its_block_meta_t *block_meta)
+{
+    /* If the block is the logical block 0, then update the physical ID to the
+     * current scratch metadata block so that it is correct after the metadata
+     * blocks are swapped.
+     */
+    if (lblock == ITS_LOGICAL_DBLOCK0) {
+        block_meta->phy_id = fs_ctx->scratch_metablock;
+    }
+
+    return its_mblock_update_scratch_block_meta(fs_ctx, lblock, block_meta);
+}
+
 psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
                                         struct its_flash_fs_ctx_t *fs_ctx,
                                         uint32_t idx,
                                         const struct its_file_meta_t *file_meta)
 {
+    psa_status_t err;
     size_t pos;
 
+    err = its_mblock_erase_pending(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
     /* Calculate the position */
     pos = its_mblock_file_meta_offset(fs_ctx, idx);
     return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
@@ -1386,6 +1832,12 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
     size_t bytes_to_move;
     uint8_t dst_block_data_copy[ITS_MAX_BLOCK_DATA_COPY];
 
+    /* The destination is a scratch block */
+    status = its_mblock_erase_pending(fs_ctx);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
     while (size > 0) {
         /* Calculates the number of bytes to move */
         bytes_to_move = ITS_UTILS_MIN(size, ITS_MAX_BLOCK_DATA_COPY);
@@ -1406,6 +1858,8 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
             return status;
         }
 
+        ITS_FLASH_FS_FAULT_POINT(fs_ctx->cfg, ITS_FLASH_FS_FAULT_DATA_MOVED);
+
         /* Updates pointers to the source and destination flash regions */
         dst_offset += bytes_to_move;
         src_offset += bytes_to_move;
@@ -1416,3 +1870,5 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
 
     return PSA_SUCCESS;
 }
+
+#endif /* !ITS_FLASH_FS_LOG && !ITS_RAM_OBJECT_STORE */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -16,6 +16,9 @@
 #include "its_flash_fs.h"
 #include "its_utils.h"
 #include "psa/error.h"
+#if ITS_ENCRYPTION
+#include "tfm_hal_its_encryption.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +52,55 @@ extern "C" {
  */
 #define ITS_LOGICAL_DBLOCK0  0
 
+/*!
+ * \def ITS_FLASH_FS_FLAG_DELETE
+ *
+ * \brief Filesystem-internal flag that indicates the file is to be deleted in
+ *        a later block update. A file with this flag set is not found by its
+ *        file ID.
+ */
+#define ITS_FLASH_FS_FLAG_DELETE  (1U << 24)
+
+/*!
+ * \def ITS_FLASH_FS_EXTENT_POS
+ *
+ * \brief Position of the extent number in the flags of a file. A file that
+ *        does not fit in one data block is stored as several extents, which
+ *        share its file ID and are numbered from 0.
+ */
+#define ITS_FLASH_FS_EXTENT_POS   25
+
+/*!
+ * \def ITS_FLASH_FS_EXTENT_MASK
+ *
+ * \brief Mask of the extent number in the flags of a file.
+ */
+#define ITS_FLASH_FS_EXTENT_MASK  (0x3FU << ITS_FLASH_FS_EXTENT_POS)
+
+/*!
+ * \def ITS_FLASH_FS_EXTENT_NUM
+ *
+ * \brief Gets the extent number from the flags of a file.
+ */
+#define ITS_FLASH_FS_EXTENT_NUM(flags) \
+    (((flags) & ITS_FLASH_FS_EXTENT_MASK) >> ITS_FLASH_FS_EXTENT_POS)
+
+/*!
+ * \def ITS_FLASH_FS_FLAG_EXTENT_NEXT
+ *
+ * \brief Filesystem-internal flag that indicates the file continues in the
+ *        next extent.
+ */
+#define ITS_FLASH_FS_FLAG_EXTENT_NEXT  (1U << 31)
+
+/*!
+ * \def ITS_FLASH_FS_MAX_EXTENTS
+ *
+ * \brief Maximum number of extents that the flags of a file can number.
+ */
+#define ITS_FLASH_FS_MAX_EXTENTS \
+    ((ITS_FLASH_FS_EXTENT_MASK >> ITS_FLASH_FS_EXTENT_POS) + 1U)
+
 /*!
  * \struct its_metadata_block_header_t
  *
@@ -150,6 +202,14 @@ struct its_block_meta_t {
  * \note This structure is programmed to flash, so its size must be padded
  *       to a multiple of the maximum required flash program unit.
  */
+#if ITS_ENCRYPTION
+#define _T3_NONCE \
+    uint8_t nonce[TFM_HAL_ITS_ENCRYPTION_NONCE_SIZE]; /*!< Nonce of the \
+                                                       *   encrypted file data \
+                                                       */
+#else
+#define _T3_NONCE
+#endif
 #define _T3 \
     uint32_t lblock;               /*!< Logical datablock where file is \
                                     *   stored \
@@ -160,7 +220,8 @@ struct its_block_meta_t {
                                     */ \
     size_t max_size;               /*!< Maximum size of this file */ \
     uint32_t flags;                /*!< Flags set when the file was created */ \
-    uint8_t id[ITS_FILE_ID_SIZE];  /*!< ID of this file */
+    uint8_t id[ITS_FILE_ID_SIZE];  /*!< ID of this file */ \
+    _T3_NONCE
 
 struct its_file_meta_t {
     _T3
@@ -170,6 +231,59 @@ struct its_file_meta_t {
 #endif
 };
 #undef _T3
+#undef _T3_NONCE
+
+/*!
+ * \def ITS_FILE_INDEX_EMPTY_SLOT
+ *
+ * \brief Value of an unused entry in the file index hash table.
+ */
+#define ITS_FILE_INDEX_EMPTY_SLOT 0xFFFFU
+
+/*!
+ * \def ITS_FILE_INDEX_NUM_SLOTS
+ *
+ * \brief Number of hash table entries the file index needs for the given
+ *        maximum number of files.
+ */
+#define ITS_FILE_INDEX_NUM_SLOTS(max_num_files) (2U * (max_num_files))
+
+/**
+ * \struct its_flash_fs_file_index_t
+ *
+ * \brief Structure to store a RAM copy of the file metadata table of the
+ *        active metadata block, indexed by file ID.
+ *
+ * \note The storage is provided by the filesystem user through
+ *       \ref its_flash_fs_config_t. The index is rebuilt from flash every
+ *       time a new metadata block becomes active. While it is not valid, the
+ *       file metadata is read from flash.
+ */
+struct its_flash_fs_file_index_t {
+    struct its_file_meta_t *file_meta; /**< Copy of the file metadata table,
+                                        *   max_num_files entries
+                                        */
+    uint16_t *slot;  /**< Open addressing hash table of file indexes,
+                      *   ITS_FILE_INDEX_NUM_SLOTS(max_num_files) entries
+                      */
+    bool valid;      /**< True if the index matches the active metadata
+                      *   block
+                      */
+};
+
+/**
+ * \def ITS_FLASH_FS_FILE_INDEX_DEFINE
+ *
+ * \brief Statically allocates a file index for a filesystem with the given
+ *        maximum number of files.
+ */
+#define ITS_FLASH_FS_FILE_INDEX_DEFINE(name, max_num_files)               \
+    static struct its_file_meta_t name##_meta[max_num_files];             \
+    static uint16_t name##_slot[ITS_FILE_INDEX_NUM_SLOTS(max_num_files)]; \
+    static struct its_flash_fs_file_index_t name = {                      \
+        .file_meta = name##_meta,                                         \
+        .slot = name##_slot,                                              \
+    }
 
 /**
  * \struct its_flash_fs_ctx_t
@@ -184,6 +298,17 @@ struct its_flash_fs_ctx_t {
                                                            */
     uint32_t active_metablock;  /**< Active metadata block */
     uint32_t scratch_metablock; /**< Scratch metadata block */
+    bool data_scratch_erased;   /**< The scratch data block has been erased
+                                 *   since it became the scratch block
+                                 */
+#if ITS_DEFERRED_SCRATCH_ERASE
+    bool erase_pending;         /**< The scratch blocks left by the last
+                                 *   update are not erased yet
+                                 */
+    uint32_t erase_dblock;      /**< Scratch data block left by the last
+                                 *   update, or ITS_BLOCK_INVALID_ID
+                                 */
+#endif
 };
 
 /**
@@ -237,6 +362,28 @@ psa_status_t its_flash_fs_mblock_get_file_idx_meta(struct its_flash_fs_ctx_t *fs
                                                    const uint8_t *fid,
                                                    uint32_t *idx,
                                                    struct its_file_meta_t *file_meta);
+
+/**
+ * \brief Gets the file metadata entry index and file metadata of an extent of
+ *        a file.
+ *
+ * \note  A NULL [file_meta] indicates ignoring file meta.
+ *
+ * \param[in,out]       fs_ctx      Filesystem context
+ * \param[in]           fid         ID of the file
+ * \param[in]           extent      Number of the extent
+ * \param[out]          idx         Index of the file metadata in the file system
+ * \param[out]          file_meta   Pointer to file meta structure
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_get_file_extent_idx_meta(
+                                            struct its_flash_fs_ctx_t *fs_ctx,
+                                            const uint8_t *fid,
+                                            uint32_t extent,
+                                            uint32_t *idx,
+                                            struct its_file_meta_t *file_meta);
+
 /**
  * \brief Gets file metadata entry index of the first file with one of the
  *        provided flags set.
@@ -382,6 +529,24 @@ psa_status_t its_flash_fs_mblock_update_scratch_block_meta(
                                            uint32_t lblock,
                                            struct its_block_meta_t *block_meta);
 
+/**
+ * \brief Puts the metadata of one logical block in scratch metadata block,
+ *        without copying the metadata of the other logical blocks.
+ *
+ * \note The caller must put the metadata of every logical block in the
+ *       scratch metadata block before the metadata update is finalized.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     lblock      Logical block number
+ * \param[in]     block_meta  Pointer to block's metadata
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_write_scratch_block_meta(
+                                           struct its_flash_fs_ctx_t *fs_ctx,
+                                           uint32_t lblock,
+                                           struct its_block_meta_t *block_meta);
+
 /**
  * \brief Writes a file metadata entry into scratch metadata block.
  *
@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "config_tfm.h"
+
+#if ITS_RAM_OBJECT_STORE
+
+#if ITS_ENCRYPTION
+#error "ITS_RAM_OBJECT_STORE is not supported with ITS_ENCRYPTION"
+#endif
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "its_flash_fs.h"
+#include "its_utils.h"
+
+/* Filesystem-internal flags, which cannot be passed by the caller */
+#define ITS_FLASH_FS_INTERNAL_FLAGS_MASK  (UINT32_MAX - ((1U << 24) - 1))
+
+static size_t its_ram_align(const struct its_flash_fs_ctx_t *fs_ctx,
+                            size_t size)
+{
+    return ITS_UTILS_ALIGN(size, fs_ctx->cfg->program_unit);
+}
+
+static uint32_t its_ram_num_slots(const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return ITS_FILE_INDEX_NUM_SLOTS(fs_ctx->cfg->max_num_files);
+}
+
+/**
+ * \brief Computes the position of a file ID in the file index hash table.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] fid     File ID
+ *
+ * \return Hash table position to start probing from
+ */
+static uint32_t its_ram_hash(const struct its_flash_fs_ctx_t *fs_ctx,
+                             const uint8_t *fid)
+{
+    uint32_t hash = 0;
+    uint32_t i;
+
+    for (i = 0; i < ITS_FILE_ID_SIZE; i++) {
+        hash = (hash * 31U) + fid[i];
+    }
+
+    return hash % its_ram_num_slots(fs_ctx);
+}
+
+/**
+ * \brief Finds the hash table entry of a file.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] fid     File ID
+ *
+ * \return Position of the entry in the hash table, or the number of entries
+ *         if the file does not exist. The table has twice as many entries as
+ *         files, so probing always ends on an empty entry.
+ */
+static uint32_t its_ram_find_slot(const struct its_flash_fs_ctx_t *fs_ctx,
+                                  const uint8_t *fid)
+{
+    const struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    uint32_t num_slots = its_ram_num_slots(fs_ctx);
+    uint32_t pos = its_ram_hash(fs_ctx, fid);
+
+    while (index->slot[pos] != ITS_FILE_INDEX_EMPTY_SLOT) {
+        if (!memcmp(index->file[index->slot[pos]].id, fid, ITS_FILE_ID_SIZE)) {
+            return pos;
+        }
+        pos = (pos + 1) % num_slots;
+    }
+
+    return num_slots;
+}
+
+/**
+ * \brief Adds a file to the hash table.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     idx     Index of the file
+ */
+static void its_ram_insert_slot(struct its_flash_fs_ctx_t *fs_ctx,
+                                uint32_t idx)
+{
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    uint32_t num_slots = its_ram_num_slots(fs_ctx);
+    uint32_t pos = its_ram_hash(fs_ctx, index->file[idx].id);
+
+    while (index->slot[pos] != ITS_FILE_INDEX_EMPTY_SLOT) {
+        pos = (pos + 1) % num_slots;
+    }
+    index->slot[pos] = (uint16_t)idx;
+}
+
+/**
+ * \brief Removes an entry from the hash table. The entries that follow it in
+ *        the same probe sequence are shifted back, so that no lookup stops
+ *        early on the freed entry.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     pos     Position of the entry in the hash table
+ */
+static void its_ram_remove_slot(struct its_flash_fs_ctx_t *fs_ctx,
+                                uint32_t pos)
+{
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    uint32_t num_slots = its_ram_num_slots(fs_ctx);
+    uint32_t next = (pos + 1) % num_slots;
+    uint32_t home;
+    bool move;
+
+    index->slot[pos] = ITS_FILE_INDEX_EMPTY_SLOT;
+
+    while (index->slot[next] != ITS_FILE_INDEX_EMPTY_SLOT) {
+        home = its_ram_hash(fs_ctx, index->file[index->slot[next]].id);
+
+        /* The entry can move to the freed position unless its home position
+         * lies cyclically after the freed position, up to its own position.
+         */
+        if (pos <= next) {
+            move = (home <= pos) || (home > next);
+        } else {
+            move = (home <= pos) && (home > next);
+        }
+
+        if (move) {
+            index->slot[pos] = index->slot[next];
+            index->slot[next] = ITS_FILE_INDEX_EMPTY_SLOT;
+            pos = next;
+        }
+
+        next = (next + 1) % num_slots;
+    }
+}
+
+/**
+ * \brief Deletes a file and packs the data of the files stored after it.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     pos     Position of the file in the hash table
+ */
+static void its_ram_delete(struct its_flash_fs_ctx_t *fs_ctx, uint32_t pos)
+{
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    uint32_t idx = index->slot[pos];
+    uint32_t last = fs_ctx->num_files - 1;
+    uint32_t offset = index->file[idx].offset;
+    uint32_t size = index->file[idx].max_size;
+    uint32_t i;
+
+    its_ram_remove_slot(fs_ctx, pos);
+
+    (void)memmove(fs_ctx->data + offset, fs_ctx->data + offset + size,
+                  fs_ctx->used_size - offset - size);
+    fs_ctx->used_size -= size;
+
+    for (i = 0; i < fs_ctx->num_files; i++) {
+        if (index->file[i].offset > offset) {
+            index->file[i].offset -= size;
+        }
+    }
+
+    /* Keep the files in use at the start of the table */
+    if (idx != last) {
+        index->file[idx] = index->file[last];
+        index->slot[its_ram_find_slot(fs_ctx, index->file[idx].id)] =
+            (uint16_t)idx;
+    }
+    (void)memset(&index->file[last], 0, sizeof(index->file[last]));
+
+    fs_ctx->num_files--;
+}
+
+/**
+ * \brief Empties the RAM store.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void its_ram_reset(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    uint32_t i;
+
+    for (i = 0; i < its_ram_num_slots(fs_ctx); i++) {
+        index->slot[i] = ITS_FILE_INDEX_EMPTY_SLOT;
+    }
+    (void)memset(index->file, 0,
+                 fs_ctx->cfg->max_num_files * sizeof(struct its_ram_file_t));
+
+    fs_ctx->num_files = 0;
+    fs_ctx->used_size = 0;
+}
+
+psa_status_t its_flash_fs_init_ctx(its_flash_fs_ctx_t *fs_ctx,
+                                   const struct its_flash_fs_config_t *fs_cfg,
+                                   const struct its_flash_fs_ops_t *fs_ops)
+{
+    if (!fs_ctx || !fs_cfg || !fs_ops) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The files are only held by the index, in RAM */
+    if ((fs_cfg->file_index == NULL) || (fs_cfg->max_num_files == 0) ||
+        (ITS_FILE_INDEX_NUM_SLOTS(fs_cfg->max_num_files)
+         > ITS_FILE_INDEX_EMPTY_SLOT)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((fs_cfg->program_unit == 0) ||
+        ((fs_cfg->program_unit & (fs_cfg->program_unit - 1)) != 0)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Zero the context */
+    memset(fs_ctx, 0, sizeof(*fs_ctx));
+
+    /* Associate the filesystem config and operations with the context */
+    fs_ctx->cfg = fs_cfg;
+    fs_ctx->ops = fs_ops;
+
+    /* The RAM area emulating the flash is used as it is */
+    fs_ctx->data = (uint8_t *)fs_cfg->flash_dev;
+    fs_ctx->data_size = (size_t)fs_cfg->num_blocks * fs_cfg->block_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_prepare(its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+
+    err = fs_ctx->ops->init(fs_ctx->cfg);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Nothing is left from before the reset */
+    its_ram_reset(fs_ctx);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_wipe_all(its_flash_fs_ctx_t *fs_ctx)
+{
+    its_ram_reset(fs_ctx);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_get_info(its_flash_fs_ctx_t *fs_ctx,
+                                        const uint8_t *fid,
+                                        struct its_file_info_t *info)
+{
+    const struct its_ram_file_t *file;
+    uint32_t pos;
+
+    pos = its_ram_find_slot(fs_ctx, fid);
+    if (pos == its_ram_num_slots(fs_ctx)) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    file = &fs_ctx->cfg->file_index->file[fs_ctx->cfg->file_index->slot[pos]];
+    info->size_max = file->max_size;
+    info->size_current = file->cur_size;
+    info->flags = file->flags & ITS_FLASH_FS_USER_FLAGS_MASK;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_write(its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *fid,
+                                     uint32_t flags,
+                                     size_t max_size,
+                                     size_t data_size,
+                                     size_t offset,
+                                     const uint8_t *data)
+{
+    struct its_flash_fs_file_index_t *index = fs_ctx->cfg->file_index;
+    struct its_ram_file_t *file = NULL;
+    uint32_t new_flags;
+    size_t cur_size;
+    size_t old_max_size = 0;
+    uint32_t pos;
+
+    /* Do not permit the user to pass filesystem-internal flags */
+    if (flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+    /* Set the max_size to be aligned with the flash program unit */
+    max_size = its_ram_align(fs_ctx, max_size);
+#endif
+
+    pos = its_ram_find_slot(fs_ctx, fid);
+    if (pos != its_ram_num_slots(fs_ctx)) {
+        file = &index->file[index->slot[pos]];
+        old_max_size = file->max_size;
+
+        if (flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
+            new_flags = flags;
+            cur_size = 0;
+        } else {
+            if (data_size == 0) {
+                /* Nothing changes */
+                return PSA_SUCCESS;
+            }
+
+            /* Write to existing file */
+            new_flags = file->flags;
+            cur_size = file->cur_size;
+            max_size = file->max_size;
+        }
+    } else {
+        /* The create flag must be supplied to create a new file */
+        if (!(flags & ITS_FLASH_FS_FLAG_CREATE)) {
+            return PSA_ERROR_DOES_NOT_EXIST;
+        }
+
+        /* Keep one file entry free, as the metadata block filesystem does */
+        if (fs_ctx->num_files + 1 >= fs_ctx->cfg->max_num_files) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+
+        new_flags = flags;
+        cur_size = 0;
+    }
+
+    /* Check that the file's maximum size is valid */
+    if (max_size > fs_ctx->cfg->max_file_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (data_size != 0) {
+#if (ITS_FLASH_MAX_ALIGNMENT != 1)
+        /* Check that the offset is aligned with the flash program unit */
+        if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+#endif
+
+        /* It is not permitted to create gaps in the file */
+        if (offset > cur_size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Check that the new data is contained within the file's max size */
+        if (its_utils_check_contained_in(max_size, offset,
+                                         its_ram_align(fs_ctx, data_size))
+            != PSA_SUCCESS) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    if ((file == NULL) || (max_size != old_max_size)) {
+        if (fs_ctx->used_size - old_max_size + max_size > fs_ctx->data_size) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+
+        /* A truncated file of a different size is stored again at the end */
+        if (file != NULL) {
+            its_ram_delete(fs_ctx, pos);
+        }
+
+        file = &index->file[fs_ctx->num_files];
+        (void)memcpy(file->id, fid, ITS_FILE_ID_SIZE);
+        file->max_size = max_size;
+        file->offset = fs_ctx->used_size;
+        fs_ctx->used_size += max_size;
+        its_ram_insert_slot(fs_ctx, fs_ctx->num_files);
+        fs_ctx->num_files++;
+    }
+
+    if (data_size != 0) {
+        (void)memcpy(fs_ctx->data + file->offset + offset, data, data_size);
+        its_flash_fs_stats_program(fs_ctx->cfg, data_size);
+
+        /* Update the file's current size if required */
+        if (offset + data_size > cur_size) {
+            cur_size = offset + data_size;
+        }
+    }
+
+    file->flags = new_flags;
+    file->cur_size = cur_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_delete(its_flash_fs_ctx_t *fs_ctx,
+                                      const uint8_t *fid)
+{
+    uint32_t pos;
+
+    pos = its_ram_find_slot(fs_ctx, fid);
+    if (pos == its_ram_num_slots(fs_ctx)) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    its_ram_delete(fs_ctx, pos);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
+                                    const uint8_t *fid,
+                                    size_t size,
+                                    size_t offset,
+                                    uint8_t *data)
+{
+    const struct its_ram_file_t *file;
+    uint32_t pos;
+    psa_status_t err;
+
+    pos = its_ram_find_slot(fs_ctx, fid);
+    if (pos == its_ram_num_slots(fs_ctx)) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    file = &fs_ctx->cfg->file_index->file[fs_ctx->cfg->file_index->slot[pos]];
+
+    /* Boundary check the incoming request */
+    err = its_utils_check_contained_in(file->cur_size, offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    (void)memcpy(data, fs_ctx->data + file->offset + offset, size);
+    its_flash_fs_stats_read(fs_ctx->cfg, size);
+
+    return PSA_SUCCESS;
+}
+
+
+psa_status_t its_flash_fs_file_count(its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *prefix,
+                                     size_t prefix_size,
+                                     uint32_t *num_files)
+{
+    const struct its_ram_file_t *file = fs_ctx->cfg->file_index->file;
+    uint32_t i;
+
+    /* The files in use are kept at the start of the table */
+    *num_files = 0;
+
+    for (i = 0; i < fs_ctx->num_files; i++) {
+        if (!memcmp(file[i].id, prefix, prefix_size)) {
+            (*num_files)++;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_bulk_load(its_flash_fs_ctx_t *fs_ctx,
+                                    const struct its_flash_fs_bulk_file_t *files,
+                                    uint32_t num_files)
+{
+    (void)fs_ctx;
+    (void)files;
+    (void)num_files;
+
+    /* Nothing is programmed to flash, so there is nothing to batch */
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+
+psa_status_t its_flash_fs_space_init(its_flash_fs_ctx_t *fs_ctx,
+                                     struct its_flash_fs_space_t *space)
+{
+    space->lblock = 0;
+    space->free_size = fs_ctx->data_size - fs_ctx->used_size;
+
+    /* One file entry is kept free */
+    space->free_files = (fs_ctx->num_files + 1 < fs_ctx->cfg->max_num_files) ?
+                        fs_ctx->cfg->max_num_files - fs_ctx->num_files - 1 : 0;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_space_reserve(its_flash_fs_ctx_t *fs_ctx,
+                                        struct its_flash_fs_space_t *space,
+                                        const uint8_t *fid,
+                                        size_t size)
+{
+    if (size > fs_ctx->cfg->max_file_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The space of a replaced file is not counted as freed */
+    size = its_ram_align(fs_ctx, size);
+    if (size > space->free_size) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    if (its_ram_find_slot(fs_ctx, fid) == its_ram_num_slots(fs_ctx)) {
+        if (space->free_files == 0) {
+            return PSA_ERROR_INSUFFICIENT_STORAGE;
+        }
+        space->free_files--;
+    }
+
+    space->free_size -= size;
+
+    return PSA_SUCCESS;
+}
+
+#endif /* ITS_RAM_OBJECT_STORE */
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file  its_flash_fs_ram.h
+ *
+ * \brief Internal definitions of the RAM object store implementation of the
+ *        ITS flash filesystem.
+ *
+ * \details Files are kept in the RAM area of the filesystem, without the flash
+ *          emulation of the RAM flash interface. The file data is packed from
+ *          the start of the area, each file taking its maximum size, and the
+ *          files are found through a hash table of their IDs. Writes and
+ *          reads copy the data in place, and deleting a file moves the data
+ *          of the files stored after it down. Nothing is kept across a reset.
+ */
+
+#ifndef __ITS_FLASH_FS_RAM_H__
+#define __ITS_FLASH_FS_RAM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flash/its_flash.h"
+#include "its_flash_fs.h"
+#include "its_utils.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \struct its_ram_file_t
+ *
+ * \brief Structure to store the information of a file of the RAM store.
+ */
+struct its_ram_file_t {
+    uint8_t id[ITS_FILE_ID_SIZE]; /*!< ID of this file */
+    uint32_t flags;               /*!< Flags set when the file was created */
+    uint32_t cur_size;            /*!< Current size of the file data */
+    uint32_t max_size;            /*!< Maximum size of this file */
+    uint32_t offset;              /*!< Offset of the file data in the RAM
+                                   *   area
+                                   */
+};
+
+/*!
+ * \def ITS_FILE_INDEX_EMPTY_SLOT
+ *
+ * \brief Value of an unused entry in the file index hash table.
+ */
+#define ITS_FILE_INDEX_EMPTY_SLOT 0xFFFFU
+
+/*!
+ * \def ITS_FILE_INDEX_NUM_SLOTS
+ *
+ * \brief Number of hash table entries the file index needs for the given
+ *        maximum number of files.
+ */
+#define ITS_FILE_INDEX_NUM_SLOTS(max_num_files) (2U * (max_num_files))
+
+/**
+ * \struct its_flash_fs_file_index_t
+ *
+ * \brief Structure to store the files of the RAM store, indexed by file ID.
+ */
+struct its_flash_fs_file_index_t {
+    struct its_ram_file_t *file; /**< Files in use first, max_num_files
+                                  *   entries
+                                  */
+    uint16_t *slot;  /**< Open addressing hash table of file indexes,
+                      *   ITS_FILE_INDEX_NUM_SLOTS(max_num_files) entries
+                      */
+};
+
+/**
+ * \def ITS_FLASH_FS_FILE_INDEX_DEFINE
+ *
+ * \brief Statically allocates the file index of a filesystem with the given
+ *        maximum number of files.
+ */
+#define ITS_FLASH_FS_FILE_INDEX_DEFINE(name, max_num_files)               \
+    static struct its_ram_file_t name##_file[max_num_files];              \
+    static uint16_t name##_slot[ITS_FILE_INDEX_NUM_SLOTS(max_num_files)]; \
+    static struct its_flash_fs_file_index_t name = {                      \
+        .file = name##_file,                                              \
+        .slot = name##_slot,                                              \
+    }
+
+/**
+ * \struct its_flash_fs_ctx_t
+ *
+ * \brief Structure to store the ITS RAM object store context.
+ */
+struct its_flash_fs_ctx_t {
+    const struct its_flash_fs_config_t *cfg; /**< Filesystem configuration */
+    const struct its_flash_fs_ops_t *ops;    /**< Filesystem flash operations */
+    uint8_t *data;       /**< RAM area of the file data */
+    size_t data_size;    /**< Size of the RAM area */
+    size_t used_size;    /**< Bytes of the RAM area taken by the files */
+    uint32_t num_files;  /**< Number of files in use */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_FLASH_FS_RAM_H__ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "its_fault_bench.h"
+
+#if ITS_FS_FAULT_INJECTION
+
+#include <string.h>
+
+#include "cmsis_compiler.h"
+#include "cycle_counter.h"
+#include "flash_fs/its_flash_fs.h"
+#include "tfm_its_defs.h"
+
+/*
+ * The counter and the reset need ITS to run privileged, which is the case for
+ * the PSA RoT partitions of the reference platforms.
+ *
+ * The fault point is armed in RAM only, so the reset it causes also disarms
+ * it and the device does not keep resetting at the same point.
+ */
+static uint32_t armed_point;
+static uint32_t armed_count;
+static struct tfm_its_fault_stats_t bench_stats;
+
+/* Reference implementation, a test build can still provide its own */
+__WEAK void its_flash_fs_fault_point(const struct its_flash_fs_config_t *cfg,
+                                     enum its_flash_fs_fault_point_t point)
+{
+    (void)cfg;
+
+    bench_stats.points++;
+
+    if ((armed_count == 0) || ((uint32_t)point != armed_point)) {
+        return;
+    }
+
+    if (--armed_count == 0) {
+        /* Stands for a power failure, the flash is left as it is now */
+        NVIC_SystemReset();
+    }
+}
+
+uint32_t its_fault_bench_init(void)
+{
+    cycle_counter_enable();
+
+    return cycle_counter_read();
+}
+
+void its_fault_bench_mounted(uint32_t start)
+{
+    bench_stats.mount_cycles = cycle_counter_read() - start;
+}
+
+uint32_t its_fault_bench_start(void)
+{
+    return cycle_counter_read();
+}
+
+void its_fault_bench_record(uint32_t op, uint32_t start, psa_status_t status)
+{
+    struct tfm_its_fault_op_stats_t *s = &bench_stats.op[op];
+    uint32_t cycles = cycle_counter_read() - start;
+    uint32_t bucket;
+
+    bucket = (cycles == 0) ? 0 : (31 - __CLZ(cycles));
+    if (bucket >= TFM_ITS_FAULT_BUCKETS) {
+        bucket = TFM_ITS_FAULT_BUCKETS - 1;
+    }
+
+    s->ops++;
+    if (status != PSA_SUCCESS) {
+        s->failures++;
+    }
+    s->cycles += cycles;
+    if (cycles > s->max_cycles) {
+        s->max_cycles = cycles;
+    }
+    s->buckets[bucket]++;
+}
+
+psa_status_t its_fault_bench_arm_req(const psa_msg_t *msg)
+{
+    struct tfm_its_fault_arm_t arm;
+
+    if (msg->in_size[0] != sizeof(arm)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (psa_read(msg->handle, 0, &arm, sizeof(arm)) != sizeof(arm)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (arm.point > ITS_FLASH_FS_FAULT_RESET_ERASED) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    armed_point = arm.point;
+    armed_count = arm.count;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_fault_bench_stats_req(const psa_msg_t *msg)
+{
+    if (msg->out_size[0] != sizeof(bench_stats)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    psa_write(msg->handle, 0, &bench_stats, sizeof(bench_stats));
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_FS_FAULT_INJECTION */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __ITS_FAULT_BENCH_H__
+#define __ITS_FAULT_BENCH_H__
+
+#include <stdint.h>
+
+#include "config_tfm.h"
+#include "psa/error.h"
+#include "psa/service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if ITS_FS_FAULT_INJECTION
+/**
+ * \brief Starts the cycle counter and returns its value, to be passed to
+ *        its_fault_bench_mounted() once the filesystems are mounted.
+ *
+ * \return The cycle counter value
+ */
+uint32_t its_fault_bench_init(void);
+
+/**
+ * \brief Records the mount time of the filesystems.
+ *
+ * \param[in] start  The value returned by its_fault_bench_init()
+ */
+void its_fault_bench_mounted(uint32_t start);
+
+/**
+ * \brief Returns the cycle counter value at the start of an operation.
+ *
+ * \return The cycle counter value
+ */
+uint32_t its_fault_bench_start(void);
+
+/**
+ * \brief Records the latency and the status of an operation.
+ *
+ * \param[in] op      The operation, one of the TFM_ITS_FAULT_OP_* values
+ * \param[in] start   The value returned by its_fault_bench_start()
+ * \param[in] status  The status the operation returns
+ */
+void its_fault_bench_record(uint32_t op, uint32_t start, psa_status_t status);
+
+/**
+ * \brief Handles the TFM_ITS_FAULT_ARM request, which arms the reset at a
+ *        fault point.
+ *
+ * \param[in] msg  The request
+ *
+ * \return PSA_SUCCESS, or PSA_ERROR_PROGRAMMER_ERROR if the input is invalid
+ */
+psa_status_t its_fault_bench_arm_req(const psa_msg_t *msg);
+
+/**
+ * \brief Handles the TFM_ITS_FAULT_GET_STATS request, which returns the
+ *        statistics counted since the last boot.
+ *
+ * \param[in] msg  The request
+ *
+ * \return PSA_SUCCESS, or PSA_ERROR_PROGRAMMER_ERROR if the output is invalid
+ */
+psa_status_t its_fault_bench_stats_req(const psa_msg_t *msg);
+#endif /* ITS_FS_FAULT_INJECTION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_FAULT_BENCH_H__ */
@@ -31,6 +31,29 @@
 static uint8_t g_fid[ITS_FILE_ID_SIZE];
 static struct its_file_info_t g_file_info;
 
+#if ITS_READ_CACHE_SIZE > 0
+#if ITS_READ_CACHE_NUM_ENTRIES == 0
+#error "Invalid config: ITS_READ_CACHE_NUM_ENTRIES shall be at least 1 when ITS_READ_CACHE_SIZE is enabled"
+#endif
+
+/* Asset held in the read cache */
+struct its_read_cache_entry_t {
+    bool valid;                          /* The entry holds an asset */
+    uint8_t fid[ITS_FILE_ID_SIZE];       /* File id of the asset */
+    struct its_file_info_t info;         /* File info of the asset */
+    size_t offset;                       /* Offset of the data in the pool */
+    uint32_t last_use;                   /* Clock value of the last access */
+};
+
+static struct its_read_cache_entry_t g_cache[ITS_READ_CACHE_NUM_ENTRIES];
+static uint8_t g_cache_pool[ITS_READ_CACHE_SIZE];
+static uint32_t g_cache_clock;
+static struct tfm_its_read_cache_stats_t g_cache_stats;
+
+/* Cache entry of the asset in g_fid, if it was found by get_file_info() */
+static struct its_read_cache_entry_t *g_cache_entry;
+#endif
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC != 1
 /* Buffer to store asset data from the caller.
  * Note: size must be aligned to the max flash program unit to meet the
@@ -40,21 +63,110 @@ static uint8_t __ALIGNED(4) asset_data[ITS_UTILS_ALIGN(ITS_BUF_SIZE,
                                           ITS_FLASH_MAX_ALIGNMENT)];
 #endif
 
+#if ITS_TRANSACTION_BUF_SIZE > 0
+/* Operations recorded in a transaction journal */
+#define ITS_TXN_OP_SET     1U
+#define ITS_TXN_OP_REMOVE  2U
+
+/* Header of a transaction journal */
+struct its_txn_header_t {
+    int32_t client_id;       /* Owner of the assets in the transaction */
+    uint32_t size;           /* Size of the journal, including this header */
+};
+
+/* Operation in a transaction journal, followed by the data of a set padded
+ * to a multiple of 4 bytes.
+ */
+struct its_txn_record_t {
+    psa_storage_uid_t uid;   /* Identifier of the asset */
+    uint32_t op;             /* ITS_TXN_OP_SET or ITS_TXN_OP_REMOVE */
+    uint32_t create_flags;   /* Flags of a set */
+    uint32_t data_length;    /* Size of the data of a set */
+};
+
+/* Journal of the open transaction, also used to replay a committed one */
+static uint8_t g_txn_buf[ITS_TRANSACTION_BUF_SIZE];
+static size_t g_txn_size;
+static bool g_txn_active;
+static int32_t g_txn_client_id;
+/* Requests of other clients since the last request of the owner */
+static uint32_t g_txn_idle;
+/* A committed transaction is not fully applied, its journal is kept */
+static bool g_txn_pending;
+#if ITS_CLIENT_MAX_NUM_ASSETS > 0
+/* Number of assets the open transaction creates */
+static uint32_t g_txn_num_created;
+#endif
+/* Files of a transaction committed to an empty ITS filesystem */
+static struct its_flash_fs_bulk_file_t g_txn_files[ITS_NUM_ASSETS];
+
+/* The journal is stored as an extra ITS file while it is applied */
+#define ITS_TXN_NUM_FILES 1
+#else
+#define ITS_TXN_NUM_FILES 0
+#endif
+
+/* Files of the ITS filesystem. Each asset can take up to ITS_MAX_FILE_EXTENTS
+ * files, and the extents of the new file of a replacement are reserved next to
+ * the ones of the existing file. An extra file is needed for the transaction
+ * journal.
+ */
+#define ITS_NUM_FILES ((ITS_NUM_ASSETS + 1) * ITS_MAX_FILE_EXTENTS + \
+                       ITS_TXN_NUM_FILES)
+
+/* The log-structured filesystem and the RAM object store always need a RAM
+ * index of the files
+ */
+#define ITS_FS_HAS_FILE_INDEX \
+    (ITS_FILE_INDEX || ITS_FLASH_FS_LOG || ITS_RAM_OBJECT_STORE)
+
+#if ITS_FS_HAS_FILE_INDEX
+/* RAM index of the ITS files */
+ITS_FLASH_FS_FILE_INDEX_DEFINE(its_file_index, ITS_NUM_FILES);
+#endif
+
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+/* Flash operations issued by the ITS filesystem */
+static struct its_flash_fs_stats_t its_flash_stats;
+#endif
+
 static its_flash_fs_ctx_t fs_ctx_its;
 static struct its_flash_fs_config_t fs_cfg_its = {
     .flash_dev = &ITS_FLASH_DEV,
     .program_unit = ITS_FLASH_ALIGNMENT,
     .max_file_size = ITS_UTILS_ALIGN(ITS_MAX_ASSET_SIZE, ITS_FLASH_ALIGNMENT),
-    .max_num_files = ITS_NUM_ASSETS + 1, /* Extra file for atomic replacement */
+    .max_num_files = ITS_NUM_FILES,
+#if ITS_FS_HAS_FILE_INDEX
+    .file_index = &its_file_index,
+#endif
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+    .stats = &its_flash_stats,
+#endif
 };
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
+#if ITS_FS_HAS_FILE_INDEX
+/* RAM index of the PS files */
+ITS_FLASH_FS_FILE_INDEX_DEFINE(ps_file_index, PS_MAX_NUM_OBJECTS);
+#endif
+
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+/* Flash operations issued by the PS filesystem */
+static struct its_flash_fs_stats_t ps_flash_stats;
+#endif
+
 static its_flash_fs_ctx_t fs_ctx_ps;
 static struct its_flash_fs_config_t fs_cfg_ps = {
     .flash_dev = &PS_FLASH_DEV,
     .program_unit = PS_FLASH_ALIGNMENT,
     .max_file_size = ITS_UTILS_ALIGN(PS_MAX_OBJECT_SIZE, PS_FLASH_ALIGNMENT),
     .max_num_files = PS_MAX_NUM_OBJECTS,
+#if ITS_FS_HAS_FILE_INDEX
+    .file_index = &ps_file_index,
+#endif
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+    .stats = &ps_flash_stats,
+#endif
 };
 #endif
 
@@ -83,6 +195,655 @@ static void tfm_its_get_fid(int32_t client_id,
     memcpy(fid + sizeof(client_id), (const void *)&uid, sizeof(uid));
 }
 
+#if ITS_CLIENT_MAX_NUM_ASSETS > 0
+/**
+ * \brief Checks that a client can create one more asset.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] num_extra  Number of assets the client is already creating, in
+ *                       addition to the ones in the filesystem
+ *
+ * \return Returns PSA_ERROR_INSUFFICIENT_STORAGE if the client has reached
+ *         ITS_CLIENT_MAX_NUM_ASSETS, or error code as specified in
+ *         \ref psa_status_t
+ */
+static psa_status_t its_check_client_quota(int32_t client_id,
+                                           uint32_t num_extra)
+{
+    psa_status_t status;
+    uint32_t num_files;
+
+    /* The PS objects have their own filesystem, sized for PS_NUM_ASSETS */
+    if (get_fs_ctx(client_id) != &fs_ctx_its) {
+        return PSA_SUCCESS;
+    }
+
+    /* The file IDs of a client all start with its client ID */
+    status = its_flash_fs_file_count(&fs_ctx_its, (const uint8_t *)&client_id,
+                                     sizeof(client_id), &num_files);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    if (num_files + num_extra >= ITS_CLIENT_MAX_NUM_ASSETS) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif
+
+#if ITS_READ_CACHE_SIZE > 0
+/**
+ * \brief Looks up an asset in the read cache.
+ *
+ * \param[in] fid  Identifier of the file
+ *
+ * \return Returns the cache entry of the asset, or NULL if it is not cached
+ */
+static struct its_read_cache_entry_t *its_read_cache_lookup(const uint8_t *fid)
+{
+    uint32_t i;
+
+    for (i = 0; i < ITS_READ_CACHE_NUM_ENTRIES; i++) {
+        if (g_cache[i].valid &&
+            (memcmp(g_cache[i].fid, fid, ITS_FILE_ID_SIZE) == 0)) {
+            g_cache[i].last_use = ++g_cache_clock;
+            return &g_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Drops an entry from the read cache and clears its data.
+ *
+ * \param[in,out] entry  Cache entry
+ */
+static void its_read_cache_drop(struct its_read_cache_entry_t *entry)
+{
+    memset(g_cache_pool + entry->offset, 0, entry->info.size_current);
+    entry->valid = false;
+}
+
+/**
+ * \brief Packs the data of the valid cache entries at the start of the pool.
+ *
+ * \return Returns the size of the pool in use
+ */
+static size_t its_read_cache_compact(void)
+{
+    struct its_read_cache_entry_t *next;
+    size_t used = 0;
+    uint32_t i;
+
+    /* Move the entries down in the order of their offsets, so that the data
+     * of an entry is never overwritten before it is moved. Empty assets have
+     * no data to move.
+     */
+    do {
+        next = NULL;
+        for (i = 0; i < ITS_READ_CACHE_NUM_ENTRIES; i++) {
+            if (g_cache[i].valid && (g_cache[i].info.size_current != 0) &&
+                (g_cache[i].offset >= used) &&
+                ((next == NULL) || (g_cache[i].offset < next->offset))) {
+                next = &g_cache[i];
+            }
+        }
+
+        if (next != NULL) {
+            if (next->offset != used) {
+                memmove(g_cache_pool + used, g_cache_pool + next->offset,
+                        next->info.size_current);
+                next->offset = used;
+            }
+            used += next->info.size_current;
+        }
+    } while (next != NULL);
+
+    return used;
+}
+
+/**
+ * \brief Reads the asset in g_fid, described by g_file_info, into the read
+ *        cache. The least recently used entries are evicted to make room.
+ *
+ * \param[in] fs_ctx  Filesystem context of the asset
+ *
+ * \return Returns the cache entry of the asset, or NULL if it is not cached
+ */
+static struct its_read_cache_entry_t *its_read_cache_fill(
+                                                    its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_read_cache_entry_t *entry;
+    struct its_read_cache_entry_t *lru;
+    size_t used;
+    uint32_t i;
+
+    if (g_file_info.size_current > ITS_READ_CACHE_SIZE) {
+        return NULL;
+    }
+
+    for (;;) {
+        entry = NULL;
+        lru = NULL;
+        used = 0;
+        for (i = 0; i < ITS_READ_CACHE_NUM_ENTRIES; i++) {
+            if (!g_cache[i].valid) {
+                if (entry == NULL) {
+                    entry = &g_cache[i];
+                }
+            } else {
+                used += g_cache[i].info.size_current;
+                if ((lru == NULL) || (g_cache[i].last_use < lru->last_use)) {
+                    lru = &g_cache[i];
+                }
+            }
+        }
+
+        if ((entry != NULL) &&
+            (used + g_file_info.size_current <= ITS_READ_CACHE_SIZE)) {
+            break;
+        }
+
+        /* Either all the entries or the space are in use, so there is at
+         * least one valid entry to evict.
+         */
+        its_read_cache_drop(lru);
+    }
+
+    entry->offset = its_read_cache_compact();
+
+    if (its_flash_fs_file_read(fs_ctx, g_fid, g_file_info.size_current, 0,
+                               g_cache_pool + entry->offset) != PSA_SUCCESS) {
+        memset(g_cache_pool + entry->offset, 0, g_file_info.size_current);
+        return NULL;
+    }
+
+    memcpy(entry->fid, g_fid, ITS_FILE_ID_SIZE);
+    entry->info = g_file_info;
+    entry->last_use = ++g_cache_clock;
+    entry->valid = true;
+
+    return entry;
+}
+
+void tfm_its_get_read_cache_stats(struct tfm_its_read_cache_stats_t *stats)
+{
+    *stats = g_cache_stats;
+}
+#endif /* ITS_READ_CACHE_SIZE > 0 */
+
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+void tfm_its_get_flash_stats(bool ps, struct its_flash_fs_stats_t *stats)
+{
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (ps) {
+        *stats = ps_flash_stats;
+        return;
+    }
+#else
+    (void)ps;
+#endif
+    *stats = its_flash_stats;
+}
+#endif /* ITS_FLASH_STATS_NUM_BLOCKS > 0 */
+
+#if ITS_TRANSACTION_BUF_SIZE > 0
+/**
+ * \brief Gets the file id of the transaction journal. The invalid UID is never
+ *        used by an asset, so the journal cannot clash with one.
+ *
+ * \param[out] fid  Identifier of the file
+ */
+static void its_txn_get_fid(uint8_t *fid)
+{
+    tfm_its_get_fid(TFM_SP_ITS, TFM_ITS_INVALID_UID, fid);
+}
+
+/**
+ * \brief Finds the last operation on an asset in the open transaction.
+ *
+ * \param[in]  uid     Identifier of the asset
+ * \param[out] record  Filled with the last operation on the asset
+ *
+ * \return Returns true if the asset is changed by the transaction
+ */
+static bool its_txn_find(psa_storage_uid_t uid,
+                         struct its_txn_record_t *record)
+{
+    struct its_txn_record_t cur;
+    size_t offset = sizeof(struct its_txn_header_t);
+    bool found = false;
+
+    while (offset < g_txn_size) {
+        memcpy(&cur, g_txn_buf + offset, sizeof(cur));
+        if (cur.uid == uid) {
+            *record = cur;
+            found = true;
+        }
+        offset += sizeof(cur) + ITS_UTILS_ALIGN(cur.data_length, 4);
+    }
+
+    return found;
+}
+
+/**
+ * \brief Appends an operation to the open transaction. The data of a set is
+ *        read from the caller.
+ *
+ * \param[in] uid           Identifier of the asset
+ * \param[in] op            ITS_TXN_OP_SET or ITS_TXN_OP_REMOVE
+ * \param[in] create_flags  Flags of a set
+ * \param[in] data_length   Size of the data of a set
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_txn_append(psa_storage_uid_t uid, uint32_t op,
+                                   psa_storage_create_flags_t create_flags,
+                                   size_t data_length)
+{
+    struct its_txn_record_t record;
+    size_t capacity;
+
+    if (data_length > fs_cfg_its.max_file_size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* The whole journal must also fit in a single ITS file */
+    capacity = ITS_UTILS_MIN(sizeof(g_txn_buf), fs_cfg_its.max_file_size);
+    if (sizeof(record) + ITS_UTILS_ALIGN(data_length, 4) >
+        capacity - g_txn_size) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    record.uid = uid;
+    record.op = op;
+    record.create_flags = (uint32_t)create_flags;
+    record.data_length = (uint32_t)data_length;
+    memcpy(g_txn_buf + g_txn_size, &record, sizeof(record));
+    g_txn_size += sizeof(record);
+
+    if (data_length != 0) {
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        memcpy(g_txn_buf + g_txn_size, its_req_mngr_get_vec_base(),
+               data_length);
+#else
+        (void)its_req_mngr_read(g_txn_buf + g_txn_size, data_length);
+#endif
+        g_txn_size += ITS_UTILS_ALIGN(data_length, 4);
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Applies the operations of the transaction journal in g_txn_buf to
+ *        the ITS filesystem.
+ *
+ * \note Each operation can be applied again after a power failure, as a set
+ *       replaces the whole asset and the removal of a missing asset is
+ *       ignored.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_txn_apply(void)
+{
+    psa_status_t status;
+    struct its_txn_header_t header;
+    struct its_txn_record_t record;
+    size_t offset = sizeof(header);
+    size_t data_length;
+    uint8_t fid[ITS_FILE_ID_SIZE];
+#if ITS_READ_CACHE_SIZE > 0
+    struct its_read_cache_entry_t *entry;
+#endif
+
+    memcpy(&header, g_txn_buf, sizeof(header));
+
+    while (offset < header.size) {
+        if (header.size - offset < sizeof(record)) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+        memcpy(&record, g_txn_buf + offset, sizeof(record));
+        offset += sizeof(record);
+
+        data_length = ITS_UTILS_ALIGN(record.data_length, 4);
+        if (data_length > header.size - offset) {
+            return PSA_ERROR_DATA_CORRUPT;
+        }
+
+        tfm_its_get_fid(header.client_id, record.uid, fid);
+
+#if ITS_READ_CACHE_SIZE > 0
+        entry = its_read_cache_lookup(fid);
+        if (entry != NULL) {
+            its_read_cache_drop(entry);
+        }
+#endif
+
+        if (record.op == ITS_TXN_OP_SET) {
+            status = its_flash_fs_file_write(&fs_ctx_its, fid,
+                                             record.create_flags |
+                                             ITS_FLASH_FS_FLAG_CREATE |
+                                             ITS_FLASH_FS_FLAG_TRUNCATE,
+                                             record.data_length,
+                                             record.data_length, 0,
+                                             g_txn_buf + offset);
+        } else {
+            status = its_flash_fs_file_delete(&fs_ctx_its, fid);
+            if (status == PSA_ERROR_DOES_NOT_EXIST) {
+                status = PSA_SUCCESS;
+            }
+        }
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        offset += data_length;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Applies the committed transaction in g_txn_buf, then removes its
+ *        journal. If it fails, the journal is kept and the transaction is
+ *        applied again before the next request of the owner.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_txn_finish(void)
+{
+    psa_status_t status;
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    status = its_txn_apply();
+    if ((status != PSA_SUCCESS) && (status != PSA_ERROR_DATA_CORRUPT)) {
+        g_txn_pending = true;
+        return status;
+    }
+
+    /* A malformed journal, for example after a change of configuration,
+     * cannot be applied and is dropped.
+     */
+    its_txn_get_fid(fid);
+    status = its_flash_fs_file_delete(&fs_ctx_its, fid);
+    g_txn_pending = (status != PSA_SUCCESS);
+
+    return status;
+}
+
+/**
+ * \brief Applies a transaction that was committed but not fully applied
+ *        before a power failure, then removes its journal.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_txn_recover(void)
+{
+    psa_status_t status;
+    struct its_file_info_t info;
+    struct its_txn_header_t header;
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    its_txn_get_fid(fid);
+
+    status = its_flash_fs_file_get_info(&fs_ctx_its, fid, &info);
+    if (status == PSA_ERROR_DOES_NOT_EXIST) {
+        return PSA_SUCCESS;
+    } else if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* A journal that does not fit in the buffer, for example after a change
+     * of configuration, cannot be applied and is dropped.
+     */
+    if ((info.size_current >= sizeof(struct its_txn_header_t)) &&
+        (info.size_current <= sizeof(g_txn_buf))) {
+        status = its_flash_fs_file_read(&fs_ctx_its, fid, info.size_current, 0,
+                                        g_txn_buf);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        memcpy(&header, g_txn_buf, sizeof(header));
+        if (header.size == info.size_current) {
+            g_txn_client_id = header.client_id;
+
+            /* Only a failure of the storage stops the initialisation. The
+             * journal is kept otherwise, and applied again later.
+             */
+            status = its_txn_finish();
+            return (status == PSA_ERROR_STORAGE_FAILURE) ? status :
+                                                           PSA_SUCCESS;
+        }
+    }
+
+    return its_flash_fs_file_delete(&fs_ctx_its, fid);
+}
+
+/**
+ * \brief Checks that the journal and the assets set by the transaction in
+ *        g_txn_buf fit in the ITS filesystem. This is done before the commit
+ *        point, so that applying the transaction does not run out of space
+ *        with only part of it applied.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_txn_check_space(void)
+{
+    psa_status_t status;
+    struct its_flash_fs_space_t space;
+    struct its_txn_record_t record;
+    size_t offset = sizeof(struct its_txn_header_t);
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    status = its_flash_fs_space_init(&fs_ctx_its, &space);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The journal is written first, and removed last */
+    its_txn_get_fid(fid);
+    status = its_flash_fs_space_reserve(&fs_ctx_its, &space, fid, g_txn_size);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    while (offset < g_txn_size) {
+        memcpy(&record, g_txn_buf + offset, sizeof(record));
+        offset += sizeof(record) + ITS_UTILS_ALIGN(record.data_length, 4);
+
+        /* A removal can fail to free space, but never needs any */
+        if (record.op != ITS_TXN_OP_SET) {
+            continue;
+        }
+
+        tfm_its_get_fid(g_txn_client_id, record.uid, fid);
+        status = its_flash_fs_space_reserve(&fs_ctx_its, &space, fid,
+                                            record.data_length);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes the assets set by the transaction in g_txn_buf in one bulk
+ *        load, when the ITS filesystem is empty, as at provisioning time.
+ *
+ * \note The bulk load updates the metadata once, so the transaction is atomic
+ *       without a journal.
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the transaction has to be
+ *         committed with a journal, or error code as specified in
+ *         \ref psa_status_t
+ */
+static psa_status_t its_txn_bulk_load(void)
+{
+    struct its_txn_record_t record;
+    size_t offset = sizeof(struct its_txn_header_t);
+    uint32_t num_files = 0;
+    uint32_t i;
+
+    while (offset < g_txn_size) {
+        memcpy(&record, g_txn_buf + offset, sizeof(record));
+        offset += sizeof(record);
+
+        if ((record.op != ITS_TXN_OP_SET) || (num_files >= ITS_NUM_ASSETS)) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+
+        tfm_its_get_fid(g_txn_client_id, record.uid,
+                        g_txn_files[num_files].fid);
+
+        /* The journal applies the sets of an asset in order */
+        for (i = 0; i < num_files; i++) {
+            if (memcmp(g_txn_files[i].fid, g_txn_files[num_files].fid,
+                       ITS_FILE_ID_SIZE) == 0) {
+                return PSA_ERROR_NOT_SUPPORTED;
+            }
+        }
+
+        g_txn_files[num_files].flags = record.create_flags;
+        g_txn_files[num_files].size = record.data_length;
+        g_txn_files[num_files].data = g_txn_buf + offset;
+        num_files++;
+
+        offset += ITS_UTILS_ALIGN(record.data_length, 4);
+    }
+
+    return its_flash_fs_bulk_load(&fs_ctx_its, g_txn_files, num_files);
+}
+
+psa_status_t tfm_its_transaction_check(int32_t client_id)
+{
+    psa_status_t status;
+
+    if (g_txn_active) {
+        if (client_id == g_txn_client_id) {
+            g_txn_idle = 0;
+        } else if (g_txn_idle < UINT32_MAX) {
+            g_txn_idle++;
+        }
+    }
+
+    if (g_txn_pending) {
+        /* Only the owner could see its assets half updated */
+        status = its_txn_finish();
+        if ((status != PSA_SUCCESS) && (client_id == g_txn_client_id)) {
+            return status;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_transaction_begin(int32_t client_id)
+{
+#ifndef TFM_NS_MANAGE_NSID
+    /* The NS threads share one client ID, so the sets of one thread would be
+     * recorded in the transaction of another.
+     */
+    if (client_id < 0) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    /* A committed transaction is applied before another one is opened */
+    if (g_txn_pending) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    /* Only one transaction can be open at a time. The transaction of an
+     * owner idle for ITS_TRANSACTION_TIMEOUT requests of other clients is
+     * aborted to open the new one.
+     */
+    if (g_txn_active &&
+        ((ITS_TRANSACTION_TIMEOUT == 0) ||
+         (g_txn_idle <= ITS_TRANSACTION_TIMEOUT))) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    /* The journal is stored in the ITS filesystem */
+    if (get_fs_ctx(client_id) != &fs_ctx_its) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    g_txn_active = true;
+    g_txn_client_id = client_id;
+    g_txn_idle = 0;
+    g_txn_size = sizeof(struct its_txn_header_t);
+#if ITS_CLIENT_MAX_NUM_ASSETS > 0
+    g_txn_num_created = 0;
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_transaction_commit(int32_t client_id)
+{
+    psa_status_t status;
+    struct its_txn_header_t header;
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    if (!g_txn_active || (client_id != g_txn_client_id)) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    g_txn_active = false;
+
+    if (g_txn_size == sizeof(header)) {
+        /* Nothing to commit */
+        return PSA_SUCCESS;
+    }
+
+    status = its_txn_bulk_load();
+    if (status != PSA_ERROR_NOT_SUPPORTED) {
+        return status;
+    }
+
+    status = its_txn_check_space();
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    header.client_id = client_id;
+    header.size = (uint32_t)g_txn_size;
+    memcpy(g_txn_buf, &header, sizeof(header));
+
+    /* Writing the journal is the commit point. Once it is stored, the
+     * operations are applied, again at initialisation time if a power failure
+     * interrupts them, or before the next request of the owner if one fails.
+     */
+    its_txn_get_fid(fid);
+    status = its_flash_fs_file_write(&fs_ctx_its, fid,
+                                     ITS_FLASH_FS_FLAG_CREATE |
+                                     ITS_FLASH_FS_FLAG_TRUNCATE,
+                                     g_txn_size, g_txn_size, 0, g_txn_buf);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    return its_txn_finish();
+}
+
+psa_status_t tfm_its_transaction_abort(int32_t client_id)
+{
+    if (!g_txn_active || (client_id != g_txn_client_id)) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    g_txn_active = false;
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_TRANSACTION_BUF_SIZE > 0 */
+
 /**
  * \brief Initialise the static filesystem configurations.
  *
@@ -185,6 +946,13 @@ psa_status_t tfm_its_init(void)
     }
 #endif /* ITS_CREATE_FLASH_LAYOUT */
 
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    /* Complete a transaction interrupted by a power failure */
+    if (status == PSA_SUCCESS) {
+        status = its_txn_recover();
+    }
+#endif
+
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
     /* Check status of ITS initialisation before continuing with PS */
     if (status != PSA_SUCCESS) {
@@ -240,6 +1008,15 @@ static psa_status_t get_file_info(psa_storage_uid_t uid, int32_t client_id)
     /* Set file id */
     tfm_its_get_fid(client_id, uid, g_fid);
 
+#if ITS_READ_CACHE_SIZE > 0
+    /* Take the file info from the read cache when the asset is cached */
+    g_cache_entry = its_read_cache_lookup(g_fid);
+    if (g_cache_entry != NULL) {
+        g_file_info = g_cache_entry->info;
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Read file info */
     return its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
                                       &g_file_info);
@@ -256,6 +1033,13 @@ psa_status_t tfm_its_set(int32_t client_id,
     size_t offset;
 #endif
     uint32_t flags;
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    struct its_txn_record_t record;
+    bool found;
+#if ITS_CLIENT_MAX_NUM_ASSETS > 0
+    bool created;
+#endif
+#endif
 
     /* Check that the UID is valid */
     if (uid == TFM_ITS_INVALID_UID) {
@@ -285,6 +1069,58 @@ psa_status_t tfm_its_set(int32_t client_id,
         return status;
     }
 
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    if (g_txn_active && (client_id == g_txn_client_id)) {
+        /* An asset set earlier in the transaction is checked in the same
+         * way, then the set is deferred to the commit.
+         */
+        found = its_txn_find(uid, &record);
+        if (found && (record.op == ITS_TXN_OP_SET) &&
+            (record.create_flags & PSA_STORAGE_FLAG_WRITE_ONCE)) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+
+#if ITS_CLIENT_MAX_NUM_ASSETS > 0
+        /* An asset created by the transaction counts against the quota from
+         * its first set, even if it is removed again before the commit.
+         */
+        created = (status == PSA_ERROR_DOES_NOT_EXIST) && !found;
+        if (created) {
+            status = its_check_client_quota(client_id, g_txn_num_created);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+        }
+
+        status = its_txn_append(uid, ITS_TXN_OP_SET, create_flags,
+                                data_length);
+        if ((status == PSA_SUCCESS) && created) {
+            g_txn_num_created++;
+        }
+
+        return status;
+#else
+        return its_txn_append(uid, ITS_TXN_OP_SET, create_flags, data_length);
+#endif
+    }
+#endif
+
+#if ITS_CLIENT_MAX_NUM_ASSETS > 0
+    if (status == PSA_ERROR_DOES_NOT_EXIST) {
+        status = its_check_client_quota(client_id, 0);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+#endif
+
+#if ITS_READ_CACHE_SIZE > 0
+    /* The cached copy becomes stale even if the write fails part way */
+    if (g_cache_entry != NULL) {
+        its_read_cache_drop(g_cache_entry);
+    }
+#endif
+
     flags = (uint32_t)create_flags |
             ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE;
 
@@ -367,6 +1203,28 @@ psa_status_t tfm_its_get(int32_t client_id,
 
     /* Update the size of the output data */
     *p_data_length = data_size;
+
+#if ITS_READ_CACHE_SIZE > 0
+    if (g_cache_entry != NULL) {
+        g_cache_stats.hits++;
+    } else {
+        g_cache_stats.misses++;
+        g_cache_entry = its_read_cache_fill(get_fs_ctx(client_id));
+    }
+
+    if (g_cache_entry != NULL) {
+        /* Copy the asset data from the read cache to the caller */
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        memcpy(its_req_mngr_get_vec_base(),
+               g_cache_pool + g_cache_entry->offset + data_offset, data_size);
+#else
+        its_req_mngr_write(g_cache_pool + g_cache_entry->offset + data_offset,
+                           data_size);
+#endif
+        return PSA_SUCCESS;
+    }
+#endif
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
         /* Read file data from the filesystem */
         status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid, data_size,
@@ -424,6 +1282,9 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
 psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
 {
     psa_status_t status;
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    struct its_txn_record_t record;
+#endif
 
 #ifdef TFM_PARTITION_TEST_PS
     /* The PS test partition can call tfm_its_remove() through PS code. Treat
@@ -436,6 +1297,30 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
 
     /* Validate and read file info */
     status = get_file_info(uid, client_id);
+
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    if (g_txn_active && (client_id == g_txn_client_id) &&
+        ((status == PSA_SUCCESS) || (status == PSA_ERROR_DOES_NOT_EXIST))) {
+        /* The asset as left by the transaction is checked, then the removal
+         * is deferred to the commit.
+         */
+        if (its_txn_find(uid, &record)) {
+            if (record.op != ITS_TXN_OP_SET) {
+                return PSA_ERROR_DOES_NOT_EXIST;
+            }
+            g_file_info.flags = record.create_flags;
+        } else if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        if (g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+            return PSA_ERROR_NOT_PERMITTED;
+        }
+
+        return its_txn_append(uid, ITS_TXN_OP_REMOVE, 0, 0);
+    }
+#endif
+
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -447,6 +1332,12 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
         return PSA_ERROR_NOT_PERMITTED;
     }
 
+#if ITS_READ_CACHE_SIZE > 0
+    if (g_cache_entry != NULL) {
+        its_read_cache_drop(g_cache_entry);
+    }
+#endif
+
     /* Delete old file from the persistent area */
     return its_flash_fs_file_delete(get_fs_ctx(client_id), g_fid);
 }
@@ -17,6 +17,7 @@
 
 #include "flash_fs/its_flash_fs.h"
 #include "its_utils.h"
+#include "tfm_its_defs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -163,6 +164,100 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
  */
 psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid);
 
+/**
+ * \brief Called before each request of a client, when
+ *        ITS_TRANSACTION_BUF_SIZE > 0. Applies again a committed transaction
+ *        that could not be fully applied, and counts how long the owner of
+ *        the open transaction is idle.
+ *
+ * \param[in] client_id  Identifier of the client of the request
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS  The request can be served
+ * \retval Other        The client owns a committed transaction which is still
+ *                      not applied, and the request must fail with this status
+ */
+psa_status_t tfm_its_transaction_check(int32_t client_id);
+
+/**
+ * \brief Opens a transaction for the client. Until the transaction is
+ *        committed or aborted, the sets and removals of the client are
+ *        recorded in the transaction instead of being applied. Gets of the
+ *        client still return the stored data. Only available when
+ *        ITS_TRANSACTION_BUF_SIZE > 0.
+ *
+ * \param[in] client_id  Identifier of the client
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS              The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE      A transaction is already open, or a
+ *                                  committed one is not fully applied
+ * \retval PSA_ERROR_NOT_SUPPORTED  The client's assets are not stored in the
+ *                                  ITS filesystem, or the client is
+ *                                  Non-secure and the NS client IDs are not
+ *                                  managed by the NSPE (TFM_NS_MANAGE_NSID)
+ */
+psa_status_t tfm_its_transaction_begin(int32_t client_id);
+
+/**
+ * \brief Commits the transaction of the client. The recorded sets and
+ *        removals are stored together, so that after a power failure either
+ *        all or none of them are applied. The space they need is checked
+ *        first. If applying them fails once they are stored, they are applied
+ *        again before the next request of the client, which fails until then.
+ *
+ * \param[in] client_id  Identifier of the client
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE             The client has no open transaction
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because there
+ *                                         was insufficient space on the
+ *                                         storage medium
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ */
+psa_status_t tfm_its_transaction_commit(int32_t client_id);
+
+/**
+ * \brief Discards the transaction of the client.
+ *
+ * \param[in] client_id  Identifier of the client
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS          The operation completed successfully
+ * \retval PSA_ERROR_BAD_STATE  The client has no open transaction
+ */
+psa_status_t tfm_its_transaction_abort(int32_t client_id);
+
+#if ITS_READ_CACHE_SIZE > 0
+/**
+ * \brief Retrieves the statistics of the read cache. The hit ratio is
+ *        hits / (hits + misses). Only available when ITS_READ_CACHE_SIZE > 0.
+ *
+ * \param[out] stats  Filled with the current statistics
+ */
+void tfm_its_get_read_cache_stats(struct tfm_its_read_cache_stats_t *stats);
+#endif
+
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+/**
+ * \brief Retrieves the flash operations issued by a filesystem. The write
+ *        amplification is bytes_programmed over the bytes of asset data
+ *        written. Only available when ITS_FLASH_STATS_NUM_BLOCKS > 0.
+ *
+ * \param[in]  ps     If true, the counters of the PS filesystem are retrieved,
+ *                    otherwise the counters of the ITS filesystem
+ * \param[out] stats  Filled with the current counters
+ */
+void tfm_its_get_flash_stats(bool ps, struct its_flash_fs_stats_t *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2026, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -18,11 +18,17 @@
 #include "psa/service.h"
 #include "psa_manifest/tfm_internal_trusted_storage.h"
 #include "tfm_its_defs.h"
+#include "its_fault_bench.h"
 
 #if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
 static uint8_t *p_data;
 #else
 static psa_handle_t handle;
+/* The output vectors its_req_mngr_write() fills, in order */
+static const size_t *out_size;
+static size_t out_count;
+static size_t out_idx;
+static size_t out_written;
 #endif
 
 static psa_status_t tfm_its_set_req(const psa_msg_t *msg)
@@ -64,10 +70,12 @@ static psa_status_t tfm_its_get_req(const psa_msg_t *msg)
 {
     psa_status_t status;
     psa_storage_uid_t uid;
-    size_t data_size;
+    size_t data_size = 0;
     size_t data_length;
     size_t data_offset;
     size_t num;
+    size_t count;
+    size_t i;
 
     if (msg->in_size[0] != sizeof(uid) ||
         msg->in_size[1] != sizeof(data_offset)) {
@@ -84,23 +92,117 @@ static psa_status_t tfm_its_get_req(const psa_msg_t *msg)
     if (num != sizeof(data_offset)) {
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
+
+    /* The data is placed in the output vectors in order, each one being filled
+     * before the next one is used.
+     */
+    count = PSA_MAX_IOVEC;
+    while ((count > 1) && (msg->out_size[count - 1] == 0)) {
+        count--;
+    }
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    /* A mapped vector is written directly, so the data is read separately
+     * into each of them.
+     */
+    i = 0;
+    do {
+        data_size = msg->out_size[i];
+        if (data_size) {
+            p_data = (uint8_t *)psa_map_outvec(msg->handle, i);
+        } else {
+            p_data = NULL;
+        }
+        data_length = 0;
+        status = tfm_its_get(msg->client_id, uid, data_offset, data_size,
+                             &data_length);
+        if ((status == PSA_SUCCESS) && (data_size != 0)) {
+            psa_unmap_outvec(msg->handle, i, data_length);
+        }
+        data_offset += data_length;
+        i++;
+    } while ((status == PSA_SUCCESS) && (data_length == data_size) &&
+             (i < count));
+#else
+    for (i = 0; i < count; i++) {
+        data_size += msg->out_size[i];
+    }
+    handle = msg->handle;
+    out_size = msg->out_size;
+    out_count = count;
+    out_idx = 0;
+    out_written = 0;
+    status = tfm_its_get(msg->client_id, uid, data_offset, data_size,
+                         &data_length);
+#endif
+    return status;
+}
+
+static psa_status_t tfm_its_get_batch_req(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    psa_storage_uid_t uid;
+    size_t count;
+    size_t data_size;
+    size_t data_length;
+    size_t used = 0;
+    size_t num;
+    size_t i;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+    uint8_t *base = NULL;
+#endif
+
+    /* The UIDs are packed back to back, and each one has a status and a data
+     * length returned to the caller.
+     */
+    count = msg->in_size[0] / sizeof(uid);
+    if (count == 0 || msg->in_size[0] != count * sizeof(uid) ||
+        msg->out_size[1] != count * sizeof(status) ||
+        msg->out_size[2] != count * sizeof(data_length)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
     data_size = msg->out_size[0];
 #if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
     if (data_size) {
-        p_data = (uint8_t *)psa_map_outvec(msg->handle, 0);
-    } else {
-        p_data = NULL;
+        base = (uint8_t *)psa_map_outvec(msg->handle, 0);
     }
 #else
     handle = msg->handle;
+    out_size = msg->out_size;
+    out_count = 1;
+    out_idx = 0;
+    out_written = 0;
 #endif
-    status = tfm_its_get(msg->client_id, uid, data_offset, data_size, &data_length);
+
+    for (i = 0; i < count; i++) {
+        num = psa_read(msg->handle, 0, &uid, sizeof(uid));
+        if (num != sizeof(uid)) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+
+        /* The data of each UID follows the data of the previous one */
+#if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
+        p_data = (base != NULL) ? base + used : NULL;
+#endif
+        data_length = 0;
+        status = tfm_its_get(msg->client_id, uid, 0, data_size - used,
+                             &data_length);
+        if (status != PSA_SUCCESS) {
+            data_length = 0;
+        }
+        used += data_length;
+
+        psa_write(msg->handle, 1, &status, sizeof(status));
+        psa_write(msg->handle, 2, &data_length, sizeof(data_length));
+    }
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC == 1
-    if ((status == PSA_SUCCESS) && (data_size != 0)) {
-        psa_unmap_outvec(msg->handle, 0, data_length);
+    if (base != NULL) {
+        psa_unmap_outvec(msg->handle, 0, used);
     }
 #endif
-    return status;
+    return PSA_SUCCESS;
 }
 
 static psa_status_t tfm_its_get_info_req(const psa_msg_t *msg)
@@ -147,22 +249,142 @@ static psa_status_t tfm_its_remove_req(const psa_msg_t *msg)
     return tfm_its_remove(msg->client_id, uid);
 }
 
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+static psa_status_t tfm_its_get_flash_stats_req(const psa_msg_t *msg)
+{
+    struct its_flash_fs_stats_t stats;
+    struct tfm_its_flash_stats_t out = {0};
+    uint32_t fs;
+    size_t i;
+
+    if ((msg->in_size[0] != sizeof(fs)) ||
+        (msg->out_size[0] != sizeof(out))) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (psa_read(msg->handle, 0, &fs, sizeof(fs)) != sizeof(fs)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (fs == TFM_ITS_FLASH_STATS_PS) {
+#ifndef TFM_PARTITION_PROTECTED_STORAGE
+        return PSA_ERROR_NOT_SUPPORTED;
+#endif
+    } else if (fs != TFM_ITS_FLASH_STATS_ITS) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    tfm_its_get_flash_stats(fs == TFM_ITS_FLASH_STATS_PS, &stats);
+
+    out.num_reads = stats.num_reads;
+    out.num_programs = stats.num_programs;
+    out.num_erases = stats.num_erases;
+    out.bytes_read = stats.bytes_read;
+    out.bytes_programmed = stats.bytes_programmed;
+    for (i = 0; (i < TFM_ITS_FLASH_STATS_BLOCKS) &&
+                (i < ITS_FLASH_STATS_NUM_BLOCKS); i++) {
+        out.erase_count[i] = stats.erase_count[i];
+    }
+
+    psa_write(msg->handle, 0, &out, sizeof(out));
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_FLASH_STATS_NUM_BLOCKS > 0 */
+
+#if ITS_READ_CACHE_SIZE > 0
+static psa_status_t tfm_its_get_read_cache_stats_req(const psa_msg_t *msg)
+{
+    struct tfm_its_read_cache_stats_t stats;
+
+    if (msg->out_size[0] != sizeof(stats)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    tfm_its_get_read_cache_stats(&stats);
+    psa_write(msg->handle, 0, &stats, sizeof(stats));
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_READ_CACHE_SIZE > 0 */
+
+#if ITS_FS_FAULT_INJECTION
+static psa_status_t tfm_its_timed_req(uint32_t op,
+                                      psa_status_t (*req)(const psa_msg_t *),
+                                      const psa_msg_t *msg)
+{
+    uint32_t start = its_fault_bench_start();
+    psa_status_t status = req(msg);
+
+    its_fault_bench_record(op, start, status);
+
+    return status;
+}
+
+#define TFM_ITS_REQ(op, req, msg) tfm_its_timed_req(op, req, msg)
+#else
+#define TFM_ITS_REQ(op, req, msg) req(msg)
+#endif
+
 psa_status_t tfm_its_entry(void)
 {
+#if ITS_FS_FAULT_INJECTION
+    uint32_t start = its_fault_bench_init();
+    psa_status_t status = tfm_its_init();
+
+    /* Includes the recovery of an update interrupted by an injected reset */
+    its_fault_bench_mounted(start);
+
+    return status;
+#else
     return tfm_its_init();
+#endif
 }
 
 psa_status_t tfm_internal_trusted_storage_service_sfn(const psa_msg_t *msg)
 {
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    psa_status_t status;
+
+    status = tfm_its_transaction_check(msg->client_id);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+#endif
+
     switch (msg->type) {
     case TFM_ITS_SET:
-        return tfm_its_set_req(msg);
+        return TFM_ITS_REQ(TFM_ITS_FAULT_OP_SET, tfm_its_set_req, msg);
     case TFM_ITS_GET:
-        return tfm_its_get_req(msg);
+        return TFM_ITS_REQ(TFM_ITS_FAULT_OP_GET, tfm_its_get_req, msg);
     case TFM_ITS_GET_INFO:
         return tfm_its_get_info_req(msg);
+    case TFM_ITS_GET_BATCH:
+        return tfm_its_get_batch_req(msg);
+#if ITS_TRANSACTION_BUF_SIZE > 0
+    case TFM_ITS_TRANSACTION_BEGIN:
+        return tfm_its_transaction_begin(msg->client_id);
+    case TFM_ITS_TRANSACTION_COMMIT:
+        return tfm_its_transaction_commit(msg->client_id);
+    case TFM_ITS_TRANSACTION_ABORT:
+        return tfm_its_transaction_abort(msg->client_id);
+#endif
     case TFM_ITS_REMOVE:
-        return tfm_its_remove_req(msg);
+        return TFM_ITS_REQ(TFM_ITS_FAULT_OP_REMOVE, tfm_its_remove_req, msg);
+#if ITS_FS_FAULT_INJECTION
+    case TFM_ITS_FAULT_ARM:
+        return its_fault_bench_arm_req(msg);
+    case TFM_ITS_FAULT_GET_STATS:
+        return its_fault_bench_stats_req(msg);
+#endif
+#if ITS_FLASH_STATS_NUM_BLOCKS > 0
+    case TFM_ITS_GET_FLASH_STATS:
+        return tfm_its_get_flash_stats_req(msg);
+#endif
+#if ITS_READ_CACHE_SIZE > 0
+    case TFM_ITS_GET_READ_CACHE_STATS:
+        return tfm_its_get_read_cache_stats_req(msg);
+#endif
     default:
         return PSA_ERROR_NOT_SUPPORTED;
     }
@@ -184,7 +406,25 @@ size_t its_req_mngr_read(uint8_t *buf, size_t num_bytes)
 
 void its_req_mngr_write(const uint8_t *buf, size_t num_bytes)
 {
-    psa_write(handle, 0, buf, num_bytes);
+    size_t len;
+
+    while ((num_bytes > 0) && (out_idx < out_count)) {
+        len = out_size[out_idx] - out_written;
+        if (len > num_bytes) {
+            len = num_bytes;
+        }
+
+        psa_write(handle, out_idx, buf, len);
+        buf += len;
+        num_bytes -= len;
+        out_written += len;
+
+        /* Move on to the next vector once this one is full */
+        if (out_written == out_size[out_idx]) {
+            out_idx++;
+            out_written = 0;
+        }
+    }
 }
 #endif
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -11,21 +11,54 @@
 static void *memcpy_r(void *dest, const void *src, size_t n)
 {
     union composite_addr_t p_dst, p_src;
+    uint32_t w0, w1, w2, w3;
+    uint32_t offset;
 
     p_dst.uint_addr = (uintptr_t)dest + n;
     p_src.uint_addr = (uintptr_t)src  + n;
 
-    /* Byte copy for unaligned address. check the last bit of address. */
-    while (n && (ADDR_WORD_UNALIGNED(p_dst.uint_addr) ||
-                 ADDR_WORD_UNALIGNED(p_src.uint_addr))) {
+    /* Byte copy until the destination end is word aligned. */
+    while (n && ADDR_WORD_UNALIGNED(p_dst.uint_addr)) {
         *(--p_dst.p_byte) = *(--p_src.p_byte);
         n--;
     }
 
-    /* Quad byte copy for aligned address. */
-    while (n >= sizeof(uint32_t)) {
-        *(--p_dst.p_word) = *(--p_src.p_word);
-        n -= sizeof(uint32_t);
+    offset = ADDR_WORD_UNALIGNED(p_src.uint_addr);
+
+    if (offset == 0) {
+        /* Burst copy for aligned addresses, loaded before being stored. */
+        while (n >= BURST_SIZE) {
+            p_src.p_word -= 4;
+            p_dst.p_word -= 4;
+            w3 = p_src.p_word[3];
+            w2 = p_src.p_word[2];
+            w1 = p_src.p_word[1];
+            w0 = p_src.p_word[0];
+            p_dst.p_word[3] = w3;
+            p_dst.p_word[2] = w2;
+            p_dst.p_word[1] = w1;
+            p_dst.p_word[0] = w0;
+            n -= BURST_SIZE;
+        }
+
+        /* Quad byte copy for the remaining words. */
+        while (n >= sizeof(uint32_t)) {
+            *(--p_dst.p_word) = *(--p_src.p_word);
+            n -= sizeof(uint32_t);
+        }
+    } else if (n >= sizeof(uint32_t)) {
+        /* Read the source by aligned words and merge them, as in memcpy. */
+        p_src.uint_addr -= offset;
+        w1 = *p_src.p_word;
+
+        while (n >= sizeof(uint32_t)) {
+            w0 = *(--p_src.p_word);
+            *(--p_dst.p_word) = WORD_MERGE(w0, w1, offset);
+            w1 = w0;
+            n -= sizeof(uint32_t);
+        }
+
+        p_src.uint_addr += offset;
     }
 
     /* Byte copy for the remaining bytes. */
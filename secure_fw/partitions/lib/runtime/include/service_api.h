@@ -8,7 +8,11 @@
 #define __SERVICE_API_H__
 
 #include <stdint.h>
+#include "config_tfm.h"
+#include "psa/error.h"
+#include "psa/service.h"
 #include "tfm_boot_status.h"
+#include "tfm_service_stats.h"
 
 /**
  * \brief Retrieve secure partition related data from shared memory area, which
@@ -22,4 +26,70 @@ int32_t tfm_core_get_boot_data(uint8_t major_type,
                                struct tfm_boot_data *boot_data,
                                uint32_t len);
 
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+/**
+ * \brief Retrieve the usage statistics of a RoT Service. Only PSA-RoT
+ *        Partitions are allowed.
+ *
+ * \param[in]  index       Index of the service, in SID order.
+ * \param[out] stat        Buffer receiving the statistics.
+ * \param[in]  len         The size of \p stat in bytes.
+ *
+ * \retval PSA_SUCCESS                  Success.
+ * \retval PSA_ERROR_DOES_NOT_EXIST     \p index is beyond the last service.
+ * \retval Other return code            Operation failed with an error code.
+ */
+psa_status_t tfm_core_get_service_stats(uint32_t index,
+                                        struct tfm_service_stat_t *stat,
+                                        uint32_t len);
+#endif
+
+#if (CONFIG_TFM_FLIH_API == 1) || (CONFIG_TFM_SLIH_API == 1)
+/**
+ * \brief Get the number of interrupt events behind an IRQ signal. For an IRQ
+ *        with "irq_coalesce_count" set, one signal stands for several events.
+ *        The count accumulated since the last call is returned and cleared.
+ *
+ * \param[in]  irq_signal  The IRQ signal of the calling Partition.
+ *
+ * \retval Event count, always 1 for an IRQ that does not coalesce events.
+ */
+uint32_t tfm_core_get_irq_event_count(psa_signal_t irq_signal);
+#endif
+
+#if CONFIG_TFM_DOORBELL_API == 1
+/**
+ * \brief Send the PSA_DOORBELL signal to several Secure Partitions, as
+ *        psa_notify() does for each of them. The scheduler runs once after
+ *        all the signals are asserted, instead of once per target.
+ *
+ * \param[in]  partition_ids  Secure Partition IDs of the targets.
+ * \param[in]  num            Number of entries in \p partition_ids.
+ *
+ * \note It is a PROGRAMMER ERROR if an ID does not correspond to a Secure
+ *       Partition.
+ */
+void tfm_core_notify_multi(const int32_t *partition_ids, uint32_t num);
+#endif
+
+#ifdef CONFIG_TFM_SPM_TRACE
+/* Partition trace events, and the meaning of arg0/arg1 */
+#define TFM_TRACE_EVT_FLASH_READ        0x80    /* block ID, size          */
+#define TFM_TRACE_EVT_FLASH_PROGRAM     0x81    /* block ID, size          */
+#define TFM_TRACE_EVT_FLASH_ERASE       0x82    /* block ID, 0             */
+#define TFM_TRACE_EVT_FLASH_DONE        0x83    /* operation event, status */
+#define TFM_TRACE_EVT_PERF_BEGIN        0x90    /* benchmark, iterations   */
+#define TFM_TRACE_EVT_PERF_END          0x91    /* benchmark, 0            */
+
+/**
+ * \brief Record an event of the calling Partition in the SPM trace ring, with
+ *        the cycle count and the PID of the Partition.
+ *
+ * \param[in]  event       Event, TFM_TRACE_EVT_* between 0x80 and 0xFFFF.
+ * \param[in]  arg0        First argument of the event.
+ * \param[in]  arg1        Second argument of the event.
+ */
+void tfm_core_trace_event(uint32_t event, uint32_t arg0, uint32_t arg1);
+#endif
+
 #endif /* __SERVICE_API_H__ */
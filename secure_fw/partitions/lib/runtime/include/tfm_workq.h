@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef __TFM_WORKQ_H__
+#define __TFM_WORKQ_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/service.h"
+#include "tfm_api.h"
+
+/*
+ * Deferred work queue of an IPC model Partition
+ *
+ * A job is a bounded step of background work, such as a compaction or a pool
+ * refill. The Partition queues its jobs, and waits for its signals with
+ * tfm_workq_wait() instead of psa_wait(). While jobs are queued, the idle
+ * Partition wakes it up with TFM_WORKQ_SIGNAL whenever the SPE has nothing
+ * else to run, and one job step is run from the Partition thread. Requests
+ * are thus always served first.
+ *
+ * Each Partition owns its queue. The queue is not protected against
+ * concurrent accesses, so it must only be used from the Partition thread.
+ */
+
+/**
+ * \brief A step of a job.
+ *
+ * \param[in] arg               The job argument.
+ *
+ * \return true if the job has more work to do, then it is queued again
+ *         behind the other jobs. false if the job is finished.
+ */
+typedef bool (*tfm_workq_fn_t)(void *arg);
+
+struct tfm_workq_job_t {
+    struct tfm_workq_job_t *next;
+    tfm_workq_fn_t fn;
+    void *arg;
+    bool queued;
+};
+
+struct tfm_workq_t {
+    struct tfm_workq_job_t *head;       /* Next job to run                */
+    struct tfm_workq_job_t *tail;       /* Last queued job                */
+};
+
+#define TFM_WORKQ_INIT                  { NULL, NULL }
+#define TFM_WORKQ_JOB_INIT(fn, arg)     { NULL, (fn), (arg), false }
+
+/**
+ * \brief Queue a job. A job which is already queued is left in place.
+ *
+ * \param[in] q                 The queue of the Partition.
+ * \param[in] job               The job, which must stay valid while queued.
+ */
+void tfm_workq_submit(struct tfm_workq_t *q, struct tfm_workq_job_t *job);
+
+/**
+ * \brief Remove a job from the queue, if it is queued.
+ */
+void tfm_workq_cancel(struct tfm_workq_t *q, struct tfm_workq_job_t *job);
+
+/**
+ * \brief Run one step of the job at the head of the queue.
+ *
+ * \return true if jobs remain in the queue.
+ */
+bool tfm_workq_run_one(struct tfm_workq_t *q);
+
+static inline bool tfm_workq_pending(const struct tfm_workq_t *q)
+{
+    return q->head != NULL;
+}
+
+/**
+ * \brief psa_wait() that runs the queued jobs when the SPE is idle.
+ *
+ * \param[in] q                 The queue of the Partition.
+ * \param[in] signal_mask       The signals to wait for, as with psa_wait().
+ * \param[in] timeout           PSA_BLOCK, PSA_POLL, or a number of ticks with
+ *                              CONFIG_TFM_SPM_TIMER.
+ *
+ * \return The asserted signals of \p signal_mask. With PSA_BLOCK, it only
+ *         returns when one of them is asserted. Otherwise, it also returns
+ *         0 once the timeout expired or a job step was run.
+ */
+psa_signal_t tfm_workq_wait(struct tfm_workq_t *q, psa_signal_t signal_mask,
+                            uint32_t timeout);
+
+#endif /* __TFM_WORKQ_H__ */
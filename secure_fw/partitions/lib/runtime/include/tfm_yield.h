@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef __TFM_YIELD_H__
+#define __TFM_YIELD_H__
+
+#include "config_impl.h"
+#include "config_tfm.h"
+#include "psa/service.h"
+#include "tfm_api.h"
+
+/*
+ * Preemption point of a long Partition operation
+ *
+ * Higher priority Partitions preempt a Partition whenever they become
+ * runnable, but the Partitions of the same priority wait for it to block. A
+ * long operation, such as a file system compaction, calls tfm_yield() between
+ * its steps to let them run. Its state is kept on the Partition stack, so the
+ * step must leave the Partition data consistent for the services it may call.
+ *
+ * It does nothing without CONFIG_TFM_PREEMPTION_POINTS, and the SPM only
+ * supports it with the IPC backend, where the Partitions have their own thread.
+ */
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1 && CONFIG_TFM_PREEMPTION_POINTS == 1
+static inline void tfm_yield(void)
+{
+    (void)psa_wait(PSA_WAIT_ANY, PSA_POLL | TFM_WAIT_YIELD);
+}
+#else
+#define tfm_yield()
+#endif
+
+#endif /* __TFM_YIELD_H__ */
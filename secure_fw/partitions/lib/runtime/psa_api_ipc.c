@@ -148,4 +148,17 @@ void psa_unmap_outvec(psa_handle_t msg_handle, uint32_t outvec_idx, size_t len)
 {
     PART_METADATA()->psa_fns->psa_unmap_outvec(msg_handle, outvec_idx, len);
 }
+
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+void *psa_map_shared_outvec(psa_handle_t msg_handle, uint32_t outvec_idx)
+{
+    return PART_METADATA()->psa_fns->psa_map_shared_outvec(msg_handle,
+                                                           outvec_idx);
+}
+
+void *psa_get_shared_outvec(psa_handle_t msg_handle, size_t *len)
+{
+    return PART_METADATA()->psa_fns->psa_get_shared_outvec(msg_handle, len);
+}
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1 */
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
@@ -22,6 +22,52 @@ int32_t tfm_core_get_boot_data(uint8_t major_type,
         );
 }
 
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+__attribute__((naked))
+psa_status_t tfm_core_get_service_stats(uint32_t index,
+                                        struct tfm_service_stat_t *stat,
+                                        uint32_t len)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_GET_SERVICE_STATS)"           \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif
+
+#if (CONFIG_TFM_FLIH_API == 1) || (CONFIG_TFM_SLIH_API == 1)
+__attribute__((naked))
+uint32_t tfm_core_get_irq_event_count(psa_signal_t irq_signal)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_GET_IRQ_EVENT_COUNT)"         \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif
+
+#if CONFIG_TFM_DOORBELL_API == 1
+__attribute__((naked))
+void tfm_core_notify_multi(const int32_t *partition_ids, uint32_t num)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_NOTIFY_MULTI)"                \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif
+
+#ifdef CONFIG_TFM_SPM_TRACE
+__attribute__((naked))
+void tfm_core_trace_event(uint32_t event, uint32_t arg0, uint32_t arg1)
+{
+    __ASM volatile(
+        "SVC    "M2S(TFM_SVC_TRACE_EVENT)"                 \n"
+        "BX     lr                                         \n"
+        );
+}
+#endif
+
 #if TFM_LVL != 1
 /* Entry point when Partition FLIH functions return */
 __attribute__((naked))
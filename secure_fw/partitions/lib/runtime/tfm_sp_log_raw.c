@@ -10,6 +10,80 @@
 #include <stdint.h>
 #include "tfm_hal_defs.h"
 #include "tfm_hal_sp_logdev.h"
+#ifdef TFM_LOG_TOKENIZED
+#include <string.h>
+#include "tfm_log_token.h"
+#include "tfm_strnlen.h"
+#endif
+
+#ifdef TFM_LOG_TOKENIZED
+/*
+ * The format string is not processed here, it is only walked to collect the
+ * arguments. The whole record is output at once so that it can't be split by
+ * other log output.
+ */
+int vprintf(const char *fmt, va_list ap)
+{
+    uint8_t record[TFM_LOG_TOKEN_SP_MAX_SIZE];
+    size_t pos = 1 + sizeof(uint32_t);
+    uint32_t nargs = 0;
+    uint32_t max_args = TFM_LOG_TOKEN_SP_MAX_ARGS;
+    const char *str;
+    size_t len;
+
+    if (fmt == NULL) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    (void)tfm_log_token_put_u32(&record[1], (uint32_t)(uintptr_t)fmt);
+
+    while (*fmt && nargs < max_args) {
+        if (*fmt++ != '%') {
+            continue;
+        }
+
+        switch (*fmt) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'p':
+        case 'c':
+            if (pos + sizeof(uint32_t) > sizeof(record)) {
+                /* The arguments after this one are not output either */
+                max_args = nargs;
+                break;
+            }
+            pos += tfm_log_token_put_u32(&record[pos], va_arg(ap, uint32_t));
+            nargs++;
+            break;
+        case 's':
+            if (pos + 1 > sizeof(record)) {
+                max_args = nargs;
+                break;
+            }
+            str = va_arg(ap, const char *);
+            len = tfm_strnlen(str, sizeof(record) - pos - 1);
+            record[pos++] = (uint8_t)len;
+            memcpy(&record[pos], str, len);
+            pos += len;
+            nargs++;
+            break;
+        case '%':
+            break;
+        default:
+            /* Unsupported tags don't take an argument */
+            continue;
+        }
+        fmt++;
+    }
+
+    record[0] = (uint8_t)(TFM_LOG_TOKEN_SP_FMT | nargs);
+
+    return tfm_hal_output_sp_log(record, pos);
+}
+#else /* TFM_LOG_TOKENIZED */
 
 #define PRINT_BUFF_SIZE 32
 #define NUM_BUFF_SIZE 12
@@ -161,6 +235,7 @@ int vprintf(const char *fmt, va_list ap)
 
     return count;
 }
+#endif /* TFM_LOG_TOKENIZED */
 
 int printf(const char *fmt, ...)
 {
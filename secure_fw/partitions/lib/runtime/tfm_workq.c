@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "config_tfm.h"
+#include "psa/service.h"
+#include "tfm_api.h"
+#include "tfm_workq.h"
+
+#if CONFIG_TFM_WORKQ == 1
+
+void tfm_workq_submit(struct tfm_workq_t *q, struct tfm_workq_job_t *job)
+{
+    if (job->queued) {
+        return;
+    }
+
+    job->next = NULL;
+    job->queued = true;
+
+    if (q->tail) {
+        q->tail->next = job;
+    } else {
+        q->head = job;
+    }
+    q->tail = job;
+}
+
+void tfm_workq_cancel(struct tfm_workq_t *q, struct tfm_workq_job_t *job)
+{
+    struct tfm_workq_job_t *prev = NULL;
+    struct tfm_workq_job_t *cur;
+
+    if (!job->queued) {
+        return;
+    }
+
+    for (cur = q->head; cur != NULL; prev = cur, cur = cur->next) {
+        if (cur != job) {
+            continue;
+        }
+
+        if (prev) {
+            prev->next = job->next;
+        } else {
+            q->head = job->next;
+        }
+        if (q->tail == job) {
+            q->tail = prev;
+        }
+        break;
+    }
+
+    job->next = NULL;
+    job->queued = false;
+}
+
+bool tfm_workq_run_one(struct tfm_workq_t *q)
+{
+    struct tfm_workq_job_t *job = q->head;
+
+    if (!job) {
+        return false;
+    }
+
+    /* Dequeued before it runs, so that the step can submit it again */
+    q->head = job->next;
+    if (!q->head) {
+        q->tail = NULL;
+    }
+    job->next = NULL;
+    job->queued = false;
+
+    if (job->fn(job->arg)) {
+        tfm_workq_submit(q, job);
+    }
+
+    return tfm_workq_pending(q);
+}
+
+psa_signal_t tfm_workq_wait(struct tfm_workq_t *q, psa_signal_t signal_mask,
+                            uint32_t timeout)
+{
+    psa_signal_t signals;
+
+    signal_mask &= ~TFM_WORKQ_SIGNAL;
+
+    while (1) {
+        signals = psa_wait(signal_mask,
+                           tfm_workq_pending(q) ? timeout | TFM_WAIT_WORKQ
+                                                : timeout);
+
+        if (signals & TFM_WORKQ_SIGNAL) {
+            (void)tfm_workq_run_one(q);
+            signals &= ~TFM_WORKQ_SIGNAL;
+        }
+
+        if (signals != 0 || timeout != PSA_BLOCK) {
+            return signals;
+        }
+    }
+}
+
+#endif /* CONFIG_TFM_WORKQ == 1 */
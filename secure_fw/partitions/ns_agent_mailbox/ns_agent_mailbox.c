@@ -29,6 +29,8 @@ void ns_agent_mailbox_entry(void)
 
     boot_ns_core();
 
+    tfm_multi_core_mem_check_init();
+
     if (tfm_inter_core_comm_init()) {
         LOG_ERRFMT("Inter-core communication init failed\r\n");
         psa_panic();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2022 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -16,42 +16,13 @@
 #include "tfm_hal_multi_core.h"
 #include "tfm_multi_core.h"
 #include "tfm_arch.h"
+#include "critical_section.h"
 #include "utilities.h"
 
 #ifndef TFM_LVL
 #error TFM_LVL is not defined!
 #endif
 
-void tfm_get_mem_region_security_attr(const void *p, size_t s,
-                                      struct security_attr_info_t *p_attr)
-{
-    p_attr->is_valid = true;
-
-    if (check_address_range(p, s, NS_DATA_START,
-                            NS_DATA_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_secure = false;
-        return;
-    }
-
-    if (check_address_range(p, s, NS_CODE_START,
-                            NS_CODE_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_secure = false;
-        return;
-    }
-
-    if (check_address_range(p, s, S_DATA_START, S_DATA_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_secure = true;
-        return;
-    }
-
-    if (check_address_range(p, s, S_CODE_START, S_CODE_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_secure = true;
-        return;
-    }
-
-    p_attr->is_valid = false;
-}
-
 #if TFM_LVL == 2
 REGION_DECLARE(Image$$, TFM_UNPRIV_CODE, $$RO$$Base);
 REGION_DECLARE(Image$$, TFM_UNPRIV_CODE, $$RO$$Limit);
@@ -65,147 +36,386 @@ REGION_DECLARE(Image$$, TFM_APP_RW_STACK_START, $$Base);
 REGION_DECLARE(Image$$, TFM_APP_RW_STACK_END, $$Base);
 #endif
 
-void tfm_get_secure_mem_region_attr(const void *p, size_t s,
-                                    struct mem_attr_info_t *p_attr)
+/* The maximal number of regions in one region list */
+#define MEM_REGION_LIST_SIZE            6
+/* Every region adds at most two boundaries to the lookup table */
+#define MEM_REGION_TBL_SIZE             (3 * 2 * MEM_REGION_LIST_SIZE)
+/* No region in a list covers the table entry */
+#define MEM_REGION_NONE                 (-1)
+
+/* A memory region and the attributes a range inside it gets */
+struct mem_region_t {
+    uintptr_t base;
+    uintptr_t limit;
+    bool is_secure;
+    struct mem_attr_info_t attr;
+};
+
+/*
+ * Regions in priority order. A range takes the attributes of the first
+ * region in the list which contains the whole range.
+ */
+struct mem_region_list_t {
+    struct mem_region_t regions[MEM_REGION_LIST_SIZE];
+    int8_t num;
+};
+
+/*
+ * A piece of the memory map inside which no region of any list starts or
+ * ends. Every region containing an address of the piece contains all of it,
+ * so a range inside the piece resolves to the same regions as the piece.
+ */
+struct mem_region_tbl_entry_t {
+    uintptr_t base;
+    uintptr_t limit;
+    int8_t security_idx;            /* Index in security_regions */
+    int8_t secure_idx;              /* Index in secure_regions */
+    int8_t ns_idx;                  /* Index in ns_regions */
+};
+
+static const struct mem_attr_info_t attr_rw_all = {
+    .is_valid = true, .is_xn = true,
+    .is_priv_rd_allow = true, .is_priv_wr_allow = true,
+    .is_unpriv_rd_allow = true, .is_unpriv_wr_allow = true,
+};
+
+static const struct mem_attr_info_t attr_ro_all = {
+    .is_valid = true, .is_xn = false,
+    .is_priv_rd_allow = true, .is_priv_wr_allow = false,
+    .is_unpriv_rd_allow = true, .is_unpriv_wr_allow = false,
+};
+
+#if TFM_LVL == 2
+static const struct mem_attr_info_t attr_rw_priv = {
+    .is_valid = true, .is_xn = true,
+    .is_priv_rd_allow = true, .is_priv_wr_allow = true,
+    .is_unpriv_rd_allow = false, .is_unpriv_wr_allow = false,
+};
+
+static const struct mem_attr_info_t attr_ro_priv = {
+    .is_valid = true, .is_xn = false,
+    .is_priv_rd_allow = true, .is_priv_wr_allow = false,
+    .is_unpriv_rd_allow = false, .is_unpriv_wr_allow = false,
+};
+#endif
+
+static struct mem_region_list_t security_regions;
+static struct mem_region_list_t secure_regions;
+static struct mem_region_list_t ns_regions;
+
+/* Sorted by base address, the entries do not overlap */
+static struct mem_region_tbl_entry_t mem_region_tbl[MEM_REGION_TBL_SIZE];
+static uint32_t mem_region_tbl_num;
+/* Consecutive checks of one request usually hit the same entry */
+static uint32_t mem_region_tbl_last;
+static volatile bool mem_region_tbl_ready;
+
+static void mem_region_add(struct mem_region_list_t *list,
+                           uintptr_t base, uintptr_t limit, bool is_secure,
+                           const struct mem_attr_info_t *attr)
 {
-#if TFM_LVL == 1
-    p_attr->is_mpu_enabled = false;
-    p_attr->is_valid = true;
-
-    if (check_address_range(p, s, S_DATA_START, S_DATA_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
-        return;
-    }
+    struct mem_region_t *region;
 
-    if (check_address_range(p, s, S_CODE_START, S_CODE_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
+    if (list->num >= MEM_REGION_LIST_SIZE) {
+        tfm_core_panic();
     }
 
-    p_attr->is_valid = false;
-#elif TFM_LVL == 2
-    uintptr_t base, limit;
+    region = &list->regions[list->num++];
+    region->base = base;
+    region->limit = limit;
+    region->is_secure = is_secure;
+    region->attr = *attr;
+}
 
-    p_attr->is_mpu_enabled = false;
-    p_attr->is_valid = true;
+static void mem_region_lists_init(void)
+{
+    security_regions.num = 0;
+    secure_regions.num = 0;
+    ns_regions.num = 0;
+
+    mem_region_add(&security_regions, NS_DATA_START, NS_DATA_LIMIT, false,
+                   &attr_rw_all);
+    mem_region_add(&security_regions, NS_CODE_START, NS_CODE_LIMIT, false,
+                   &attr_ro_all);
+    mem_region_add(&security_regions, S_DATA_START, S_DATA_LIMIT, true,
+                   &attr_rw_all);
+    mem_region_add(&security_regions, S_CODE_START, S_CODE_LIMIT, true,
+                   &attr_ro_all);
 
+#if TFM_LVL == 1
+    mem_region_add(&secure_regions, S_DATA_START, S_DATA_LIMIT, true,
+                   &attr_rw_all);
+    mem_region_add(&secure_regions, S_CODE_START, S_CODE_LIMIT, true,
+                   &attr_ro_all);
+#elif TFM_LVL == 2
     /* TFM Core unprivileged code region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE, $$RO$$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE, $$RO$$Limit) - 1;
-    if (check_address_range(p, s, base, limit) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
-    }
+    mem_region_add(&secure_regions,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE, $$RO$$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_UNPRIV_CODE, $$RO$$Limit) - 1,
+        true, &attr_ro_all);
 
 #ifdef CONFIG_TFM_PARTITION_META
     /* TFM partition metadata pointer region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Limit) - 1;
-    if (check_address_range(p, s, base, limit) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
-        return;
-    }
+    mem_region_add(&secure_regions,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_SP_META_PTR, $$ZI$$Limit) - 1,
+        true, &attr_rw_all);
 #endif
 
     /* APP RoT partition RO region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_START, $$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_END, $$Base) - 1;
-    if (check_address_range(p, s, base, limit) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
-    }
+    mem_region_add(&secure_regions,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_START, $$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_CODE_END, $$Base) - 1,
+        true, &attr_ro_all);
 
     /* RW, ZI and stack as one region */
-    base = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_START, $$Base);
-    limit = (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_END, $$Base) - 1;
-    if (check_address_range(p, s, base, limit) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
-        return;
-    }
+    mem_region_add(&secure_regions,
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_START, $$Base),
+        (uintptr_t)&REGION_NAME(Image$$, TFM_APP_RW_STACK_END, $$Base) - 1,
+        true, &attr_rw_all);
 
     /*
      * Treat the remaining parts in secure data section and secure code section
      * as privileged regions
      */
-    base = (uintptr_t)S_DATA_START;
-    limit = (uintptr_t)S_DATA_LIMIT;
-    if (check_address_range(p, s, base, limit) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = false;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = true;
-        return;
+    mem_region_add(&secure_regions, S_DATA_START, S_DATA_LIMIT, true,
+                   &attr_rw_priv);
+    mem_region_add(&secure_regions, S_CODE_START, S_CODE_LIMIT, true,
+                   &attr_ro_priv);
+#else
+#error "Cannot support current TF-M isolation level"
+#endif
+
+    mem_region_add(&ns_regions, NS_DATA_START, NS_DATA_LIMIT, false,
+                   &attr_rw_all);
+    mem_region_add(&ns_regions, NS_CODE_START, NS_CODE_LIMIT, false,
+                   &attr_ro_all);
+}
+
+/* Return the index of the first region in the list containing the range. */
+static int8_t mem_region_find(const struct mem_region_list_t *list,
+                              uintptr_t base, uintptr_t limit)
+{
+    int8_t i;
+
+    for (i = 0; i < list->num; i++) {
+        if ((base >= list->regions[i].base) &&
+            (limit <= list->regions[i].limit)) {
+            return i;
+        }
     }
 
-    base = (uintptr_t)S_CODE_START;
-    limit = (uintptr_t)S_CODE_LIMIT;
-    if (check_address_range(p, s, base, limit) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = false;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
-        return;
+    return MEM_REGION_NONE;
+}
+
+/* Insert a boundary into the sorted array of boundaries, without duplicates */
+static void mem_region_add_boundary(uintptr_t *bounds, uint32_t *num,
+                                    uintptr_t addr)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < *num; i++) {
+        if (bounds[i] == addr) {
+            return;
+        }
+        if (bounds[i] > addr) {
+            break;
+        }
     }
 
-    p_attr->is_valid = false;
-#else
-#error "Cannot support current TF-M isolation level"
-#endif
+    for (j = *num; j > i; j--) {
+        bounds[j] = bounds[j - 1];
+    }
+    bounds[i] = addr;
+    (*num)++;
 }
 
-void tfm_get_ns_mem_region_attr(const void *p, size_t s,
-                                struct mem_attr_info_t *p_attr)
+static void mem_region_add_list_boundaries(const struct mem_region_list_t *list,
+                                           uintptr_t *bounds, uint32_t *num)
 {
-    p_attr->is_mpu_enabled = false;
-    p_attr->is_valid = true;
-
-    if (check_address_range(p, s, NS_DATA_START,
-                            NS_DATA_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = true;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = true;
-        p_attr->is_xn = true;
-        return;
+    int8_t i;
+
+    for (i = 0; i < list->num; i++) {
+        mem_region_add_boundary(bounds, num, list->regions[i].base);
+        /* A region ending at the top of the map has no boundary after it */
+        if (list->regions[i].limit != UINTPTR_MAX) {
+            mem_region_add_boundary(bounds, num, list->regions[i].limit + 1);
+        }
     }
+}
+
+void tfm_multi_core_mem_check_init(void)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    uintptr_t bounds[MEM_REGION_TBL_SIZE + 1];
+    struct mem_region_tbl_entry_t *entry;
+    uint32_t nbounds = 0, i;
 
-    if (check_address_range(p, s, NS_CODE_START,
-                            NS_CODE_LIMIT) == TFM_SUCCESS) {
-        p_attr->is_priv_rd_allow = true;
-        p_attr->is_priv_wr_allow = false;
-        p_attr->is_unpriv_rd_allow = true;
-        p_attr->is_unpriv_wr_allow = false;
-        p_attr->is_xn = false;
+    CRITICAL_SECTION_ENTER(cs);
+
+    if (mem_region_tbl_ready) {
+        CRITICAL_SECTION_LEAVE(cs);
         return;
     }
 
-    p_attr->is_valid = false;
+    mem_region_lists_init();
+
+    mem_region_add_list_boundaries(&security_regions, bounds, &nbounds);
+    mem_region_add_list_boundaries(&secure_regions, bounds, &nbounds);
+    mem_region_add_list_boundaries(&ns_regions, bounds, &nbounds);
+
+    mem_region_tbl_num = 0;
+    for (i = 0; i + 1 < nbounds; i++) {
+        entry = &mem_region_tbl[mem_region_tbl_num];
+        entry->base = bounds[i];
+        entry->limit = bounds[i + 1] - 1;
+        entry->security_idx = mem_region_find(&security_regions,
+                                              entry->base, entry->limit);
+        entry->secure_idx = mem_region_find(&secure_regions,
+                                            entry->base, entry->limit);
+        entry->ns_idx = mem_region_find(&ns_regions,
+                                        entry->base, entry->limit);
+
+        /* Gaps between regions are left to the slow path */
+        if ((entry->security_idx != MEM_REGION_NONE) ||
+            (entry->secure_idx != MEM_REGION_NONE) ||
+            (entry->ns_idx != MEM_REGION_NONE)) {
+            mem_region_tbl_num++;
+        }
+    }
+
+    mem_region_tbl_last = 0;
+    mem_region_tbl_ready = true;
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+/*
+ * Return the table entry containing the whole range, or NULL if the range
+ * crosses a boundary or lies in a gap.
+ */
+static const struct mem_region_tbl_entry_t *mem_region_tbl_lookup(
+                                                    const void *p, size_t s)
+{
+    const struct mem_region_tbl_entry_t *entry;
+    uintptr_t base = (uintptr_t)p;
+    uintptr_t limit;
+    uint32_t lo, hi, mid;
+
+    if (!mem_region_tbl_ready) {
+        tfm_multi_core_mem_check_init();
+    }
+
+    if ((s == 0) || (base > UINTPTR_MAX - s)) {
+        return NULL;
+    }
+    limit = base + s - 1;
+
+    entry = &mem_region_tbl[mem_region_tbl_last];
+    if ((mem_region_tbl_last < mem_region_tbl_num) &&
+        (base >= entry->base) && (base <= entry->limit)) {
+        return (limit <= entry->limit) ? entry : NULL;
+    }
+
+    /* Find the last entry starting at or below the base */
+    lo = 0;
+    hi = mem_region_tbl_num;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (mem_region_tbl[mid].base <= base) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) {
+        return NULL;
+    }
+
+    entry = &mem_region_tbl[lo - 1];
+    if (limit > entry->limit) {
+        return NULL;
+    }
+
+    mem_region_tbl_last = lo - 1;
+
+    return entry;
+}
+
+/*
+ * Resolve the range to a region of the list, through the table when the range
+ * lies inside one entry and by the priority order otherwise.
+ */
+static const struct mem_region_t *mem_region_resolve(
+                                        const struct mem_region_list_t *list,
+                                        const void *p, size_t s)
+{
+    const struct mem_region_tbl_entry_t *entry = mem_region_tbl_lookup(p, s);
+    int8_t idx = MEM_REGION_NONE;
+    int8_t i;
+
+    if (entry) {
+        if (list == &security_regions) {
+            idx = entry->security_idx;
+        } else if (list == &secure_regions) {
+            idx = entry->secure_idx;
+        } else {
+            idx = entry->ns_idx;
+        }
+    } else {
+        for (i = 0; i < list->num; i++) {
+            if (check_address_range(p, s, list->regions[i].base,
+                                    list->regions[i].limit) == TFM_SUCCESS) {
+                idx = i;
+                break;
+            }
+        }
+    }
+
+    return (idx == MEM_REGION_NONE) ? NULL : &list->regions[idx];
+}
+
+void tfm_get_mem_region_security_attr(const void *p, size_t s,
+                                      struct security_attr_info_t *p_attr)
+{
+    const struct mem_region_t *region;
+
+    region = mem_region_resolve(&security_regions, p, s);
+    if (region) {
+        p_attr->is_valid = true;
+        p_attr->is_secure = region->is_secure;
+    } else {
+        p_attr->is_valid = false;
+    }
+}
+
+void tfm_get_secure_mem_region_attr(const void *p, size_t s,
+                                    struct mem_attr_info_t *p_attr)
+{
+    const struct mem_region_t *region;
+
+    region = mem_region_resolve(&secure_regions, p, s);
+    if (region) {
+        *p_attr = region->attr;
+    } else {
+        p_attr->is_mpu_enabled = false;
+        p_attr->is_valid = false;
+    }
+}
+
+void tfm_get_ns_mem_region_attr(const void *p, size_t s,
+                                struct mem_attr_info_t *p_attr)
+{
+    const struct mem_region_t *region;
+
+    region = mem_region_resolve(&ns_regions, p, s);
+    if (region) {
+        *p_attr = region->attr;
+    } else {
+        p_attr->is_mpu_enabled = false;
+        p_attr->is_valid = false;
+    }
 }
 
 static void security_attr_init(struct security_attr_info_t *p_attr)
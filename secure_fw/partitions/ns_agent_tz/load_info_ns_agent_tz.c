@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2021-2022 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -18,6 +18,7 @@
 #include "load/partition_defs.h"
 #include "load/service_defs.h"
 #include "load/asset_defs.h"
+#include "runtime_defs.h"
 /* Note that region_defs.h must be included before tfm_s_linker_alignments.h
  * to let platform overwrite default alignment values.
  */
@@ -41,12 +42,22 @@ extern void ns_agent_tz_main(void);
 /* Stack */
 uint8_t ns_agent_tz_stack[TFM_NS_AGENT_TZ_STACK_SIZE_ALIGNED] __aligned(TFM_LINKER_NS_AGENT_TZ_STACK_ALIGNMENT);
 
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+/* Runtime metadata */
+static const struct runtime_metadata_t ns_agent_tz_metadata = {
+    .entry                          = (uintptr_t)ns_agent_tz_main,
+    .psa_fns                        = RUNTIME_METADATA_PSA_FNS,
+    .n_sfn                          = 0,
+};
+#endif
+
 struct partition_tfm_sp_ns_agent_tz_load_info_t {
     /* common length load data */
     struct partition_load_info_t    load_info;
     /* per-partition variable length load data */
     uintptr_t                       stack_addr;
     uintptr_t                       heap_addr;
+    uintptr_t                       metadata_addr;
 #if TFM_LVL == 3
     struct asset_desc_t             assets[TFM_SP_NS_AGENT_NASSETS];
 #endif
@@ -80,6 +91,11 @@ const struct partition_tfm_sp_ns_agent_tz_load_info_t
     },
     .stack_addr                     = (uintptr_t)ns_agent_tz_stack,
     .heap_addr                      = 0,
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    .metadata_addr                  = (uintptr_t)&ns_agent_tz_metadata,
+#else
+    .metadata_addr                  = 0,
+#endif
 #if TFM_LVL == 3
     .assets                         = {
         {
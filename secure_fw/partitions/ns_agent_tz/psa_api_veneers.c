@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -43,6 +43,14 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
     return tfm_psa_call_pack(handle, ctrl_param, in_vec, out_vec);
 }
 
+__tz_c_veneer
+psa_status_t tfm_psa_call_batch_veneer(const struct psa_call_batch_item_t *items,
+                                       psa_status_t *statuses,
+                                       uint32_t num)
+{
+    return tfm_psa_call_batch_pack(items, statuses, num);
+}
+
 /* Following veneers are only needed by connection-based services */
 #if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
 __tz_c_veneer
@@ -15,6 +15,7 @@
 #include "utilities.h"
 
 #include "psa/client.h"
+#include "tfm_psa_call_batch.h"
 
 /*
  * This is the veneers of FF-M Client APIs for Armv8.0-m.
@@ -30,6 +31,12 @@
  *   the pushed non-secure context is popped and overrides the returned
  *   context before returning to NSPE. Therefore it is unnecessary to
  *   explicitly clean up the context.
+ *
+ * - The stack seal is checked with the scratch registers that do not carry
+ *   an argument. psa_call() takes four arguments, so r4 is pushed first and
+ *   used with r12, the seal being then 8 bytes above the stack pointer. A
+ *   reentrant call only writes these 8 bytes below the stack pointer of the
+ *   interrupted call before it panics.
  */
 
 #if defined(__ICCARM__)
@@ -39,6 +46,7 @@
 #pragma required = psa_framework_version
 #pragma required = psa_version
 #pragma required = tfm_psa_call_pack
+#pragma required = tfm_psa_call_batch_pack
 /* Following PSA APIs are only needed by connection-based services */
 #if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
 #pragma required = psa_connect
@@ -47,38 +55,35 @@
 
 #endif
 
-__attribute__((naked, used))
-static void clear_caller_context(void)
-{
-    __ASM volatile(
+/*
+ * Clears the secure values left in the registers that are not restored from
+ * the stack before returning to NSPE: the flags and, with FP enabled, s0-s15
+ * and the FPSCR flags. It is expanded in each veneer rather than called, to
+ * save the branch and return. r1 and r12 are used as scratch registers, and r3
+ * is set to zero.
+ */
 #if (CONFIG_TFM_FP >= 1)
-        "   vmov.f32   s0, #1.0                               \n"
-        "   vmov.f32   s1, #1.0                               \n"
-        "   vmov.f32   s2, #1.0                               \n"
-        "   vmov.f32   s3, #1.0                               \n"
-        "   vmov.f32   s4, #1.0                               \n"
-        "   vmov.f32   s5, #1.0                               \n"
-        "   vmov.f32   s6, #1.0                               \n"
-        "   vmov.f32   s7, #1.0                               \n"
-        "   vmov.f32   s8, #1.0                               \n"
-        "   vmov.f32   s9, #1.0                               \n"
-        "   vmov.f32   s10, #1.0                              \n"
-        "   vmov.f32   s11, #1.0                              \n"
-        "   vmov.f32   s12, #1.0                              \n"
-        "   vmov.f32   s13, #1.0                              \n"
-        "   vmov.f32   s14, #1.0                              \n"
-        "   vmov.f32   s15, #1.0                              \n"
-        "   vmrs   r12, fpscr                                 \n"
-        "   movw   r1, #0x009f                                \n"
-        "   movt   r1, #0xf000                                \n"
-        "   bics   r12, r1                                    \n"
-        "   vmsr   fpscr, r12                                 \n"
-#endif
-        "   movs    r3, #0x0                                  \n"
+#define CLEAR_CALLER_CONTEXT                                          \
+        "   movs   r3, #0x0                                   \n" \
+        "   vmov   d0, r3, r3                                 \n" \
+        "   vmov   d1, r3, r3                                 \n" \
+        "   vmov   d2, r3, r3                                 \n" \
+        "   vmov   d3, r3, r3                                 \n" \
+        "   vmov   d4, r3, r3                                 \n" \
+        "   vmov   d5, r3, r3                                 \n" \
+        "   vmov   d6, r3, r3                                 \n" \
+        "   vmov   d7, r3, r3                                 \n" \
+        "   vmrs   r12, fpscr                                 \n" \
+        "   movw   r1, #0x009f                                \n" \
+        "   movt   r1, #0xf000                                \n" \
+        "   bics   r12, r1                                    \n" \
+        "   vmsr   fpscr, r12                                 \n" \
         "   msr    APSR_nzcvq, r3                             \n"
-        "   bx     lr                                         \n"
-    );
-}
+#else
+#define CLEAR_CALLER_CONTEXT                                          \
+        "   movs   r3, #0x0                                   \n" \
+        "   msr    APSR_nzcvq, r3                             \n"
+#endif
 
 __tz_naked_veneer
 uint32_t tfm_psa_framework_version_veneer(void)
@@ -94,7 +99,7 @@ uint32_t tfm_psa_framework_version_veneer(void)
         "   bne    reent_panic1                               \n"
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_framework_version)"               \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -121,7 +126,7 @@ uint32_t tfm_psa_version_veneer(uint32_t sid)
 
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_version)"                         \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -144,15 +149,14 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
         ".syntax unified                                      \n"
 #endif
 
-        "   push   {r2, r3}                                   \n"
-        "   ldr    r2, [sp, #8]                               \n"
-        "   ldr    r3, ="M2S(STACK_SEAL_PATTERN)"             \n"
-        "   cmp    r2, r3                                     \n"
-        "   bne    reent_panic4                               \n"
-        "   pop    {r2, r3}                                   \n"
         "   push   {r4, lr}                                   \n"
+        "   ldr    r4, ="M2S(STACK_SEAL_PATTERN)"             \n"
+        "   mov    r12, r4                                    \n"
+        "   ldr    r4, [sp, #8]                               \n"
+        "   cmp    r4, r12                                    \n"
+        "   bne    reent_panic4                               \n"
         "   bl     "M2S(tfm_psa_call_pack)"                   \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -164,6 +168,35 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
     );
 }
 
+__tz_naked_veneer
+psa_status_t tfm_psa_call_batch_veneer(const struct psa_call_batch_item_t *items,
+                                       psa_status_t *statuses,
+                                       uint32_t num)
+{
+    __ASM volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                      \n"
+#endif
+
+        "   ldr    r3, ="M2S(STACK_SEAL_PATTERN)"             \n"
+        "   mov    r12, r3                                    \n"
+        "   ldr    r3, [sp]                                   \n"
+        "   cmp    r3, r12                                    \n"
+        "   bne    reent_panic6                               \n"
+        "   push   {r4, lr}                                   \n"
+        "   bl     "M2S(tfm_psa_call_batch_pack)"             \n"
+        CLEAR_CALLER_CONTEXT
+        "   pop    {r1, r2}                                   \n"
+        "   mov    lr, r2                                     \n"
+        "   mov    r4, r1                                     \n"
+        "   bxns   lr                                         \n"
+
+        "reent_panic6:                                        \n"
+        "   svc    "M2S(TFM_SVC_PSA_PANIC)"                   \n"
+        "   b      .                                          \n"
+    );
+}
+
 /* Following veneers are only needed by connection-based services */
 #if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
 
@@ -181,7 +214,7 @@ psa_handle_t tfm_psa_connect_veneer(uint32_t sid, uint32_t version)
         "   bne    reent_panic3                               \n"
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_connect)"                         \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -208,7 +241,7 @@ void tfm_psa_close_veneer(psa_handle_t handle)
 
         "   push   {r4, lr}                                   \n"
         "   bl     "M2S(psa_close)"                           \n"
-        "   bl     clear_caller_context                       \n"
+        CLEAR_CALLER_CONTEXT
         "   pop    {r1, r2}                                   \n"
         "   mov    lr, r2                                     \n"
         "   mov    r4, r1                                     \n"
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <arm_cmse.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tfm_hal_device_header.h"
+#include "tfm_psa_call_batch.h"
+#include "tfm_psa_call_pack.h"
+
+#include "psa/client.h"
+
+/*
+ * Check that the NSPE caller can access the given memory, with the privilege
+ * the caller runs with.
+ */
+static bool ns_memory_accessible(const void *p, size_t size, int flags)
+{
+    CONTROL_Type ctrl;
+
+    ctrl.w = __TZ_get_CONTROL_NS();
+    if (ctrl.b.nPRIV == 1) {
+        flags |= CMSE_MPU_UNPRIV;
+    }
+
+    return cmse_check_address_range((void *)p, size,
+                                    flags | CMSE_NONSECURE) != NULL;
+}
+
+psa_status_t tfm_psa_call_batch_pack(const struct psa_call_batch_item_t *items,
+                                     psa_status_t *statuses,
+                                     uint32_t num)
+{
+    struct psa_call_batch_item_t item;
+    psa_status_t status;
+    uint32_t i;
+
+    if ((num == 0) || (num > PSA_CALL_BATCH_MAX_NUM)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (!ns_memory_accessible(items, num * sizeof(*items), CMSE_MPU_READ) ||
+        !ns_memory_accessible(statuses, num * sizeof(*statuses),
+                              CMSE_MPU_READWRITE)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    for (i = 0; i < num; i++) {
+        /* Copy the item out to avoid TOCTOU attacks. */
+        item = items[i];
+
+        if ((item.type > INT16_MAX) || (item.type < INT16_MIN) ||
+            (item.in_len > UINT8_MAX) || (item.out_len > UINT8_MAX)) {
+            status = PSA_ERROR_PROGRAMMER_ERROR;
+        } else {
+            /* The SPM validates the vectors as for any NSPE psa_call(). */
+            status = tfm_psa_call_pack(item.handle,
+                                       PARAM_PACK(item.type, item.in_len,
+                                                  item.out_len),
+                                       item.in_vec, item.out_vec);
+        }
+
+        statuses[i] = status;
+    }
+
+    return PSA_SUCCESS;
+}
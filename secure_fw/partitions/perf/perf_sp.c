@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "psa/service.h"
+#include "psa_manifest/tfm_perf.h"
+#include "tfm_perf_defs.h"
+
+#ifdef CONFIG_TFM_SPM_TRACE
+#include "service_api.h"
+#endif
+
+/**
+ * \brief Records the start or the end of a benchmark in the SPM trace. The
+ *        spans recorded in between are attributed to the benchmark by
+ *        tools/tfm_trace_export.py.
+ *
+ * \param[in] msg    The message of the mark
+ * \param[in] begin  Whether it is the start of the benchmark
+ *
+ * \return Returns PSA_SUCCESS, or PSA_ERROR_PROGRAMMER_ERROR if the mark is
+ *         invalid
+ */
+static psa_status_t tfm_perf_mark(const psa_msg_t *msg, bool begin)
+{
+    struct tfm_perf_mark_t mark;
+
+    if (msg->in_size[0] != sizeof(mark)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (psa_read(msg->handle, 0, &mark, sizeof(mark)) != sizeof(mark)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+#ifdef CONFIG_TFM_SPM_TRACE
+    tfm_core_trace_event(begin ? TFM_TRACE_EVT_PERF_BEGIN :
+                                 TFM_TRACE_EVT_PERF_END,
+                         mark.benchmark, mark.iterations);
+#else
+    (void)begin;
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_perf_service_sfn(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case TFM_PERF_NULL_CALL:
+        /* The cost measured is the one of the call itself */
+        return PSA_SUCCESS;
+    case TFM_PERF_BEGIN:
+        return tfm_perf_mark(msg, true);
+    case TFM_PERF_END:
+        return tfm_perf_mark(msg, false);
+    default:
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    return PSA_ERROR_GENERIC_ERROR;
+}
@@ -1,10 +1,12 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
+#include <string.h>
+
 #include "config_tfm.h"
 #include "platform_sp.h"
 
@@ -16,6 +18,15 @@
 #include "tfm_plat_nv_counters.h"
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED */
 
+#if (CONFIG_TFM_SPM_SERVICE_STATS == 1) || defined(TFM_BOOT_TIMING)
+#include "service_api.h"
+#endif
+
+#ifdef TFM_BOOT_TIMING
+#include "tfm_api.h"
+#include "tfm_boot_status.h"
+#endif
+
 #include "psa/client.h"
 #include "psa/service.h"
 #include "region_defs.h"
@@ -23,6 +34,8 @@
 
 #if !PLATFORM_NV_COUNTER_MODULE_DISABLED
 #define NV_COUNTER_ID_SIZE  sizeof(enum tfm_nv_counter_t)
+/* The values of a batch read are returned as 32-bit words */
+#define NV_COUNTER_VAL_SIZE sizeof(uint32_t)
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED */
 
 typedef enum tfm_platform_err_t (*plat_func_t)(const psa_msg_t *msg);
@@ -172,8 +185,258 @@ static psa_status_t platform_sp_nv_increment_psa_api(const psa_msg_t *msg)
 
     return TFM_PLATFORM_ERR_SUCCESS;
 }
+
+/* Reads the counter IDs of a batch request in one go, and checks that the
+ * client can access all of them before any counter is accessed.
+ */
+static enum tfm_platform_err_t nv_counter_batch_get_ids(
+        const psa_msg_t *msg,
+        enum tfm_nv_counter_t *counter_ids,
+        uint32_t *num_counters,
+        bool is_read)
+{
+    size_t num;
+    uint32_t i, j;
+
+    if ((msg->in_size[0] == 0) ||
+        (msg->in_size[0] % NV_COUNTER_ID_SIZE != 0) ||
+        (msg->in_size[0] > PLAT_NV_COUNTER_MAX * NV_COUNTER_ID_SIZE)) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    num = psa_read(msg->handle, 0, counter_ids, msg->in_size[0]);
+    if (num != msg->in_size[0]) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    *num_counters = num / NV_COUNTER_ID_SIZE;
+
+    for (i = 0; i < *num_counters; i++) {
+        if (msg->client_id < 0) {
+            counter_ids[i] += PLAT_NV_COUNTER_NS_0;
+        }
+
+        if (nv_counter_permissions_check(msg->client_id, counter_ids[i],
+                                         is_read)
+            != TFM_PLATFORM_ERR_SUCCESS) {
+            return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+        }
+
+        /* Each counter is incremented once per batch */
+        for (j = 0; j < i; j++) {
+            if (counter_ids[j] == counter_ids[i]) {
+                return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+            }
+        }
+    }
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+
+static psa_status_t platform_sp_nv_read_batch_psa_api(const psa_msg_t *msg)
+{
+    enum tfm_plat_err_t err = TFM_PLAT_ERR_SYSTEM_ERR;
+    size_t in_len = PSA_MAX_IOVEC, out_len = PSA_MAX_IOVEC;
+
+    enum tfm_nv_counter_t counter_ids[PLAT_NV_COUNTER_MAX];
+    uint32_t counter_vals[PLAT_NV_COUNTER_MAX] = {0};
+    uint32_t num_counters = 0;
+    uint32_t i;
+
+    /* Check the number of in_vec filled */
+    while ((in_len > 0) && (msg->in_size[in_len - 1] == 0)) {
+        in_len--;
+    }
+
+    /* Check the number of out_vec filled */
+    while ((out_len > 0) && (msg->out_size[out_len - 1] == 0)) {
+        out_len--;
+    }
+
+    if (in_len != 1 || out_len != 1) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    if (nv_counter_batch_get_ids(msg, counter_ids, &num_counters, true)
+        != TFM_PLATFORM_ERR_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    if (msg->out_size[0] != num_counters * NV_COUNTER_VAL_SIZE) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    for (i = 0; i < num_counters; i++) {
+        err = tfm_plat_read_nv_counter(counter_ids[i], NV_COUNTER_VAL_SIZE,
+                                       (uint8_t *)&counter_vals[i]);
+        if (err != TFM_PLAT_ERR_SUCCESS) {
+            return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+        }
+    }
+
+    psa_write(msg->handle, 0, counter_vals, msg->out_size[0]);
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+
+static psa_status_t platform_sp_nv_increment_batch_psa_api(const psa_msg_t *msg)
+{
+    enum tfm_plat_err_t err = TFM_PLAT_ERR_SYSTEM_ERR;
+    size_t in_len = PSA_MAX_IOVEC, out_len = PSA_MAX_IOVEC;
+
+    enum tfm_nv_counter_t counter_ids[PLAT_NV_COUNTER_MAX];
+    uint32_t num_counters = 0;
+
+    /* Check the number of in_vec filled */
+    while ((in_len > 0) && (msg->in_size[in_len - 1] == 0)) {
+        in_len--;
+    }
+
+    /* Check the number of out_vec filled */
+    while ((out_len > 0) && (msg->out_size[out_len - 1] == 0)) {
+        out_len--;
+    }
+
+    if (in_len != 1 || out_len != 0) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    if (nv_counter_batch_get_ids(msg, counter_ids, &num_counters, false)
+        != TFM_PLATFORM_ERR_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    /* The counters are all read, then written together where possible */
+    err = tfm_plat_increment_nv_counters(counter_ids, num_counters);
+
+    if (err != TFM_PLAT_ERR_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
 #endif /* !PLATFORM_NV_COUNTER_MODULE_DISABLED*/
 
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+static enum tfm_platform_err_t platform_sp_service_stats(int32_t client_id,
+                                                         psa_invec *input,
+                                                         psa_outvec *output)
+{
+    uint32_t index;
+    psa_status_t status;
+
+    /* The timings of the Secure services are not given to the NSPE */
+    if (client_id < 0) {
+        return TFM_PLATFORM_ERR_NOT_SUPPORTED;
+    }
+
+    if (!input || (input->len != sizeof(index)) ||
+        !output || (output->len < sizeof(struct tfm_service_stat_t))) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    memcpy(&index, input->base, sizeof(index));
+
+    status = tfm_core_get_service_stats(index,
+                                        (struct tfm_service_stat_t *)
+                                        output->base,
+                                        output->len);
+    if (status != PSA_SUCCESS) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    output->len = sizeof(struct tfm_service_stat_t);
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+#endif /* CONFIG_TFM_SPM_SERVICE_STATS == 1 */
+
+#ifdef TFM_BOOT_TIMING
+/* Copy of the TLV_MAJOR_BTS entries of the shared data area */
+static uint8_t boot_timing_buf[BOOT_TFM_SHARED_DATA_SIZE];
+
+static enum tfm_platform_err_t platform_sp_boot_timing(psa_invec *input,
+                                                       psa_outvec *output)
+{
+    struct tfm_boot_data *boot_data = (struct tfm_boot_data *)boot_timing_buf;
+    struct shared_data_tlv_entry tlv_entry;
+    uint32_t first = 0;
+    uint32_t index = 0;
+    size_t offset, tlv_end, out_len = 0;
+    int32_t rc;
+
+    if (input) {
+        if (input->len != sizeof(first)) {
+            return TFM_PLATFORM_ERR_INVALID_PARAM;
+        }
+        memcpy(&first, input->base, sizeof(first));
+    }
+
+    if (!output || (output->len < sizeof(struct boot_timing_entry))) {
+        return TFM_PLATFORM_ERR_INVALID_PARAM;
+    }
+
+    rc = tfm_core_get_boot_data(TLV_MAJOR_BTS, boot_data,
+                                sizeof(boot_timing_buf));
+    if (rc != (int32_t)TFM_SUCCESS) {
+        return TFM_PLATFORM_ERR_SYSTEM_ERROR;
+    }
+
+    /* Entries are returned in the order they were recorded, the ones before
+     * the requested index are skipped.
+     */
+    tlv_end = boot_data->header.tlv_tot_len;
+    for (offset = SHARED_DATA_HEADER_SIZE;
+         offset + SHARED_DATA_ENTRY_HEADER_SIZE <= tlv_end;
+         offset += SHARED_DATA_ENTRY_SIZE(tlv_entry.tlv_len)) {
+        memcpy(&tlv_entry, &boot_timing_buf[offset], sizeof(tlv_entry));
+
+        if (tlv_entry.tlv_len != sizeof(struct boot_timing_entry)) {
+            continue;
+        }
+
+        if (index++ < first) {
+            continue;
+        }
+
+        if (out_len + sizeof(struct boot_timing_entry) > output->len) {
+            break;
+        }
+
+        memcpy((uint8_t *)output->base + out_len,
+               &boot_timing_buf[offset + SHARED_DATA_ENTRY_HEADER_SIZE],
+               sizeof(struct boot_timing_entry));
+        out_len += sizeof(struct boot_timing_entry);
+    }
+
+    output->len = out_len;
+
+    return TFM_PLATFORM_ERR_SUCCESS;
+}
+#endif /* TFM_BOOT_TIMING */
+
+static enum tfm_platform_err_t platform_sp_ioctl(
+                                            int32_t client_id,
+                                            tfm_platform_ioctl_req_t request,
+                                            psa_invec *input,
+                                            psa_outvec *output)
+{
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+    if (request == TFM_PLATFORM_IOCTL_SERVICE_STATS) {
+        return platform_sp_service_stats(client_id, input, output);
+    }
+#else
+    (void)client_id;
+#endif
+#ifdef TFM_BOOT_TIMING
+    if (request == TFM_PLATFORM_IOCTL_BOOT_TIMING) {
+        return platform_sp_boot_timing(input, output);
+    }
+#endif
+
+    return tfm_platform_hal_ioctl(request, input, output);
+}
+
 static psa_status_t platform_sp_ioctl_psa_api(const psa_msg_t *msg)
 {
     void *input = NULL;
@@ -230,7 +493,7 @@ static psa_status_t platform_sp_ioctl_psa_api(const psa_msg_t *msg)
         output = &outvec;
     }
 
-    ret = tfm_platform_hal_ioctl(request, input, output);
+    ret = platform_sp_ioctl(msg->client_id, request, input, output);
 
     if (output != NULL) {
         psa_write(msg->handle, 0, outvec.base, outvec.len);
@@ -247,6 +510,10 @@ psa_status_t tfm_platform_service_sfn(const psa_msg_t *msg)
         return platform_sp_nv_read_psa_api(msg);
     case TFM_PLATFORM_API_ID_NV_INCREMENT:
         return platform_sp_nv_increment_psa_api(msg);
+    case TFM_PLATFORM_API_ID_NV_READ_BATCH:
+        return platform_sp_nv_read_batch_psa_api(msg);
+    case TFM_PLATFORM_API_ID_NV_INCREMENT_BATCH:
+        return platform_sp_nv_increment_batch_psa_api(msg);
 #endif /* PLATFORM_NV_COUNTER_MODULE_DISABLED */
     case TFM_PLATFORM_API_ID_SYSTEM_RESET:
         return platform_sp_system_reset_psa_api(msg);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -38,6 +38,80 @@ typedef char PS_ERROR_NOT_AEAD_ALG[(PSA_ALG_IS_AEAD(PS_CRYPTO_ALG)) ? 1 : -1];
 
 static psa_key_id_t ps_key;
 static uint8_t ps_crypto_iv_buf[PS_IV_LEN_BYTES];
+/* The multi-part AEAD operation on an object, one at a time */
+static psa_aead_operation_t ps_crypto_aead_op;
+
+#if PS_CRYPTO_KEY_CACHE_NUM > 0
+/* The longest key label which can be cached, fits the object and table labels */
+#define PS_CRYPTO_KEY_CACHE_LABEL_MAX 16
+
+/*
+ * Keys derived for a label are kept as volatile keys in the crypto service so
+ * that accessing the same object again does not re-run the whole derivation.
+ */
+struct ps_crypto_key_cache_entry_t {
+    uint8_t label[PS_CRYPTO_KEY_CACHE_LABEL_MAX];
+    size_t label_len;
+    psa_key_id_t key;
+    uint32_t last_use;
+    bool is_valid;
+};
+
+static struct ps_crypto_key_cache_entry_t ps_key_cache[PS_CRYPTO_KEY_CACHE_NUM];
+static uint32_t ps_key_cache_stamp;
+/* Whether ps_key is owned by the cache rather than by the current operation */
+static bool ps_key_is_cached;
+
+static bool ps_crypto_key_cache_lookup(const uint8_t *key_label,
+                                       size_t key_label_len)
+{
+    for (size_t i = 0; i < PS_CRYPTO_KEY_CACHE_NUM; i++) {
+        struct ps_crypto_key_cache_entry_t *entry = &ps_key_cache[i];
+
+        if (entry->is_valid && (entry->label_len == key_label_len) &&
+            (memcmp(entry->label, key_label, key_label_len) == 0)) {
+            entry->last_use = ++ps_key_cache_stamp;
+            ps_key = entry->key;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool ps_crypto_key_cache_insert(const uint8_t *key_label,
+                                       size_t key_label_len)
+{
+    struct ps_crypto_key_cache_entry_t *victim = &ps_key_cache[0];
+
+    if (key_label_len > PS_CRYPTO_KEY_CACHE_LABEL_MAX) {
+        return false;
+    }
+
+    /* Prefer a free entry, otherwise evict the least recently used one */
+    for (size_t i = 0; i < PS_CRYPTO_KEY_CACHE_NUM; i++) {
+        if (!ps_key_cache[i].is_valid) {
+            victim = &ps_key_cache[i];
+            break;
+        }
+        if ((int32_t)(ps_key_cache[i].last_use - victim->last_use) < 0) {
+            victim = &ps_key_cache[i];
+        }
+    }
+
+    if (victim->is_valid) {
+        (void)psa_destroy_key(victim->key);
+    }
+
+    memcpy(victim->label, key_label, key_label_len);
+    victim->label_len = key_label_len;
+    victim->key = ps_key;
+    victim->last_use = ++ps_key_cache_stamp;
+    victim->is_valid = true;
+
+    return true;
+}
+#endif /* PS_CRYPTO_KEY_CACHE_NUM > 0 */
 
 psa_status_t ps_crypto_init(void)
 {
@@ -67,6 +141,13 @@ psa_status_t ps_crypto_setkey(const uint8_t *key_label, size_t key_label_len)
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#if PS_CRYPTO_KEY_CACHE_NUM > 0
+    ps_key_is_cached = ps_crypto_key_cache_lookup(key_label, key_label_len);
+    if (ps_key_is_cached) {
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Set the key attributes for the storage key */
     psa_set_key_usage_flags(&attributes, PS_KEY_USAGE);
     psa_set_key_algorithm(&attributes, PS_CRYPTO_ALG);
@@ -105,6 +186,10 @@ psa_status_t ps_crypto_setkey(const uint8_t *key_label, size_t key_label_len)
         goto err_release_key;
     }
 
+#if PS_CRYPTO_KEY_CACHE_NUM > 0
+    ps_key_is_cached = ps_crypto_key_cache_insert(key_label, key_label_len);
+#endif
+
     return PSA_SUCCESS;
 
 err_release_key:
@@ -120,6 +205,14 @@ psa_status_t ps_crypto_destroykey(void)
 {
     psa_status_t status;
 
+#if PS_CRYPTO_KEY_CACHE_NUM > 0
+    /* A cached key stays available until it is evicted from the cache */
+    if (ps_key_is_cached) {
+        ps_key_is_cached = false;
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Destroy the transient key */
     status = psa_destroy_key(ps_key);
     if (status != PSA_SUCCESS) {
@@ -188,6 +281,27 @@ psa_status_t ps_crypto_get_iv(union ps_crypto_t *crypto)
     return PSA_SUCCESS;
 }
 
+bool ps_crypto_iv_is_newer(const union ps_crypto_t *crypto,
+                           const union ps_crypto_t *ref)
+{
+    uint64_t iv_l;
+    uint64_t ref_l;
+    uint32_t iv_h;
+    uint32_t ref_h;
+
+    /* Same layout as the one incremented by ps_crypto_get_iv */
+    (void)memcpy(&iv_l, crypto->ref.iv, sizeof(iv_l));
+    (void)memcpy(&iv_h, (crypto->ref.iv + sizeof(iv_l)), sizeof(iv_h));
+    (void)memcpy(&ref_l, ref->ref.iv, sizeof(ref_l));
+    (void)memcpy(&ref_h, (ref->ref.iv + sizeof(ref_l)), sizeof(ref_h));
+
+    if (iv_h != ref_h) {
+        return (iv_h > ref_h);
+    }
+
+    return (iv_l > ref_l);
+}
+
 psa_status_t ps_crypto_encrypt_and_tag(union ps_crypto_t *crypto,
                                        const uint8_t *add,
                                        size_t add_len,
@@ -242,6 +356,102 @@ psa_status_t ps_crypto_auth_and_decrypt(const union ps_crypto_t *crypto,
     return PSA_SUCCESS;
 }
 
+psa_status_t ps_crypto_aead_setup(const union ps_crypto_t *crypto,
+                                  bool encrypt,
+                                  const uint8_t *add,
+                                  size_t add_len,
+                                  size_t in_len)
+{
+    psa_status_t status;
+
+    ps_crypto_aead_op = psa_aead_operation_init();
+
+    if (encrypt) {
+        status = psa_aead_encrypt_setup(&ps_crypto_aead_op, ps_key,
+                                        PS_CRYPTO_ALG);
+    } else {
+        status = psa_aead_decrypt_setup(&ps_crypto_aead_op, ps_key,
+                                        PS_CRYPTO_ALG);
+    }
+    if (status != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* The lengths are only required by some algorithms, such as CCM */
+    status = psa_aead_set_lengths(&ps_crypto_aead_op, add_len, in_len);
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_set_nonce(&ps_crypto_aead_op, crypto->ref.iv,
+                                    PS_IV_LEN_BYTES);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_update_ad(&ps_crypto_aead_op, add, add_len);
+    }
+    if (status != PSA_SUCCESS) {
+        ps_crypto_aead_abort();
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_crypto_aead_update(const uint8_t *in,
+                                   size_t in_len,
+                                   uint8_t *out,
+                                   size_t out_size,
+                                   size_t *out_len)
+{
+    psa_status_t status;
+
+    status = psa_aead_update(&ps_crypto_aead_op, in, in_len,
+                             out, out_size, out_len);
+    if (status != PSA_SUCCESS) {
+        ps_crypto_aead_abort();
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_crypto_aead_finish(union ps_crypto_t *crypto,
+                                   uint8_t *out,
+                                   size_t out_size,
+                                   size_t *out_len)
+{
+    psa_status_t status;
+    size_t tag_len;
+
+    status = psa_aead_finish(&ps_crypto_aead_op, out, out_size, out_len,
+                             crypto->ref.tag, PS_TAG_LEN_BYTES, &tag_len);
+    if (status != PSA_SUCCESS || tag_len != PS_TAG_LEN_BYTES) {
+        ps_crypto_aead_abort();
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_crypto_aead_verify(const union ps_crypto_t *crypto,
+                                   uint8_t *out,
+                                   size_t out_size,
+                                   size_t *out_len)
+{
+    psa_status_t status;
+
+    status = psa_aead_verify(&ps_crypto_aead_op, out, out_size, out_len,
+                             crypto->ref.tag, PS_TAG_LEN_BYTES);
+    if (status != PSA_SUCCESS) {
+        ps_crypto_aead_abort();
+        return PSA_ERROR_INVALID_SIGNATURE;
+    }
+
+    return PSA_SUCCESS;
+}
+
+void ps_crypto_aead_abort(void)
+{
+    (void)psa_aead_abort(&ps_crypto_aead_op);
+}
+
 psa_status_t ps_crypto_generate_auth_tag(union ps_crypto_t *crypto,
                                          const uint8_t *add,
                                          uint32_t add_len)
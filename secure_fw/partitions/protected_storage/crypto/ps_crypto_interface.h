@@ -8,6 +8,7 @@
 #ifndef __PS_CRYPTO_INTERFACE_H__
 #define __PS_CRYPTO_INTERFACE_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -104,6 +105,81 @@ psa_status_t ps_crypto_auth_and_decrypt(const union ps_crypto_t *crypto,
                                         size_t out_size,
                                         size_t *out_len);
 
+/**
+ * \brief Starts a multi-part authenticated encryption or decryption with the
+ *        current key.
+ *
+ * \param[in] crypto   Pointer to the crypto union holding the IV
+ * \param[in] encrypt  Whether to encrypt or to decrypt
+ * \param[in] add      Pointer to the associated data
+ * \param[in] add_len  Length of the associated data
+ * \param[in] in_len   Total length of the data to encrypt or decrypt
+ *
+ * \return Returns values as described in \ref psa_status_t
+ */
+psa_status_t ps_crypto_aead_setup(const union ps_crypto_t *crypto,
+                                  bool encrypt,
+                                  const uint8_t *add,
+                                  size_t add_len,
+                                  size_t in_len);
+
+/**
+ * \brief Encrypts or decrypts the next part of the data of the multi-part
+ *        operation started by \ref ps_crypto_aead_setup.
+ *
+ * \param[in]  in        Pointer to the input data
+ * \param[in]  in_len    Length of the input data
+ * \param[out] out       Pointer to the output buffer
+ * \param[in]  out_size  Size of the output buffer. It must be able to hold
+ *                       in_len rounded up to the AES block size.
+ * \param[out] out_len   On success, the length of the output data
+ *
+ * \return Returns values as described in \ref psa_status_t
+ */
+psa_status_t ps_crypto_aead_update(const uint8_t *in,
+                                   size_t in_len,
+                                   uint8_t *out,
+                                   size_t out_size,
+                                   size_t *out_len);
+
+/**
+ * \brief Finishes a multi-part encryption and gets its tag.
+ *
+ * \param[out] crypto    Pointer to the crypto union to fill in with the tag
+ * \param[out] out       Pointer to the output buffer for the last encrypted
+ *                       data
+ * \param[in]  out_size  Size of the output buffer
+ * \param[out] out_len   On success, the length of the output data
+ *
+ * \return Returns values as described in \ref psa_status_t
+ */
+psa_status_t ps_crypto_aead_finish(union ps_crypto_t *crypto,
+                                   uint8_t *out,
+                                   size_t out_size,
+                                   size_t *out_len);
+
+/**
+ * \brief Finishes a multi-part decryption and authenticates the data against
+ *        the tag.
+ *
+ * \param[in]  crypto    Pointer to the crypto union holding the tag
+ * \param[out] out       Pointer to the output buffer for the last decrypted
+ *                       data
+ * \param[in]  out_size  Size of the output buffer
+ * \param[out] out_len   On success, the length of the output data
+ *
+ * \return Returns values as described in \ref psa_status_t
+ */
+psa_status_t ps_crypto_aead_verify(const union ps_crypto_t *crypto,
+                                   uint8_t *out,
+                                   size_t out_size,
+                                   size_t *out_len);
+
+/**
+ * \brief Aborts the ongoing multi-part operation, if any.
+ */
+void ps_crypto_aead_abort(void);
+
 /**
  * \brief Generates authentication tag for given data.
  *
@@ -146,6 +222,18 @@ void ps_crypto_set_iv(const union ps_crypto_t *crypto);
  */
 psa_status_t ps_crypto_get_iv(union ps_crypto_t *crypto);
 
+/**
+ * \brief Checks if an IV value was generated after another one.
+ *
+ * \param[in] crypto  Pointer to the crypto union holding the IV to check
+ * \param[in] ref     Pointer to the crypto union holding the reference IV
+ *
+ * \return Returns true if the IV in crypto was got by \ref ps_crypto_get_iv
+ *         after the one in ref, false otherwise
+ */
+bool ps_crypto_iv_is_newer(const union ps_crypto_t *crypto,
+                           const union ps_crypto_t *ref);
+
 #ifdef __cplusplus
 }
 #endif
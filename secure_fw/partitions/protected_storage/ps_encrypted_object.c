@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,7 @@
 
 #include "ps_encrypted_object.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -21,19 +22,33 @@
 
 #define PS_OBJECT_START_POSITION  0
 
-/* Buffer to store the maximum encrypted object */
-/* FIXME: Do partial encrypt/decrypt to reduce the size of internal buffer */
+/* Size of the encrypted form of the largest object */
 #define PS_MAX_ENCRYPTED_OBJ_SIZE PS_ENCRYPT_SIZE(PS_MAX_OBJECT_DATA_SIZE)
 
-/* FIXME: add the tag length to the crypto buffer size to account for the tag
- * being appended to the ciphertext by the crypto layer.
+/* A multi-part AEAD step may output up to one more block than its input, and
+ * the last step outputs up to one block.
  */
-#define PS_TAG_IV_LEN_MAX   ((PS_TAG_LEN_BYTES > PS_IV_LEN_BYTES) ? \
-                             PS_TAG_LEN_BYTES : PS_IV_LEN_BYTES)
-#define PS_CRYPTO_BUF_LEN (PS_MAX_ENCRYPTED_OBJ_SIZE + PS_TAG_IV_LEN_MAX)
+#define PS_CRYPTO_BLOCK_SIZE 16
+#define PS_CRYPTO_BUF_LEN    (PS_CRYPTO_CHUNK_SIZE + PS_CRYPTO_BLOCK_SIZE)
 
+/*
+ * Objects are encrypted and decrypted in place in the object buffer. Each step
+ * of the multi-part operation reads its input from the object and outputs to
+ * this buffer, which is then copied back into the object. The output of a step
+ * never goes past its input, so it only overwrites data already processed.
+ */
 static uint8_t ps_crypto_buf[PS_CRYPTO_BUF_LEN];
 
+#ifndef PS_OBJECT_SEGMENTED
+/* The object buffer holds the stored form of the object, which is the
+ * encrypted data followed by the IV, in place of the crypto metadata.
+ */
+PS_UTILS_BOUND_CHECK(IV_NOT_FIT_IN_CRYPTO_METADATA, PS_IV_LEN_BYTES,
+                     sizeof(union ps_crypto_t));
+#endif
+PS_UTILS_BOUND_CHECK(CHUNK_SIZE_NOT_BLOCK_MULTIPLE,
+                     (PS_CRYPTO_CHUNK_SIZE % PS_CRYPTO_BLOCK_SIZE), 0);
+
 static psa_status_t fill_key_label(struct ps_object_t *obj, size_t *length)
 {
     psa_storage_uid_t uid = obj->header.crypto.ref.uid;
@@ -52,25 +67,273 @@ static psa_status_t fill_key_label(struct ps_object_t *obj, size_t *length)
 }
 
 /**
- * \brief Performs authenticated decryption on object data, with the header as
- *        the associated data.
+ * \brief Encrypts or decrypts data in place with the ongoing multi-part AEAD
+ *        operation, and finishes the operation.
  *
- * \param[in]  fid       File ID
- * \param[in]  cur_size  Size of the object data to decrypt
- * \param[in,out] obj    Pointer to the object structure to authenticate and
- *                       fill in with the decrypted data. The tag of the object
- *                       is the one stored in the object table for the given
- *                       File ID.
+ * \param[in,out] crypto  Pointer to the crypto union. The tag is filled in when
+ *                        encrypting and authenticated when decrypting.
+ * \param[in]     encrypt Whether the operation encrypts or decrypts
+ * \param[in]     in      Pointer to the input data
+ * \param[out]    out     Pointer to the output buffer. It must not be after
+ *                        in, and may overlap it.
+ * \param[in]     size    Size of the data to process
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
-static psa_status_t ps_object_auth_decrypt(uint32_t fid,
-                                           uint32_t cur_size,
+static psa_status_t ps_object_crypt_in_place(union ps_crypto_t *crypto,
+                                             bool encrypt,
+                                             const uint8_t *in,
+                                             uint8_t *out,
+                                             uint32_t size)
+{
+    psa_status_t err;
+    uint32_t in_pos = 0;
+    uint32_t out_pos = 0;
+    size_t chunk_len, out_len;
+
+    while (in_pos < size) {
+        chunk_len = PS_UTILS_MIN(size - in_pos, PS_CRYPTO_CHUNK_SIZE);
+
+        err = ps_crypto_aead_update(in + in_pos, chunk_len, ps_crypto_buf,
+                                    sizeof(ps_crypto_buf), &out_len);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        in_pos += chunk_len;
+
+        if (out_len > in_pos - out_pos) {
+            ps_crypto_aead_abort();
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+        (void)memcpy(out + out_pos, ps_crypto_buf, out_len);
+        out_pos += out_len;
+    }
+
+    if (encrypt) {
+        err = ps_crypto_aead_finish(crypto, ps_crypto_buf,
+                                    sizeof(ps_crypto_buf), &out_len);
+    } else {
+        err = ps_crypto_aead_verify(crypto, ps_crypto_buf,
+                                    sizeof(ps_crypto_buf), &out_len);
+    }
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (out_len != size - out_pos) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    (void)memcpy(out + out_pos, ps_crypto_buf, out_len);
+
+    return PSA_SUCCESS;
+}
+
+#ifdef PS_OBJECT_SEGMENTED
+/*
+ * The stored object is the segment table, the encrypted object information and
+ * the encrypted object data, which is also their layout in the object buffer
+ * from the segment table onwards. Each segment is encrypted on its own, with
+ * its index as the associated data. The object information is encrypted with
+ * the segment table as the associated data, and its tag is kept in the object
+ * table, so the tag of the header authenticates the whole object.
+ */
+
+/* Offset of the object data in the stored object */
+#define PS_SEG_DATA_OFFSET \
+    (PS_OBJECT_HEADER_SIZE - sizeof(union ps_crypto_t))
+
+/* Gets the number of segments of an object of the given size */
+#define PS_SEG_NUM(size) \
+    (((size) + PS_OBJECT_SEGMENT_SIZE - 1) / PS_OBJECT_SEGMENT_SIZE)
+
+/**
+ * \brief Checks whether a segment holds any of the bytes of a data range.
+ *
+ * \param[in] idx     Segment index
+ * \param[in] offset  Offset of the range in the object data
+ * \param[in] size    Size of the range
+ *
+ * \return Returns true if the range is not empty and covers the segment
+ */
+static bool ps_object_segment_in_range(uint32_t idx, uint32_t offset,
+                                       uint32_t size)
+{
+    uint32_t seg_start = idx * PS_OBJECT_SEGMENT_SIZE;
+
+    if (size == 0) {
+        return false;
+    }
+
+    return (seg_start <= offset) ?
+           (offset - seg_start < PS_OBJECT_SEGMENT_SIZE) :
+           (seg_start - offset < size);
+}
+
+/**
+ * \brief Encrypts or authenticates and decrypts a segment of the object data
+ *        in place.
+ *
+ * \param[in]     idx      Segment index
+ * \param[in]     encrypt  Whether to encrypt or to decrypt the segment
+ * \param[in,out] obj      Pointer to the object structure, with a valid object
+ *                         information
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_segment_crypt(uint32_t idx, bool encrypt,
+                                            struct ps_object_t *obj)
+{
+    psa_status_t err;
+    struct ps_obj_segment_t *segment = &obj->header.seg.segment[idx];
+    uint8_t *p_seg_data = obj->data + idx * PS_OBJECT_SEGMENT_SIZE;
+    uint32_t seg_size = PS_UTILS_MIN(PS_OBJECT_SEGMENT_SIZE,
+                                     obj->header.info.current_size -
+                                     idx * PS_OBJECT_SEGMENT_SIZE);
+    union ps_crypto_t crypto;
+
+    if (encrypt) {
+        /* Get a new IV for each encryption */
+        err = ps_crypto_get_iv(&crypto);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        (void)memcpy(segment->iv, crypto.ref.iv, sizeof(segment->iv));
+    } else {
+        (void)memcpy(crypto.ref.iv, segment->iv, sizeof(segment->iv));
+        (void)memcpy(crypto.ref.tag, segment->tag, sizeof(segment->tag));
+    }
+
+    /* Use the segment index as the associated data, so that segments cannot
+     * be moved within the object.
+     */
+    err = ps_crypto_aead_setup(&crypto, encrypt, (const uint8_t *)&idx,
+                               sizeof(idx), seg_size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_object_crypt_in_place(&crypto, encrypt, p_seg_data, p_seg_data,
+                                   seg_size);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if (encrypt) {
+        (void)memcpy(segment->tag, crypto.ref.tag, sizeof(segment->tag));
+    }
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Encrypts or authenticates and decrypts the object information in
+ *        place, with the segment table as the associated data.
+ *
+ * \param[in]     fid      File ID
+ * \param[in]     encrypt  Whether to encrypt or to decrypt the header
+ * \param[in,out] obj      Pointer to the object structure. When decrypting,
+ *                         the tag of the header is the one stored in the
+ *                         object table for the given File ID.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_header_crypt(uint32_t fid, bool encrypt,
                                            struct ps_object_t *obj)
 {
     psa_status_t err;
-    uint8_t *p_obj_data = (uint8_t *)&obj->header.info;
-    size_t out_len, label_length;
+    union ps_crypto_t *crypto = &obj->header.crypto;
+    uint8_t *p_info = (uint8_t *)&obj->header.info;
+
+    if (encrypt) {
+        /* Get a new IV for each encryption */
+        err = ps_crypto_get_iv(crypto);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        (void)memcpy(obj->header.seg.iv, crypto->ref.iv,
+                     sizeof(obj->header.seg.iv));
+        obj->header.seg.fid = fid;
+    } else {
+        (void)memcpy(crypto->ref.iv, obj->header.seg.iv,
+                     sizeof(obj->header.seg.iv));
+    }
+
+    err = ps_crypto_aead_setup(crypto, encrypt,
+                               (const uint8_t *)&obj->header.seg,
+                               sizeof(obj->header.seg),
+                               sizeof(obj->header.info));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_object_crypt_in_place(crypto, encrypt, p_info, p_info,
+                                   sizeof(obj->header.info));
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* The File ID is authenticated with the header. Check it to detect an
+     * object stored under another File ID.
+     */
+    if (!encrypt && (obj->header.seg.fid != fid ||
+        obj->header.info.current_size > PS_MAX_OBJECT_DATA_SIZE)) {
+        return PSA_ERROR_DATA_CORRUPT;
+    }
+
+    return PSA_SUCCESS;
+}
+
+enum ps_seg_read_t {
+    PS_SEG_READ_HEADER = 0, /* Only read and authenticate the header */
+    PS_SEG_READ_RANGE,      /* Decrypt the segments holding the range */
+    PS_SEG_READ_FOR_WRITE,  /* Decrypt the segments holding the range which
+                             * also hold data out of it, as a write of the
+                             * range replaces the other ones as a whole
+                             */
+};
+
+/**
+ * \brief Checks whether a segment holding bytes of a data range to write also
+ *        holds object data which is out of the range, and kept by the write.
+ *
+ * \param[in] idx       Segment index
+ * \param[in] offset    Offset of the range in the object data
+ * \param[in] size      Size of the range
+ * \param[in] cur_size  Current size of the object data
+ *
+ * \return Returns true if the segment holds data kept by the write
+ */
+static bool ps_object_segment_kept(uint32_t idx, uint32_t offset,
+                                   uint32_t size, uint32_t cur_size)
+{
+    uint32_t seg_start = idx * PS_OBJECT_SEGMENT_SIZE;
+    uint32_t seg_end = PS_UTILS_MIN(seg_start + PS_OBJECT_SEGMENT_SIZE,
+                                    cur_size);
+
+    return (seg_start < offset) || (seg_end - offset > size);
+}
+
+/**
+ * \brief Reads the stored object into the object buffer, authenticates its
+ *        header and decrypts the segments holding the given data range.
+ *
+ * \param[in]     fid     File ID
+ * \param[in]     type    Read type as specified in \ref ps_seg_read_t
+ * \param[in]     offset  Offset of the data range to decrypt
+ * \param[in]     size    Size of the data range to decrypt
+ * \param[in,out] obj     Pointer to the object structure to fill in
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_read_segments(uint32_t fid,
+                                            enum ps_seg_read_t type,
+                                            uint32_t offset, uint32_t size,
+                                            struct ps_object_t *obj)
+{
+    psa_status_t err;
+    size_t data_length, label_length;
+    bool read_data = (type != PS_SEG_READ_HEADER);
+    uint32_t idx;
 
     err = fill_key_label(obj, &label_length);
     if (err != PSA_SUCCESS) {
@@ -82,156 +345,384 @@ static psa_status_t ps_object_auth_decrypt(uint32_t fid,
         return err;
     }
 
-    (void)memcpy(ps_crypto_buf, p_obj_data, cur_size);
+    err = psa_its_get(fid, PS_OBJECT_START_POSITION,
+                      PS_SEG_DATA_OFFSET +
+                      (read_data ? PS_MAX_OBJECT_DATA_SIZE : 0),
+                      (void *)&obj->header.seg,
+                      &data_length);
+    if (err == PSA_SUCCESS && data_length < PS_SEG_DATA_OFFSET) {
+        err = PSA_ERROR_DATA_CORRUPT;
+    }
 
-    /* Use File ID as a part of the associated data to authenticate
-     * the object in the FS. The tag will be stored in the object table and
-     * not as a part of the object's data stored in the FS.
+    if (err == PSA_SUCCESS) {
+        err = ps_object_header_crypt(fid, false, obj);
+    }
+
+    if (err == PSA_SUCCESS && read_data &&
+        data_length != PS_SEG_DATA_OFFSET + obj->header.info.current_size) {
+        err = PSA_ERROR_DATA_CORRUPT;
+    }
+
+    /* Only decrypt the segments holding the requested range */
+    for (idx = offset / PS_OBJECT_SEGMENT_SIZE;
+         err == PSA_SUCCESS && read_data &&
+         idx < PS_SEG_NUM(obj->header.info.current_size) &&
+         ps_object_segment_in_range(idx, offset, size);
+         idx++) {
+        if (type == PS_SEG_READ_FOR_WRITE &&
+            !ps_object_segment_kept(idx, offset, size,
+                                    obj->header.info.current_size)) {
+            /* Left encrypted, as the write replaces all its data */
+            continue;
+        }
+        err = ps_object_segment_crypt(idx, false, obj);
+    }
+
+    if (err != PSA_SUCCESS) {
+        /* Do not leave unauthenticated data in the object */
+        (void)memset(&obj->header.seg, 0,
+                     sizeof(*obj) - sizeof(obj->header.crypto));
+        (void)ps_crypto_destroykey();
+        return err;
+    }
+
+    return ps_crypto_destroykey();
+}
+
+psa_status_t ps_encrypted_object_read(uint32_t fid, struct ps_object_t *obj)
+{
+    return ps_object_read_segments(fid, PS_SEG_READ_RANGE, 0,
+                                   PS_MAX_OBJECT_DATA_SIZE, obj);
+}
+
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj)
+{
+    return ps_object_read_segments(fid, PS_SEG_READ_HEADER, 0, 0, obj);
+}
+
+psa_status_t ps_encrypted_object_read_range(uint32_t fid, uint32_t offset,
+                                            uint32_t size,
+                                            struct ps_object_t *obj)
+{
+    return ps_object_read_segments(fid, PS_SEG_READ_RANGE, offset, size, obj);
+}
+
+psa_status_t ps_encrypted_object_read_for_write(uint32_t fid, uint32_t offset,
+                                                uint32_t size,
+                                                struct ps_object_t *obj)
+{
+    return ps_object_read_segments(fid, PS_SEG_READ_FOR_WRITE, offset, size,
+                                   obj);
+}
+
+psa_status_t ps_encrypted_object_write_range(uint32_t fid, uint32_t offset,
+                                             uint32_t size,
+                                             struct ps_object_t *obj)
+{
+    psa_status_t err;
+    size_t label_length;
+    uint32_t wrt_size = PS_SEG_DATA_OFFSET + obj->header.info.current_size;
+    uint32_t num_seg = PS_SEG_NUM(obj->header.info.current_size);
+    uint32_t idx;
+
+    err = fill_key_label(obj, &label_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_crypto_setkey(ps_crypto_buf, label_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Only encrypt the segments holding the updated range. The other segments
+     * are still encrypted as they were read. The object information is
+     * encrypted last, as the header authenticates the segment table.
      */
+    for (idx = offset / PS_OBJECT_SEGMENT_SIZE;
+         err == PSA_SUCCESS && idx < num_seg &&
+         ps_object_segment_in_range(idx, offset, size);
+         idx++) {
+        err = ps_object_segment_crypt(idx, true, obj);
+    }
+
+    if (err == PSA_SUCCESS) {
+        /* Clear the metadata of the segments past the end of the object */
+        (void)memset(&obj->header.seg.segment[num_seg], 0,
+                     (PS_OBJECT_NUM_SEGMENTS - num_seg) *
+                     sizeof(struct ps_obj_segment_t));
+
+        err = ps_object_header_crypt(fid, true, obj);
+    }
+
+    if (err == PSA_SUCCESS) {
+        /* Write the stored object to the persistent area. The tag of the
+         * header is not copied as it is stored in the object table.
+         */
+        err = psa_its_set(fid, wrt_size, (const void *)&obj->header.seg,
+                          PSA_STORAGE_FLAG_NONE);
+    }
 
-    err = ps_crypto_auth_and_decrypt(&obj->header.crypto,
-                                     (const uint8_t *)&fid,
-                                     sizeof(fid),
-                                     ps_crypto_buf,
-                                     cur_size,
-                                     p_obj_data,
-                                     sizeof(*obj) - sizeof(obj->header.crypto),
-                                     &out_len);
-    if (err != PSA_SUCCESS || out_len != cur_size) {
+    if (err != PSA_SUCCESS) {
         (void)ps_crypto_destroykey();
-        return PSA_ERROR_GENERIC_ERROR;
+        return err;
     }
 
     return ps_crypto_destroykey();
 }
 
+psa_status_t ps_encrypted_object_write(uint32_t fid, struct ps_object_t *obj)
+{
+    return ps_encrypted_object_write_range(fid, 0, PS_MAX_OBJECT_DATA_SIZE,
+                                           obj);
+}
+
+#else /* PS_OBJECT_SEGMENTED */
+
 /**
- * \brief Performs authenticated encryption on object data, with the header as
+ * \brief Performs authenticated decryption on object data, with the header as
  *        the associated data.
  *
  * \param[in]  fid       File ID
- * \param[in]  cur_size  Size of the object data to encrypt
- * \param[out] obj       Pointer to the object structure to authenticate and
- *                       fill in with the encrypted data.
+ * \param[in]  cur_size  Size of the object data to decrypt
+ * \param[in]  crypto    Pointer to the crypto metadata of the object. The tag
+ *                       is the one stored in the object table for the given
+ *                       File ID.
+ * \param[in,out] obj    Pointer to the object structure holding the encrypted
+ *                       data at its start, to fill in with the decrypted data.
  *
  * \return Returns error code as specified in \ref psa_status_t
  */
-static psa_status_t ps_object_auth_encrypt(uint32_t fid,
+static psa_status_t ps_object_auth_decrypt(uint32_t fid,
                                            uint32_t cur_size,
+                                           union ps_crypto_t *crypto,
                                            struct ps_object_t *obj)
 {
     psa_status_t err;
     uint8_t *p_obj_data = (uint8_t *)&obj->header.info;
-    size_t out_len, label_length;
 
-    err = fill_key_label(obj, &label_length);
+    /* Use File ID as a part of the associated data to authenticate
+     * the object in the FS. The tag will be stored in the object table and
+     * not as a part of the object's data stored in the FS.
+     */
+    err = ps_crypto_aead_setup(crypto, false, (const uint8_t *)&fid,
+                               sizeof(fid), cur_size);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
-    err = ps_crypto_setkey(ps_crypto_buf, label_length);
+    /* Decrypt to the start of the object, as the encrypted data is there */
+    err = ps_object_crypt_in_place(crypto, false, (const uint8_t *)obj,
+                                   (uint8_t *)obj, cur_size);
     if (err != PSA_SUCCESS) {
-        return err;
+        return PSA_ERROR_GENERIC_ERROR;
     }
 
-    /* Get a new IV for each encryption */
-    err = ps_crypto_get_iv(&obj->header.crypto);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
+    /* Move the decrypted data after the crypto metadata */
+    (void)memmove(p_obj_data, obj, cur_size);
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Performs authenticated encryption on object data, with the header as
+ *        the associated data.
+ *
+ * \param[in]  fid       File ID
+ * \param[in]  cur_size  Size of the object data to encrypt
+ * \param[in]  crypto    Pointer to the crypto metadata of the object, to fill
+ *                       in with the tag
+ * \param[in,out] obj    Pointer to the object structure to encrypt. The
+ *                       encrypted data is output at the start of the object.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_auth_encrypt(uint32_t fid,
+                                           uint32_t cur_size,
+                                           union ps_crypto_t *crypto,
+                                           struct ps_object_t *obj)
+{
+    psa_status_t err;
+    uint8_t *p_obj_data = (uint8_t *)&obj->header.info;
 
     /* Use File ID as a part of the associated data to authenticate
      * the object in the FS. The tag will be stored in the object table and
      * not as a part of the object's data stored in the FS.
      */
+    err = ps_crypto_aead_setup(crypto, true, (const uint8_t *)&fid,
+                               sizeof(fid), cur_size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
 
-    err = ps_crypto_encrypt_and_tag(&obj->header.crypto,
-                                    (const uint8_t *)&fid,
-                                    sizeof(fid),
-                                    p_obj_data,
-                                    cur_size,
-                                    ps_crypto_buf,
-                                    sizeof(ps_crypto_buf),
-                                    &out_len);
-    if (err != PSA_SUCCESS || out_len != cur_size) {
-        (void)ps_crypto_destroykey();
+    err = ps_object_crypt_in_place(crypto, true, p_obj_data, (uint8_t *)obj,
+                                   cur_size);
+    if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
     }
 
-    (void)memcpy(p_obj_data, ps_crypto_buf, cur_size);
-
-    return ps_crypto_destroykey();
+    return PSA_SUCCESS;
 }
 
 psa_status_t ps_encrypted_object_read(uint32_t fid, struct ps_object_t *obj)
 {
     psa_status_t err;
     uint32_t decrypt_size;
-    size_t data_length;
+    size_t data_length, label_length;
+    union ps_crypto_t crypto;
 
-    /* Read the encrypted object from the persistent area. The data stored via
-     * ITS interface of this `fid` is the encrypted object together with the
-     * `IV`.
-     * In the psa_its_get, the buffer size is not checked. Check the buffer size
-     * here.
-     */
-    if (sizeof(ps_crypto_buf) < PS_MAX_ENCRYPTED_OBJ_SIZE + PS_IV_LEN_BYTES) {
-        return PSA_ERROR_GENERIC_ERROR;
+    err = fill_key_label(obj, &label_length);
+    if (err != PSA_SUCCESS) {
+        return err;
     }
-    err = psa_its_get(fid, PS_OBJECT_START_POSITION,
-                      PS_MAX_ENCRYPTED_OBJ_SIZE + PS_IV_LEN_BYTES,
-                      (void *)ps_crypto_buf,
-                      &data_length);
+
+    err = ps_crypto_setkey(ps_crypto_buf, label_length);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
-    /* Get the decrypt size. IV is also stored by ITS service. It is at the end
-     * of the read out data. Toolchains may add padding byte after iv array in
-     * crypto.ref structure. Separate the copies of header.info and iv array to
-     * skip the padding byte.
+    /* The crypto metadata is overwritten by the stored object below */
+    crypto = obj->header.crypto;
+
+    /* Read the encrypted object from the persistent area to the start of the
+     * object. The data stored via ITS interface of this `fid` is the encrypted
+     * object together with the `IV`.
+     * In the psa_its_get, the buffer size is not checked. The IV bound check
+     * at the top of this file ensures that it fits in the object.
      */
-    decrypt_size = data_length - sizeof(obj->header.crypto.ref.iv);
-    memcpy(&obj->header.info, ps_crypto_buf, decrypt_size);
-    memcpy(obj->header.crypto.ref.iv,
-           ps_crypto_buf + decrypt_size,
-           sizeof(obj->header.crypto.ref.iv));
+    err = psa_its_get(fid, PS_OBJECT_START_POSITION,
+                      PS_MAX_ENCRYPTED_OBJ_SIZE + PS_IV_LEN_BYTES,
+                      (void *)obj,
+                      &data_length);
+    if (err == PSA_SUCCESS && data_length < PS_IV_LEN_BYTES) {
+        err = PSA_ERROR_DATA_CORRUPT;
+    }
+
+    if (err == PSA_SUCCESS) {
+        /* Get the decrypt size. IV is also stored by ITS service. It is at the
+         * end of the read out data. Toolchains may add padding byte after iv
+         * array in crypto.ref structure, so the iv array is copied on its own.
+         */
+        decrypt_size = data_length - sizeof(crypto.ref.iv);
+        memcpy(crypto.ref.iv, (uint8_t *)obj + decrypt_size,
+               sizeof(crypto.ref.iv));
+
+        /* Decrypt the object data */
+        err = ps_object_auth_decrypt(fid, decrypt_size, &crypto, obj);
+    }
+
+    obj->header.crypto = crypto;
 
-    /* Decrypt the object data */
-    err = ps_object_auth_decrypt(fid, decrypt_size, obj);
     if (err != PSA_SUCCESS) {
+        /* Do not leave unauthenticated data in the object */
+        (void)memset(&obj->header.info, 0,
+                     sizeof(*obj) - sizeof(obj->header.crypto));
+        (void)ps_crypto_destroykey();
         return err;
     }
 
-    return PSA_SUCCESS;
+    return ps_crypto_destroykey();
 }
 
 psa_status_t ps_encrypted_object_write(uint32_t fid, struct ps_object_t *obj)
 {
     psa_status_t err;
     uint32_t wrt_size;
+    size_t label_length;
+    union ps_crypto_t crypto;
 
     wrt_size = PS_ENCRYPT_SIZE(obj->header.info.current_size);
 
+    err = fill_key_label(obj, &label_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = ps_crypto_setkey(ps_crypto_buf, label_length);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Get a new IV for each encryption */
+    err = ps_crypto_get_iv(&obj->header.crypto);
+    if (err != PSA_SUCCESS) {
+        (void)ps_crypto_destroykey();
+        return err;
+    }
+
+    /* The crypto metadata is overwritten by the encrypted object below */
+    crypto = obj->header.crypto;
+
     /* Authenticate and encrypt the object */
-    err = ps_object_auth_encrypt(fid, wrt_size, obj);
+    err = ps_object_auth_encrypt(fid, wrt_size, &crypto, obj);
+    if (err == PSA_SUCCESS) {
+        /* The IV will also be stored. Append the value of the 'iv' to the end
+         * of the encrypted data. Toolchains may add padding byte after iv array
+         * in crypto.ref structure. The padding byte shall not be written into
+         * the storage area.
+         */
+        (void)memcpy((uint8_t *)obj + wrt_size, crypto.ref.iv,
+                     sizeof(crypto.ref.iv));
+
+        /* Write the encrypted object to the persistent area. The tag values is
+         * not copied as it is stored in the object table.
+         */
+        err = psa_its_set(fid, wrt_size + sizeof(crypto.ref.iv),
+                          (const void *)obj, PSA_STORAGE_FLAG_NONE);
+    }
+
+    /* Put back the crypto metadata, with the tag of the new object */
+    obj->header.crypto = crypto;
+
     if (err != PSA_SUCCESS) {
+        (void)ps_crypto_destroykey();
         return err;
     }
 
-    /* The IV will also be stored. The encrypted data is stored in ps_crypto_buf
-     * now. Append the value of the 'iv' to the end of the encrypted data.
-     * Toolchains may add padding byte after iv array in crypto.ref structure.
-     * The padding byte shall not be written into the storage area.
-     */
-    (void)memcpy(ps_crypto_buf + wrt_size,
-                     obj->header.crypto.ref.iv,
-                     sizeof(obj->header.crypto.ref.iv));
-    wrt_size += sizeof(obj->header.crypto.ref.iv);
+    return ps_crypto_destroykey();
+}
 
-    /* Write the encrypted object to the persistent area. The tag values is not
-     * copied as it is stored in the object table.
-     */
-    return psa_its_set(fid, wrt_size, (const void *)ps_crypto_buf,
-                       PSA_STORAGE_FLAG_NONE);
+/* Without segments, the whole object is authenticated, decrypted and encrypted
+ * at once.
+ */
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj)
+{
+    return ps_encrypted_object_read(fid, obj);
 }
+
+psa_status_t ps_encrypted_object_read_range(uint32_t fid, uint32_t offset,
+                                            uint32_t size,
+                                            struct ps_object_t *obj)
+{
+    (void)offset;
+    (void)size;
+
+    return ps_encrypted_object_read(fid, obj);
+}
+
+/* The object information can only be trusted once the whole object is
+ * authenticated, so even a write replacing all the data reads it all.
+ */
+psa_status_t ps_encrypted_object_read_for_write(uint32_t fid, uint32_t offset,
+                                                uint32_t size,
+                                                struct ps_object_t *obj)
+{
+    (void)offset;
+    (void)size;
+
+    return ps_encrypted_object_read(fid, obj);
+}
+
+psa_status_t ps_encrypted_object_write_range(uint32_t fid, uint32_t offset,
+                                             uint32_t size,
+                                             struct ps_object_t *obj)
+{
+    (void)offset;
+    (void)size;
+
+    return ps_encrypted_object_write(fid, obj);
+}
+
+#endif /* PS_OBJECT_SEGMENTED */
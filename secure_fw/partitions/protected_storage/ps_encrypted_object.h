@@ -27,6 +27,59 @@ extern "C" {
 psa_status_t ps_encrypted_object_read(uint32_t fid,
                                       struct ps_object_t *obj);
 
+/**
+ * \brief Reads and authenticates the header of the object referenced by the
+ *        object File ID.
+ *
+ * \param[in]  fid      File ID
+ * \param[out] obj      Pointer to the object structure to fill in. Only the
+ *                      object information is valid when objects are stored
+ *                      in segments, the whole object otherwise.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_header(uint32_t fid,
+                                             struct ps_object_t *obj);
+
+/**
+ * \brief Reads object referenced by the object File ID, and decrypts the part
+ *        of its data needed for the given range.
+ *
+ * \param[in]  fid      File ID
+ * \param[in]  offset   Offset of the range in the object data
+ * \param[in]  size     Size of the range
+ * \param[out] obj      Pointer to the object structure to fill in. When
+ *                      objects are stored in segments, only the segments
+ *                      holding bytes of the range are decrypted, the others
+ *                      are left encrypted for
+ *                      \ref ps_encrypted_object_write_range.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_range(uint32_t fid, uint32_t offset,
+                                            uint32_t size,
+                                            struct ps_object_t *obj);
+
+/**
+ * \brief Reads object referenced by the object File ID, to write the given
+ *        range of its data.
+ *
+ * \param[in]  fid      File ID
+ * \param[in]  offset   Offset of the range in the object data
+ * \param[in]  size     Size of the range
+ * \param[out] obj      Pointer to the object structure to fill in. When
+ *                      objects are stored in segments, only the segments
+ *                      holding bytes of the range and data out of it are
+ *                      decrypted, as the write replaces the data of the
+ *                      other segments of the range. Their content is not
+ *                      valid until the range is written.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_read_for_write(uint32_t fid, uint32_t offset,
+                                                uint32_t size,
+                                                struct ps_object_t *obj);
+
 /**
  * \brief Creates and writes a new encrypted object based on the given
  *        ps_object_t structure data.
@@ -34,16 +87,36 @@ psa_status_t ps_encrypted_object_read(uint32_t fid,
  * \param[in]     fid      File ID
  * \param[in,out] obj      Pointer to the object structure to write.
  *
- * Note: The function will use obj to store the encrypted data before write it
+ * Note: The function encrypts the object in place in obj before writing it
  *       into the flash to reduce the memory requirements and the number of
- *       internal copies. So, this object will contain the encrypted object
- *       stored in the flash.
+ *       internal copies. So, only the crypto metadata of the object, which
+ *       holds the new tag, is valid after the call.
  *
  * \return Returns error code specified in \ref psa_status_t
  */
 psa_status_t ps_encrypted_object_write(uint32_t fid,
                                        struct ps_object_t *obj);
 
+/**
+ * \brief Writes an object read by \ref ps_encrypted_object_read_for_write
+ *        after its data has been updated in the given range.
+ *
+ * \param[in]     fid      File ID
+ * \param[in]     offset   Offset of the updated range in the object data
+ * \param[in]     size     Size of the updated range
+ * \param[in,out] obj      Pointer to the object structure to write. When
+ *                         objects are stored in segments, only the segments
+ *                         holding bytes of the range are encrypted again.
+ *
+ * Note: As for \ref ps_encrypted_object_write, only the crypto metadata of the
+ *       object is valid after the call.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_encrypted_object_write_range(uint32_t fid, uint32_t offset,
+                                             uint32_t size,
+                                             struct ps_object_t *obj);
+
 #ifdef __cplusplus
 }
 #endif
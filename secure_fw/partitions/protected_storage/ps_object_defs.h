@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -28,6 +28,41 @@ struct ps_object_info_t {
     psa_storage_create_flags_t create_flags; /*!< Object creation flags */
 };
 
+#define PS_MAX_OBJECT_DATA_SIZE  PS_MAX_ASSET_SIZE
+
+#if defined(PS_ENCRYPTION) && (PS_OBJECT_SEGMENT_SIZE > 0)
+/* Objects are stored as segments authenticated on their own */
+#define PS_OBJECT_SEGMENTED
+
+/* The number of segments of the largest object */
+#define PS_OBJECT_NUM_SEGMENTS \
+    ((PS_MAX_OBJECT_DATA_SIZE + PS_OBJECT_SEGMENT_SIZE - 1) / \
+     PS_OBJECT_SEGMENT_SIZE)
+
+/*!
+ * \struct ps_obj_segment_t
+ *
+ * \brief Crypto metadata of an object segment.
+ */
+struct ps_obj_segment_t {
+    uint8_t iv[PS_IV_LEN_BYTES];   /*!< IV of the segment */
+    uint8_t tag[PS_TAG_LEN_BYTES]; /*!< MAC value of the segment */
+};
+
+/*!
+ * \struct ps_obj_segment_table_t
+ *
+ * \brief Metadata of the object segments, stored in front of the object
+ *        information. It is authenticated by the tag of the object header,
+ *        which is kept in the object table.
+ */
+struct ps_obj_segment_table_t {
+    uint32_t fid;                 /*!< File ID */
+    uint8_t iv[PS_IV_LEN_BYTES];  /*!< IV of the object header */
+    struct ps_obj_segment_t segment[PS_OBJECT_NUM_SEGMENTS]; /*!< Segments */
+};
+#endif /* PS_ENCRYPTION && PS_OBJECT_SEGMENT_SIZE > 0 */
+
 /*!
  * \struct ps_obj_header_t
  *
@@ -36,6 +71,9 @@ struct ps_object_info_t {
 struct ps_obj_header_t {
 #ifdef PS_ENCRYPTION
     union ps_crypto_t crypto;     /*!< Crypto metadata */
+#ifdef PS_OBJECT_SEGMENTED
+    struct ps_obj_segment_table_t seg; /*!< Segment metadata */
+#endif
 #else
     uint32_t version;              /*!< Object version */
     uint32_t fid;                  /*!< File ID */
@@ -43,9 +81,6 @@ struct ps_obj_header_t {
     struct ps_object_info_t info; /*!< Object information */
 };
 
-
-#define PS_MAX_OBJECT_DATA_SIZE  PS_MAX_ASSET_SIZE
-
 /*!
  * \struct ps_object_t
  *
@@ -66,8 +101,13 @@ struct ps_object_t {
  *
  * \brief Specifies the maximum number of objects in the system, which is the
  *        number of defined assets, the object table and 2 temporary objects to
- *        store the temporary object table and temporary updated object.
+ *        store the temporary object table and temporary updated object, plus
+ *        the object table journal when it is enabled.
  */
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+#define PS_MAX_NUM_OBJECTS (PS_NUM_ASSETS + 4)
+#else
 #define PS_MAX_NUM_OBJECTS (PS_NUM_ASSETS + 3)
+#endif
 
 #endif /* __PS_OBJECT_DEFS_H__ */
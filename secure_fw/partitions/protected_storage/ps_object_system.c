@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,7 @@
 
 #include "ps_object_system.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -18,6 +19,7 @@
 #include "ps_object_defs.h"
 #include "ps_object_table.h"
 #include "ps_utils.h"
+#include "tfm_ps_defs.h"
 #include "tfm_ps_req_mngr.h"
 
 #ifndef PS_ENCRYPTION
@@ -30,6 +32,59 @@
 static struct ps_object_t g_ps_object;
 static struct ps_obj_table_info_t g_obj_tbl_info;
 
+#if PS_WRITE_COALESCE_NUM
+/* Latest content of an object whose writes are held in RAM. The entry is
+ * clean when it holds no write that is not in the persistent area yet.
+ */
+struct ps_coalesce_entry_t {
+    psa_storage_uid_t uid;                   /* UID of the object */
+    int32_t client_id;                       /* Owner of the object */
+    psa_storage_create_flags_t create_flags; /* Create flags of the object */
+    uint32_t size;                           /* Size of the object data */
+    uint32_t pending;                        /* Writes held since the last
+                                              * flush
+                                              */
+    bool in_use;                             /* Entry holds an object */
+    uint8_t data[PS_MAX_ASSET_SIZE];         /* Latest object data */
+};
+
+static struct ps_coalesce_entry_t g_ps_coalesce[PS_WRITE_COALESCE_NUM];
+
+/**
+ * \brief Finds the entry holding the object with the provided UID and client
+ *        ID.
+ *
+ * \param[in] uid        Unique identifier for the data
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ *
+ * \return Pointer to the entry, or NULL if the object is not held
+ */
+static struct ps_coalesce_entry_t *ps_coalesce_find(psa_storage_uid_t uid,
+                                                    int32_t client_id)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < PS_WRITE_COALESCE_NUM; idx++) {
+        if (g_ps_coalesce[idx].in_use && g_ps_coalesce[idx].uid == uid &&
+            g_ps_coalesce[idx].client_id == client_id) {
+            return &g_ps_coalesce[idx];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Stops holding an object, discarding the writes not flushed yet.
+ *
+ * \param[in,out] entry  Pointer to the entry to release
+ */
+static void ps_coalesce_release(struct ps_coalesce_entry_t *entry)
+{
+    (void)memset(entry, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(*entry));
+}
+#endif /* PS_WRITE_COALESCE_NUM */
+
 /**
  * \brief Initialize g_ps_object based on the input parameters and empty data.
  *
@@ -130,6 +185,50 @@ static psa_status_t ps_read_object(enum read_type_t type)
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Reads the object data which is out of the given range, and so kept
+ *        by a write of the range, based on its object table info stored in
+ *        g_obj_tbl_info. The object header must have been read, and the
+ *        offset must not be larger than the current object size.
+ *
+ * \param[in] offset  Offset of the range in the object data
+ * \param[in] size    Size of the range
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_read_object_kept_data(uint32_t offset, uint32_t size)
+{
+    psa_status_t err;
+    size_t data_length;
+    uint32_t cur_size = g_ps_object.header.info.current_size;
+
+    /* Read the data before the range */
+    if (offset > 0) {
+        err = psa_its_get(g_obj_tbl_info.fid,
+                          PS_OBJECT_HEADER_SIZE,
+                          offset,
+                          (void *)g_ps_object.data,
+                          &data_length);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Read the data after the range */
+    if (cur_size - offset > size) {
+        err = psa_its_get(g_obj_tbl_info.fid,
+                          PS_OBJECT_HEADER_SIZE + offset + size,
+                          cur_size - offset - size,
+                          (void *)(g_ps_object.data + offset + size),
+                          &data_length);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
 /**
  * \brief Writes an object based on its object table info stored in
  *        g_obj_tbl_info and the input parameter.
@@ -177,6 +276,25 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
                             size_t *p_data_length)
 {
     psa_status_t err;
+#if PS_WRITE_COALESCE_NUM
+    struct ps_coalesce_entry_t *entry;
+
+    /* A held object is more recent in RAM than in the persistent area */
+    entry = ps_coalesce_find(uid, client_id);
+    if (entry != NULL) {
+        if (offset > entry->size) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+
+        size = PS_UTILS_MIN(size, entry->size - offset);
+
+        ps_req_mngr_write_asset_data(entry->data + offset, size);
+
+        *p_data_length = size;
+
+        return PSA_SUCCESS;
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -191,7 +309,8 @@ psa_status_t ps_object_read(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_range(g_obj_tbl_info.fid, offset, size,
+                                         &g_ps_object);
 #else
     /* Read object header */
     err = ps_read_object(READ_ALL_OBJECT);
@@ -222,9 +341,22 @@ clear_data_and_return:
     return err;
 }
 
-psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
-                              psa_storage_create_flags_t create_flags,
-                              uint32_t size)
+/**
+ * \brief Creates or replaces an object with the provided UID and client ID,
+ *        and stores it in the persistent area.
+ *
+ * \param[in] uid           Unique identifier for the data
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] create_flags  Flags indicating the properties of the data
+ * \param[in] size          Size of the contents of `data` in bytes
+ * \param[in] data          Pointer to the data of the object, or NULL to read
+ *                          it from the client request
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_set(psa_storage_uid_t uid, int32_t client_id,
+                                  psa_storage_create_flags_t create_flags,
+                                  uint32_t size, const uint8_t *data)
 {
     psa_status_t err;
     uint32_t old_fid = PS_INVALID_FID;
@@ -249,7 +381,8 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         g_ps_object.header.crypto.ref.uid = uid;
         g_ps_object.header.crypto.ref.client_id = client_id;
 
-        err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+        err = ps_encrypted_object_read_header(g_obj_tbl_info.fid,
+                                              &g_ps_object);
 #else
         /* Read the object header */
         err = ps_read_object(READ_HEADER_ONLY);
@@ -274,6 +407,15 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
         /* Save old file ID */
         old_fid = g_obj_tbl_info.fid;
     } else if (err == PSA_ERROR_DOES_NOT_EXIST) {
+#if PS_CLIENT_MAX_NUM_ASSETS > 0
+        /* Keep a client from taking all the object table entries */
+        if (ps_object_table_count_objects(client_id) >=
+            PS_CLIENT_MAX_NUM_ASSETS) {
+            err = PSA_ERROR_INSUFFICIENT_STORAGE;
+            goto clear_data_and_return;
+        }
+#endif
+
         /* If the object does not exist, then initialize it based on the input
          * arguments and empty content. Requests 2 FIDs to prevent exhaustion.
          */
@@ -284,9 +426,13 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
     }
 
     /* Update the object data */
-    err = ps_req_mngr_read_asset_data(g_ps_object.data, size);
-    if (err != PSA_SUCCESS) {
-        goto clear_data_and_return;
+    if (data != NULL) {
+        (void)memcpy(g_ps_object.data, data, size);
+    } else {
+        err = ps_req_mngr_read_asset_data(g_ps_object.data, size);
+        if (err != PSA_SUCCESS) {
+            goto clear_data_and_return;
+        }
     }
 
     /* Update the current object size */
@@ -342,6 +488,145 @@ clear_data_and_return:
     return err;
 }
 
+#if PS_WRITE_COALESCE_NUM
+/**
+ * \brief Stores the writes held for an object in the persistent area.
+ *
+ * \param[in,out] entry  Pointer to the entry holding the object
+ *
+ * \note If the object cannot be stored, the entry is released and the object
+ *       reverts to its content in the persistent area.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+static psa_status_t ps_coalesce_flush(struct ps_coalesce_entry_t *entry)
+{
+    psa_status_t err;
+
+    err = ps_object_set(entry->uid, entry->client_id, entry->create_flags,
+                        entry->size, entry->data);
+    if (err != PSA_SUCCESS) {
+        ps_coalesce_release(entry);
+        return err;
+    }
+
+    entry->pending = 0;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes an object created with \ref TFM_PS_FLAG_COALESCE_WRITES.
+ *
+ * \details If the object is held with the same create flags, the write is
+ *          held in RAM and only stored once PS_WRITE_COALESCE_LIMIT writes
+ *          are held. Otherwise the write is stored at once, and the object
+ *          is then held if an entry is free or clean.
+ *
+ * \param[in] uid           Unique identifier for the data
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] create_flags  Flags indicating the properties of the data
+ * \param[in] size          Size of the contents of `data` in bytes
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+static psa_status_t ps_coalesce_set(psa_storage_uid_t uid, int32_t client_id,
+                                    psa_storage_create_flags_t create_flags,
+                                    uint32_t size)
+{
+    psa_status_t err;
+    struct ps_coalesce_entry_t *entry;
+    uint32_t idx;
+
+    /* Boundary check the incoming request */
+    if (size > PS_MAX_ASSET_SIZE) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    entry = ps_coalesce_find(uid, client_id);
+    if (entry != NULL && entry->create_flags == create_flags) {
+        /* Read the data aside so that a failed read keeps the held data */
+        err = ps_req_mngr_read_asset_data(g_ps_object.data, size);
+        if (err == PSA_SUCCESS) {
+            (void)memcpy(entry->data, g_ps_object.data, size);
+            entry->size = size;
+            entry->pending++;
+        }
+
+        (void)memset(g_ps_object.data, PS_DEFAULT_EMPTY_BUFF_VAL, size);
+
+        if (err != PSA_SUCCESS ||
+            entry->pending < PS_WRITE_COALESCE_LIMIT) {
+            return err;
+        }
+
+        return ps_coalesce_flush(entry);
+    }
+
+    /* Look for an entry to hold the object once it is stored */
+    for (idx = 0; entry == NULL && idx < PS_WRITE_COALESCE_NUM; idx++) {
+        if (!g_ps_coalesce[idx].in_use || g_ps_coalesce[idx].pending == 0) {
+            entry = &g_ps_coalesce[idx];
+        }
+    }
+
+    if (entry == NULL) {
+        /* All the entries hold writes of other objects */
+        return ps_object_set(uid, client_id, create_flags, size, NULL);
+    }
+
+    err = ps_req_mngr_read_asset_data(entry->data, size);
+    if (err == PSA_SUCCESS) {
+        err = ps_object_set(uid, client_id, create_flags, size, entry->data);
+    }
+
+    if (err != PSA_SUCCESS) {
+        ps_coalesce_release(entry);
+        return err;
+    }
+
+    entry->uid = uid;
+    entry->client_id = client_id;
+    entry->create_flags = create_flags;
+    entry->size = size;
+    entry->pending = 0;
+    entry->in_use = true;
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_WRITE_COALESCE_NUM */
+
+psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
+                              psa_storage_create_flags_t create_flags,
+                              uint32_t size)
+{
+#if PS_WRITE_COALESCE_NUM
+    psa_status_t err;
+    struct ps_coalesce_entry_t *entry;
+
+    /* A write once object cannot be held, as its writes must be rejected */
+    if ((create_flags & TFM_PS_FLAG_COALESCE_WRITES) &&
+        !(create_flags & PSA_STORAGE_FLAG_WRITE_ONCE)) {
+        return ps_coalesce_set(uid, client_id, create_flags, size);
+    }
+
+    err = ps_object_set(uid, client_id, create_flags, size, NULL);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The held writes are superseded by the stored content */
+    entry = ps_coalesce_find(uid, client_id);
+    if (entry != NULL) {
+        ps_coalesce_release(entry);
+    }
+
+    return PSA_SUCCESS;
+#else
+    return ps_object_set(uid, client_id, create_flags, size, NULL);
+#endif
+}
+
 psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
                              uint32_t offset, uint32_t size)
 {
@@ -351,6 +636,19 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
 #ifndef PS_ENCRYPTION
     uint32_t wrt_size;
 #endif
+#if PS_WRITE_COALESCE_NUM
+    struct ps_coalesce_entry_t *entry;
+
+    /* The write updates the stored object, so it must hold the latest data */
+    entry = ps_coalesce_find(uid, client_id);
+    if (entry != NULL) {
+        err = (entry->pending != 0) ? ps_coalesce_flush(entry) : PSA_SUCCESS;
+        ps_coalesce_release(entry);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -360,14 +658,15 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         return err;
     }
 
-    /* Read the object */
+    /* Read the object, leaving out the data the write replaces */
 #ifdef PS_ENCRYPTION
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_for_write(g_obj_tbl_info.fid, offset, size,
+                                             &g_ps_object);
 #else
-    err = ps_read_object(READ_ALL_OBJECT);
+    err = ps_read_object(READ_HEADER_ONLY);
 #endif
     if (err != PSA_SUCCESS) {
         goto clear_data_and_return;
@@ -394,6 +693,13 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
         goto clear_data_and_return;
     }
 
+#ifndef PS_ENCRYPTION
+    err = ps_read_object_kept_data(offset, size);
+    if (err != PSA_SUCCESS) {
+        goto clear_data_and_return;
+    }
+#endif
+
     /* Update the object data */
     err = ps_req_mngr_read_asset_data(g_ps_object.data + offset, size);
     if (err != PSA_SUCCESS) {
@@ -418,7 +724,8 @@ psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_write(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_write_range(g_obj_tbl_info.fid, offset, size,
+                                          &g_ps_object);
 #else
     wrt_size = PS_OBJECT_SIZE(g_ps_object.header.info.current_size);
 
@@ -457,6 +764,17 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
                                 struct psa_storage_info_t *info)
 {
     psa_status_t err;
+#if PS_WRITE_COALESCE_NUM
+    struct ps_coalesce_entry_t *entry;
+
+    entry = ps_coalesce_find(uid, client_id);
+    if (entry != NULL) {
+        info->size = entry->size;
+        info->flags = entry->create_flags;
+
+        return PSA_SUCCESS;
+    }
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -470,7 +788,7 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
 #else
     err = ps_read_object(READ_HEADER_ONLY);
 #endif
@@ -493,6 +811,9 @@ clear_data_and_return:
 psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
 {
     psa_status_t err;
+#if PS_WRITE_COALESCE_NUM
+    struct ps_coalesce_entry_t *entry;
+#endif
 
     /* Retrieve the object information from the object table if the object
      * exists.
@@ -506,7 +827,7 @@ psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
     g_ps_object.header.crypto.ref.uid = uid;
     g_ps_object.header.crypto.ref.client_id = client_id;
 
-    err = ps_encrypted_object_read(g_obj_tbl_info.fid, &g_ps_object);
+    err = ps_encrypted_object_read_header(g_obj_tbl_info.fid, &g_ps_object);
 #else
     err = ps_read_object(READ_HEADER_ONLY);
 #endif
@@ -528,6 +849,14 @@ psa_status_t ps_object_delete(psa_storage_uid_t uid, int32_t client_id)
         goto clear_data_and_return;
     }
 
+#if PS_WRITE_COALESCE_NUM
+    /* The writes held for the object are deleted with it */
+    entry = ps_coalesce_find(uid, client_id);
+    if (entry != NULL) {
+        ps_coalesce_release(entry);
+    }
+#endif
+
     /* Remove old object table and file */
     err = ps_remove_old_data(g_obj_tbl_info.fid);
 
@@ -548,5 +877,31 @@ psa_status_t ps_system_wipe_all(void)
      * this function doesn't block on the lock and directly
      * moves to erasing the flash instead.
      */
+#if PS_WRITE_COALESCE_NUM
+    (void)memset(g_ps_coalesce, PS_DEFAULT_EMPTY_BUFF_VAL,
+                 sizeof(g_ps_coalesce));
+#endif
+
     return ps_object_table_create();
 }
+
+psa_status_t ps_object_flush(void)
+{
+    psa_status_t err = PSA_SUCCESS;
+#if PS_WRITE_COALESCE_NUM
+    psa_status_t flush_err;
+    uint32_t idx;
+
+    /* Flush every object, even after a failure, and report the first error */
+    for (idx = 0; idx < PS_WRITE_COALESCE_NUM; idx++) {
+        if (g_ps_coalesce[idx].in_use && g_ps_coalesce[idx].pending != 0) {
+            flush_err = ps_coalesce_flush(&g_ps_coalesce[idx]);
+            if (err == PSA_SUCCESS) {
+                err = flush_err;
+            }
+        }
+    }
+#endif
+
+    return err;
+}
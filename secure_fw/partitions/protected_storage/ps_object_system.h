@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -99,6 +99,16 @@ psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
  */
 psa_status_t ps_system_wipe_all(void);
 
+/**
+ * \brief Stores the object writes held in RAM in the persistent area.
+ *
+ * \note The writes of an object that cannot be stored are discarded, and the
+ *       object reverts to its content in the persistent area.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_object_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
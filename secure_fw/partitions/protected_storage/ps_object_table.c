@@ -7,6 +7,7 @@
 
 #include "ps_object_table.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -17,10 +18,18 @@
 #include "psa/internal_trusted_storage.h"
 #include "ps_utils.h"
 #include "tfm_ps_defs.h"
+#include "tfm_yield.h"
 
 /* FIXME: Duplicated from flash info */
 #define PS_FLASH_DEFAULT_VAL 0xFFU
 
+/* Specifies if several saves share one increment of the PS NV counters */
+#if PS_ROLLBACK_PROTECTION && (PS_NV_COUNTER_UPDATE_INTERVAL > 1)
+#define PS_NVC_BATCHED 1
+#else
+#define PS_NVC_BATCHED 0
+#endif
+
 /*!
  * \def PS_OBJECT_SYSTEM_VERSION
  *
@@ -67,6 +76,13 @@ struct ps_obj_table_t {
                                   */
 #endif /* PS_ROLLBACK_PROTECTION */
 
+#if PS_NVC_BATCHED
+  uint32_t nvc_sub;              /*!< Number of saves since PS NV counter 1
+                                  *   was incremented, to order the saves
+                                  *   made with the same counter value.
+                                  */
+#endif
+
   struct ps_obj_table_entry_t obj_db[PS_OBJ_TABLE_ENTRIES]; /*!< Table's
                                                              *   entries
                                                              */
@@ -133,11 +149,135 @@ struct ps_obj_table_ctx_t {
     struct ps_obj_table_t obj_table;  /*!< Object tables */
     uint8_t active_table;             /*!< Active object table */
     uint8_t scratch_table;            /*!< Scratch object table */
+#if PS_NVC_BATCHED
+    uint32_t nvc_sub;                 /*!< Sub count of the latest save */
+#endif
 };
 
 /* Object table context */
 static struct ps_obj_table_ctx_t ps_obj_table_ctx;
 
+/* Number of hash buckets in the object table index */
+#define PS_OBJ_TABLE_NUM_BUCKETS  PS_OBJ_TABLE_ENTRIES
+
+/* Marks the end of a hash chain in the object table index */
+#define PS_OBJ_TABLE_IDX_NONE     UINT16_MAX
+
+/* Number of words in the free entry bitmap */
+#define PS_OBJ_TABLE_FREE_WORDS   ((PS_OBJ_TABLE_ENTRIES + 31) / 32)
+
+#if PS_OBJ_TABLE_ENTRIES >= PS_OBJ_TABLE_IDX_NONE
+#error "PS_NUM_ASSETS is too large for the object table index"
+#endif
+
+/*!
+ * \struct ps_obj_table_index_t
+ *
+ * \brief RAM index of the object table entries, hashed on (uid, client_id).
+ *
+ * \note The index is never stored in the file system. It is rebuilt each time
+ *       the object table is loaded or created, and kept in step with every
+ *       change made to the table entries afterwards.
+ */
+struct ps_obj_table_index_t {
+    uint16_t bucket[PS_OBJ_TABLE_NUM_BUCKETS]; /*!< First entry of each hash
+                                                *   chain
+                                                */
+    uint16_t next[PS_OBJ_TABLE_ENTRIES];       /*!< Next entry in the same
+                                                *   hash chain
+                                                */
+    uint32_t free_map[PS_OBJ_TABLE_FREE_WORDS]; /*!< One bit set for each
+                                                 *   free entry
+                                                 */
+    uint32_t num_free;                         /*!< Number of free entries */
+};
+
+/* Object table index */
+static struct ps_obj_table_index_t ps_obj_table_index;
+
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+/*!
+ * \def PS_OBJ_TABLE_JOURNAL_FS_ID
+ *
+ * \brief File ID to be used in order to store the object table journal in the
+ *        file system. It follows the file IDs of all the table entries.
+ */
+#define PS_OBJ_TABLE_JOURNAL_FS_ID PS_OBJECT_FS_ID(PS_OBJ_TABLE_ENTRIES)
+
+/*!
+ * \struct ps_obj_table_journal_rec_t
+ *
+ * \brief Object table journal record, the new content of one table entry.
+ */
+struct ps_obj_table_journal_rec_t {
+    uint32_t idx;                      /*!< Index of the entry in the table */
+    struct ps_obj_table_entry_t entry; /*!< New content of the entry */
+};
+
+/*!
+ * \struct ps_obj_table_journal_t
+ *
+ * \brief Object table journal structure.
+ *
+ * \details The journal holds the entries changed since the object table was
+ *          last saved, and is bound to that table. A change is saved by
+ *          rewriting the journal only, so its cost depends on the number of
+ *          records rather than on the number of table entries. When the
+ *          journal is full, the whole table is saved instead, which makes the
+ *          journal stale.
+ */
+struct ps_obj_table_journal_t {
+#ifdef PS_ENCRYPTION
+    union ps_crypto_t crypto;           /*!< Crypto metadata */
+    uint8_t base_tag[PS_TAG_LEN_BYTES]; /*!< Tag of the object table the
+                                         *   records apply to
+                                         */
+#if PS_ROLLBACK_PROTECTION
+    uint32_t base_nvc;                  /*!< NV counter 1 value the object
+                                         *   table was authenticated with
+                                         */
+    uint32_t nv_counter;                /*!< NV counter 1 value when the
+                                         *   journal was saved
+                                         */
+#if PS_NVC_BATCHED
+    uint32_t nvc_sub;                   /*!< Sub count when the journal was
+                                         *   saved
+                                         */
+#endif
+#endif /* PS_ROLLBACK_PROTECTION */
+#else
+    uint32_t base_swap_count;           /*!< Swap count of the object table
+                                         *   the records apply to
+                                         */
+#endif /* PS_ENCRYPTION */
+    uint32_t num_records;               /*!< Number of records in use */
+    struct ps_obj_table_journal_rec_t rec[PS_OBJ_TABLE_JOURNAL_ENTRIES];
+                                        /*!< Journal records, in the order
+                                         *   the changes were made
+                                         */
+};
+
+/* Size of the stored journal, which only includes the records in use */
+#define PS_OBJ_TABLE_JOURNAL_SIZE(num_records) \
+    (offsetof(struct ps_obj_table_journal_t, rec) + \
+     ((num_records) * sizeof(struct ps_obj_table_journal_rec_t)))
+
+/*!
+ * \struct ps_obj_table_journal_ctx_t
+ *
+ * \brief Object table journal context structure.
+ */
+struct ps_obj_table_journal_ctx_t {
+    struct ps_obj_table_journal_t journal; /*!< Journal of the active table */
+    bool table_saved;                      /*!< The last change saved the
+                                            *   whole table
+                                            */
+};
+
+/* Object table journal context */
+static struct ps_obj_table_journal_ctx_t ps_obj_table_journal_ctx;
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+
 /* Object table size */
 #define PS_OBJ_TABLE_SIZE            sizeof(struct ps_obj_table_t)
 
@@ -184,6 +324,12 @@ struct ps_crypto_assoc_data_t {
 PS_UTILS_BOUND_CHECK(OBJ_TABLE_NOT_FIT_IN_STATIC_OBJ_DATA_BUF,
                      PS_OBJ_TABLE_SIZE, PS_MAX_ASSET_SIZE);
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+/* Check at compilation time if the journal fits in a file of the PS area */
+PS_UTILS_BOUND_CHECK(OBJ_TABLE_JOURNAL_NOT_FIT_IN_FS_FILE,
+                     sizeof(struct ps_obj_table_journal_t), PS_MAX_ASSET_SIZE);
+#endif
+
 enum ps_obj_table_state {
     PS_OBJ_TABLE_VALID = 0,   /*!< Table content is valid */
     PS_OBJ_TABLE_INVALID,     /*!< Table content is invalid */
@@ -213,6 +359,11 @@ struct ps_obj_table_init_ctx_t {
     uint32_t nvc_1;        /*!< Non-volatile counter value 1 */
     uint32_t nvc_3;        /*!< Non-volatile counter value 3 */
 #endif /* PS_ROLLBACK_PROTECTION */
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    enum ps_obj_table_state journal_state; /*!< Indicates if the journal is
+                                            *   valid
+                                            */
+#endif
 };
 
 /**
@@ -236,6 +387,9 @@ __STATIC_INLINE void ps_object_table_fs_read_table(
                       (void *)init_ctx->p_table[PS_OBJ_TABLE_IDX_0],
                       &data_length);
     if (err != PSA_SUCCESS) {
+        /* Clear the buffer, which may hold a previous table */
+        (void)memset(init_ctx->p_table[PS_OBJ_TABLE_IDX_0],
+                     PS_DEFAULT_EMPTY_BUFF_VAL, PS_OBJ_TABLE_SIZE);
         init_ctx->table_state[PS_OBJ_TABLE_IDX_0] = PS_OBJ_TABLE_INVALID;
     }
 
@@ -246,10 +400,57 @@ __STATIC_INLINE void ps_object_table_fs_read_table(
                       (void *)init_ctx->p_table[PS_OBJ_TABLE_IDX_1],
                       &data_length);
     if (err != PSA_SUCCESS) {
+        /* Clear the buffer, which may hold a previous table */
+        (void)memset(init_ctx->p_table[PS_OBJ_TABLE_IDX_1],
+                     PS_DEFAULT_EMPTY_BUFF_VAL, PS_OBJ_TABLE_SIZE);
         init_ctx->table_state[PS_OBJ_TABLE_IDX_1] = PS_OBJ_TABLE_INVALID;
     }
 }
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+/**
+ * \brief Reads the object table journal from persistent memory and checks its
+ *        format.
+ *
+ * \param[out] init_ctx  Pointer to the init object table context
+ *
+ */
+__attribute__ ((always_inline))
+__STATIC_INLINE void ps_object_table_fs_read_journal(
+                                       struct ps_obj_table_init_ctx_t *init_ctx)
+{
+    struct ps_obj_table_journal_t *p_journal =
+                                          &ps_obj_table_journal_ctx.journal;
+    psa_status_t err;
+    size_t data_length = 0;
+    uint32_t i;
+
+    init_ctx->journal_state = PS_OBJ_TABLE_INVALID;
+
+    err = psa_its_get(PS_OBJ_TABLE_JOURNAL_FS_ID,
+                      PS_OBJECT_TABLE_OBJECT_OFFSET,
+                      sizeof(struct ps_obj_table_journal_t),
+                      (void *)p_journal,
+                      &data_length);
+    if (err != PSA_SUCCESS
+        || data_length < PS_OBJ_TABLE_JOURNAL_SIZE(0)
+        || p_journal->num_records > PS_OBJ_TABLE_JOURNAL_ENTRIES
+        || data_length != PS_OBJ_TABLE_JOURNAL_SIZE(p_journal->num_records)) {
+        p_journal->num_records = 0;
+        return;
+    }
+
+    for (i = 0; i < p_journal->num_records; i++) {
+        if (p_journal->rec[i].idx >= PS_OBJ_TABLE_ENTRIES) {
+            p_journal->num_records = 0;
+            return;
+        }
+    }
+
+    init_ctx->journal_state = PS_OBJ_TABLE_VALID;
+}
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+
 /**
  * \brief Writes object table in persistent memory.
  *
@@ -308,6 +509,8 @@ static psa_status_t ps_object_table_align_nv_counters(uint32_t nvc_1)
         if (err != PSA_SUCCESS) {
             return err;
         }
+
+        tfm_yield();
     }
 
     /* Align PS NVC 3 with NVC 1 */
@@ -321,11 +524,48 @@ static psa_status_t ps_object_table_align_nv_counters(uint32_t nvc_1)
         if (err != PSA_SUCCESS) {
             return err;
         }
+
+        tfm_yield();
     }
 
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Gets the PS NV counter 1 value to authenticate a new save with.
+ *
+ * \details NV counter 1 is incremented for the first save of each batch of
+ *          PS_NV_COUNTER_UPDATE_INTERVAL saves. The saves of a batch share
+ *          the counter value and are ordered by their sub count, which is
+ *          authenticated with the saved data.
+ *
+ * \param[out] nvc_1    Value of PS non-volatile counter 1
+ * \param[out] nvc_sub  Sub count of the save in the batch
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_get_save_nvc(uint32_t *nvc_1,
+                                                 uint32_t *nvc_sub)
+{
+    psa_status_t err;
+
+#if PS_NVC_BATCHED
+    *nvc_sub = ps_obj_table_ctx.nvc_sub + 1;
+    if (*nvc_sub < PS_NV_COUNTER_UPDATE_INTERVAL) {
+        return ps_read_nv_counter(TFM_PS_NV_COUNTER_1, nvc_1);
+    }
+#endif
+
+    *nvc_sub = 0;
+
+    err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_1);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return ps_read_nv_counter(TFM_PS_NV_COUNTER_1, nvc_1);
+}
+
 /**
  * \brief Generates table authentication tag.
  *
@@ -359,6 +599,31 @@ __STATIC_INLINE psa_status_t ps_object_table_nvc_generate_auth_tag(
                                        PS_CRYPTO_ASSOCIATED_DATA_LEN);
 }
 
+/**
+ * \brief Authenticates a table of objects against a value of PS
+ *        non-volatile counter 1.
+ *
+ * \param[in] obj_table  Pointer to the object table to authenticate
+ * \param[in] nvc        Value of PS non-volatile counter 1 to check with
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_nvc_check(
+                                        const struct ps_obj_table_t *obj_table,
+                                        uint32_t nvc)
+{
+    struct ps_crypto_assoc_data_t assoc_data;
+    const union ps_crypto_t *crypto = &obj_table->crypto;
+
+    assoc_data.nv_counter = nvc;
+    (void)memcpy(assoc_data.obj_table_data,
+                 PS_CRYPTO_ASSOCIATED_DATA(crypto),
+                 PS_OBJ_TABLE_AUTH_DATA_SIZE);
+
+    return ps_crypto_authenticate(crypto, (const uint8_t *)&assoc_data,
+                                  PS_CRYPTO_ASSOCIATED_DATA_LEN);
+}
+
 /**
  * \brief Authenticates table of objects.
  *
@@ -369,33 +634,25 @@ __STATIC_INLINE psa_status_t ps_object_table_nvc_generate_auth_tag(
 static void ps_object_table_authenticate(uint8_t table_idx,
                                        struct ps_obj_table_init_ctx_t *init_ctx)
 {
-    struct ps_crypto_assoc_data_t assoc_data;
-    union ps_crypto_t *crypto = &init_ctx->p_table[table_idx]->crypto;
+    const struct ps_obj_table_t *obj_table = init_ctx->p_table[table_idx];
     psa_status_t err;
 
-    /* Init associated data with NVC 1 */
-    assoc_data.nv_counter = init_ctx->nvc_1;
-    (void)memcpy(assoc_data.obj_table_data,
-                 PS_CRYPTO_ASSOCIATED_DATA(crypto),
-                 PS_OBJ_TABLE_AUTH_DATA_SIZE);
-
-    err = ps_crypto_authenticate(crypto, (const uint8_t *)&assoc_data,
-                                 PS_CRYPTO_ASSOCIATED_DATA_LEN);
+    /* Check with NVC 1 */
+    err = ps_object_table_nvc_check(obj_table, init_ctx->nvc_1);
     if (err == PSA_SUCCESS) {
         init_ctx->table_state[table_idx] = PS_OBJ_TABLE_NVC_1_VALID;
         return;
     }
 
-    if (init_ctx->nvc_3 == PS_INVALID_NVC_VALUE) {
+    /* When NVC 3 has the value of NVC 1, checking with it is the same check */
+    if ((init_ctx->nvc_3 == PS_INVALID_NVC_VALUE)
+        || (init_ctx->nvc_3 == init_ctx->nvc_1)) {
         init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
         return;
     }
 
     /* Check with NVC 3 */
-    assoc_data.nv_counter = init_ctx->nvc_3;
-
-    err = ps_crypto_authenticate(crypto, (const uint8_t *)&assoc_data,
-                                 PS_CRYPTO_ASSOCIATED_DATA_LEN);
+    err = ps_object_table_nvc_check(obj_table, init_ctx->nvc_3);
     if (err != PSA_SUCCESS) {
         init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
     } else {
@@ -403,6 +660,109 @@ static void ps_object_table_authenticate(uint8_t table_idx,
     }
 }
 
+#else /* PS_ROLLBACK_PROTECTION */
+
+/**
+ * \brief Generates table authentication
+ *
+ * \param[in,out] obj_table  Pointer to the object table to generate
+ *                           authentication
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+__attribute__ ((always_inline))
+__STATIC_INLINE psa_status_t ps_object_table_generate_auth_tag(
+                                              struct ps_obj_table_t *obj_table)
+{
+    union ps_crypto_t *crypto = &obj_table->crypto;
+    psa_status_t err;
+
+    /* Get new IV */
+    err = ps_crypto_get_iv(crypto);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return ps_crypto_generate_auth_tag(crypto,
+                                       PS_CRYPTO_ASSOCIATED_DATA(crypto),
+                                       PS_CRYPTO_ASSOCIATED_DATA_LEN);
+}
+
+/**
+ * \brief Authenticates table of objects.
+ *
+ * \param[in]     table_idx  Table index in the init context
+ * \param[in,out] init_ctx   Pointer to the object table to authenticate
+ *
+ */
+static void ps_object_table_authenticate(uint8_t table_idx,
+                                       struct ps_obj_table_init_ctx_t *init_ctx)
+{
+    const union ps_crypto_t *crypto = &init_ctx->p_table[table_idx]->crypto;
+    psa_status_t err;
+
+    err = ps_crypto_authenticate(crypto,
+                                 PS_CRYPTO_ASSOCIATED_DATA(crypto),
+                                 PS_CRYPTO_ASSOCIATED_DATA_LEN);
+    if (err != PSA_SUCCESS) {
+        init_ctx->table_state[table_idx] = PS_OBJ_TABLE_INVALID;
+    }
+}
+#endif /* PS_ROLLBACK_PROTECTION */
+
+/* State of a table which no other table can supersede */
+#if PS_ROLLBACK_PROTECTION
+#define PS_OBJ_TABLE_LATEST_STATE PS_OBJ_TABLE_NVC_1_VALID
+#else
+#define PS_OBJ_TABLE_LATEST_STATE PS_OBJ_TABLE_VALID
+#endif
+
+/**
+ * \brief Authenticates the tables of objects which can be the active one.
+ *
+ * \details The table saved last is authenticated first. It is found from the
+ *          IVs of the tables, which are not authenticated yet but only serve
+ *          as a hint: a forged IV makes its table fail the authentication.
+ *          When that table is valid with the latest state, the other one was
+ *          saved earlier and cannot be the active table, so it is not
+ *          authenticated.
+ *
+ * \param[in,out] init_ctx  Pointer to the init object table context
+ *
+ */
+static void ps_object_table_authenticate_tables(
+                                       struct ps_obj_table_init_ctx_t *init_ctx)
+{
+    uint8_t first = PS_OBJ_TABLE_IDX_0;
+    uint8_t second = PS_OBJ_TABLE_IDX_1;
+
+    if ((init_ctx->table_state[PS_OBJ_TABLE_IDX_1] != PS_OBJ_TABLE_INVALID)
+        && ((init_ctx->table_state[PS_OBJ_TABLE_IDX_0] ==
+                                                       PS_OBJ_TABLE_INVALID)
+            || ps_crypto_iv_is_newer(
+                             &init_ctx->p_table[PS_OBJ_TABLE_IDX_1]->crypto,
+                             &init_ctx->p_table[PS_OBJ_TABLE_IDX_0]->crypto))) {
+        first = PS_OBJ_TABLE_IDX_1;
+        second = PS_OBJ_TABLE_IDX_0;
+    }
+
+    if (init_ctx->table_state[first] != PS_OBJ_TABLE_INVALID) {
+        ps_object_table_authenticate(first, init_ctx);
+    }
+
+    if (init_ctx->table_state[second] == PS_OBJ_TABLE_INVALID) {
+        return;
+    }
+
+    if (init_ctx->table_state[first] == PS_OBJ_TABLE_LATEST_STATE) {
+        init_ctx->table_state[second] = PS_OBJ_TABLE_INVALID;
+        return;
+    }
+
+    ps_object_table_authenticate(second, init_ctx);
+}
+
+#if PS_ROLLBACK_PROTECTION
 /**
  * \brief Authenticates tables of objects.
  *
@@ -443,85 +803,121 @@ __STATIC_INLINE psa_status_t ps_object_table_nvc_authenticate(
         init_ctx->nvc_3 = PS_INVALID_NVC_VALUE;
     }
 
-    /* Authenticate table 0 if data is valid */
-    if (init_ctx->table_state[PS_OBJ_TABLE_IDX_0] != PS_OBJ_TABLE_INVALID) {
-        ps_object_table_authenticate(PS_OBJ_TABLE_IDX_0, init_ctx);
-    }
-
-    /* Authenticate table 1 if data is valid */
-    if (init_ctx->table_state[PS_OBJ_TABLE_IDX_1] != PS_OBJ_TABLE_INVALID) {
-        ps_object_table_authenticate(PS_OBJ_TABLE_IDX_1, init_ctx);
-    }
+    ps_object_table_authenticate_tables(init_ctx);
 
     return PSA_SUCCESS;
 }
-#else /* PS_ROLLBACK_PROTECTION */
+#endif /* PS_ROLLBACK_PROTECTION */
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
 /**
- * \brief Generates table authentication
+ * \brief Authenticates the object table journal.
  *
- * \param[in,out] obj_table  Pointer to the object table to generate
- *                           authentication
+ * \details With rollback protection, a journal that authenticates with the
+ *          latest NV counter value is the latest update. In that case the
+ *          object table it is bound to was authenticated with an older NV
+ *          counter value, which is checked here instead.
+ *
+ * \param[in,out] init_ctx  Pointer to the init object table context
  *
- * \return Returns error code as specified in \ref psa_status_t
  */
 __attribute__ ((always_inline))
-__STATIC_INLINE psa_status_t ps_object_table_generate_auth_tag(
-                                              struct ps_obj_table_t *obj_table)
+__STATIC_INLINE void ps_object_table_authenticate_journal(
+                                      struct ps_obj_table_init_ctx_t *init_ctx)
 {
-    union ps_crypto_t *crypto = &obj_table->crypto;
+    struct ps_obj_table_journal_t *p_journal =
+                                          &ps_obj_table_journal_ctx.journal;
     psa_status_t err;
+#if PS_ROLLBACK_PROTECTION
+    uint8_t i;
+#endif
 
-    /* Get new IV */
-    err = ps_crypto_get_iv(crypto);
+    if (init_ctx->journal_state == PS_OBJ_TABLE_INVALID) {
+        return;
+    }
+
+    err = ps_crypto_authenticate(&p_journal->crypto,
+                        PS_CRYPTO_ASSOCIATED_DATA(&p_journal->crypto),
+                        PS_OBJ_TABLE_JOURNAL_SIZE(p_journal->num_records) -
+                        PS_NON_AUTH_OBJ_TABLE_SIZE);
     if (err != PSA_SUCCESS) {
-        return err;
+        init_ctx->journal_state = PS_OBJ_TABLE_INVALID;
+        return;
     }
 
-    return ps_crypto_generate_auth_tag(crypto,
-                                       PS_CRYPTO_ASSOCIATED_DATA(crypto),
-                                       PS_CRYPTO_ASSOCIATED_DATA_LEN);
-}
+#if PS_ROLLBACK_PROTECTION
+    if (p_journal->nv_counter == init_ctx->nvc_1) {
+        init_ctx->journal_state = PS_OBJ_TABLE_NVC_1_VALID;
+    } else if ((init_ctx->nvc_3 != PS_INVALID_NVC_VALUE)
+               && (p_journal->nv_counter == init_ctx->nvc_3)
+               && (init_ctx->table_state[PS_OBJ_TABLE_IDX_0] !=
+                                                    PS_OBJ_TABLE_NVC_1_VALID)
+               && (init_ctx->table_state[PS_OBJ_TABLE_IDX_1] !=
+                                                    PS_OBJ_TABLE_NVC_1_VALID)) {
+        /* Only valid with NVC 3 if no table was saved with NVC 1 since */
+        init_ctx->journal_state = PS_OBJ_TABLE_NVC_3_VALID;
+    } else {
+        /* Stale journal, a table saved later holds its changes */
+        init_ctx->journal_state = PS_OBJ_TABLE_INVALID;
+        return;
+    }
 
-/**
- * \brief Authenticates tables of objects.
- *
- * \param[in,out] init_ctx  Pointer to the object table to authenticate
- *
- */
-__attribute__ ((always_inline))
-__STATIC_INLINE void ps_object_table_authenticate_ctx_tables(
-                                      struct ps_obj_table_init_ctx_t *init_ctx)
-{
-    psa_status_t err;
-    union ps_crypto_t *crypto =
-                                &init_ctx->p_table[PS_OBJ_TABLE_IDX_0]->crypto;
-
-    /* Authenticate table 0 if data is valid */
-    if (init_ctx->table_state[PS_OBJ_TABLE_IDX_0] != PS_OBJ_TABLE_INVALID) {
-        err = ps_crypto_authenticate(crypto,
-                                     PS_CRYPTO_ASSOCIATED_DATA(crypto),
-                                     PS_CRYPTO_ASSOCIATED_DATA_LEN);
-        if (err != PSA_SUCCESS) {
-            init_ctx->table_state[PS_OBJ_TABLE_IDX_0] = PS_OBJ_TABLE_INVALID;
+#if PS_NVC_BATCHED
+    for (i = 0; i < PS_NUM_OBJ_TABLES; i++) {
+        if ((init_ctx->table_state[i] == init_ctx->journal_state)
+            && (init_ctx->p_table[i]->nvc_sub > p_journal->nvc_sub)) {
+            /* A table was saved later in the same batch */
+            init_ctx->journal_state = PS_OBJ_TABLE_INVALID;
+            return;
         }
     }
+#endif /* PS_NVC_BATCHED */
 
-    /* Authenticate table 1 if data is valid */
-    if (init_ctx->table_state[PS_OBJ_TABLE_IDX_1] != PS_OBJ_TABLE_INVALID) {
-        crypto = &init_ctx->p_table[PS_OBJ_TABLE_IDX_1]->crypto;
+    /* The journal is the latest update, so only the table it is bound to is
+     * valid. It is marked as valid with NVC 1 to be set as the active one.
+     */
+    for (i = 0; i < PS_NUM_OBJ_TABLES; i++) {
+        /* Only the table with the base tag needs to be authenticated */
+        init_ctx->table_state[i] = PS_OBJ_TABLE_INVALID;
+        if (memcmp(init_ctx->p_table[i]->crypto.ref.tag,
+                   p_journal->base_tag, PS_TAG_LEN_BYTES) != 0) {
+            continue;
+        }
 
-        err = ps_crypto_authenticate(crypto,
-                                     PS_CRYPTO_ASSOCIATED_DATA(crypto),
-                                     PS_CRYPTO_ASSOCIATED_DATA_LEN);
-        if (err != PSA_SUCCESS) {
-            init_ctx->table_state[PS_OBJ_TABLE_IDX_1] = PS_OBJ_TABLE_INVALID;
+        err = ps_object_table_nvc_check(init_ctx->p_table[i],
+                                        p_journal->base_nvc);
+        if (err == PSA_SUCCESS) {
+            init_ctx->table_state[i] = PS_OBJ_TABLE_NVC_1_VALID;
         }
     }
-}
 #endif /* PS_ROLLBACK_PROTECTION */
+}
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
 #endif /* PS_ENCRYPTION */
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+/**
+ * \brief Empties the object table journal and binds it to the given table.
+ *
+ * \param[in] obj_table  Pointer to the object table the journal applies to
+ *
+ */
+static void ps_object_table_journal_reset(
+                                        const struct ps_obj_table_t *obj_table)
+{
+    struct ps_obj_table_journal_t *p_journal =
+                                          &ps_obj_table_journal_ctx.journal;
+
+    p_journal->num_records = 0;
+#ifdef PS_ENCRYPTION
+    (void)memcpy(p_journal->base_tag, obj_table->crypto.ref.tag,
+                 PS_TAG_LEN_BYTES);
+#else
+    p_journal->base_swap_count = obj_table->swap_count;
+#endif
+}
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+
 /**
  * \brief Saves object table in the persistent memory.
  *
@@ -536,16 +932,16 @@ static psa_status_t ps_object_table_save_table(
 
 #if PS_ROLLBACK_PROTECTION
     uint32_t nvc_1 = 0;
+    uint32_t nvc_sub = 0;
 
-    err = ps_increment_nv_counter(TFM_PS_NV_COUNTER_1);
+    err = ps_object_table_get_save_nvc(&nvc_1, &nvc_sub);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
-    err = ps_read_nv_counter(TFM_PS_NV_COUNTER_1, &nvc_1);
-    if (err != PSA_SUCCESS) {
-        return err;
-    }
+#if PS_NVC_BATCHED
+    obj_table->nvc_sub = nvc_sub;
+#endif
 #else
     obj_table->swap_count++;
 
@@ -590,6 +986,23 @@ static psa_status_t ps_object_table_save_table(
 
     err = ps_object_table_fs_write_table(obj_table);
 
+#if PS_NVC_BATCHED
+    if (err == PSA_SUCCESS) {
+        ps_obj_table_ctx.nvc_sub = nvc_sub;
+    }
+#endif
+
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    if (err == PSA_SUCCESS) {
+        /* The new table holds all the journaled changes */
+        ps_object_table_journal_reset(obj_table);
+#if PS_ROLLBACK_PROTECTION
+        ps_obj_table_journal_ctx.journal.base_nvc = nvc_1;
+#endif
+        ps_obj_table_journal_ctx.table_saved = true;
+    }
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+
 #if PS_ROLLBACK_PROTECTION
     if (err != PSA_SUCCESS) {
         return err;
@@ -602,6 +1015,203 @@ static psa_status_t ps_object_table_save_table(
     return err;
 }
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+/**
+ * \brief Writes the object table journal in persistent memory.
+ *
+ * \param[in,out] p_journal  Pointer to the journal to authenticate and write
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+__attribute__ ((always_inline))
+__STATIC_INLINE psa_status_t ps_object_table_fs_write_journal(
+                                       struct ps_obj_table_journal_t *p_journal)
+{
+    size_t journal_size = PS_OBJ_TABLE_JOURNAL_SIZE(p_journal->num_records);
+#ifdef PS_ENCRYPTION
+    psa_status_t err;
+
+    /* Set object table key */
+    err = ps_crypto_setkey(ps_table_key_label, sizeof(ps_table_key_label));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* Get new IV */
+    err = ps_crypto_get_iv(&p_journal->crypto);
+    if (err == PSA_SUCCESS) {
+        err = ps_crypto_generate_auth_tag(&p_journal->crypto,
+                            PS_CRYPTO_ASSOCIATED_DATA(&p_journal->crypto),
+                            journal_size - PS_NON_AUTH_OBJ_TABLE_SIZE);
+    }
+
+    if (err != PSA_SUCCESS) {
+        (void)ps_crypto_destroykey();
+        return err;
+    }
+
+    err = ps_crypto_destroykey();
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif /* PS_ENCRYPTION */
+
+    return psa_its_set(PS_OBJ_TABLE_JOURNAL_FS_ID,
+                       journal_size,
+                       (const void *)p_journal,
+                       PSA_STORAGE_FLAG_NONE);
+}
+
+/**
+ * \brief Saves the given entries of the object table as new records of the
+ *        journal.
+ *
+ * \param[in] obj_table  Pointer to the object table holding the entries
+ * \param[in] idx        Indexes of the changed entries
+ * \param[in] num_idx    Number of changed entries
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_save_journal(
+                                        const struct ps_obj_table_t *obj_table,
+                                        const uint32_t *idx,
+                                        uint32_t num_idx)
+{
+    struct ps_obj_table_journal_t *p_journal =
+                                          &ps_obj_table_journal_ctx.journal;
+    uint32_t num_records = p_journal->num_records;
+    uint32_t i;
+    psa_status_t err;
+
+#if PS_ROLLBACK_PROTECTION
+    uint32_t nvc_1 = 0;
+    uint32_t nvc_sub = 0;
+
+    err = ps_object_table_get_save_nvc(&nvc_1, &nvc_sub);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    p_journal->nv_counter = nvc_1;
+#if PS_NVC_BATCHED
+    p_journal->nvc_sub = nvc_sub;
+#endif
+#endif /* PS_ROLLBACK_PROTECTION */
+
+    for (i = 0; i < num_idx; i++) {
+        p_journal->rec[num_records + i].idx = idx[i];
+        (void)memcpy(&p_journal->rec[num_records + i].entry,
+                     &obj_table->obj_db[idx[i]],
+                     PS_OBJECTS_TABLE_ENTRY_SIZE);
+    }
+    p_journal->num_records = num_records + num_idx;
+
+    err = ps_object_table_fs_write_journal(p_journal);
+    if (err != PSA_SUCCESS) {
+        /* The journal in the file system is unchanged */
+        p_journal->num_records = num_records;
+        return err;
+    }
+
+    ps_obj_table_journal_ctx.table_saved = false;
+
+#if PS_NVC_BATCHED
+    ps_obj_table_ctx.nvc_sub = nvc_sub;
+#endif
+
+#if PS_ROLLBACK_PROTECTION
+    /* Align PS NV counters to have the same value */
+    err = ps_object_table_align_nv_counters(nvc_1);
+#endif /* PS_ROLLBACK_PROTECTION */
+
+    return err;
+}
+
+/**
+ * \brief Applies the object table journal to the active table, if it is
+ *        bound to it. Otherwise, the journal is stale and it is removed.
+ *
+ * \param[in] init_ctx  Pointer to the init object table context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_load_journal(
+                                const struct ps_obj_table_init_ctx_t *init_ctx)
+{
+    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    struct ps_obj_table_journal_t *p_journal =
+                                          &ps_obj_table_journal_ctx.journal;
+    psa_status_t err;
+    uint32_t i;
+
+    if ((init_ctx->journal_state != PS_OBJ_TABLE_INVALID)
+#ifdef PS_ENCRYPTION
+        && (memcmp(p_journal->base_tag, p_table->crypto.ref.tag,
+                   PS_TAG_LEN_BYTES) == 0)
+#else
+        && (p_journal->base_swap_count == p_table->swap_count)
+#endif
+        ) {
+        /* Replay the changes made since the table was saved */
+        for (i = 0; i < p_journal->num_records; i++) {
+            (void)memcpy(&p_table->obj_db[p_journal->rec[i].idx],
+                         &p_journal->rec[i].entry,
+                         PS_OBJECTS_TABLE_ENTRY_SIZE);
+        }
+
+        return PSA_SUCCESS;
+    }
+
+    ps_object_table_journal_reset(p_table);
+#if PS_ROLLBACK_PROTECTION
+    if (init_ctx->table_state[ps_obj_table_ctx.active_table] ==
+                                                    PS_OBJ_TABLE_NVC_3_VALID) {
+        p_journal->base_nvc = init_ctx->nvc_3;
+    } else {
+        p_journal->base_nvc = init_ctx->nvc_1;
+    }
+#endif /* PS_ROLLBACK_PROTECTION */
+
+    err = psa_its_remove(PS_OBJ_TABLE_JOURNAL_FS_ID);
+    if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+
+/**
+ * \brief Saves the changed entries of the object table in the persistent
+ *        memory.
+ *
+ * \param[in,out] obj_table  Pointer to the object table to save
+ * \param[in]     idx        Indexes of the changed entries
+ * \param[in]     num_idx    Number of changed entries
+ *
+ * \note The changes are journaled while the journal has room for them.
+ *       Otherwise, the whole table is saved.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_table_save_changes(
+                                              struct ps_obj_table_t *obj_table,
+                                              const uint32_t *idx,
+                                              uint32_t num_idx)
+{
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    if (ps_obj_table_journal_ctx.journal.num_records + num_idx <=
+                                               PS_OBJ_TABLE_JOURNAL_ENTRIES) {
+        return ps_object_table_save_journal(obj_table, idx, num_idx);
+    }
+#else
+    (void)idx;
+    (void)num_idx;
+#endif
+
+    return ps_object_table_save_table(obj_table);
+}
+
 /**
  * \brief Checks the validity of the table version.
  *
@@ -678,11 +1288,24 @@ static psa_status_t ps_set_active_object_table(
     }
 
 #if PS_ROLLBACK_PROTECTION
-    if (init_ctx->table_state[PS_OBJ_TABLE_IDX_1] ==
-                                                    PS_OBJ_TABLE_NVC_1_VALID) {
+    if ((init_ctx->table_state[PS_OBJ_TABLE_IDX_1] ==
+                                                    PS_OBJ_TABLE_NVC_1_VALID)
+        && (init_ctx->table_state[PS_OBJ_TABLE_IDX_0] !=
+                                                    PS_OBJ_TABLE_NVC_1_VALID)) {
         /* Table 0 is invalid, the active one is table 1 */
         ps_obj_table_ctx.active_table  = PS_OBJ_TABLE_IDX_1;
         ps_obj_table_ctx.scratch_table = PS_OBJ_TABLE_IDX_0;
+#if PS_NVC_BATCHED
+    } else if ((init_ctx->table_state[PS_OBJ_TABLE_IDX_0] ==
+                init_ctx->table_state[PS_OBJ_TABLE_IDX_1])
+               && (init_ctx->p_table[PS_OBJ_TABLE_IDX_1]->nvc_sub >
+                   init_ctx->p_table[PS_OBJ_TABLE_IDX_0]->nvc_sub)) {
+        /* Both tables are valid with the same NV counter value, table 1 was
+         * saved later in the batch.
+         */
+        ps_obj_table_ctx.active_table  = PS_OBJ_TABLE_IDX_1;
+        ps_obj_table_ctx.scratch_table = PS_OBJ_TABLE_IDX_0;
+#endif /* PS_NVC_BATCHED */
     } else {
         /* In case both tables are valid or table 0 is valid, table 0 is the
          * valid on as it is already in the PS object table context.
@@ -739,6 +1362,100 @@ static psa_status_t ps_set_active_object_table(
     return PSA_SUCCESS;
 }
 
+/**
+ * \brief Hashes an object UID and client ID into an index bucket.
+ *
+ * \param[in] uid        Object UID
+ * \param[in] client_id  Client UID
+ *
+ * \return Returns the bucket number
+ */
+__STATIC_INLINE uint32_t ps_table_hash(psa_storage_uid_t uid,
+                                       int32_t client_id)
+{
+    uint32_t hash = (uint32_t)uid ^ (uint32_t)(uid >> 32) ^
+                    (uint32_t)client_id;
+
+    /* Mix the bits so that consecutive UIDs spread across the buckets */
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3BU;
+    hash ^= hash >> 16;
+
+    return hash % PS_OBJ_TABLE_NUM_BUCKETS;
+}
+
+/**
+ * \brief Adds a table entry, which must hold a valid UID, to the index.
+ *
+ * \param[in] idx  Entry index to add
+ */
+static void ps_table_index_add(uint32_t idx)
+{
+    struct ps_obj_table_index_t *p_index = &ps_obj_table_index;
+    const struct ps_obj_table_entry_t *p_entry =
+                                    &ps_obj_table_ctx.obj_table.obj_db[idx];
+    uint32_t bucket = ps_table_hash(p_entry->uid, p_entry->client_id);
+
+    p_index->next[idx] = p_index->bucket[bucket];
+    p_index->bucket[bucket] = (uint16_t)idx;
+
+    p_index->free_map[idx / 32] &= ~(1U << (idx % 32));
+    p_index->num_free--;
+}
+
+/**
+ * \brief Removes a table entry from the index. It must be called before the
+ *        entry's UID or client ID is modified.
+ *
+ * \param[in] idx  Entry index to remove
+ */
+static void ps_table_index_remove(uint32_t idx)
+{
+    struct ps_obj_table_index_t *p_index = &ps_obj_table_index;
+    const struct ps_obj_table_entry_t *p_entry =
+                                    &ps_obj_table_ctx.obj_table.obj_db[idx];
+    uint16_t *p_link = &p_index->bucket[ps_table_hash(p_entry->uid,
+                                                      p_entry->client_id)];
+
+    while (*p_link != PS_OBJ_TABLE_IDX_NONE) {
+        if (*p_link == idx) {
+            *p_link = p_index->next[idx];
+            break;
+        }
+        p_link = &p_index->next[*p_link];
+    }
+
+    p_index->free_map[idx / 32] |= (1U << (idx % 32));
+    p_index->num_free++;
+}
+
+/**
+ * \brief Rebuilds the index from the entries of the object table in the
+ *        context.
+ */
+static void ps_table_index_rebuild(void)
+{
+    uint32_t i;
+    struct ps_obj_table_index_t *p_index = &ps_obj_table_index;
+
+    for (i = 0; i < PS_OBJ_TABLE_NUM_BUCKETS; i++) {
+        p_index->bucket[i] = PS_OBJ_TABLE_IDX_NONE;
+    }
+
+    /* Start with every entry free, then index the used ones */
+    (void)memset(p_index->free_map, 0, sizeof(p_index->free_map));
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        p_index->free_map[i / 32] |= (1U << (i % 32));
+    }
+    p_index->num_free = PS_OBJ_TABLE_ENTRIES;
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if (ps_obj_table_ctx.obj_table.obj_db[i].uid != TFM_PS_INVALID_UID) {
+            ps_table_index_add(i);
+        }
+    }
+}
+
 /**
  * \brief Gets table's entry index based on the given object UID and client ID.
  *
@@ -753,10 +1470,16 @@ static psa_status_t ps_get_object_entry_idx(psa_storage_uid_t uid,
                                             int32_t client_id,
                                             uint32_t *idx)
 {
-    uint32_t i;
+    uint16_t i;
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
 
-    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+    if (uid == TFM_PS_INVALID_UID) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    for (i = ps_obj_table_index.bucket[ps_table_hash(uid, client_id)];
+         i != PS_OBJ_TABLE_IDX_NONE;
+         i = ps_obj_table_index.next[i]) {
         if (p_table->obj_db[i].uid == uid
             && p_table->obj_db[i].client_id == client_id) {
             *idx = i;
@@ -786,25 +1509,52 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
                                                uint32_t *idx)
 {
     uint32_t i;
-    uint32_t last_free = 0;
-    struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    uint32_t free_bits;
+    uint32_t bit;
 
     if (idx_num == 0) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    for (i = 0; i < PS_OBJ_TABLE_ENTRIES && idx_num > 0; i++) {
-        if (p_table->obj_db[i].uid == TFM_PS_INVALID_UID) {
-            last_free = i;
-            idx_num--;
+    if (idx_num > ps_obj_table_index.num_free) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    /* Return the idx_num-th free index, counting from the start of the table */
+    for (i = 0; i < PS_OBJ_TABLE_FREE_WORDS; i++) {
+        free_bits = ps_obj_table_index.free_map[i];
+        while (free_bits != 0) {
+            bit = __CLZ(__RBIT(free_bits));
+            if (--idx_num == 0) {
+                *idx = (i * 32) + bit;
+                return PSA_SUCCESS;
+            }
+            free_bits &= free_bits - 1;
         }
     }
 
-    if (idx_num != 0) {
-        return PSA_ERROR_INSUFFICIENT_STORAGE;
-    } else {
-        *idx = last_free;
-        return PSA_SUCCESS;
+    return PSA_ERROR_INSUFFICIENT_STORAGE;
+}
+
+/**
+ * \brief Writes an entry of the table and keeps the index in step
+ *
+ * \param[in] idx      Entry index to write
+ * \param[in] p_entry  New content of the entry
+ */
+static void ps_table_set_entry(uint32_t idx,
+                               const struct ps_obj_table_entry_t *p_entry)
+{
+    struct ps_obj_table_entry_t *p_db = &ps_obj_table_ctx.obj_table.obj_db[idx];
+
+    if (p_db->uid != TFM_PS_INVALID_UID) {
+        ps_table_index_remove(idx);
+    }
+
+    (void)memcpy(p_db, p_entry, PS_OBJECTS_TABLE_ENTRY_SIZE);
+
+    if (p_db->uid != TFM_PS_INVALID_UID) {
+        ps_table_index_add(idx);
     }
 }
 
@@ -816,6 +1566,10 @@ __STATIC_INLINE psa_status_t ps_table_free_idx(uint32_t idx_num,
  */
 static void ps_table_delete_entry(uint32_t idx)
 {
+    if (ps_obj_table_ctx.obj_table.obj_db[idx].uid != TFM_PS_INVALID_UID) {
+        ps_table_index_remove(idx);
+    }
+
     /* Initialise object table entry structure */
     (void)memset(&ps_obj_table_ctx.obj_table.obj_db[idx],
                  PS_DEFAULT_EMPTY_BUFF_VAL, PS_OBJECTS_TABLE_ENTRY_SIZE);
@@ -837,6 +1591,13 @@ psa_status_t ps_object_table_create(void)
 
     p_table->version = PS_OBJECT_SYSTEM_VERSION;
 
+#if PS_NVC_BATCHED
+    /* Start a new batch with the first save of the new table */
+    ps_obj_table_ctx.nvc_sub = PS_NV_COUNTER_UPDATE_INTERVAL - 1;
+#endif
+
+    ps_table_index_rebuild();
+
     /* Save object table contents */
     return ps_object_table_save_table(p_table);
 }
@@ -858,6 +1619,11 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
     /* Read table from the file system */
     ps_object_table_fs_read_table(&init_ctx);
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    /* Read the changes made since the table was saved */
+    ps_object_table_fs_read_journal(&init_ctx);
+#endif
+
 #ifdef PS_ENCRYPTION
     err = ps_crypto_init();
     if (err != PSA_SUCCESS) {
@@ -878,9 +1644,13 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
         return err;
     }
 #else
-    ps_object_table_authenticate_ctx_tables(&init_ctx);
+    ps_object_table_authenticate_tables(&init_ctx);
 #endif /* PS_ROLLBACK_PROTECTION */
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    ps_object_table_authenticate_journal(&init_ctx);
+#endif
+
     err = ps_crypto_destroykey();
     if (err != PSA_SUCCESS) {
         return err;
@@ -896,6 +1666,25 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
         return err;
     }
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    err = ps_object_table_load_journal(&init_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
+#if PS_NVC_BATCHED
+    /* Continue the batch of the latest save */
+    ps_obj_table_ctx.nvc_sub = ps_obj_table_ctx.obj_table.nvc_sub;
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    if (ps_obj_table_journal_ctx.journal.num_records != 0) {
+        ps_obj_table_ctx.nvc_sub = ps_obj_table_journal_ctx.journal.nvc_sub;
+    }
+#endif
+#endif /* PS_NVC_BATCHED */
+
+    ps_table_index_rebuild();
+
     /* Remove the old object table file */
     err = psa_its_remove(PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table));
     if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
@@ -911,8 +1700,17 @@ psa_status_t ps_object_table_init(uint8_t *obj_data)
 #endif /* PS_ROLLBACK_PROTECTION */
 
 #ifdef PS_ENCRYPTION
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    if (ps_obj_table_journal_ctx.journal.num_records != 0) {
+        /* The journal was saved after the table and has the latest IV */
+        ps_crypto_set_iv(&ps_obj_table_journal_ctx.journal.crypto);
+    } else {
+        ps_crypto_set_iv(&ps_obj_table_ctx.obj_table.crypto);
+    }
+#else
     ps_crypto_set_iv(&ps_obj_table_ctx.obj_table.crypto);
-#endif
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+#endif /* PS_ENCRYPTION */
 
     return PSA_SUCCESS;
 }
@@ -925,6 +1723,22 @@ psa_status_t ps_object_table_obj_exist(psa_storage_uid_t uid,
     return ps_get_object_entry_idx(uid, client_id, &idx);
 }
 
+uint32_t ps_object_table_count_objects(int32_t client_id)
+{
+    const struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
+    uint32_t num_objects = 0;
+    uint32_t i;
+
+    for (i = 0; i < PS_OBJ_TABLE_ENTRIES; i++) {
+        if ((p_table->obj_db[i].uid != TFM_PS_INVALID_UID) &&
+            (p_table->obj_db[i].client_id == client_id)) {
+            num_objects++;
+        }
+    }
+
+    return num_objects;
+}
+
 psa_status_t ps_object_table_get_free_fid(uint32_t fid_num,
                                           uint32_t *p_fid)
 {
@@ -963,6 +1777,8 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
     psa_status_t err;
     uint32_t idx = 0;
     uint32_t backup_idx = 0;
+    uint32_t changed_idx[2];
+    uint32_t num_changed = 0;
     struct ps_obj_table_entry_t backup_entry = {
 #ifdef PS_ENCRYPTION
         .tag = {0U},
@@ -972,6 +1788,7 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
         .uid = TFM_PS_INVALID_UID,
         .client_id = 0,
     };
+    struct ps_obj_table_entry_t new_entry;
     struct ps_obj_table_t *p_table = &ps_obj_table_ctx.obj_table;
 
     err = ps_get_object_entry_idx(uid, client_id, &backup_idx);
@@ -984,29 +1801,32 @@ psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
 
         /* Deletes old object information if it exist in the table */
         ps_table_delete_entry(backup_idx);
+        changed_idx[num_changed++] = backup_idx;
     }
 
     idx = PS_OBJECT_FS_ID_TO_IDX(obj_tbl_info->fid);
-    p_table->obj_db[idx].uid = uid;
-    p_table->obj_db[idx].client_id = client_id;
+    (void)memset(&new_entry, PS_DEFAULT_EMPTY_BUFF_VAL,
+                 PS_OBJECTS_TABLE_ENTRY_SIZE);
+    new_entry.uid = uid;
+    new_entry.client_id = client_id;
 
     /* Add new object information */
 #ifdef PS_ENCRYPTION
-    (void)memcpy(p_table->obj_db[idx].tag, obj_tbl_info->tag,
-                 PS_TAG_LEN_BYTES);
+    (void)memcpy(new_entry.tag, obj_tbl_info->tag, PS_TAG_LEN_BYTES);
 #else
-    p_table->obj_db[idx].version = obj_tbl_info->version;
+    new_entry.version = obj_tbl_info->version;
 #endif
+    ps_table_set_entry(idx, &new_entry);
+    changed_idx[num_changed++] = idx;
 
-    err = ps_object_table_save_table(p_table);
+    err = ps_object_table_save_changes(p_table, changed_idx, num_changed);
     if (err != PSA_SUCCESS) {
+        ps_table_delete_entry(idx);
+
         if (backup_entry.uid != TFM_PS_INVALID_UID) {
             /* Rollback the change in the table */
-            (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
-                         PS_OBJECTS_TABLE_ENTRY_SIZE);
+            ps_table_set_entry(backup_idx, &backup_entry);
         }
-
-        ps_table_delete_entry(idx);
     }
 
     return err;
@@ -1063,11 +1883,10 @@ psa_status_t ps_object_table_delete_object(psa_storage_uid_t uid,
 
     ps_table_delete_entry(backup_idx);
 
-    err = ps_object_table_save_table(p_table);
+    err = ps_object_table_save_changes(p_table, &backup_idx, 1);
     if (err != PSA_SUCCESS) {
        /* Rollback the change in the table */
-       (void)memcpy(&p_table->obj_db[backup_idx], &backup_entry,
-                    PS_OBJECTS_TABLE_ENTRY_SIZE);
+       ps_table_set_entry(backup_idx, &backup_entry);
     }
 
     return err;
@@ -1077,5 +1896,20 @@ psa_status_t ps_object_table_delete_old_table(void)
 {
     uint32_t table_id = PS_TABLE_FS_ID(ps_obj_table_ctx.scratch_table);
 
+#if PS_OBJ_TABLE_JOURNAL_ENTRIES
+    psa_status_t err;
+
+    if (!ps_obj_table_journal_ctx.table_saved) {
+        /* The change was journaled, the old table is still the active one */
+        return PSA_SUCCESS;
+    }
+
+    /* The saved table holds the changes of the journal */
+    err = psa_its_remove(PS_OBJ_TABLE_JOURNAL_FS_ID);
+    if (err != PSA_SUCCESS && err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif /* PS_OBJ_TABLE_JOURNAL_ENTRIES */
+
     return psa_its_remove(table_id);
 }
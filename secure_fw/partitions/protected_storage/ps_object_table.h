@@ -63,6 +63,15 @@ psa_status_t ps_object_table_init(uint8_t *obj_data);
 psa_status_t ps_object_table_obj_exist(psa_storage_uid_t uid,
                                        int32_t client_id);
 
+/**
+ * \brief Counts the objects of a client in the table.
+ *
+ * \param[in] client_id  Identifier of the asset’s owner (client)
+ *
+ * \return Returns the number of table entries owned by the client
+ */
+uint32_t ps_object_table_count_objects(int32_t client_id);
+
 /**
  * \brief Gets a not in use file ID.
  *
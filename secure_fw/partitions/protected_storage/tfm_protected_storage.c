@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -57,6 +57,9 @@ psa_status_t tfm_ps_set(int32_t client_id,
 
     /* Check that the create_flags does not contain any unsupported flags */
     if (create_flags & ~(PSA_STORAGE_FLAG_WRITE_ONCE |
+#if PS_WRITE_COALESCE_NUM
+                         TFM_PS_FLAG_COALESCE_WRITES |
+#endif
                          PSA_STORAGE_FLAG_NO_CONFIDENTIALITY |
                          PSA_STORAGE_FLAG_NO_REPLAY_PROTECTION)) {
         return PSA_ERROR_NOT_SUPPORTED;
@@ -128,3 +131,9 @@ uint32_t tfm_ps_get_support(void)
 
     return 0;
 }
+
+psa_status_t tfm_ps_flush(void)
+{
+    /* Store the writes held by the object system */
+    return ps_object_flush();
+}
@@ -173,6 +173,24 @@ psa_status_t tfm_ps_remove(int32_t client_id, psa_storage_uid_t uid);
  */
 uint32_t tfm_ps_get_support(void);
 
+/**
+ * \brief Stores the asset writes held in RAM in the persistent area.
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ *
+ * \retval PSA_SUCCESS                    The operation completed successfully
+ * \retval PSA_ERROR_STORAGE_FAILURE      The operation failed because the
+ *                                        physical storage has failed (fatal
+ *                                        error)
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE The operation failed because there
+ *                                        was insufficient space on the
+ *                                        storage medium
+ * \retval PSA_ERROR_GENERIC_ERROR        The operation failed because of an
+ *                                        unspecified internal failure
+ */
+psa_status_t tfm_ps_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -20,6 +20,10 @@
 #include "tfm_ps_defs.h"
 
 static const psa_msg_t *p_msg;
+/* The output vectors ps_req_mngr_write_asset_data() fills, in order */
+static size_t out_count;
+static size_t out_idx;
+static size_t out_written;
 
 static psa_status_t tfm_ps_set_req(const psa_msg_t *msg)
 {
@@ -55,6 +59,8 @@ static psa_status_t tfm_ps_get_req(const psa_msg_t *msg)
     uint32_t data_offset;
     size_t num = 0;
     size_t p_data_length;
+    size_t data_size = 0;
+    size_t i;
 
     if (msg->in_size[0] != sizeof(uid) ||
         msg->in_size[1] != sizeof(data_offset)) {
@@ -72,7 +78,20 @@ static psa_status_t tfm_ps_get_req(const psa_msg_t *msg)
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
-    return tfm_ps_get(msg->client_id, uid, data_offset,  msg->out_size[0],
+    /* The data is placed in the output vectors in order, each one being filled
+     * before the next one is used.
+     */
+    out_count = PSA_MAX_IOVEC;
+    while ((out_count > 1) && (msg->out_size[out_count - 1] == 0)) {
+        out_count--;
+    }
+    for (i = 0; i < out_count; i++) {
+        data_size += msg->out_size[i];
+    }
+    out_idx = 0;
+    out_written = 0;
+
+    return tfm_ps_get(msg->client_id, uid, data_offset, data_size,
                       &p_data_length);
 }
 
@@ -152,6 +171,8 @@ psa_status_t tfm_protected_storage_service_sfn(const psa_msg_t *msg)
         return tfm_ps_remove_req(msg);
     case TFM_PS_GET_SUPPORT:
         return tfm_ps_get_support_req(msg);
+    case TFM_PS_FLUSH:
+        return tfm_ps_flush();
     default:
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
@@ -177,5 +198,23 @@ psa_status_t ps_req_mngr_read_asset_data(uint8_t *out_data, uint32_t size)
 
 void ps_req_mngr_write_asset_data(const uint8_t *in_data, uint32_t size)
 {
-    psa_write(p_msg->handle, 0, in_data, size);
+    size_t len;
+
+    while ((size > 0) && (out_idx < out_count)) {
+        len = p_msg->out_size[out_idx] - out_written;
+        if (len > size) {
+            len = size;
+        }
+
+        psa_write(p_msg->handle, out_idx, in_data, len);
+        in_data += len;
+        size -= len;
+        out_written += len;
+
+        /* Move on to the next vector once this one is full */
+        if (out_written == p_msg->out_size[out_idx]) {
+            out_idx++;
+            out_written = 0;
+        }
+    }
 }
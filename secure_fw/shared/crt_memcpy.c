@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,21 +10,58 @@
 void *memcpy(void *dest, const void *src, size_t n)
 {
     union composite_addr_t p_dst, p_src;
+    uint32_t w0, w1, w2, w3;
+    uint32_t offset;
 
     p_dst.uint_addr = (uintptr_t)dest;
     p_src.uint_addr = (uintptr_t)src;
 
-    /* Byte copy for unaligned address. check the last bit of address. */
-    while (n && (ADDR_WORD_UNALIGNED(p_dst.uint_addr) ||
-                 ADDR_WORD_UNALIGNED(p_src.uint_addr))) {
+    /* Byte copy until the destination is word aligned. */
+    while (n && ADDR_WORD_UNALIGNED(p_dst.uint_addr)) {
         *p_dst.p_byte++ = *p_src.p_byte++;
         n--;
     }
 
-    /* Quad byte copy for aligned address. */
-    while (n >= sizeof(uint32_t)) {
-        *(p_dst.p_word)++ = *(p_src.p_word)++;
-        n -= sizeof(uint32_t);
+    offset = ADDR_WORD_UNALIGNED(p_src.uint_addr);
+
+    if (offset == 0) {
+        /* Burst copy for aligned addresses. */
+        while (n >= BURST_SIZE) {
+            w0 = p_src.p_word[0];
+            w1 = p_src.p_word[1];
+            w2 = p_src.p_word[2];
+            w3 = p_src.p_word[3];
+            p_dst.p_word[0] = w0;
+            p_dst.p_word[1] = w1;
+            p_dst.p_word[2] = w2;
+            p_dst.p_word[3] = w3;
+            p_src.p_word += 4;
+            p_dst.p_word += 4;
+            n -= BURST_SIZE;
+        }
+
+        /* Quad byte copy for the remaining words. */
+        while (n >= sizeof(uint32_t)) {
+            *(p_dst.p_word)++ = *(p_src.p_word)++;
+            n -= sizeof(uint32_t);
+        }
+    } else if (n >= sizeof(uint32_t)) {
+        /*
+         * Read the source by aligned words and merge them. The bytes read
+         * around the source are in the same words, so in the same isolation
+         * region.
+         */
+        p_src.uint_addr -= offset;
+        w0 = *(p_src.p_word)++;
+
+        while (n >= sizeof(uint32_t)) {
+            w1 = *(p_src.p_word)++;
+            *(p_dst.p_word)++ = WORD_MERGE(w0, w1, offset);
+            w0 = w1;
+            n -= sizeof(uint32_t);
+        }
+
+        p_src.uint_addr -= sizeof(uint32_t) - offset;
     }
 
     /* Byte copy for the remaining bytes. */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,9 +7,15 @@
 
 #include "build_config_check.h"
 #include "fih.h"
+#include "ffm/fih_bench.h"
 #include "ffm/tfm_boot_data.h"
+#ifdef TFM_BOOT_TIMING
+#include "cycle_counter.h"
+#include "tfm_boot_status.h"
+#endif
 #include "memory_symbols.h"
 #include "spm.h"
+#include "spm_secure_cores.h"
 #include "tfm_hal_isolation.h"
 #include "tfm_hal_platform.h"
 #include "tfm_api.h"
@@ -84,6 +90,9 @@ static fih_int tfm_core_init(void)
 int main(void)
 {
     fih_int fih_rc = FIH_FAILURE;
+#ifdef TFM_BOOT_TIMING
+    uint32_t start_timestamp = cycle_counter_read();
+#endif
 
     /* set Main Stack Pointer limit */
     tfm_arch_set_msplim(SPM_BOOT_STACK_TOP);
@@ -95,12 +104,19 @@ int main(void)
         tfm_core_panic();
     }
 
+#ifdef TFM_BOOT_TIMING
+    /* The shared data can only be written once it has been validated. */
+    tfm_core_add_boot_timestamp(BOOT_TIMING_SPM_START, 0, 0, start_timestamp);
+#endif
+
     /* All isolation should have been set up at this point */
     FIH_LABEL_CRITICAL_POINT();
 
     /* Print the TF-M version */
     SPMLOG_INFMSG("\033[1;34mBooting TF-M "VERSION_FULLSTR"\033[0m\r\n");
 
+    fih_bench_report();
+
     /*
      * Prioritise secure exceptions to avoid NS being able to pre-empt
      * secure SVC or SecureFault. Do it before PSA API initialization.
@@ -120,3 +136,25 @@ int main(void)
 
     return 0;
 }
+
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+void tfm_spm_secondary_core_main(void)
+{
+    fih_int fih_rc = FIH_FAILURE;
+
+    /* The boot stack is private to each core, at the same address */
+    tfm_arch_set_msplim(SPM_BOOT_STACK_TOP);
+
+    /* The SAU and MPU settings are core local */
+    FIH_CALL(tfm_hal_set_up_static_boundaries, fih_rc, &spm_boundary);
+    if (fih_not_eq(fih_rc, fih_int_encode(TFM_HAL_SUCCESS))) {
+        tfm_core_panic();
+    }
+
+    tfm_arch_config_extensions();
+    tfm_arch_set_secure_exception_priorities();
+
+    /* Run the Partitions pinned to this core */
+    tfm_core_handler_mode();
+}
+#endif
@@ -38,34 +38,42 @@ static uint32_t psa_interface_cross_unified_entry(uint32_t a0)
     );
 }
 
-__naked
+/*
+ * The following APIs only read static data, never block and never schedule.
+ * Calls from the same isolation boundary skip the cross call frame, stack
+ * switching and scheduler locking, and call SPM directly on the caller stack.
+ */
 __section(".psa_interface_cross_call")
 uint32_t psa_framework_version_cross(void)
 {
-    __asm volatile(
-#if !defined(__ICCARM__)
-        ".syntax unified                                    \n"
-#endif
-        "push   {r0-r4, lr}                                 \n"
-        "ldr    r0, =tfm_spm_client_psa_framework_version   \n"
-        "mov    r1, sp                                      \n"
-        "b      psa_interface_cross_unified_entry           \n"
-    );
+    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
+        /* PSA APIs must be called from Thread mode */
+        tfm_core_panic();
+    }
+
+    return tfm_spm_client_psa_framework_version();
 }
 
-__naked
 __section(".psa_interface_cross_call")
 uint32_t psa_version_cross(uint32_t sid)
 {
-    __asm volatile(
-#if !defined(__ICCARM__)
-        ".syntax unified                                    \n"
-#endif
-        "push   {r0-r4, lr}                                 \n"
-        "ldr    r0, =tfm_spm_client_psa_version             \n"
-        "mov    r1, sp                                      \n"
-        "b      psa_interface_cross_unified_entry           \n"
-    );
+    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
+        /* PSA APIs must be called from Thread mode */
+        tfm_core_panic();
+    }
+
+    return tfm_spm_client_psa_version(sid);
+}
+
+__section(".psa_interface_cross_call")
+uint32_t psa_rot_lifecycle_state_cross(void)
+{
+    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
+        /* PSA APIs must be called from Thread mode */
+        tfm_core_panic();
+    }
+
+    return tfm_spm_get_lifecycle_state();
 }
 
 __naked
@@ -226,21 +234,6 @@ void psa_panic_cross(void)
     );
 }
 
-__naked
-__section(".psa_interface_cross_call")
-uint32_t psa_rot_lifecycle_state_cross(void)
-{
-    __asm volatile(
-#if !defined(__ICCARM__)
-        ".syntax unified                                    \n"
-#endif
-        "push   {r0-r4, lr}                                 \n"
-        "ldr    r0, =tfm_spm_get_lifecycle_state            \n"
-        "mov    r1, sp                                      \n"
-        "b      psa_interface_cross_unified_entry           \n"
-    );
-}
-
 /* Following PSA APIs are only needed by connection-based services */
 #if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
 
@@ -422,6 +415,40 @@ void psa_unmap_outvec_cross(psa_handle_t msg_handle, uint32_t outvec_idx,
     );
 }
 
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+
+__naked
+__section(".psa_interface_cross_call")
+void *psa_map_shared_outvec_cross(psa_handle_t msg_handle, uint32_t outvec_idx)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =tfm_spm_partition_psa_map_shared_outvec\n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_cross_unified_entry           \n"
+    );
+}
+
+__naked
+__section(".psa_interface_cross_call")
+void *psa_get_shared_outvec_cross(psa_handle_t msg_handle, size_t *len)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =tfm_spm_partition_psa_get_shared_outvec\n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_cross_unified_entry           \n"
+    );
+}
+
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API */
+
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
 
 const struct psa_api_tbl_t psa_api_cross = {
@@ -460,5 +487,9 @@ const struct psa_api_tbl_t psa_api_cross = {
                                 psa_unmap_invec_cross,
                                 psa_map_outvec_cross,
                                 psa_unmap_outvec_cross,
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+                                psa_map_shared_outvec_cross,
+                                psa_get_shared_outvec_cross,
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API */
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
                             };
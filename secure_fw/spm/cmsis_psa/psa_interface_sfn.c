@@ -261,4 +261,26 @@ void psa_unmap_outvec(psa_handle_t msg_handle, uint32_t outvec_idx, size_t len)
     tfm_spm_partition_psa_unmap_outvec(msg_handle, outvec_idx, len);
 }
 
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+void *psa_map_shared_outvec(psa_handle_t msg_handle, uint32_t outvec_idx)
+{
+    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
+        /* PSA APIs must be called from Thread mode */
+        tfm_core_panic();
+    }
+
+    return tfm_spm_partition_psa_map_shared_outvec(msg_handle, outvec_idx);
+}
+
+void *psa_get_shared_outvec(psa_handle_t msg_handle, size_t *len)
+{
+    if (__get_active_exc_num() != EXC_NUM_THREAD_MODE) {
+        /* PSA APIs must be called from Thread mode */
+        tfm_core_panic();
+    }
+
+    return tfm_spm_partition_psa_get_shared_outvec(msg_handle, len);
+}
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API */
+
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
@@ -10,6 +10,7 @@
 #include <limits.h>
 #include <stdint.h>
 #include "config_impl.h"
+#include "critical_section.h"
 #include "lists.h"
 #include "memory_symbols.h"
 #include "region_defs.h"
@@ -129,10 +130,21 @@ uint32_t load_services_assuredly(struct partition_t *p_partition,
      * The loop won't go in the NULL case.
      */
     services = tfm_allocate_service_assuredly(p_ptldinf->nservices);
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    p_partition->p_services = services;
+#endif
     for (i = 0; i < p_ptldinf->nservices && services; i++) {
         services[i].p_ldinf = &p_servldinf[i];
         services[i].partition = p_partition;
         services[i].next = NULL;
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+        services[i].p_msgq_head = NULL;
+        services[i].p_msgq_tail = NULL;
+#endif
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+        services[i].msgq_depth = 0;
+        spm_memset(&services[i].stat, 0, sizeof(services[i].stat));
+#endif
 
         BACKEND_SERVICE_SET(service_setting, &p_servldinf[i]);
 
@@ -182,6 +194,14 @@ void load_irqs_assuredly(struct partition_t *p_partition)
             tfm_core_panic();
         }
 
+#if CONFIG_TFM_CRITICAL_SECTION_BASEPRI != 0
+        /* The handler reaches the SPM state, the critical sections mask it */
+        if (!CRITICAL_SECTION_MASKS_PRIORITY(
+                            NVIC_GetPriority((IRQn_Type)p_irq_info->source))) {
+            tfm_core_panic();
+        }
+#endif
+
         if ((p_ldinf->psa_ff_ver & PARTITION_INFO_VERSION_MASK) == 0x0100) {
             tfm_hal_irq_enable(p_irq_info->source);
         } else if ((p_ldinf->psa_ff_ver & PARTITION_INFO_VERSION_MASK)
@@ -21,6 +21,10 @@
 #include "psa/service.h"
 #include "load/partition_defs.h"
 #include "load/interrupt_defs.h"
+#include "tfm_service_stats.h"
+#if CONFIG_TFM_SPM_TIMER == 1
+#include "ffm/spm_timer.h"
+#endif
 
 #define TFM_HANDLE_STATUS_IDLE          0 /* Handle created             */
 #define TFM_HANDLE_STATUS_ACTIVE        1 /* Handle in use              */
@@ -75,6 +79,12 @@ struct connection_t {
                                          */
     struct partition_t *p_client;       /* Caller partition               */
     struct service_t *service;          /* RoT service pointer            */
+    uint16_t slot_idx;                  /* Index of the slot in the pool  */
+    uint32_t generation;                /*
+                                         * Incremented at allocation and
+                                         * free. Kept across them to detect
+                                         * stale user handles
+                                         */
     psa_msg_t msg;                      /* PSA message body               */
     psa_invec invec[PSA_MAX_IOVEC];     /* Put in/out vectors in msg body */
     psa_outvec outvec[PSA_MAX_IOVEC];
@@ -91,10 +101,20 @@ struct connection_t {
 #endif
 #if PSA_FRAMEWORK_HAS_MM_IOVEC
     uint32_t iovec_status;              /* MM-IOVEC status                */
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+    void *shared_base;                  /*
+                                         * Client buffer kept mapped for the
+                                         * lifetime of the connection
+                                         */
+    size_t shared_len;
+#endif
 #endif
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
     struct connection_t *p_handles;     /* Handle(s) link                 */
 #endif
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+    uint32_t call_start_cycles;         /* Cycle count at psa_call() entry */
+#endif
 };
 
 /* Partition runtime type */
@@ -110,8 +130,19 @@ struct partition_t {
     struct context_ctrl_t              ctx_ctrl;
     struct thread_t                    thrd;            /* IPC model */
     uintptr_t                          reply_value;
+    struct service_t                   *p_services;     /* Owned services */
+#if CONFIG_TFM_SPM_TIMER == 1
+    struct spm_timer_t                 timer;           /* Timed psa_wait */
+#endif
+#if CONFIG_TFM_STACK_GROUP_NUM > 0
+    struct stack_group_t               *p_stack_group;  /* Shared stack */
+    bool                               sfn_inited;      /* Init function run */
+#endif
 #else
     uint32_t                           state;           /* SFN model */
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+    struct connection_t                rtc_connection;  /* Stateless calls */
+#endif
 #endif
     struct connection_t                *p_handles;
     struct partition_t                 *next;
@@ -122,6 +153,14 @@ struct service_t {
     const struct service_load_info_t *p_ldinf;     /* Service load info      */
     struct partition_t *partition;                 /* Owner of the service   */
     struct service_t *next;                        /* For list operation     */
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    struct connection_t *p_msgq_head;              /* Oldest pending message */
+    struct connection_t *p_msgq_tail;              /* Latest pending message */
+#endif
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+    uint32_t msgq_depth;                           /* Pending message number */
+    struct tfm_service_stat_t stat;                /* Usage statistics       */
+#endif
 };
 
 /**
@@ -135,24 +174,42 @@ int32_t tfm_spm_partition_get_running_partition_id(void);
 
 struct connection_t *spm_allocate_connection(void);
 
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+/*
+ * Get the connection embedded in the SFN Partition \p p_pt for a stateless
+ * call. A connection is only allocated from the pool if the embedded one is
+ * still in use, by a call the Partition has not returned from yet.
+ */
+struct connection_t *spm_allocate_rtc_connection(struct partition_t *p_pt);
+#endif
+
 psa_status_t spm_validate_connection(const struct connection_t *p_connection);
 
 /* Panic if invalid connection is given. */
 void spm_free_connection(struct connection_t *p_connection);
 
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+/*
+ * Get the number of connection allocations failed because the connection
+ * pool was exhausted. A non-zero value means CONFIG_TFM_CONN_HANDLE_MAX_NUM
+ * is too small for the system.
+ */
+uint32_t spm_get_connection_exhaustion_count(void);
+#endif
+
 /******************** Partition management functions *************************/
 
 #if CONFIG_TFM_SPM_BACKEND_IPC == 1
 /*
- * Lookup and grab the last spotted handles containing the message
- * by the given signal. Only ONE signal bit can be accepted in 'signal',
- * multiple bits lead to 'no matched handles found to that signal'.
+ * Grab the oldest handle containing the message from the queue of the
+ * service which owns the given signal. Only ONE signal bit can be accepted
+ * in 'signal', multiple bits lead to 'no matched handles found to that
+ * signal'.
  *
  * Returns NULL if no handles matched with the given signal.
  * Returns an internal handle instance if spotted, the instance
- * is moved out of partition handles. Partition available signals
- * also get updated based on the count of handles with given signal
- * still in the partition handles.
+ * is moved out of the service message queue. Partition available signals
+ * also get updated if the service message queue becomes empty.
  */
 struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
                                               psa_signal_t signal);
@@ -182,6 +239,19 @@ struct partition_t *tfm_spm_get_partition_by_id(int32_t partition_id);
  */
 struct service_t *tfm_spm_get_service_by_sid(uint32_t sid);
 
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+/**
+ * \brief                   Get the service context by its index in the SID
+ *                          ordered service table.
+ *
+ * \param[in] index         Index in RANGE[0, SPM_SERVICE_NUM - 1]
+ *
+ * \retval NULL             Index out of range
+ * \retval "Not NULL"       Target service context pointer
+ */
+struct service_t *tfm_spm_get_service_by_index(uint32_t index);
+#endif
+
 /************************ Message functions **********************************/
 
 #if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
@@ -27,6 +27,9 @@
 #include "tfm_hal_interrupt.h"
 #include "tfm_hal_isolation.h"
 #include "spm.h"
+#include "spm_secure_cores.h"
+#include "spm_pid_tbl.h"
+#include "spm_sid_tbl.h"
 #include "tfm_peripherals_def.h"
 #include "tfm_nspm.h"
 #include "tfm_rpc.h"
@@ -36,6 +39,12 @@
 #include "region.h"
 #include "psa_manifest/pid.h"
 #include "ffm/backend.h"
+#include "cycle_counter.h"
+#include "ffm/spm_trace.h"
+#ifdef TFM_BOOT_TIMING
+#include "ffm/tfm_boot_data.h"
+#include "tfm_boot_status.h"
+#endif
 #include "load/partition_defs.h"
 #include "load/service_defs.h"
 #include "load/asset_defs.h"
@@ -50,87 +59,119 @@
 static struct service_head_t services_listhead;
 struct service_t *stateless_services_ref_tbl[STATIC_HANDLE_NUM_LIMIT];
 
+#if SPM_SERVICE_NUM > 0
+/* Generated SIDs in ascending order, and the services in the same order. */
+static const uint32_t sorted_sids[SPM_SERVICE_NUM] = {
+    SPM_SORTED_SID_LIST
+};
+/* Index of the SID of each perfect hash slot */
+static const uint16_t sid_hash_index[SPM_SID_HASH_SLOT_NUM] = {
+    SPM_SID_HASH_INDEX_LIST
+};
+static struct service_t *sorted_services_tbl[SPM_SERVICE_NUM];
+#endif
+
+#if CONFIG_TFM_DOORBELL_API == 1
+/* Generated PIDs in ascending order, and the partitions in the same order. */
+static const int32_t sorted_pids[SPM_PARTITION_NUM] = {
+    SPM_SORTED_PID_LIST
+};
+/* Index of the PID of each perfect hash slot */
+static const uint16_t pid_hash_index[SPM_PID_HASH_SLOT_NUM] = {
+    SPM_PID_HASH_INDEX_LIST
+};
+static struct partition_t *sorted_partitions_tbl[SPM_PARTITION_NUM];
+#endif /* CONFIG_TFM_DOORBELL_API == 1 */
+
 /* Pools */
 TFM_POOL_DECLARE(connection_pool, sizeof(struct connection_t),
                  CONFIG_TFM_CONN_HANDLE_MAX_NUM);
 
 /*********************** Connection handle conversion APIs *******************/
 
-#define CONVERSION_FACTOR_BITOFFSET    3
-#define CONVERSION_FACTOR_VALUE        (1 << CONVERSION_FACTOR_BITOFFSET)
-/* Set 32 as the maximum */
-#define CONVERSION_FACTOR_VALUE_MAX    0x20
-
-#if CONVERSION_FACTOR_VALUE > CONVERSION_FACTOR_VALUE_MAX
-#error "CONVERSION FACTOR OUT OF RANGE"
-#endif
-
-static uint32_t loop_index;
-
 /*
- * A handle instance psa_handle_t allocated inside SPM is actually a memory
- * address among the handle pool. Return this handle to the client directly
- * exposes information of secure memory address. In this case, converting the
- * handle into another value does not represent the memory address to avoid
- * exposing secure memory directly to clients.
- *
- * This function converts the handle instance into another value by scaling the
- * handle in pool offset, the converted value is named as a user handle.
+ * A user handle encodes the index of the connection slot in the pool and the
+ * generation of that slot, rather than the connection address. The generation
+ * is incremented at both allocation and free, so it is odd while the slot is
+ * in use, and a handle kept after its connection is freed no longer matches.
  *
  * The formula:
- *  handle =      (p_connection - POOL_START) * CONVERSION_FACTOR_VALUE +
- *                CLIENT_HANDLE_VALUE_MIN + loop_index
+ *  handle =      ((generation << HANDLE_INDEX_BITS) | index) +
+ *                CLIENT_HANDLE_VALUE_MIN
  * where:
- *  CONVERSION_FACTOR_VALUE = 1 << CONVERSION_FACTOR_BITOFFSET, and should not
- *  exceed CONVERSION_FACTOR_VALUE_MAX.
- *
- *  p_connection    in RANGE[POOL_START, POOL_END]
+ *  index           in RANGE[0, CONFIG_TFM_CONN_HANDLE_MAX_NUM - 1]
+ *  generation      in RANGE[0, HANDLE_GEN_MASK]
  *  handle          in RANGE[CLIENT_HANDLE_VALUE_MIN, 0x3FFFFFFF]
- *  loop_index      in RANGE[0, CONVERSION_FACTOR_VALUE - 1]
- *
- *  note:
- *  loop_index is used to promise same handle instance is converted into
- *  different user handles in short time.
  */
-psa_handle_t connection_to_handle(struct connection_t *p_connection)
-{
-    psa_handle_t handle;
+#define HANDLE_INDEX_BITS               10
+#define HANDLE_INDEX_MASK               ((1UL << HANDLE_INDEX_BITS) - 1)
+#define HANDLE_GEN_MASK                 ((1UL << (29 - HANDLE_INDEX_BITS)) - 1)
 
-    loop_index = (loop_index + 1) % CONVERSION_FACTOR_VALUE;
-    handle = (psa_handle_t)((((uintptr_t)p_connection -
-                  (uintptr_t)connection_pool) << CONVERSION_FACTOR_BITOFFSET) +
-                  CLIENT_HANDLE_VALUE_MIN + loop_index);
+#if CONFIG_TFM_CONN_HANDLE_MAX_NUM > (1 << HANDLE_INDEX_BITS)
+#error "CONFIG_TFM_CONN_HANDLE_MAX_NUM exceeds the handle index range."
+#endif
+
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+/* The last index marks the connections embedded in the SFN Partitions */
+#define RTC_CONNECTION_IDX              HANDLE_INDEX_MASK
+
+#if CONFIG_TFM_CONN_HANDLE_MAX_NUM > RTC_CONNECTION_IDX
+#error "CONFIG_TFM_CONN_HANDLE_MAX_NUM overlaps the embedded connection index."
+#endif
+#endif
 
-    return handle;
+/* Stride of the connection slots in the pool */
+#define CONNECTION_SLOT_SIZE            (sizeof(struct tfm_pool_chunk_t) + \
+                                         sizeof(struct connection_t))
+
+#define CONNECTION_IN_SLOT(idx)                                             \
+    ((struct connection_t *)(connection_pool->chunks +                      \
+                             (idx) * CONNECTION_SLOT_SIZE +                 \
+                             sizeof(struct tfm_pool_chunk_t)))
+
+psa_handle_t connection_to_handle(struct connection_t *p_connection)
+{
+    return (psa_handle_t)((((p_connection->generation & HANDLE_GEN_MASK) <<
+                            HANDLE_INDEX_BITS) | p_connection->slot_idx) +
+                          CLIENT_HANDLE_VALUE_MIN);
 }
 
 /*
  * This function converts a user handle into a corresponded handle instance.
- * The converted value is validated before returning, an invalid handle instance
- * is returned as NULL.
- *
- * The formula:
- *  p_connection =    ((handle - CLIENT_HANDLE_VALUE_MIN) /
- *                    CONVERSION_FACTOR_VALUE) + POOL_START
- * where:
- *  CONVERSION_FACTOR_VALUE = 1 << CONVERSION_FACTOR_BITOFFSET, and should not
- *  exceed CONVERSION_FACTOR_VALUE_MAX.
- *
- *  p_connection    in RANGE[POOL_START, POOL_END]
- *  handle          in RANGE[CLIENT_HANDLE_VALUE_MIN, 0x3FFFFFFF]
- *  loop_index      in RANGE[0, CONVERSION_FACTOR_VALUE - 1]
+ * A handle out of the pool range, or with a stale generation, is returned as
+ * NULL.
  */
 struct connection_t *handle_to_connection(psa_handle_t handle)
 {
     struct connection_t *p_connection;
+    uint32_t value = (uint32_t)handle - CLIENT_HANDLE_VALUE_MIN;
+    uint32_t idx = value & HANDLE_INDEX_MASK;
 
     if (handle == PSA_NULL_HANDLE) {
         return NULL;
     }
 
-    p_connection = (struct connection_t *)((((uintptr_t)handle -
-                    CLIENT_HANDLE_VALUE_MIN) >> CONVERSION_FACTOR_BITOFFSET) +
-                    (uintptr_t)connection_pool);
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+    if (idx == RTC_CONNECTION_IDX) {
+        /* Only the running Partition can refer to its embedded connection */
+        p_connection = &GET_CURRENT_COMPONENT()->rtc_connection;
+    } else if (idx < CONFIG_TFM_CONN_HANDLE_MAX_NUM) {
+        p_connection = CONNECTION_IN_SLOT(idx);
+    } else {
+        return NULL;
+    }
+#else
+    if (idx >= CONFIG_TFM_CONN_HANDLE_MAX_NUM) {
+        return NULL;
+    }
+
+    p_connection = CONNECTION_IN_SLOT(idx);
+#endif
+
+    if ((p_connection->generation & HANDLE_GEN_MASK) !=
+        (value >> HANDLE_INDEX_BITS)) {
+        return NULL;
+    }
 
     return p_connection;
 }
@@ -146,18 +187,81 @@ struct connection_t *spm_allocate_connection(void)
         return NULL;
     }
 
-    spm_memset(p_handle, 0, sizeof(*p_handle));
+    /* The slot is owned exclusively now, an odd generation marks it in use. */
+    p_handle->generation++;
+
+    /*
+     * Only clear the fields which can be read before they are written. The
+     * message body is cleared by spm_fill_message(), the vectors and the
+     * caller outvec are set by psa_call(), the caller data is set for NSPE
+     * clients and the message queue link when the message is queued.
+     */
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+    p_handle->rhandle = NULL;
+#endif
+    p_handle->p_client = NULL;
+    p_handle->service = NULL;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC
+    p_handle->iovec_status = 0;
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+    p_handle->shared_base = NULL;
+    p_handle->shared_len = 0;
+#endif
+#endif
 
     p_handle->status = TFM_HANDLE_STATUS_IDLE;
 
     return p_handle;
 }
 
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+struct connection_t *spm_allocate_rtc_connection(struct partition_t *p_pt)
+{
+    struct connection_t *p_handle = &p_pt->rtc_connection;
+
+    /* The generation is odd while the connection is in use */
+    if (p_handle->generation & 1U) {
+        return spm_allocate_connection();
+    }
+
+    p_handle->generation++;
+    p_handle->slot_idx = RTC_CONNECTION_IDX;
+
+    /*
+     * The message body and the vectors are filled by psa_call(), only clear
+     * the fields it does not set.
+     */
+    p_handle->p_client = NULL;
+    p_handle->service = NULL;
+#if PSA_FRAMEWORK_HAS_MM_IOVEC
+    p_handle->iovec_status = 0;
+#endif
+
+    p_handle->status = TFM_HANDLE_STATUS_IDLE;
+
+    return p_handle;
+}
+#endif
+
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+uint32_t spm_get_connection_exhaustion_count(void)
+{
+    struct tfm_pool_stat_t stat;
+
+    /* The pool counts the allocations which found it empty */
+    tfm_pool_get_stat(connection_pool, &stat);
+
+    return stat.alloc_failures;
+}
+#endif
+
 psa_status_t spm_validate_connection(const struct connection_t *handle)
 {
-    /* Check the handle address is valid */
-    if (is_valid_chunk_data_in_pool(connection_pool,
-                                    (uint8_t *)handle) != true) {
+    /*
+     * The handle comes from handle_to_connection(), which has already checked
+     * the slot range and generation. Only a slot in use is valid.
+     */
+    if (!handle || !(handle->generation & 1U)) {
         return SPM_ERROR_GENERIC;
     }
 
@@ -166,14 +270,20 @@ psa_status_t spm_validate_connection(const struct connection_t *handle)
 
 void spm_free_connection(struct connection_t *p_connection)
 {
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
-
     SPM_ASSERT(p_connection != NULL);
 
-    CRITICAL_SECTION_ENTER(cs_assert);
-    /* Back handle buffer to pool */
+    /* Invalidate the user handles still referring to this connection. */
+    p_connection->generation++;
+
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+    /* Embedded connections are not from the pool */
+    if (p_connection->slot_idx == RTC_CONNECTION_IDX) {
+        return;
+    }
+#endif
+
+    /* Back handle buffer to pool, the pool protects itself. */
     tfm_pool_free(connection_pool, p_connection);
-    CRITICAL_SECTION_LEAVE(cs_assert);
 }
 
 /* Partition management functions */
@@ -183,52 +293,151 @@ void spm_free_connection(struct connection_t *p_connection)
 struct connection_t *spm_get_handle_by_signal(struct partition_t *p_ptn,
                                               psa_signal_t signal)
 {
-    struct connection_t *p_handle_iter;
-    struct connection_t **pr_handle_iter, **last_found_handle_holder = NULL;
+    struct connection_t *p_handle = NULL;
+    struct service_t *p_service = NULL;
     struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
-    uint32_t nr_found_msgs = 0;
-
-    CRITICAL_SECTION_ENTER(cs_assert);
+    uint32_t i;
 
-    /* Return the last found message which applies a FIFO mechanism. */
-    UNI_LIST_FOREACH_NODE_PNODE(pr_handle_iter, p_handle_iter,
-                                p_ptn, p_handles) {
-        if (p_handle_iter->service->p_ldinf->signal == signal) {
-            last_found_handle_holder = pr_handle_iter;
-            nr_found_msgs++;
+    /* Find the service owning the signal, the messages are queued there. */
+    for (i = 0; i < p_ptn->p_ldinf->nservices; i++) {
+        if (p_ptn->p_services[i].p_ldinf->signal == signal) {
+            p_service = &p_ptn->p_services[i];
+            break;
         }
     }
 
-    if (last_found_handle_holder) {
-        p_handle_iter = *last_found_handle_holder;
-        UNI_LIST_REMOVE_NODE_BY_PNODE(last_found_handle_holder, p_handles);
+    if (!p_service) {
+        return NULL;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    /* Return the oldest message which applies a FIFO mechanism. */
+    p_handle = p_service->p_msgq_head;
+    if (p_handle) {
+        p_service->p_msgq_head = p_handle->p_handles;
+        p_handle->p_handles = NULL;
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+        p_service->msgq_depth--;
+#endif
 
-        if (nr_found_msgs == 1) {
+        if (!p_service->p_msgq_head) {
+            p_service->p_msgq_tail = NULL;
             p_ptn->signals_asserted &= ~signal;
         }
     }
 
     CRITICAL_SECTION_LEAVE(cs_assert);
 
-    return p_handle_iter;
+    return p_handle;
 }
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 
-struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
+/*
+ * Look up the SID in the generated perfect hash. Returns the index of the
+ * SID, or SPM_SERVICE_NUM if the SID does not exist.
+ */
+static uint32_t sid_to_tbl_index(uint32_t sid)
 {
-    struct service_t *p_prev, *p_curr;
+#if SPM_SERVICE_NUM > 0
+    uint32_t idx = sid_hash_index[(sid * SPM_SID_HASH_MULTIPLIER) >>
+                                  SPM_SID_HASH_SHIFT];
+
+    /* Any SID maps to a slot, only one of them is stored there */
+    if ((idx < SPM_SERVICE_NUM) && (sorted_sids[idx] == sid)) {
+        return idx;
+    }
+#else
+    (void)sid;
+#endif
 
-    UNI_LIST_FOREACH_NODE_PREV(p_prev, p_curr, &services_listhead, next) {
-        if (p_curr->p_ldinf->sid == sid) {
-            UNI_LIST_MOVE_AFTER(&services_listhead, p_prev, p_curr, next);
-            return p_curr;
+    return SPM_SERVICE_NUM;
+}
+
+/* Put all the loaded services into the SID ordered table. */
+static void index_services_assuredly(void)
+{
+    struct service_t *p_serv;
+    uint32_t idx;
+
+    UNI_LIST_FOREACH(p_serv, &services_listhead, next) {
+        idx = sid_to_tbl_index(p_serv->p_ldinf->sid);
+        if (idx >= SPM_SERVICE_NUM) {
+            tfm_core_panic();
         }
+#if SPM_SERVICE_NUM > 0
+        if (sorted_services_tbl[idx]) {
+            tfm_core_panic();
+        }
+        sorted_services_tbl[idx] = p_serv;
+#endif
     }
+}
+
+struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
+{
+#if SPM_SERVICE_NUM > 0
+    uint32_t idx = sid_to_tbl_index(sid);
+
+    if (idx < SPM_SERVICE_NUM) {
+        return sorted_services_tbl[idx];
+    }
+#else
+    (void)sid;
+#endif
+
+    return NULL;
+}
+
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+struct service_t *tfm_spm_get_service_by_index(uint32_t index)
+{
+#if SPM_SERVICE_NUM > 0
+    if (index < SPM_SERVICE_NUM) {
+        return sorted_services_tbl[index];
+    }
+#else
+    (void)index;
+#endif
 
     return NULL;
 }
+#endif
 
 #if CONFIG_TFM_DOORBELL_API == 1
+/*
+ * Look up the PID in the generated perfect hash. Returns the index of the
+ * PID, or SPM_PARTITION_NUM if the PID does not exist.
+ */
+static uint32_t pid_to_tbl_index(int32_t partition_id)
+{
+    uint32_t idx = pid_hash_index[((uint32_t)partition_id *
+                                   SPM_PID_HASH_MULTIPLIER) >>
+                                  SPM_PID_HASH_SHIFT];
+
+    /* Any PID maps to a slot, only one of them is stored there */
+    if ((idx < SPM_PARTITION_NUM) && (sorted_pids[idx] == partition_id)) {
+        return idx;
+    }
+
+    return SPM_PARTITION_NUM;
+}
+
+/* Put all the loaded partitions into the PID ordered table. */
+static void index_partitions_assuredly(void)
+{
+    struct partition_t *p_part;
+    uint32_t idx;
+
+    UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
+        idx = pid_to_tbl_index(p_part->p_ldinf->pid);
+        if ((idx >= SPM_PARTITION_NUM) || sorted_partitions_tbl[idx]) {
+            tfm_core_panic();
+        }
+        sorted_partitions_tbl[idx] = p_part;
+    }
+}
+
 /**
  * \brief                   Get the partition context by partition ID.
  *
@@ -240,12 +449,10 @@ struct service_t *tfm_spm_get_service_by_sid(uint32_t sid)
  */
 struct partition_t *tfm_spm_get_partition_by_id(int32_t partition_id)
 {
-    struct partition_t *p_part;
+    uint32_t idx = pid_to_tbl_index(partition_id);
 
-    UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
-        if (p_part->p_ldinf->pid == partition_id) {
-            return p_part;
-        }
+    if (idx < SPM_PARTITION_NUM) {
+        return sorted_partitions_tbl[idx];
     }
 
     return NULL;
@@ -431,13 +638,32 @@ uint32_t tfm_spm_init(void)
 {
     struct partition_t *partition;
     uint32_t service_setting;
+    uint32_t i;
     fih_int fih_rc = FIH_FAILURE;
+#ifdef TFM_BOOT_TIMING
+    uint8_t load_index = 0;
+
+    tfm_core_add_boot_timestamp(BOOT_TIMING_SPM_INIT, 0, 0,
+                                cycle_counter_read());
+#endif
 
     tfm_pool_init(connection_pool,
                   POOL_BUFFER_SIZE(connection_pool),
                   sizeof(struct connection_t),
                   CONFIG_TFM_CONN_HANDLE_MAX_NUM);
 
+    /* Slot index and generation are kept in the slot across alloc and free. */
+    for (i = 0; i < CONFIG_TFM_CONN_HANDLE_MAX_NUM; i++) {
+        CONNECTION_IN_SLOT(i)->slot_idx = i;
+        CONNECTION_IN_SLOT(i)->generation = 0;
+    }
+
+    spm_trace_init();
+#if (CONFIG_TFM_SPM_SERVICE_STATS == 1) || defined(TFM_BOOT_TIMING) || \
+    ((CONFIG_TFM_IRQ_COALESCE == 1) && (CONFIG_TFM_SPM_TIMER != 1))
+    cycle_counter_enable();
+#endif
+
     UNI_LISI_INIT_NODE(PARTITION_LIST_ADDR, next);
     UNI_LISI_INIT_NODE(&services_listhead, next);
 
@@ -466,8 +692,34 @@ uint32_t tfm_spm_init(void)
         }
 
         backend_init_comp_assuredly(partition, service_setting);
+
+#ifdef TFM_BOOT_TIMING
+        tfm_core_add_boot_timestamp(BOOT_TIMING_SPM_PARTITION_LOAD,
+                                    load_index++,
+                                    (uint32_t)partition->p_ldinf->pid,
+                                    cycle_counter_read());
+#endif
     }
 
+    index_services_assuredly();
+#if CONFIG_TFM_DOORBELL_API == 1
+    index_partitions_assuredly();
+#endif
+
+#if CONFIG_TFM_SPM_TIMER == 1
+    spm_timer_init();
+#endif
+
+#ifdef TFM_BOOT_TIMING
+    tfm_core_add_boot_timestamp(BOOT_TIMING_SPM_INIT_DONE, 0, 0,
+                                cycle_counter_read());
+#endif
+
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+    /* They wait for the SPM lock, held until the first core is scheduled */
+    spm_boot_secondary_cores();
+#endif
+
     return backend_system_run();
 }
 
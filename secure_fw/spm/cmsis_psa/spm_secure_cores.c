@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "config_spm.h"
+#include "critical_section.h"
+#include "spm_secure_cores.h"
+#include "tfm_arch.h"
+#include "tfm_hal_secure_cores.h"
+#include "thread.h"
+#include "utilities.h"
+
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+
+#define SPM_CORE_NONE           (~0U)
+
+/* The core holding the SPM lock, and how many times it took it. */
+static volatile uint32_t lock_owner = SPM_CORE_NONE;
+static uint32_t lock_depth;
+
+void spm_core_lock(void)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t core = tfm_hal_get_secure_core_id();
+
+    /*
+     * Only the core holding the lock writes the owner, so it is read safely
+     * without the lock. The interrupts are masked while waiting, so an
+     * interrupt can not take the lock in between on this core.
+     */
+    CRITICAL_SECTION_ENTER(cs);
+    if (lock_owner != core) {
+        tfm_hal_secure_core_lock();
+        lock_owner = core;
+    }
+    lock_depth++;
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void spm_core_unlock(void)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    SPM_ASSERT(lock_owner == tfm_hal_get_secure_core_id());
+    SPM_ASSERT(lock_depth > 0);
+
+    if (--lock_depth == 0) {
+        lock_owner = SPM_CORE_NONE;
+        tfm_hal_secure_core_unlock();
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void spm_handle_core_notify(void)
+{
+    spm_core_lock();
+
+    if (THRD_EXPECTING_SCHEDULE()) {
+        tfm_arch_trigger_pendsv();
+    }
+
+    spm_core_unlock();
+}
+
+void spm_boot_secondary_cores(void)
+{
+    uint32_t i;
+
+    for (i = 1; i < CONFIG_TFM_SPM_SECURE_CORE_NUM; i++) {
+        tfm_hal_boot_secure_core(i, (uintptr_t)tfm_spm_secondary_core_main);
+    }
+}
+
+#endif /* CONFIG_TFM_SPM_SECURE_CORE_NUM > 1 */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_SECURE_CORES_H__
+#define __SPM_SECURE_CORES_H__
+
+#include <stdint.h>
+#include "config_spm.h"
+
+/*
+ * With more than one secure core, the Partitions pinned to different cores
+ * run in parallel, but the SPM runs on one core at a time. The SPM entries
+ * (SVC, PendSV, interrupts and the secure tick) take the SPM lock. It is
+ * recursive on the core holding it, so the preemption of an SPM entry by
+ * another on the same core behaves as on a single core.
+ */
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+
+void spm_core_lock(void);
+void spm_core_unlock(void);
+
+/*
+ * Schedule the Partitions of the current core woken up by another core. It is
+ * called by the inter-core interrupt handler of the platform.
+ */
+void spm_handle_core_notify(void);
+
+/* Start the secondary secure cores, once the Partitions are initialized. */
+void spm_boot_secondary_cores(void);
+
+/* Entry point of the secondary secure cores, in main.c */
+void tfm_spm_secondary_core_main(void);
+
+#define SPM_CORE_LOCK()         spm_core_lock()
+#define SPM_CORE_UNLOCK()       spm_core_unlock()
+
+#else /* CONFIG_TFM_SPM_SECURE_CORE_NUM > 1 */
+
+#define SPM_CORE_LOCK()
+#define SPM_CORE_UNLOCK()
+
+#endif /* CONFIG_TFM_SPM_SECURE_CORE_NUM > 1 */
+
+#endif /* __SPM_SECURE_CORES_H__ */
@@ -9,6 +9,7 @@
 #include "config_spm.h"
 #include "memory_symbols.h"
 #include "spm.h"
+#include "spm_secure_cores.h"
 #include "svc_num.h"
 #include "tfm_api.h"
 #include "tfm_arch.h"
@@ -16,7 +17,10 @@
 #include "tfm_svcalls.h"
 #include "utilities.h"
 #include "load/spm_load_api.h"
+#include "ffm/backend.h"
 #include "ffm/interrupt.h"
+#include "ffm/service_stats.h"
+#include "ffm/spm_trace.h"
 #include "ffm/tfm_boot_data.h"
 #include "ffm/psa_api.h"
 #include "tfm_hal_isolation.h"
@@ -161,16 +165,53 @@ uint32_t tfm_core_svc_handler(uint32_t *msp, uint32_t exc_return,
         tfm_core_panic();
     }
 
+    SPM_CORE_LOCK();
+
     switch (svc_number) {
     case TFM_SVC_SPM_INIT:
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+        /* The secondary cores run the Partitions initialized by the first */
+        if (SPM_CORE_ID() != 0) {
+            exc_return = backend_system_run();
+        } else {
+            exc_return = tfm_spm_init();
+        }
+#else
         exc_return = tfm_spm_init();
+#endif
         tfm_arch_check_msp_sealing();
+        SPM_CORE_UNLOCK();
         /* The following call does not return */
         tfm_arch_free_msp_and_exc_ret(SPM_BOOT_STACK_BOTTOM, exc_return);
         break;
     case TFM_SVC_GET_BOOT_DATA:
         tfm_core_get_boot_data_handler(svc_args);
         break;
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+    case TFM_SVC_GET_SERVICE_STATS:
+        tfm_core_get_service_stats_handler(svc_args);
+        break;
+#endif
+#if (CONFIG_TFM_FLIH_API == 1) || (CONFIG_TFM_SLIH_API == 1)
+    case TFM_SVC_GET_IRQ_EVENT_COUNT:
+        tfm_core_get_irq_event_count_handler(svc_args);
+        break;
+#endif
+#ifdef CONFIG_TFM_SPM_TRACE
+    case TFM_SVC_TRACE_EVENT:
+        tfm_core_trace_event_handler(svc_args);
+        break;
+#endif
+#if CONFIG_TFM_DOORBELL_API == 1
+    case TFM_SVC_NOTIFY_MULTI:
+        tfm_core_notify_multi_handler(svc_args);
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+        if (THRD_EXPECTING_SCHEDULE()) {
+            tfm_arch_trigger_pendsv();
+        }
+#endif
+        break;
+#endif
 #if (TFM_LVL != 1) && (CONFIG_TFM_FLIH_API == 1)
     case TFM_SVC_PREPARE_DEPRIV_FLIH:
         exc_return = tfm_flih_prepare_depriv_flih(
@@ -211,6 +252,8 @@ uint32_t tfm_core_svc_handler(uint32_t *msp, uint32_t exc_return,
         break;
     }
 
+    SPM_CORE_UNLOCK();
+
     return exc_return;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -88,6 +88,12 @@ void tfm_get_secure_mem_region_attr(const void *p, size_t s,
 void tfm_get_ns_mem_region_attr(const void *p, size_t s,
                                 struct mem_attr_info_t *p_attr);
 
+/**
+ * \brief Build the sorted lookup table of memory regions used by the memory
+ *        check functions above. It is built on first use if not called.
+ */
+void tfm_multi_core_mem_check_init(void);
+
 /**
  * \brief Check whether a memory access is allowed to access to a memory range
  *
@@ -13,10 +13,122 @@
 #include "psa/service.h"
 #include "internal_status_code.h"
 #include "cmsis_compiler.h"
+#include "critical_section.h"
 #include "utilities.h"
 #include "lists.h"
 #include "tfm_pools.h"
 
+/*
+ * The free list is operated with exclusive access instructions if available.
+ * Any exception between the load and the store clears the local exclusive
+ * monitor, so the store fails and the operation retries. Armv6-M does not
+ * support exclusive access, a critical section is used instead.
+ */
+#if defined(__ARM_ARCH_6M__)
+#define POOL_LOCK_FREE                  0
+#else
+#define POOL_LOCK_FREE                  1
+#endif
+
+#define POOL_LINK_ADDR(p)               ((volatile uint32_t *)&(p)->next)
+
+static struct tfm_pool_chunk_t *pool_pop(struct tfm_pool_instance_t *pool)
+{
+    struct tfm_pool_chunk_t *node;
+#if POOL_LOCK_FREE == 1
+
+    do {
+        node = (struct tfm_pool_chunk_t *)__LDREXW(POOL_LINK_ADDR(pool));
+        if (!node) {
+            __CLREX();
+            return NULL;
+        }
+    } while (__STREXW((uint32_t)(uintptr_t)node->next, POOL_LINK_ADDR(pool)));
+#else
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    node = pool->next;
+    if (node) {
+        pool->next = node->next;
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+#endif
+
+    return node;
+}
+
+static void pool_push(struct tfm_pool_instance_t *pool,
+                      struct tfm_pool_chunk_t *node)
+{
+#if POOL_LOCK_FREE == 1
+    do {
+        node->next = (struct tfm_pool_chunk_t *)__LDREXW(POOL_LINK_ADDR(pool));
+    } while (__STREXW((uint32_t)(uintptr_t)node, POOL_LINK_ADDR(pool)));
+#else
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    node->next = pool->next;
+    pool->next = node;
+    CRITICAL_SECTION_LEAVE(cs);
+#endif
+}
+
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+/* Add 'val' to the counter and return the new value. */
+static uint32_t pool_stat_add(volatile uint32_t *counter, uint32_t val)
+{
+    uint32_t new_val;
+#if POOL_LOCK_FREE == 1
+
+    do {
+        new_val = __LDREXW(counter) + val;
+    } while (__STREXW(new_val, counter));
+#else
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    new_val = *counter + val;
+    *counter = new_val;
+    CRITICAL_SECTION_LEAVE(cs);
+#endif
+
+    return new_val;
+}
+
+/* Raise the watermark to 'val' if it is lower. */
+static void pool_stat_raise(volatile uint32_t *watermark, uint32_t val)
+{
+#if POOL_LOCK_FREE == 1
+    do {
+        if (__LDREXW(watermark) >= val) {
+            __CLREX();
+            return;
+        }
+    } while (__STREXW(val, watermark));
+#else
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    if (*watermark < val) {
+        *watermark = val;
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+#endif
+}
+
+void tfm_pool_get_stat(struct tfm_pool_instance_t *pool,
+                       struct tfm_pool_stat_t *stat)
+{
+    if (!pool || !stat) {
+        return;
+    }
+
+    *stat = pool->stat;
+}
+#endif /* CONFIG_TFM_SPM_POOL_STATISTICS == 1 */
+
 psa_status_t tfm_pool_init(struct tfm_pool_instance_t *pool, size_t poolsz,
                            size_t chunksz, size_t num)
 {
@@ -60,14 +172,22 @@ void *tfm_pool_alloc(struct tfm_pool_instance_t *pool)
         return NULL;
     }
 
-    if (UNI_LIST_IS_EMPTY(pool, next)) {
+    node = pool_pop(pool);
+    if (!node) {
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+        pool_stat_add(&pool->stat.alloc_failures, 1);
+#endif
         return NULL;
     }
 
-    node = UNI_LIST_NEXT_NODE(pool, next);
-    UNI_LIST_REMOVE_NODE(pool, node, next);
+    node->next = NULL;
+
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+    pool_stat_raise(&pool->stat.high_watermark,
+                    pool_stat_add(&pool->stat.in_use, 1));
+#endif
 
-    return &(((struct tfm_pool_chunk_t *)node)->data);
+    return &(node->data);
 }
 
 void tfm_pool_free(struct tfm_pool_instance_t *pool, void *ptr)
@@ -76,7 +196,11 @@ void tfm_pool_free(struct tfm_pool_instance_t *pool, void *ptr)
 
     pchunk = TO_CONTAINER(ptr, struct tfm_pool_chunk_t, data);
 
-    UNI_LIST_INSERT_AFTER(pool, pchunk, next);
+    pool_push(pool, pchunk);
+
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+    pool_stat_add(&pool->stat.in_use, (uint32_t)-1);
+#endif
 }
 
 bool is_valid_chunk_data_in_pool(struct tfm_pool_instance_t *pool,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,8 @@
 #define __TFM_POOLS_H__
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "config_spm.h"
 #include "psa/error.h"
 #include "compiler_ext_defs.h"
 #include "lists.h"
@@ -21,10 +23,20 @@ struct tfm_pool_chunk_t {
     uint8_t data[];                       /* Data indicator                 */
 };
 
+/* Pool usage statistics */
+struct tfm_pool_stat_t {
+    uint32_t in_use;                      /* Chunks currently allocated     */
+    uint32_t high_watermark;              /* Maximal chunks ever allocated  */
+    uint32_t alloc_failures;              /* Allocations with pool empty    */
+};
+
 struct tfm_pool_instance_t {
     struct tfm_pool_chunk_t *next;        /* Point to the first free node   */
     size_t chunksz;                       /* Chunks size of pool member     */
     size_t pool_sz;                       /* Pool size in bytes             */
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+    struct tfm_pool_stat_t stat;          /* Usage statistics               */
+#endif
     uint8_t chunks[];                     /* Data indicator                 */
 };
 
@@ -72,6 +84,10 @@ psa_status_t tfm_pool_init(struct tfm_pool_instance_t *pool, size_t poolsz,
  *
  * \retval buffer pointer       Success.
  * \retval NULL                 Failed.
+ *
+ * \note The allocated memory is not cleared. Allocation and free are lock-free
+ *       on architectures with exclusive access instructions, and protected by
+ *       a critical section otherwise. Callers do not need extra protection.
  */
 void *tfm_pool_alloc(struct tfm_pool_instance_t *pool);
 
@@ -97,4 +113,16 @@ void tfm_pool_free(struct tfm_pool_instance_t *pool, void *ptr);
 bool is_valid_chunk_data_in_pool(struct tfm_pool_instance_t *pool,
                                  uint8_t *data);
 
+#if CONFIG_TFM_SPM_POOL_STATISTICS == 1
+/**
+ * \brief Get the usage statistics of a pool.
+ *
+ * \param[in]  pool             Pointer to memory pool declared by
+ *                              \ref TFM_POOL_DECLARE.
+ * \param[out] stat             The statistics of the pool.
+ */
+void tfm_pool_get_stat(struct tfm_pool_instance_t *pool,
+                       struct tfm_pool_stat_t *stat);
+#endif
+
 #endif /* __TFM_POOLS_H__ */
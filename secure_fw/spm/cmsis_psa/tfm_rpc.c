@@ -34,6 +34,7 @@ static struct tfm_rpc_ops_t rpc_ops = {
     .handle_req = default_handle_req,
     .reply      = default_mailbox_reply,
     .get_caller_data = default_get_caller_data,
+    .flush_replies = NULL,
 };
 
 uint32_t tfm_rpc_psa_framework_version(void)
@@ -98,6 +99,7 @@ int32_t tfm_rpc_register_ops(const struct tfm_rpc_ops_t *ops_ptr)
     rpc_ops.handle_req = ops_ptr->handle_req;
     rpc_ops.reply = ops_ptr->reply;
     rpc_ops.get_caller_data = ops_ptr->get_caller_data;
+    rpc_ops.flush_replies = ops_ptr->flush_replies;
 
     return TFM_RPC_SUCCESS;
 }
@@ -107,6 +109,7 @@ void tfm_rpc_unregister_ops(void)
     rpc_ops.handle_req = default_handle_req;
     rpc_ops.reply = default_mailbox_reply;
     rpc_ops.get_caller_data = default_get_caller_data;
+    rpc_ops.flush_replies = NULL;
 }
 
 void tfm_rpc_client_call_handler(void)
@@ -121,6 +124,13 @@ void tfm_rpc_client_call_reply(const void *owner, int32_t ret)
     rpc_ops.reply(handle->caller_data, ret);
 }
 
+void tfm_rpc_client_call_flush(void)
+{
+    if (rpc_ops.flush_replies) {
+        rpc_ops.flush_replies();
+    }
+}
+
 void tfm_rpc_set_caller_data(struct connection_t *handle, int32_t client_id)
 {
     handle->caller_data = rpc_ops.get_caller_data(client_id);
@@ -54,11 +54,14 @@ struct client_call_params_t {
  *                owner identifies the owner of the PSA client call.
  * get_caller_data() - Get the private data of NSPE client from mailbox to
  *                     identify the PSA client call.
+ * flush_replies() - Optional. Notify NSPE of the replies held back to be
+ *                   coalesced. Called once per scheduling pass.
  */
 struct tfm_rpc_ops_t {
     void (*handle_req)(void);
     void (*reply)(const void *owner, int32_t ret);
     const void * (*get_caller_data)(int32_t client_id);
+    void (*flush_replies)(void);
 };
 
 /**
@@ -161,6 +164,12 @@ void tfm_rpc_client_call_handler(void);
  */
 void tfm_rpc_client_call_reply(const void *owner, int32_t ret);
 
+/**
+ * \brief Notify NSPE of the PSA client call results replied so far, if the
+ *        underlying mailbox coalesces the notifications.
+ */
+void tfm_rpc_client_call_flush(void);
+
 /*
  * Check if the message was allocated for a non-secure request via RPC
  *
@@ -205,6 +214,8 @@ void tfm_rpc_set_caller_data(struct connection_t *handle, int32_t client_id);
 
 #define tfm_rpc_client_call_reply(owner, ret)   do {} while (0)
 
+#define tfm_rpc_client_call_flush()             do {} while (0)
+
 #define tfm_rpc_set_caller_data(hdl, client_id) do {} while (0)
 
 #endif /* TFM_PARTITION_NS_AGENT_MAILBOX */
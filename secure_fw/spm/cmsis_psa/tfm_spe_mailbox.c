@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2021, Cypress Semiconductor Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -9,13 +9,21 @@
 #include "cmsis_compiler.h"
 
 #include "config_impl.h"
+#include "critical_section.h"
+#include "current.h"
+#include "fih.h"
 #include "psa/error.h"
+#include "spm.h"
+#include "tfm_hal_isolation.h"
 #include "utilities.h"
 #include "tfm_arch.h"
+#include "ffm/backend.h"
+#include "ffm/spm_trace.h"
 #include "thread.h"
 #include "tfm_spe_mailbox.h"
 #include "tfm_rpc.h"
 #include "tfm_multi_core.h"
+#include "region_defs.h"
 
 static struct secure_mailbox_queue_t spe_mailbox_queue;
 
@@ -65,54 +73,103 @@ static int32_t tfm_mailbox_dispatch(uint32_t call_type,
     }
 }
 
-__STATIC_INLINE void set_spe_queue_empty_status(uint8_t idx)
+/*
+ * Assert the mailbox interrupt signal of the NS Agent, so that it calls
+ * tfm_mailbox_handle_msg() again without a doorbell from NSPE.
+ */
+static void mailbox_kick_agent(struct partition_t *p_agent)
 {
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        spe_mailbox_queue.empty_slots |= (1 << idx);
+    const struct irq_load_info_t *p_ildi;
+
+    /* The mailbox NS Agent owns one interrupt, the mailbox notification. */
+    if (p_agent && (p_agent->p_ldinf->nirqs > 0)) {
+        p_ildi = LOAD_INFO_IRQ(p_agent->p_ldinf);
+        backend_assert_signal(p_agent, p_ildi->signal);
+    }
+}
+
+/*
+ * Take the lowest free SPE queue slot. Returns NUM_SPE_MAILBOX_QUEUE_SLOT and
+ * marks the queue as deferred if all the slots are in use, so that freeing a
+ * slot kicks the NS Agent to pick up the NSPE requests left pending.
+ */
+static uint8_t alloc_spe_queue_slot(void)
+{
+    struct critical_section_t cs_slot = CRITICAL_SECTION_STATIC_INIT;
+    uint8_t idx = NUM_SPE_MAILBOX_QUEUE_SLOT;
+
+    CRITICAL_SECTION_ENTER(cs_slot);
+    idx = mailbox_status_next_slot(&spe_mailbox_queue.empty_slots, 0);
+    if (idx < NUM_SPE_MAILBOX_QUEUE_SLOT) {
+        mailbox_status_clear_slot(&spe_mailbox_queue.empty_slots, idx);
+    } else {
+        idx = NUM_SPE_MAILBOX_QUEUE_SLOT;
+        spe_mailbox_queue.deferred = true;
     }
+    CRITICAL_SECTION_LEAVE(cs_slot);
+
+    return idx;
 }
 
-__STATIC_INLINE void clear_spe_queue_empty_status(uint8_t idx)
+/*
+ * Give a SPE queue slot back. If NSPE requests were deferred, assert the
+ * mailbox interrupt signal of the NS Agent again so that it handles them.
+ */
+static void free_spe_queue_slot(uint8_t idx)
 {
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
-        spe_mailbox_queue.empty_slots &= ~(1 << idx);
+    struct critical_section_t cs_slot = CRITICAL_SECTION_STATIC_INIT;
+    struct partition_t *p_agent = NULL;
+
+    if (idx >= NUM_SPE_MAILBOX_QUEUE_SLOT) {
+        return;
     }
+
+    CRITICAL_SECTION_ENTER(cs_slot);
+    mailbox_status_set_slot(&spe_mailbox_queue.empty_slots, idx);
+    if (spe_mailbox_queue.deferred) {
+        spe_mailbox_queue.deferred = false;
+        p_agent = spe_mailbox_queue.p_agent;
+    }
+    CRITICAL_SECTION_LEAVE(cs_slot);
+
+    mailbox_kick_agent(p_agent);
 }
 
 __STATIC_INLINE bool get_spe_queue_empty_status(uint8_t idx)
 {
-    if ((idx < NUM_MAILBOX_QUEUE_SLOT) &&
-        (spe_mailbox_queue.empty_slots & (1 << idx))) {
+    if ((idx < NUM_SPE_MAILBOX_QUEUE_SLOT) &&
+        mailbox_status_has_slot(&spe_mailbox_queue.empty_slots, idx)) {
         return true;
     }
 
     return false;
 }
 
-__STATIC_INLINE mailbox_queue_status_t get_nspe_queue_pend_status(
-                                    const struct ns_mailbox_queue_t *ns_queue)
+__STATIC_INLINE void get_nspe_queue_pend_status(
+                                    const struct ns_mailbox_queue_t *ns_queue,
+                                    mailbox_queue_status_t *status)
 {
-    return ns_queue->pend_slots;
+    mailbox_status_copy(status, &ns_queue->pend_slots);
 }
 
 __STATIC_INLINE void set_nspe_queue_replied_status(
-                                            struct ns_mailbox_queue_t *ns_queue,
-                                            mailbox_queue_status_t mask)
+                                        struct ns_mailbox_queue_t *ns_queue,
+                                        const mailbox_queue_status_t *mask)
 {
-    ns_queue->replied_slots |= mask;
+    mailbox_status_set_mask(&ns_queue->replied_slots, mask);
 }
 
 __STATIC_INLINE void clear_nspe_queue_pend_status(
-                                            struct ns_mailbox_queue_t *ns_queue,
-                                            mailbox_queue_status_t mask)
+                                        struct ns_mailbox_queue_t *ns_queue,
+                                        const mailbox_queue_status_t *mask)
 {
-    ns_queue->pend_slots &= ~mask;
+    mailbox_status_clear_mask(&ns_queue->pend_slots, mask);
 }
 
 __STATIC_INLINE int32_t get_spe_mailbox_msg_handle(uint8_t idx,
                                                    mailbox_msg_handle_t *handle)
 {
-    if ((idx >= NUM_MAILBOX_QUEUE_SLOT) || !handle) {
+    if ((idx >= NUM_SPE_MAILBOX_QUEUE_SLOT) || !handle) {
         return MAILBOX_INVAL_PARAMS;
     }
 
@@ -128,39 +185,46 @@ __STATIC_INLINE int32_t get_spe_mailbox_msg_idx(mailbox_msg_handle_t handle,
         return MAILBOX_INVAL_PARAMS;
     }
 
-    *idx = (uint8_t)(handle - 1);
+    *idx = (uint8_t)((handle & MAILBOX_MSG_SLOT_MASK) - 1);
 
     return MAILBOX_SUCCESS;
 }
 
 static void mailbox_clean_queue_slot(uint8_t idx)
 {
-    if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
+    if (idx >= NUM_SPE_MAILBOX_QUEUE_SLOT) {
         return;
     }
 
+    SPM_TRACE(SPM_TRACE_EVT_MBOX_SLOT_FREE, idx,
+              ((uint32_t)spe_mailbox_queue.queue[idx].ns_queue_idx << 8) |
+              spe_mailbox_queue.queue[idx].ns_slot_idx);
+
     spm_memset(&spe_mailbox_queue.queue[idx], 0,
                          sizeof(spe_mailbox_queue.queue[idx]));
-    set_spe_queue_empty_status(idx);
+    free_spe_queue_slot(idx);
 }
 
 __STATIC_INLINE struct mailbox_reply_t *get_nspe_reply_addr(uint8_t idx)
 {
-    uint8_t ns_slot_idx;
+    uint8_t ns_slot_idx, ns_queue_idx;
 
-    if (idx >= NUM_MAILBOX_QUEUE_SLOT) {
+    if (idx >= NUM_SPE_MAILBOX_QUEUE_SLOT) {
         return NULL;
     }
 
     ns_slot_idx = spe_mailbox_queue.queue[idx].ns_slot_idx;
+    ns_queue_idx = spe_mailbox_queue.queue[idx].ns_queue_idx;
 
-    return &spe_mailbox_queue.ns_queue->queue[ns_slot_idx].reply;
+    return &spe_mailbox_queue.ns_queue[ns_queue_idx]->queue[ns_slot_idx].reply;
 }
 
-static void mailbox_direct_reply(uint8_t idx, uint32_t result)
+/* Returns the index of the NSPE queue slot to set as replied. */
+static uint8_t mailbox_direct_reply(uint8_t idx, uint32_t result)
 {
     struct mailbox_reply_t *reply_ptr;
     uint32_t ret_result = result;
+    uint8_t ns_slot_idx = spe_mailbox_queue.queue[idx].ns_slot_idx;
 
     /* Get reply address */
     reply_ptr = get_nspe_reply_addr(idx);
@@ -173,6 +237,143 @@ static void mailbox_direct_reply(uint8_t idx, uint32_t result)
      * Skip NSPE queue status update after single reply.
      * Update NSPE queue status after all the mailbox messages are completed
      */
+    return ns_slot_idx;
+}
+
+/*
+ * Count one call of a batch as done, or the issuing of the batch calls.
+ * Returns true if the whole batch is done.
+ */
+static bool mailbox_batch_put(struct secure_mailbox_slot_t *slot)
+{
+    struct critical_section_t cs_batch = CRITICAL_SECTION_STATIC_INIT;
+    bool done;
+
+    CRITICAL_SECTION_ENTER(cs_batch);
+    done = (--slot->batch_pending == 0);
+    CRITICAL_SECTION_LEAVE(cs_batch);
+
+    return done;
+}
+
+/*
+ * Issue all the calls of a batch to TF-M IPC SPM. The calls are replied
+ * one by one via tfm_mailbox_reply_msg(), and the mailbox message is
+ * replied once all of them are done.
+ *
+ * Returns true if the batch is already done, and the mailbox message shall
+ * be replied with the value in psa_ret.
+ */
+static bool mailbox_dispatch_batch(uint8_t idx, psa_status_t *psa_ret)
+{
+    struct secure_mailbox_slot_t *slot = &spe_mailbox_queue.queue[idx];
+    const struct psa_call_batch_item_t *items =
+                                    slot->msg.params.psa_call_batch_params.items;
+    size_t num = slot->msg.params.psa_call_batch_params.num;
+    struct partition_t *p_agent = GET_CURRENT_COMPONENT();
+    struct psa_call_batch_item_t item;
+    struct client_call_params_t spm_params = {0};
+    psa_status_t status;
+    fih_int fih_rc = FIH_FAILURE;
+    uint8_t i;
+
+    *psa_ret = PSA_ERROR_PROGRAMMER_ERROR;
+
+    if ((num == 0) || (num > PSA_CALL_BATCH_MAX_NUM)) {
+        return true;
+    }
+
+    slot->batch_statuses = slot->msg.params.psa_call_batch_params.statuses;
+
+    FIH_CALL(tfm_hal_memory_check, fih_rc, p_agent->boundary,
+             (uintptr_t)items, num * sizeof(*items), TFM_HAL_ACCESS_READABLE);
+    if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+        return true;
+    }
+
+    FIH_CALL(tfm_hal_memory_check, fih_rc, p_agent->boundary,
+             (uintptr_t)slot->batch_statuses,
+             num * sizeof(*slot->batch_statuses), TFM_HAL_ACCESS_READWRITE);
+    if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+        return true;
+    }
+
+    /* Hold one more count until all the calls are issued. */
+    slot->batch_pending = num + 1;
+
+    for (i = 0; i < num; i++) {
+        /* Copy the item out to avoid TOCTOU attacks. */
+        spm_memcpy(&item, &items[i], sizeof(item));
+
+        slot->batch_handles[i] = slot->msg_handle |
+                 (mailbox_msg_handle_t)((i + 1) << MAILBOX_MSG_BATCH_ITEM_SHIFT);
+        spe_mailbox_queue.cur_proc_batch_idx = i;
+
+        spm_params.handle = item.handle;
+        spm_params.type = item.type;
+        spm_params.in_vec = item.in_vec;
+        spm_params.in_len = item.in_len;
+        spm_params.out_vec = item.out_vec;
+        spm_params.out_len = item.out_len;
+
+        status = tfm_rpc_psa_call(&spm_params);
+        if (status != PSA_SUCCESS) {
+            /* The call is not delivered and will not be replied. */
+            spm_memcpy(&slot->batch_statuses[i], &status, sizeof(status));
+            (void)mailbox_batch_put(slot);
+        }
+    }
+
+    *psa_ret = PSA_SUCCESS;
+
+    return mailbox_batch_put(slot);
+}
+
+/*
+ * Take a snapshot of the NSPE mailbox message fields used by its call type.
+ * Only these fields are read from non-secure memory, each once, so that they
+ * cannot change after being checked. The rest of the SPE slot stays zero.
+ */
+static void mailbox_snapshot_msg(struct mailbox_msg_t *dst,
+                                 const struct mailbox_msg_t *src)
+{
+    const struct psa_client_params_t *params = &src->params;
+
+    dst->call_type = src->call_type;
+    dst->client_id = src->client_id;
+
+    switch (dst->call_type) {
+    case MAILBOX_PSA_VERSION:
+        dst->params.psa_version_params.sid = params->psa_version_params.sid;
+        break;
+    case MAILBOX_PSA_CONNECT:
+        dst->params.psa_connect_params.sid = params->psa_connect_params.sid;
+        dst->params.psa_connect_params.version =
+                                        params->psa_connect_params.version;
+        break;
+    case MAILBOX_PSA_CALL:
+        dst->params.psa_call_params.handle = params->psa_call_params.handle;
+        dst->params.psa_call_params.type = params->psa_call_params.type;
+        dst->params.psa_call_params.in_vec = params->psa_call_params.in_vec;
+        dst->params.psa_call_params.in_len = params->psa_call_params.in_len;
+        dst->params.psa_call_params.out_vec = params->psa_call_params.out_vec;
+        dst->params.psa_call_params.out_len = params->psa_call_params.out_len;
+        break;
+    case MAILBOX_PSA_CLOSE:
+        dst->params.psa_close_params.handle = params->psa_close_params.handle;
+        break;
+    case MAILBOX_PSA_CALL_BATCH:
+        dst->params.psa_call_batch_params.items =
+                                        params->psa_call_batch_params.items;
+        dst->params.psa_call_batch_params.statuses =
+                                        params->psa_call_batch_params.statuses;
+        dst->params.psa_call_batch_params.num =
+                                        params->psa_call_batch_params.num;
+        break;
+    default:
+        /* MAILBOX_PSA_FRAMEWORK_VERSION has no parameter */
+        break;
+    }
 }
 
 __STATIC_INLINE int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
@@ -185,47 +386,63 @@ __STATIC_INLINE int32_t check_mailbox_msg(const struct mailbox_msg_t *msg)
     return MAILBOX_SUCCESS;
 }
 
-int32_t tfm_mailbox_handle_msg(void)
+/*
+ * Default doorbell of an NSPE mailbox queue. Platforms with one doorbell per
+ * queue override it, the others notify their single peer.
+ */
+__WEAK int32_t tfm_mailbox_hal_notify_peer_queue(uint8_t queue_idx)
 {
-    uint8_t idx;
+    (void)queue_idx;
+
+    return tfm_mailbox_hal_notify_peer();
+}
+
+/* Handle the pending mailbox messages in one NSPE mailbox queue. */
+static int32_t mailbox_handle_ns_queue(uint8_t q_idx)
+{
+    uint8_t idx, ns_idx;
     int32_t result;
     psa_status_t psa_ret = PSA_ERROR_GENERIC_ERROR;
-    mailbox_queue_status_t mask_bits, pend_slots, reply_slots = 0;
-    struct ns_mailbox_queue_t *ns_queue = spe_mailbox_queue.ns_queue;
+    mailbox_queue_status_t pend_slots, reply_slots;
+    struct ns_mailbox_queue_t *ns_queue = spe_mailbox_queue.ns_queue[q_idx];
     struct mailbox_msg_t *msg_ptr;
-
-    SPM_ASSERT(ns_queue != NULL);
+    bool ns_polling;
 
     tfm_mailbox_hal_enter_critical();
 
-    pend_slots = get_nspe_queue_pend_status(ns_queue);
+    get_nspe_queue_pend_status(ns_queue, &pend_slots);
 
     tfm_mailbox_hal_exit_critical();
 
     /* Check if NSPE mailbox did assert a PSA client call request */
-    if (!pend_slots) {
+    if (mailbox_status_is_zero(&pend_slots)) {
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    for (idx = 0; idx < NUM_MAILBOX_QUEUE_SLOT; idx++) {
-        mask_bits = (1 << idx);
-        /* Check if current NSPE mailbox queue slot is pending for handling */
-        if (!(pend_slots & mask_bits)) {
-            continue;
-        }
+    mailbox_status_zero(&reply_slots);
 
+    /* Scan the NSPE mailbox queue slots pending for handling */
+    for (ns_idx = mailbox_status_next_slot(&pend_slots, 0);
+         ns_idx < NUM_MAILBOX_QUEUE_SLOT;
+         ns_idx = mailbox_status_next_slot(&pend_slots, ns_idx + 1)) {
         /*
-         * TODO
-         * The operations are simplified here. Use the SPE mailbox queue
-         * slot with the same idx as that of the NSPE mailbox queue slot.
-         * A more general implementation should dynamically search and
-         * select an empty SPE mailbox queue slot.
+         * Without a free SPE slot the request stays pending in the NSPE
+         * queue. It is handled once an ongoing message is replied.
          */
-        clear_spe_queue_empty_status(idx);
-        spe_mailbox_queue.queue[idx].ns_slot_idx = idx;
+        idx = alloc_spe_queue_slot();
+        if (idx >= NUM_SPE_MAILBOX_QUEUE_SLOT) {
+            mailbox_status_clear_slot(&pend_slots, ns_idx);
+            continue;
+        }
+
+        spe_mailbox_queue.queue[idx].ns_queue_idx = q_idx;
+        spe_mailbox_queue.queue[idx].ns_slot_idx = ns_idx;
+
+        SPM_TRACE(SPM_TRACE_EVT_MBOX_SLOT_ALLOC, idx,
+                  ((uint32_t)q_idx << 8) | ns_idx);
 
         msg_ptr = &spe_mailbox_queue.queue[idx].msg;
-        spm_memcpy(msg_ptr, &ns_queue->queue[idx].msg, sizeof(*msg_ptr));
+        mailbox_snapshot_msg(msg_ptr, &ns_queue->queue[ns_idx].msg);
 
         if (check_mailbox_msg(msg_ptr) != MAILBOX_SUCCESS) {
             mailbox_clean_queue_slot(idx);
@@ -242,6 +459,16 @@ int32_t tfm_mailbox_handle_msg(void)
          */
         spe_mailbox_queue.cur_proc_slot_idx = idx;
 
+        if (msg_ptr->call_type == MAILBOX_PSA_CALL_BATCH) {
+            if (mailbox_dispatch_batch(idx, &psa_ret)) {
+                mailbox_status_set_slot(&reply_slots,
+                                mailbox_direct_reply(idx, (uint32_t)psa_ret));
+            }
+
+            spe_mailbox_queue.cur_proc_slot_idx = NUM_SPE_MAILBOX_QUEUE_SLOT;
+            continue;
+        }
+
         result = tfm_mailbox_dispatch(msg_ptr->call_type, &msg_ptr->params,
                                       msg_ptr->client_id, &psa_ret);
         if (result != MAILBOX_SUCCESS) {
@@ -250,7 +477,7 @@ int32_t tfm_mailbox_handle_msg(void)
         }
 
         /* Clean up the current slot index under processing */
-        spe_mailbox_queue.cur_proc_slot_idx = NUM_MAILBOX_QUEUE_SLOT;
+        spe_mailbox_queue.cur_proc_slot_idx = NUM_SPE_MAILBOX_QUEUE_SLOT;
 
         if ((msg_ptr->call_type == MAILBOX_PSA_FRAMEWORK_VERSION) ||
             (msg_ptr->call_type == MAILBOX_PSA_VERSION)) {
@@ -258,9 +485,8 @@ int32_t tfm_mailbox_handle_msg(void)
              * Directly write the result to NSPE for psa_framework_version() and
              * psa_version().
              */
-            reply_slots |= (1 << idx);
-
-            mailbox_direct_reply(idx, (uint32_t)psa_ret);
+            mailbox_status_set_slot(&reply_slots,
+                                mailbox_direct_reply(idx, (uint32_t)psa_ret));
         } else if ((msg_ptr->call_type == MAILBOX_PSA_CONNECT) ||
                    (msg_ptr->call_type == MAILBOX_PSA_CALL)) {
             /*
@@ -268,8 +494,8 @@ int32_t tfm_mailbox_handle_msg(void)
              * TF-M IPC SPM, the failure result should be returned immediately.
              */
             if (psa_ret != PSA_SUCCESS) {
-                reply_slots |= (1 << idx);
-                mailbox_direct_reply(idx, (uint32_t)psa_ret);
+                mailbox_status_set_slot(&reply_slots,
+                                mailbox_direct_reply(idx, (uint32_t)psa_ret));
             }
         }
         /*
@@ -280,28 +506,184 @@ int32_t tfm_mailbox_handle_msg(void)
 
     tfm_mailbox_hal_enter_critical();
 
-    /* Clean the NSPE mailbox pending status. */
-    clear_nspe_queue_pend_status(ns_queue, pend_slots);
+    /* Clean the NSPE mailbox pending status of the requests taken. */
+    clear_nspe_queue_pend_status(ns_queue, &pend_slots);
 
     /* Set the NSPE mailbox replied status */
-    set_nspe_queue_replied_status(ns_queue, reply_slots);
+    set_nspe_queue_replied_status(ns_queue, &reply_slots);
+
+    ns_polling = ns_queue->ns_polling;
 
     tfm_mailbox_hal_exit_critical();
 
-    if (reply_slots) {
-        tfm_mailbox_hal_notify_peer();
+    if (!mailbox_status_is_zero(&reply_slots) && !ns_polling) {
+        tfm_mailbox_hal_notify_peer_queue(q_idx);
     }
 
-    return MAILBOX_SUCCESS;
+    /* Requests left pending for lack of SPE slots are no progress */
+    return mailbox_status_is_zero(&pend_slots) ? MAILBOX_NO_PEND_EVENT :
+                                                 MAILBOX_SUCCESS;
+}
+
+/*
+ * Switch all the NSPE queues in or out of polling mode. Returns true if a
+ * request is pending in any queue when the mode is changed.
+ */
+static bool mailbox_set_polling(bool polling)
+{
+    uint8_t q_idx;
+    struct ns_mailbox_queue_t *ns_queue;
+    bool pending = false;
+
+    tfm_mailbox_hal_enter_critical();
+
+    for (q_idx = 0; q_idx < NUM_MAILBOX_QUEUE; q_idx++) {
+        ns_queue = spe_mailbox_queue.ns_queue[q_idx];
+        if (!ns_queue) {
+            continue;
+        }
+
+        ns_queue->spe_polling = polling;
+        if (!mailbox_status_is_zero(&ns_queue->pend_slots)) {
+            pending = true;
+        }
+    }
+
+    tfm_mailbox_hal_exit_critical();
+
+    return pending;
+}
+
+int32_t tfm_mailbox_handle_msg(void)
+{
+    uint8_t q_idx, round;
+    int32_t ret = MAILBOX_NO_PEND_EVENT;
+    bool busy;
+
+    SPM_ASSERT(spe_mailbox_queue.ns_queue[0] != NULL);
+
+    /* Kicked again when a slot is freed for deferred requests */
+    spe_mailbox_queue.p_agent = GET_CURRENT_COMPONENT();
+
+    /*
+     * Like NAPI, NSPE doorbells are turned off while the queues are polled.
+     * Polling stops when a round finds no request to take, then doorbells
+     * are turned on again and the queues checked once more to catch a
+     * request posted meanwhile.
+     */
+    (void)mailbox_set_polling(true);
+
+    for (round = 0; round < MAILBOX_POLL_BUDGET; round++) {
+        busy = false;
+
+        /*
+         * Queue 0 has the highest priority. Its requests take the free SPE
+         * slots first, the lower queues are left pending when the slots run
+         * out.
+         */
+        for (q_idx = 0; q_idx < NUM_MAILBOX_QUEUE; q_idx++) {
+            if (!spe_mailbox_queue.ns_queue[q_idx]) {
+                continue;
+            }
+
+            if (mailbox_handle_ns_queue(q_idx) == MAILBOX_SUCCESS) {
+                busy = true;
+                ret = MAILBOX_SUCCESS;
+            }
+        }
+
+        if (busy) {
+            continue;
+        }
+
+        /*
+         * Quiet, or only requests waiting for a free slot, which kicks the
+         * agent again once it is freed.
+         */
+        if (!mailbox_set_polling(false) || spe_mailbox_queue.deferred) {
+            return ret;
+        }
+
+        (void)mailbox_set_polling(true);
+    }
+
+    /*
+     * Budget used up with traffic still coming. Keep doorbells off and come
+     * back from the Partition loop, so that other Partitions can be scheduled
+     * in between.
+     */
+    mailbox_kick_agent(spe_mailbox_queue.p_agent);
+
+    return ret;
+}
+
+#if MAILBOX_REPLY_COALESCE_NUM > 1
+/* Set the gathered replied slots in each NSPE queue, one doorbell per queue */
+static void mailbox_flush_replies(void)
+{
+    struct critical_section_t cs_reply = CRITICAL_SECTION_STATIC_INIT;
+    mailbox_queue_status_t slots[NUM_MAILBOX_QUEUE];
+    struct ns_mailbox_queue_t *ns_queue;
+    uint8_t q_idx;
+    bool ns_polling;
+
+    CRITICAL_SECTION_ENTER(cs_reply);
+    if (spe_mailbox_queue.coalesced_num == 0) {
+        CRITICAL_SECTION_LEAVE(cs_reply);
+        return;
+    }
+    spm_memcpy(slots, spe_mailbox_queue.coalesced_slots, sizeof(slots));
+    spm_memset(spe_mailbox_queue.coalesced_slots, 0, sizeof(slots));
+    spe_mailbox_queue.coalesced_num = 0;
+    CRITICAL_SECTION_LEAVE(cs_reply);
+
+    for (q_idx = 0; q_idx < NUM_MAILBOX_QUEUE; q_idx++) {
+        ns_queue = spe_mailbox_queue.ns_queue[q_idx];
+        if (mailbox_status_is_zero(&slots[q_idx]) || !ns_queue) {
+            continue;
+        }
+
+        tfm_mailbox_hal_enter_critical();
+        set_nspe_queue_replied_status(ns_queue, &slots[q_idx]);
+        ns_polling = ns_queue->ns_polling;
+        tfm_mailbox_hal_exit_critical();
+
+        if (!ns_polling) {
+            tfm_mailbox_hal_notify_peer_queue(q_idx);
+        }
+    }
+}
+
+/* Hold a reply back until enough are gathered or the pass ends */
+static void mailbox_coalesce_reply(uint8_t q_idx, uint8_t ns_slot_idx)
+{
+    struct critical_section_t cs_reply = CRITICAL_SECTION_STATIC_INIT;
+    bool full;
+
+    CRITICAL_SECTION_ENTER(cs_reply);
+    mailbox_status_set_slot(&spe_mailbox_queue.coalesced_slots[q_idx],
+                            ns_slot_idx);
+    full = (++spe_mailbox_queue.coalesced_num >= MAILBOX_REPLY_COALESCE_NUM);
+    CRITICAL_SECTION_LEAVE(cs_reply);
+
+    if (full) {
+        mailbox_flush_replies();
+    }
 }
+#endif /* MAILBOX_REPLY_COALESCE_NUM > 1 */
 
 int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
 {
-    uint8_t idx;
+    uint8_t idx, q_idx;
     int32_t ret;
-    struct ns_mailbox_queue_t *ns_queue = spe_mailbox_queue.ns_queue;
+    uint32_t batch_item;
+    struct secure_mailbox_slot_t *slot;
+    uint8_t ns_slot_idx;
+#if MAILBOX_REPLY_COALESCE_NUM <= 1
+    bool ns_polling;
+#endif
 
-    SPM_ASSERT(ns_queue != NULL);
+    SPM_ASSERT(spe_mailbox_queue.ns_queue[0] != NULL);
 
     /*
      * If handle == MAILBOX_MSG_NULL_HANDLE, reply to the mailbox message
@@ -322,16 +704,43 @@ int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply)
         return MAILBOX_NO_PEND_EVENT;
     }
 
-    mailbox_direct_reply(idx, (uint32_t)reply);
+    /* A call of a batch. Reply the mailbox message when the batch is done. */
+    batch_item = (uint32_t)handle >> MAILBOX_MSG_BATCH_ITEM_SHIFT;
+    if (batch_item != 0) {
+        if (batch_item > PSA_CALL_BATCH_MAX_NUM) {
+            return MAILBOX_INVAL_PARAMS;
+        }
+
+        slot = &spe_mailbox_queue.queue[idx];
+        spm_memcpy(&slot->batch_statuses[batch_item - 1], &reply,
+                   sizeof(slot->batch_statuses[batch_item - 1]));
+        if (!mailbox_batch_put(slot)) {
+            return MAILBOX_SUCCESS;
+        }
+
+        reply = PSA_SUCCESS;
+    }
+
+    q_idx = spe_mailbox_queue.queue[idx].ns_queue_idx;
+    ns_slot_idx = mailbox_direct_reply(idx, (uint32_t)reply);
 
+#if MAILBOX_REPLY_COALESCE_NUM > 1
+    mailbox_coalesce_reply(q_idx, ns_slot_idx);
+#else
     tfm_mailbox_hal_enter_critical();
 
     /* Set the NSPE mailbox replied status */
-    set_nspe_queue_replied_status(ns_queue, (1 << idx));
+    mailbox_status_set_slot(&spe_mailbox_queue.ns_queue[q_idx]->replied_slots,
+                            ns_slot_idx);
+
+    ns_polling = spe_mailbox_queue.ns_queue[q_idx]->ns_polling;
 
     tfm_mailbox_hal_exit_critical();
 
-    tfm_mailbox_hal_notify_peer();
+    if (!ns_polling) {
+        tfm_mailbox_hal_notify_peer_queue(q_idx);
+    }
+#endif /* MAILBOX_REPLY_COALESCE_NUM > 1 */
 
     return MAILBOX_SUCCESS;
 }
@@ -363,7 +772,13 @@ static const void *mailbox_get_caller_data(int32_t client_id)
     (void)client_id;
 
     idx = spe_mailbox_queue.cur_proc_slot_idx;
-    if (idx < NUM_MAILBOX_QUEUE_SLOT) {
+    if (idx < NUM_SPE_MAILBOX_QUEUE_SLOT) {
+        if (spe_mailbox_queue.queue[idx].msg.call_type ==
+                                                    MAILBOX_PSA_CALL_BATCH) {
+            return (const void *)&spe_mailbox_queue.queue[idx].batch_handles[
+                                        spe_mailbox_queue.cur_proc_batch_idx];
+        }
+
         return (const void *)&spe_mailbox_queue.queue[idx].msg_handle;
     }
 
@@ -375,6 +790,9 @@ static const struct tfm_rpc_ops_t mailbox_rpc_ops = {
     .handle_req = mailbox_handle_req,
     .reply      = mailbox_reply,
     .get_caller_data = mailbox_get_caller_data,
+#if MAILBOX_REPLY_COALESCE_NUM > 1
+    .flush_replies = mailbox_flush_replies,
+#endif
 };
 
 int32_t tfm_mailbox_init(void)
@@ -383,10 +801,9 @@ int32_t tfm_mailbox_init(void)
 
     spm_memset(&spe_mailbox_queue, 0, sizeof(spe_mailbox_queue));
 
-    spe_mailbox_queue.empty_slots =
-            (mailbox_queue_status_t)((1UL << (NUM_MAILBOX_QUEUE_SLOT - 1)) - 1);
-    spe_mailbox_queue.empty_slots +=
-            (mailbox_queue_status_t)(1UL << (NUM_MAILBOX_QUEUE_SLOT - 1));
+    mailbox_status_fill(&spe_mailbox_queue.empty_slots,
+                        NUM_SPE_MAILBOX_QUEUE_SLOT);
+    spe_mailbox_queue.cur_proc_slot_idx = NUM_SPE_MAILBOX_QUEUE_SLOT;
 
     /* Register RPC callbacks */
     ret = tfm_rpc_register_ops(&mailbox_rpc_ops);
@@ -406,6 +823,18 @@ int32_t tfm_mailbox_init(void)
         return ret;
     }
 
+#if (CONFIG_TFM_CRITICAL_SECTION_BASEPRI != 0) && defined(MAILBOX_IRQ)
+    /*
+     * The HAL may set the priority after the loader checked the IRQ. The
+     * handler walks the mailbox queue, the critical sections must mask it.
+     */
+    if (!CRITICAL_SECTION_MASKS_PRIORITY(NVIC_GetPriority(MAILBOX_IRQ))) {
+        tfm_rpc_unregister_ops();
+
+        return MAILBOX_INIT_ERROR;
+    }
+#endif
+
     return MAILBOX_SUCCESS;
 }
 
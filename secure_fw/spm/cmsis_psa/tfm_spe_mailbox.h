@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,29 +10,92 @@
 
 #include "tfm_mailbox.h"
 
+/*
+ * Number of SPE mailbox queue slots. It can be smaller than the NSPE queue.
+ * NSPE requests beyond it stay pending in the NSPE queue until an SPE slot
+ * is freed.
+ */
+#ifndef NUM_SPE_MAILBOX_QUEUE_SLOT
+#define NUM_SPE_MAILBOX_QUEUE_SLOT       NUM_MAILBOX_QUEUE_SLOT
+#endif
+
+#if (NUM_SPE_MAILBOX_QUEUE_SLOT < 1) || \
+    (NUM_SPE_MAILBOX_QUEUE_SLOT > NUM_MAILBOX_QUEUE_SLOT)
+#error "NUM_SPE_MAILBOX_QUEUE_SLOT must be in 1..NUM_MAILBOX_QUEUE_SLOT"
+#endif
+
+/*
+ * Rounds over the NSPE queues that tfm_mailbox_handle_msg() polls before it
+ * returns to the NS Agent while requests keep coming.
+ */
+#ifndef MAILBOX_POLL_BUDGET
+#define MAILBOX_POLL_BUDGET              8
+#endif
+
+/*
+ * Replies gathered before one NSPE doorbell. The gathered replies are also
+ * notified at the end of each scheduling pass. 1 notifies every reply.
+ */
+#ifndef MAILBOX_REPLY_COALESCE_NUM
+#define MAILBOX_REPLY_COALESCE_NUM       1
+#endif
+
 /* A handle to a mailbox message in use */
 typedef int32_t    mailbox_msg_handle_t;
 
 #define MAILBOX_MSG_NULL_HANDLE          ((mailbox_msg_handle_t)0)
 
+/*
+ * The low bits of a message handle select the queue slot. The calls of a
+ * batch add their call index plus one above them.
+ */
+#define MAILBOX_MSG_BATCH_ITEM_SHIFT     16
+#define MAILBOX_MSG_SLOT_MASK            ((1UL << MAILBOX_MSG_BATCH_ITEM_SHIFT) - 1)
+
 /* A single slot structure in SPE mailbox queue */
 struct secure_mailbox_slot_t {
     struct mailbox_msg_t msg;
 
+    uint8_t              ns_queue_idx;      /* NSPE mailbox queue index */
     uint8_t              ns_slot_idx;
     mailbox_msg_handle_t msg_handle;
+
+    psa_status_t         *batch_statuses;   /* NSPE status array of a batch */
+    uint32_t             batch_pending;     /*
+                                             * Calls of the batch not replied
+                                             * yet, plus one while the calls
+                                             * are being issued
+                                             */
+    mailbox_msg_handle_t batch_handles[PSA_CALL_BATCH_MAX_NUM];
 };
 
 struct secure_mailbox_queue_t {
     mailbox_queue_status_t       empty_slots;      /* bitmask of empty slots */
-
-    struct secure_mailbox_slot_t queue[NUM_MAILBOX_QUEUE_SLOT];
-    struct ns_mailbox_queue_t    *ns_queue;
+    bool                         deferred;         /*
+                                                    * NSPE requests are left
+                                                    * pending for lack of a
+                                                    * free slot
+                                                    */
+    struct partition_t           *p_agent;         /* The mailbox NS Agent */
+
+    struct secure_mailbox_slot_t queue[NUM_SPE_MAILBOX_QUEUE_SLOT];
+    /* NSPE mailbox queues in priority order, NULL if not used */
+    struct ns_mailbox_queue_t    *ns_queue[NUM_MAILBOX_QUEUE];
     uint8_t                      cur_proc_slot_idx; /*
                                                      * The index of mailbox
                                                      * queue slot currently
                                                      * under processing.
                                                      */
+    uint8_t                      cur_proc_batch_idx; /*
+                                                      * The index of the call
+                                                      * currently issued in
+                                                      * a batch.
+                                                      */
+#if MAILBOX_REPLY_COALESCE_NUM > 1
+    /* Replied NSPE slots per queue, not notified yet */
+    mailbox_queue_status_t       coalesced_slots[NUM_MAILBOX_QUEUE];
+    uint32_t                     coalesced_num;
+#endif
 };
 
 /**
@@ -64,7 +127,8 @@ int32_t tfm_mailbox_reply_msg(mailbox_msg_handle_t handle, int32_t reply);
 int32_t tfm_mailbox_init(void);
 
 /**
- * \brief Platform specific initialization of SPE mailbox.
+ * \brief Platform specific initialization of SPE mailbox. It sets the NSPE
+ *        mailbox queue addresses in \p s_queue, at least ns_queue[0].
  *
  * \param[in] s_queue           The base address of SPE mailbox queue.
  *
@@ -82,6 +146,19 @@ int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue);
  */
 int32_t tfm_mailbox_hal_notify_peer(void);
 
+/**
+ * \brief Notify the NSPE owner of an NSPE mailbox queue that a PSA client call
+ *        return result is replied. The default implementation calls
+ *        \ref tfm_mailbox_hal_notify_peer. Platforms with a doorbell per queue
+ *        can override it.
+ *
+ * \param[in] queue_idx         The index of the NSPE mailbox queue.
+ *
+ * \retval MAILBOX_SUCCESS      The notification is successfully sent out.
+ * \retval Other return code    Operation failed with an error code.
+ */
+int32_t tfm_mailbox_hal_notify_peer_queue(uint8_t queue_idx);
+
 /**
  * \brief Enter critical section of NSPE mailbox
  */
@@ -8,21 +8,30 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "config_spm.h"
+#include "critical_section.h"
 #include "thread.h"
 #include "tfm_arch.h"
 #include "utilities.h"
 
 /* Declaration of current thread pointer. */
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+struct thread_t *p_curr_thrd[CONFIG_TFM_SPM_SECURE_CORE_NUM];
+#else
 struct thread_t *p_curr_thrd;
+#endif
 
-/* Force ZERO in case ZI(bss) clear is missing. */
-static struct thread_t *p_thrd_head = NULL; /* Point to the first thread. */
-static struct thread_t *p_rnbl_head = NULL; /* Point to the first runnable. */
+/* Each secure core runs the threads of its own list. */
+static struct thread_t *p_thrd_head[CONFIG_TFM_SPM_SECURE_CORE_NUM];
+#if CONFIG_TFM_SCHED_READY_BITMAP != 1
+static struct thread_t *p_rnbl_head[CONFIG_TFM_SPM_SECURE_CORE_NUM];
+#endif
 
-/* Define Macro to fetch global to support future expansion (PERCPU e.g.) */
-#define LIST_HEAD   p_thrd_head
-#define RNBL_HEAD   p_rnbl_head
+/* The first thread and the first runnable thread of a core. */
+#define LIST_HEAD(core)   p_thrd_head[core]
+#define RNBL_HEAD(core)   p_rnbl_head[core]
 
 /* Callback function pointer for thread to query current state. */
 static thrd_query_state_t query_state_cb = (thrd_query_state_t)NULL;
@@ -32,25 +41,100 @@ void thrd_set_query_callback(thrd_query_state_t fn)
     query_state_cb = fn;
 }
 
-struct thread_t *thrd_next(void)
+/*
+ * Evaluate the latest state of a thread, and apply the return value if it
+ * became available. Returns true if the thread can be scheduled.
+ */
+static bool thrd_is_runnable(struct thread_t *p_thrd)
 {
-    struct thread_t *p_thrd = RNBL_HEAD;
     uint32_t retval = 0;
 
+    /* Change thread state if any signal changed */
+    p_thrd->state = query_state_cb(p_thrd, &retval);
+
+    if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
+        tfm_arch_set_context_ret_code(p_thrd->p_context_ctrl, retval);
+        p_thrd->state = THRD_STATE_RUNNABLE;
+    }
+
+    return p_thrd->state == THRD_STATE_RUNNABLE;
+}
+
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+/*
+ * Threads are grouped into priority bands. A bit in the ready bitmap stands
+ * for a band which may contain runnable threads, the MSB is the band holding
+ * the highest priority, so the band index is the count of leading zeros.
+ */
+#define THRD_PRIOR_BAND_SHIFT       3
+#define THRD_PRIOR_BAND_NUM         32
+#define THRD_PRIOR_BAND(prior)      ((uint32_t)(prior) >> THRD_PRIOR_BAND_SHIFT)
+#define THRD_PRIOR_BAND_BIT(band)   (0x80000000UL >> (band))
+
+static uint32_t rdy_bitmap[CONFIG_TFM_SPM_SECURE_CORE_NUM];
+/* Point to the first thread of each band in the priority-sorted list. */
+static struct thread_t *band_head[CONFIG_TFM_SPM_SECURE_CORE_NUM]
+                                 [THRD_PRIOR_BAND_NUM];
+
+static void set_band_ready(uint32_t core, uint32_t band, bool ready)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    if (ready) {
+        rdy_bitmap[core] |= THRD_PRIOR_BAND_BIT(band);
+    } else {
+        rdy_bitmap[core] &= ~THRD_PRIOR_BAND_BIT(band);
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void thrd_mark_ready(struct thread_t *p_thrd)
+{
+    SPM_ASSERT(p_thrd != NULL);
+
+    set_band_ready(THRD_CORE(p_thrd), THRD_PRIOR_BAND(p_thrd->priority), true);
+}
+
+struct thread_t *thrd_next(void)
+{
+    struct thread_t *p_thrd;
+    uint32_t core = SPM_CORE_ID();
+    uint32_t band;
+
+    while (rdy_bitmap[core]) {
+        band = __CLZ(rdy_bitmap[core]);
+
+        /*
+         * Clear the band bit before enumerating the band. A signal asserted
+         * while enumerating marks the band ready again, so no wake-up would
+         * be lost.
+         */
+        set_band_ready(core, band, false);
+
+        for (p_thrd = band_head[core][band];
+             p_thrd && (THRD_PRIOR_BAND(p_thrd->priority) == band);
+             p_thrd = p_thrd->next) {
+            if (thrd_is_runnable(p_thrd)) {
+                set_band_ready(core, band, true);
+                return p_thrd;
+            }
+        }
+    }
+
+    return NULL;
+}
+#else /* CONFIG_TFM_SCHED_READY_BITMAP == 1 */
+struct thread_t *thrd_next(void)
+{
+    struct thread_t *p_thrd = RNBL_HEAD(SPM_CORE_ID());
+
     /*
      * First runnable thread has highest priority since threads are
      * sorted by priority.
      */
     while (p_thrd) {
-        /* Change thread state if any signal changed */
-        p_thrd->state = query_state_cb(p_thrd, &retval);
-
-        if (p_thrd->state == THRD_STATE_RET_VAL_AVAIL) {
-            tfm_arch_set_context_ret_code(p_thrd->p_context_ctrl, retval);
-            p_thrd->state = THRD_STATE_RUNNABLE;
-        }
-
-        if (p_thrd->state == THRD_STATE_RUNNABLE) {
+        if (thrd_is_runnable(p_thrd)) {
             break;
         }
 
@@ -59,6 +143,7 @@ struct thread_t *thrd_next(void)
 
     return p_thrd;
 }
+#endif /* CONFIG_TFM_SCHED_READY_BITMAP == 1 */
 
 static void insert_by_prior(struct thread_t **head, struct thread_t *node)
 {
@@ -77,12 +162,126 @@ static void insert_by_prior(struct thread_t **head, struct thread_t *node)
     }
 }
 
+#if (CONFIG_TFM_SCHED_READY_BITMAP == 1) && \
+    ((CONFIG_TFM_PRIORITY_DONATION == 1) || (CONFIG_TFM_PREEMPTION_POINTS == 1))
+/* Find the first thread of every band again after the list is reordered. */
+static void rebuild_band_heads(uint32_t core)
+{
+    struct thread_t *p_thrd;
+    uint32_t band;
+
+    for (band = 0; band < THRD_PRIOR_BAND_NUM; band++) {
+        band_head[core][band] = NULL;
+    }
+
+    for (p_thrd = LIST_HEAD(core); p_thrd; p_thrd = p_thrd->next) {
+        band = THRD_PRIOR_BAND(p_thrd->priority);
+        if (band_head[core][band] == NULL) {
+            band_head[core][band] = p_thrd;
+        }
+    }
+}
+#endif
+
+#if CONFIG_TFM_PRIORITY_DONATION == 1
+void thrd_set_priority(struct thread_t *p_thrd, uint8_t priority)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct thread_t **pp_iter;
+    uint32_t core;
+
+    SPM_ASSERT(p_thrd != NULL);
+
+    if (p_thrd->priority == priority) {
+        return;
+    }
+
+    core = THRD_CORE(p_thrd);
+
+    /* The scheduler must not walk the list while it is reordered. */
+    CRITICAL_SECTION_ENTER(cs);
+
+    for (pp_iter = &LIST_HEAD(core); *pp_iter != p_thrd;
+         pp_iter = &(*pp_iter)->next) {
+        SPM_ASSERT(*pp_iter != NULL);
+    }
+    *pp_iter = p_thrd->next;
+
+    p_thrd->priority = priority;
+    insert_by_prior(&LIST_HEAD(core), p_thrd);
+
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+    rebuild_band_heads(core);
+    /*
+     * A wake-up may have been recorded in the band the thread left. Mark the
+     * new band ready, the scheduler clears it if the thread is not runnable.
+     */
+    rdy_bitmap[core] |= THRD_PRIOR_BAND_BIT(THRD_PRIOR_BAND(priority));
+#else
+    RNBL_HEAD(core) = LIST_HEAD(core);
+#endif
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+#endif /* CONFIG_TFM_PRIORITY_DONATION == 1 */
+
+#if CONFIG_TFM_PREEMPTION_POINTS == 1
+void thrd_yield(struct thread_t *p_thrd)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct thread_t **pp_iter;
+    uint32_t core;
+
+    SPM_ASSERT(p_thrd != NULL);
+
+    core = THRD_CORE(p_thrd);
+
+    /* The scheduler must not walk the list while it is reordered. */
+    CRITICAL_SECTION_ENTER(cs);
+
+    for (pp_iter = &LIST_HEAD(core); *pp_iter != p_thrd;
+         pp_iter = &(*pp_iter)->next) {
+        SPM_ASSERT(*pp_iter != NULL);
+    }
+    *pp_iter = p_thrd->next;
+
+    /* The threads before it have a higher or the same priority */
+    while ((*pp_iter != NULL) && ((*pp_iter)->priority <= p_thrd->priority)) {
+        pp_iter = &(*pp_iter)->next;
+    }
+    p_thrd->next = *pp_iter;
+    *pp_iter = p_thrd;
+
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+    rebuild_band_heads(core);
+    rdy_bitmap[core] |= THRD_PRIOR_BAND_BIT(THRD_PRIOR_BAND(p_thrd->priority));
+#else
+    RNBL_HEAD(core) = LIST_HEAD(core);
+#endif
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+#endif /* CONFIG_TFM_PREEMPTION_POINTS == 1 */
+
 void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *param)
 {
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+    struct thread_t **pp_band;
+#endif
+
     SPM_ASSERT(p_thrd != NULL);
+    SPM_ASSERT(THRD_CORE(p_thrd) < CONFIG_TFM_SPM_SECURE_CORE_NUM);
 
     /* Insert a new thread with priority */
-    insert_by_prior(&LIST_HEAD, p_thrd);
+    insert_by_prior(&LIST_HEAD(THRD_CORE(p_thrd)), p_thrd);
+
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+    /* The new thread is placed before threads of the same priority. */
+    pp_band = &band_head[THRD_CORE(p_thrd)][THRD_PRIOR_BAND(p_thrd->priority)];
+    if ((*pp_band == NULL) || (p_thrd->priority <= (*pp_band)->priority)) {
+        *pp_band = p_thrd;
+    }
+#endif
 
     tfm_arch_init_context(p_thrd->p_context_ctrl, (uintptr_t)fn, param,
                           (uintptr_t)exit_fn);
@@ -93,20 +292,32 @@ void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *
 
 void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state)
 {
+#if CONFIG_TFM_SCHED_READY_BITMAP != 1
+    uint32_t core;
+#endif
+
     SPM_ASSERT(p_thrd != NULL);
 
     p_thrd->state = new_state;
 
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+    if (p_thrd->state == THRD_STATE_RUNNABLE) {
+        thrd_mark_ready(p_thrd);
+    }
+#else
     /*
      * Set first runnable thread as head to reduce enumerate
      * depth while searching for a first runnable thread.
      */
+    core = THRD_CORE(p_thrd);
     if ((p_thrd->state == THRD_STATE_RUNNABLE) &&
-        ((RNBL_HEAD == NULL) || (p_thrd->priority < RNBL_HEAD->priority))) {
-        RNBL_HEAD = p_thrd;
+        ((RNBL_HEAD(core) == NULL) ||
+         (p_thrd->priority < RNBL_HEAD(core)->priority))) {
+        RNBL_HEAD(core) = p_thrd;
     } else {
-        RNBL_HEAD = LIST_HEAD;
+        RNBL_HEAD(core) = LIST_HEAD(core);
     }
+#endif
 }
 
 uint32_t thrd_start_scheduler(struct thread_t **ppth)
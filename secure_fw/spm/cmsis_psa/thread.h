@@ -13,6 +13,10 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "config_spm.h"
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+#include "tfm_hal_secure_cores.h"
+#endif
 
 /* State codes */
 #define THRD_STATE_CREATING       0
@@ -33,6 +37,18 @@
 #define THRD_SUCCESS              0
 #define THRD_ERR_GENERIC          1
 
+/*
+ * Secure core the caller runs on. Each core has its own run queue and current
+ * thread, the threads are pinned to the core of their Partition.
+ */
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+#define SPM_CORE_ID()             tfm_hal_get_secure_core_id()
+#define THRD_CORE(p_thrd)         ((uint32_t)(p_thrd)->core)
+#else
+#define SPM_CORE_ID()             0U
+#define THRD_CORE(p_thrd)         0U
+#endif
+
 /* Thread entry function type */
 typedef void (*thrd_fn_t)(void *);
 
@@ -46,6 +62,9 @@ struct thread_t {
     uint16_t        flags;              /* Flags and align, DO NOT REMOVE!   */
     void            *p_context_ctrl;    /* Context control (sp, splimit, lr) */
     struct thread_t *next;              /* Next thread in list               */
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+    uint32_t        core;               /* Secure core running the thread    */
+#endif
 };
 
 /* Query thread state function type */
@@ -55,8 +74,13 @@ typedef uint32_t (*thrd_query_state_t)(struct thread_t *p_thrd,
  * Definition for the current thread and its access helper preprocessor.
  * The definition needs to be declared in one of the sources.
  */
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+extern struct thread_t *p_curr_thrd[CONFIG_TFM_SPM_SECURE_CORE_NUM];
+#define CURRENT_THREAD p_curr_thrd[SPM_CORE_ID()]
+#else
 extern struct thread_t *p_curr_thrd;
 #define CURRENT_THREAD p_curr_thrd
+#endif
 
 /*
  * Initialize the thread_t struct with the given inputs.
@@ -71,8 +95,23 @@ extern struct thread_t *p_curr_thrd;
                         (p_thrd)->state          = THRD_STATE_CREATING;  \
                         (p_thrd)->flags          = 0;                    \
                         (p_thrd)->p_context_ctrl = p_ctx_ctrl;           \
+                        THRD_SET_CORE(p_thrd, 0);                        \
                     } while (0)
 
+/*
+ * Pin a thread to a secure core. It must be done before the thread is
+ * started.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ *  core_id        -     Secure core ID, below CONFIG_TFM_SPM_SECURE_CORE_NUM
+ */
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+#define THRD_SET_CORE(p_thrd, core_id)  (p_thrd)->core = (uint32_t)(core_id)
+#else
+#define THRD_SET_CORE(p_thrd, core_id)
+#endif
+
 /*
  * Set thread priority.
  *
@@ -86,6 +125,29 @@ extern struct thread_t *p_curr_thrd;
 #define THRD_SET_PRIORITY(p_thrd, priority) \
                                         p_thrd->priority = (uint8_t)(priority)
 
+/*
+ * Change the priority of a thread and move it to the matching position in
+ * the priority-sorted thread list. Takes effect at the next scheduling.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ *  priority       -     Priority value (0~255)
+ */
+#if CONFIG_TFM_PRIORITY_DONATION == 1
+void thrd_set_priority(struct thread_t *p_thrd, uint8_t priority);
+#endif
+
+/*
+ * Move a thread behind the other threads of its priority, so that they are
+ * scheduled first if they are runnable. Takes effect at the next scheduling.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ */
+#if CONFIG_TFM_PREEMPTION_POINTS == 1
+void thrd_yield(struct thread_t *p_thrd);
+#endif
+
 /*
  * Update current thread's bound context pointer.
  *
@@ -120,6 +182,20 @@ void thrd_set_query_callback(thrd_query_state_t fn);
  */
 void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state);
 
+/*
+ * Mark the priority band of a thread as possibly holding a runnable thread.
+ * Needs to be called whenever an event may unblock the thread, for example
+ * a signal asserted to the owner of the thread.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ */
+#if CONFIG_TFM_SCHED_READY_BITMAP == 1
+void thrd_mark_ready(struct thread_t *p_thrd);
+#else
+#define thrd_mark_ready(p_thrd)
+#endif
+
 /*
  * Prepare thread context with given info and insert it into schedulable list.
  *
@@ -135,7 +211,7 @@ void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state);
 void thrd_start(struct thread_t *p_thrd, thrd_fn_t fn, thrd_fn_t exit_fn, void *param);
 
 /*
- * Get the next thread to run in list.
+ * Get the next thread to run in the list of the current secure core.
  *
  * Return :
  *  Pointer of next thread to run.
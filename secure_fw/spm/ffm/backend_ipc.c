@@ -8,16 +8,24 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "aapcs_local.h"
 #include "critical_section.h"
 #include "compiler_ext_defs.h"
 #include "config_spm.h"
 #include "runtime_defs.h"
+#include "ffm/spm_timer.h"
+#include "ffm/spm_trace.h"
 #include "ffm/stack_watermark.h"
 #include "spm.h"
+#include "spm_secure_cores.h"
+#include "tfm_api.h"
 #include "tfm_hal_isolation.h"
 #include "tfm_hal_platform.h"
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+#include "tfm_hal_secure_cores.h"
+#endif
 #include "tfm_rpc.h"
 #include "ffm/backend.h"
 #include "utilities.h"
@@ -52,6 +60,111 @@ uintptr_t *partition_meta_indicator_pos;
 
 extern uint32_t scheduler_lock;
 
+extern void common_sfn_thread(void *param);
+
+#if CONFIG_TFM_STACK_GROUP_NUM > 0
+extern void common_sfn_thread_loop(void *param);
+
+/*
+ * The SFN Partitions of a stack group run on one stack, one at a time. A
+ * member owns the stack from the time it has a message to handle until it
+ * waits for the next ones in the SFN thread loop, when nothing of it is left
+ * on the stack. The manifest tool checks that the members never wait for each
+ * other while they own it.
+ */
+struct stack_group_t {
+    uintptr_t          stack_addr;      /* The shared stack                 */
+    struct partition_t *p_owner;        /* Member running on the stack      */
+    struct partition_t *p_user;         /* Member with its context on it    */
+};
+
+static struct stack_group_t stack_groups[CONFIG_TFM_STACK_GROUP_NUM];
+
+/* The signals the SFN thread loop waits for */
+#define SFN_LOOP_SIGNALS(p_pt)                                              \
+    ((psa_signal_t)((1UL <<                                                 \
+      ((const struct runtime_metadata_t *)(p_pt)->p_metadata)->n_sfn) - 1))
+
+static void stack_group_join(struct partition_t *p_pt)
+{
+    uintptr_t stack_addr = LOAD_ALLOCED_STACK_ADDR(p_pt->p_ldinf);
+    uint32_t i;
+
+    for (i = 0; i < CONFIG_TFM_STACK_GROUP_NUM; i++) {
+        if (stack_groups[i].stack_addr == 0) {
+            stack_groups[i].stack_addr = stack_addr;
+        }
+
+        if (stack_groups[i].stack_addr == stack_addr) {
+            /* The initial context of a member overwrites the previous ones */
+            stack_groups[i].p_user = p_pt;
+            p_pt->p_stack_group = &stack_groups[i];
+            return;
+        }
+    }
+
+    tfm_core_panic();
+}
+
+/*
+ * Take the stack for a member having a message to handle. The member which
+ * used it last resumes its context, the others restart the SFN thread, whose
+ * psa_wait() returns the asserted signals at once. The members never started
+ * restart it from the beginning, to run their init function. Returns false if
+ * another member owns the stack.
+ */
+static bool stack_group_acquire(struct partition_t *p_pt)
+{
+    const struct partition_load_info_t *p_pldi = p_pt->p_ldinf;
+    struct stack_group_t *p_grp = p_pt->p_stack_group;
+    thrd_fn_t thrd_entry;
+
+    if (p_grp->p_owner == p_pt) {
+        return true;
+    } else if (p_grp->p_owner != NULL) {
+        return false;
+    }
+
+    p_grp->p_owner = p_pt;
+
+    if (p_grp->p_user != p_pt) {
+        p_grp->p_user = p_pt;
+
+        if (p_pt->sfn_inited) {
+            thrd_entry = POSITION_TO_ENTRY(common_sfn_thread_loop, thrd_fn_t);
+        } else {
+            thrd_entry = POSITION_TO_ENTRY(common_sfn_thread, thrd_fn_t);
+        }
+
+        ARCH_CTXCTRL_INIT(&p_pt->ctx_ctrl,
+                          LOAD_ALLOCED_STACK_ADDR(p_pldi),
+                          p_pldi->stack_size);
+        tfm_arch_init_context(&p_pt->ctx_ctrl, (uintptr_t)thrd_entry, NULL,
+                              (uintptr_t)THRD_GENERAL_EXIT);
+        p_pt->signals_waiting = 0;
+    }
+
+    return true;
+}
+
+/* Give the stack back once the member waits in the SFN thread loop */
+static void stack_group_release(struct partition_t *p_pt)
+{
+    struct partition_t *p_member;
+
+    p_pt->p_stack_group->p_owner = NULL;
+    p_pt->sfn_inited = true;
+
+    /* Let the scheduler check the members waiting for the stack */
+    UNI_LIST_FOREACH(p_member, PARTITION_LIST_ADDR, next) {
+        if ((p_member != p_pt) &&
+            (p_member->p_stack_group == p_pt->p_stack_group)) {
+            thrd_mark_ready(&p_member->thrd);
+        }
+    }
+}
+#endif /* CONFIG_TFM_STACK_GROUP_NUM > 0 */
+
 /*
  * Query the state of current thread.
  */
@@ -68,6 +181,25 @@ static uint32_t query_state(struct thread_t *p_thrd, uint32_t *p_retval)
 
     CRITICAL_SECTION_ENTER(cs_signal);
 
+#if CONFIG_TFM_STACK_GROUP_NUM > 0
+    /*
+     * A member of a stack group starting, or with a message to handle, only
+     * runs once it owns the stack.
+     */
+    if (p_pt->p_stack_group &&
+        ((p_pt->signals_waiting == 0) ||
+         (p_pt->signals_waiting & p_pt->signals_asserted))) {
+        if (!stack_group_acquire(p_pt)) {
+            CRITICAL_SECTION_LEAVE(cs_signal);
+            return THRD_STATE_BLOCK;
+        }
+
+        if (p_pt->signals_waiting == 0) {
+            state = THRD_STATE_RUNNABLE;
+        }
+    }
+#endif
+
     signal_ret = p_pt->signals_waiting & p_pt->signals_asserted;
 
     if (signal_ret) {
@@ -84,6 +216,21 @@ static uint32_t query_state(struct thread_t *p_thrd, uint32_t *p_retval)
             p_pt->signals_asserted &= ~TFM_IPC_REPLY_SIGNAL;
             *p_retval = (uint32_t)p_pt->reply_value;
         } else {
+#if CONFIG_TFM_SPM_TIMER == 1
+            /*
+             * A timed psa_wait() returns the asserted signals it waits for,
+             * or 0 if only its timer expired.
+             */
+            if (p_pt->signals_waiting & TFM_TIMER_SIGNAL) {
+                spm_timer_stop(&p_pt->timer);
+                p_pt->signals_asserted &= ~TFM_TIMER_SIGNAL;
+                signal_ret &= ~TFM_TIMER_SIGNAL;
+            }
+#endif
+#if CONFIG_TFM_WORKQ == 1
+            /* The idle Partition asserts it again while work is queued */
+            p_pt->signals_asserted &= ~(signal_ret & TFM_WORKQ_SIGNAL);
+#endif
             *p_retval = signal_ret;
         }
 
@@ -101,55 +248,50 @@ static uint32_t query_state(struct thread_t *p_thrd, uint32_t *p_retval)
     return state;
 }
 
-extern struct psa_api_tbl_t psa_api_cross;
-extern struct psa_api_tbl_t psa_api_svc;
-
-static void prv_process_metadata(struct partition_t *p_pt)
+#if CONFIG_TFM_PRIORITY_DONATION == 1
+/*
+ * Raise the priority of the server to the priority of the client, so the
+ * message is not handled behind threads of lower priority than the client.
+ * The donation is a single hop: a server already blocked in a call of its
+ * own does not pass it on, only the messages it sends later carry it.
+ */
+static void donate_priority(struct partition_t *p_server,
+                            const struct partition_t *p_client)
 {
-    const struct partition_load_info_t *p_pt_ldi;
-    const struct service_load_info_t *p_srv_ldi;
-    struct context_ctrl_t *ctx_ctrl;
-    struct runtime_metadata_t *p_rt_meta;
-    service_fn_t *p_sfn_table;
-    uint32_t allocate_size;
-
-    p_pt_ldi = p_pt->p_ldinf;
-    p_srv_ldi = LOAD_INFO_SERVICE(p_pt_ldi);
-    ctx_ctrl = &p_pt->ctx_ctrl;
-
-    /* common runtime metadata */
-    allocate_size = sizeof(*p_rt_meta);
-
-    if (!IS_IPC_MODEL(p_pt_ldi)) {
-        /* SFN specific metadata - SFN function table */
-        allocate_size += sizeof(service_fn_t) * p_pt_ldi->nservices;
+    if (p_client->thrd.priority < p_server->thrd.priority) {
+        thrd_set_priority(&p_server->thrd, p_client->thrd.priority);
     }
+}
 
-    ARCH_CTXCTRL_ALLOCATE_STACK(ctx_ctrl, allocate_size);
-    p_rt_meta = (struct runtime_metadata_t *)
-                                    ARCH_CTXCTRL_ALLOCATED_PTR(ctx_ctrl);
-
-    p_rt_meta->entry = p_pt_ldi->entry;
-#if TFM_LVL == 1
-    p_rt_meta->psa_fns = &psa_api_cross;
-#else
-    /* TODO: ABI for PRoT partitions needs to be updated based on implementations. */
-    p_rt_meta->psa_fns = &psa_api_svc;
-#endif
-    p_rt_meta->n_sfn = 0;
-    p_sfn_table = p_rt_meta->sfn_table;
-
-    if (!IS_IPC_MODEL(p_pt_ldi)) {
-        /* SFN table. The signal bit of the service is the same index of SFN. */
-        for (int i = 0; i < p_pt_ldi->nservices; i++) {
-            p_sfn_table[i] = (service_fn_t)p_srv_ldi[i].sfn;
+/*
+ * Return the server to its own priority, or to the highest priority of the
+ * clients which still have messages queued to its services. Only the queued
+ * messages are counted: a message the server has got but not replied to yet
+ * does not keep the priority of its client.
+ */
+static void restore_priority(struct partition_t *p_server)
+{
+    struct critical_section_t cs_msgq = CRITICAL_SECTION_STATIC_INIT;
+    const struct connection_t *p_conn;
+    uint8_t priority;
+    uint32_t i;
+
+    priority = TO_THREAD_PRIORITY(PARTITION_PRIORITY(p_server->p_ldinf->flags));
+
+    CRITICAL_SECTION_ENTER(cs_msgq);
+    for (i = 0; i < p_server->p_ldinf->nservices; i++) {
+        for (p_conn = p_server->p_services[i].p_msgq_head;
+             p_conn != NULL; p_conn = p_conn->p_handles) {
+            if (p_conn->p_client->thrd.priority < priority) {
+                priority = p_conn->p_client->thrd.priority;
+            }
         }
-
-        p_rt_meta->n_sfn = p_pt_ldi->nservices;
     }
+    CRITICAL_SECTION_LEAVE(cs_msgq);
 
-    p_pt->p_metadata = (void *)p_rt_meta;
+    thrd_set_priority(&p_server->thrd, priority);
 }
+#endif /* CONFIG_TFM_PRIORITY_DONATION == 1 */
 
 /*
  * Send message and wake up the SP who is waiting on message queue, block the
@@ -160,6 +302,7 @@ psa_status_t backend_messaging(struct service_t *service,
 {
     struct partition_t *p_owner = NULL;
     psa_signal_t signal = 0;
+    struct critical_section_t cs_msgq = CRITICAL_SECTION_STATIC_INIT;
 
     if (!handle || !service || !service->p_ldinf || !service->partition) {
         return PSA_ERROR_PROGRAMMER_ERROR;
@@ -168,7 +311,26 @@ psa_status_t backend_messaging(struct service_t *service,
     p_owner = service->partition;
     signal = service->p_ldinf->signal;
 
-    UNI_LIST_INSERT_AFTER(p_owner, handle, p_handles);
+    /* Append the message to the tail of the service message queue. */
+    handle->p_handles = NULL;
+
+    CRITICAL_SECTION_ENTER(cs_msgq);
+    if (service->p_msgq_tail) {
+        service->p_msgq_tail->p_handles = handle;
+    } else {
+        service->p_msgq_head = handle;
+    }
+    service->p_msgq_tail = handle;
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+    if (++service->msgq_depth > service->stat.queue_hwm) {
+        service->stat.queue_hwm = service->msgq_depth;
+    }
+#endif
+    CRITICAL_SECTION_LEAVE(cs_msgq);
+
+#if CONFIG_TFM_PRIORITY_DONATION == 1
+    donate_priority(p_owner, handle->p_client);
+#endif
 
     /* Messages put. Update signals */
     backend_assert_signal(p_owner, signal);
@@ -189,6 +351,10 @@ psa_status_t backend_messaging(struct service_t *service,
 
 psa_status_t backend_replying(struct connection_t *handle, int32_t status)
 {
+#if CONFIG_TFM_PRIORITY_DONATION == 1
+    restore_priority(handle->service->partition);
+#endif
+
     if (is_tfm_rpc_msg(handle)) {
         tfm_rpc_client_call_reply(handle, status);
     } else {
@@ -204,8 +370,6 @@ psa_status_t backend_replying(struct connection_t *handle, int32_t status)
     return PSA_SUCCESS;
 }
 
-extern void common_sfn_thread(void *param);
-
 /* Parameters are treated as assuredly */
 void backend_init_comp_assuredly(struct partition_t *p_pt,
                                  uint32_t service_setting)
@@ -213,6 +377,7 @@ void backend_init_comp_assuredly(struct partition_t *p_pt,
     const struct partition_load_info_t *p_pldi = p_pt->p_ldinf;
     thrd_fn_t thrd_entry;
     void *param = NULL;
+    uint8_t priority;
 
 #if CONFIG_TFM_DOORBELL_API == 1
     p_pt->signals_allowed |= PSA_DOORBELL;
@@ -228,10 +393,28 @@ void backend_init_comp_assuredly(struct partition_t *p_pt,
 
     watermark_stack(p_pt);
 
-    prv_process_metadata(p_pt);
+    /* The runtime metadata is generated with the load information */
+    p_pt->p_metadata = (void *)LOAD_RUNTIME_METADATA_ADDR(p_pldi);
+
+    priority = TO_THREAD_PRIORITY(PARTITION_PRIORITY(p_pldi->flags));
+#if CONFIG_TFM_PRIORITY_DONATION == 1
+    /*
+     * Initialize the Partition in the background. It has the priority of NS
+     * Agent TZ, which is started after it and so is scheduled first, until it
+     * replies to its first message. Its clients donate their priority to it
+     * meanwhile.
+     */
+    if (IS_LAZY_INIT(p_pldi)) {
+        priority = TO_THREAD_PRIORITY(PARTITION_PRI_LOWEST - 1);
+    }
+#endif
 
-    THRD_INIT(&p_pt->thrd, &p_pt->ctx_ctrl,
-              TO_THREAD_PRIORITY(PARTITION_PRIORITY(p_pldi->flags)));
+    THRD_INIT(&p_pt->thrd, &p_pt->ctx_ctrl, priority);
+
+    if (PARTITION_CORE_ID(p_pldi->flags) >= CONFIG_TFM_SPM_SECURE_CORE_NUM) {
+        tfm_core_panic();
+    }
+    THRD_SET_CORE(&p_pt->thrd, PARTITION_CORE_ID(p_pldi->flags));
 
 #if (CONFIG_TFM_PSA_API_CROSS_CALL == 1)
     if (IS_NS_AGENT_TZ(p_pldi)) {
@@ -257,6 +440,14 @@ void backend_init_comp_assuredly(struct partition_t *p_pt,
                thrd_entry,
                THRD_GENERAL_EXIT,
                param);
+
+#if CONFIG_TFM_STACK_GROUP_NUM > 0
+    p_pt->p_stack_group = NULL;
+    p_pt->sfn_inited = false;
+    if (IS_SHARED_STACK(p_pldi)) {
+        stack_group_join(p_pt);
+    }
+#endif
 }
 
 uint32_t backend_system_run(void)
@@ -300,6 +491,11 @@ psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals
     ret_signal = p_pt->signals_asserted & signals;
     if (ret_signal == 0) {
         p_pt->signals_waiting = signals;
+#if CONFIG_TFM_STACK_GROUP_NUM > 0
+        if (p_pt->p_stack_group && (signals == SFN_LOOP_SIGNALS(p_pt))) {
+            stack_group_release(p_pt);
+        }
+#endif
     }
 
     CRITICAL_SECTION_LEAVE(cs_signal);
@@ -307,6 +503,44 @@ psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals
     return ret_signal;
 }
 
+#if CONFIG_TFM_SPM_TIMER == 1
+psa_signal_t backend_wait_signals_timed(struct partition_t *p_pt,
+                                        psa_signal_t signals,
+                                        uint32_t ticks)
+{
+    struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
+    psa_signal_t ret_signal;
+
+    if (!p_pt) {
+        tfm_core_panic();
+    }
+
+    CRITICAL_SECTION_ENTER(cs_signal);
+
+    ret_signal = p_pt->signals_asserted & signals & ~TFM_TIMER_SIGNAL;
+    if (ret_signal == 0) {
+        p_pt->signals_asserted &= ~TFM_TIMER_SIGNAL;
+        p_pt->signals_waiting = signals | TFM_TIMER_SIGNAL;
+        spm_timer_start(&p_pt->timer, ticks);
+    }
+
+    CRITICAL_SECTION_LEAVE(cs_signal);
+
+    return ret_signal;
+}
+#endif
+
+#if CONFIG_TFM_PREEMPTION_POINTS == 1
+void backend_yield(struct partition_t *p_pt)
+{
+    if (!p_pt) {
+        tfm_core_panic();
+    }
+
+    thrd_yield(&p_pt->thrd);
+}
+#endif
+
 uint32_t backend_assert_signal(struct partition_t *p_pt, psa_signal_t signal)
 {
     struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
@@ -319,6 +553,16 @@ uint32_t backend_assert_signal(struct partition_t *p_pt, psa_signal_t signal)
     p_pt->signals_asserted |= signal;
     CRITICAL_SECTION_LEAVE(cs_signal);
 
+    /* The partition may be waiting for this signal, let scheduler check it. */
+    thrd_mark_ready(&p_pt->thrd);
+
+#if CONFIG_TFM_SPM_SECURE_CORE_NUM > 1
+    /* A Partition of another core is scheduled by that core */
+    if (THRD_CORE(&p_pt->thrd) != SPM_CORE_ID()) {
+        tfm_hal_notify_secure_core(THRD_CORE(&p_pt->thrd));
+    }
+#endif
+
     return PSA_SUCCESS;
 }
 
@@ -328,9 +572,16 @@ uint64_t ipc_schedule(void)
     AAPCS_DUAL_U32_T ctx_ctrls;
     struct partition_t *p_part_curr, *p_part_next;
     struct context_ctrl_t *p_curr_ctx;
-    struct thread_t *pth_next = thrd_next();
+    struct thread_t *pth_next;
     struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
 
+    SPM_CORE_LOCK();
+
+    pth_next = thrd_next();
+
+    /* One doorbell for the NSPE replies made during the ending pass */
+    tfm_rpc_client_call_flush();
+
     p_curr_ctx = (struct context_ctrl_t *)(CURRENT_THREAD->p_context_ctrl);
 
     AAPCS_DUAL_U32_SET(ctx_ctrls, (uint32_t)p_curr_ctx, (uint32_t)p_curr_ctx);
@@ -359,17 +610,29 @@ uint64_t ipc_schedule(void)
                 tfm_core_panic();
             }
         }
-        ARCH_FLUSH_FP_CONTEXT();
+        /*
+         * Only a Partition using the FPU can have a lazy FP context pending
+         * on its stack, so the flush is skipped for the others.
+         */
+        if (USES_FPU(p_part_curr->p_ldinf)) {
+            ARCH_FLUSH_FP_CONTEXT();
+        }
 
         AAPCS_DUAL_U32_SET_A1(ctx_ctrls, (uint32_t)pth_next->p_context_ctrl);
 
         CURRENT_THREAD = pth_next;
         CRITICAL_SECTION_LEAVE(cs);
+
+        SPM_TRACE(SPM_TRACE_EVT_SCHEDULE, p_part_curr->p_ldinf->pid,
+                  p_part_next->p_ldinf->pid);
     }
 
     /* Update meta indicator */
     if (partition_meta_indicator_pos && (p_part_next->p_metadata)) {
         *partition_meta_indicator_pos = (uintptr_t)(p_part_next->p_metadata);
     }
+
+    SPM_CORE_UNLOCK();
+
     return AAPCS_DUAL_U32_AS_U64(ctx_ctrls);
 }
@@ -21,6 +21,11 @@
 #include "psa/error.h"
 #include "psa/service.h"
 #include "spm.h"
+#ifdef TFM_BOOT_TIMING
+#include "cycle_counter.h"
+#include "ffm/tfm_boot_data.h"
+#include "tfm_boot_status.h"
+#endif
 
 /* SFN Partition state */
 #define SFN_PARTITION_STATE_NOT_INITED        0
@@ -90,6 +95,9 @@ static uint32_t spm_thread_fn(uint32_t param)
 {
     struct partition_t *p_part, *p_curr;
     psa_status_t status;
+#ifdef TFM_BOOT_TIMING
+    uint8_t init_index = 0;
+#endif
 
     p_curr = GET_CURRENT_COMPONENT();
     /* Call partition initialization routine one by one. */
@@ -98,6 +106,11 @@ static uint32_t spm_thread_fn(uint32_t param)
             continue;
         }
 
+        /* Initialized by backend_messaging() on the first message instead */
+        if (IS_LAZY_INIT(p_part->p_ldinf)) {
+            continue;
+        }
+
         if (p_part->state == SFN_PARTITION_STATE_INITED) {
             continue;
         }
@@ -112,6 +125,13 @@ static uint32_t spm_thread_fn(uint32_t param)
         }
 
         p_part->state = SFN_PARTITION_STATE_INITED;
+
+#ifdef TFM_BOOT_TIMING
+        tfm_core_add_boot_timestamp(BOOT_TIMING_SPM_PARTITION_INIT,
+                                    init_index++,
+                                    (uint32_t)p_part->p_ldinf->pid,
+                                    cycle_counter_read());
+#endif
     }
 
     SET_CURRENT_COMPONENT(p_curr);
@@ -157,9 +177,16 @@ uint32_t backend_system_run(void)
 
 psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals)
 {
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+    /* Run-to-completion services never block */
+    if (!(p_pt->signals_asserted & signals)) {
+        tfm_core_panic();
+    }
+#else
     while (!(p_pt->signals_asserted & signals)) {
         __WFI();
     }
+#endif
 
     return p_pt->signals_asserted & signals;
 }
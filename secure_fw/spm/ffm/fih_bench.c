@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "config_spm.h"
+
+#if CONFIG_TFM_FIH_BENCH == 1
+#include "ffm/fih_bench_body.h"
+#include "tfm_spm_log.h"
+
+void fih_bench_boot(struct fih_bench_result_t *result)
+{
+    fih_bench_measure(result);
+}
+
+void fih_bench_report(void)
+{
+    struct fih_bench_result_t boot;
+    struct fih_bench_result_t runtime;
+
+    cycle_counter_enable();
+
+    fih_bench_boot(&boot);
+    fih_bench_runtime(&runtime);
+
+    SPMLOG_INFMSGVAL("[FIH] Boot path FIH_CALL cycles: ", boot.call_cycles);
+    SPMLOG_INFMSGVAL("[FIH] Boot path fih_eq cycles: ", boot.eq_cycles);
+    SPMLOG_INFMSGVAL("[FIH] Runtime path FIH_CALL cycles: ",
+                     runtime.call_cycles);
+    SPMLOG_INFMSGVAL("[FIH] Runtime path fih_eq cycles: ", runtime.eq_cycles);
+}
+#endif /* CONFIG_TFM_FIH_BENCH == 1 */
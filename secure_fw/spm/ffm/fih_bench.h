@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FIH_BENCH_H__
+#define __FIH_BENCH_H__
+
+#include <stdint.h>
+#include "config_spm.h"
+
+#if CONFIG_TFM_FIH_BENCH == 1
+/* Mean cycles of the FIH primitives, with the FIH profile of one module */
+struct fih_bench_result_t {
+    uint32_t call_cycles;   /* FIH_CALL of a function that only FIH_RETs */
+    uint32_t eq_cycles;     /* fih_eq() of two fih_int */
+};
+
+/* Measure with TFM_FIH_PROFILE, the profile of the SPM boot path. */
+void fih_bench_boot(struct fih_bench_result_t *result);
+
+/* Measure with TFM_FIH_PROFILE_RUNTIME, the profile of the runtime path. */
+void fih_bench_runtime(struct fih_bench_result_t *result);
+
+/* Measure with both profiles and log the results. */
+void fih_bench_report(void);
+#else
+#define fih_bench_report()
+#endif
+
+#endif /* __FIH_BENCH_H__ */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FIH_BENCH_BODY_H__
+#define __FIH_BENCH_BODY_H__
+
+/*
+ * The body of the FIH measurement. The FIH macros expand with the profile of
+ * the source including it, so it is only included by fih_bench.c, built with
+ * TFM_FIH_PROFILE, and fih_bench_runtime.c, built with the runtime profile.
+ */
+
+#include <stdint.h>
+#include "cycle_counter.h"
+#include "fih.h"
+#include "ffm/fih_bench.h"
+
+#define FIH_BENCH_ITERATIONS    64
+
+static __attribute__((noinline)) FIH_RET_TYPE(int32_t) fih_bench_ret(void)
+{
+    FIH_RET(FIH_SUCCESS);
+}
+
+static void fih_bench_measure(struct fih_bench_result_t *result)
+{
+    fih_int fih_rc = FIH_FAILURE;
+    volatile fih_int a = FIH_SUCCESS;
+    volatile fih_int b = FIH_SUCCESS;
+    volatile uint32_t eq = 0;
+    uint32_t start;
+    uint32_t i;
+
+    start = cycle_counter_read();
+    for (i = 0; i < FIH_BENCH_ITERATIONS; i++) {
+        FIH_CALL(fih_bench_ret, fih_rc);
+    }
+    result->call_cycles = (cycle_counter_read() - start) /
+                          FIH_BENCH_ITERATIONS;
+
+    start = cycle_counter_read();
+    for (i = 0; i < FIH_BENCH_ITERATIONS; i++) {
+        eq += (uint32_t)fih_eq(a, b);
+    }
+    result->eq_cycles = (cycle_counter_read() - start) / FIH_BENCH_ITERATIONS;
+
+    (void)fih_rc;
+}
+
+#endif /* __FIH_BENCH_BODY_H__ */
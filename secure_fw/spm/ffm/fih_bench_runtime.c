@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "config_spm.h"
+
+#if CONFIG_TFM_FIH_BENCH == 1
+#include "ffm/fih_bench_body.h"
+
+/* Built with the runtime path profile, see secure_fw/spm/CMakeLists.txt */
+void fih_bench_runtime(struct fih_bench_result_t *result)
+{
+    fih_bench_measure(result);
+}
+#endif /* CONFIG_TFM_FIH_BENCH == 1 */
@@ -8,10 +8,14 @@
  *
  */
 
+#include <stdbool.h>
 #include "interrupt.h"
 
 #include "bitops.h"
+#include "cmsis.h"
+#include "critical_section.h"
 #include "current.h"
+#include "spm_secure_cores.h"
 #include "svc_num.h"
 #include "tfm_arch.h"
 #include "tfm_hal_interrupt.h"
@@ -21,6 +25,8 @@
 
 #include "load/spm_load_api.h"
 #include "ffm/backend.h"
+#include "cycle_counter.h"
+#include "ffm/spm_trace.h"
 
 extern uintptr_t spm_boundary;
 
@@ -44,6 +50,7 @@ uint32_t tfm_flih_prepare_depriv_flih(struct partition_t *p_owner_sp,
     uintptr_t sp_base, sp_limit, curr_stack, ctx_stack;
     struct context_ctrl_t flih_ctx_ctrl;
     fih_int fih_rc = FIH_FAILURE;
+    bool switch_boundary;
 
     /* Come too early before runtime setup, should not happen. */
     if (!CURRENT_THREAD) {
@@ -64,8 +71,13 @@ uint32_t tfm_flih_prepare_depriv_flih(struct partition_t *p_owner_sp,
                  ((struct context_ctrl_t *)p_owner_sp->thrd.p_context_ctrl)->sp;
     }
 
-    if (tfm_hal_boundary_need_switch(p_curr_sp->boundary,
-                                     p_owner_sp->boundary)) {
+    /*
+     * The MPU is only reprogrammed if the interrupted component runs in a
+     * different boundary, typically it is the owner or shares its domain.
+     */
+    switch_boundary = tfm_hal_boundary_need_switch(p_curr_sp->boundary,
+                                                   p_owner_sp->boundary);
+    if (switch_boundary) {
         FIH_CALL(tfm_hal_activate_boundary, fih_rc,
                  p_owner_sp->p_ldinf, p_owner_sp->boundary);
     }
@@ -85,6 +97,9 @@ uint32_t tfm_flih_prepare_depriv_flih(struct partition_t *p_owner_sp,
 
     (void)tfm_arch_refresh_hardware_context(&flih_ctx_ctrl);
 
+    SPM_TRACE(SPM_TRACE_EVT_FLIH_HANDLER, p_owner_sp->p_ldinf->pid,
+              switch_boundary);
+
     return flih_ctx_ctrl.exc_ret;
 }
 
@@ -138,6 +153,156 @@ const struct irq_load_info_t *get_irq_info_for_signal(
     return NULL;
 }
 
+#if CONFIG_TFM_IRQ_COALESCE == 1
+#if CONFIG_TFM_SPM_TIMER == 1
+/* The time window is counted in secure ticks, rounded up */
+#define COALESCE_STAMP()        spm_ticks
+#define COALESCE_WINDOW(us)     ((((uint64_t)(us) *                           \
+                                   CONFIG_TFM_SPM_TIMER_TICK_HZ) + 999999) /  \
+                                 1000000)
+
+/* Partial batches with a time window, checked by the secure tick */
+static struct irq_coalesce_t *coalesce_timed_list;
+
+/* Unlink a batch from the timed list. To be called in a critical section. */
+static void irq_coalesce_unlink(struct irq_coalesce_t *p_co)
+{
+    struct irq_coalesce_t **pp_link = &coalesce_timed_list;
+
+    while (*pp_link != NULL) {
+        if (*pp_link == p_co) {
+            *pp_link = p_co->next;
+            break;
+        }
+        pp_link = &(*pp_link)->next;
+    }
+
+    p_co->next = NULL;
+}
+#else
+/* Without a secure tick, the time window is checked when an event arrives */
+#define COALESCE_STAMP()        cycle_counter_read()
+#define COALESCE_WINDOW(us)     (((uint64_t)(us) * SystemCoreClock) / 1000000)
+#endif
+
+/* Check if the time window of a partial batch has elapsed */
+static bool irq_coalesce_expired(const struct irq_coalesce_t *p_co,
+                                 uint32_t now)
+{
+    if (p_co->p_ildi->coalesce_us == 0) {
+        return false;
+    }
+
+    return (uint64_t)(uint32_t)(now - p_co->first_stamp) >=
+           COALESCE_WINDOW(p_co->p_ildi->coalesce_us);
+}
+
+/*
+ * Account one event of a coalescing interrupt. Returns true if the pending
+ * events are to be delivered as one signal now.
+ */
+static bool irq_coalesce_event(void *p_pt,
+                               const struct irq_load_info_t *p_ildi)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct irq_coalesce_t *p_co = p_ildi->p_coalesce;
+    uint32_t now = COALESCE_STAMP();
+    bool deliver;
+
+    CRITICAL_SECTION_ENTER(cs);
+
+    if (p_co->pending == 0) {
+        p_co->p_pt = p_pt;
+        p_co->p_ildi = p_ildi;
+        p_co->first_stamp = now;
+#if CONFIG_TFM_SPM_TIMER == 1
+        if (p_ildi->coalesce_us != 0) {
+            p_co->next = coalesce_timed_list;
+            coalesce_timed_list = p_co;
+        }
+#endif
+    }
+    p_co->pending++;
+
+    deliver = (p_co->pending >= p_ildi->coalesce_count) ||
+              irq_coalesce_expired(p_co, now);
+    if (deliver) {
+        p_co->delivered += p_co->pending;
+        p_co->pending = 0;
+#if CONFIG_TFM_SPM_TIMER == 1
+        if (p_ildi->coalesce_us != 0) {
+            irq_coalesce_unlink(p_co);
+        }
+#endif
+    }
+
+    CRITICAL_SECTION_LEAVE(cs);
+
+    return deliver;
+}
+
+#if CONFIG_TFM_SPM_TIMER == 1
+void spm_irq_coalesce_tick(void)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct irq_coalesce_t **pp_link = &coalesce_timed_list;
+    struct irq_coalesce_t *p_co;
+    uint32_t now = spm_ticks;
+
+    CRITICAL_SECTION_ENTER(cs);
+
+    while ((p_co = *pp_link) != NULL) {
+        if (!irq_coalesce_expired(p_co, now)) {
+            pp_link = &p_co->next;
+            continue;
+        }
+
+        *pp_link = p_co->next;
+        p_co->next = NULL;
+
+        p_co->delivered += p_co->pending;
+        p_co->pending = 0;
+
+        /* As for a complete batch, the SLIH source waits for psa_eoi() */
+        if (p_co->p_ildi->flih_func == NULL) {
+            tfm_hal_irq_disable(p_co->p_ildi->source);
+        }
+        backend_assert_signal(p_co->p_pt, p_co->p_ildi->signal);
+    }
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+#endif
+#endif /* CONFIG_TFM_IRQ_COALESCE == 1 */
+
+void tfm_core_get_irq_event_count_handler(uint32_t *svc_args)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    const struct irq_load_info_t *p_ildi;
+    struct partition_t *p_part;
+    uint32_t count;
+
+    p_part = GET_CURRENT_COMPONENT();
+
+    p_ildi = get_irq_info_for_signal(p_part->p_ldinf,
+                                     (psa_signal_t)svc_args[0]);
+    if (!p_ildi) {
+        tfm_core_panic();
+    }
+
+    if (!p_ildi->p_coalesce) {
+        svc_args[0] = 1;
+        return;
+    }
+
+    CRITICAL_SECTION_ENTER(cs);
+    count = p_ildi->p_coalesce->delivered;
+    p_ildi->p_coalesce->delivered = 0;
+    CRITICAL_SECTION_LEAVE(cs);
+
+    svc_args[0] = count;
+}
+
 void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi)
 {
     psa_flih_result_t flih_result;
@@ -153,17 +318,23 @@ void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi)
         tfm_core_panic();
     }
 
+    SPM_CORE_LOCK();
+
     if (p_ildi->flih_func == NULL) {
         /* SLIH Model Handling */
         tfm_hal_irq_disable(p_ildi->source);
         flih_result = PSA_FLIH_SIGNAL;
+        SPM_TRACE(SPM_TRACE_EVT_SLIH, p_ildi->pid, p_ildi->signal);
     } else {
         /* FLIH Model Handling */
+        SPM_TRACE(SPM_TRACE_EVT_FLIH_ENTER, p_ildi->pid, p_ildi->signal);
 #if TFM_LVL == 1
+        SPM_TRACE(SPM_TRACE_EVT_FLIH_HANDLER, p_ildi->pid, 0);
         flih_result = p_ildi->flih_func();
 #else
         if (!tfm_hal_boundary_need_switch(spm_boundary,
                                          p_part->boundary)) {
+            SPM_TRACE(SPM_TRACE_EVT_FLIH_HANDLER, p_ildi->pid, 0);
             flih_result = p_ildi->flih_func();
         } else {
             flih_result = tfm_flih_deprivileged_handling(
@@ -172,8 +343,21 @@ void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi)
                                                 GET_CURRENT_COMPONENT());
         }
 #endif
+        SPM_TRACE(SPM_TRACE_EVT_FLIH_EXIT, p_ildi->pid, flih_result);
     }
 
+#if CONFIG_TFM_IRQ_COALESCE == 1
+    if (flih_result == PSA_FLIH_SIGNAL && p_ildi->p_coalesce &&
+        !irq_coalesce_event(p_pt, p_ildi)) {
+        /* Batch not complete, keep a SLIH source running for the next one */
+        if (p_ildi->flih_func == NULL) {
+            tfm_hal_irq_enable(p_ildi->source);
+        }
+        SPM_CORE_UNLOCK();
+        return;
+    }
+#endif
+
     if (flih_result == PSA_FLIH_SIGNAL) {
         backend_assert_signal(p_pt, p_ildi->signal);
         /* In SFN backend, there is only one thread, no thread switch. */
@@ -183,4 +367,6 @@ void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi)
         }
 #endif
     }
+
+    SPM_CORE_UNLOCK();
 }
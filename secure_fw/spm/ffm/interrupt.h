@@ -44,6 +44,23 @@ const struct irq_load_info_t *get_irq_info_for_signal(
  */
 void spm_handle_interrupt(void *p_pt, const struct irq_load_info_t *p_ildi);
 
+/*
+ * SVC handler of tfm_core_get_irq_event_count(). Returns in svc_args[0] the
+ * number of events delivered by the IRQ signal in svc_args[0] since the last
+ * call and clears it. Non-coalescing IRQs always report 1.
+ */
+void tfm_core_get_irq_event_count_handler(uint32_t *svc_args);
+
+#if (CONFIG_TFM_IRQ_COALESCE == 1) && (CONFIG_TFM_SPM_TIMER == 1)
+/*
+ * Deliver the partial batches of the coalescing IRQs whose time window has
+ * elapsed. Called by the secure tick handler out of its critical section. The
+ * batches are updated in a critical section of their own, as the coalescing
+ * IRQs can preempt the tick.
+ */
+void spm_irq_coalesce_tick(void);
+#endif
+
 /*
  * Prepare execution context for deprivileged FLIH functions
  * Parameters:
@@ -23,6 +23,9 @@
 #include "utilities.h"
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
+#include "ffm/service_stats.h"
+#include "ffm/spm_trace.h"
+#include "ffm/stack_watermark.h"
 #include "tfm_rpc.h"
 #include "tfm_api.h"
 #include "tfm_hal_platform.h"
@@ -58,12 +61,49 @@ psa_signal_t tfm_spm_partition_psa_wait(psa_signal_t signal_mask,
                                         uint32_t timeout)
 {
     struct partition_t *partition = NULL;
+#if CONFIG_TFM_WORKQ == 1
+    struct critical_section_t cs_signal = CRITICAL_SECTION_STATIC_INIT;
+#endif
+
+#if CONFIG_TFM_WORKQ == 1
+    /*
+     * TFM_WAIT_WORKQ is a flag, not part of the timeout. Only the Partitions
+     * with deferred work are woken up by the idle Partition.
+     */
+    if (timeout & TFM_WAIT_WORKQ) {
+        signal_mask |= TFM_WORKQ_SIGNAL;
+    } else {
+        signal_mask &= ~TFM_WORKQ_SIGNAL;
+    }
+    timeout &= ~TFM_WAIT_WORKQ;
+#endif
 
+#if CONFIG_TFM_PREEMPTION_POINTS == 1
+    /*
+     * TFM_WAIT_YIELD is a flag, not part of the timeout. The other runnable
+     * Partitions of the same priority run before the caller continues.
+     */
+    if (timeout & TFM_WAIT_YIELD) {
+        backend_yield(GET_CURRENT_COMPONENT());
+    }
+    timeout &= ~TFM_WAIT_YIELD;
+#endif
+
+#if CONFIG_TFM_SPM_TIMER == 1
+    /*
+     * Timeout[30:0] are reserved by FF-M. As a TF-M extension, they are the
+     * number of secure ticks to wait for when PSA_BLOCK is not set.
+     */
+    if (timeout & PSA_TIMEOUT_MASK) {
+        timeout = PSA_BLOCK;
+    }
+#else
     /*
      * Timeout[30:0] are reserved for future use.
      * SPM must ignore the value of RES.
      */
     timeout &= PSA_TIMEOUT_MASK;
+#endif
 
     partition = GET_CURRENT_COMPONENT();
 
@@ -85,8 +125,22 @@ psa_signal_t tfm_spm_partition_psa_wait(psa_signal_t signal_mask,
      */
     if (timeout == PSA_BLOCK) {
         return backend_wait_signals(partition, signal_mask);
+#if CONFIG_TFM_SPM_TIMER == 1
+    } else if (timeout != PSA_POLL) {
+        return backend_wait_signals_timed(partition, signal_mask, timeout);
+#endif
     } else {
+#if CONFIG_TFM_WORKQ == 1
+        CRITICAL_SECTION_ENTER(cs_signal);
+        signal_mask &= partition->signals_asserted;
+        /* It is consumed as when it wakes up a blocked wait */
+        partition->signals_asserted &= ~(signal_mask & TFM_WORKQ_SIGNAL);
+        CRITICAL_SECTION_LEAVE(cs_signal);
+
+        return signal_mask;
+#else
         return partition->signals_asserted & signal_mask;
+#endif
     }
 }
 #endif
@@ -158,6 +212,8 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
     psa_status_t ret = PSA_SUCCESS;
     struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
 
+    SPM_TRACE(SPM_TRACE_EVT_REPLY_ENTER, msg_handle, status);
+
     /* It is a fatal error if message handle is invalid */
     handle = spm_msg_handle_to_connection(msg_handle);
     if (!handle) {
@@ -187,9 +243,11 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
             /* Refuse the client connection, indicating a permanent error. */
             ret = PSA_ERROR_CONNECTION_REFUSED;
             handle->status = TFM_HANDLE_STATUS_TO_FREE;
+            spm_stats_rejected(service);
         } else if (status == PSA_ERROR_CONNECTION_BUSY) {
             /* Fail the client connection, indicating a transient error. */
             ret = PSA_ERROR_CONNECTION_BUSY;
+            spm_stats_rejected(service);
         } else {
             tfm_core_panic();
         }
@@ -238,6 +296,8 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
              * psa_call().
              */
             update_caller_outvec_len(handle);
+            spm_stats_call_end(handle);
+            stack_profile_reply(service, handle->msg.type);
             if (SERVICE_IS_STATELESS(service->p_ldinf->flags)) {
                 handle->status = TFM_HANDLE_STATUS_TO_FREE;
             }
@@ -271,6 +331,8 @@ psa_status_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
         handle->status = TFM_HANDLE_STATUS_IDLE;
     }
 
+    SPM_TRACE(SPM_TRACE_EVT_REPLY_EXIT, msg_handle, ret);
+
     return ret;
 }
 
@@ -282,6 +344,35 @@ void tfm_spm_partition_psa_notify(int32_t partition_id)
     backend_assert_signal(p_pt, PSA_DOORBELL);
 }
 
+void tfm_core_notify_multi_handler(uint32_t *svc_args)
+{
+    const int32_t *p_pids = (const int32_t *)svc_args[0];
+    uint32_t num = svc_args[1];
+    struct partition_t *p_curr = GET_CURRENT_COMPONENT();
+    fih_int fih_rc = FIH_FAILURE;
+    uint32_t i;
+
+    if (num > UINT32_MAX / sizeof(int32_t)) {
+        tfm_core_panic();
+    }
+
+    FIH_CALL(tfm_hal_memory_check, fih_rc,
+             p_curr->boundary, (uintptr_t)p_pids,
+             num * sizeof(int32_t), TFM_HAL_ACCESS_READABLE);
+    if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+        tfm_core_panic();
+    }
+
+    /*
+     * The targets are all marked ready before this SVC returns, so the
+     * scheduler runs once for the whole batch.
+     */
+    for (i = 0; i < num; i++) {
+        backend_assert_signal(tfm_spm_get_partition_by_id(p_pids[i]),
+                              PSA_DOORBELL);
+    }
+}
+
 void tfm_spm_partition_psa_clear(void)
 {
     struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
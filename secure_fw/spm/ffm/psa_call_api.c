@@ -9,28 +9,34 @@
  */
 
 #include "config_impl.h"
-#include "critical_section.h"
+#include "config_spm.h"
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
+#include "ffm/service_stats.h"
+#include "ffm/spm_trace.h"
 #include "tfm_hal_isolation.h"
 #include "tfm_psa_call_pack.h"
 #include "utilities.h"
 
 extern struct service_t *stateless_services_ref_tbl[];
 
-psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
-                                     uint32_t ctrl_param,
-                                     const psa_invec *inptr,
-                                     psa_outvec *outptr)
+static psa_status_t spm_client_psa_call(psa_handle_t handle,
+                                        uint32_t ctrl_param,
+                                        const psa_invec *inptr,
+                                        psa_outvec *outptr)
 {
+#if CONFIG_TFM_SFN_DIRECT_DISPATCH == 1
+    psa_invec *invecs;
+    psa_outvec *outvecs;
+#else
     psa_invec invecs[PSA_MAX_IOVEC];
     psa_outvec outvecs[PSA_MAX_IOVEC];
+#endif
     struct connection_t *p_connection;
     struct service_t *service;
     int i, j;
     int32_t client_id;
     uint32_t sid, version, index;
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
     bool ns_caller = tfm_spm_is_ns_caller();
     struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
     int32_t type = (int32_t)(int16_t)((ctrl_param & TYPE_MASK) >> TYPE_OFFSET);
@@ -73,6 +79,7 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
          */
         if (tfm_spm_check_authorization(sid, service, ns_caller)
             != PSA_SUCCESS) {
+            spm_stats_rejected(service);
             return PSA_ERROR_CONNECTION_REFUSED;
         }
 
@@ -82,11 +89,14 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
             return PSA_ERROR_PROGRAMMER_ERROR;
         }
 
-        CRITICAL_SECTION_ENTER(cs_assert);
+#if CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1
+        p_connection = spm_allocate_rtc_connection(service->partition);
+#else
         p_connection = spm_allocate_connection();
-        CRITICAL_SECTION_LEAVE(cs_assert);
+#endif
 
         if (!p_connection) {
+            spm_stats_rejected(service);
             return PSA_ERROR_CONNECTION_BUSY;
         }
 
@@ -121,6 +131,15 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
 #endif
     }
 
+#if CONFIG_TFM_SFN_DIRECT_DISPATCH == 1
+    /*
+     * The connection is SPM-owned. Copy the vectors straight into it instead
+     * of an intermediate copy, which avoids TOCTOU attacks just the same.
+     */
+    invecs = p_connection->invec;
+    outvecs = p_connection->outvec;
+#endif
+
     /*
      * Read client invecs from the wrap input vector. It is a PROGRAMMER ERROR
      * if the memory reference for the wrap input vector is invalid or not
@@ -135,8 +154,8 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
 
     /*
      * Read client outvecs from the wrap output vector and will update the
-     * actual length later. It is a PROGRAMMER ERROR if the memory reference for
-     * the wrap output vector is invalid or not read-write.
+     * actual length later. It is a PROGRAMMER ERROR if the memory reference
+     * for the wrap output vector is invalid or not read-write.
      */
     FIH_CALL(tfm_hal_memory_check, fih_rc,
              curr_partition->boundary, (uintptr_t)outptr,
@@ -145,8 +164,8 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
         return PSA_ERROR_PROGRAMMER_ERROR;
     }
 
-    spm_memset(invecs, 0, sizeof(invecs));
-    spm_memset(outvecs, 0, sizeof(outvecs));
+    spm_memset(invecs, 0, sizeof(psa_invec) * PSA_MAX_IOVEC);
+    spm_memset(outvecs, 0, sizeof(psa_outvec) * PSA_MAX_IOVEC);
 
     /* Copy the address out to avoid TOCTOU attacks. */
     spm_memcpy(invecs, inptr, in_num * sizeof(psa_invec));
@@ -197,16 +216,43 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
     spm_fill_message(p_connection, service, handle, type, client_id);
     for (i = 0; i < in_num; i++) {
         p_connection->msg.in_size[i] = invecs[i].len;
+#if CONFIG_TFM_SFN_DIRECT_DISPATCH != 1
         p_connection->invec[i].base = invecs[i].base;
+#endif
     }
 
     for (i = 0; i < out_num; i++) {
         p_connection->msg.out_size[i] = outvecs[i].len;
+#if CONFIG_TFM_SFN_DIRECT_DISPATCH != 1
         p_connection->outvec[i].base = outvecs[i].base;
+#endif
         /* Out len is used to record the written number, set 0 here again */
         p_connection->outvec[i].len = 0;
     }
     p_connection->caller_outvec = outptr;
 
+    spm_stats_call_begin(p_connection);
+
+#if CONFIG_TFM_SPM_BACKEND_IPC == 1
+    SPM_TRACE(SPM_TRACE_EVT_CALL_MSG, p_connection->msg.handle, type);
+#endif
+
     return backend_messaging(service, p_connection);
 }
+
+psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
+                                     uint32_t ctrl_param,
+                                     const psa_invec *inptr,
+                                     psa_outvec *outptr)
+{
+    psa_status_t status;
+
+    SPM_TRACE(SPM_TRACE_EVT_CALL_ENTER, handle, ctrl_param);
+
+    status = spm_client_psa_call(handle, ctrl_param, inptr, outptr);
+
+    /* In IPC backend the reply comes later, see SPM_TRACE_EVT_REPLY_*. */
+    SPM_TRACE(SPM_TRACE_EVT_CALL_EXIT, handle, status);
+
+    return status;
+}
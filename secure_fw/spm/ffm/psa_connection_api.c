@@ -8,9 +8,9 @@
  *
  */
 
-#include "critical_section.h"
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
+#include "ffm/service_stats.h"
 #include "load/service_defs.h"
 #include "spm.h"
 
@@ -23,7 +23,6 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
     int32_t client_id;
     psa_handle_t handle;
     bool ns_caller = tfm_spm_is_ns_caller();
-    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
 
     /*
      * It is a PROGRAMMER ERROR if the RoT Service does not exist on the
@@ -44,6 +43,7 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
      * RoT Service.
      */
     if (tfm_spm_check_authorization(sid, service, ns_caller) != PSA_SUCCESS) {
+        spm_stats_rejected(service);
         return PSA_ERROR_CONNECTION_REFUSED;
     }
 
@@ -52,6 +52,7 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
      * not supported on the platform.
      */
     if (tfm_spm_check_client_version(service, version) != PSA_SUCCESS) {
+        spm_stats_rejected(service);
         return PSA_ERROR_CONNECTION_REFUSED;
     }
 
@@ -61,10 +62,9 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
      * Create connection handle here since it is possible to return the error
      * code to client when creation fails.
      */
-    CRITICAL_SECTION_ENTER(cs_assert);
     p_connection = spm_allocate_connection();
-    CRITICAL_SECTION_LEAVE(cs_assert);
     if (!p_connection) {
+        spm_stats_rejected(service);
         return PSA_ERROR_CONNECTION_BUSY;
     }
 
@@ -280,3 +280,81 @@ void tfm_spm_partition_psa_unmap_outvec(psa_handle_t msg_handle,
     /* Update the write number */
     handle->outvec[outvec_idx].len = len;
 }
+
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+
+void *tfm_spm_partition_psa_map_shared_outvec(psa_handle_t msg_handle,
+                                              uint32_t outvec_idx)
+{
+    struct connection_t *handle;
+    void *base;
+
+    /* It is a fatal error if message handle is invalid */
+    handle = spm_msg_handle_to_connection(msg_handle);
+    if (!handle) {
+        tfm_core_panic();
+    }
+
+    /*
+     * It is a fatal error if the RoT Service is stateless, as the connection
+     * is freed when the message is replied.
+     */
+    if (SERVICE_IS_STATELESS(handle->service->p_ldinf->flags)) {
+        tfm_core_panic();
+    }
+
+    /* It is a fatal error if a buffer is already mapped for the connection. */
+    if (handle->shared_base != NULL) {
+        tfm_core_panic();
+    }
+
+    /* The remaining checks are the ones of psa_map_outvec() */
+    base = tfm_spm_partition_psa_map_outvec(msg_handle, outvec_idx);
+
+    /*
+     * Nothing is written to the buffer by this message, it is kept mapped for
+     * the next ones instead.
+     */
+    tfm_spm_partition_psa_unmap_outvec(msg_handle, outvec_idx, 0);
+
+    handle->shared_base = base;
+    handle->shared_len = handle->msg.out_size[outvec_idx];
+
+    return base;
+}
+
+void *tfm_spm_partition_psa_get_shared_outvec(psa_handle_t msg_handle,
+                                              size_t *len)
+{
+    struct connection_t *handle;
+
+    /* It is a fatal error if message handle is invalid */
+    handle = spm_msg_handle_to_connection(msg_handle);
+    if (!handle) {
+        tfm_core_panic();
+    }
+
+    /*
+     * It is a fatal error if MM-IOVEC has not been enabled for the RoT
+     * Service that received the message.
+     */
+    if (!SERVICE_ENABLED_MM_IOVEC(handle->service->p_ldinf->flags)) {
+        tfm_core_panic();
+    }
+
+    /*
+     * It is a fatal error if message handle does not refer to a request
+     * message.
+     */
+    if (handle->msg.type < PSA_IPC_CALL) {
+        tfm_core_panic();
+    }
+
+    if (len != NULL) {
+        *len = handle->shared_len;
+    }
+
+    return handle->shared_base;
+}
+
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1 */
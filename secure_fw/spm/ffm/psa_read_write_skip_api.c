@@ -11,6 +11,22 @@
 #include "spm.h"
 #include "utilities.h"
 #include "tfm_hal_isolation.h"
+#ifdef PLATFORM_HAS_DMA_COPY
+#include "tfm_hal_dma.h"
+#endif
+
+/* Copy iovec data, with the platform DMA for large transfers */
+static void spm_iovec_copy(void *dest, const void *src, size_t n)
+{
+#ifdef PLATFORM_HAS_DMA_COPY
+    if (n >= TFM_HAL_DMA_COPY_MIN_SIZE &&
+        tfm_hal_dma_copy(dest, src, n) == TFM_HAL_SUCCESS) {
+        return;
+    }
+#endif
+
+    spm_memcpy(dest, src, n);
+}
 
 size_t tfm_spm_partition_psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
                                   void *buffer, size_t num_bytes)
@@ -73,7 +89,7 @@ size_t tfm_spm_partition_psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
     bytes = num_bytes > handle->msg.in_size[invec_idx] ?
                         handle->msg.in_size[invec_idx] : num_bytes;
 
-    spm_memcpy(buffer, handle->invec[invec_idx].base, bytes);
+    spm_iovec_copy(buffer, handle->invec[invec_idx].base, bytes);
 
     /* There maybe some remaining data */
     handle->invec[invec_idx].base =
@@ -204,8 +220,8 @@ void tfm_spm_partition_psa_write(psa_handle_t msg_handle, uint32_t outvec_idx,
         tfm_core_panic();
     }
 
-    spm_memcpy((char *)handle->outvec[outvec_idx].base +
-               handle->outvec[outvec_idx].len, buffer, num_bytes);
+    spm_iovec_copy((char *)handle->outvec[outvec_idx].base +
+                   handle->outvec[outvec_idx].len, buffer, num_bytes);
 
     /* Update the write number */
     handle->outvec[outvec_idx].len += num_bytes;
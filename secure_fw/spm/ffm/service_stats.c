@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "critical_section.h"
+#include "current.h"
+#include "fih.h"
+#include "internal_status_code.h"
+#include "spm.h"
+#include "tfm_hal_isolation.h"
+#include "utilities.h"
+#include "cycle_counter.h"
+#include "ffm/service_stats.h"
+#include "load/partition_defs.h"
+#include "load/service_defs.h"
+
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+void spm_stats_call_begin(struct connection_t *p_connection)
+{
+    p_connection->call_start_cycles = cycle_counter_read();
+}
+
+void spm_stats_call_end(struct connection_t *p_connection)
+{
+    struct tfm_service_stat_t *p_stat = &p_connection->service->stat;
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t cycles = cycle_counter_read() -
+                      p_connection->call_start_cycles;
+
+    CRITICAL_SECTION_ENTER(cs);
+    p_stat->calls++;
+    p_stat->total_cycles += cycles;
+    if (cycles > p_stat->max_cycles) {
+        p_stat->max_cycles = cycles;
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void spm_stats_rejected(struct service_t *service)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+    service->stat.rejected++;
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void tfm_core_get_service_stats_handler(uint32_t args[])
+{
+    uint32_t index = args[0];
+    struct tfm_service_stat_t *p_buf = (struct tfm_service_stat_t *)args[1];
+    uint32_t buf_size = args[2];
+    struct partition_t *curr_partition = GET_CURRENT_COMPONENT();
+    struct service_t *service;
+    struct tfm_service_stat_t stat;
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    fih_int fih_rc = FIH_FAILURE;
+
+    /* The statistics expose timing of all services, keep them to PSA-RoT. */
+    if (!IS_PSA_ROT(curr_partition->p_ldinf)) {
+        args[0] = (uint32_t)PSA_ERROR_NOT_PERMITTED;
+        return;
+    }
+
+    if (buf_size < sizeof(*p_buf)) {
+        args[0] = (uint32_t)PSA_ERROR_BUFFER_TOO_SMALL;
+        return;
+    }
+
+    FIH_CALL(tfm_hal_memory_check, fih_rc,
+             curr_partition->boundary, (uintptr_t)p_buf,
+             sizeof(*p_buf), TFM_HAL_ACCESS_READWRITE);
+    if (fih_not_eq(fih_rc, fih_int_encode(PSA_SUCCESS))) {
+        args[0] = (uint32_t)PSA_ERROR_INVALID_ARGUMENT;
+        return;
+    }
+
+    service = tfm_spm_get_service_by_index(index);
+    if (!service) {
+        args[0] = (uint32_t)PSA_ERROR_DOES_NOT_EXIST;
+        return;
+    }
+
+    CRITICAL_SECTION_ENTER(cs);
+    stat = service->stat;
+    CRITICAL_SECTION_LEAVE(cs);
+
+    stat.sid = service->p_ldinf->sid;
+    stat.partition_id = service->partition->p_ldinf->pid;
+
+    /* The caller buffer may not be aligned. */
+    spm_memcpy(p_buf, &stat, sizeof(stat));
+
+    args[0] = (uint32_t)PSA_SUCCESS;
+}
+#endif /* CONFIG_TFM_SPM_SERVICE_STATS == 1 */
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SERVICE_STATS_H__
+#define __SERVICE_STATS_H__
+
+#include <stdint.h>
+#include "config_spm.h"
+#include "spm.h"
+
+#if CONFIG_TFM_SPM_SERVICE_STATS == 1
+/* Stamp the start of a psa_call() request. */
+void spm_stats_call_begin(struct connection_t *p_connection);
+
+/* Account a replied psa_call() request to its service. */
+void spm_stats_call_end(struct connection_t *p_connection);
+
+/* Count a connection refused or failed for lack of resources. */
+void spm_stats_rejected(struct service_t *service);
+
+/*
+ * SVC handler to copy the statistics of the service at index args[0] into
+ * the caller buffer args[1] of size args[2]. The status is returned in
+ * args[0].
+ */
+void tfm_core_get_service_stats_handler(uint32_t args[]);
+#else
+#define spm_stats_call_begin(p_connection)
+#define spm_stats_call_end(p_connection)
+#define spm_stats_rejected(service)
+#endif
+
+#endif /* __SERVICE_STATS_H__ */
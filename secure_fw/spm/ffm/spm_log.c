@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,38 @@
 
 #include "tfm_spm_log.h"
 
+#ifdef TFM_LOG_TOKENIZED
+#include "tfm_log_token.h"
+
+int32_t spm_log_msg(const char *msg)
+{
+    uint8_t record[1 + sizeof(uint32_t)];
+
+    record[0] = TFM_LOG_TOKEN_SPM_MSG;
+    (void)tfm_log_token_put_u32(&record[1], (uint32_t)(uintptr_t)msg);
+
+    return tfm_hal_output_spm_log((const char *)record, sizeof(record));
+}
+
+int32_t spm_log_msgval(const char *msg, size_t len, uint32_t value)
+{
+    uint8_t record[1 + 2 * sizeof(uint32_t)];
+    size_t pos = 0;
+
+    /* A NULL token makes the host output the value only */
+    if (!len) {
+        msg = NULL;
+    }
+
+    record[pos++] = TFM_LOG_TOKEN_SPM_MSGVAL;
+    pos += tfm_log_token_put_u32(&record[pos], (uint32_t)(uintptr_t)msg);
+    pos += tfm_log_token_put_u32(&record[pos], value);
+
+    return tfm_hal_output_spm_log((const char *)record, pos);
+}
+
+#else /* TFM_LOG_TOKENIZED */
+
 #define MAX_DIGIT_BITS 12  /* 8 char for number, 2 for '0x' and 2 for '\r\n' */
 const static char HEX_TABLE[] = {'0', '1', '2', '3', '4', '5', '6', '7',
                                  '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
@@ -54,3 +86,5 @@ int32_t spm_log_msgval(const char *msg, size_t len, uint32_t value)
     }
     return (result_msg + result_val);
 }
+
+#endif /* TFM_LOG_TOKENIZED */
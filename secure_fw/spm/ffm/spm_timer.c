@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config_spm.h"
+#include "critical_section.h"
+#include "ffm/backend.h"
+#include "ffm/interrupt.h"
+#include "ffm/spm_timer.h"
+#include "spm.h"
+#include "spm_secure_cores.h"
+#include "tfm_arch.h"
+#include "tfm_hal_platform.h"
+#include "thread.h"
+#include "utilities.h"
+
+#if CONFIG_TFM_SPM_TIMER == 1
+
+#if (SPM_TIMER_WHEEL_SLOTS & (SPM_TIMER_WHEEL_SLOTS - 1)) != 0
+#error "SPM_TIMER_WHEEL_SLOTS must be a power of two!"
+#endif
+
+#define WHEEL_SLOT(tick)    (&timer_wheel[(tick) & (SPM_TIMER_WHEEL_SLOTS - 1)])
+
+volatile uint32_t spm_ticks;
+
+static struct spm_timer_t *timer_wheel[SPM_TIMER_WHEEL_SLOTS];
+
+/* Unlink a timer from its slot. To be called in a critical section. */
+static void timer_unlink(struct spm_timer_t *p_timer)
+{
+    struct spm_timer_t **pp_link = WHEEL_SLOT(p_timer->expiry);
+
+    while (*pp_link != NULL) {
+        if (*pp_link == p_timer) {
+            *pp_link = p_timer->next;
+            break;
+        }
+        pp_link = &(*pp_link)->next;
+    }
+
+    p_timer->next = NULL;
+    p_timer->armed = false;
+}
+
+void spm_timer_init(void)
+{
+    if (tfm_hal_spm_tick_init(CONFIG_TFM_SPM_TIMER_TICK_HZ) !=
+                                                        TFM_HAL_SUCCESS) {
+        tfm_core_panic();
+    }
+}
+
+void spm_timer_start(struct spm_timer_t *p_timer, uint32_t ticks)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    if (!p_timer || ticks == 0) {
+        tfm_core_panic();
+    }
+
+    CRITICAL_SECTION_ENTER(cs);
+
+    if (p_timer->armed) {
+        timer_unlink(p_timer);
+    }
+
+    p_timer->expiry = spm_ticks + ticks;
+    p_timer->next = *WHEEL_SLOT(p_timer->expiry);
+    p_timer->armed = true;
+    *WHEEL_SLOT(p_timer->expiry) = p_timer;
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void spm_timer_stop(struct spm_timer_t *p_timer)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs);
+
+    if (p_timer->armed) {
+        timer_unlink(p_timer);
+    }
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+void spm_handle_tick(void)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct spm_timer_t **pp_link;
+    struct spm_timer_t *p_timer;
+    uint32_t now;
+
+    SPM_CORE_LOCK();
+    CRITICAL_SECTION_ENTER(cs);
+
+    now = ++spm_ticks;
+    pp_link = WHEEL_SLOT(now);
+
+    /* Only the timers of the current slot can expire on this tick */
+    while ((p_timer = *pp_link) != NULL) {
+        if (p_timer->expiry != now) {
+            pp_link = &p_timer->next;
+            continue;
+        }
+
+        *pp_link = p_timer->next;
+        p_timer->next = NULL;
+        p_timer->armed = false;
+
+        backend_assert_signal(TO_CONTAINER(p_timer, struct partition_t, timer),
+                              TFM_TIMER_SIGNAL);
+    }
+
+    CRITICAL_SECTION_LEAVE(cs);
+
+#if CONFIG_TFM_IRQ_COALESCE == 1
+    spm_irq_coalesce_tick();
+#endif
+
+    if (THRD_EXPECTING_SCHEDULE()) {
+        tfm_arch_trigger_pendsv();
+    }
+
+    SPM_CORE_UNLOCK();
+}
+
+#endif /* CONFIG_TFM_SPM_TIMER == 1 */
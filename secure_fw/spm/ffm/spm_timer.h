@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_TIMER_H__
+#define __SPM_TIMER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Number of slots in the timer wheel, must be a power of two */
+#ifndef SPM_TIMER_WHEEL_SLOTS
+#define SPM_TIMER_WHEEL_SLOTS           16
+#endif
+
+/*
+ * A timer is linked in the wheel slot of its expiry tick, modulo the number
+ * of slots. Timers further than one wheel turn away stay in their slot until
+ * the tick count matches.
+ */
+struct spm_timer_t {
+    struct spm_timer_t *next;           /* Next timer of the same slot     */
+    uint32_t expiry;                    /* Tick count to expire at         */
+    bool armed;                         /* Linked in the wheel             */
+};
+
+/* Number of secure ticks since the tick source was started. */
+extern volatile uint32_t spm_ticks;
+
+/* Start the secure tick source. It panics if the platform fails. */
+void spm_timer_init(void);
+
+/**
+ * \brief Arm a timer, or re-arm it if it is pending.
+ *
+ * \param[in] p_timer           The timer, embedded in its owner partition.
+ * \param[in] ticks             Ticks from now to expire after, at least 1.
+ */
+void spm_timer_start(struct spm_timer_t *p_timer, uint32_t ticks);
+
+/* Disarm a timer. Stopping a timer which is not armed does nothing. */
+void spm_timer_stop(struct spm_timer_t *p_timer);
+
+/*
+ * Advance the wheel by one tick and assert the timer signal of the partitions
+ * whose timer expired. The platform calls it from the secure tick interrupt.
+ */
+void spm_handle_tick(void);
+
+#endif /* __SPM_TIMER_H__ */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "critical_section.h"
+#include "current.h"
+#include "spm.h"
+#include "utilities.h"
+#include "cycle_counter.h"
+#include "ffm/spm_trace.h"
+#include "load/partition_defs.h"
+
+#if (SPM_TRACE_ENTRY_NUM & (SPM_TRACE_ENTRY_NUM - 1)) != 0
+#error "SPM_TRACE_ENTRY_NUM must be a power of two."
+#endif
+
+#define TRACE_IDX(n)                    ((n) & (SPM_TRACE_ENTRY_NUM - 1))
+
+/* SPM runs on a single core, so one ring covers all SPM events. */
+struct spm_trace_ring_t spm_trace_ring;
+
+void spm_trace_init(void)
+{
+    cycle_counter_enable();
+
+    spm_trace_ring.entry_num = SPM_TRACE_ENTRY_NUM;
+    spm_trace_ring.head = 0;
+    spm_trace_ring.tail = 0;
+    spm_trace_ring.lost = 0;
+    spm_trace_ring.magic = SPM_TRACE_MAGIC;
+}
+
+void spm_trace_record(uint32_t event, uint32_t arg0, uint32_t arg1)
+{
+    struct spm_trace_entry_t *p_entry;
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t head;
+
+    CRITICAL_SECTION_ENTER(cs);
+
+    head = spm_trace_ring.head;
+    if (head - spm_trace_ring.tail >= SPM_TRACE_ENTRY_NUM) {
+        /* Full, drop the oldest entry. */
+        spm_trace_ring.tail++;
+        spm_trace_ring.lost++;
+    }
+
+    p_entry = &spm_trace_ring.entries[TRACE_IDX(head)];
+    p_entry->cycles = cycle_counter_read();
+    p_entry->event = event;
+    p_entry->arg0 = arg0;
+    p_entry->arg1 = arg1;
+
+    spm_trace_ring.head = head + 1;
+
+    CRITICAL_SECTION_LEAVE(cs);
+}
+
+uint32_t spm_trace_drain(struct spm_trace_entry_t *buf, uint32_t num)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t count = 0;
+
+    if (!buf) {
+        return 0;
+    }
+
+    CRITICAL_SECTION_ENTER(cs);
+    while ((count < num) && (spm_trace_ring.tail != spm_trace_ring.head)) {
+        buf[count++] =
+                spm_trace_ring.entries[TRACE_IDX(spm_trace_ring.tail)];
+        spm_trace_ring.tail++;
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+
+    return count;
+}
+
+void tfm_core_trace_event_handler(uint32_t *svc_args)
+{
+    struct partition_t *p_curr = GET_CURRENT_COMPONENT();
+    uint32_t event = svc_args[0];
+
+    /* Partitions can not forge the events recorded by SPM. */
+    if ((event < SPM_TRACE_EVT_PARTITION_BASE) ||
+        (event > SPM_TRACE_EVT_PARTITION_MAX)) {
+        tfm_core_panic();
+    }
+
+    event |= (uint32_t)p_curr->p_ldinf->pid << SPM_TRACE_EVT_PID_SHIFT;
+
+    spm_trace_record(event, svc_args[1], svc_args[2]);
+}
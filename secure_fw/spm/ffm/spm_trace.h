@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_TRACE_H__
+#define __SPM_TRACE_H__
+
+#include <stdint.h>
+
+/* Number of entries in the trace ring, must be a power of two */
+#ifndef SPM_TRACE_ENTRY_NUM
+#define SPM_TRACE_ENTRY_NUM             64
+#endif
+
+#define SPM_TRACE_MAGIC                 0x53505452      /* "SPTR" */
+
+/* Trace events, and the meaning of arg0/arg1 */
+#define SPM_TRACE_EVT_SCHEDULE          1   /* current pid, next pid       */
+#define SPM_TRACE_EVT_CALL_ENTER        2   /* handle, ctrl_param          */
+#define SPM_TRACE_EVT_CALL_EXIT         3   /* handle, status              */
+#define SPM_TRACE_EVT_REPLY_ENTER       4   /* msg handle, status          */
+#define SPM_TRACE_EVT_REPLY_EXIT        5   /* msg handle, return value    */
+#define SPM_TRACE_EVT_FLIH_ENTER        6   /* pid, signal                 */
+#define SPM_TRACE_EVT_FLIH_EXIT         7   /* pid, FLIH result            */
+#define SPM_TRACE_EVT_SLIH              8   /* pid, signal                 */
+#define SPM_TRACE_EVT_IDLE              9   /* idle state, wake IRQ        */
+#define SPM_TRACE_EVT_FLIH_HANDLER      10  /* pid, MPU switched           */
+#define SPM_TRACE_EVT_MBOX_SLOT_ALLOC   11  /* SPE slot, NS queue:NS slot  */
+#define SPM_TRACE_EVT_MBOX_SLOT_FREE    12  /* SPE slot, NS queue:NS slot  */
+#define SPM_TRACE_EVT_CALL_MSG         13  /* msg handle, type            */
+
+/*
+ * Events from SPM_TRACE_EVT_PARTITION_BASE are recorded by the Partitions with
+ * tfm_core_trace_event(), see service_api.h. The PID of the Partition is in
+ * bits [31:16] of the event field. The mailbox slots are given as
+ * (NS queue index << 8) | NS slot index.
+ */
+#define SPM_TRACE_EVT_PARTITION_BASE    0x80
+#define SPM_TRACE_EVT_PARTITION_MAX     0xFFFF
+#define SPM_TRACE_EVT_PID_SHIFT         16
+
+/*
+ * With the IPC backend, psa_call() returns to the scheduler before the RoT
+ * Service runs, so CALL_EXIT is recorded before the reply. CALL_MSG is then
+ * recorded when the message of the last CALL_ENTER is queued, and the call
+ * completes at the REPLY_EXIT of that message handle.
+ */
+
+/*
+ * FLIH entry-to-handler latency is the cycle delta from an FLIH_ENTER entry
+ * to the FLIH_HANDLER entry that follows it, split by whether the isolation
+ * boundary had to be switched.
+ */
+
+struct spm_trace_entry_t {
+    uint32_t cycles;                    /* DWT CYCCNT, 0 if not present   */
+    uint32_t event;                     /* SPM_TRACE_EVT_*                */
+    uint32_t arg0;
+    uint32_t arg1;
+};
+
+/*
+ * The ring is a plain global so that a debugger can drain it without halting
+ * the core: entries [tail, head) are valid, modulo SPM_TRACE_ENTRY_NUM, and
+ * the reader advances tail. Entries overwritten before being drained are
+ * counted in lost.
+ *
+ * It is also the binary trace format read by tools/tfm_trace_export.py: a
+ * little endian memory image of the ring, or a stream of entries as returned
+ * by spm_trace_drain(). The tool converts it to a trace that Perfetto loads.
+ */
+struct spm_trace_ring_t {
+    uint32_t magic;                     /* SPM_TRACE_MAGIC once ready      */
+    uint32_t entry_num;                 /* SPM_TRACE_ENTRY_NUM             */
+    volatile uint32_t head;             /* Number of entries written       */
+    volatile uint32_t tail;             /* Number of entries consumed      */
+    volatile uint32_t lost;             /* Entries overwritten unread      */
+    struct spm_trace_entry_t entries[SPM_TRACE_ENTRY_NUM];
+};
+
+#ifdef CONFIG_TFM_SPM_TRACE
+/* Enable the cycle counter and reset the ring. */
+void spm_trace_init(void);
+
+/* Append an event to the ring. It can be called from any SPM context. */
+void spm_trace_record(uint32_t event, uint32_t arg0, uint32_t arg1);
+
+/**
+ * \brief Move the pending entries out of the ring.
+ *
+ * \param[out] buf              Buffer receiving the entries, oldest first.
+ * \param[in]  num              Number of entries \p buf can hold.
+ *
+ * \return Number of entries copied.
+ */
+uint32_t spm_trace_drain(struct spm_trace_entry_t *buf, uint32_t num);
+
+/*
+ * SVC handler of tfm_core_trace_event(). The event in svc_args[0] must be in
+ * the Partition range, and is recorded with the PID of the caller.
+ */
+void tfm_core_trace_event_handler(uint32_t *svc_args);
+
+#define SPM_TRACE(evt, arg0, arg1)                                      \
+    spm_trace_record((evt), (uint32_t)(arg0), (uint32_t)(arg1))
+#else
+#define spm_trace_init()
+#define SPM_TRACE(evt, arg0, arg1)
+#endif
+
+#endif /* __SPM_TRACE_H__ */
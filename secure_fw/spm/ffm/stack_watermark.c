@@ -6,6 +6,8 @@
  */
 
 #include <stdint.h>
+#include "config_impl.h"
+#include "critical_section.h"
 #include "ffm/backend.h"
 #include "ffm/stack_watermark.h"
 #include "lists.h"
@@ -21,6 +23,31 @@
 
 #define STACK_WATERMARK_VAL 0xdeadbeef
 
+#ifdef CONFIG_TFM_STACK_PROFILE
+/*
+ * The stack below the caller SP is re-watermarked on each reply, keeping clear
+ * of the words the SPM itself may still be using there.
+ */
+#define STACK_PROFILE_GUARD 64
+
+#ifndef CONFIG_TFM_STACK_PROFILE_ENTRIES
+#define CONFIG_TFM_STACK_PROFILE_ENTRIES 32
+#endif
+
+struct stack_profile_t {
+    uint32_t sid;
+    int32_t  type;
+    int32_t  pid;
+    uint32_t calls;
+    uint32_t max_used;
+};
+
+static struct stack_profile_t stack_profiles[CONFIG_TFM_STACK_PROFILE_ENTRIES];
+static uint32_t stack_profile_count;
+/* Replies not recorded because the table was full */
+static uint32_t stack_profile_dropped;
+#endif /* CONFIG_TFM_STACK_PROFILE */
+
 void watermark_stack(struct partition_t *p_pt)
 {
     const struct partition_load_info_t *p_pldi = p_pt->p_ldinf;
@@ -48,6 +75,57 @@ static uint32_t used_stack(struct partition_t *p_pt)
     return p_pldi->stack_size - (unused_words * 4);
 }
 
+#ifdef CONFIG_TFM_STACK_PROFILE
+void stack_profile_reply(const struct service_t *service, int32_t type)
+{
+    struct critical_section_t cs = CRITICAL_SECTION_STATIC_INIT;
+    struct partition_t *p_pt = service->partition;
+    const struct partition_load_info_t *p_pldi = p_pt->p_ldinf;
+    struct stack_profile_t *p_prof = NULL;
+    uint32_t used = used_stack(p_pt);
+    uint32_t *p, *p_end;
+    uint32_t i;
+
+    CRITICAL_SECTION_ENTER(cs);
+    for (i = 0; i < stack_profile_count; i++) {
+        if (stack_profiles[i].sid == service->p_ldinf->sid &&
+            stack_profiles[i].type == type) {
+            p_prof = &stack_profiles[i];
+            break;
+        }
+    }
+
+    if (!p_prof && stack_profile_count < CONFIG_TFM_STACK_PROFILE_ENTRIES) {
+        p_prof = &stack_profiles[stack_profile_count++];
+        p_prof->sid = service->p_ldinf->sid;
+        p_prof->type = type;
+        p_prof->pid = p_pldi->pid;
+    }
+
+    if (p_prof) {
+        p_prof->calls++;
+        if (used > p_prof->max_used) {
+            p_prof->max_used = used;
+        }
+    } else {
+        stack_profile_dropped++;
+    }
+    CRITICAL_SECTION_LEAVE(cs);
+
+    /* The partition is the caller of psa_reply(), find where its stack is */
+#if CONFIG_TFM_PSA_API_CROSS_CALL == 1
+    p_end = (uint32_t *)p_pt->ctx_ctrl.cross_frame;
+#else
+    p_end = (uint32_t *)__get_PSP();
+#endif
+    p_end = (uint32_t *)((uintptr_t)p_end - STACK_PROFILE_GUARD);
+
+    for (p = (uint32_t *)LOAD_ALLOCED_STACK_ADDR(p_pldi); p < p_end; p++) {
+        *p = STACK_WATERMARK_VAL;
+    }
+}
+#endif /* CONFIG_TFM_STACK_PROFILE */
+
 void dump_used_stacks(void)
 {
     struct partition_t *p_pt;
@@ -58,4 +136,16 @@ void dump_used_stacks(void)
         SPMLOG_VAL("    Stack bytes: ", p_pt->p_ldinf->stack_size);
         SPMLOG_VAL("    Stack bytes used: ", used_stack(p_pt));
     }
+
+#ifdef CONFIG_TFM_STACK_PROFILE
+    SPMLOG("Stack usage per service call\r\n");
+    for (uint32_t i = 0; i < stack_profile_count; i++) {
+        SPMLOG_VAL("  SID: ", stack_profiles[i].sid);
+        SPMLOG_VAL("    Message type: ", stack_profiles[i].type);
+        SPMLOG_VAL("    Partition id: ", stack_profiles[i].pid);
+        SPMLOG_VAL("    Replies: ", stack_profiles[i].calls);
+        SPMLOG_VAL("    Peak stack bytes used: ", stack_profiles[i].max_used);
+    }
+    SPMLOG_VAL("  Replies not recorded: ", stack_profile_dropped);
+#endif
 }
@@ -18,4 +18,15 @@ void dump_used_stacks(void);
 #define dump_used_stacks()
 #endif
 
+#ifdef CONFIG_TFM_STACK_PROFILE
+/*
+ * Records the stack used by the partition of the service since its previous
+ * reply against the service and message type, then watermarks the unused part
+ * of the stack again. Called by psa_reply() on request messages.
+ */
+void stack_profile_reply(const struct service_t *service, int32_t type);
+#else
+#define stack_profile_reply(service, type)
+#endif
+
 #endif /* __STACK_WATERMARK_H__ */
@@ -77,6 +77,9 @@ static const struct boot_data_access_policy access_policy_table[] = {
 #ifdef TFM_PARTITION_MEASURED_BOOT
     {TFM_SP_MEASURED_BOOT, TLV_MAJOR_MBS},
 #endif
+#if defined(TFM_BOOT_TIMING) && defined(TFM_PARTITION_PLATFORM)
+    {TFM_SP_PLATFORM, TLV_MAJOR_BTS},
+#endif
 };
 
 /*!
@@ -218,3 +221,47 @@ void tfm_core_get_boot_data_handler(uint32_t args[])
     args[0] = (uint32_t)TFM_SUCCESS;
     return;
 }
+
+#ifdef TFM_BOOT_TIMING
+void tfm_core_add_boot_timestamp(uint8_t phase, uint8_t index, uint32_t id,
+                                 uint32_t timestamp)
+{
+#ifdef BOOT_DATA_AVAILABLE
+    struct tfm_boot_data *boot_data;
+    struct shared_data_tlv_entry tlv_entry;
+    struct boot_timing_entry entry;
+    uintptr_t offset;
+
+    if (is_boot_data_valid != BOOT_DATA_VALID) {
+        return;
+    }
+
+    boot_data = (struct tfm_boot_data *)BOOT_TFM_SHARED_DATA_BASE;
+    if (boot_data->header.tlv_tot_len + SHARED_DATA_ENTRY_SIZE(sizeof(entry)) >
+        BOOT_TFM_SHARED_DATA_SIZE) {
+        return;
+    }
+
+    entry.phase = phase;
+    entry.index = index;
+    entry.reserved = 0;
+    entry.timestamp = timestamp;
+    entry.id = id;
+
+    tlv_entry.tlv_type = SET_TLV_TYPE(TLV_MAJOR_BTS,
+                                      SET_BTS_MINOR(phase, index));
+    tlv_entry.tlv_len  = sizeof(entry);
+
+    offset = BOOT_TFM_SHARED_DATA_BASE + boot_data->header.tlv_tot_len;
+    (void)spm_memcpy((void *)offset, &tlv_entry, SHARED_DATA_ENTRY_HEADER_SIZE);
+    (void)spm_memcpy((void *)(offset + SHARED_DATA_ENTRY_HEADER_SIZE), &entry,
+                     sizeof(entry));
+    boot_data->header.tlv_tot_len += SHARED_DATA_ENTRY_SIZE(sizeof(entry));
+#else
+    (void)phase;
+    (void)index;
+    (void)id;
+    (void)timestamp;
+#endif /* BOOT_DATA_AVAILABLE */
+}
+#endif /* TFM_BOOT_TIMING */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -24,4 +24,19 @@ void tfm_core_get_boot_data_handler(uint32_t args[]);
  */
 void tfm_core_validate_boot_data(void);
 
+#ifdef TFM_BOOT_TIMING
+/**
+ * \brief Append a boot phase timestamp to the shared memory area, after the
+ *        ones recorded by the bootloaders. Nothing is recorded if the shared
+ *        data is not valid or if the area is full.
+ *
+ * \param[in] phase      The boot phase, one of the BOOT_TIMING_* values.
+ * \param[in] index      Tells the repeated phases apart.
+ * \param[in] id         The partition ID the phase is about, 0 if none.
+ * \param[in] timestamp  The cycle counter value when the phase was reached.
+ */
+void tfm_core_add_boot_timestamp(uint8_t phase, uint8_t index, uint32_t id,
+                                 uint32_t timestamp);
+#endif /* TFM_BOOT_TIMING */
+
 #endif /* __TFM_BOOT_DATA_H__ */
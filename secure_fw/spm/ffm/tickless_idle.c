@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "config_spm.h"
+#include "ffm/backend.h"
+#include "ffm/spm_trace.h"
+#include "ffm/tickless_idle.h"
+#include "lists.h"
+#include "load/interrupt_defs.h"
+#include "load/spm_load_api.h"
+#include "spm.h"
+#include "spm_secure_cores.h"
+#include "tfm_api.h"
+#include "tfm_arch.h"
+#include "tfm_hal_platform.h"
+#include "thread.h"
+
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+
+uint32_t spm_idle_wake_reason = TFM_HAL_WAKE_REASON_UNKNOWN;
+
+/*
+ * A Partition blocked on one of its interrupt signals waits for a timer or a
+ * peripheral, and a timed psa_wait() waits for the secure tick. Deep sleep
+ * could lose them.
+ */
+static enum tfm_hal_idle_state_t deepest_permitted_state(void)
+{
+    struct partition_t *p_part;
+    const struct irq_load_info_t *p_ildi;
+    psa_signal_t wake_signals;
+    uint32_t i;
+
+    UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
+        p_ildi = LOAD_INFO_IRQ(p_part->p_ldinf);
+        wake_signals = 0;
+#if CONFIG_TFM_SPM_TIMER == 1
+        wake_signals |= TFM_TIMER_SIGNAL;
+#endif
+
+        for (i = 0; i < p_part->p_ldinf->nirqs; i++) {
+            wake_signals |= p_ildi[i].signal;
+        }
+
+        if (p_part->signals_waiting & wake_signals) {
+            return TFM_HAL_IDLE_SLEEP;
+        }
+    }
+
+    return TFM_HAL_IDLE_DEEP_SLEEP;
+}
+
+void spm_idle_enter(void)
+{
+    enum tfm_hal_idle_state_t state;
+    uint32_t reason = TFM_HAL_WAKE_REASON_UNKNOWN;
+    uint32_t primask;
+    bool sleep;
+
+    /*
+     * Interrupts stay masked between the check and the sleep, so an interrupt
+     * which wakes up a Partition can not slip in between. It still wakes up
+     * the core, and it is handled once the critical section is left.
+     * The other secure cores notify this one with an interrupt as well, so
+     * the SPM lock is not held while sleeping.
+     * PRIMASK is used even with CONFIG_TFM_CRITICAL_SECTION_BASEPRI, as the
+     * interrupts masked by BASEPRI do not wake up the core.
+     */
+    primask = __save_disable_irq();
+
+    SPM_CORE_LOCK();
+    sleep = !THRD_EXPECTING_SCHEDULE();
+    if (sleep) {
+        state = deepest_permitted_state();
+    }
+    SPM_CORE_UNLOCK();
+
+    if (sleep) {
+        state = tfm_hal_platform_idle(state, &reason);
+        SPM_CORE_LOCK();
+        spm_idle_wake_reason = reason;
+        SPM_TRACE(SPM_TRACE_EVT_IDLE, state, reason);
+        SPM_CORE_UNLOCK();
+        (void)state;
+    }
+
+    __restore_irq(primask);
+}
+
+#endif /* CONFIG_TFM_IDLE_LOW_POWER == 1 */
+
+#if CONFIG_TFM_WORKQ == 1
+bool spm_idle_kick_work(void)
+{
+    struct partition_t *p_part;
+    bool kicked = false;
+
+    SPM_CORE_LOCK();
+
+    UNI_LIST_FOREACH(p_part, PARTITION_LIST_ADDR, next) {
+        if (p_part->signals_waiting & TFM_WORKQ_SIGNAL) {
+            backend_assert_signal(p_part, TFM_WORKQ_SIGNAL);
+            kicked = true;
+        }
+    }
+
+    if (THRD_EXPECTING_SCHEDULE()) {
+        tfm_arch_trigger_pendsv();
+    }
+
+    SPM_CORE_UNLOCK();
+
+    return kicked;
+}
+#endif /* CONFIG_TFM_WORKQ == 1 */
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TICKLESS_IDLE_H__
+#define __TICKLESS_IDLE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config_spm.h"
+
+#if CONFIG_TFM_IDLE_LOW_POWER == 1
+/* The IRQ that woke up the idle thread last time, for debugging. */
+extern uint32_t spm_idle_wake_reason;
+
+/*
+ * Enter the deepest low-power state the SPE permits, unless a thread became
+ * runnable in the meantime. It returns after the core wakes up.
+ */
+void spm_idle_enter(void);
+#endif
+
+#if CONFIG_TFM_WORKQ == 1
+/*
+ * Wake up the Partitions waiting with deferred work queued. It returns true
+ * if any was woken up, then the idle thread must not sleep.
+ */
+bool spm_idle_kick_work(void);
+#endif
+
+#endif /* __TICKLESS_IDLE_H__ */
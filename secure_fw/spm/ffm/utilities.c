@@ -9,11 +9,19 @@
 #include "fih.h"
 #include "utilities.h"
 #include "tfm_hal_platform.h"
+#ifdef TFM_SPM_LOG_BUFFERED
+#include "tfm_hal_spm_logdev.h"
+#endif
 
 void tfm_core_panic(void)
 {
     fih_delay();
 
+#ifdef TFM_SPM_LOG_BUFFERED
+    /* Send the log output that led to the panic before it is lost */
+    tfm_hal_spm_log_drain();
+#endif
+
 #ifdef CONFIG_TFM_HALT_ON_CORE_PANIC
 
     /*
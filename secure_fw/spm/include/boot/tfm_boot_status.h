@@ -23,6 +23,7 @@ extern "C" {
 #define TLV_MAJOR_IAS      0x1
 #define TLV_MAJOR_FWU      0x2
 #define TLV_MAJOR_MBS      0x3
+#define TLV_MAJOR_BTS      0x4
 #define TLV_MAJOR_INVALID  0xF
 
 /**
@@ -62,6 +63,8 @@ extern "C" {
  * |---------------------------------------|
  * | MAJOR_MBS   | slot ID  (6) | claim(6) |
  * |---------------------------------------|
+ * | MAJOR_BTS   | phase    (6) | index(6) |
+ * |---------------------------------------|
  * | MAJOR_CORE  |          TBD            |
  * |---------------------------------------|
  */
@@ -157,6 +160,53 @@ extern "C" {
                     (MASK_LEFT_SHIFT(sw_module, MODULE_MASK, MODULE_POS) | \
                      MASK_LEFT_SHIFT(claim, CLAIM_MASK, CLAIM_POS))
 
+/* Boot timing specific macros */
+#define BTS_PHASE_POS  6
+#define BTS_PHASE_MASK 0x3F /* 6 bit */
+#define BTS_INDEX_POS  0
+#define BTS_INDEX_MASK 0x3F /* 6 bit */
+
+#define SET_BTS_MINOR(phase, index) \
+                    (MASK_LEFT_SHIFT(phase, BTS_PHASE_MASK, BTS_PHASE_POS) | \
+                     MASK_LEFT_SHIFT(index, BTS_INDEX_MASK, BTS_INDEX_POS))
+
+/* Boot timing: the cold boot phases which are timestamped with
+ * TFM_BOOT_TIMING. The index tells the repeated phases apart: it is the image
+ * ID for the image phases, the load order for the partition phases, and 0
+ * otherwise.
+ */
+#define BOOT_TIMING_BL1_1_START             0x01 /* BL1_1 platform init done  */
+#define BOOT_TIMING_BL1_1_JUMP              0x02 /* BL1_2 validated           */
+#define BOOT_TIMING_BL1_2_START             0x08 /* BL1_2 platform init done  */
+#define BOOT_TIMING_BL1_2_DECRYPT           0x09 /* copy_and_decrypt_image()  */
+#define BOOT_TIMING_BL1_2_VALIDATE          0x0A /* validate_image_at_addr()  */
+#define BOOT_TIMING_BL1_2_JUMP              0x0B /* BL2 validated             */
+#define BOOT_TIMING_BL2_START               0x10 /* main() entry              */
+#define BOOT_TIMING_BL2_FLASH_INIT          0x11 /* Platform and flash init   */
+#define BOOT_TIMING_BL2_VALIDATE            0x12 /* Image load and validation */
+#define BOOT_TIMING_BL2_SHARED_DATA         0x13 /* boot_save_shared_data()   */
+#define BOOT_TIMING_BL2_LOADED              0x14 /* Image validated           */
+#define BOOT_TIMING_BL2_JUMP                0x15 /* Jump to the secure image  */
+#define BOOT_TIMING_SPM_START               0x20 /* SPM main() entry          */
+#define BOOT_TIMING_SPM_INIT                0x21 /* tfm_spm_init() entry      */
+#define BOOT_TIMING_SPM_PARTITION_LOAD      0x22 /* Partition loaded          */
+#define BOOT_TIMING_SPM_PARTITION_INIT      0x23 /* SFN partition initialized */
+#define BOOT_TIMING_SPM_INIT_DONE           0x24 /* All partitions loaded     */
+
+/**
+ * Value of the TLV_MAJOR_BTS entries. The timestamp is read from the DWT
+ * cycle counter by default, which keeps counting across the boot stages; it
+ * is 0 on cores which have none. The phase and index repeat the minor type,
+ * so that an entry can be decoded once copied out of the shared data area.
+ */
+struct boot_timing_entry {
+    uint8_t  phase;     /* BOOT_TIMING_* */
+    uint8_t  index;     /* Image ID or partition load order */
+    uint16_t reserved;
+    uint32_t timestamp; /* Counter value when the phase was reached */
+    uint32_t id;        /* Image ID, or partition ID, 0 if none */
+};
+
 /* Magic value which marks the beginning of shared data area in memory */
 #define SHARED_DATA_TLV_INFO_MAGIC    0x2016
 
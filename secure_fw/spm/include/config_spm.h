@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,8 +13,12 @@
 
 /* The maximal number of secure services that are connected or requested at the same time */
 #ifndef CONFIG_TFM_CONN_HANDLE_MAX_NUM
-#pragma message("CONFIG_TFM_CONN_HANDLE_MAX_NUM is defaulted to 8. Please check and set it explicitly.")
-#define CONFIG_TFM_CONN_HANDLE_MAX_NUM 8
+#pragma message("CONFIG_TFM_CONN_HANDLE_MAX_NUM is defaulted to the manifest calculated number. Please check and set it explicitly.")
+#define CONFIG_TFM_CONN_HANDLE_MAX_NUM CONFIG_TFM_CONN_HANDLE_AUTO_NUM
+#elif CONFIG_TFM_CONN_HANDLE_MAX_NUM == 0
+/* 0 selects the number calculated by the manifest tool */
+#undef CONFIG_TFM_CONN_HANDLE_MAX_NUM
+#define CONFIG_TFM_CONN_HANDLE_MAX_NUM CONFIG_TFM_CONN_HANDLE_AUTO_NUM
 #endif
 
 /* Set the doorbell APIs */
@@ -30,4 +34,47 @@
 #error "Invalid config: CONFIG_TFM_SPM_BACKEND_SFN AND CONFIG_TFM_DOORBELL_API!"
 #endif
 
+#if (CONFIG_TFM_SPM_BACKEND_SFN != 1) && (CONFIG_TFM_SFN_DIRECT_DISPATCH == 1)
+#error "Invalid config: CONFIG_TFM_SFN_DIRECT_DISPATCH requires CONFIG_TFM_SPM_BACKEND_SFN!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_SFN != 1) && (CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1)
+#error "Invalid config: CONFIG_TFM_SFN_RUN_TO_COMPLETION requires CONFIG_TFM_SPM_BACKEND_SFN!"
+#endif
+
+/* Run-to-completion services must never wait for an interrupt signal */
+#if (CONFIG_TFM_SFN_RUN_TO_COMPLETION == 1) && (CONFIG_TFM_SLIH_API == 1)
+#error "Invalid config: CONFIG_TFM_SFN_RUN_TO_COMPLETION AND SLIH interrupts!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_IPC != 1) && (CONFIG_TFM_PRIORITY_DONATION == 1)
+#error "Invalid config: CONFIG_TFM_PRIORITY_DONATION requires CONFIG_TFM_SPM_BACKEND_IPC!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_IPC != 1) && (CONFIG_TFM_IDLE_LOW_POWER == 1)
+#error "Invalid config: CONFIG_TFM_IDLE_LOW_POWER requires CONFIG_TFM_SPM_BACKEND_IPC!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_IPC != 1) && (CONFIG_TFM_SPM_TIMER == 1)
+#error "Invalid config: CONFIG_TFM_SPM_TIMER requires CONFIG_TFM_SPM_BACKEND_IPC!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_IPC != 1) && (CONFIG_TFM_WORKQ == 1)
+#error "Invalid config: CONFIG_TFM_WORKQ requires CONFIG_TFM_SPM_BACKEND_IPC!"
+#endif
+
+#if (CONFIG_TFM_SPM_BACKEND_IPC != 1) && (CONFIG_TFM_PREEMPTION_POINTS == 1)
+#error "Invalid config: CONFIG_TFM_PREEMPTION_POINTS requires CONFIG_TFM_SPM_BACKEND_IPC!"
+#endif
+
+#if (CONFIG_TFM_CRITICAL_SECTION_BASEPRI != 0) && \
+    !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__) && \
+    !defined(__ARM_ARCH_8M_MAIN__) && !defined(__ARM_ARCH_8_1M_MAIN__)
+#error "Invalid config: CONFIG_TFM_CRITICAL_SECTION_BASEPRI requires a Mainline core!"
+#endif
+
+#if (CONFIG_TFM_SPM_TIMER == 1) && (CONFIG_TFM_SPM_TIMER_TICK_HZ == 0)
+#error "Invalid config: CONFIG_TFM_SPM_TIMER_TICK_HZ must not be 0!"
+#endif
+
 #endif /* __CONFIG_PARTITION_SPM_H__ */
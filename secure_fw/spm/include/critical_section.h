@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,6 +9,7 @@
 #define __TFM_CRITICAL_SECTION_H__
 
 #include <stdint.h>
+#include "config_tfm.h"
 #include "tfm_arch.h"
 
 struct critical_section_t {
@@ -17,7 +18,30 @@ struct critical_section_t {
 
 #define CRITICAL_SECTION_STATIC_INIT   {.state = 0,}
 #define CRITICAL_SECTION_INIT(cs)      (cs).state = (0)
+
+#if CONFIG_TFM_CRITICAL_SECTION_BASEPRI != 0
+/*
+ * Only mask the exceptions of a priority lower than or equal to the BASEPRI
+ * value, which must cover PendSV, the secure tick and the interrupts handled
+ * by the SPM. The interrupts of a higher priority, which do not reach the SPM
+ * state, and the faults keep running.
+ */
+#if (PENDSV_PRIO_FOR_SCHED << (8 - __NVIC_PRIO_BITS)) < \
+    CONFIG_TFM_CRITICAL_SECTION_BASEPRI
+#error "Invalid config: CONFIG_TFM_CRITICAL_SECTION_BASEPRI must mask PendSV!"
+#endif
+
+#define CRITICAL_SECTION_ENTER(cs)     \
+    (cs).state = __save_raise_basepri(CONFIG_TFM_CRITICAL_SECTION_BASEPRI)
+#define CRITICAL_SECTION_LEAVE(cs)     __restore_basepri((cs).state)
+
+/* Whether an exception of the given NVIC priority is masked by the sections */
+#define CRITICAL_SECTION_MASKS_PRIORITY(prio)                   \
+    (((prio) << (8 - __NVIC_PRIO_BITS)) >=                      \
+     CONFIG_TFM_CRITICAL_SECTION_BASEPRI)
+#else
 #define CRITICAL_SECTION_ENTER(cs)     (cs).state = __save_disable_irq()
 #define CRITICAL_SECTION_LEAVE(cs)     __restore_irq((cs).state)
+#endif
 
 #endif /* __TFM_CRITICAL_SECTION_H__ */
@@ -28,6 +28,9 @@
  */
 #define TFM_IPC_REPLY_SIGNAL     (0x00000002u)
 
+/* The signal asserted when the timer of a timed psa_wait() expires. */
+#define TFM_TIMER_SIGNAL         (0x00000004u)
+
 /*
  * Runtime model-specific component initialization routine. This
  * is an `assuredly` function, would panic if any error occurred.
@@ -57,6 +60,24 @@ psa_status_t backend_replying(struct connection_t *handle, int32_t status);
  */
 psa_signal_t backend_wait_signals(struct partition_t *p_pt, psa_signal_t signals);
 
+#if CONFIG_TFM_SPM_TIMER == 1
+/**
+ * \brief Set the wait signal pattern in current partition, and arm its timer
+ *        to stop waiting after the given number of secure ticks.
+ */
+psa_signal_t backend_wait_signals_timed(struct partition_t *p_pt,
+                                        psa_signal_t signals,
+                                        uint32_t ticks);
+#endif
+
+#if CONFIG_TFM_PREEMPTION_POINTS == 1
+/**
+ * \brief Let the other runnable partitions of the same priority run before
+ *        the given partition continues.
+ */
+void backend_yield(struct partition_t *p_pt);
+#endif
+
 /**
  * \brief Set the asserted signal pattern in current partition.
  */
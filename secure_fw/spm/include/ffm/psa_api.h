@@ -337,6 +337,18 @@ void tfm_spm_partition_psa_notify(int32_t partition_id);
  *                              currently asserted.
  */
 void tfm_spm_partition_psa_clear(void);
+
+/**
+ * \brief SVC handler of \ref tfm_core_notify_multi. Sends the PSA_DOORBELL
+ *        signal to each Secure Partition of the list in svc_args[0], with
+ *        svc_args[1] entries.
+ *
+ * \retval void                 Success.
+ * \retval "PROGRAMMER ERROR"   The list is not readable by the caller, or an
+ *                              entry does not correspond to a Secure
+ *                              Partition.
+ */
+void tfm_core_notify_multi_handler(uint32_t *svc_args);
 #endif /* CONFIG_TFM_DOORBELL_API == 1 */
 
 /**
@@ -464,6 +476,20 @@ void *tfm_spm_partition_psa_map_outvec(psa_handle_t msg_handle,
 void tfm_spm_partition_psa_unmap_outvec(psa_handle_t msg_handle,
                                         uint32_t outvec_idx, size_t len);
 
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+/**
+ * \brief Function body of psa_map_shared_outvec.
+ */
+void *tfm_spm_partition_psa_map_shared_outvec(psa_handle_t msg_handle,
+                                              uint32_t outvec_idx);
+
+/**
+ * \brief Function body of psa_get_shared_outvec.
+ */
+void *tfm_spm_partition_psa_get_shared_outvec(psa_handle_t msg_handle,
+                                              size_t *len);
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1 */
+
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
 
 #endif /* __PSA_API_H__ */
@@ -63,6 +63,10 @@ struct psa_api_tbl_t {
     void             (*psa_unmap_invec)(psa_handle_t msg_handle, uint32_t invec_idx);
     void *           (*psa_map_outvec)(psa_handle_t msg_handle, uint32_t outvec_idx);
     void             (*psa_unmap_outvec)(psa_handle_t msg_handle, uint32_t outvec_idx, size_t len);
+#if CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1
+    void *           (*psa_map_shared_outvec)(psa_handle_t msg_handle, uint32_t outvec_idx);
+    void *           (*psa_get_shared_outvec)(psa_handle_t msg_handle, size_t *len);
+#endif /* CONFIG_TFM_CONNECTION_BASED_SERVICE_API == 1 */
 #endif /* PSA_FRAMEWORK_HAS_MM_IOVEC */
 };
 
@@ -72,6 +76,29 @@ struct runtime_metadata_t {
     uint32_t             n_sfn;      /* Number of Secure FuNctions */
     service_fn_t         sfn_table[];/* Secure FuNctions Table */
 };
+
+/*
+ * The runtime metadata with a table of 'n' SFNs, which has the layout of
+ * 'struct runtime_metadata_t'. The manifest tool generates it as constant
+ * data of the Partition, and the load information refers to it.
+ */
+#define RUNTIME_METADATA_T(n)                                         \
+    struct {                                                          \
+        uintptr_t            entry;                                   \
+        struct psa_api_tbl_t *psa_fns;                                \
+        uint32_t             n_sfn;                                   \
+        service_fn_t         sfn_table[n];                            \
+    }
+
+/* PSA API entry table of the Partitions at this isolation level */
+#if TFM_LVL == 1
+#define RUNTIME_METADATA_PSA_FNS      (&psa_api_cross)
+extern struct psa_api_tbl_t psa_api_cross;
+#else
+/* TODO: ABI for PRoT partitions needs to be updated based on implementations. */
+#define RUNTIME_METADATA_PSA_FNS      (&psa_api_svc)
+extern struct psa_api_tbl_t psa_api_svc;
+#endif
 #endif /* CONFIG_TFM_SPM_BACKEND_IPC == 1 */
 
 #endif /* __RUNTIME_DEFS_H__ */
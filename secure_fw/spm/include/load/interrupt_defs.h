@@ -15,6 +15,18 @@
 #include "tfm_hal_defs.h"
 #include "psa/service.h"
 
+struct irq_load_info_t;
+
+/* IRQ event coalescing runtime data */
+struct irq_coalesce_t {
+    struct irq_coalesce_t *next;              /* Next batch the tick checks   */
+    void         *p_pt;                       /* The owner Partition          */
+    const struct irq_load_info_t *p_ildi;     /* The interrupt load info      */
+    uint32_t     pending;                     /* Events not yet signalled     */
+    uint32_t     first_stamp;                 /* Tick or cycle of 1st pending */
+    uint32_t     delivered;                   /* Events reported by signal    */
+};
+
 /* IRQ static load info */
 struct irq_load_info_t {
     /*
@@ -26,6 +38,9 @@ struct irq_load_info_t {
     int32_t      pid;                         /* Owner Partition ID           */
     uint32_t     source;                      /* IRQ source (number/index)    */
     psa_signal_t signal;                      /* The signal assigned for IRQ  */
+    uint32_t     coalesce_count;              /* Events per signal, 0 for off */
+    uint32_t     coalesce_us;                 /* Max delay in us, 0 for none  */
+    struct irq_coalesce_t *p_coalesce;        /* NULL if not coalescing       */
 };
 
 /* IRQ runtime data */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  * Copyright (c) 2022-2023 Cypress Semiconductor Corporation (an Infineon
  * company) or an affiliate of Cypress Semiconductor Corporation. All rights
  * reserved.
@@ -16,6 +16,7 @@
 
 /* TF-M internal partition ID */
 #define TFM_SP_IDLE_ID                          (1)
+#define TFM_SP_IDLE_CORE1_ID                    (2)
 #define INVALID_PARTITION_ID                    (~0U)
 
 /* Encode a magic number into version for validating partition info */
@@ -26,10 +27,10 @@
 /*
  * Partition flag start
  *
- * 31      12 11 10  9   8  7         0
- * +---------+--+--+---+---+----------+
- * | RES[20] |TZ|NS|I/S|A/P| Priority |
- * +---------+--+--+---+---+----------+
+ * 31      16 15 14 13 12 11 10  9   8  7         0
+ * +---------+--+--+--+--+--+--+---+---+----------+
+ * | RES[16] |SS|CO|LI|FP|TZ|NS|I/S|A/P| Priority |
+ * +---------+--+--+--+--+--+--+---+---+----------+
  *
  * Field                Desc                        Value
  * Priority, bits[7:0]:  Partition Priority          Lowest, low, normal, high, hightest
@@ -37,7 +38,11 @@
  * I/S, bit[9]:          IPC or SFN typed partition  1: IPC               0: SFN
  * NS,  bit[10]:         NS Agent or not             1: NS Agent          0: Not
  * TZ,  bit[11]:         NS Agent TZ or not          1: NS Agent TZ       0: Not
- * RES, bits[31:12]:     20 bits reserved            0
+ * FP,  bit[12]:         FPU unused or not           1: FPU never used    0: May use FPU
+ * LI,  bit[13]:         Lazy initialization         1: Deferred init     0: Init at boot
+ * CO,  bit[14]:         Secure core                 1: Core 1            0: Core 0
+ * SS,  bit[15]:         Stack of a stack group      1: Shared stack      0: Own stack
+ * RES, bits[31:16]:     16 bits reserved            0
  */
 #define PARTITION_PRI_HIGHEST                   (0x0)
 #define PARTITION_PRI_HIGH                      (0xF)
@@ -52,6 +57,20 @@
 #define PARTITION_NS_AGENT                      (1U << 10)
 #define PARTITION_NS_AGENT_TZ                   (1U << 11)
 
+#define PARTITION_NO_FPU                        (1U << 12)
+
+#define PARTITION_LAZY_INIT                     (1U << 13)
+
+#define PARTITION_CORE_SHIFT                    (14)
+#define PARTITION_CORE_MASK                     (0x1U << PARTITION_CORE_SHIFT)
+#define PARTITION_CORE(core)                    (((uint32_t)(core) \
+                                                  << PARTITION_CORE_SHIFT) \
+                                                 & PARTITION_CORE_MASK)
+#define PARTITION_CORE_ID(flag)                 (((flag) & PARTITION_CORE_MASK) \
+                                                 >> PARTITION_CORE_SHIFT)
+
+#define PARTITION_SHARED_STACK                  (1U << 15)
+
 #define PARTITION_PRIORITY(flag)                ((flag) & PARTITION_PRI_MASK)
 #define TO_THREAD_PRIORITY(x)                   (x)
 
@@ -67,6 +86,12 @@
                                                      & PARTITION_MODEL_IPC))
 #define IS_NS_AGENT(pldi)                       (!!((pldi)->flags \
                                                      & PARTITION_NS_AGENT))
+#define USES_FPU(pldi)                          (!((pldi)->flags \
+                                                   & PARTITION_NO_FPU))
+#define IS_LAZY_INIT(pldi)                      (!!((pldi)->flags \
+                                                     & PARTITION_LAZY_INIT))
+#define IS_SHARED_STACK(pldi)                   (!!((pldi)->flags \
+                                                     & PARTITION_SHARED_STACK))
 #ifdef CONFIG_TFM_USE_TRUSTZONE
 #define IS_NS_AGENT_TZ(pldi)                    (IS_NS_AGENT(pldi) \
                                                      && !!((pldi)->flags \
@@ -22,7 +22,7 @@
 #define NO_MORE_PARTITION        NULL
 
 /* Length of extendable variables in partition load type */
-#define LOAD_INFO_EXT_LENGTH                        (2)
+#define LOAD_INFO_EXT_LENGTH                        (3)
 /* Argument "pldinf" must be a "struct partition_load_info_t *". */
 #define LOAD_INFSZ_BYTES(pldinf)                                       \
     (sizeof(*(pldinf)) + LOAD_INFO_EXT_LENGTH * sizeof(uintptr_t) +    \
@@ -33,6 +33,7 @@
 
 /* 'Allocate' stack based on load info */
 #define LOAD_ALLOCED_STACK_ADDR(pldinf)    (*((uintptr_t *)(pldinf + 1)))
+#define LOAD_RUNTIME_METADATA_ADDR(pldinf) (*((uintptr_t *)(pldinf + 1) + 2))
 
 #define LOAD_INFO_DEPS(pldinf)                                         \
     ((const uint32_t *)((uintptr_t)(pldinf + 1) + LOAD_INFO_EXT_LENGTH * sizeof(uintptr_t)))
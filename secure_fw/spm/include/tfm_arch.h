@@ -213,6 +213,24 @@ __STATIC_INLINE void __restore_irq(uint32_t status)
     __ASM volatile ("msr primask, %0" :: "r" (status) : "memory");
 }
 
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+/* BASEPRI is only raised, so the nested sections keep the outer mask */
+__STATIC_INLINE uint32_t __save_raise_basepri(uint32_t basepri)
+{
+    uint32_t result;
+
+    __ASM volatile ("mrs %0, basepri \n msr basepri_max, %1"
+                    : "=&r" (result) : "r" (basepri) : "memory");
+    return result;
+}
+
+__STATIC_INLINE void __restore_basepri(uint32_t status)
+{
+    __ASM volatile ("msr basepri, %0" :: "r" (status) : "memory");
+}
+#endif
+
 __attribute__ ((always_inline))
 __STATIC_INLINE uint32_t __get_active_exc_num(void)
 {
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_LOG_TOKEN_H__
+#define __TFM_LOG_TOKEN_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Tokenized log records
+ *
+ * With TFM_LOG_TOKENIZED, the SPM and Secure Partition logs are output as
+ * binary records instead of formatted text. The token of a record is the
+ * address of its message string in the secure image, which
+ * tools/tfm_log_decode.py looks up in the image ELF file to format the text
+ * on the host. The header bytes never appear in UTF-8 text, so records can be
+ * mixed with plain text output.
+ *
+ *   SPM message:             0xC0, token
+ *   SPM message with value:  0xC1, token, value
+ *   Partition printf:        0xF8 | nargs, token, args
+ *
+ * Tokens and values are 32-bit little endian. Partition arguments are 32-bit
+ * little endian, except for "%s", which is output as a length byte followed by
+ * the characters.
+ */
+#define TFM_LOG_TOKEN_SPM_MSG           0xC0
+#define TFM_LOG_TOKEN_SPM_MSGVAL        0xC1
+#define TFM_LOG_TOKEN_SP_FMT            0xF8
+
+/* Arguments after these limits are not output */
+#define TFM_LOG_TOKEN_SP_MAX_ARGS       7
+#define TFM_LOG_TOKEN_SP_MAX_SIZE       64
+
+static inline size_t tfm_log_token_put_u32(uint8_t *buf, uint32_t val)
+{
+    buf[0] = (uint8_t)val;
+    buf[1] = (uint8_t)(val >> 8);
+    buf[2] = (uint8_t)(val >> 16);
+    buf[3] = (uint8_t)(val >> 24);
+
+    return sizeof(uint32_t);
+}
+
+#endif /* __TFM_LOG_TOKEN_H__ */
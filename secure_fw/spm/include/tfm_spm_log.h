@@ -34,9 +34,15 @@
 #error "Incorrect TFM_SPM_LOG_LEVEL value!"
 #endif
 
+#ifdef TFM_LOG_TOKENIZED
+#define SPMLOG_MSG(msg) spm_log_msg(msg)
+#else
+#define SPMLOG_MSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#endif
+
 #if (TFM_SPM_LOG_LEVEL == TFM_SPM_LOG_LEVEL_DEBUG)
 #define SPMLOG_DBGMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_DBGMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_DBGMSG(msg) SPMLOG_MSG(msg)
 #else
 #define SPMLOG_DBGMSGVAL(msg, val)
 #define SPMLOG_DBGMSG(msg)
@@ -44,7 +50,7 @@
 
 #if (TFM_SPM_LOG_LEVEL >= TFM_SPM_LOG_LEVEL_INFO)
 #define SPMLOG_INFMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_INFMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_INFMSG(msg) SPMLOG_MSG(msg)
 #else
 #define SPMLOG_INFMSGVAL(msg, val)
 #define SPMLOG_INFMSG(msg)
@@ -52,7 +58,7 @@
 
 #if (TFM_SPM_LOG_LEVEL >= TFM_SPM_LOG_LEVEL_ERROR)
 #define SPMLOG_ERRMSGVAL(msg, val) spm_log_msgval(msg, sizeof(msg), val)
-#define SPMLOG_ERRMSG(msg) tfm_hal_output_spm_log(msg, sizeof(msg))
+#define SPMLOG_ERRMSG(msg) SPMLOG_MSG(msg)
 #else
 #define SPMLOG_ERRMSGVAL(msg, val)
 #define SPMLOG_ERRMSG(msg)
@@ -71,4 +77,16 @@
  */
 int32_t spm_log_msgval(const char *msg, size_t len, uint32_t value);
 
+#ifdef TFM_LOG_TOKENIZED
+/**
+ * \brief SPM output API to output a tokenized string message.
+ *
+ * \param[in]  msg    A string message in the secure image
+ *
+ * \retval >=0        Number of bytes output.
+ * \retval <0         TFM HAL error code.
+ */
+int32_t spm_log_msg(const char *msg);
+#endif
+
 #endif /* __TFM_SPM_LOG_H__ */
@@ -5,6 +5,7 @@
  *
  */
 #include "tfm_arch.h"
+#include "tfm_hal_isolation.h"
 #include "tfm_nspm.h"
 #include "tfm_ns_client_ext.h"
 #include "tfm_ns_ctx.h"
@@ -121,6 +122,10 @@ uint32_t tfm_nsce_load_ctx(uint32_t token, int32_t nsid)
     if (!load_ns_ctx(gid, tid, nsid, ctx_idx)) {
         return TFM_NS_CLIENT_ERR_INVALID_TOKEN;
     } else {
+#ifdef CONFIG_TFM_MEMORY_CHECK_CACHE
+        /* The NS OS may have reprogrammed its MPU for the new thread */
+        tfm_hal_memory_check_cache_invalidate();
+#endif
         return TFM_NS_CLIENT_ERR_SUCCESS;
     }
 }
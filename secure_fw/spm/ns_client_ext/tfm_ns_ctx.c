@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -19,6 +19,18 @@ static struct tfm_ns_ctx_t ns_ctx_data[TFM_NS_CONTEXT_MAX] = {0};
 /* Current active NS context index. Default is invalid index */
 static uint8_t active_ns_ctx_index = TFM_NS_CONTEXT_MAX;
 
+/* Bit i is set when context i is free */
+#define NS_CTX_ALL_FREE                                                  \
+    ((TFM_NS_CONTEXT_MAX == 32) ? 0xFFFFFFFFU                            \
+                                : ((1U << TFM_NS_CONTEXT_MAX) - 1U))
+static uint32_t free_ns_ctx_bitmap = NS_CTX_ALL_FREE;
+
+/*
+ * The context index plus one taken by each group ID, 0 if none. Acquiring
+ * and releasing a context then costs the same for any number of groups.
+ */
+static uint8_t gid_to_ns_ctx[UINT8_MAX + 1];
+
 bool init_ns_ctx(void)
 {
     uint32_t i;
@@ -28,63 +40,67 @@ bool init_ns_ctx(void)
         ns_ctx_data[i].ref_cnt = 0;
     }
 
+    for (i = 0; i <= UINT8_MAX; i++) {
+        gid_to_ns_ctx[i] = 0;
+    }
+
+    free_ns_ctx_bitmap = NS_CTX_ALL_FREE;
     active_ns_ctx_index = TFM_NS_CONTEXT_MAX;
     return true;
 }
 
+/* Drop one reference, and free the context with the last one. */
+static void put_ns_ctx(uint8_t idx)
+{
+    if (ns_ctx_data[idx].ref_cnt == 0) {
+        return;
+    }
+
+    if (--ns_ctx_data[idx].ref_cnt == 0) {
+        gid_to_ns_ctx[ns_ctx_data[idx].gid] = 0;
+        free_ns_ctx_bitmap |= (1U << idx);
+    }
+}
+
 bool acquire_ns_ctx(uint8_t gid, uint8_t *idx)
 {
-    /* Only support one context slot for now */
-    uint32_t i;
-    uint32_t empty_ctx_idx = TFM_NS_CONTEXT_MAX; /* default is invalid */
+    uint8_t i;
 
     __disable_irq();
-    /*
-     * Go through all context slots to get the context for the given group ID.
-     * It will not take a long time as the context number should be limited.
-     */
-    for (i = 0; i < TFM_NS_CONTEXT_MAX; i++) {
-        if (ns_ctx_data[i].ref_cnt > 0) {  /* This context has been taken */
-            if (ns_ctx_data[i].gid == gid) {
-                /*
-                 * Found the context associated with the input group ID.
-                 * Check if the thread number reached the limit.
-                 */
-                if (ns_ctx_data[i].ref_cnt < TFM_NS_CONTEXT_MAX_TID) {
-                    /* Reuse this context and increase the reference number */
-                    ns_ctx_data[i].ref_cnt++;
-                    *idx = i;
-                    __enable_irq();
-                    return true;
-                } else {
-                    /* No more thread for this group */
-                    __enable_irq();
-                    return false;
-                }
-            }
-        } else {    /* Found an empty context slot */
-            /* Save the first unused context index and continue */
-            if (empty_ctx_idx == TFM_NS_CONTEXT_MAX) {
-                empty_ctx_idx = i;
-            }
-            /*
-             * Still need to go through the remaining slots to check if there
-             * is an existing context assigned to the given group ID.
-             */
+
+    if (gid_to_ns_ctx[gid] != 0) {
+        i = gid_to_ns_ctx[gid] - 1;
+        /*
+         * Found the context associated with the input group ID.
+         * Check if the thread number reached the limit.
+         */
+        if (ns_ctx_data[i].ref_cnt < TFM_NS_CONTEXT_MAX_TID) {
+            /* Reuse this context and increase the reference number */
+            ns_ctx_data[i].ref_cnt++;
+            *idx = i;
+            __enable_irq();
+            return true;
+        } else {
+            /* No more thread for this group */
+            __enable_irq();
+            return false;
         }
     }
 
-    /* No existing context for the group ID, use the first free context */
-    if (empty_ctx_idx < TFM_NS_CONTEXT_MAX) {
-        ns_ctx_data[empty_ctx_idx].ref_cnt++;
-        ns_ctx_data[empty_ctx_idx].gid = gid;
-        *idx = empty_ctx_idx;
-        __enable_irq();
-        return true;
-    } else {
+    if (free_ns_ctx_bitmap == 0) {
         __enable_irq();
         return false;   /* No available context */
     }
+
+    /* No existing context for the group ID, use the lowest free context */
+    i = (uint8_t)__CLZ(__RBIT(free_ns_ctx_bitmap));
+    free_ns_ctx_bitmap &= ~(1U << i);
+    gid_to_ns_ctx[gid] = i + 1;
+    ns_ctx_data[i].ref_cnt = 1;
+    ns_ctx_data[i].gid = gid;
+    *idx = i;
+    __enable_irq();
+    return true;
 }
 
 bool release_ns_ctx(uint8_t gid, uint8_t tid, uint8_t idx)
@@ -110,9 +126,7 @@ bool release_ns_ctx(uint8_t gid, uint8_t tid, uint8_t idx)
     if (idx == active_ns_ctx_index) {
         if (ns_ctx_data[idx].tid == tid) {
             /* Release the currrent active thread */
-            if (ns_ctx_data[idx].ref_cnt > 0) {
-                ns_ctx_data[idx].ref_cnt--;
-            }
+            put_ns_ctx(idx);
             active_ns_ctx_index = TFM_NS_CONTEXT_MAX;
         } else {
             /*
@@ -126,9 +140,7 @@ bool release_ns_ctx(uint8_t gid, uint8_t tid, uint8_t idx)
         }
     } else {
         /* Release in the non-active context */
-        if (ns_ctx_data[idx].ref_cnt > 0) {
-            ns_ctx_data[idx].ref_cnt--;
-        }
+        put_ns_ctx(idx);
     }
 
     __enable_irq();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,8 +10,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-/* Supported maximum context for NS. Only support single context for now. */
+/*
+ * Supported maximum context for NS. The free contexts are tracked in a 32-bit
+ * bitmap, which limits the number to 32.
+ */
+#ifndef TFM_NS_CONTEXT_MAX
 #define TFM_NS_CONTEXT_MAX                  1
+#endif
+
+#if (TFM_NS_CONTEXT_MAX < 1) || (TFM_NS_CONTEXT_MAX > 32)
+#error "TFM_NS_CONTEXT_MAX must be between 1 and 32!"
+#endif
 
 #define TFM_NS_CONTEXT_MAX_TID              0xFF
 
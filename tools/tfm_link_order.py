@@ -0,0 +1,223 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Generates the link order header of a TF-M secure image from a function hit
+count profile.
+
+The images are built with -ffunction-sections, so each function is a
+".text.<name>" input section. The GNU linker map of a previous build gives the
+output section, the object file and the address range of each of them. The hot
+functions are listed first in their output section, in decreasing hit count
+order, so that the hot SPM and partition paths are packed together.
+
+The header defines one TFM_LINK_ORDER_<output section> macro per output
+section. The TF-M GNU linker scripts expand the macro, if defined, before the
+other input sections of the output section. Functions are never moved to
+another output section, so the isolation boundaries are not changed.
+
+The profile is a text file with one function per line, given by its name or by
+an address within it, followed by its hit count:
+
+    spm_get_connection      1200
+    0x10002c41              800
+
+Addresses can come from any PC sampler, such as the DWT PC sampling or a
+debugger. Lines starting with '#' are ignored.
+"""
+
+import re
+import sys
+import argparse
+
+INPUT_SECTION = re.compile(r'^ (\.text\.\S+)'
+                           r'(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+))?$')
+SECTION_ADDR = re.compile(r'^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+)$')
+OUTPUT_SECTION = re.compile(r'^(\.\S+)')
+ARCHIVE_MEMBER = re.compile(r'([^/\\]+\.a)\(([^)]+)\)$')
+
+
+class Function:
+    def __init__(self, section, addr, size, obj, output_section):
+        self.section = section
+        self.addr = addr
+        self.size = size
+        self.obj = obj
+        self.output_section = output_section
+        self.hits = 0
+
+    def pattern(self):
+        """
+        Returns the linker script input section description of the function,
+        qualified by its object file, as functions of different objects can
+        have the same name.
+        """
+        member = ARCHIVE_MEMBER.search(self.obj)
+        if member:
+            return '*{}:{}({})'.format(member.group(1), member.group(2),
+                                       self.section)
+
+        return '*{}({})'.format(re.split(r'[/\\]', self.obj)[-1], self.section)
+
+
+def parse_map(path):
+    """
+    Returns the functions of a GNU linker map, keyed by the name of their
+    input section.
+    """
+    functions = {}
+    in_memory_map = False
+    pending = None
+    output_section = None
+
+    with open(path, 'r', errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\r\n')
+
+            if not in_memory_map:
+                in_memory_map = line.startswith('Linker script and memory map')
+                continue
+
+            if pending:
+                # The section name was too long, the address is on this line
+                section, pending = pending, None
+                match = SECTION_ADDR.match(line)
+                if match:
+                    add_function(functions, section, *match.groups(),
+                                 output_section)
+                continue
+
+            if line.startswith('.'):
+                output_section = OUTPUT_SECTION.match(line).group(1)
+                continue
+
+            match = INPUT_SECTION.match(line)
+            if not match:
+                continue
+
+            if match.group(2) is None:
+                pending = match.group(1)
+            else:
+                add_function(functions, *match.groups(), output_section)
+
+    return functions
+
+
+def add_function(functions, section, addr, size, obj, output_section):
+    addr = int(addr, 16)
+    size = int(size, 16)
+
+    # Sections discarded by the linker are listed at address 0
+    if size == 0 or addr == 0:
+        return
+
+    functions.setdefault(section, []).append(
+        Function(section, addr, size, obj.strip(), output_section))
+
+
+def apply_profile(functions, path):
+    """
+    Adds the hit counts of the profile to the functions. Returns the number
+    of profile lines that match no function.
+    """
+    by_addr = sorted((func for funcs in functions.values() for func in funcs),
+                     key=lambda func: func.addr)
+    unknown = 0
+
+    with open(path, 'r') as f:
+        for line in f:
+            fields = line.split()
+            if not fields or fields[0].startswith('#'):
+                continue
+
+            hits = int(fields[1], 0) if len(fields) > 1 else 1
+
+            if re.match(r'^(0x)?[0-9a-fA-F]+$', fields[0]) and \
+               '.text.' + fields[0] not in functions:
+                # Clear the Thumb bit of function pointers
+                addr = int(fields[0], 16) & ~1
+                matches = [func for func in by_addr
+                           if func.addr <= addr < func.addr + func.size]
+            else:
+                matches = functions.get('.text.' + fields[0], [])
+
+            if not matches:
+                unknown += 1
+            for func in matches:
+                func.hits += hits
+
+    return unknown
+
+
+def macro_name(output_section):
+    return 'TFM_LINK_ORDER_' + re.sub(r'\W', '_', output_section.lstrip('.'))
+
+
+def write_header(functions, out):
+    sections = {}
+
+    for funcs in functions.values():
+        for func in funcs:
+            if func.hits:
+                sections.setdefault(func.output_section, []).append(func)
+
+    out.write('/*\n'
+              ' * Generated by tools/tfm_link_order.py. Do not edit!\n'
+              ' *\n'
+              ' * Hot functions of each output section, in decreasing hit\n'
+              ' * count order.\n'
+              ' */\n\n'
+              '#ifndef __TFM_LINK_ORDER_H__\n'
+              '#define __TFM_LINK_ORDER_H__\n')
+
+    for output_section, funcs in sorted(sections.items()):
+        funcs.sort(key=lambda func: (-func.hits, func.addr))
+        lines = ['#define {}'.format(macro_name(output_section))]
+        lines.extend('        {}'.format(func.pattern()) for func in funcs)
+        out.write('\n' + ' \\\n'.join(lines) + '\n')
+
+    out.write('\n#endif /* __TFM_LINK_ORDER_H__ */\n')
+
+    return sections
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+                        description='Generate the secure image link order'
+                                    ' header from a function hit count'
+                                    ' profile')
+    parser.add_argument('-m', '--map',
+                        required=True,
+                        help='The GNU linker map of the profiled image, such'
+                             ' as tfm_s.map')
+    parser.add_argument('-p', '--profile',
+                        required=True,
+                        help='The function hit counts')
+    parser.add_argument('-o', '--output',
+                        required=True,
+                        help='The link order header to write, to pass to'
+                             ' the next build in TFM_S_LINK_ORDER_FILE')
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    functions = parse_map(args.map)
+    unknown = apply_profile(functions, args.profile)
+
+    with open(args.output, 'w') as f:
+        sections = write_header(functions, f)
+
+    for output_section, funcs in sorted(sections.items()):
+        print('{:<32}{:>6} functions {:>8} bytes'.format(
+              output_section, len(funcs), sum(func.size for func in funcs)))
+    if unknown:
+        print('{} profile entries match no function'.format(unknown))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,232 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Decodes the log output of a TF-M secure image built with TFM_LOG_TOKENIZED.
+
+The binary records are described in secure_fw/spm/include/tfm_log_token.h.
+Their tokens are the addresses of the message strings in the secure image, so
+the strings are read from the loadable segments of the image ELF file. Any
+other output is passed through unchanged.
+"""
+
+import sys
+import struct
+import argparse
+
+TOKEN_SPM_MSG = 0xC0
+TOKEN_SPM_MSGVAL = 0xC1
+TOKEN_SP_FMT = 0xF8
+
+PT_LOAD = 1
+
+
+class ElfImage:
+    """
+    Loadable segments of a 32-bit little endian ELF file.
+    """
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+
+        if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+            raise ValueError('{} is not a 32-bit little endian ELF file'
+                             .format(path))
+
+        phoff, = struct.unpack_from('<I', data, 28)
+        phentsize, phnum = struct.unpack_from('<HH', data, 42)
+
+        self.segments = []
+        for i in range(phnum):
+            p_type, p_offset, p_vaddr, p_paddr, p_filesz = \
+                struct.unpack_from('<IIIII', data, phoff + i * phentsize)
+            if p_type == PT_LOAD and p_filesz:
+                self.segments.append((p_vaddr,
+                                      data[p_offset:p_offset + p_filesz]))
+                if p_paddr != p_vaddr:
+                    self.segments.append((p_paddr,
+                                          data[p_offset:p_offset + p_filesz]))
+
+    def string(self, address):
+        for base, content in self.segments:
+            if base <= address < base + len(content):
+                end = content.find(b'\0', address - base)
+                if end < 0:
+                    end = len(content)
+                return content[address - base:end].decode('utf-8', 'replace')
+
+        return '[Unknown token 0x{:08x}]'.format(address)
+
+
+INT_TAGS = 'diuxXpc'
+STR_TAG = 's'
+
+
+def read_sp_args(fmt, nargs, buf, pos):
+    """
+    Reads the arguments of a partition printf record, the types of which are
+    given by the format string. Returns the arguments and the position of the
+    end of the record, or None if buf doesn't hold the whole record yet.
+    """
+    args = []
+    i = 0
+
+    while i < len(fmt) and len(args) < nargs:
+        if fmt[i] != '%' or i + 1 == len(fmt):
+            i += 1
+            continue
+
+        tag = fmt[i + 1]
+        if tag in INT_TAGS:
+            if pos + 4 > len(buf):
+                return None
+            args.append(struct.unpack_from('<I', buf, pos)[0])
+            pos += 4
+        elif tag == STR_TAG:
+            if pos + 1 > len(buf) or pos + 1 + buf[pos] > len(buf):
+                return None
+            args.append(buf[pos + 1:pos + 1 + buf[pos]]
+                        .decode('utf-8', 'replace'))
+            pos += 1 + buf[pos]
+        elif tag != '%':
+            # Unsupported tags don't take an argument
+            i += 1
+            continue
+        i += 2
+
+    return args, pos
+
+
+def format_sp(fmt, args):
+    """
+    Formats a partition printf record the way tfm_sp_log_raw.c would. The
+    arguments that didn't fit in the record are output as '?'.
+    """
+    out = []
+    i = 0
+
+    while i < len(fmt):
+        if fmt[i] != '%':
+            out.append(fmt[i])
+            i += 1
+            continue
+
+        tag = fmt[i + 1] if i + 1 < len(fmt) else ''
+        if tag == '%':
+            out.append('%')
+        elif tag and tag in INT_TAGS + STR_TAG:
+            if not args:
+                out.append('?')
+            else:
+                val = args.pop(0)
+                if tag in 'di':
+                    out.append(str(val - (1 << 32) if val & (1 << 31)
+                                   else val))
+                elif tag == 'u':
+                    out.append(str(val))
+                elif tag == 'x':
+                    out.append('{:x}'.format(val))
+                elif tag == 'X':
+                    out.append('{:X}'.format(val))
+                elif tag == 'p':
+                    out.append('0x{:x}'.format(val))
+                elif tag == 'c':
+                    out.append(chr(val & 0xFF))
+                else:
+                    out.append(val)
+        else:
+            out.append('[Unsupported Tag]')
+            i += 1
+            continue
+        i += 2
+
+    return ''.join(out)
+
+
+def decode_record(image, buf):
+    """
+    Decodes the record at the start of buf. Returns the text and the length of
+    the record, or None if buf doesn't hold the whole record yet.
+    """
+    header = buf[0]
+
+    if len(buf) < 5:
+        return None
+    token, = struct.unpack_from('<I', buf, 1)
+
+    if header == TOKEN_SPM_MSG:
+        return image.string(token), 5
+
+    if header == TOKEN_SPM_MSGVAL:
+        if len(buf) < 9:
+            return None
+        value, = struct.unpack_from('<I', buf, 5)
+        msg = image.string(token) if token else ''
+        return '{}0x{:08X}\r\n'.format(msg, value), 9
+
+    fmt = image.string(token)
+    result = read_sp_args(fmt, header & 0x7, buf, 5)
+    if result is None:
+        return None
+
+    args, length = result
+    return format_sp(fmt, args), length
+
+
+def decode(image, infile, outfile):
+    buf = b''
+
+    while True:
+        chunk = infile.read(1)
+        if not chunk:
+            break
+        buf += chunk
+
+        while buf:
+            if buf[0] not in (TOKEN_SPM_MSG, TOKEN_SPM_MSGVAL) and \
+               buf[0] < TOKEN_SP_FMT:
+                outfile.write(buf[:1].decode('latin-1'))
+                buf = buf[1:]
+                continue
+
+            result = decode_record(image, buf)
+            if result is None:
+                break
+
+            text, length = result
+            outfile.write(text)
+            buf = buf[length:]
+
+        outfile.flush()
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+                        description='Decode the tokenized TF-M secure log')
+    parser.add_argument('-e', '--elf',
+                        required=True,
+                        help='The secure image ELF file, such as tfm_s.elf')
+    parser.add_argument('-i', '--input',
+                        default='-',
+                        help='The log capture, or the serial device, to read.'
+                             ' Defaults to the standard input')
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    image = ElfImage(args.elf)
+
+    if args.input == '-':
+        decode(image, sys.stdin.buffer, sys.stdout)
+    else:
+        with open(args.input, 'rb', buffering=0) as infile:
+            decode(image, infile, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,252 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Reports the RAM used by each Secure Partition of a TF-M secure image.
+
+The GNU linker map of the image is parsed, and the .data and .bss input
+sections are attributed to the partition library, or the source directory, of
+their object file. Partition stacks are the "<name>_stack" variables. The
+images are built with -fdata-sections, so the biggest variables of each
+partition are listed as well.
+
+The values of the TF-M config macros are read from the given config headers,
+so that reports of different builds can be compared. The report is written as
+JSON for CI, and summarized on the standard output.
+"""
+
+import re
+import sys
+import json
+import argparse
+
+# Partition libraries are named tfm_<psa|app>_rot_partition_<name>
+PARTITION_LIB = re.compile(r'^(?:lib)?tfm_(?:psa|app)_rot_partition_(\w+)$')
+
+# Libraries that don't follow the partition library naming
+LIBRARY_OWNERS = {
+    'tfm_spm': 'spm',
+    'tfm_sprt': 'sprt',
+    'platform_s': 'platform_s',
+    'crypto_service_mbedcrypto': 'crypto',
+    'tfm_fih': 'fih',
+}
+
+# Output sections allocated by the secure linker script
+OUTPUT_SECTION_USES = {
+    '.msp_stack': ('spm', 'stack'),
+    '.heap': ('system', 'heap'),
+}
+
+INPUT_SECTION = re.compile(r'^ (\.(?:data|bss|sbss|sdata)\S*|COMMON)'
+                           r'(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+))?$')
+SECTION_ADDR = re.compile(r'^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+)$')
+OUTPUT_SECTION = re.compile(r'^(\.\S+)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+))?')
+ARCHIVE_MEMBER = re.compile(r'([^/\\]+)\.a\(([^)]+)\)$')
+SOURCE_DIR = re.compile(r'(?:partitions|spm|platform)[/\\]([^/\\]+)')
+CONFIG_DEFINE = re.compile(r'^\s*#\s*define\s+([A-Za-z_]\w*)(?!\()\s+(.+?)\s*$')
+
+USES = ('data', 'bss', 'stack', 'heap')
+
+
+def owner_of(obj):
+    """
+    Returns the partition, or the component, that an object file of the map
+    belongs to.
+    """
+    member = ARCHIVE_MEMBER.search(obj)
+    if member:
+        lib = member.group(1)
+        if lib.startswith('lib'):
+            lib = lib[3:]
+        partition = PARTITION_LIB.match(lib)
+        if partition:
+            return partition.group(1)
+        return LIBRARY_OWNERS.get(lib, lib)
+
+    # Objects linked straight into the image, such as the load info of the
+    # SPM built-in partitions
+    directory = SOURCE_DIR.findall(obj)
+    if directory:
+        return directory[-1]
+
+    return 'other'
+
+
+def use_of(section):
+    """
+    Returns the use of a .data or .bss input section, and the name of its
+    variable.
+    """
+    name = section.split('.', 2)[2] if section.count('.') >= 2 else ''
+
+    if section.startswith(('.data', '.sdata')):
+        return 'data', name
+    if name.endswith('_stack'):
+        return 'stack', name
+    return 'bss', name
+
+
+def parse_map(path):
+    """
+    Returns the list of (owner, use, name, size) of the RAM input sections of
+    a GNU linker map.
+    """
+    entries = []
+    in_memory_map = False
+    pending = None
+    output_section = None
+
+    with open(path, 'r', errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\r\n')
+
+            if not in_memory_map:
+                in_memory_map = line.startswith('Linker script and memory map')
+                continue
+
+            if pending:
+                # The section name was too long, the address is on this line
+                section, pending = pending, None
+                match = SECTION_ADDR.match(line)
+                if match:
+                    add_section(entries, section, *match.groups())
+                continue
+
+            if line.startswith('.'):
+                match = OUTPUT_SECTION.match(line)
+                output_section = match.group(1)
+                if output_section in OUTPUT_SECTION_USES and match.group(3):
+                    owner, use = OUTPUT_SECTION_USES[output_section]
+                    size = int(match.group(3), 16)
+                    if size:
+                        entries.append((owner, use, output_section, size))
+                continue
+
+            # Space reserved by the output sections above is already counted
+            if output_section in OUTPUT_SECTION_USES:
+                continue
+
+            match = INPUT_SECTION.match(line)
+            if not match:
+                continue
+
+            if match.group(2) is None:
+                pending = match.group(1)
+            else:
+                add_section(entries, *match.groups())
+
+    return entries
+
+
+def add_section(entries, section, addr, size, obj):
+    size = int(size, 16)
+
+    # Sections discarded by the linker are listed at address 0
+    if size == 0 or int(addr, 16) == 0:
+        return
+
+    use, name = use_of(section)
+    entries.append((owner_of(obj.strip()), use, name or section, size))
+
+
+def parse_config(headers):
+    """
+    Returns the macros defined by the config headers. The headers are given in
+    the order config_tfm.h includes them, so the first definition of a macro
+    is the one that is used.
+    """
+    config = {}
+
+    for header in headers:
+        with open(header, 'r', errors='replace') as f:
+            for line in f:
+                match = CONFIG_DEFINE.match(line)
+                if match and match.group(1) not in config:
+                    value = match.group(2).split('/*')[0].strip()
+                    if value:
+                        config[match.group(1)] = value
+
+    return config
+
+
+def build_report(entries, config, top):
+    partitions = {}
+
+    for owner, use, name, size in entries:
+        partition = partitions.setdefault(owner, {
+            'data': 0, 'bss': 0, 'stack': 0, 'heap': 0, 'total': 0,
+            'symbols': []
+        })
+        partition[use] += size
+        partition['total'] += size
+        partition['symbols'].append({'name': name, 'use': use, 'size': size})
+
+    for partition in partitions.values():
+        partition['symbols'].sort(key=lambda s: s['size'], reverse=True)
+        del partition['symbols'][top:]
+
+    total = {use: sum(p[use] for p in partitions.values()) for use in USES}
+    total['total'] = sum(total.values())
+
+    return {
+        'config': config,
+        'partitions': dict(sorted(partitions.items())),
+        'total': total,
+    }
+
+
+def print_report(report, out):
+    row = '{:<24}' + '{:>10}' * (len(USES) + 1) + '\n'
+
+    out.write(row.format('Partition', *USES, 'total'))
+    for name, partition in report['partitions'].items():
+        out.write(row.format(name, *[partition[use] for use in USES],
+                             partition['total']))
+    out.write(row.format('Total', *[report['total'][use] for use in USES],
+                         report['total']['total']))
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+                        description='Report the RAM used by each secure'
+                                    ' partition from the linker map')
+    parser.add_argument('-m', '--map',
+                        required=True,
+                        help='The GNU linker map of the image, such as'
+                             ' tfm_s.map')
+    parser.add_argument('-c', '--config',
+                        nargs='*',
+                        default=[],
+                        help='The config headers, in the order they are'
+                             ' included by config_tfm.h')
+    parser.add_argument('-o', '--output',
+                        help='The JSON report file to write')
+    parser.add_argument('-t', '--top',
+                        type=int,
+                        default=5,
+                        help='Number of biggest variables to list per'
+                             ' partition')
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    report = build_report(parse_map(args.map),
+                          parse_config(args.config),
+                          args.top)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=4)
+            f.write('\n')
+
+    print_report(report, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -31,6 +31,11 @@ OUT_DIR = None # The root directory that files are generated to
 # PID[0, TFM_PID_BASE - 1] are reserved for TF-M SPM and test usages
 TFM_PID_BASE = 256
 
+# SPM objects on the path of a PSA API call to a Partition and its reply
+SPM_HOT_OBJECTS = ['spm_ipc', 'psa_api', 'psa_call_api', 'backend_ipc',
+                   'thread', 'tfm_core_svcalls_ipc', 'spm_cross_call',
+                   'tfm_arch_v8m_main', 'tfm_arch_v8m_base', 'tfm_arch_v6m_v7m']
+
 # variable for checking for duplicated sid
 sid_list = []
 class TemplateLoader(BaseLoader):
@@ -114,6 +119,55 @@ def manifest_validation(manifest, pid):
     if 'ns_agent' not in manifest:
         manifest['ns_agent'] = False
 
+    # "uses_fpu" validation
+    if 'uses_fpu' not in manifest:
+        manifest['uses_fpu'] = True
+    elif manifest['uses_fpu'] not in [True, False]:
+        raise Exception('Invalid uses_fpu of {}'.format(manifest['name']))
+
+    # "lazy_init" validation
+    if 'lazy_init' not in manifest:
+        manifest['lazy_init'] = False
+    elif manifest['lazy_init'] not in [True, False]:
+        raise Exception('Invalid lazy_init of {}'.format(manifest['name']))
+    elif manifest['lazy_init'] and len(irq_list) > 0:
+        # Interrupts could be handled before the Partition is initialized
+        raise Exception('{} with IRQs cannot use lazy_init'.format(manifest['name']))
+
+    # "hot" validation
+    if 'hot' not in manifest:
+        manifest['hot'] = False
+    elif manifest['hot'] not in [True, False]:
+        raise Exception('Invalid hot of {}'.format(manifest['name']))
+
+    # "core" validation, the number of secure cores is checked by the caller
+    if 'core' not in manifest:
+        manifest['core'] = 0
+    elif not isinstance(manifest['core'], int) or isinstance(manifest['core'], bool) \
+         or manifest['core'] < 0:
+        raise Exception('Invalid core of {}'.format(manifest['name']))
+
+    # "stack_group" validation, the groups are checked by process_stack_groups()
+    if 'stack_group' not in manifest:
+        manifest['stack_group'] = None
+    elif not isinstance(manifest['stack_group'], str) or \
+         not re.match(r'^[A-Za-z_][A-Za-z0-9_]*$', manifest['stack_group']):
+        raise Exception('Invalid stack_group of {}'.format(manifest['name']))
+
+    # IRQ "irq_coalesce_count" and "irq_coalesce_us" validation
+    for irq in irq_list:
+        for attr in ['irq_coalesce_count', 'irq_coalesce_us']:
+            if attr not in irq:
+                irq[attr] = 0
+            elif not isinstance(irq[attr], int) or isinstance(irq[attr], bool) \
+                 or irq[attr] < 0 or irq[attr] > 0xFFFFFFFF:
+                raise Exception('Invalid {} of {}'.format(attr, manifest['name']))
+        if irq['irq_coalesce_count'] == 1 and irq['irq_coalesce_us'] == 0:
+            irq['irq_coalesce_count'] = 0
+        if irq['irq_coalesce_us'] and irq['irq_coalesce_count'] == 0:
+            raise Exception('irq_coalesce_us requires irq_coalesce_count in {}'
+                            .format(manifest['name']))
+
     # Every PSA Partition must have at least either a secure service or an IRQ
     if (pid == None or pid >= TFM_PID_BASE) \
        and len(service_list) == 0 and len(irq_list) == 0:
@@ -216,6 +270,154 @@ def validate_dependency_chain(partition,
         validate_dependency_chain(dependency, dependency_table, dependency_chain)
     dependency_table[partition]['validated'] = True
 
+def get_dependency_closure(partitions, service_partition_map):
+    """
+    This function collects the Partitions each Partition can wait for, directly
+    or through the Partitions it calls.
+
+    Inputs:
+        - partitions:            list of partitions
+        - service_partition_map: map between services and their owner Partitions
+
+    Returns:
+        The dict of the Partition names to the sets of Partition names
+    """
+    direct = {}
+    for partition in partitions:
+        manifest = partition['manifest']
+        dependencies = manifest.get('dependencies', []) + \
+                       manifest.get('weak_dependencies', [])
+        direct[manifest['name']] = set(service_partition_map[dependency]
+                                       for dependency in dependencies
+                                       if dependency in service_partition_map)
+
+    closure = {}
+    for name in direct.keys():
+        closure[name] = set()
+        pending = list(direct[name])
+        while pending:
+            dependency = pending.pop()
+            if dependency not in closure[name]:
+                closure[name].add(dependency)
+                pending.extend(direct[dependency])
+
+    return closure
+
+def process_stack_groups(partitions, service_partition_map, backend,
+                         isolation_level):
+    """
+    This function checks the Partitions sharing a stack with the "stack_group"
+    attribute, and sets up the shared stacks.
+
+    The IPC backend runs one group member at a time on the shared stack, from
+    the start of a message until the Partition waits for the next one. A member
+    waiting for another member, even through other Partitions, would deadlock,
+    so the groups must be of SFN Partitions of the same priority and core that
+    do not depend on each other. The SFN backend already runs all the
+    Partitions on one stack, and ignores the attribute.
+
+    Inputs:
+        - partitions:            list of partitions
+        - service_partition_map: map between services and their owner Partitions
+        - backend:               the SPM backend
+        - isolation_level:       the isolation level
+
+    Returns:
+        The number of stack groups
+    """
+    groups = {}
+    for partition in partitions:
+        manifest = partition['manifest']
+        if manifest['stack_group'] is not None:
+            groups.setdefault(manifest['stack_group'], []).append(manifest)
+
+    if backend != 'IPC':
+        for manifest in sum(groups.values(), []):
+            manifest['stack_group'] = None
+        return 0
+
+    closure = get_dependency_closure(partitions, service_partition_map)
+
+    for group, members in list(groups.items()):
+        if len(members) == 1:
+            logging.info('Stack group {} has only {}, it is not shared'
+                         .format(group, members[0]['name']))
+            members[0]['stack_group'] = None
+            del groups[group]
+            continue
+
+        if isolation_level > 1:
+            raise Exception('Stack group {} requires isolation level 1'
+                            .format(group))
+
+        names = set(manifest['name'] for manifest in members)
+        for manifest in members:
+            if manifest['model'] != 'SFN' or manifest['ns_agent'] or \
+               len(manifest.get('irqs', [])) > 0:
+                raise Exception('{} must be an SFN Partition without IRQs to '
+                                'join stack group {}'
+                                .format(manifest['name'], group))
+            if manifest['priority'] != members[0]['priority'] or \
+               manifest['core'] != members[0]['core']:
+                raise Exception('{} does not have the priority and core of {} '
+                                'in stack group {}'
+                                .format(manifest['name'], members[0]['name'],
+                                        group))
+            blocking = closure[manifest['name']] & names
+            if blocking:
+                raise Exception('{} can wait for {} in stack group {}'
+                                .format(manifest['name'],
+                                        ', '.join(sorted(blocking)), group))
+
+        # The largest stack of the members, as a C expression
+        size = members[0]['stack_size']
+        for manifest in members[1:]:
+            size = '(({0}) > ({1}) ? ({0}) : ({1}))'.format(size,
+                                                           manifest['stack_size'])
+        for manifest in members:
+            manifest['stack_group_size'] = size
+            manifest['stack_group_lead'] = manifest is members[0]
+
+        logging.info('Stack group {}: {}'
+                     .format(group, ', '.join(manifest['name']
+                                              for manifest in members)))
+
+    return len(groups)
+
+def calc_conn_handle_num(configs, partition_statistics):
+    """
+    Calculate the connection pool size needed by the enabled Partitions.
+
+    Every client can have one stateless request in flight, and can hold one
+    connection to each connection-based service at the same time.
+    NSPE clients are the mailbox queue slots in multi-core topology, or the
+    NSPE client threads otherwise. The pool is never made smaller than the
+    former default of 8 connections.
+
+    Parameters
+    ----------
+    configs:
+        The build configurations
+    partition_statistics:
+        The statistics of the enabled Partitions
+
+    Returns
+    -------
+    The number of connections to allocate, as a string.
+    """
+    if configs.get('TFM_MULTI_CORE_TOPOLOGY', '0') == '1':
+        ns_client_num = int(configs.get('NUM_MAILBOX_QUEUE_SLOT', '1'), base = 10)
+    else:
+        ns_client_num = int(configs.get('TFM_NS_CLIENT_THREAD_NUM', '1'), base = 10)
+
+    client_num = ns_client_num + partition_statistics['client_partition_num']
+    conn_num = client_num * (1 + partition_statistics['connection_based_srv_num'])
+
+    logging.info('Connection pool: {} clients, {} connection-based services, {} connections'
+                 .format(client_num, partition_statistics['connection_based_srv_num'], conn_num))
+
+    return str(max(conn_num, 8))
+
 def process_partition_manifests(manifest_lists, configs):
     """
     Parse the input manifest lists, check if manifest settings are valid,
@@ -241,10 +443,12 @@ def process_partition_manifests(manifest_lists, configs):
     service_partition_map = {}
     partition_statistics = {
         'connection_based_srv_num': 0,
+        'client_partition_num': 0,
         'ipc_partitions': [],
         'mmio_region_num': 0,
         'flih_num': 0,
-        'slih_num': 0
+        'slih_num': 0,
+        'irq_coalesce_num': 0
     }
     config_impl = {
         'CONFIG_TFM_SPM_BACKEND_SFN'              : '0',
@@ -255,11 +459,17 @@ def process_partition_manifests(manifest_lists, configs):
         'CONFIG_TFM_CONNECTION_BASED_SERVICE_API' : '0',
         'CONFIG_TFM_MMIO_REGION_ENABLE'           : '0',
         'CONFIG_TFM_FLIH_API'                     : '0',
-        'CONFIG_TFM_SLIH_API'                     : '0'
+        'CONFIG_TFM_SLIH_API'                     : '0',
+        'CONFIG_TFM_IRQ_COALESCE'                 : '0',
+        'CONFIG_TFM_CONN_HANDLE_AUTO_NUM'         : '1',
+        'CONFIG_TFM_SPM_SECURE_CORE_NUM'          : '1',
+        'CONFIG_TFM_STACK_GROUP_NUM'              : '0'
     }
 
     isolation_level = int(configs['TFM_ISOLATION_LEVEL'], base = 10)
     backend = configs['CONFIG_TFM_SPM_BACKEND']
+    secure_core_num = int(configs.get('TFM_SPM_SECURE_CORE_NUM', '1'), base = 10)
+    config_impl['CONFIG_TFM_SPM_SECURE_CORE_NUM'] = str(secure_core_num)
 
     # Get all the manifests information as a dictionary
     for i, item in enumerate(manifest_lists):
@@ -330,11 +540,21 @@ def process_partition_manifests(manifest_lists, configs):
                 manifest['model'] = backend
             manifest = manifest_validation(manifest, pid)
 
+        if manifest['core'] >= secure_core_num:
+            raise Exception('{} is pinned to core {}, but TFM_SPM_SECURE_CORE_NUM is {}'
+                            .format(manifest['name'], manifest['core'],
+                                    secure_core_num))
+
         if pid == None or pid >= TFM_PID_BASE:
             # Count the number of IPC/SFN partitions
             if manifest['model'] == 'IPC':
                 partition_statistics['ipc_partitions'].append(manifest['name'])
 
+        # Partitions depending on services are the Secure clients
+        if len(manifest.get('dependencies', [])) > 0 or \
+           len(manifest.get('weak_dependencies', [])) > 0:
+            partition_statistics['client_partition_num'] += 1
+
         # Set initial value to -1 to make (srv_idx + 1) reflect the correct
         # number (0) when there are no services.
         srv_idx = -1
@@ -365,6 +585,8 @@ def process_partition_manifests(manifest_lists, configs):
                 partition_statistics['flih_num'] += 1
             else:
                 partition_statistics['slih_num'] += 1
+            if irq['irq_coalesce_count'] > 0:
+                partition_statistics['irq_coalesce_num'] += 1
         logging.debug('{} has {} IRQS'.format(manifest['name'], irq_idx +1))
 
         if ((srv_idx + 1) + (irq_idx + 1)) > 28:
@@ -427,20 +649,36 @@ def process_partition_manifests(manifest_lists, configs):
         else:
             config_impl['CONFIG_TFM_PSA_API_CROSS_CALL'] = '1'
 
+    config_impl['CONFIG_TFM_STACK_GROUP_NUM'] = \
+        str(process_stack_groups(partition_list, service_partition_map,
+                                 backend, isolation_level))
+
     if partition_statistics['connection_based_srv_num'] > 0:
         config_impl['CONFIG_TFM_CONNECTION_BASED_SERVICE_API'] = 1
 
     if partition_statistics['mmio_region_num'] > 0:
         config_impl['CONFIG_TFM_MMIO_REGION_ENABLE'] = 1
 
+    config_impl['CONFIG_TFM_CONN_HANDLE_AUTO_NUM'] = \
+        calc_conn_handle_num(configs, partition_statistics)
+
     if partition_statistics['flih_num'] > 0:
         config_impl['CONFIG_TFM_FLIH_API'] = 1
     if partition_statistics['slih_num'] > 0:
         config_impl['CONFIG_TFM_SLIH_API'] = 1
+    if partition_statistics['irq_coalesce_num'] > 0:
+        config_impl['CONFIG_TFM_IRQ_COALESCE'] = 1
 
     context['partitions'] = partition_list
     context['config_impl'] = config_impl
     context['stateless_services'] = process_stateless_services(partition_list)
+    context['sorted_sids'] = process_sorted_sids(partition_list)
+    context['sid_hash'] = process_id_hash(
+        [int(sid, 16) for sid in context['sorted_sids']], 'SIDs')
+    context['sorted_pids'] = process_sorted_pids(partition_list)
+    context['pid_hash'] = process_id_hash(context['sorted_pids'], 'PIDs')
+    context['hot_sections'] = process_hot_sections(partition_list, configs,
+                                                   isolation_level)
 
     return context
 
@@ -529,6 +767,127 @@ def gen_summary_files(context, gen_file_lists):
         outfile.write(template.render(context))
         outfile.close()
 
+def process_sorted_sids(partitions):
+    """
+    This function collects the SIDs of all services and sorts them in
+    ascending order. SPM uses the sorted SID list as the index of its service
+    lookup table.
+
+    Inputs:
+        - partitions: list of partitions
+
+    Returns:
+        The sorted list of SIDs in hexadecimal strings
+    """
+    sids = []
+
+    for partition in partitions:
+        for service in partition['manifest'].get('services', []):
+            try:
+                sids.append(int(str(service['sid']), 0))
+            except ValueError:
+                raise Exception('Invalid SID: {} of service {}'
+                                .format(service['sid'], service['name']))
+
+    return ['0x{0:08x}'.format(sid) for sid in sorted(sids)]
+
+def process_sorted_pids(partitions):
+    """
+    This function collects the PIDs of all partitions and sorts them in
+    ascending order. SPM uses the sorted PID list as the index of its
+    partition lookup table.
+
+    Inputs:
+        - partitions: list of partitions
+
+    Returns:
+        The sorted list of PIDs
+    """
+    return sorted(partition['attr']['pid'] for partition in partitions)
+
+def process_id_hash(sorted_ids, id_name):
+    """
+    This function finds a multiplicative hash that maps every ID to its own
+    slot of a power of two sized table, so that SPM finds a service or a
+    partition with a fixed number of loads instead of a search.
+
+    slot = (ID * multiplier) >> shift, on 32 bits
+
+    Inputs:
+        - sorted_ids: the sorted list of IDs, SIDs or PIDs
+        - id_name: the name of the IDs for the error message
+
+    Returns:
+        The multiplier, the shift, and the index in sorted_ids of the ID of
+        each slot, or the number of IDs for empty slots
+    """
+    ids = [key & 0xFFFFFFFF for key in sorted_ids]
+    bits = max(1, (2 * len(ids) - 1).bit_length())
+
+    if len(set(ids)) != len(ids):
+        raise Exception('Duplicated {}'.format(id_name))
+
+    while True:
+        # Odd multipliers starting from the golden ratio spread the IDs well
+        for multiplier in range(0x9E3779B1, 0x9E3779B1 + 2 * 4096, 2):
+            slots = [((key * multiplier) & 0xFFFFFFFF) >> (32 - bits)
+                     for key in ids]
+            if len(set(slots)) == len(slots):
+                index = [len(ids)] * (1 << bits)
+                for idx, slot in enumerate(slots):
+                    index[slot] = idx
+                return {
+                    'multiplier': '0x{0:08x}'.format(multiplier),
+                    'shift': 32 - bits,
+                    'index': index,
+                }
+        bits += 1
+
+def process_hot_sections(partitions, configs, isolation_level):
+    """
+    This function collects the input section patterns that the TF-M GNU
+    linker scripts place in the code RAM, if the platform has one. They are
+    the code of the Partitions that set the "hot" attribute, and the SPM IPC
+    path if CONFIG_TFM_SPM_HOT_PATH_IN_RAM is enabled.
+
+    The "hot_list" of the "linker_pattern" of a Partition selects its hot
+    code. Without it, all the code of the Partition is hot.
+
+    Inputs:
+        - partitions: list of partitions
+        - configs: the build configurations
+        - isolation_level: the isolation level
+
+    Returns:
+        The list of "archive:member" patterns
+    """
+    patterns = []
+
+    if configs.get('CONFIG_TFM_SPM_HOT_PATH_IN_RAM', '0') == '1':
+        patterns.extend(['*tfm_spm.*:{}.*'.format(obj) for obj in SPM_HOT_OBJECTS])
+
+    for partition in partitions:
+        manifest = partition['manifest']
+        if not manifest['hot']:
+            continue
+
+        # The code RAM is only accessible by privileged code in the MPU
+        # settings of the higher isolation levels.
+        if isolation_level == 3 or \
+           (isolation_level == 2 and manifest['type'] == 'APPLICATION-ROT'):
+            raise Exception('{} cannot be hot in isolation level {}'
+                            .format(manifest['name'], isolation_level))
+
+        linker_pattern = partition['attr'].get('linker_pattern', {})
+        if 'hot_list' in linker_pattern:
+            patterns.extend(linker_pattern['hot_list'])
+        else:
+            patterns.extend(['{}:*'.format(lib) for lib in
+                             linker_pattern.get('library_list', [])])
+            patterns.extend(linker_pattern.get('object_list', []))
+
+    return patterns
+
 def process_stateless_services(partitions):
     """
     This function collects all stateless services together, and allocates
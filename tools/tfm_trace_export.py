@@ -0,0 +1,469 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+"""
+Exports the SPM trace of a TF-M secure image built with CONFIG_TFM_SPM_TRACE
+as a trace in the Chrome JSON trace event format, which Perfetto and
+chrome://tracing load.
+
+The binary trace format is described in secure_fw/spm/ffm/spm_trace.h. The
+input is either a little endian memory image of spm_trace_ring, dumped by a
+debugger, or a stream of the 16 byte entries drained with spm_trace_drain().
+
+The timestamps are the DWT cycle counts, unwrapped and converted with the core
+clock given by --clock-hz. On a TrustZone core the NSPE reads the same cycle
+counter, so the secure events and an NS RTOS trace timestamped with DWT CYCCNT
+line up on one timeline. Otherwise --offset-us shifts the secure events onto
+the timeline of the other trace.
+
+With --summary, the cycles of each kind of span in the trace are also written to
+a JSON file: the psa_call() of each connection or stateless handle, the
+context switches into the RoT Service, the FLIHs of each Partition, the mailbox
+slots and the flash operations. With the IPC backend, a psa_call() lasts until
+the reply to its message. The spans recorded between the marks of a reference
+benchmark of tfm_perf_run() are also summarized per benchmark. Comparing the
+summaries of the reference benchmarks, from a TFM_PERF build, tracks the cost
+of the secure firmware across commits and platforms.
+"""
+
+import sys
+import re
+import json
+import struct
+import argparse
+
+SPM_TRACE_MAGIC = 0x53505452
+RING_HEADER_FMT = '<IIIII'
+ENTRY_FMT = '<IIII'
+
+EVT_SCHEDULE = 1
+EVT_CALL_ENTER = 2
+EVT_CALL_EXIT = 3
+EVT_REPLY_ENTER = 4
+EVT_REPLY_EXIT = 5
+EVT_FLIH_ENTER = 6
+EVT_FLIH_EXIT = 7
+EVT_SLIH = 8
+EVT_IDLE = 9
+EVT_FLIH_HANDLER = 10
+EVT_MBOX_SLOT_ALLOC = 11
+EVT_MBOX_SLOT_FREE = 12
+EVT_CALL_MSG = 13
+
+EVT_PARTITION_BASE = 0x80
+EVT_PID_SHIFT = 16
+
+EVT_FLASH_READ = 0x80
+EVT_FLASH_PROGRAM = 0x81
+EVT_FLASH_ERASE = 0x82
+EVT_FLASH_DONE = 0x83
+
+EVT_PERF_BEGIN = 0x90
+EVT_PERF_END = 0x91
+
+# The TFM_PERF_BENCH_* values of tfm_perf_defs.h
+BENCHMARKS = {
+    1: 'null_call',
+    2: 'its_set',
+    3: 'its_get',
+    4: 'ps_set',
+    5: 'ps_get',
+    6: 'hash_sha256',
+    7: 'aead_aes128_gcm',
+    8: 'sign_ecdsa_p256',
+    9: 'attest_token',
+}
+
+FLASH_OPS = {
+    EVT_FLASH_READ: 'flash read',
+    EVT_FLASH_PROGRAM: 'flash program',
+    EVT_FLASH_ERASE: 'flash erase',
+}
+
+# Tracks of the secure core. Each Partition gets its own track for the
+# events it records, from TID_PARTITION_BASE + PID.
+TRACE_PID = 1
+TID_SCHEDULER = 1
+TID_INTERRUPTS = 2
+TID_REPLY = 3
+TID_PARTITION_BASE = 1000
+
+
+def read_entries(data, stream):
+    """
+    Reads the trace entries from a ring image, or from a stream of entries.
+    Returns the entries, oldest first, and the number of lost entries.
+    """
+    entry_size = struct.calcsize(ENTRY_FMT)
+    header_size = struct.calcsize(RING_HEADER_FMT)
+
+    if not stream and len(data) >= header_size and \
+       struct.unpack_from('<I', data)[0] == SPM_TRACE_MAGIC:
+        magic, entry_num, head, tail, lost = \
+            struct.unpack_from(RING_HEADER_FMT, data)
+        if entry_num == 0 or entry_num & (entry_num - 1):
+            raise ValueError('Invalid entry number {} in the ring'
+                             .format(entry_num))
+        if len(data) < header_size + entry_num * entry_size:
+            raise ValueError('The ring image is truncated')
+
+        count = (head - tail) & 0xFFFFFFFF
+        if count > entry_num:
+            lost += count - entry_num
+            tail = (head - entry_num) & 0xFFFFFFFF
+            count = entry_num
+
+        entries = []
+        for n in range(count):
+            idx = ((tail + n) & 0xFFFFFFFF) & (entry_num - 1)
+            entries.append(struct.unpack_from(
+                ENTRY_FMT, data, header_size + idx * entry_size))
+        return entries, lost
+
+    if len(data) % entry_size:
+        raise ValueError('The entry stream is not a multiple of {} bytes'
+                         .format(entry_size))
+
+    return [struct.unpack_from(ENTRY_FMT, data, off)
+            for off in range(0, len(data), entry_size)], 0
+
+
+def read_pid_names(path):
+    """
+    Reads the Partition names from the generated psa_manifest/pid.h.
+    """
+    names = {}
+
+    with open(path, 'r') as f:
+        for line in f:
+            match = re.match(r'\s*#define\s+(\w+)\s+\((\d+)\)', line)
+            if match and match.group(1) != 'TFM_MAX_USER_PARTITIONS':
+                names[int(match.group(2))] = match.group(1)
+
+    return names
+
+
+def read_handle_names(path):
+    """
+    Reads the names of the stateless handles from the generated
+    psa_manifest/sid.h.
+    """
+    names = {}
+
+    with open(path, 'r') as f:
+        for line in f:
+            match = re.match(r'\s*#define\s+(\w+)_HANDLE\s+\((\w+?)U?\)',
+                             line)
+            if match:
+                names[int(match.group(2), 0)] = match.group(1)
+
+    return names
+
+
+def span_stats(samples):
+    """
+    Returns the count, total, minimum, maximum and nearest-rank percentiles of
+    the cycles of the spans of one kind.
+    """
+    samples = sorted(samples)
+
+    def percentile(percent):
+        rank = (len(samples) * percent + 99) // 100
+        return samples[max(rank, 1) - 1]
+
+    return {
+        'count': len(samples),
+        'total_cycles': sum(samples),
+        'min_cycles': samples[0],
+        'p50_cycles': percentile(50),
+        'p99_cycles': percentile(99),
+        'max_cycles': samples[-1],
+    }
+
+
+class TraceExporter:
+    """
+    Converts the SPM trace entries to Chrome JSON trace events.
+    """
+    def __init__(self, clock_hz, offset_us, pid_names, handle_names):
+        self.clock_hz = clock_hz
+        self.offset_us = offset_us
+        self.pid_names = pid_names
+        self.handle_names = handle_names
+        self.events = []
+        self.tracks = {}
+        self.running = None
+        self.last_raw = None
+        self.cycles = 0
+        self.open_spans = {}
+        self.spans = {}
+        self.last_call = None
+        self.msg_calls = {}
+        self.switching = False
+        self.bench = None
+        self.bench_seq = 0
+        self.benchmarks = {}
+
+    def partition(self, pid):
+        return self.pid_names.get(pid, 'partition {}'.format(pid))
+
+    def timestamp(self, raw):
+        # The 32 bit cycle counter wraps, the entries are in order
+        if self.last_raw is not None:
+            self.cycles += (raw - self.last_raw) & 0xFFFFFFFF
+        self.last_raw = raw
+
+        if self.clock_hz:
+            return self.cycles * 1000000.0 / self.clock_hz + self.offset_us
+        return self.cycles + self.offset_us
+
+    def handle(self, handle):
+        if handle in self.handle_names:
+            return self.handle_names[handle]
+        return '0x{:x}'.format(handle)
+
+    def span_begin(self, key, name):
+        self.open_spans[key] = (name, self.cycles, self.bench_seq)
+
+    def span_end(self, key):
+        if key not in self.open_spans:
+            return
+        name, begin, seq = self.open_spans.pop(key)
+        cycles = self.cycles - begin
+
+        self.spans.setdefault(name, []).append(cycles)
+
+        # The spans which started and ended inside a benchmark belong to it
+        if self.bench is not None and seq == self.bench_seq:
+            self.bench['spans'].setdefault(name, []).append(cycles)
+
+    def bench_begin(self, benchmark, iterations):
+        self.bench_seq += 1
+        self.bench = {'iterations': iterations, 'begin': self.cycles,
+                      'spans': {}}
+        self.benchmarks[BENCHMARKS.get(benchmark,
+                                       'benchmark {}'.format(benchmark))] = \
+            self.bench
+
+    def bench_end(self):
+        if self.bench is not None:
+            self.bench['cycles'] = self.cycles - self.bench.pop('begin')
+            self.bench = None
+        self.bench_seq += 1
+
+    def track(self, tid, name):
+        if tid not in self.tracks:
+            self.tracks[tid] = name
+        return tid
+
+    def emit(self, ph, ts, tid, name, **kwargs):
+        event = {'ph': ph, 'ts': ts, 'pid': TRACE_PID, 'tid': tid,
+                 'name': name}
+        event.update(kwargs)
+        self.events.append(event)
+
+    def add(self, entry):
+        raw, event, arg0, arg1 = entry
+        ts = self.timestamp(raw)
+
+        if (event & 0xFFFF) >= EVT_PARTITION_BASE:
+            self.add_partition_event(ts, event >> EVT_PID_SHIFT,
+                                     event & 0xFFFF, arg0, arg1)
+            return
+
+        sched = self.track(TID_SCHEDULER, 'SPM scheduler')
+        irq = self.track(TID_INTERRUPTS, 'Secure interrupts')
+
+        if event == EVT_SCHEDULE:
+            if self.switching:
+                self.span_end(('switch',))
+                self.switching = False
+            if self.running is not None:
+                self.emit('E', ts, sched, self.running)
+            self.running = self.partition(arg1)
+            self.emit('B', ts, sched, self.running,
+                      args={'from': self.partition(arg0)})
+        elif event == EVT_CALL_ENTER:
+            self.last_call = arg0
+            self.span_begin(('call', arg0),
+                            'psa_call {}'.format(self.handle(arg0)))
+            self.emit('b', ts, sched, 'psa_call', cat='psa_call',
+                      id='0x{:x}'.format(arg0),
+                      args={'handle': '0x{:x}'.format(arg0),
+                            'ctrl_param': '0x{:x}'.format(arg1)})
+        elif event == EVT_CALL_MSG:
+            # IPC backend: the call of the last CALL_ENTER ends at the reply
+            # to this message, and the RoT Service runs after a switch.
+            call = ('call', self.last_call)
+            if call in self.open_spans:
+                self.open_spans[('msg', arg0)] = self.open_spans.pop(call)
+                self.msg_calls[arg0] = self.last_call
+                self.span_begin(('switch',), 'context switch')
+                self.switching = True
+        elif event == EVT_CALL_EXIT:
+            if ('call', arg0) in self.open_spans:
+                self.span_end(('call', arg0))
+                self.emit('e', ts, sched, 'psa_call', cat='psa_call',
+                          id='0x{:x}'.format(arg0),
+                          args={'status': arg1 - (1 << 32)
+                                if arg1 & (1 << 31) else arg1})
+        elif event == EVT_REPLY_ENTER:
+            self.emit('B', ts, self.track(TID_REPLY, 'psa_reply'),
+                      'psa_reply', args={'msg_handle': '0x{:x}'.format(arg0),
+                                         'status': arg1})
+        elif event == EVT_REPLY_EXIT:
+            self.emit('E', ts, self.track(TID_REPLY, 'psa_reply'),
+                      'psa_reply', args={'ret': arg1})
+            if arg0 in self.msg_calls:
+                handle = self.msg_calls.pop(arg0)
+                self.span_end(('msg', arg0))
+                self.emit('e', ts, sched, 'psa_call', cat='psa_call',
+                          id='0x{:x}'.format(handle))
+        elif event == EVT_FLIH_ENTER:
+            self.span_begin(('flih', arg0),
+                            'FLIH {}'.format(self.partition(arg0)))
+            self.emit('B', ts, irq, 'FLIH {}'.format(self.partition(arg0)),
+                      args={'signal': '0x{:x}'.format(arg1)})
+        elif event == EVT_FLIH_HANDLER:
+            self.emit('i', ts, irq, 'FLIH handler', s='t',
+                      args={'mpu_switched': arg1})
+        elif event == EVT_FLIH_EXIT:
+            self.span_end(('flih', arg0))
+            self.emit('E', ts, irq, 'FLIH {}'.format(self.partition(arg0)),
+                      args={'result': arg1})
+        elif event == EVT_SLIH:
+            self.emit('i', ts, irq, 'SLIH {}'.format(self.partition(arg0)),
+                      s='t', args={'signal': '0x{:x}'.format(arg1)})
+        elif event == EVT_IDLE:
+            self.emit('i', ts, sched, 'idle', s='t',
+                      args={'state': arg0, 'wake_irq': arg1})
+        elif event in (EVT_MBOX_SLOT_ALLOC, EVT_MBOX_SLOT_FREE):
+            if event == EVT_MBOX_SLOT_ALLOC:
+                self.span_begin(('slot', arg0), 'mailbox slot')
+            else:
+                self.span_end(('slot', arg0))
+            self.emit('b' if event == EVT_MBOX_SLOT_ALLOC else 'e', ts, sched,
+                      'mailbox slot {}'.format(arg0), cat='mailbox',
+                      id='slot{}'.format(arg0),
+                      args={'ns_queue': arg1 >> 8, 'ns_slot': arg1 & 0xFF})
+        else:
+            self.emit('i', ts, sched, 'event {}'.format(event), s='t',
+                      args={'arg0': arg0, 'arg1': arg1})
+
+    def add_partition_event(self, ts, pid, event, arg0, arg1):
+        tid = self.track(TID_PARTITION_BASE + pid, self.partition(pid))
+
+        if event == EVT_PERF_BEGIN:
+            self.bench_begin(arg0, arg1)
+            self.emit('B', ts, tid, BENCHMARKS.get(arg0, 'benchmark'),
+                      args={'benchmark': arg0, 'iterations': arg1})
+        elif event == EVT_PERF_END:
+            self.bench_end()
+            self.emit('E', ts, tid, BENCHMARKS.get(arg0, 'benchmark'))
+        elif event in FLASH_OPS:
+            self.span_begin(('flash', pid), '{} {}'.format(
+                self.partition(pid), FLASH_OPS[event]))
+            self.emit('B', ts, tid, FLASH_OPS[event],
+                      args={'block': arg0, 'size': arg1})
+        elif event == EVT_FLASH_DONE:
+            self.span_end(('flash', pid))
+            self.emit('E', ts, tid, FLASH_OPS.get(arg0, 'flash'),
+                      args={'status': arg1 - (1 << 32)
+                            if arg1 & (1 << 31) else arg1})
+        else:
+            self.emit('i', ts, tid, 'event 0x{:x}'.format(event), s='t',
+                      args={'arg0': arg0, 'arg1': arg1})
+
+    def summary(self, lost):
+        benchmarks = {}
+        for name, bench in self.benchmarks.items():
+            benchmarks[name] = {
+                'iterations': bench['iterations'],
+                'cycles': bench.get('cycles'),
+                'spans': {span: span_stats(samples)
+                          for span, samples in bench['spans'].items()},
+            }
+
+        return {
+            'clock_hz': self.clock_hz,
+            'lost_entries': lost,
+            'spans': {name: span_stats(samples)
+                      for name, samples in self.spans.items()},
+            'benchmarks': benchmarks,
+        }
+
+    def trace(self, lost):
+        metadata = [{'ph': 'M', 'pid': TRACE_PID, 'name': 'process_name',
+                     'args': {'name': 'TF-M SPE'}}]
+        for tid, name in sorted(self.tracks.items()):
+            metadata.append({'ph': 'M', 'pid': TRACE_PID, 'tid': tid,
+                             'name': 'thread_name', 'args': {'name': name}})
+
+        return {
+            'traceEvents': metadata + self.events,
+            'displayTimeUnit': 'ns',
+            'otherData': {'lost_entries': lost},
+        }
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description='Export the TF-M SPM trace to a Perfetto loadable trace')
+    parser.add_argument('-i', '--input', required=True,
+                        help='The ring image or the entry stream')
+    parser.add_argument('-o', '--output',
+                        help='The JSON trace, standard output by default')
+    parser.add_argument('--stream', action='store_true',
+                        help='The input is a stream of drained entries')
+    parser.add_argument('--clock-hz', type=int, default=0,
+                        help='Core clock, one cycle is one microsecond if '
+                             'not given')
+    parser.add_argument('--offset-us', type=float, default=0.0,
+                        help='Offset added to the timestamps')
+    parser.add_argument('--pid-header',
+                        help='The generated psa_manifest/pid.h, to name the '
+                             'Partitions')
+    parser.add_argument('--sid-header',
+                        help='The generated psa_manifest/sid.h, to name the '
+                             'stateless handles')
+    parser.add_argument('--summary',
+                        help='JSON file to write the cycles of each kind of '
+                             'span to')
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    with open(args.input, 'rb') as f:
+        entries, lost = read_entries(f.read(), args.stream)
+
+    pid_names = read_pid_names(args.pid_header) if args.pid_header else {}
+
+    handle_names = read_handle_names(args.sid_header) \
+        if args.sid_header else {}
+
+    exporter = TraceExporter(args.clock_hz, args.offset_us, pid_names,
+                             handle_names)
+    for entry in entries:
+        exporter.add(entry)
+
+    if lost:
+        sys.stderr.write('{} trace entries were lost\n'.format(lost))
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    json.dump(exporter.trace(lost), out, indent=1)
+    if args.output:
+        out.close()
+
+    if args.summary:
+        with open(args.summary, 'w') as f:
+            json.dump(exporter.summary(lost), f, indent=1, sort_keys=True)
+
+
+if __name__ == '__main__':
+    main()